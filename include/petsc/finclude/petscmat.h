@@ -54,6 +54,7 @@
 #define MATPARTITIONING_PARMETIS 'parmetis'
 
 #define MATCOARSEN_MIS 'mis'
+#define MATCOARSEN_MIS2 'mis2'
 
 #define MATCOLORINGJP      'jp'
 #define MATCOLORINGPOWER   'power'
@@ -193,6 +194,7 @@
 #define MATSOLVERMATLAB          'matlab'
 #define MATSOLVERPETSC           'petsc'
 #define MATSOLVERBAS             'bas'
+#define MATSOLVERBLR             'blr'
 #define MATSOLVERCUSPARSE        'cusparse'
 #define MATSOLVERCUSPARSEBAND    'cusparseband'
 #define MATSOLVERCUDA            'cuda'
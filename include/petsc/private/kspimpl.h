@@ -113,6 +113,13 @@ struct _p_KSP {
   PetscInt      chknorm;             /* only compute/check norm if iterations is great than this */
   PetscBool     lagnorm;             /* Lag the residual norm calculation so that it is computed as part of the
                                         MPI_Allreduce() for computing the inner products for the next iteration. */
+  PetscBool     batchreductions;     /* Merge the independent reductions of an iteration into a single (non-blocking)
+                                        MPI_Allreduce() using the split phase VecXXXBegin()/VecXXXEnd() routines */
+  PetscInt      chknormevery;        /* compute the residual norm at most every chknormevery iterations, see KSPSetCheckNormEvery() */
+  PetscBool     chknormpredict;      /* check earlier when the convergence rate predicts convergence before the next check */
+  PetscInt      chknormnext;         /* next iteration at which the residual norm is computed */
+  PetscInt      chknormlast;         /* last iteration at which it was computed and its value then */
+  PetscReal     chknormlastnorm;
 
   PetscInt   nmax;                   /* maximum number of right-hand sides to be handled simultaneously */
 
@@ -270,8 +277,22 @@ PETSC_STATIC_INLINE PetscErrorCode KSPSetNoisy_Private(Vec v)
 
 PETSC_INTERN PetscErrorCode KSPSetUpNorms_Private(KSP,PetscBool,KSPNormType*,PCSide*);
 
+/* iterations that skip the residual norm and the convergence test, see KSPSetCheckNormEvery(), the last one never does */
+PETSC_STATIC_INLINE PetscBool KSPCheckNormSkip_Private(KSP ksp,PetscInt it)
+{
+  return (PetscBool)(ksp->normtype != KSP_NORM_NONE && it < ksp->chknormnext && it < ksp->max_it);
+}
+PETSC_INTERN PetscErrorCode KSPCheckNormSchedule_Private(KSP,PetscInt,PetscReal);
+
 PETSC_INTERN PetscErrorCode KSPPlotEigenContours_Private(KSP,PetscInt,const PetscReal*,const PetscReal*);
 
+/* dense kernels of the block methods used in KSPMatSolve() */
+PETSC_INTERN PetscErrorCode KSPBlockInnerProducts_Private(KSP,PetscInt,const Mat[],const Mat[],PetscInt,PetscScalar*);
+PETSC_INTERN PetscErrorCode KSPBlockGemm_Private(PetscScalar,Mat,const PetscScalar*,PetscInt,PetscScalar,Mat);
+PETSC_INTERN PetscErrorCode KSPBlockOrthonormalize_Private(PetscInt,PetscScalar*,const PetscReal*,PetscReal,PetscInt*,PetscScalar*,PetscScalar*,PetscInt);
+PETSC_INTERN PetscErrorCode KSPBlockConverged_Private(KSP,PetscInt,const PetscReal[],const PetscReal[],PetscBool[]);
+PETSC_INTERN PetscErrorCode KSPBlockDeflate_Private(PetscInt*,const PetscBool[],PetscInt[],PetscReal[],Mat,Mat,PetscInt,Mat[]);
+
 typedef struct _p_DMKSP *DMKSP;
 typedef struct _DMKSPOps *DMKSPOps;
 struct _DMKSPOps {
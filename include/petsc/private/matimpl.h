@@ -464,6 +464,7 @@ struct _p_Mat {
   PetscBool              structure_only;
   PetscBool              sortedfull;       /* full, sorted rows are inserted */
   PetscBool              force_diagonals;  /* set by MAT_FORCE_DIAGONAL_ENTRIES */
+  PetscBool              submatrix_plan;   /* set by MAT_SUBMATRIX_PLAN */
 #if defined(PETSC_HAVE_DEVICE)
   PetscOffloadMask       offloadmask;      /* a mask which indicates where the valid matrix data is (GPU, CPU or both) */
   PetscBool              boundtocpu;
@@ -10,20 +10,37 @@ struct _PCGAMGOps {
   PetscErrorCode (*coarsen)(PC, Mat*, PetscCoarsenData**);
   PetscErrorCode (*prolongator)(PC, Mat, Mat, PetscCoarsenData*, Mat*);
   PetscErrorCode (*optprolongator)(PC, Mat, Mat*);
+  PetscErrorCode (*refreshprolongator)(PC, PetscInt, Mat, PetscBool*);
   PetscErrorCode (*createlevel)(PC, Mat, PetscInt, Mat *, Mat *, PetscMPIInt *, IS *, PetscBool);
   PetscErrorCode (*createdefaultdata)(PC, Mat); /* for data methods that have a default (SA) */
   PetscErrorCode (*setfromoptions)(PetscOptionItems*,PC);
   PetscErrorCode (*destroy)(PC);
   PetscErrorCode (*view)(PC,PetscViewer);
 };
+/* what is kept of the setup of a level to refresh its smoothed prolongator when the values of its operator change, see PCGAMGSetRefreshTolerance() */
+typedef struct {
+  Mat       Ptent;       /* tentative prolongator */
+  Mat       AP;          /* product of the operator and Ptent, with its symbolic data */
+  Mat       P;           /* smoothed prolongator, before the permutation of the columns by a process reduction */
+  IS        perm;        /* columns of P in the interpolation of PCMG, or NULL */
+  Vec       diag;        /* diagonal of the operator P was last computed with */
+  Vec       vpow;        /* power iteration for D^{-1} A, warm started across refreshes */
+  PetscReal lambdapow;   /* its last estimate */
+  PetscReal emin,emax;   /* eigenvalue estimates of D^{-1} A used to smooth P */
+  PetscBool chebysa;     /* the Chebyshev smoother of the level uses emin and emax */
+  PetscInt  nrefresh;    /* number of times P was refreshed */
+} PCGAMGRefresh;
+
 /* Private context for the GAMG preconditioner */
 typedef struct gamg_TAG {
   PCGAMGType type;
   PetscInt  Nlevels;
   PetscBool repart;
   PetscBool reuse_prol;
+  PetscBool keep_aij;        /* keep the AIJ copies of BAIJ levels and their Galerkin products with reused interpolations */
   PetscBool use_aggs_in_asm;
   PetscBool use_parallel_coarse_grid_solver;
+  PetscBool coarse_subcomm;  /* solve the coarse grid on the subcommunicator of the processes that hold its equations */
   PCGAMGLayoutType layout_type;
   PetscBool cpu_pin_coarse_grids;
   PetscInt  min_eq_proc;
@@ -50,6 +67,13 @@ typedef struct gamg_TAG {
   PetscInt   esteig_max_it;
   PetscInt   use_sa_esteig;
   PetscReal  emin,emax;
+
+  PetscReal     refresh_tol;                    /* smoothed prolongators are refreshed when the diagonal of the operator changed more than this, negative to keep them */
+  PCGAMGRefresh refresh[PETSC_MG_MAXLEVELS];
+
+  Mat              aijcopy[PETSC_MG_MAXLEVELS];  /* AIJ copies of the BAIJ operators of the levels, see PCGAMGSetKeepAIJProducts() */
+  PetscObjectState aijstate[PETSC_MG_MAXLEVELS]; /* nonzero state of the BAIJ operators they were copied from */
+  Mat              aijptap[PETSC_MG_MAXLEVELS];  /* Galerkin products of the copies, with their symbolic data */
 } PC_GAMG;
 
 PetscErrorCode PCReset_MG(PC);
@@ -45,6 +45,15 @@ typedef struct {
   PetscLogEvent eventsmoothsolve;
   PetscLogEvent eventresidual;
   PetscLogEvent eventinterprestrict;
+
+  /* copy of the level on the group of processes that smooths it in the concurrent additive cycle */
+  PetscMPIInt   cgroupsize;                    /* number of processes of the group */
+  IS            cis;                           /* rows of the level owned by this process in the group */
+  VecScatter    cscatter;                      /* from the level vectors to ctmp */
+  Vec           ctmp;                          /* on the communicator of the PC, shares the arrays of cxred and cyred */
+  Vec           cxred,cyred;                   /* right hand side and solution on the communicator of the group */
+  Mat           cA;                            /* operator on the communicator of the group */
+  KSP           csmooth;                       /* smoother on the communicator of the group */
 } PC_MG_Levels;
 
 /*
@@ -65,6 +74,9 @@ typedef struct {
 
   PetscBool           compatibleRelaxation;   /* flag to monitor the coarse space quality using an auxiliary solve with compatible relaxation */
 
+  PetscBool           additiveconcurrent;     /* smooth the levels of the additive cycle concurrently on disjoint groups of processes */
+  PetscSubcomm        cpsubcomm;              /* the groups of processes of the concurrent additive cycle */
+
   PetscInt     nlevels;
   PC_MG_Levels **levels;
   PetscInt     default_smoothu;               /* number of smooths per level if not over-ridden */
@@ -91,6 +103,8 @@ PETSC_INTERN PetscErrorCode PCMGComputeCoarseSpace_Internal(PC, PetscInt, PCMGCo
 PETSC_INTERN PetscErrorCode PCMGAdaptInterpolator_Internal(PC, PetscInt, KSP, KSP, PetscInt, Vec[], Vec[]);
 PETSC_INTERN PetscErrorCode PCMGRecomputeLevelOperators_Internal(PC, PetscInt);
 PETSC_INTERN PetscErrorCode PCMGACycle_Private(PC,PC_MG_Levels**,PetscBool,PetscBool);
+PETSC_INTERN PetscErrorCode PCMGACycleSetUpConcurrent_Private(PC);
+PETSC_INTERN PetscErrorCode PCMGACycleResetConcurrent_Private(PC);
 PETSC_INTERN PetscErrorCode PCMGFCycle_Private(PC,PC_MG_Levels**,PetscBool,PetscBool);
 PETSC_INTERN PetscErrorCode PCMGKCycle_Private(PC,PC_MG_Levels**,PetscBool,PetscBool);
 PETSC_INTERN PetscErrorCode PCMGMCycle_Private(PC,PC_MG_Levels**,PetscBool,PetscBool,PCRichardsonConvergedReason*);
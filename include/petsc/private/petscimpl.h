@@ -906,6 +906,8 @@ typedef struct {
   void           **invecs;     /* for debugging only, vector/memory used with each op */
   PetscInt       *reducetype;  /* is particular value to be summed or maxed? */
   struct { PetscScalar v; PetscInt i; } *lvalues_mix,*gvalues_mix; /* used when mixing reduce operations */
+  PetscReal      *lrepro,*grepro; /* accumulators of the sums with -vec_reproducible, reduced separately */
+  MPI_Request    rrequest;
   SRState        state;        /* are we calling xxxBegin() or xxxEnd()? */
   PetscInt       maxops;       /* total amount of space we have for requests */
   PetscInt       numopsbegin;  /* number of requests that have been queued in */
@@ -67,6 +67,13 @@ struct _p_PetscSF {
     PetscInt          bs;            /* Block size, determined by IS passed to VecScatterCreate */
     MPI_Datatype      unit;          /* one unit = bs PetscScalars */
     PetscBool         logging;       /* Indicate if vscat log events are happening. If yes, avoid duplicated SF logging to have clear -log_view */
+    PetscSF           msf;           /* SF with roots compacted to those connected to leaves, used by VecScatterBeginMultiple(). Built on demand. */
+    PetscInt          *mroots;       /* Roots of this SF connected to leaves, in the order of roots of msf */
+    PetscScalar       *mrootbuf;     /* Buffers holding interleaved entries of the vectors in VecScatterBeginMultiple() */
+    PetscScalar       *mleafbuf;
+    PetscInt          mbufn;         /* Number of vectors mrootbuf/mleafbuf can hold */
+    PetscInt          mn;            /* Number of vectors in the pending VecScatterBeginMultiple(), 0 if none */
+    MPI_Datatype      munit;         /* mn*bs PetscScalars, the unit of msf in the pending VecScatterBeginMultiple() */
   } vscat;
 
   /* Fields for generic PetscSF functionality */
@@ -105,6 +112,7 @@ struct _p_PetscSF {
   PetscBool       setupcalled;     /* Type and communication structures have been set up */
   PetscSFPattern  pattern;         /* Pattern of the graph */
   PetscBool       persistent;      /* Does this SF use MPI persistent requests for communication */
+  PetscSFCompression compression; /* Reduced precision used for floating point data sent to other processes */
   PetscLayout     map;             /* Layout of leaves over all processes when building a patterned graph */
   PetscBool       unknown_input_stream;/* If true, SF does not know which streams root/leafdata is on. Default is false, since we only use petsc default stream */
   PetscBool       use_gpu_aware_mpi;   /* If true, SF assumes it can pass GPU pointers to MPI */
@@ -15,6 +15,21 @@ PETSC_EXTERN PetscBool VecRegisterAllCalled;
 PETSC_EXTERN PetscErrorCode VecRegisterAll(void);
 PETSC_EXTERN MPI_Op MPIU_MAXLOC;
 PETSC_EXTERN MPI_Op MPIU_MINLOC;
+PETSC_EXTERN PetscBool VecReproducible; /* -vec_reproducible, see src/vec/vec/impls/seq/vrepro.c */
+
+/* Accumulators of reproducible sums, VEC_REPRO_NACC reals for each real sum */
+#define VEC_REPRO_NACC 8
+#if defined(PETSC_USE_COMPLEX)
+#define VEC_REPRO_NSCALAR (2*VEC_REPRO_NACC)
+#else
+#define VEC_REPRO_NSCALAR VEC_REPRO_NACC
+#endif
+PETSC_INTERN MPI_Op         VecRepro_Op;
+PETSC_INTERN MPI_Datatype   VecRepro_Type;
+PETSC_INTERN PetscErrorCode VecReproMDotLocal(Vec,PetscInt,const Vec[],PetscBool,PetscReal*);
+PETSC_INTERN PetscErrorCode VecReproNormLocal(Vec,NormType,PetscReal*,PetscReal*);
+PETSC_INTERN PetscReal      VecReproReal(const PetscReal*,PetscBool);
+PETSC_INTERN PetscScalar    VecReproScalar(const PetscReal*);
 
 /* ----------------------------------------------------------------------------*/
 
@@ -38,6 +38,7 @@ typedef const char* KSPType;
 #define KSPPIPELCG     "pipelcg"
 #define KSPPIPEPRCG    "pipeprcg"
 #define KSPPIPECG2     "pipecg2"
+#define KSPSSTEPCG     "sstepcg"
 #define   KSPCGNE       "cgne"
 #define   KSPNASH       "nash"
 #define   KSPSTCG       "stcg"
@@ -49,6 +50,7 @@ typedef const char* KSPType;
 #define KSPPIPEFCG    "pipefcg"
 #define KSPGMRES      "gmres"
 #define KSPPIPEFGMRES "pipefgmres"
+#define KSPCAGMRES    "cagmres"
 #define   KSPFGMRES     "fgmres"
 #define   KSPLGMRES     "lgmres"
 #define   KSPDGMRES     "dgmres"
@@ -78,6 +80,11 @@ typedef const char* KSPType;
 #define KSPCGLS       "cgls"
 #define KSPFETIDP     "fetidp"
 #define KSPHPDDM      "hpddm"
+#define KSPIR         "ir"
+#define KSPGCRODR     "gcrodr"
+#define KSPDEFCG      "defcg"
+#define KSPECG        "ecg"
+#define KSPBATCH      "batch"
 
 /* Logging support */
 PETSC_EXTERN PetscClassId KSP_CLASSID;
@@ -181,9 +188,12 @@ PETSC_EXTERN PetscErrorCode KSPBuildResidual(KSP,Vec,Vec,Vec*);
 PETSC_EXTERN PetscErrorCode KSPRichardsonSetScale(KSP,PetscReal);
 PETSC_EXTERN PetscErrorCode KSPRichardsonSetSelfScale(KSP,PetscBool);
 PETSC_EXTERN PetscErrorCode KSPChebyshevSetEigenvalues(KSP,PetscReal,PetscReal);
+PETSC_EXTERN PetscErrorCode KSPChebyshevGetEigenvalues(KSP,PetscReal*,PetscReal*);
 PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigSet(KSP,PetscReal,PetscReal,PetscReal,PetscReal);
 PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigSetUseNoisy(KSP,PetscBool);
 PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigGetKSP(KSP,KSP*);
+PETSC_EXTERN PetscErrorCode KSPChebyshevEstEigSetReuseTolerance(KSP,PetscReal);
+PETSC_EXTERN PetscErrorCode KSPChebyshevSetFused(KSP,PetscBool);
 PETSC_EXTERN PetscErrorCode KSPComputeExtremeSingularValues(KSP,PetscReal*,PetscReal*);
 PETSC_EXTERN PetscErrorCode KSPComputeEigenvalues(KSP,PetscInt,PetscReal[],PetscReal[],PetscInt*);
 PETSC_EXTERN PetscErrorCode KSPComputeEigenvaluesExplicitly(KSP,PetscInt,PetscReal[],PetscReal[]);
@@ -496,6 +506,10 @@ PETSC_EXTERN PetscErrorCode KSPGetNormType(KSP,KSPNormType*);
 PETSC_EXTERN PetscErrorCode KSPSetSupportedNorm(KSP ksp,KSPNormType,PCSide,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPSetCheckNormIteration(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPSetLagNorm(KSP,PetscBool);
+PETSC_EXTERN PetscErrorCode KSPSetBatchReductions(KSP,PetscBool);
+PETSC_EXTERN PetscErrorCode KSPGetBatchReductions(KSP,PetscBool*);
+PETSC_EXTERN PetscErrorCode KSPSetCheckNormEvery(KSP,PetscInt,PetscBool);
+PETSC_EXTERN PetscErrorCode KSPGetCheckNormEvery(KSP,PetscInt*,PetscBool*);
 
 #define KSP_DIVERGED_PCSETUP_FAILED_DEPRECATED KSP_DIVERGED_PCSETUP_FAILED PETSC_DEPRECATED_ENUM("Use KSP_DIVERGED_PC_FAILED (since version 3.11)")
 /*E
@@ -722,6 +736,70 @@ PETSC_EXTERN const char *const KSPCGTypes[];
 PETSC_EXTERN PetscErrorCode KSPCGSetType(KSP,KSPCGType);
 PETSC_EXTERN PetscErrorCode KSPCGUseSingleReduction(KSP,PetscBool);
 
+/*E
+    KSPSStepBasis - The polynomial basis used by the s-step Krylov methods KSPSSTEPCG and KSPCAGMRES to generate s
+    Krylov vectors at once
+
+   Level: advanced
+
+.seealso: KSPSStepSetBasis(), KSPSStepSetSize(), KSPSSTEPCG, KSPCAGMRES
+E*/
+typedef enum {KSP_SSTEP_BASIS_MONOMIAL,KSP_SSTEP_BASIS_NEWTON,KSP_SSTEP_BASIS_CHEBYSHEV} KSPSStepBasis;
+PETSC_EXTERN const char *const KSPSStepBases[];
+
+PETSC_EXTERN PetscErrorCode KSPSStepSetSize(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPSStepGetSize(KSP,PetscInt*);
+PETSC_EXTERN PetscErrorCode KSPSStepSetBasis(KSP,KSPSStepBasis);
+PETSC_EXTERN PetscErrorCode KSPSStepGetBasis(KSP,KSPSStepBasis*);
+
+/*E
+    KSPIRPrecision - The precision of the communication of the operators in the inner solver of KSPIR
+
+$  KSP_IR_PRECISION_FULL   - the inner solver applies the operators in full precision (default)
+$  KSP_IR_PRECISION_SINGLE - MatMult() in the inner solver sends the ghost values of MATMPIAIJ operators in single precision
+
+   Notes:
+   Only the communication is compressed, the operators are stored and applied in full precision in both cases.
+
+   Level: intermediate
+
+.seealso: KSPIRSetInnerPrecision(), KSPIR
+E*/
+typedef enum {KSP_IR_PRECISION_FULL,KSP_IR_PRECISION_SINGLE} KSPIRPrecision;
+PETSC_EXTERN const char *const KSPIRPrecisions[];
+
+PETSC_EXTERN PetscErrorCode KSPIRSetInnerPrecision(KSP,KSPIRPrecision);
+PETSC_EXTERN PetscErrorCode KSPIRGetInnerPrecision(KSP,KSPIRPrecision*);
+PETSC_EXTERN PetscErrorCode KSPIRGetInnerKSP(KSP,KSP*);
+
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetRestart(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetRecycleSize(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGCRODRGetRecycleSize(KSP,PetscInt*,PetscInt*);
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetAdaptiveRestart(KSP,PetscBool);
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetMemoryBudget(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPDEFCGSetRecycleSize(KSP,PetscInt,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPDEFCGGetRecycleSize(KSP,PetscInt*,PetscInt*,PetscInt*);
+PETSC_EXTERN PetscErrorCode KSPECGSetEnlargingFactor(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPECGGetEnlargingFactor(KSP,PetscInt*);
+
+/*E
+    KSPBatchMethod - The Krylov method applied to each system of KSPBATCH
+
+$  KSP_BATCH_BCGS  - BiCGStab, see KSPBCGS
+$  KSP_BATCH_GMRES - restarted GMRES, see KSPGMRES
+
+   Level: intermediate
+
+.seealso: KSPBatchSetMethod(), KSPBATCH
+E*/
+typedef enum {KSP_BATCH_BCGS,KSP_BATCH_GMRES} KSPBatchMethod;
+PETSC_EXTERN const char *const KSPBatchMethods[];
+
+PETSC_EXTERN PetscErrorCode KSPBatchSetMethod(KSP,KSPBatchMethod);
+PETSC_EXTERN PetscErrorCode KSPBatchGetMethod(KSP,KSPBatchMethod*);
+PETSC_EXTERN PetscErrorCode KSPBatchSetSection(KSP,PetscSection);
+PETSC_EXTERN PetscErrorCode KSPBatchGetConvergedReasons(KSP,PetscInt*,const KSPConvergedReason*[],const PetscInt*[]);
+
 PETSC_EXTERN PetscErrorCode KSPCGSetRadius(KSP,PetscReal);
 PETSC_EXTERN PetscErrorCode KSPCGGetNormD(KSP,PetscReal*);
 PETSC_EXTERN PetscErrorCode KSPCGGetObjFcn(KSP,PetscReal*);
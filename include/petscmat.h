@@ -142,6 +142,7 @@ typedef const char* MatSolverType;
 #define MATSOLVERMATLAB           "matlab"
 #define MATSOLVERPETSC            "petsc"
 #define MATSOLVERBAS              "bas"
+#define MATSOLVERBLR              "blr"
 #define MATSOLVERCUSPARSE         "cusparse"
 #define MATSOLVERCUSPARSEBAND     "cusparseband"
 #define MATSOLVERCUDA             "cuda"
@@ -468,7 +469,8 @@ typedef enum {MAT_OPTION_MIN = -3,
               MAT_STRUCTURE_ONLY = 22,
               MAT_SORTED_FULL = 23,
               MAT_FORM_EXPLICIT_TRANSPOSE = 24,
-              MAT_OPTION_MAX = 25} MatOption;
+              MAT_SUBMATRIX_PLAN = 25,
+              MAT_OPTION_MAX = 26} MatOption;
 
 PETSC_EXTERN const char *const *MatOptions;
 PETSC_EXTERN PetscErrorCode MatSetOption(Mat,MatOption,PetscBool);
@@ -249,7 +249,8 @@ typedef const char *PCGAMGClassicalType;
 +  PC_MG_MULTIPLICATIVE (default) - traditional V or W cycle as determined by PCMGSetCycleType()
 .  PC_MG_ADDITIVE - the additive multigrid preconditioner where all levels are
                 smoothed before updating the residual. This only uses the
-                down smoother, in the preconditioner the upper smoother is ignored
+                down smoother, in the preconditioner the upper smoother is ignored. The levels can be
+                smoothed concurrently on disjoint groups of processes with PCMGAdditiveSetConcurrent()
 .  PC_MG_FULL - same as multiplicative except one also performs grid sequencing,
             that is starts on the coarsest grid, performs a cycle, interpolates
             to the next, performs a cycle etc. This is much like the F-cycle presented in "Multigrid" by Trottenberg, Oosterlee, Schuller page 49, but that
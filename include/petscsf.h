@@ -77,6 +77,25 @@ E*/
 typedef enum {PETSCSF_DUPLICATE_CONFONLY,PETSCSF_DUPLICATE_RANKS,PETSCSF_DUPLICATE_GRAPH} PetscSFDuplicateOption;
 PETSC_EXTERN const char *const PetscSFDuplicateOptions[];
 
+/*E
+    PetscSFCompression - Reduced-precision representation of floating point data sent between processes
+
+$  PETSCSF_COMPRESSION_NONE     - data is sent in full precision (default)
+$  PETSCSF_COMPRESSION_SINGLE   - double precision data is rounded to single precision before sending
+$  PETSCSF_COMPRESSION_BFLOAT16 - double precision data is rounded to bfloat16 (8 bit exponent, 7 bit mantissa) before sending
+
+   Notes:
+   Compression is lossy and only affects data exchanged between different processes; data that stays on a process is never
+   rounded. It is applied to PetscSFBcast and PetscSFReduce operations on PetscReal or PetscScalar data in host memory with
+   the PETSCSFBASIC type. All other operations and data types silently communicate in full precision.
+
+   Level: advanced
+
+.seealso: PetscSFSetCompression(), PetscSFGetCompression()
+E*/
+typedef enum {PETSCSF_COMPRESSION_NONE=0,PETSCSF_COMPRESSION_SINGLE,PETSCSF_COMPRESSION_BFLOAT16} PetscSFCompression;
+PETSC_EXTERN const char *const PetscSFCompressions[];
+
 PETSC_EXTERN PetscFunctionList PetscSFList;
 PETSC_EXTERN PetscErrorCode PetscSFRegister(const char[],PetscErrorCode (*)(PetscSF));
 
@@ -98,6 +117,8 @@ PETSC_EXTERN PetscErrorCode PetscSFWindowGetFlavorType(PetscSF,PetscSFWindowFlav
 PETSC_EXTERN PetscErrorCode PetscSFWindowSetInfo(PetscSF,MPI_Info);
 PETSC_EXTERN PetscErrorCode PetscSFWindowGetInfo(PetscSF,MPI_Info*);
 PETSC_EXTERN PetscErrorCode PetscSFSetRankOrder(PetscSF,PetscBool);
+PETSC_EXTERN PetscErrorCode PetscSFSetCompression(PetscSF,PetscSFCompression);
+PETSC_EXTERN PetscErrorCode PetscSFGetCompression(PetscSF,PetscSFCompression*);
 PETSC_EXTERN PetscErrorCode PetscSFSetGraph(PetscSF,PetscInt,PetscInt,const PetscInt*,PetscCopyMode,const PetscSFNode*,PetscCopyMode);
 PETSC_EXTERN PetscErrorCode PetscSFSetGraphWithPattern(PetscSF,PetscLayout,PetscSFPattern);
 PETSC_EXTERN PetscErrorCode PetscSFGetGraph(PetscSF,PetscInt*,PetscInt*,const PetscInt**,const PetscSFNode**);
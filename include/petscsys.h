@@ -422,6 +422,19 @@ M*/
 #  define PetscPragmaSIMD
 #endif
 
+/* PetscPragmaOMPParallelFor - statically scheduled OpenMP parallel loop when PETSc is configured with OpenMP, nothing otherwise.
+   PetscPragmaOMPParallelForClauses(clauses) appends further clauses, e.g. private() or an if() threshold */
+
+#if defined(PETSC_HAVE_OPENMP) && !defined(_WIN32)
+#  define PetscPragmaOMPParallelFor_Private(x) _Pragma(#x)
+#  define PetscPragmaOMPParallelForClauses(clauses) PetscPragmaOMPParallelFor_Private(omp parallel for schedule(static) clauses)
+#elif defined(PETSC_HAVE_OPENMP) && defined(_WIN32)
+#  define PetscPragmaOMPParallelForClauses(clauses) __pragma(omp parallel for schedule(static) clauses)
+#else
+#  define PetscPragmaOMPParallelForClauses(clauses)
+#endif
+#define PetscPragmaOMPParallelFor PetscPragmaOMPParallelForClauses()
+
 /*
     Declare extern C stuff after including external header files
 */
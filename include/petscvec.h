@@ -381,6 +381,8 @@ PETSC_EXTERN PetscErrorCode VecRegister(const char[],PetscErrorCode (*)(Vec));
 
 PETSC_EXTERN PetscErrorCode VecScatterBegin(VecScatter,Vec,Vec,InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecScatterEnd(VecScatter,Vec,Vec,InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecScatterBeginMultiple(VecScatter,PetscInt,const Vec[],const Vec[],InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecScatterEndMultiple(VecScatter,PetscInt,const Vec[],const Vec[],InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecScatterDestroy(VecScatter*);
 PETSC_EXTERN PetscErrorCode VecScatterSetUp(VecScatter);
 PETSC_EXTERN PetscErrorCode VecScatterCopy(VecScatter,VecScatter *);
@@ -661,6 +663,8 @@ PETSC_EXTERN PetscErrorCode VecGhostRestoreLocalForm(Vec,Vec*);
 PETSC_EXTERN PetscErrorCode VecGhostIsLocalForm(Vec,Vec,PetscBool*);
 PETSC_EXTERN PetscErrorCode VecGhostUpdateBegin(Vec,InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecGhostUpdateEnd(Vec,InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecGhostUpdateMultipleBegin(PetscInt,const Vec[],InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecGhostUpdateMultipleEnd(PetscInt,const Vec[],InsertMode,ScatterMode);
 
 PETSC_EXTERN PetscErrorCode VecConjugate(Vec);
 PETSC_EXTERN PetscErrorCode VecImaginaryPart(Vec);
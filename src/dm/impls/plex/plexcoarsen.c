@@ -29,3 +29,80 @@ PetscErrorCode DMCoarsenHierarchy_Plex(DM dm, PetscInt nlevels, DM dmCoarsened[]
   }
   PetscFunctionReturn(0);
 }
+
+/*@
+  DMPlexCoarsenDegree - Create a DM on the same mesh whose finite element fields have a lower polynomial degree, for p-multigrid
+
+  Collective on dm
+
+  Input Parameters:
++ dm     - The DMPLEX with a PetscFE discretization
+- degree - The polynomial degree of the coarse fields
+
+  Output Parameter:
+. dmc - The coarse DM
+
+  Notes:
+  Each PetscFE field of degree larger than degree is replaced by a Lagrange element of that degree, the other fields are kept. The coarse DM gets
+  the equations, constants, boundary conditions and exact solutions of the PetscDS of dm, and is set as the coarse DM of dm with DMSetCoarseDM(),
+  so that DMCoarsen() returns it. Calling this function from the finest degree down thus gives PCMG the levels of a p-multigrid hierarchy, with the
+  interpolation between degrees built by DMCreateInterpolation(). With -dm_mat_type shell every level is applied matrix-free, see DMCreateMatrix(),
+  and can be smoothed with KSPCHEBYSHEV and PCJACOBI.
+
+  Level: intermediate
+
+.seealso: DMCoarsen(), DMSetCoarseDM(), DMCreateInterpolation(), PetscFECreateLagrange()
+@*/
+PetscErrorCode DMPlexCoarsenDegree(DM dm, PetscInt degree, DM *dmc)
+{
+  PetscDS        ds, dsc;
+  PetscBool      simplex;
+  PetscInt       dim, Nf, f;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(dm, degree, 2);
+  PetscValidPointer(dmc, 3);
+  if (degree < 1) SETERRQ1(PetscObjectComm((PetscObject) dm), PETSC_ERR_ARG_OUTOFRANGE, "Coarse degree %D must be positive", degree);
+  ierr = DMGetDimension(dm, &dim);CHKERRQ(ierr);
+  ierr = DMPlexIsSimplex(dm, &simplex);CHKERRQ(ierr);
+  ierr = DMClone(dm, dmc);CHKERRQ(ierr);
+  ierr = DMGetNumFields(dm, &Nf);CHKERRQ(ierr);
+  for (f = 0; f < Nf; ++f) {
+    DMLabel      label;
+    PetscObject  obj;
+    PetscClassId id;
+
+    ierr = DMGetField(dm, f, &label, &obj);CHKERRQ(ierr);
+    ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+    if (id == PETSCFE_CLASSID) {
+      PetscFE     fe = (PetscFE) obj, fec;
+      PetscSpace  sp;
+      PetscInt    Nc, k;
+      const char *name;
+
+      ierr = PetscFEGetBasisSpace(fe, &sp);CHKERRQ(ierr);
+      ierr = PetscSpaceGetDegree(sp, &k, NULL);CHKERRQ(ierr);
+      if (k > degree) {
+        ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+        ierr = PetscFECreateLagrange(PetscObjectComm((PetscObject) dm), dim, Nc, simplex, degree, PETSC_DETERMINE, &fec);CHKERRQ(ierr);
+        ierr = PetscObjectGetName((PetscObject) fe, &name);CHKERRQ(ierr);
+        ierr = PetscObjectSetName((PetscObject) fec, name);CHKERRQ(ierr);
+        ierr = DMSetField(*dmc, f, label, (PetscObject) fec);CHKERRQ(ierr);
+        ierr = PetscFEDestroy(&fec);CHKERRQ(ierr);
+        continue;
+      }
+    }
+    ierr = DMSetField(*dmc, f, label, obj);CHKERRQ(ierr);
+  }
+  ierr = DMCreateDS(*dmc);CHKERRQ(ierr);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = DMGetDS(*dmc, &dsc);CHKERRQ(ierr);
+  ierr = PetscDSCopyEquations(ds, dsc);CHKERRQ(ierr);
+  ierr = PetscDSCopyConstants(ds, dsc);CHKERRQ(ierr);
+  ierr = PetscDSCopyBoundary(ds, PETSC_DETERMINE, NULL, dsc);CHKERRQ(ierr);
+  ierr = PetscDSCopyExactSolutions(ds, dsc);CHKERRQ(ierr);
+  ierr = DMSetCoarseDM(dm, *dmc);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -3119,13 +3119,15 @@ PetscErrorCode DMPlexComputeMassMatrixGeneral(DM dmc, DM dmf, Mat mass, void *us
   Output Parameter:
 . sc   - The mapping
 
+  Note: The fine DM is either a regular refinement of the coarse DM, or shares its mesh with discretizations of higher degree, see DMPlexCoarsenDegree()
+
   Level: developer
 
 .seealso: DMPlexComputeInterpolatorNested(), DMPlexComputeJacobianFEM()
 @*/
 PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *user)
 {
-  PetscDS        prob;
+  PetscDS        prob, probF;
   PetscFE       *feRef;
   PetscFV       *fvRef;
   Vec            fv, cv;
@@ -3133,7 +3135,7 @@ PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *us
   PetscSection   fsection, fglobalSection, csection, cglobalSection;
   PetscInt      *cmap, *cellCIndices, *cellFIndices, *cindices, *findices;
   PetscInt       cTotDim, fTotDim = 0, Nf, f, field, cStart, cEnd, c, dim, d, startC, endC, offsetC, offsetF, m;
-  PetscBool     *needAvg;
+  PetscBool     *needAvg, isRefined = dmc->data == dmf->data ? PETSC_FALSE : PETSC_TRUE;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
@@ -3146,6 +3148,7 @@ PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *us
   ierr = PetscSectionGetNumFields(fsection, &Nf);CHKERRQ(ierr);
   ierr = DMPlexGetSimplexOrBoxCells(dmc, 0, &cStart, &cEnd);CHKERRQ(ierr);
   ierr = DMGetDS(dmc, &prob);CHKERRQ(ierr);
+  ierr = DMGetDS(dmf, &probF);CHKERRQ(ierr);
   ierr = PetscCalloc3(Nf,&feRef,Nf,&fvRef,Nf,&needAvg);CHKERRQ(ierr);
   for (f = 0; f < Nf; ++f) {
     PetscObject  obj;
@@ -3159,7 +3162,12 @@ PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *us
       PetscSpace sp;
       PetscInt   maxDegree;
 
-      ierr = PetscFERefine(fe, &feRef[f]);CHKERRQ(ierr);
+      /* On the same mesh, e.g. for a lower polynomial degree, the coarse functionals are matched with the fine ones directly */
+      if (isRefined) {ierr = PetscFERefine(fe, &feRef[f]);CHKERRQ(ierr);}
+      else {
+        ierr = PetscDSGetDiscretization(probF, f, (PetscObject *) &feRef[f]);CHKERRQ(ierr);
+        ierr = PetscObjectReference((PetscObject) feRef[f]);CHKERRQ(ierr);
+      }
       ierr = PetscFEGetDimension(feRef[f], &fNb);CHKERRQ(ierr);
       ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
       ierr = PetscFEGetBasisSpace(fe, &sp);CHKERRQ(ierr);
@@ -3169,7 +3177,11 @@ PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *us
       PetscFV        fv = (PetscFV) obj;
       PetscDualSpace Q;
 
-      ierr = PetscFVRefine(fv, &fvRef[f]);CHKERRQ(ierr);
+      if (isRefined) {ierr = PetscFVRefine(fv, &fvRef[f]);CHKERRQ(ierr);}
+      else {
+        ierr = PetscDSGetDiscretization(probF, f, (PetscObject *) &fvRef[f]);CHKERRQ(ierr);
+        ierr = PetscObjectReference((PetscObject) fvRef[f]);CHKERRQ(ierr);
+      }
       ierr = PetscFVGetDualSpace(fvRef[f], &Q);CHKERRQ(ierr);
       ierr = PetscDualSpaceGetDimension(Q, &fNb);CHKERRQ(ierr);
       ierr = PetscFVGetNumComponents(fv, &Nc);CHKERRQ(ierr);
@@ -3254,7 +3266,17 @@ PetscErrorCode DMPlexComputeInjectorFEM(DM dmc, DM dmf, VecScatter *sc, void *us
   ierr = PetscMalloc1(m,&findices);CHKERRQ(ierr);
   for (d = 0; d < m; ++d) cindices[d] = findices[d] = -1;
   for (c = cStart; c < cEnd; ++c) {
-    ierr = DMPlexMatGetClosureIndicesRefined(dmf, fsection, fglobalSection, dmc, csection, cglobalSection, c, cellCIndices, cellFIndices);CHKERRQ(ierr);
+    if (isRefined) {ierr = DMPlexMatGetClosureIndicesRefined(dmf, fsection, fglobalSection, dmc, csection, cglobalSection, c, cellCIndices, cellFIndices);CHKERRQ(ierr);}
+    else {
+      PetscInt *indices, numIndices;
+
+      ierr = DMPlexGetClosureIndices(dmc, csection, cglobalSection, c, PETSC_FALSE, &numIndices, &indices, NULL, NULL);CHKERRQ(ierr);
+      ierr = PetscArraycpy(cellCIndices, indices, cTotDim);CHKERRQ(ierr);
+      ierr = DMPlexRestoreClosureIndices(dmc, csection, cglobalSection, c, PETSC_FALSE, &numIndices, &indices, NULL, NULL);CHKERRQ(ierr);
+      ierr = DMPlexGetClosureIndices(dmf, fsection, fglobalSection, c, PETSC_FALSE, &numIndices, &indices, NULL, NULL);CHKERRQ(ierr);
+      ierr = PetscArraycpy(cellFIndices, indices, fTotDim);CHKERRQ(ierr);
+      ierr = DMPlexRestoreClosureIndices(dmf, fsection, fglobalSection, c, PETSC_FALSE, &numIndices, &indices, NULL, NULL);CHKERRQ(ierr);
+    }
     for (d = 0; d < cTotDim; ++d) {
       if ((cellCIndices[d] < startC) || (cellCIndices[d] >= endC)) continue;
       if ((findices[cellCIndices[d]-startC] >= 0) && (findices[cellCIndices[d]-startC] != cellFIndices[cmap[d]])) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Coarse dof %D maps to both %D and %D", cindices[cellCIndices[d]-startC], findices[cellCIndices[d]-startC], cellFIndices[cmap[d]]);
@@ -5754,7 +5776,7 @@ PetscErrorCode DMPlexComputeJacobian_Hybrid_Internal(DM dm, PetscFormKey key[],
 . X_tShift - The multiplier for the Jacobian with repsect to X_t
 . X      - Local solution vector
 . X_t    - Time-derivative of the local solution vector
-. Y      - Local input vector
+. Y      - Local input vector, or NULL to compute the diagonal of the Jacobian
 - user   - the user context
 
   Output Parameter:
@@ -5837,9 +5859,11 @@ PetscErrorCode DMPlexComputeJacobian_Action_Internal(DM dm, PetscFormKey key, IS
       for (i = 0; i < totDimAux; ++i) a[cind*totDimAux+i] = x[i];
       ierr = DMPlexVecRestoreClosure(plexAux, sectionAux, A, subcell, NULL, &x);CHKERRQ(ierr);
     }
-    ierr = DMPlexVecGetClosure(plex, section, Y, cell, NULL, &x);CHKERRQ(ierr);
-    for (i = 0; i < totDim; ++i) y[cind*totDim+i] = x[i];
-    ierr = DMPlexVecRestoreClosure(plex, section, Y, cell, NULL, &x);CHKERRQ(ierr);
+    if (Y) {
+      ierr = DMPlexVecGetClosure(plex, section, Y, cell, NULL, &x);CHKERRQ(ierr);
+      for (i = 0; i < totDim; ++i) y[cind*totDim+i] = x[i];
+      ierr = DMPlexVecRestoreClosure(plex, section, Y, cell, NULL, &x);CHKERRQ(ierr);
+    }
   }
   ierr = PetscArrayzero(elemMat, numCells*totDim*totDim);CHKERRQ(ierr);
   if (hasDyn)  {ierr = PetscArrayzero(elemMatD, numCells*totDim*totDim);CHKERRQ(ierr);}
@@ -5898,10 +5922,15 @@ PetscErrorCode DMPlexComputeJacobian_Action_Internal(DM dm, PetscFormKey key, IS
     const PetscBLASInt M = totDim, one = 1;
     const PetscScalar  a = 1.0, b = 0.0;
 
-    PetscStackCallBLAS("BLASgemv", BLASgemv_("N", &M, &M, &a, &elemMat[cind*totDim*totDim], &M, &y[cind*totDim], &one, &b, z, &one));
+    if (Y) {PetscStackCallBLAS("BLASgemv", BLASgemv_("T", &M, &M, &a, &elemMat[cind*totDim*totDim], &M, &y[cind*totDim], &one, &b, z, &one));}
+    else {
+      PetscInt i;
+
+      for (i = 0; i < totDim; ++i) z[i] = elemMat[(cind*totDim+i)*totDim+i];
+    }
     if (mesh->printFEM > 1) {
       ierr = DMPrintCellMatrix(c, name, totDim, totDim, &elemMat[cind*totDim*totDim]);CHKERRQ(ierr);
-      ierr = DMPrintCellVector(c, "Y",  totDim, &y[cind*totDim]);CHKERRQ(ierr);
+      if (Y) {ierr = DMPrintCellVector(c, "Y",  totDim, &y[cind*totDim]);CHKERRQ(ierr);}
       ierr = DMPrintCellVector(c, "Z",  totDim, z);CHKERRQ(ierr);
     }
     ierr = DMPlexVecSetClosure(dm, section, Z, cell, z, ADD_VALUES);CHKERRQ(ierr);
@@ -0,0 +1,617 @@
+#include <petsc/private/dmpleximpl.h>   /*I      "petscdmplex.h"   I*/
+#include <petsc/private/petscfeimpl.h>
+#include <petscdmfield.h>
+
+/*
+  Matrix-free application of the Jacobian of a PetscFE discretization, used for DMCreateMatrix() with MATSHELL.
+
+  For a single Lagrange field on quadrilaterals or hexahedra integrated with a tensor product quadrature, the operator
+  is applied with sum factorization: the trial function and its gradient are evaluated at the quadrature points with
+  one dimensional contractions, the pointwise Jacobian functions are applied, and the result is integrated against the
+  test functions with the transposed contractions. This costs O(p^{d+1}) per cell, instead of the O(p^{2d}) of the
+  element matrix, and stores only the geometry at the quadrature points. The diagonal needed by PCJACOBI is computed
+  the same way. Other discretizations are applied with the element matrices, one cell at a time.
+*/
+typedef struct {
+  Vec        X;             /* local linearization point, with the boundary values */
+  void      *user;          /* context for the pointwise functions */
+  PetscBool  sumfact;       /* use sum factorization when the discretization allows it */
+  PetscBool  setup;         /* the tensor product structure was looked for */
+  PetscBool  tensor;        /* the operator is applied with sum factorization */
+  PetscInt   dim, Nc, Nb;   /* dimension, number of components and closure size */
+  PetscInt   n, m;          /* number of 1D nodes and of 1D quadrature points */
+  PetscInt   cStart, cEnd;  /* cells */
+  PetscInt  *bperm;         /* closure index to component*n^dim + lexicographic node */
+  PetscReal *B, *D;         /* 1D basis and derivative at the 1D quadrature points, m x n */
+  PetscReal *BB, *BD, *DD;  /* their elementwise products, for the diagonal */
+  PetscReal *invJ, *wdetJ, *x; /* geometry of the cells at the lexicographic quadrature points */
+} DMPlexMatrixFree;
+
+static PetscErrorCode DMPlexMatrixFreeResetTensor_Private(DMPlexMatrixFree *mf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(mf->bperm);CHKERRQ(ierr);
+  ierr = PetscFree5(mf->B, mf->D, mf->BB, mf->BD, mf->DD);CHKERRQ(ierr);
+  ierr = PetscFree3(mf->invJ, mf->wdetJ, mf->x);CHKERRQ(ierr);
+  mf->tensor = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexMatrixFreeDestroy_Private(void *ctx)
+{
+  DMPlexMatrixFree *mf = (DMPlexMatrixFree *) ctx;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexMatrixFreeResetTensor_Private(mf);CHKERRQ(ierr);
+  ierr = VecDestroy(&mf->X);CHKERRQ(ierr);
+  ierr = PetscFree(mf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexMatrixFreeGet_Private(Mat A, DMPlexMatrixFree **mf)
+{
+  PetscContainer container;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *mf  = NULL;
+  ierr = PetscObjectQuery((PetscObject) A, "DMPlexMatrixFree", (PetscObject *) &container);CHKERRQ(ierr);
+  if (container) {ierr = PetscContainerGetPointer(container, (void **) mf);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* Sorted distinct values of v[], within tol */
+static PetscErrorCode DMPlexMatrixFreeUnique_Private(PetscInt N, const PetscReal v[], PetscReal tol, PetscInt *n, PetscReal **u)
+{
+  PetscReal     *w;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(N, &w);CHKERRQ(ierr);
+  ierr = PetscArraycpy(w, v, N);CHKERRQ(ierr);
+  ierr = PetscSortReal(N, w);CHKERRQ(ierr);
+  for (i = 0, *n = 0; i < N; ++i) if (!*n || w[i] - w[*n-1] > tol) w[(*n)++] = w[i];
+  *u   = w;
+  PetscFunctionReturn(0);
+}
+
+static PetscInt DMPlexMatrixFreeFind_Private(PetscInt n, const PetscReal u[], PetscReal v, PetscReal tol)
+{
+  PetscInt i;
+
+  for (i = 0; i < n; ++i) if (PetscAbsReal(u[i] - v) <= tol) return i;
+  return -1;
+}
+
+/*
+  Look for the tensor product structure of the discretization: the basis functions must be the products of the 1D
+  Lagrange polynomials on the nodes of the dual space, and the quadrature points a tensor product grid. The 1D
+  tabulation is checked against the tabulation of the PetscFE, so any mismatch falls back to the element matrices.
+*/
+static PetscErrorCode DMPlexMatrixFreeSetUpTensor_Private(DM dm, DMPlexMatrixFree *mf)
+{
+  const PetscReal  tol = 1.e-10;
+  PetscDS          ds;
+  PetscFE          fe;
+  PetscObject      obj;
+  PetscClassId     id;
+  PetscDualSpace   sp;
+  PetscQuadrature  quad;
+  PetscTabulation  T;
+  DMField          coordField;
+  Vec              A;
+  IS               cellIS;
+  PetscFEGeom     *geom;
+  const PetscReal *qpoints, *qweights;
+  PetscReal       *nodes, *xq = NULL, *xn = NULL;
+  PetscInt        *comp, *bind, *qind, *qperm;
+  PetscInt         dim, cdim, Nds, Nf, Nc, Nb, qdim, qNc, nq, nn, n = 0, m = 0, cStart, cEnd, c, b, q, i, j, k, l;
+  PetscBool        ok = PETSC_TRUE;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  mf->setup  = PETSC_TRUE;
+  mf->tensor = PETSC_FALSE;
+  if (!mf->sumfact) PetscFunctionReturn(0);
+  ierr = DMGetDimension(dm, &dim);CHKERRQ(ierr);
+  ierr = DMGetCoordinateDim(dm, &cdim);CHKERRQ(ierr);
+  if (dim < 2 || dim > 3 || cdim != dim) PetscFunctionReturn(0);
+  ierr = DMGetNumDS(dm, &Nds);CHKERRQ(ierr);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  ierr = DMGetAuxiliaryVec(dm, NULL, 0, &A);CHKERRQ(ierr);
+  if (Nds != 1 || Nf != 1 || A) PetscFunctionReturn(0);
+  ierr = PetscDSGetDiscretization(ds, 0, &obj);CHKERRQ(ierr);
+  ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+  if (id != PETSCFE_CLASSID) PetscFunctionReturn(0);
+  fe   = (PetscFE) obj;
+  ierr = DMPlexGetHeightStratum(dm, 0, &cStart, &cEnd);CHKERRQ(ierr);
+  for (c = cStart; c < cEnd; ++c) {
+    DMPolytopeType ct;
+
+    ierr = DMPlexGetCellType(dm, c, &ct);CHKERRQ(ierr);
+    if (ct != (dim == 2 ? DM_POLYTOPE_QUADRILATERAL : DM_POLYTOPE_HEXAHEDRON)) PetscFunctionReturn(0);
+  }
+  ierr = PetscFEGetNumComponents(fe, &Nc);CHKERRQ(ierr);
+  ierr = PetscFEGetDimension(fe, &Nb);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &quad);CHKERRQ(ierr);
+  ierr = PetscQuadratureGetData(quad, &qdim, &qNc, &nq, &qpoints, &qweights);CHKERRQ(ierr);
+  if (qdim != dim || qNc != 1) PetscFunctionReturn(0);
+  ierr = PetscFEGetDualSpace(fe, &sp);CHKERRQ(ierr);
+  ierr = PetscMalloc5(Nb*dim, &nodes, Nb, &comp, Nb*dim, &bind, nq*dim, &qind, nq, &qperm);CHKERRQ(ierr);
+  /* Quadrature points: a tensor product grid, numbered lexicographically with the first direction fastest */
+  ierr = DMPlexMatrixFreeUnique_Private(nq*dim, qpoints, tol, &m, &xq);CHKERRQ(ierr);
+  if (PetscPowInt(m, dim) != nq) ok = PETSC_FALSE;
+  for (q = 0; q < nq; ++q) qperm[q] = -1;
+  for (q = 0; ok && q < nq; ++q) {
+    PetscInt lex = 0;
+
+    for (k = dim-1; k >= 0; --k) {
+      qind[q*dim+k] = DMPlexMatrixFreeFind_Private(m, xq, qpoints[q*dim+k], tol);
+      lex = lex*m + qind[q*dim+k];
+    }
+    if (qperm[lex] >= 0) ok = PETSC_FALSE;
+    else qperm[lex] = q;
+  }
+  /* Nodes: each functional of the dual space evaluates one component at one point */
+  for (b = 0; ok && b < Nb; ++b) {
+    PetscQuadrature  f;
+    const PetscReal *fpoints, *fweights;
+    PetscInt         fNc, fNp;
+
+    ierr = PetscDualSpaceGetFunctional(sp, b, &f);CHKERRQ(ierr);
+    ierr = PetscQuadratureGetData(f, NULL, &fNc, &fNp, &fpoints, &fweights);CHKERRQ(ierr);
+    if (fNp != 1 || fNc != Nc) {ok = PETSC_FALSE; break;}
+    for (i = 0, comp[b] = -1; i < Nc; ++i) {
+      if (PetscAbsReal(fweights[i]) > tol) {
+        if (comp[b] >= 0) ok = PETSC_FALSE;
+        comp[b] = i;
+      }
+    }
+    if (comp[b] < 0) ok = PETSC_FALSE;
+    for (k = 0; k < dim; ++k) nodes[b*dim+k] = fpoints[k];
+  }
+  if (ok) {
+    ierr = DMPlexMatrixFreeUnique_Private(Nb*dim, nodes, tol, &n, &xn);CHKERRQ(ierr);
+    if (Nc*PetscPowInt(n, dim) != Nb) ok = PETSC_FALSE;
+  }
+  nn = ok ? PetscPowInt(n, dim) : 0;
+  if (ok) {
+    ierr = PetscMalloc1(Nb, &mf->bperm);CHKERRQ(ierr);
+    for (b = 0; b < Nb; ++b) mf->bperm[b] = -1;
+    for (b = 0; ok && b < Nb; ++b) {
+      PetscInt lex = 0;
+
+      for (k = dim-1; k >= 0; --k) {
+        const PetscInt ind = DMPlexMatrixFreeFind_Private(n, xn, nodes[b*dim+k], tol);
+
+        bind[b*dim+k] = ind;
+        lex = lex*n + ind;
+      }
+      lex += comp[b]*nn;
+      for (l = 0; l < b; ++l) if (mf->bperm[l] == lex) ok = PETSC_FALSE;
+      mf->bperm[b] = lex;
+    }
+  }
+  /* 1D Lagrange polynomials on the nodes and their derivatives at the quadrature points */
+  if (ok) {
+    ierr = PetscMalloc5(m*n, &mf->B, m*n, &mf->D, m*n, &mf->BB, m*n, &mf->BD, m*n, &mf->DD);CHKERRQ(ierr);
+    for (j = 0; j < m; ++j) {
+      for (i = 0; i < n; ++i) {
+        PetscReal v = 1.0, d = 0.0;
+
+        for (l = 0; l < n; ++l) {
+          PetscReal t;
+
+          if (l == i) continue;
+          t = 1.0 / (xn[i] - xn[l]);
+          for (k = 0; k < n; ++k) if (k != i && k != l) t *= (xq[j] - xn[k]) / (xn[i] - xn[k]);
+          d += t;
+          v *= (xq[j] - xn[l]) / (xn[i] - xn[l]);
+        }
+        mf->B[j*n+i]  = v;
+        mf->D[j*n+i]  = d;
+        mf->BB[j*n+i] = v*v;
+        mf->BD[j*n+i] = v*d;
+        mf->DD[j*n+i] = d*d;
+      }
+    }
+    /* Check against the tabulation of the element */
+    ierr = PetscFEGetCellTabulation(fe, 1, &T);CHKERRQ(ierr);
+    for (q = 0; ok && q < nq; ++q) {
+      for (b = 0; ok && b < Nb; ++b) {
+        for (i = 0; ok && i < Nc; ++i) {
+          PetscReal v = 0.0, d[3] = {0.0, 0.0, 0.0}, t;
+          PetscInt  e;
+
+          if (i == comp[b]) {
+            for (e = 0; e < dim; ++e) d[e] = 1.0;
+            for (k = 0, v = 1.0; k < dim; ++k) {
+              const PetscInt ind = qind[q*dim+k]*n + bind[b*dim+k];
+
+              v *= mf->B[ind];
+              for (e = 0; e < dim; ++e) d[e] *= e == k ? mf->D[ind] : mf->B[ind];
+            }
+          }
+          t = T->T[0][(q*Nb+b)*Nc+i];
+          if (PetscAbsReal(t - v) > 1.e-8*PetscMax(1.0, PetscAbsReal(v))) ok = PETSC_FALSE;
+          for (e = 0; e < dim; ++e) {
+            t = T->T[1][((q*Nb+b)*Nc+i)*dim+e];
+            if (PetscAbsReal(t - d[e]) > 1.e-8*PetscMax(1.0, PetscAbsReal(d[e]))) ok = PETSC_FALSE;
+          }
+        }
+      }
+    }
+  }
+  /* Geometry at the quadrature points, in lexicographic order */
+  if (ok) {
+    ierr = PetscMalloc3((cEnd-cStart)*nq*dim*dim, &mf->invJ, (cEnd-cStart)*nq, &mf->wdetJ, (cEnd-cStart)*nq*dim, &mf->x);CHKERRQ(ierr);
+    if (cEnd > cStart) {
+      ierr = ISCreateStride(PETSC_COMM_SELF, cEnd-cStart, cStart, 1, &cellIS);CHKERRQ(ierr);
+      ierr = DMGetCoordinateField(dm, &coordField);CHKERRQ(ierr);
+      ierr = DMFieldCreateFEGeom(coordField, cellIS, quad, PETSC_FALSE, &geom);CHKERRQ(ierr);
+      for (c = 0; c < cEnd-cStart; ++c) {
+        for (l = 0; l < nq; ++l) {
+          const PetscInt p = c*nq + qperm[l];
+
+          for (k = 0; k < dim*dim; ++k) mf->invJ[(c*nq+l)*dim*dim+k] = geom->invJ[p*dim*dim+k];
+          for (k = 0; k < dim; ++k)     mf->x[(c*nq+l)*dim+k]        = geom->v[p*dim+k];
+          mf->wdetJ[c*nq+l] = geom->detJ[p]*qweights[qperm[l]];
+        }
+      }
+      ierr = PetscFEGeomDestroy(&geom);CHKERRQ(ierr);
+      ierr = ISDestroy(&cellIS);CHKERRQ(ierr);
+    }
+    mf->dim    = dim;
+    mf->Nc     = Nc;
+    mf->Nb     = Nb;
+    mf->n      = n;
+    mf->m      = m;
+    mf->cStart = cStart;
+    mf->cEnd   = cEnd;
+    mf->tensor = PETSC_TRUE;
+    ierr = PetscInfo2(dm, "Applying the matrix-free operator with sum factorization, %D nodes and %D quadrature points per direction\n", n, m);CHKERRQ(ierr);
+  } else {
+    ierr = DMPlexMatrixFreeResetTensor_Private(mf);CHKERRQ(ierr);
+    ierr = PetscInfo(dm, "The discretization is not a tensor product, applying the matrix-free operator with element matrices\n");CHKERRQ(ierr);
+  }
+  ierr = PetscFree(xq);CHKERRQ(ierr);
+  ierr = PetscFree(xn);CHKERRQ(ierr);
+  ierr = PetscFree5(nodes, comp, bind, qind, qperm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* out[k][p][i] = sum_r A[p][r] in[k][r][i], where A is P x R, or A^T when A is R x P */
+static void DMPlexMatrixFreeContract_Private(PetscInt pre, PetscInt R, PetscInt P, PetscInt post, const PetscReal A[], PetscBool transpose, const PetscScalar in[], PetscScalar out[])
+{
+  PetscInt k, p, r, i;
+
+  for (k = 0; k < post; ++k) {
+    for (p = 0; p < P; ++p) {
+      PetscScalar *o = &out[(k*P+p)*pre];
+
+      for (i = 0; i < pre; ++i) o[i] = 0.0;
+      for (r = 0; r < R; ++r) {
+        const PetscReal    a  = transpose ? A[r*P+p] : A[p*R+r];
+        const PetscScalar *in_ = &in[(k*R+r)*pre];
+
+        for (i = 0; i < pre; ++i) o[i] += a*in_[i];
+      }
+    }
+  }
+}
+
+/* Apply A[0] x ... x A[dim-1] to a tensor with R points per direction, the first direction fastest, giving P points per direction */
+static PetscErrorCode DMPlexMatrixFreeTensorApply_Private(PetscInt dim, PetscInt R, PetscInt P, const PetscReal *A[], PetscBool transpose, const PetscScalar in[], PetscBool add, PetscScalar out[], PetscScalar work[])
+{
+  const PetscInt     size = PetscPowInt(PetscMax(R, P), dim);
+  const PetscScalar *src  = in;
+  PetscScalar       *dst;
+  PetscInt           k, i, pre = 1, post = PetscPowInt(R, dim-1);
+  PetscLogDouble     flops = 0.0;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  for (k = 0; k < dim; ++k) {
+    dst = (k == dim-1 && !add) ? out : &work[(k%2)*size];
+    DMPlexMatrixFreeContract_Private(pre, R, P, post, A[k], transpose, src, dst);
+    flops += 2.0*pre*R*P*post;
+    src    = dst;
+    pre   *= P;
+    if (k < dim-1) post /= R;
+  }
+  if (add) {
+    for (i = 0; i < pre; ++i) out[i] += src[i];
+    flops += pre;
+  }
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Z = J(X) Y with sum factorization, or the diagonal of J(X) when Y is NULL; X, Y and Z are local vectors */
+static PetscErrorCode DMPlexMatrixFreeApplyTensor_Private(DM dm, DMPlexMatrixFree *mf, Vec Y, Vec Z)
+{
+  const PetscInt     dim = mf->dim, Nc = mf->Nc, Nb = mf->Nb, n = mf->n, m = mf->m;
+  const PetscInt     nn = PetscPowInt(n, dim), nq = PetscPowInt(m, dim), Nt = Y ? dim+1 : (dim+1)*(dim+1);
+  PetscDS            ds;
+  PetscWeakForm      wf;
+  PetscSection       section;
+  PetscPointJac     *g0_func, *g1_func, *g2_func, *g3_func;
+  const PetscScalar *constants;
+  const PetscReal   *A[3];
+  PetscScalar       *xe, *ye, *ze, *U, *V, *F, *work, *z, *u, *u_x, *du, *du_x, *g0, *g1, *g2, *g3, *f1;
+  PetscInt          *uOff, *uOff_x, n0, n1, n2, n3, numConstants, c, b, q, k, e, s, t, fc, gc, df, dg;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = DMGetLocalSection(dm, &section);CHKERRQ(ierr);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = PetscDSGetWeakForm(ds, &wf);CHKERRQ(ierr);
+  ierr = PetscWeakFormGetJacobian(wf, NULL, 0, 0, 0, 0, &n0, &g0_func, &n1, &g1_func, &n2, &g2_func, &n3, &g3_func);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  ierr = PetscMalloc6(3*Nc*nn, &xe, Nc*(dim+1)*nq, &U, Y ? Nc*(dim+1)*nq : 0, &V, Nc*Nt*nq, &F, 2*PetscPowInt(PetscMax(n, m), dim), &work, Nb, &z);CHKERRQ(ierr);
+  ierr = PetscMalloc5(Nc, &u, Nc*dim, &u_x, Nc, &du, Nc*dim, &du_x, Nc*dim, &f1);CHKERRQ(ierr);
+  ierr = PetscMalloc4(Nc*Nc, &g0, Nc*Nc*dim, &g1, Nc*Nc*dim, &g2, Nc*Nc*dim*dim, &g3);CHKERRQ(ierr);
+  ye   = xe + Nc*nn;
+  ze   = ye + Nc*nn;
+  ierr = VecSet(Z, 0.0);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(DMPLEX_JacobianFEM, dm, 0, 0, 0);CHKERRQ(ierr);
+  for (c = mf->cStart; c < mf->cEnd; ++c) {
+    const PetscInt   ci    = c - mf->cStart;
+    const PetscReal *invJ  = &mf->invJ[ci*nq*dim*dim];
+    const PetscReal *wdetJ = &mf->wdetJ[ci*nq];
+    const PetscReal *x     = &mf->x[ci*nq*dim];
+    PetscScalar     *cl    = NULL;
+
+    /* Values and reference gradients of the linearization point, and of the trial function, at the quadrature points */
+    ierr = DMPlexVecGetClosure(dm, section, mf->X, c, NULL, &cl);CHKERRQ(ierr);
+    for (b = 0; b < Nb; ++b) xe[mf->bperm[b]] = cl[b];
+    ierr = DMPlexVecRestoreClosure(dm, section, mf->X, c, NULL, &cl);CHKERRQ(ierr);
+    if (Y) {
+      ierr = DMPlexVecGetClosure(dm, section, Y, c, NULL, &cl);CHKERRQ(ierr);
+      for (b = 0; b < Nb; ++b) ye[mf->bperm[b]] = cl[b];
+      ierr = DMPlexVecRestoreClosure(dm, section, Y, c, NULL, &cl);CHKERRQ(ierr);
+    }
+    for (fc = 0; fc < Nc; ++fc) {
+      for (e = 0; e <= dim; ++e) {
+        for (k = 0; k < dim; ++k) A[k] = e == k+1 ? mf->D : mf->B;
+        ierr = DMPlexMatrixFreeTensorApply_Private(dim, n, m, A, PETSC_FALSE, &xe[fc*nn], PETSC_FALSE, &U[(fc*(dim+1)+e)*nq], work);CHKERRQ(ierr);
+        if (Y) {ierr = DMPlexMatrixFreeTensorApply_Private(dim, n, m, A, PETSC_FALSE, &ye[fc*nn], PETSC_FALSE, &V[(fc*(dim+1)+e)*nq], work);CHKERRQ(ierr);}
+      }
+    }
+    /* Pointwise Jacobian at each quadrature point, mapped back to the reference cell */
+    for (q = 0; q < nq; ++q) {
+      const PetscReal *iJ = &invJ[q*dim*dim];
+      PetscInt         i;
+
+      for (fc = 0; fc < Nc; ++fc) {
+        u[fc] = U[fc*(dim+1)*nq+q];
+        if (Y) du[fc] = V[fc*(dim+1)*nq+q];
+        for (df = 0; df < dim; ++df) {
+          u_x[fc*dim+df] = 0.0;
+          if (Y) du_x[fc*dim+df] = 0.0;
+          for (e = 0; e < dim; ++e) {
+            u_x[fc*dim+df] += U[(fc*(dim+1)+e+1)*nq+q]*iJ[e*dim+df];
+            if (Y) du_x[fc*dim+df] += V[(fc*(dim+1)+e+1)*nq+q]*iJ[e*dim+df];
+          }
+        }
+      }
+      ierr = PetscArrayzero(g0, Nc*Nc);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g1, Nc*Nc*dim);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g2, Nc*Nc*dim);CHKERRQ(ierr);
+      ierr = PetscArrayzero(g3, Nc*Nc*dim*dim);CHKERRQ(ierr);
+      for (i = 0; i < n0; ++i) g0_func[i](dim, 1, 0, uOff, uOff_x, u, NULL, u_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &x[q*dim], numConstants, constants, g0);
+      for (i = 0; i < n1; ++i) g1_func[i](dim, 1, 0, uOff, uOff_x, u, NULL, u_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &x[q*dim], numConstants, constants, g1);
+      for (i = 0; i < n2; ++i) g2_func[i](dim, 1, 0, uOff, uOff_x, u, NULL, u_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &x[q*dim], numConstants, constants, g2);
+      for (i = 0; i < n3; ++i) g3_func[i](dim, 1, 0, uOff, uOff_x, u, NULL, u_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &x[q*dim], numConstants, constants, g3);
+      if (Y) {
+        /* F[fc][0] multiplies the test function, F[fc][e+1] its reference derivative in direction e */
+        for (fc = 0; fc < Nc; ++fc) {
+          PetscScalar f0 = 0.0;
+
+          for (df = 0; df < dim; ++df) f1[fc*dim+df] = 0.0;
+          for (gc = 0; gc < Nc; ++gc) {
+            f0 += g0[fc*Nc+gc]*du[gc];
+            for (dg = 0; dg < dim; ++dg) f0 += g1[(fc*Nc+gc)*dim+dg]*du_x[gc*dim+dg];
+            for (df = 0; df < dim; ++df) {
+              f1[fc*dim+df] += g2[(fc*Nc+gc)*dim+df]*du[gc];
+              for (dg = 0; dg < dim; ++dg) f1[fc*dim+df] += g3[((fc*Nc+gc)*dim+df)*dim+dg]*du_x[gc*dim+dg];
+            }
+          }
+          F[fc*(dim+1)*nq+q] = wdetJ[q]*f0;
+          for (e = 0; e < dim; ++e) {
+            PetscScalar r = 0.0;
+
+            for (df = 0; df < dim; ++df) r += iJ[e*dim+df]*f1[fc*dim+df];
+            F[(fc*(dim+1)+e+1)*nq+q] = wdetJ[q]*r;
+          }
+        }
+      } else {
+        /* F[fc][s][t] multiplies the test function (s = 0) or its reference derivative s-1, times the trial function (t = 0) or its reference derivative t-1 */
+        for (fc = 0; fc < Nc; ++fc) {
+          const PetscInt cc = fc*Nc+fc;
+
+          for (s = 0; s <= dim; ++s) {
+            for (t = 0; t <= dim; ++t) {
+              PetscScalar r = 0.0;
+
+              if (!s && !t) r = g0[cc];
+              else if (!s) {for (dg = 0; dg < dim; ++dg) r += g1[cc*dim+dg]*iJ[(t-1)*dim+dg];}
+              else if (!t) {for (df = 0; df < dim; ++df) r += g2[cc*dim+df]*iJ[(s-1)*dim+df];}
+              else {
+                for (df = 0; df < dim; ++df) for (dg = 0; dg < dim; ++dg) r += iJ[(s-1)*dim+df]*g3[(cc*dim+df)*dim+dg]*iJ[(t-1)*dim+dg];
+              }
+              F[((fc*(dim+1)+s)*(dim+1)+t)*nq+q] = wdetJ[q]*r;
+            }
+          }
+        }
+      }
+    }
+    /* Integrate against the test functions with the transposed contractions */
+    for (fc = 0; fc < Nc; ++fc) {
+      PetscBool add = PETSC_FALSE;
+
+      if (Y) {
+        for (e = 0; e <= dim; ++e) {
+          if (!e && !n0 && !n1) continue;
+          if (e && !n2 && !n3) continue;
+          for (k = 0; k < dim; ++k) A[k] = e == k+1 ? mf->D : mf->B;
+          ierr = DMPlexMatrixFreeTensorApply_Private(dim, m, n, A, PETSC_TRUE, &F[(fc*(dim+1)+e)*nq], add, &ze[fc*nn], work);CHKERRQ(ierr);
+          add  = PETSC_TRUE;
+        }
+      } else {
+        for (s = 0; s <= dim; ++s) {
+          for (t = 0; t <= dim; ++t) {
+            if ((!s && !t && !n0) || (!s && t && !n1) || (s && !t && !n2) || (s && t && !n3)) continue;
+            for (k = 0; k < dim; ++k) A[k] = (s == k+1) == (t == k+1) ? (s == k+1 ? mf->DD : mf->BB) : mf->BD;
+            ierr = DMPlexMatrixFreeTensorApply_Private(dim, m, n, A, PETSC_TRUE, &F[((fc*(dim+1)+s)*(dim+1)+t)*nq], add, &ze[fc*nn], work);CHKERRQ(ierr);
+            add  = PETSC_TRUE;
+          }
+        }
+      }
+      if (!add) {ierr = PetscArrayzero(&ze[fc*nn], nn);CHKERRQ(ierr);}
+    }
+    for (b = 0; b < Nb; ++b) z[b] = ze[mf->bperm[b]];
+    ierr = DMPlexVecSetClosure(dm, section, Z, c, z, ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(DMPLEX_JacobianFEM, dm, 0, 0, 0);CHKERRQ(ierr);
+  ierr = PetscFree6(xe, U, V, F, work, z);CHKERRQ(ierr);
+  ierr = PetscFree5(u, u_x, du, du_x, f1);CHKERRQ(ierr);
+  ierr = PetscFree4(g0, g1, g2, g3);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Z = J(X) Y, or the diagonal of J(X) when Y is NULL, for local vectors */
+static PetscErrorCode DMPlexMatrixFreeApply_Private(DM dm, DMPlexMatrixFree *mf, Vec Y, Vec Z)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!mf->setup) {ierr = DMPlexMatrixFreeSetUpTensor_Private(dm, mf);CHKERRQ(ierr);}
+  if (mf->tensor) {
+    ierr = DMPlexMatrixFreeApplyTensor_Private(dm, mf, Y, Z);CHKERRQ(ierr);
+  } else {
+    PetscFormKey key;
+
+    key.label = NULL;
+    key.value = 0;
+    key.field = 0;
+    key.part  = 0;
+    ierr = DMPlexComputeJacobian_Action_Internal(dm, key, NULL, 0.0, 0.0, mf->X, NULL, Y, Z, mf->user);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMult_DMPlexMatrixFree(Mat A, Vec Y, Vec Z)
+{
+  DMPlexMatrixFree *mf;
+  DM                dm;
+  Vec               Yl, Zl;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexMatrixFreeGet_Private(A, &mf);CHKERRQ(ierr);
+  ierr = MatGetDM(A, &dm);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(dm, &Yl);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(dm, &Zl);CHKERRQ(ierr);
+  /* the constrained values of the trial function are zero */
+  ierr = VecSet(Yl, 0.0);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm, Y, INSERT_VALUES, Yl);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm, Y, INSERT_VALUES, Yl);CHKERRQ(ierr);
+  ierr = DMPlexMatrixFreeApply_Private(dm, mf, Yl, Zl);CHKERRQ(ierr);
+  ierr = VecSet(Z, 0.0);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(dm, Zl, ADD_VALUES, Z);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(dm, Zl, ADD_VALUES, Z);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm, &Yl);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm, &Zl);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetDiagonal_DMPlexMatrixFree(Mat A, Vec D)
+{
+  DMPlexMatrixFree *mf;
+  DM                dm;
+  Vec               Dl;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexMatrixFreeGet_Private(A, &mf);CHKERRQ(ierr);
+  ierr = MatGetDM(A, &dm);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(dm, &Dl);CHKERRQ(ierr);
+  ierr = DMPlexMatrixFreeApply_Private(dm, mf, NULL, Dl);CHKERRQ(ierr);
+  ierr = VecSet(D, 0.0);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(dm, Dl, ADD_VALUES, D);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(dm, Dl, ADD_VALUES, D);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm, &Dl);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  DMPlexCreateMatrixFree_Internal - Make the MATSHELL created by DMCreateMatrix() apply the Jacobian of the PetscFE
+  discretization of the DM matrix-free. The linearization point is set by DMPlexSNESComputeJacobianFEM(), and is zero
+  until then. Nothing is done if the DM has no PetscFE discretization, so that the shell can be defined by the user.
+*/
+PetscErrorCode DMPlexCreateMatrixFree_Internal(DM dm, Mat J)
+{
+  DMPlexMatrixFree *mf;
+  PetscContainer    container;
+  PetscDS           ds;
+  PetscInt          Nds, Nf, f;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = DMGetNumDS(dm, &Nds);CHKERRQ(ierr);
+  if (Nds != 1) PetscFunctionReturn(0);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  if (!Nf) PetscFunctionReturn(0);
+  for (f = 0; f < Nf; ++f) {
+    PetscObject  obj;
+    PetscClassId id;
+
+    ierr = PetscDSGetDiscretization(ds, f, &obj);CHKERRQ(ierr);
+    ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+    if (id != PETSCFE_CLASSID) PetscFunctionReturn(0);
+  }
+  ierr = PetscNew(&mf);CHKERRQ(ierr);
+  mf->sumfact = PETSC_TRUE;
+  ierr = PetscObjectOptionsBegin((PetscObject) dm);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-dm_plex_matfree_sumfact", "Apply the matrix-free operator of tensor product elements with sum factorization", "DMCreateMatrix", mf->sumfact, &mf->sumfact, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(dm, &mf->X);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF, &container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container, mf);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container, DMPlexMatrixFreeDestroy_Private);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject) J, "DMPlexMatrixFree", (PetscObject) container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(J, MATOP_MULT, (void (*)(void)) MatMult_DMPlexMatrixFree);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(J, MATOP_GET_DIAGONAL, (void (*)(void)) MatGetDiagonal_DMPlexMatrixFree);CHKERRQ(ierr);
+  ierr = MatSetUp(J);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+  DMPlexMatrixFreeSetState_Internal - Set the local linearization point, with its boundary values, and the user context
+  of a matrix-free operator created by DMCreateMatrix(); isMF tells whether J is such an operator.
+*/
+PetscErrorCode DMPlexMatrixFreeSetState_Internal(Mat J, Vec X, void *user, PetscBool *isMF)
+{
+  DMPlexMatrixFree *mf;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr  = DMPlexMatrixFreeGet_Private(J, &mf);CHKERRQ(ierr);
+  *isMF = mf ? PETSC_TRUE : PETSC_FALSE;
+  if (!mf) PetscFunctionReturn(0);
+  ierr = VecCopy(X, mf->X);CHKERRQ(ierr);
+  mf->user = user;
+  /* The operator changed, so that preconditioners built from it, e.g. from its diagonal, are rebuilt */
+  ierr = PetscObjectStateIncrease((PetscObject) J);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
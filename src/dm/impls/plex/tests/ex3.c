@@ -24,6 +24,7 @@ typedef struct {
   PetscBool constraints;       /* Test local constraints */
   PetscBool tree;              /* Test tree routines */
   PetscBool testFEjacobian;    /* Test finite element Jacobian assembly */
+  PetscBool testG2LMultiple;   /* Test the global to local update of several vectors at once */
   PetscBool testFVgrad;        /* Test finite difference gradient routine */
   PetscBool testInjector;      /* Test finite element injection routines */
   PetscInt  treeCell;          /* Cell to refine in tree test */
@@ -126,6 +127,7 @@ static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   options->tree            = PETSC_FALSE;
   options->treeCell        = 0;
   options->testFEjacobian  = PETSC_FALSE;
+  options->testG2LMultiple = PETSC_FALSE;
   options->testFVgrad      = PETSC_FALSE;
   options->testInjector    = PETSC_FALSE;
   options->constants[0]    = 1.0;
@@ -145,6 +147,7 @@ static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   ierr = PetscOptionsBool("-tree", "Test tree routines", "ex3.c", options->tree, &options->tree, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBoundedInt("-tree_cell", "cell to refine in tree test", "ex3.c", options->treeCell, &options->treeCell, NULL,0);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-test_fe_jacobian", "Test finite element Jacobian assembly", "ex3.c", options->testFEjacobian, &options->testFEjacobian, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-test_g2l_multiple", "Test the global to local update of several vectors at once", "ex3.c", options->testG2LMultiple, &options->testG2LMultiple, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-test_fv_grad", "Test finite volume gradient reconstruction", "ex3.c", options->testFVgrad, &options->testFVgrad, NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-test_injector","Test finite element injection", "ex3.c", options->testInjector, &options->testInjector,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsRealArray("-constants","Set the constant values", "ex3.c", options->constants, &n,NULL);CHKERRQ(ierr);
@@ -509,6 +512,47 @@ static PetscErrorCode TestFEJacobian(DM dm, AppCtx *user)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode TestGlobalToLocalMultiple(DM dm, AppCtx *user)
+{
+  MatNullSpace   sp;
+  const Vec     *vecs;
+  Vec           *localX, localY;
+  PetscInt       n, i;
+  PetscBool      hasConst, equal, pass = PETSC_TRUE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  if (user->useDA) PetscFunctionReturn(0);
+  ierr = DMPlexCreateRigidBody(dm,0,&sp);CHKERRQ(ierr);
+  ierr = MatNullSpaceGetVecs(sp,&hasConst,&n,&vecs);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&localX);CHKERRQ(ierr);
+  for (i = 0; i < n; i++) {
+    ierr = DMCreateLocalVector(dm,&localX[i]);CHKERRQ(ierr);
+    ierr = VecSet(localX[i],0.);CHKERRQ(ierr);
+  }
+  ierr = DMGetLocalVector(dm,&localY);CHKERRQ(ierr);
+  /* update the local forms of all the null space vectors with one exchange, and compare with one update per vector */
+  ierr = DMGlobalToLocalMultipleBegin(dm,n,vecs,INSERT_VALUES,localX);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalMultipleEnd(dm,n,vecs,INSERT_VALUES,localX);CHKERRQ(ierr);
+  for (i = 0; i < n; i++) {
+    ierr = VecSet(localY,0.);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBegin(dm,vecs[i],INSERT_VALUES,localY);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(dm,vecs[i],INSERT_VALUES,localY);CHKERRQ(ierr);
+    ierr = VecEqual(localX[i],localY,&equal);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&equal,1,MPIU_BOOL,MPI_LAND,PetscObjectComm((PetscObject)dm));CHKERRMPI(ierr);
+    if (!equal) {
+      ierr = PetscPrintf(PetscObjectComm((PetscObject)dm),"Multiple global to local differs for null space vector %D\n",i);CHKERRQ(ierr);
+      pass = PETSC_FALSE;
+    }
+  }
+  ierr = PetscPrintf(PetscObjectComm((PetscObject)dm),"Multiple global to local of %D vectors: %s\n",n,pass ? "PASS" : "FAIL");CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm,&localY);CHKERRQ(ierr);
+  for (i = 0; i < n; i++) {ierr = VecDestroy(&localX[i]);CHKERRQ(ierr);}
+  ierr = PetscFree(localX);CHKERRQ(ierr);
+  ierr = MatNullSpaceDestroy(&sp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode TestInjector(DM dm, AppCtx *user)
 {
   DM             refTree;
@@ -883,6 +927,7 @@ int main(int argc, char **argv)
   ierr = PetscFECreateDefault(PETSC_COMM_WORLD, dim, user.numComponents, simplex, NULL, user.qorder, &user.fe);CHKERRQ(ierr);
   ierr = SetupSection(dm, &user);CHKERRQ(ierr);
   if (user.testFEjacobian) {ierr = TestFEJacobian(dm, &user);CHKERRQ(ierr);}
+  if (user.testG2LMultiple) {ierr = TestGlobalToLocalMultiple(dm, &user);CHKERRQ(ierr);}
   if (user.testFVgrad) {ierr = TestFVGrad(dm, &user);CHKERRQ(ierr);}
   if (user.testInjector) {ierr = TestInjector(dm, &user);CHKERRQ(ierr);}
   ierr = CheckFunctions(dm, user.porder, &user);CHKERRQ(ierr);
@@ -1245,6 +1290,10 @@ int main(int argc, char **argv)
     suffix: nonconforming_tensor_3
     nsize: 4
     args: -dist_dm_distribute -test_fe_jacobian -petscpartitioner_type simple -tree -dm_plex_simplex 0 -dm_plex_dim 3 -dm_plex_box_faces 2,2,2 -dm_plex_max_projection_height 2 -petscspace_type tensor -petscspace_degree 1 -qorder 1 -dm_view ascii::ASCII_INFO_DETAIL
+  test:
+    suffix: nonconforming_tensor_2_g2l_multiple
+    nsize: 4
+    args: -dist_dm_distribute -test_g2l_multiple -petscpartitioner_type simple -tree -dm_plex_simplex 0 -dm_plex_max_projection_height 1 -petscspace_type tensor -petscspace_degree 2 -qorder 2
   test:
     suffix: nonconforming_tensor_2_fv
     nsize: 4
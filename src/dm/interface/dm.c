@@ -2709,6 +2709,103 @@ PetscErrorCode  DMGlobalToLocalEnd(DM dm,Vec g,InsertMode mode,Vec l)
   PetscFunctionReturn(0);
 }
 
+/*@
+    DMGlobalToLocalMultipleBegin - Begins updating several local vectors from global vectors with one exchange of messages
+
+    Neighbor-wise Collective on dm
+
+    Input Parameters:
++   dm - the DM object
+.   n - the number of vector pairs
+.   g - the global vectors
+.   mode - INSERT_VALUES or ADD_VALUES
+-   l - the local vectors
+
+    Notes:
+    This has the same effect as calling DMGlobalToLocalBegin() on each pair g[i], l[i]. When the DM communicates
+    with its section PetscSF (e.g., DMPLEX), the entries of all the vectors are interleaved and sent with one message
+    per neighbor process, see VecScatterBeginMultiple(), so that the update of many fields costs the latency of one.
+    Otherwise the vectors are updated one by one.
+
+    Level: intermediate
+
+.seealso DMGlobalToLocalMultipleEnd(), DMGlobalToLocalBegin(), VecScatterBeginMultiple(), VecGhostUpdateMultipleBegin()
+
+@*/
+PetscErrorCode DMGlobalToLocalMultipleBegin(DM dm,PetscInt n,const Vec g[],InsertMode mode,const Vec l[])
+{
+  PetscSF                 sf;
+  PetscErrorCode          ierr;
+  PetscInt                i;
+  DMGlobalToLocalHookLink link;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  if (!n) PetscFunctionReturn(0);
+  PetscValidPointer(g,3);
+  PetscValidPointer(l,5);
+  ierr = DMGetSectionSF(dm, &sf);CHKERRQ(ierr);
+  if (!sf) {
+    for (i=0; i<n; i++) {ierr = DMGlobalToLocalBegin(dm,g[i],mode,l[i]);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  if (mode == ADD_VALUES) SETERRQ1(PetscObjectComm((PetscObject)dm), PETSC_ERR_ARG_OUTOFRANGE, "Invalid insertion mode %D", mode);
+  for (i=0; i<n; i++) {
+    for (link=dm->gtolhook; link; link=link->next) {
+      if (link->beginhook) {ierr = (*link->beginhook)(dm,g[i],mode,l[i],link->ctx);CHKERRQ(ierr);}
+    }
+  }
+  ierr = VecScatterBeginMultiple(sf,n,g,l,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+    DMGlobalToLocalMultipleEnd - Ends updating several local vectors from global vectors
+
+    Neighbor-wise Collective on dm
+
+    Input Parameters:
++   dm - the DM object
+.   n - the number of vector pairs
+.   g - the global vectors
+.   mode - INSERT_VALUES or ADD_VALUES
+-   l - the local vectors
+
+    Level: intermediate
+
+.seealso DMGlobalToLocalMultipleBegin(), DMGlobalToLocalEnd()
+
+@*/
+PetscErrorCode DMGlobalToLocalMultipleEnd(DM dm,PetscInt n,const Vec g[],InsertMode mode,const Vec l[])
+{
+  PetscSF                 sf;
+  PetscErrorCode          ierr;
+  PetscInt                i;
+  PetscBool               transform;
+  DMGlobalToLocalHookLink link;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm,DM_CLASSID,1);
+  if (!n) PetscFunctionReturn(0);
+  PetscValidPointer(g,3);
+  PetscValidPointer(l,5);
+  ierr = DMGetSectionSF(dm, &sf);CHKERRQ(ierr);
+  if (!sf) {
+    for (i=0; i<n; i++) {ierr = DMGlobalToLocalEnd(dm,g[i],mode,l[i]);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = DMHasBasisTransform(dm, &transform);CHKERRQ(ierr);
+  ierr = VecScatterEndMultiple(sf,n,g,l,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    if (transform) {ierr = DMPlexGlobalToLocalBasis(dm, l[i]);CHKERRQ(ierr);}
+    ierr = DMGlobalToLocalHook_Constraints(dm,g[i],mode,l[i],NULL);CHKERRQ(ierr);
+    for (link=dm->gtolhook; link; link=link->next) {
+      if (link->endhook) {ierr = (*link->endhook)(dm,g[i],mode,l[i],link->ctx);CHKERRQ(ierr);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@C
    DMLocalToGlobalHookAdd - adds a callback to be run when a local to global is called
 
@@ -110,4 +110,10 @@ int main(int argc,char **argv)
       args: -dof 3 -stencil_width 2 -M 50 -N 50 -periodic -grid3d
       output_file: output/ex7_1.out
 
+   test:
+      suffix: 4
+      nsize: 8
+      args: -dof 20 -stencil_width 1 -stencil_type 1 -M 12 -N 12 -periodic 1 -grid3d
+      output_file: output/ex7_1.out
+
 TEST*/
@@ -0,0 +1,895 @@
+
+/*
+    Lockstep Krylov methods for many independent small systems stored in one block diagonal operator
+*/
+#include <petsc/private/kspimpl.h>              /*I "petscksp.h" I*/
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+#include <petscsection.h>
+
+typedef struct {
+  KSPBatchMethod     method;
+  PetscInt           restart;         /* restart of the batched GMRES */
+  PetscSection       section;         /* systems given with KSPBatchSetSection(), or NULL */
+  PetscObjectId      Aid;             /* operator and section the systems were computed from */
+  PetscObjectState   Anzstate,Sstate;
+  Mat                Aloc;            /* local AIJ operator, the products are restricted to the active systems */
+  PetscInt           nsys;            /* number of local systems, system s owns the local rows start[s] to end[s]-1 */
+  PetscInt           *start,*end;
+  PetscInt           nactive,*active; /* systems still iterating */
+  PetscInt           ncycle,*cycle;   /* systems that started the current cycle of GMRES */
+  KSPConvergedReason *reason;         /* per system results */
+  PetscInt           *its;
+  PetscReal          *rnorm,*ttol,*rnorm0;
+  PetscScalar        *rho,*rhoold,*alpha,*omega; /* scalars of BiCGStab */
+  PetscScalar        *H,*g,*cs,*sn;   /* Hessenberg matrices, right-hand sides and Givens rotations of GMRES */
+  PetscInt           *kc;             /* number of Arnoldi steps of each system in the current cycle */
+  Vec                *V;              /* Krylov basis of GMRES */
+} KSP_Batch;
+
+/* splits the rows [0,m) at the boundaries of the finest contiguous block diagonal decomposition of the local AIJ matrix */
+static PetscErrorCode KSPBatchDetectSystems_Private(KSP ksp,Mat A,PetscInt m)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  const PetscInt *ia,*ja;
+  PetscInt       i,j,n,lo,hi,*smin;
+  PetscBool      done;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetRowIJ(A,0,PETSC_FALSE,PETSC_FALSE,&n,&ia,&ja,&done);CHKERRQ(ierr);
+  if (!done) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Cannot get the IJ structure of the operator");
+  /* smin[i] is the smallest column of the rows i to m-1 */
+  ierr = PetscMalloc1(m+1,&smin);CHKERRQ(ierr);
+  smin[m] = m;
+  for (i=m-1; i>=0; i--) {
+    smin[i] = PetscMin(smin[i+1],i);
+    for (j=ia[i]; j<ia[i+1]; j++) smin[i] = PetscMin(smin[i],ja[j]);
+  }
+  batch->nsys = 0;
+  for (i=0,lo=0,hi=0; i<m; i++) {
+    hi = PetscMax(hi,i);
+    for (j=ia[i]; j<ia[i+1]; j++) hi = PetscMax(hi,ja[j]);
+    if (hi <= i && smin[i+1] >= i+1) {
+      batch->start[batch->nsys] = lo;
+      batch->end[batch->nsys++] = i+1;
+      lo = i+1;
+    }
+  }
+  ierr = PetscFree(smin);CHKERRQ(ierr);
+  ierr = MatRestoreRowIJ(A,0,PETSC_FALSE,PETSC_FALSE,&n,&ia,&ja,&done);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes the systems: from the PetscSection given with KSPBatchSetSection(), whose points are the systems, their dof their sizes
+   and their offsets their first local rows, or from the variable block sizes of the operator, see MatSetVariableBlockSizes(), or from the
+   structure of AIJ operators; other operators are taken as a single system per process
+*/
+static PetscErrorCode KSPBatchSetUpSystems_Private(KSP ksp)
+{
+  KSP_Batch        *batch = (KSP_Batch*)ksp->data;
+  Mat              A,Ad = NULL,Ao;
+  PetscObjectState nzstate,sstate = 0;
+  PetscObjectId    id;
+  MatInfo          info;
+  const PetscInt   *bsizes,*ia,*ja;
+  PetscInt         m,i,j,s,n,nblocks,pStart,pEnd,dof,off,rows;
+  PetscBool        flg,local,done;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&A,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)A,&id);CHKERRQ(ierr);
+  ierr = MatGetNonzeroState(A,&nzstate);CHKERRQ(ierr);
+  if (batch->section) {ierr = PetscObjectStateGet((PetscObject)batch->section,&sstate);CHKERRQ(ierr);}
+  if (batch->start && id == batch->Aid && nzstate == batch->Anzstate && sstate == batch->Sstate) PetscFunctionReturn(0);
+  batch->Aid      = id;
+  batch->Anzstate = nzstate;
+  batch->Sstate   = sstate;
+
+  /* the local AIJ operator, the systems may not couple rows of different processes */
+  batch->Aloc = NULL;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&flg);CHKERRQ(ierr);
+  if (flg) batch->Aloc = A;
+  else {
+    ierr = PetscObjectTypeCompare((PetscObject)A,MATMPIAIJ,&flg);CHKERRQ(ierr);
+    if (flg) {
+      ierr  = MatMPIAIJGetSeqAIJ(A,&Ad,&Ao,NULL);CHKERRQ(ierr);
+      ierr  = MatGetInfo(Ao,MAT_LOCAL,&info);CHKERRQ(ierr);
+      local = (PetscBool)(info.nz_used == 0.0);
+      ierr  = MPIU_Allreduce(MPI_IN_PLACE,&local,1,MPIU_BOOL,MPI_LAND,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+      if (!local) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_INCOMP,"KSPBATCH needs an operator whose systems are each owned by a single process");
+      batch->Aloc = Ad;
+    }
+  }
+
+  ierr = MatGetLocalSize(A,&m,NULL);CHKERRQ(ierr);
+  ierr = PetscFree2(batch->start,batch->end);CHKERRQ(ierr);
+  ierr = PetscMalloc2(m+1,&batch->start,m+1,&batch->end);CHKERRQ(ierr);
+  ierr = MatGetVariableBlockSizes(A,&nblocks,&bsizes);CHKERRQ(ierr);
+  if (batch->section) {
+    ierr = PetscSectionGetChart(batch->section,&pStart,&pEnd);CHKERRQ(ierr);
+    if (pEnd-pStart > m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"The section has %D systems for %D local rows",pEnd-pStart,m);
+    for (s=pStart,rows=0,batch->nsys=0; s<pEnd; s++) {
+      ierr = PetscSectionGetDof(batch->section,s,&dof);CHKERRQ(ierr);
+      ierr = PetscSectionGetOffset(batch->section,s,&off);CHKERRQ(ierr);
+      if (!dof) continue;
+      if (off < 0 || off+dof > m) SETERRQ4(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"System %D has rows %D to %D outside of the %D local rows",s,off,off+dof-1,m);
+      batch->start[batch->nsys] = off;
+      batch->end[batch->nsys++] = off+dof;
+      rows += dof;
+    }
+    if (rows != m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"The systems of the section have %D rows, the operator has %D local rows",rows,m);
+  } else if (nblocks) {
+    for (s=0,off=0; s<nblocks; s++) {
+      batch->start[s] = off;
+      off            += bsizes[s];
+      batch->end[s]   = off;
+    }
+    batch->nsys = nblocks;
+    if (off != m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"The variable block sizes sum to %D, the operator has %D local rows",off,m);
+  } else if (batch->Aloc) {
+    ierr = KSPBatchDetectSystems_Private(ksp,batch->Aloc,m);CHKERRQ(ierr);
+  } else {
+    batch->nsys     = m ? 1 : 0;
+    batch->start[0] = 0;
+    batch->end[0]   = m;
+  }
+
+  /* the given systems must not be coupled */
+  if (batch->Aloc && (batch->section || nblocks)) {
+    ierr = MatGetRowIJ(batch->Aloc,0,PETSC_FALSE,PETSC_FALSE,&n,&ia,&ja,&done);CHKERRQ(ierr);
+    if (!done) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Cannot get the IJ structure of the operator");
+    for (s=0; s<batch->nsys; s++) {
+      for (i=batch->start[s]; i<batch->end[s]; i++) {
+        for (j=ia[i]; j<ia[i+1]; j++) {
+          if (ja[j] < batch->start[s] || ja[j] >= batch->end[s]) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Local row %D of system %D is coupled to the local column %D of another system",i,s,ja[j]);
+        }
+      }
+    }
+    ierr = MatRestoreRowIJ(batch->Aloc,0,PETSC_FALSE,PETSC_FALSE,&n,&ia,&ja,&done);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree6(batch->active,batch->cycle,batch->reason,batch->its,batch->kc,batch->rnorm);CHKERRQ(ierr);
+  ierr = PetscFree2(batch->ttol,batch->rnorm0);CHKERRQ(ierr);
+  ierr = PetscFree4(batch->rho,batch->rhoold,batch->alpha,batch->omega);CHKERRQ(ierr);
+  ierr = PetscFree4(batch->H,batch->g,batch->cs,batch->sn);CHKERRQ(ierr);
+  n    = batch->nsys;
+  ierr = PetscMalloc6(n,&batch->active,n,&batch->cycle,n,&batch->reason,n,&batch->its,n,&batch->kc,n,&batch->rnorm);CHKERRQ(ierr);
+  ierr = PetscMalloc2(n,&batch->ttol,n,&batch->rnorm0);CHKERRQ(ierr);
+  if (batch->method == KSP_BATCH_BCGS) {
+    ierr = PetscMalloc4(n,&batch->rho,n,&batch->rhoold,n,&batch->alpha,n,&batch->omega);CHKERRQ(ierr);
+  } else {
+    i    = batch->restart;
+    ierr = PetscMalloc4(n*(i+1)*i,&batch->H,n*(i+1),&batch->g,n*i,&batch->cs,n*i,&batch->sn);CHKERRQ(ierr);
+  }
+  ierr = PetscInfo1(ksp,"%D local systems\n",batch->nsys);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* y = A x on the rows of the active systems */
+static PetscErrorCode KSPBatchMatMult_Private(KSP ksp,Vec x,Vec y)
+{
+  KSP_Batch         *batch = (KSP_Batch*)ksp->data;
+  Mat               A;
+  const PetscInt    *ia,*ja;
+  const PetscScalar *aa,*xa;
+  PetscScalar       *ya,sum;
+  PetscInt          k,i,j,n;
+  PetscLogDouble    nz = 0.0;
+  PetscBool         done;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!batch->Aloc) {
+    ierr = PCGetOperators(ksp->pc,&A,NULL);CHKERRQ(ierr);
+    ierr = KSP_MatMult(ksp,A,x,y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatGetRowIJ(batch->Aloc,0,PETSC_FALSE,PETSC_FALSE,&n,&ia,&ja,&done);CHKERRQ(ierr);
+  ierr = MatSeqAIJGetArrayRead(batch->Aloc,&aa);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(x,&xa);CHKERRQ(ierr);
+  ierr = VecGetArray(y,&ya);CHKERRQ(ierr);
+  for (k=0; k<batch->nactive; k++) {
+    const PetscInt s = batch->active[k];
+
+    for (i=batch->start[s]; i<batch->end[s]; i++) {
+      for (sum=0.0,j=ia[i]; j<ia[i+1]; j++) sum += aa[j]*xa[ja[j]];
+      ya[i] = sum;
+    }
+    nz += ia[batch->end[s]]-ia[batch->start[s]];
+  }
+  ierr = VecRestoreArray(y,&ya);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(x,&xa);CHKERRQ(ierr);
+  ierr = MatSeqAIJRestoreArrayRead(batch->Aloc,&aa);CHKERRQ(ierr);
+  ierr = MatRestoreRowIJ(batch->Aloc,0,PETSC_FALSE,PETSC_FALSE,&n,&ia,&ja,&done);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Tests the active systems, whose residual norms were just updated, removes those that stopped, or were stopped by a breakdown during the
+   iteration, from the active list, monitors the norm of the whole residual at iteration ksp->its and returns the global number of active systems
+*/
+static PetscErrorCode KSPBatchConverged_Private(KSP ksp,PetscInt *nactive)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscReal      sums[2] = {0.0,0.0};
+  PetscInt       k,s,n = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<batch->nactive; k++) {
+    s = batch->active[k];
+    batch->its[s]++;
+    if (batch->reason[s]) continue;
+    if (PetscIsInfOrNanReal(batch->rnorm[s])) batch->reason[s] = KSP_DIVERGED_NANORINF;
+    else if (batch->rnorm[s] <= batch->ttol[s]) batch->reason[s] = batch->rnorm[s] < ksp->abstol ? KSP_CONVERGED_ATOL : KSP_CONVERGED_RTOL;
+    else if (batch->rnorm[s] >= ksp->divtol*batch->rnorm0[s]) batch->reason[s] = KSP_DIVERGED_DTOL;
+    if (!batch->reason[s]) batch->active[n++] = s;
+  }
+  batch->nactive = n;
+  for (s=0; s<batch->nsys; s++) if (!PetscIsInfOrNanReal(batch->rnorm[s])) sums[0] += batch->rnorm[s]*batch->rnorm[s];
+  sums[1] = (PetscReal)n;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,sums,2,MPIU_REAL,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = PetscSqrtReal(sums[0]);
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,ksp->rnorm);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,ksp->rnorm);CHKERRQ(ierr);
+  *nactive = (PetscInt)sums[1];
+  PetscFunctionReturn(0);
+}
+
+/* r = b - A x on all the systems, their norms and tolerances, and the initial active list */
+static PetscErrorCode KSPBatchInitialResidual_Private(KSP ksp,Vec r,PetscInt *nactive)
+{
+  KSP_Batch         *batch = (KSP_Batch*)ksp->data;
+  const PetscScalar *ra;
+  PetscReal         sum;
+  PetscInt          s,i,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  batch->nactive = batch->nsys;
+  for (s=0; s<batch->nsys; s++) {
+    batch->active[s] = s;
+    batch->reason[s] = KSP_CONVERGED_ITERATING;
+    batch->its[s]    = 0;
+  }
+  if (!ksp->guess_zero) {
+    ierr = KSPBatchMatMult_Private(ksp,ksp->vec_sol,r);CHKERRQ(ierr);
+    ierr = VecAYPX(r,-1.0,ksp->vec_rhs);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(ksp->vec_rhs,r);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(r,&ra);CHKERRQ(ierr);
+  for (s=0; s<batch->nsys; s++) {
+    for (sum=0.0,i=batch->start[s]; i<batch->end[s]; i++) sum += PetscRealPart(ra[i]*PetscConj(ra[i]));
+    batch->rnorm[s] = batch->rnorm0[s] = PetscSqrtReal(sum);
+    batch->ttol[s]  = PetscMax(ksp->rtol*batch->rnorm0[s],ksp->abstol);
+  }
+  ierr = VecRestoreArrayRead(r,&ra);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(r,&n);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*n);CHKERRQ(ierr);
+
+  /* iteration 0 tests the initial residuals without counting an iteration */
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPBatchConverged_Private(ksp,nactive);CHKERRQ(ierr);
+  for (s=0; s<batch->nsys; s++) batch->its[s] = 0;
+  PetscFunctionReturn(0);
+}
+
+/* right preconditioned BiCGStab, as KSPBCGS, with scalars per system */
+static PetscErrorCode KSPSolve_Batch_BCGS(KSP ksp)
+{
+  KSP_Batch         *batch = (KSP_Batch*)ksp->data;
+  Vec               R,RP,P,V,S,T,PH,SH;
+  PetscScalar       *x,*r,*p,*v,*sv,*tv,*ph,*sh,beta,d1,d2;
+  const PetscScalar *rp;
+  PetscReal         sum;
+  PetscInt          k,s,i,n,nactive;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  R  = ksp->work[0]; RP = ksp->work[1]; P  = ksp->work[2]; V  = ksp->work[3];
+  S  = ksp->work[4]; T  = ksp->work[5]; PH = ksp->work[6]; SH = ksp->work[7];
+  ierr = KSPBatchInitialResidual_Private(ksp,R,&nactive);CHKERRQ(ierr);
+  ierr = VecCopy(R,RP);CHKERRQ(ierr);
+  ierr = VecSet(P,0.0);CHKERRQ(ierr);
+  ierr = VecSet(V,0.0);CHKERRQ(ierr);
+  for (s=0; s<batch->nsys; s++) batch->rhoold[s] = batch->alpha[s] = batch->omega[s] = 1.0;
+
+  while (nactive && ksp->its < ksp->max_it) {
+    /* rho = (r,rp), p = r + beta (p - omega v) */
+    ierr = VecGetArrayRead(RP,&rp);CHKERRQ(ierr);
+    ierr = VecGetArray(R,&r);CHKERRQ(ierr);
+    ierr = VecGetArray(P,&p);CHKERRQ(ierr);
+    ierr = VecGetArray(V,&v);CHKERRQ(ierr);
+    for (k=0,n=0; k<batch->nactive; k++) {
+      s = batch->active[k];
+      for (batch->rho[s]=0.0,i=batch->start[s]; i<batch->end[s]; i++) batch->rho[s] += r[i]*PetscConj(rp[i]);
+      if (batch->rho[s] == 0.0) {
+        batch->reason[s] = KSP_DIVERGED_BREAKDOWN;
+        continue;
+      }
+      beta = (batch->rho[s]/batch->rhoold[s])*(batch->alpha[s]/batch->omega[s]);
+      for (i=batch->start[s]; i<batch->end[s]; i++) p[i] = r[i] + beta*(p[i] - batch->omega[s]*v[i]);
+      batch->active[n++] = s;
+    }
+    batch->nactive = n;
+    ierr = VecRestoreArray(V,&v);CHKERRQ(ierr);
+    ierr = VecRestoreArray(P,&p);CHKERRQ(ierr);
+    ierr = VecRestoreArray(R,&r);CHKERRQ(ierr);
+
+    /* v = A M p, alpha = rho/(v,rp), s = r - alpha v */
+    ierr = KSP_PCApply(ksp,P,PH);CHKERRQ(ierr);
+    ierr = KSPBatchMatMult_Private(ksp,PH,V);CHKERRQ(ierr);
+    ierr = VecGetArray(R,&r);CHKERRQ(ierr);
+    ierr = VecGetArray(V,&v);CHKERRQ(ierr);
+    ierr = VecGetArray(S,&sv);CHKERRQ(ierr);
+    for (k=0,n=0; k<batch->nactive; k++) {
+      s = batch->active[k];
+      for (d1=0.0,i=batch->start[s]; i<batch->end[s]; i++) d1 += v[i]*PetscConj(rp[i]);
+      if (d1 == 0.0 || PetscIsInfOrNanScalar(d1)) {
+        batch->reason[s] = d1 == 0.0 ? KSP_DIVERGED_BREAKDOWN : KSP_DIVERGED_NANORINF;
+        continue;
+      }
+      batch->alpha[s] = batch->rho[s]/d1;
+      for (i=batch->start[s]; i<batch->end[s]; i++) sv[i] = r[i] - batch->alpha[s]*v[i];
+      batch->active[n++] = s;
+    }
+    batch->nactive = n;
+    ierr = VecRestoreArray(S,&sv);CHKERRQ(ierr);
+    ierr = VecRestoreArray(V,&v);CHKERRQ(ierr);
+    ierr = VecRestoreArray(R,&r);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(RP,&rp);CHKERRQ(ierr);
+
+    /* t = A M s, omega = (t,s)/(t,t), x += alpha M p + omega M s, r = s - omega t */
+    ierr = KSP_PCApply(ksp,S,SH);CHKERRQ(ierr);
+    ierr = KSPBatchMatMult_Private(ksp,SH,T);CHKERRQ(ierr);
+    ierr = VecGetArray(ksp->vec_sol,&x);CHKERRQ(ierr);
+    ierr = VecGetArray(R,&r);CHKERRQ(ierr);
+    ierr = VecGetArray(S,&sv);CHKERRQ(ierr);
+    ierr = VecGetArray(T,&tv);CHKERRQ(ierr);
+    ierr = VecGetArray(PH,&ph);CHKERRQ(ierr);
+    ierr = VecGetArray(SH,&sh);CHKERRQ(ierr);
+    for (k=0; k<batch->nactive; k++) {
+      s = batch->active[k];
+      for (d1=0.0,d2=0.0,i=batch->start[s]; i<batch->end[s]; i++) {
+        d1 += sv[i]*PetscConj(tv[i]);
+        d2 += tv[i]*PetscConj(tv[i]);
+      }
+      batch->omega[s] = d2 == 0.0 ? 0.0 : d1/d2;
+      for (sum=0.0,i=batch->start[s]; i<batch->end[s]; i++) {
+        x[i] += batch->alpha[s]*ph[i] + batch->omega[s]*sh[i];
+        r[i]  = sv[i] - batch->omega[s]*tv[i];
+        sum  += PetscRealPart(r[i]*PetscConj(r[i]));
+      }
+      batch->rnorm[s]  = PetscSqrtReal(sum);
+      batch->rhoold[s] = batch->rho[s];
+      /* t = 0 with s != 0, the next rho/omega would divide by zero */
+      if (d2 == 0.0 && batch->rnorm[s] > batch->ttol[s]) batch->reason[s] = KSP_DIVERGED_BREAKDOWN;
+    }
+    ierr = VecRestoreArray(SH,&sh);CHKERRQ(ierr);
+    ierr = VecRestoreArray(PH,&ph);CHKERRQ(ierr);
+    ierr = VecRestoreArray(T,&tv);CHKERRQ(ierr);
+    ierr = VecRestoreArray(S,&sv);CHKERRQ(ierr);
+    ierr = VecRestoreArray(R,&r);CHKERRQ(ierr);
+    ierr = VecRestoreArray(ksp->vec_sol,&x);CHKERRQ(ierr);
+    for (k=0,n=0; k<batch->nactive; k++) n += batch->end[batch->active[k]]-batch->start[batch->active[k]];
+    ierr = PetscLogFlops(22.0*n);CHKERRQ(ierr);
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->its++;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ierr = KSPBatchConverged_Private(ksp,&nactive);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* right preconditioned restarted GMRES with modified Gram-Schmidt, one Hessenberg matrix per system */
+static PetscErrorCode KSPSolve_Batch_GMRES(KSP ksp)
+{
+  KSP_Batch         *batch = (KSP_Batch*)ksp->data;
+  const PetscInt    m = batch->restart,ldh = m+1;
+  Vec               Z = ksp->work[0],*V = batch->V;
+  PetscScalar       **v,*x,*w,*z,*H,*g,*cs,*sn,h,tmp;
+  const PetscScalar *b;
+  PetscReal         sum,nrm;
+  PetscInt          k,s,i,j,l,n,nactive,rows;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPBatchInitialResidual_Private(ksp,V[0],&nactive);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m+1,&v);CHKERRQ(ierr);
+  while (nactive && ksp->its < ksp->max_it) {
+    /* v_0 = r/|r|, the residual is recomputed at each restart */
+    if (ksp->its) {
+      ierr = KSPBatchMatMult_Private(ksp,ksp->vec_sol,V[0]);CHKERRQ(ierr);
+    }
+    ierr = VecGetArray(V[0],&v[0]);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(ksp->vec_rhs,&b);CHKERRQ(ierr);
+    for (k=0; k<batch->nactive; k++) {
+      s = batch->active[k];
+      if (ksp->its) {
+        for (sum=0.0,i=batch->start[s]; i<batch->end[s]; i++) {
+          v[0][i] = b[i] - v[0][i];
+          sum    += PetscRealPart(v[0][i]*PetscConj(v[0][i]));
+        }
+        batch->rnorm[s] = PetscSqrtReal(sum);
+      }
+      for (i=batch->start[s]; i<batch->end[s]; i++) v[0][i] /= batch->rnorm[s];
+      g    = batch->g+s*ldh;
+      g[0] = batch->rnorm[s];
+      batch->kc[s]    = 0;
+      batch->cycle[k] = s;
+    }
+    batch->ncycle = batch->nactive;
+    ierr = VecRestoreArrayRead(ksp->vec_rhs,&b);CHKERRQ(ierr);
+    ierr = VecRestoreArray(V[0],&v[0]);CHKERRQ(ierr);
+
+    for (j=0; j<m && nactive && ksp->its < ksp->max_it; j++) {
+      /* w = A M v_j, orthogonalized against v_0, ..., v_j one system at a time */
+      ierr = KSP_PCApply(ksp,V[j],Z);CHKERRQ(ierr);
+      ierr = KSPBatchMatMult_Private(ksp,Z,V[j+1]);CHKERRQ(ierr);
+      for (l=0; l<=j+1; l++) {ierr = VecGetArray(V[l],&v[l]);CHKERRQ(ierr);}
+      w    = v[j+1];
+      rows = 0;
+      for (k=0; k<batch->nactive; k++) {
+        s  = batch->active[k];
+        H  = batch->H+s*ldh*m+j*ldh;
+        g  = batch->g+s*ldh;
+        cs = batch->cs+s*m;
+        sn = batch->sn+s*m;
+        for (l=0; l<=j; l++) {
+          for (h=0.0,i=batch->start[s]; i<batch->end[s]; i++) h += w[i]*PetscConj(v[l][i]);
+          for (i=batch->start[s]; i<batch->end[s]; i++) w[i] -= h*v[l][i];
+          H[l] = h;
+        }
+        for (sum=0.0,i=batch->start[s]; i<batch->end[s]; i++) sum += PetscRealPart(w[i]*PetscConj(w[i]));
+        H[j+1] = PetscSqrtReal(sum);
+        if (H[j+1] != 0.0) for (i=batch->start[s]; i<batch->end[s]; i++) w[i] /= H[j+1];
+        /* apply the previous rotations and compute the one that eliminates H[j+1], a real number */
+        for (l=0; l<j; l++) {
+          tmp    = cs[l]*H[l] + sn[l]*H[l+1];
+          H[l+1] = -PetscConj(sn[l])*H[l] + cs[l]*H[l+1];
+          H[l]   = tmp;
+        }
+        nrm = PetscSqrtReal(PetscRealPart(H[j]*PetscConj(H[j]) + H[j+1]*PetscConj(H[j+1])));
+        rows += batch->end[s]-batch->start[s];
+        if (nrm == 0.0) {
+          /* singular Hessenberg matrix, the cycle ends with the previous steps */
+          batch->reason[s] = KSP_DIVERGED_BREAKDOWN;
+          continue;
+        }
+        if (H[j] == 0.0) {
+          cs[j] = 0.0;
+          sn[j] = 1.0;
+          H[j]  = H[j+1];
+        } else {
+          tmp   = H[j]/PetscAbsScalar(H[j]);
+          cs[j] = PetscAbsScalar(H[j])/nrm;
+          sn[j] = tmp*PetscConj(H[j+1])/nrm;
+          H[j]  = tmp*nrm;
+        }
+        H[j+1]   = 0.0;
+        g[j+1]   = -PetscConj(sn[j])*g[j];
+        g[j]     = cs[j]*g[j];
+        batch->rnorm[s] = PetscAbsScalar(g[j+1]);
+        batch->kc[s]    = j+1;
+      }
+      for (l=0; l<=j+1; l++) {ierr = VecRestoreArray(V[l],&v[l]);CHKERRQ(ierr);}
+      ierr = PetscLogFlops((4.0*(j+1)+4.0)*rows);CHKERRQ(ierr);
+      ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ksp->its++;
+      ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ierr = KSPBatchConverged_Private(ksp,&nactive);CHKERRQ(ierr);
+    }
+
+    /* x += M V y for the systems of the cycle, H y = g */
+    ierr = VecSet(Z,0.0);CHKERRQ(ierr);
+    ierr = VecGetArray(Z,&z);CHKERRQ(ierr);
+    for (l=0; l<j; l++) {ierr = VecGetArrayRead(V[l],(const PetscScalar**)&v[l]);CHKERRQ(ierr);}
+    for (k=0,n=0; k<batch->ncycle; k++) {
+      s = batch->cycle[k];
+      if (batch->reason[s] == KSP_DIVERGED_NANORINF) continue;
+      H = batch->H+s*ldh*m;
+      g = batch->g+s*ldh;
+      for (l=batch->kc[s]-1; l>=0; l--) {
+        for (i=l+1; i<batch->kc[s]; i++) g[l] -= H[l+i*ldh]*g[i];
+        g[l] /= H[l+l*ldh];
+        for (i=batch->start[s]; i<batch->end[s]; i++) z[i] += g[l]*v[l][i];
+      }
+      n += batch->kc[s]*(batch->end[s]-batch->start[s]);
+    }
+    for (l=0; l<j; l++) {ierr = VecRestoreArrayRead(V[l],(const PetscScalar**)&v[l]);CHKERRQ(ierr);}
+    ierr = VecRestoreArray(Z,&z);CHKERRQ(ierr);
+    ierr = KSP_PCApply(ksp,Z,V[m]);CHKERRQ(ierr);
+    ierr = VecGetArray(ksp->vec_sol,&x);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(V[m],(const PetscScalar**)&z);CHKERRQ(ierr);
+    for (k=0; k<batch->ncycle; k++) {
+      s = batch->cycle[k];
+      if (batch->reason[s] == KSP_DIVERGED_NANORINF) continue;
+      for (i=batch->start[s]; i<batch->end[s]; i++) x[i] += z[i];
+    }
+    ierr = VecRestoreArrayRead(V[m],(const PetscScalar**)&z);CHKERRQ(ierr);
+    ierr = VecRestoreArray(ksp->vec_sol,&x);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*n);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_Batch(KSP ksp)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscInt       s,reason = PETSC_MAX_INT;
+  PetscBool      diagonalscale;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ksp->transpose_solve) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPSolveTranspose() is not supported by KSPBATCH");
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+  ierr = KSPBatchSetUpSystems_Private(ksp);CHKERRQ(ierr);
+  if (batch->method == KSP_BATCH_BCGS) {
+    ierr = KSPSolve_Batch_BCGS(ksp);CHKERRQ(ierr);
+  } else {
+    ierr = KSPSolve_Batch_GMRES(ksp);CHKERRQ(ierr);
+  }
+
+  /* the reason of the batch is the smallest one of its systems, a divergence if any system diverged */
+  for (s=0; s<batch->nsys; s++) {
+    if (!batch->reason[s]) batch->reason[s] = KSP_DIVERGED_ITS;
+    reason = PetscMin(reason,(PetscInt)batch->reason[s]);
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&reason,1,MPIU_INT,MPI_MIN,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  ksp->reason = reason == PETSC_MAX_INT ? KSP_CONVERGED_ATOL : (KSPConvergedReason)reason;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetUp_Batch(KSP ksp)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (batch->method == KSP_BATCH_BCGS) {
+    ierr = KSPSetWorkVecs(ksp,8);CHKERRQ(ierr);
+  } else {
+    ierr = KSPSetWorkVecs(ksp,1);CHKERRQ(ierr);
+    ierr = VecDuplicateVecs(ksp->work[0],batch->restart+1,&batch->V);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,batch->restart+1,batch->V);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_Batch(KSP ksp)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (batch->V) {ierr = VecDestroyVecs(batch->restart+1,&batch->V);CHKERRQ(ierr);}
+  ierr = PetscFree2(batch->start,batch->end);CHKERRQ(ierr);
+  ierr = PetscFree6(batch->active,batch->cycle,batch->reason,batch->its,batch->kc,batch->rnorm);CHKERRQ(ierr);
+  ierr = PetscFree2(batch->ttol,batch->rnorm0);CHKERRQ(ierr);
+  ierr = PetscFree4(batch->rho,batch->rhoold,batch->alpha,batch->omega);CHKERRQ(ierr);
+  ierr = PetscFree4(batch->H,batch->g,batch->cs,batch->sn);CHKERRQ(ierr);
+  batch->nsys = 0;
+  batch->Aid  = 0;
+  batch->Aloc = NULL;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_Batch(KSP ksp)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_Batch(ksp);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&batch->section);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPBatchSetMethod_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPBatchGetMethod_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPBatchSetSection_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPBatchGetConvergedReasons_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_Batch(KSP ksp,PetscViewer viewer)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    if (batch->method == KSP_BATCH_GMRES) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  method: %s, restart %D\n",KSPBatchMethods[batch->method],batch->restart);CHKERRQ(ierr);
+    } else {
+      ierr = PetscViewerASCIIPrintf(viewer,"  method: %s\n",KSPBatchMethods[batch->method]);CHKERRQ(ierr);
+    }
+    if (batch->start) {
+      ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIISynchronizedPrintf(viewer,"  [%d] %D local systems\n",PetscGlobalRank,batch->nsys);CHKERRQ(ierr);
+      ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_Batch(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  KSPBatchMethod method = batch->method;
+  PetscInt       restart = batch->restart;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP batch options");CHKERRQ(ierr);
+  ierr = PetscOptionsEnum("-ksp_batch_method","Krylov method applied to each system","KSPBatchSetMethod",KSPBatchMethods,(PetscEnum)method,(PetscEnum*)&method,NULL);CHKERRQ(ierr);
+  ierr = KSPBatchSetMethod(ksp,method);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_gmres_restart","Number of Krylov search directions of each system","KSPGMRESSetRestart",restart,&restart,NULL);CHKERRQ(ierr);
+  ierr = KSPGMRESSetRestart(ksp,restart);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBatchSetMethod_Batch(KSP ksp,KSPBatchMethod method)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (method == batch->method) PetscFunctionReturn(0);
+  batch->method = method;
+  if (ksp->setupstage) {
+    ksp->setupstage = KSP_SETUP_NEW;
+    ierr = KSPReset_Batch(ksp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBatchGetMethod_Batch(KSP ksp,KSPBatchMethod *method)
+{
+  KSP_Batch *batch = (KSP_Batch*)ksp->data;
+
+  PetscFunctionBegin;
+  *method = batch->method;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGMRESSetRestart_Batch(KSP ksp,PetscInt restart)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (restart < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Restart must be positive, not %D",restart);
+  if (restart == batch->restart) PetscFunctionReturn(0);
+  if (ksp->setupstage) {
+    ksp->setupstage = KSP_SETUP_NEW;
+    ierr = KSPReset_Batch(ksp);CHKERRQ(ierr);
+  }
+  batch->restart = restart;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGMRESGetRestart_Batch(KSP ksp,PetscInt *restart)
+{
+  KSP_Batch *batch = (KSP_Batch*)ksp->data;
+
+  PetscFunctionBegin;
+  *restart = batch->restart;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBatchSetSection_Batch(KSP ksp,PetscSection section)
+{
+  KSP_Batch      *batch = (KSP_Batch*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (section) {ierr = PetscObjectReference((PetscObject)section);CHKERRQ(ierr);}
+  ierr = PetscSectionDestroy(&batch->section);CHKERRQ(ierr);
+  batch->section = section;
+  batch->Aid     = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBatchGetConvergedReasons_Batch(KSP ksp,PetscInt *n,const KSPConvergedReason *reasons[],const PetscInt *its[])
+{
+  KSP_Batch *batch = (KSP_Batch*)ksp->data;
+
+  PetscFunctionBegin;
+  if (n) *n = batch->nsys;
+  if (reasons) *reasons = batch->reason;
+  if (its) *its = batch->its;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPBatchSetMethod - Sets the Krylov method applied to each system of KSPBATCH
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+-  method - KSP_BATCH_BCGS (default) or KSP_BATCH_GMRES
+
+   Options Database Key:
+.  -ksp_batch_method <bcgs,gmres> - the method
+
+   Notes:
+   The restart of KSP_BATCH_GMRES is set with KSPGMRESSetRestart() or -ksp_gmres_restart, it stores one Hessenberg matrix of size
+   (restart+1) x restart per system.
+
+   Level: intermediate
+
+.seealso: KSPBATCH, KSPBatchGetMethod(), KSPBatchMethod, KSPGMRESSetRestart()
+@*/
+PetscErrorCode KSPBatchSetMethod(KSP ksp,KSPBatchMethod method)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,method,2);
+  ierr = PetscTryMethod(ksp,"KSPBatchSetMethod_C",(KSP,KSPBatchMethod),(ksp,method));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPBatchGetMethod - Gets the Krylov method applied to each system of KSPBATCH
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov solver context
+
+   Output Parameter:
+.  method - the method
+
+   Level: intermediate
+
+.seealso: KSPBATCH, KSPBatchSetMethod(), KSPBatchMethod
+@*/
+PetscErrorCode KSPBatchGetMethod(KSP ksp,KSPBatchMethod *method)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidPointer(method,2);
+  ierr = PetscUseMethod(ksp,"KSPBatchGetMethod_C",(KSP,KSPBatchMethod*),(ksp,method));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPBatchSetSection - Describes the independent systems solved by KSPBATCH
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+-  section - each point of the chart is a system, its dof is the size of the system and its offset the first of its rows, numbered
+             from the first local row of the operator, or NULL to use the default systems
+
+   Notes:
+   Each process solves its own systems, which must partition its local rows and not be coupled by the operator.
+
+   Without a section the systems are the blocks given with MatSetVariableBlockSizes(), otherwise for AIJ operators the finest
+   decomposition of the local rows into contiguous uncoupled blocks, and for other operators one system per process.
+
+   Level: intermediate
+
+.seealso: KSPBATCH, KSPBatchGetConvergedReasons(), PetscSectionCreate(), MatSetVariableBlockSizes()
+@*/
+PetscErrorCode KSPBatchSetSection(KSP ksp,PetscSection section)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  if (section) PetscValidHeaderSpecific(section,PETSC_SECTION_CLASSID,2);
+  ierr = PetscTryMethod(ksp,"KSPBatchSetSection_C",(KSP,PetscSection),(ksp,section));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   KSPBatchGetConvergedReasons - Gets the reasons and iteration numbers of the local systems of the last solve of KSPBATCH
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov solver context
+
+   Output Parameters:
++  n - the number of local systems
+.  reasons - the reason each system stopped, in the order of the systems
+-  its - the number of iterations of each system
+
+   Notes:
+   The arrays are owned by the KSP and are valid until the next solve, pass NULL for the outputs that are not needed.
+
+   Level: intermediate
+
+.seealso: KSPBATCH, KSPBatchSetSection(), KSPGetConvergedReason()
+@*/
+PetscErrorCode KSPBatchGetConvergedReasons(KSP ksp,PetscInt *n,const KSPConvergedReason *reasons[],const PetscInt *its[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  ierr = PetscUseMethod(ksp,"KSPBatchGetConvergedReasons_C",(KSP,PetscInt*,const KSPConvergedReason*[],const PetscInt*[]),(ksp,n,reasons,its));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPBATCH - Solves many independent small linear systems, stored as the diagonal blocks of one operator, in lockstep
+
+   Options Database Keys:
++   -ksp_batch_method <bcgs,gmres> - the Krylov method, see KSPBatchSetMethod()
+-   -ksp_gmres_restart <restart> - the restart of the batched GMRES
+
+   Level: intermediate
+
+   Notes:
+   All the systems are advanced together, one iteration applies the preconditioner to the whole vector and the operator to the
+   systems still iterating, while the inner products, the scalars of the method and the convergence test are computed separately
+   for each system, in a single pass over its rows. A system stops as soon as its residual norm satisfies the tolerances of
+   KSPSetTolerances(), relative to its own initial residual, and is no longer touched by the following iterations; the solve stops
+   when all the systems have stopped. There is no object per system and no reduction across processes other than one per
+   iteration for the monitors.
+
+   The systems are described by KSPBatchSetSection() or MatSetVariableBlockSizes(), or found from the nonzero structure of AIJ
+   operators. The preconditioner must not couple the systems either, e.g., PCJACOBI, PCPBJACOBI, PCVPBJACOBI, or PCNONE;
+   PCVPBJACOBI with the variable block sizes of the systems solves them exactly.
+
+   Only right preconditioning and the unpreconditioned norm are supported, KSPSetConvergenceTest() is ignored. KSPGetResidualNorm()
+   and the monitors give the norm of the residual of all the systems, KSPGetIterationNumber() the number of lockstep iterations and
+   KSPGetConvergedReason() the smallest reason of the systems, i.e., a divergence if any system diverged. The reasons of the
+   individual systems are obtained with KSPBatchGetConvergedReasons().
+
+.seealso: KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPBCGS, KSPGMRES, KSPBatchSetSection(),
+          KSPBatchSetMethod(), KSPBatchGetConvergedReasons(), PCVPBJACOBI
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_Batch(KSP ksp)
+{
+  KSP_Batch      *batch;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr           = PetscNewLog(ksp,&batch);CHKERRQ(ierr);
+  batch->method  = KSP_BATCH_BCGS;
+  batch->restart = 30;
+  ksp->data      = (void*)batch;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,3);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_Batch;
+  ksp->ops->solve          = KSPSolve_Batch;
+  ksp->ops->reset          = KSPReset_Batch;
+  ksp->ops->destroy        = KSPDestroy_Batch;
+  ksp->ops->view           = KSPView_Batch;
+  ksp->ops->setfromoptions = KSPSetFromOptions_Batch;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPBatchSetMethod_C",KSPBatchSetMethod_Batch);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPBatchGetMethod_C",KSPBatchGetMethod_Batch);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPBatchSetSection_C",KSPBatchSetSection_Batch);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPBatchGetConvergedReasons_C",KSPBatchGetConvergedReasons_Batch);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_Batch);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPGMRESGetRestart_Batch);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -24,10 +24,11 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 {
   PetscErrorCode ierr;
   PetscInt       i;
-  PetscScalar    rho,rhoold,alpha,beta,omega,omegaold,d1;
+  PetscScalar    rho,rhoold,rhonext = 0.0,alpha,beta,omega,omegaold,d1;
   Vec            X,B,V,P,R,RP,T,S;
   PetscReal      dp    = 0.0,d2;
   KSP_BCGS       *bcgs = (KSP_BCGS*)ksp->data;
+  PetscBool      havenext = PETSC_FALSE,skip;
 
   PetscFunctionBegin;
   X  = ksp->vec_sol;
@@ -69,6 +70,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     }
     PetscFunctionReturn(0);
   }
+  ierr = KSPCheckNormSchedule_Private(ksp,0,dp);CHKERRQ(ierr);
 
   /* Make the initial Rp == R */
   ierr = VecCopy(R,RP);CHKERRQ(ierr);
@@ -81,7 +83,10 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 
   i=0;
   do {
-    ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);       /*   rho <- (r,rp)      */
+    if (havenext) rho = rhonext;                  /*   computed with the residual norm of the previous iteration */
+    else {
+      ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);     /*   rho <- (r,rp)      */
+    }
     beta = (rho/rhoold) * (alpha/omegaold);
     ierr = VecAXPBYPCZ(P,1.0,-omegaold*beta,beta,R,V);CHKERRQ(ierr);  /* p <- r - omega * beta* v + beta * p */
     ierr = KSP_PCApplyBAorAB(ksp,P,V,T);CHKERRQ(ierr);  /*   v <- K p           */
@@ -119,8 +124,20 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     omega = d1 / d2;                               /*   w <- (t's) / (t't) */
     ierr  = VecAXPBYPCZ(X,alpha,omega,1.0,P,S);CHKERRQ(ierr); /* x <- alpha * p + omega * s + x */
     ierr  = VecWAXPY(R,-omega,T,S);CHKERRQ(ierr);     /*   r <- s - w t       */
-    if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+    havenext = PETSC_FALSE;
+    skip     = KSPCheckNormSkip_Private(ksp,i+1);
+    if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2 && !skip) {
+      if (ksp->batchreductions || ksp->chknormevery > 1 || ksp->chknormpredict) {
+        /* compute the next rho together with the residual norm, see KSPSetBatchReductions() and KSPSetCheckNormEvery() */
+        ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);
+        ierr = VecDotBegin(R,RP,&rhonext);CHKERRQ(ierr);
+        ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R));CHKERRQ(ierr);
+        ierr = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);
+        ierr = VecDotEnd(R,RP,&rhonext);CHKERRQ(ierr);
+        havenext = PETSC_TRUE;
+      } else {
+        ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+      }
       KSPCheckNorm(ksp,dp);
     }
 
@@ -129,12 +146,15 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 
     ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
     ksp->its++;
-    ksp->rnorm = dp;
+    if (!skip) ksp->rnorm = dp;
     ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
-    ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
-    ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
-    ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
-    if (ksp->reason) break;
+    if (!skip) {
+      ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+      if (ksp->chknorm < i+2) {ierr = KSPCheckNormSchedule_Private(ksp,i+1,dp);CHKERRQ(ierr);}
+    }
     if (rho == 0.0) {
       ksp->reason = KSP_DIVERGED_BREAKDOWN;
       break;
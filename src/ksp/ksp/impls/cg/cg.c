@@ -81,6 +81,28 @@ static PetscErrorCode KSPSetUp_CG(KSP ksp)
      A macro used in the following KSPSolve_CG and KSPSolve_CG_SingleReduction routines
 */
 #define VecXDot(x,y,a) (((cg->type) == (KSP_CG_HERMITIAN)) ? VecDot(x,y,a) : VecTDot(x,y,a))
+#define VecXDotBegin(x,y,a) (((cg->type) == (KSP_CG_HERMITIAN)) ? VecDotBegin(x,y,a) : VecTDotBegin(x,y,a))
+#define VecXDotEnd(x,y,a) (((cg->type) == (KSP_CG_HERMITIAN)) ? VecDotEnd(x,y,a) : VecTDotEnd(x,y,a))
+
+/*
+     KSPCGNormDot_Batched - Applies the preconditioner and computes the residual norm (preconditioned or
+     unpreconditioned) together with beta = z'*r in a single reduction, see KSPSetBatchReductions()
+*/
+static PetscErrorCode KSPCGNormDot_Batched(KSP ksp,Vec R,Vec Z,PetscReal *dp,PetscScalar *beta)
+{
+  KSP_CG         *cg = (KSP_CG*)ksp->data;
+  Vec            N   = (ksp->normtype == KSP_NORM_PRECONDITIONED) ? Z : R;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                   /*    z <- Br                           */
+  ierr = VecNormBegin(N,NORM_2,dp);CHKERRQ(ierr);               /*    dp <- z'*z or dp <- r'*r          */
+  ierr = VecXDotBegin(Z,R,beta);CHKERRQ(ierr);                  /*    beta <- z'*r                      */
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R));CHKERRQ(ierr);
+  ierr = VecNormEnd(N,NORM_2,dp);CHKERRQ(ierr);
+  ierr = VecXDotEnd(Z,R,beta);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 /*
      KSPSolve_CG - This routine actually applies the conjugate gradient method
@@ -101,7 +123,7 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   Vec            X,B,Z,R,P,W;
   KSP_CG         *cg;
   Mat            Amat,Pmat;
-  PetscBool      diagonalscale;
+  PetscBool      diagonalscale,batched,skip,nonorm;
 
   PetscFunctionBegin;
   ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
@@ -128,7 +150,12 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     ierr = VecCopy(B,R);CHKERRQ(ierr);                         /*    r <- b (x is 0)                   */
   }
 
-  switch (ksp->normtype) {
+  batched = (PetscBool)(ksp->batchreductions && (ksp->normtype == KSP_NORM_PRECONDITIONED || ksp->normtype == KSP_NORM_UNPRECONDITIONED));
+  if (batched) {
+    ierr = KSPCGNormDot_Batched(ksp,R,Z,&dp,&beta);CHKERRQ(ierr);
+    KSPCheckNorm(ksp,dp);
+    KSPCheckDot(ksp,beta);
+  } else switch (ksp->normtype) {
     case KSP_NORM_PRECONDITIONED:
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*    z <- Br                           */
       ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*    dp <- z'*z = e'*A'*B'*B*A*e       */
@@ -155,11 +182,12 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
 
   ierr = (*ksp->converged)(ksp,0,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);     /* test for convergence */
   if (ksp->reason) PetscFunctionReturn(0);
+  ierr = KSPCheckNormSchedule_Private(ksp,0,dp);CHKERRQ(ierr);
 
-  if (ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) {
+  if (!batched && ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) {
     ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                /*     z <- Br                           */
   }
-  if (ksp->normtype != KSP_NORM_NATURAL) {
+  if (!batched && ksp->normtype != KSP_NORM_NATURAL) {
     ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                  /*     beta <- z'*r                      */
     KSPCheckDot(ksp,beta);
   }
@@ -206,11 +234,19 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     if (eigs) d[i] = PetscSqrtReal(PetscAbsScalar(b))*e[i] + 1.0/a;
     ierr = VecAXPY(X,a,P);CHKERRQ(ierr);                       /*     x <- x + ap                      */
     ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                      /*     r <- r - aw                      */
-    if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i+2) {
+    /* the natural norm is free, the others are skipped between two checks, see KSPSetCheckNormEvery(), and computed with beta */
+    skip    = (PetscBool)(ksp->normtype != KSP_NORM_NATURAL && KSPCheckNormSkip_Private(ksp,i+1));
+    nonorm  = (PetscBool)(skip || ksp->chknorm >= i+2);
+    batched = (PetscBool)((ksp->batchreductions || ksp->chknormevery > 1 || ksp->chknormpredict) && (ksp->normtype == KSP_NORM_PRECONDITIONED || ksp->normtype == KSP_NORM_UNPRECONDITIONED) && !nonorm);
+    if (batched) {
+      ierr = KSPCGNormDot_Batched(ksp,R,Z,&dp,&beta);CHKERRQ(ierr);
+      KSPCheckNorm(ksp,dp);
+      KSPCheckDot(ksp,beta);
+    } else if (ksp->normtype == KSP_NORM_PRECONDITIONED && !nonorm) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
       ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- z'*z                       */
       KSPCheckNorm(ksp,dp);
-    } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
+    } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && !nonorm) {
       ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- r'*r                       */
       KSPCheckNorm(ksp,dp);
     } else if (ksp->normtype == KSP_NORM_NATURAL) {
@@ -218,20 +254,23 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- r'*z                     */
       KSPCheckDot(ksp,beta);
       dp = PetscSqrtReal(PetscAbsScalar(beta));
-    } else {
+    } else if (!skip) {
       dp = 0.0;
     }
-    ksp->rnorm = dp;
-    ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
     if (eigs) cg->ned = ksp->its;
-    ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
-    ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
-    if (ksp->reason) break;
+    if (!skip) {
+      ksp->rnorm = dp;
+      ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+      if (!nonorm) {ierr = KSPCheckNormSchedule_Private(ksp,i+1,dp);CHKERRQ(ierr);}
+    }
 
-    if ((ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) || (ksp->chknorm >= i+2)) {
+    if (!batched && ((ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) || nonorm)) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
     }
-    if ((ksp->normtype != KSP_NORM_NATURAL) || (ksp->chknorm >= i+2)) {
+    if (!batched && ((ksp->normtype != KSP_NORM_NATURAL) || nonorm)) {
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- z'*r                     */
       KSPCheckDot(ksp,beta);
     }
@@ -561,6 +600,10 @@ PETSC_INTERN PetscErrorCode KSPBuildResidual_CG(KSP ksp,Vec t,Vec v,Vec *V)
    For complex numbers there are two different CG methods, one for Hermitian symmetric matrices and one for non-Hermitian symmetric matrices. Use
    KSPCGSetType() to indicate which type you are using.
 
+   KSPMatSolve() uses a block CG that shares the matrix-matrix products, preconditioner applications and reductions of all the right-hand sides.
+   The search directions are A-orthonormalized at each iteration, numerically dependent ones are dropped, and columns that have converged
+   (relative to their own initial residual) are removed from the block. Complex symmetric (non Hermitian) systems are solved column by column.
+
    Developer Notes:
     KSPSolve_CG() should actually query the matrix to determine if it is Hermitian symmetric or not and NOT require the user to
    indicate it to the KSP object.
@@ -568,11 +611,12 @@ PETSC_INTERN PetscErrorCode KSPBuildResidual_CG(KSP ksp,Vec t,Vec v,Vec *V)
    References:
 +   1. - Magnus R. Hestenes and Eduard Stiefel, Methods of Conjugate Gradients for Solving Linear Systems,
    Journal of Research of the National Bureau of Standards Vol. 49, No. 6, December 1952 Research Paper 2379
--   2. - Josef Malek and Zdenek Strakos, Preconditioning and the Conjugate Gradient Method in the Context of Solving PDEs,
+.   2. - Josef Malek and Zdenek Strakos, Preconditioning and the Conjugate Gradient Method in the Context of Solving PDEs,
     SIAM, 2014.
+-   3. - Hao Ji and Yaohang Li, A breakdown-free block conjugate gradient method, BIT Numerical Mathematics, 2017.
 
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP,
-           KSPCGSetType(), KSPCGUseSingleReduction(), KSPPIPECG, KSPGROPPCG
+           KSPCGSetType(), KSPCGUseSingleReduction(), KSPPIPECG, KSPGROPPCG, KSPMatSolve()
 
 M*/
 PETSC_EXTERN PetscErrorCode KSPCreate_CG(KSP ksp)
@@ -600,6 +644,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_CG(KSP ksp)
   */
   ksp->ops->setup          = KSPSetUp_CG;
   ksp->ops->solve          = KSPSolve_CG;
+  ksp->ops->matsolve       = KSPMatSolve_CG;
   ksp->ops->destroy        = KSPDestroy_CG;
   ksp->ops->view           = KSPView_CG;
   ksp->ops->setfromoptions = KSPSetFromOptions_CG;
@@ -0,0 +1,205 @@
+/*
+    Block conjugate gradient method used by KSPMatSolve() with KSPCG
+*/
+#include <../src/ksp/ksp/impls/cg/cgimpl.h>       /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+/* local parts of the squared norms of the columns of R (and Z) used by the convergence test */
+static PetscErrorCode KSPMatSolveNormsLocal_CG(KSP ksp,Mat R,Mat Z,PetscScalar *d)
+{
+  const PetscScalar *r,*z;
+  PetscInt          i,j,m,k,ldr,ldz;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(R,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(R,NULL,&k);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(R,&ldr);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(Z,&ldz);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(R,&r);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(Z,&z);CHKERRQ(ierr);
+  for (j=0; j<k; j++) {
+    const PetscScalar *u = ksp->normtype == KSP_NORM_PRECONDITIONED ? z+j*ldz : r+j*ldr;
+    const PetscScalar *v = ksp->normtype == KSP_NORM_UNPRECONDITIONED ? r+j*ldr : z+j*ldz;
+
+    d[j] = 0.0;
+    for (i=0; i<m; i++) d[j] += PetscConj(u[i])*v[i];
+  }
+  ierr = MatDenseRestoreArrayRead(Z,&z);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(R,&r);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*m*k);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* copies the first k columns of Z to P, P (and the product AP) are recreated when the number of columns changes */
+static PetscErrorCode KSPMatSolveSetDirections_CG(Mat Z,PetscInt k,Mat *P,Mat *AP)
+{
+  Mat            Zk;
+  PetscInt       m,M,p = -1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (*P) {ierr = MatGetSize(*P,NULL,&p);CHKERRQ(ierr);}
+  if (p != k) {
+    ierr = MatDestroy(P);CHKERRQ(ierr);
+    ierr = MatDestroy(AP);CHKERRQ(ierr);
+    ierr = MatGetLocalSize(Z,&m,NULL);CHKERRQ(ierr);
+    ierr = MatGetSize(Z,&M,NULL);CHKERRQ(ierr);
+    ierr = MatCreateDense(PetscObjectComm((PetscObject)Z),m,PETSC_DECIDE,M,k,NULL,P);CHKERRQ(ierr);
+  }
+  ierr = MatDenseGetSubMatrix(Z,0,k,&Zk);CHKERRQ(ierr);
+  ierr = MatCopy(Zk,*P,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatDenseRestoreSubMatrix(Z,&Zk);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Block conjugate gradient with A-orthonormalized search directions, in the spirit of the breakdown-free block CG of Ji and Li
+
+   With R the residuals of the k active columns and Z = M R, each iteration performs
+
+      Q = A P, [P^H Q, P^H R]          one MatMatMult() and one reduction
+      P^H Q = (T T^H)^{-1}             rank revealing, the numerically dependent directions are dropped
+      X += P T T^H P^H R, R -= Q T T^H P^H R
+      Z = M R, [Q^H Z, norms of R]     one PCMatApply() and one reduction
+      P = Z - P T T^H Q^H Z
+
+   Columns are deflated, i.e., removed from the active block, as soon as they have converged.
+*/
+PetscErrorCode KSPMatSolve_CG(KSP ksp,Mat B,Mat X)
+{
+  KSP_CG         *cg = (KSP_CG*)ksp->data;
+  Mat            A,Xa,R,Z,P = NULL,AP = NULL,AX,Rk,Zk,Xk,M[2],Y[2];
+  Vec            cb,cx;
+  PetscScalar    *work,*T,*TL,*L,one = 1.0,zero = 0.0;
+  PetscReal      *rnorm,*rnorm0;
+  PetscBool      *conv;
+  PetscInt       m,N,NN,k,p,pn,i,j,l,*idx;
+  PetscBLASInt   bk,bp,bpn;
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+  if (cg->type != KSP_CG_HERMITIAN && PetscDefined(USE_COMPLEX)) {
+    ierr = PetscInfo(ksp,"Block CG is only implemented for Hermitian matrices, solving column by column\n");CHKERRQ(ierr);
+    for (j=0; j<N; j++) {
+      ierr = MatDenseGetColumnVecRead(B,j,&cb);CHKERRQ(ierr);
+      ierr = MatDenseGetColumnVecWrite(X,j,&cx);CHKERRQ(ierr);
+      ierr = KSPSolve(ksp,cb,cx);CHKERRQ(ierr);
+      ierr = MatDenseRestoreColumnVecWrite(X,j,&cx);CHKERRQ(ierr);
+      ierr = MatDenseRestoreColumnVecRead(B,j,&cb);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
+  ierr = KSPGetOperators(ksp,&A,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)B,&comm);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,&NN,NULL);CHKERRQ(ierr);
+  ierr = MatCreateDense(comm,m,PETSC_DECIDE,NN,N,NULL,&Xa);CHKERRQ(ierr);
+  ierr = MatCreateDense(comm,m,PETSC_DECIDE,NN,N,NULL,&R);CHKERRQ(ierr);
+  ierr = MatCreateDense(comm,m,PETSC_DECIDE,NN,N,NULL,&Z);CHKERRQ(ierr);
+  ierr = PetscMalloc4(2*N*N+N,&work,N*N,&T,N*N,&TL,N*N,&L);CHKERRQ(ierr);
+  ierr = PetscMalloc4(N,&rnorm,N,&rnorm0,N,&conv,N,&idx);CHKERRQ(ierr);
+  for (j=0; j<N; j++) idx[j] = j;
+  k = N;
+
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its    = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  if (ksp->guess_zero) {
+    ierr = MatZeroEntries(Xa);CHKERRQ(ierr);
+    ierr = MatCopy(B,R,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  } else {
+    ierr = MatCopy(X,Xa,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatMatMult(A,X,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&AX);CHKERRQ(ierr);
+    ierr = MatCopy(B,R,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatAXPY(R,-1.0,AX,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatDestroy(&AX);CHKERRQ(ierr);
+  }
+  ierr = PCMatApply(ksp->pc,R,Z);CHKERRQ(ierr);
+  ierr = KSPMatSolveNormsLocal_CG(ksp,R,Z,work);CHKERRQ(ierr);
+  ierr = KSPBlockInnerProducts_Private(ksp,0,NULL,NULL,k,work);CHKERRQ(ierr);
+  for (j=0; j<k; j++) rnorm0[j] = rnorm[j] = PetscSqrtReal(PetscAbsScalar(work[j]));
+  ierr = KSPBlockConverged_Private(ksp,k,rnorm,rnorm0,conv);CHKERRQ(ierr);
+  if (!ksp->reason) {
+    M[0] = R; M[1] = Z;
+    ierr = KSPBlockDeflate_Private(&k,conv,idx,rnorm0,Xa,X,2,M);CHKERRQ(ierr);
+    ierr = KSPMatSolveSetDirections_CG(Z,k,&P,&AP);CHKERRQ(ierr);
+  }
+
+  while (!ksp->reason) {
+    ierr = MatGetSize(P,NULL,&p);CHKERRQ(ierr);
+    ierr = MatMatMult(A,P,AP ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,PETSC_DEFAULT,&AP);CHKERRQ(ierr);
+    ierr = MatDenseGetSubMatrix(R,0,k,&Rk);CHKERRQ(ierr);
+    M[0] = P; M[1] = P;
+    Y[0] = AP; Y[1] = Rk;
+    ierr = KSPBlockInnerProducts_Private(ksp,2,M,Y,0,work);CHKERRQ(ierr);
+    ierr = KSPBlockOrthonormalize_Private(p,work,NULL,PETSC_SMALL,&pn,T,NULL,0);CHKERRQ(ierr);
+    if (!pn) {
+      ierr = MatDenseRestoreSubMatrix(R,&Rk);CHKERRQ(ierr);
+      ierr = PetscInfo1(ksp,"Breakdown of the block of search directions at iteration %D\n",ksp->its);CHKERRQ(ierr);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+    if (pn < p) {ierr = PetscInfo3(ksp,"Dropping %D of the %D search directions at iteration %D\n",p-pn,p,ksp->its);CHKERRQ(ierr);}
+    /* TL = T T^H P^H R, the step X += P TL, R -= A P TL */
+    ierr = PetscBLASIntCast(k,&bk);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(p,&bp);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(pn,&bpn);CHKERRQ(ierr);
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bpn,&bk,&bp,&one,T,&bp,work+p*p,&bp,&zero,L,&bpn));
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bp,&bk,&bpn,&one,T,&bp,L,&bpn,&zero,TL,&bp));
+    ierr = KSPBlockGemm_Private(-1.0,AP,TL,p,1.0,Rk);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(R,&Rk);CHKERRQ(ierr);
+    ierr = MatDenseGetSubMatrix(Xa,0,k,&Xk);CHKERRQ(ierr);
+    ierr = KSPBlockGemm_Private(1.0,P,TL,p,1.0,Xk);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(Xa,&Xk);CHKERRQ(ierr);
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->its++;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+    /* Z = M R, the norms of the residuals and the A-orthogonalization coefficients of the next directions */
+    ierr = MatDenseGetSubMatrix(R,0,k,&Rk);CHKERRQ(ierr);
+    ierr = MatDenseGetSubMatrix(Z,0,k,&Zk);CHKERRQ(ierr);
+    ierr = PCMatApply(ksp->pc,Rk,Zk);CHKERRQ(ierr);
+    ierr = KSPMatSolveNormsLocal_CG(ksp,Rk,Zk,work+p*k);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(R,&Rk);CHKERRQ(ierr);
+    M[0] = AP;
+    Y[0] = Zk;
+    ierr = KSPBlockInnerProducts_Private(ksp,1,M,Y,k,work);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(Z,&Zk);CHKERRQ(ierr);
+    for (j=0; j<k; j++) rnorm[j] = PetscSqrtReal(PetscAbsScalar(work[p*k+j]));
+    ierr = KSPBlockConverged_Private(ksp,k,rnorm,rnorm0,conv);CHKERRQ(ierr);
+    if (ksp->reason) break;
+
+    /* TL = T T^H Q^H Z, restricted to the columns that have not converged */
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bpn,&bk,&bp,&one,T,&bp,work,&bp,&zero,L,&bpn));
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bp,&bk,&bpn,&one,T,&bp,L,&bpn,&zero,TL,&bp));
+    for (j=0,l=0; j<k; j++) {
+      if (conv[j]) continue;
+      if (l != j) for (i=0; i<p; i++) TL[i+l*p] = TL[i+j*p];
+      l++;
+    }
+    M[0] = R; M[1] = Z;
+    ierr = KSPBlockDeflate_Private(&k,conv,idx,rnorm0,Xa,X,2,M);CHKERRQ(ierr);
+
+    /* P = Z - P TL */
+    ierr = MatDenseGetSubMatrix(Z,0,k,&Zk);CHKERRQ(ierr);
+    ierr = KSPBlockGemm_Private(-1.0,P,TL,p,1.0,Zk);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(Z,&Zk);CHKERRQ(ierr);
+    ierr = KSPMatSolveSetDirections_CG(Z,k,&P,&AP);CHKERRQ(ierr);
+  }
+
+  /* copy the remaining active columns to the solution */
+  for (j=0; j<k; j++) conv[j] = PETSC_TRUE;
+  ierr = KSPBlockDeflate_Private(&k,conv,idx,NULL,Xa,X,0,NULL);CHKERRQ(ierr);
+  ierr = PetscFree4(work,T,TL,L);CHKERRQ(ierr);
+  ierr = PetscFree4(rnorm,rnorm0,conv,idx);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+  ierr = MatDestroy(&AP);CHKERRQ(ierr);
+  ierr = MatDestroy(&Z);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = MatDestroy(&Xa);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
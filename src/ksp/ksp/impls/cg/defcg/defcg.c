@@ -0,0 +1,517 @@
+
+/*
+    Deflated preconditioned conjugate gradient that harvests approximate eigenvectors for the next solves
+*/
+#include <petsc/private/kspimpl.h>              /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+typedef struct {
+  PetscInt         k;               /* maximum number of deflation vectors */
+  PetscInt         l;               /* number of search directions stored during a solve for the harvest */
+  PetscInt         nk;              /* number of deflation vectors currently in W */
+  Vec              *W,*AW,*BAW;     /* deflation space, its image by A and by B A, with B the preconditioner */
+  Vec              *Wn,*AWn,*BAWn;  /* space for the next deflation vectors */
+  Vec              *P,*AP,*BAP;     /* first search directions of the solve, with their images */
+  Vec              *Z,*AZ,*BAZ;     /* arrays of pointers [W P], no vectors are allocated */
+  PetscScalar      *WtAW;           /* Cholesky factor of W^T A W */
+  PetscScalar      *F,*H,*mu,*work;
+  PetscReal        *theta,*rwork;
+  PetscBLASInt     lwork;
+  PetscBool        valid;           /* AW and BAW are the images of W by the operators below */
+  PetscObjectId    Aid,Pid;
+  PetscObjectState Astate,Pstate;
+} KSP_DEFCG;
+
+static PetscErrorCode KSPSetUp_DEFCG(KSP ksp)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  PetscInt       k = defcg->k,l = defcg->l,s = defcg->k+defcg->l;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (l < k) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"The number of harvested directions %D must be at least the number of deflation vectors %D",l,k);
+  ierr = KSPSetWorkVecs(ksp,4);CHKERRQ(ierr);
+  if (k) {
+    ierr = KSPCreateVecs(ksp,k,&defcg->W,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&defcg->AW,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&defcg->BAW,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&defcg->Wn,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&defcg->AWn,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&defcg->BAWn,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,l,&defcg->P,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,l,&defcg->AP,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,l,&defcg->BAP,0,NULL);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,defcg->W);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,defcg->AW);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,defcg->BAW);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,defcg->Wn);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,defcg->AWn);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,defcg->BAWn);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,l,defcg->P);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,l,defcg->AP);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,l,defcg->BAP);CHKERRQ(ierr);
+  }
+  defcg->lwork = (PetscBLASInt)(64*(s+1));
+  ierr = PetscMalloc6(k*k,&defcg->WtAW,s*s,&defcg->F,s*s,&defcg->H,k+1,&defcg->mu,defcg->lwork,&defcg->work,s,&defcg->theta);CHKERRQ(ierr);
+  ierr = PetscMalloc4(3*s,&defcg->rwork,s,&defcg->Z,s,&defcg->AZ,s+1,&defcg->BAZ);CHKERRQ(ierr);
+  defcg->nk    = 0;
+  defcg->valid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Makes AW and BAW the images of W by the current operators, then factors W^T A W; the images are only recomputed when the
+   operators have changed since the last solve, which costs nk products with A and nk applications of the preconditioner
+*/
+static PetscErrorCode KSPDEFCGRefresh_Private(KSP ksp)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  PetscInt       i,j,nk = defcg->nk;
+  PetscBLASInt   bnk,info;
+  Mat            A,P;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&A,&P);CHKERRQ(ierr);
+  if (!defcg->valid || defcg->Aid != ((PetscObject)A)->id || defcg->Astate != ((PetscObject)A)->state || defcg->Pid != ((PetscObject)P)->id || defcg->Pstate != ((PetscObject)P)->state) {
+    for (i=0; i<nk; i++) {
+      ierr = KSP_MatMult(ksp,A,defcg->W[i],defcg->AW[i]);CHKERRQ(ierr);
+      ierr = KSP_PCApply(ksp,defcg->AW[i],defcg->BAW[i]);CHKERRQ(ierr);
+    }
+    defcg->Aid    = ((PetscObject)A)->id;
+    defcg->Astate = ((PetscObject)A)->state;
+    defcg->Pid    = ((PetscObject)P)->id;
+    defcg->Pstate = ((PetscObject)P)->state;
+    defcg->valid  = PETSC_TRUE;
+  }
+  if (!nk) PetscFunctionReturn(0);
+  ierr = PetscArrayzero(defcg->WtAW,nk*nk);CHKERRQ(ierr);
+  for (j=0; j<nk; j++) {ierr = VecMDot(defcg->AW[j],j+1,defcg->W,defcg->WtAW+j*nk);CHKERRQ(ierr);}
+  ierr = PetscBLASIntCast(nk,&bnk);CHKERRQ(ierr);
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bnk,defcg->WtAW,&bnk,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) {
+    ierr = PetscInfo1(ksp,"W^T A W is not positive definite (potrf info %d), the deflation space is discarded\n",(int)info);CHKERRQ(ierr);
+    defcg->nk = 0;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* mu <- (W^T A W)^{-1} mu */
+static PetscErrorCode KSPDEFCGSolveCoarse_Private(KSP ksp,PetscScalar *mu)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  PetscBLASInt   bnk,one = 1,info;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(defcg->nk,&bnk);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKpotrs",LAPACKpotrs_("U",&bnk,&one,defcg->WtAW,&bnk,mu,&bnk,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine xPOTRS %d",(int)info);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Replaces W with the approximate eigenvectors of B A associated with its smallest eigenvalues in the space [W P], obtained from
+   the symmetric pencil (A Z)^T B (A Z) y = lambda Z^T A Z y with Z = [W P]; all the images are combinations of stored vectors since
+   B A p_j = (z_j - z_{j+1})/alpha_j
+*/
+static PetscErrorCode KSPDEFCGHarvest_Private(KSP ksp,PetscInt np)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  PetscInt       i,j,nk = defcg->nk,s = nk+np,kk = PetscMin(defcg->k,s);
+  PetscScalar    *F = defcg->F,*H = defcg->H;
+  PetscBLASInt   bs,itype = 1,info;
+  Vec            *swap;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<nk; i++) {
+    defcg->Z[i]   = defcg->W[i];
+    defcg->AZ[i]  = defcg->AW[i];
+    defcg->BAZ[i] = defcg->BAW[i];
+  }
+  for (i=0; i<np; i++) {
+    defcg->Z[nk+i]   = defcg->P[i];
+    defcg->AZ[nk+i]  = defcg->AP[i];
+    defcg->BAZ[nk+i] = defcg->BAP[i];
+  }
+  ierr = PetscArrayzero(F,s*s);CHKERRQ(ierr);
+  ierr = PetscArrayzero(H,s*s);CHKERRQ(ierr);
+  for (j=0; j<s; j++) {
+    ierr = VecMDot(defcg->AZ[j],j+1,defcg->Z,F+j*s);CHKERRQ(ierr);
+    ierr = VecMDot(defcg->BAZ[j],j+1,defcg->AZ,H+j*s);CHKERRQ(ierr);
+  }
+  ierr = PetscBLASIntCast(s,&bs);CHKERRQ(ierr);
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if !defined(PETSC_USE_COMPLEX)
+  PetscStackCallBLAS("LAPACKsygv",LAPACKsygv_(&itype,"V","U",&bs,H,&bs,F,&bs,defcg->theta,defcg->work,&defcg->lwork,&info));
+#else
+  PetscStackCallBLAS("LAPACKsygv",LAPACKsygv_(&itype,"V","U",&bs,H,&bs,F,&bs,defcg->theta,defcg->work,&defcg->lwork,defcg->rwork,&info));
+#endif
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) {
+    ierr = PetscInfo1(ksp,"Harvest of the search directions failed (sygv info %d), the deflation space is kept\n",(int)info);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  /* the eigenvalues are in ascending order, H holds the eigenvectors */
+  for (j=0; j<kk; j++) {
+    ierr = VecSet(defcg->Wn[j],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(defcg->Wn[j],s,H+j*s,defcg->Z);CHKERRQ(ierr);
+    ierr = VecSet(defcg->AWn[j],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(defcg->AWn[j],s,H+j*s,defcg->AZ);CHKERRQ(ierr);
+    ierr = VecSet(defcg->BAWn[j],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(defcg->BAWn[j],s,H+j*s,defcg->BAZ);CHKERRQ(ierr);
+  }
+  ierr = PetscInfo3(ksp,"Deflation space of %D vectors, smallest and largest approximate eigenvalues %g %g\n",kk,(double)defcg->theta[0],(double)defcg->theta[kk-1]);CHKERRQ(ierr);
+  swap = defcg->W;   defcg->W   = defcg->Wn;   defcg->Wn   = swap;
+  swap = defcg->AW;  defcg->AW  = defcg->AWn;  defcg->AWn  = swap;
+  swap = defcg->BAW; defcg->BAW = defcg->BAWn; defcg->BAWn = swap;
+  defcg->nk = kk;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_DEFCG(KSP ksp)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  Mat            Amat,Pmat;
+  Vec            X,B,R,Z,Pv,Q;
+  PetscInt       i,j,nk,np = 0;
+  PetscScalar    *mu = defcg->mu,alpha,beta,betaold,pq;
+  PetscReal      dp = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ksp->transpose_solve) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPSolveTranspose() is not supported by KSPDEFCG");
+  X    = ksp->vec_sol;
+  B    = ksp->vec_rhs;
+  R    = ksp->work[0];
+  Z    = ksp->work[1];
+  Pv   = ksp->work[2];
+  Q    = ksp->work[3];
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = KSPDEFCGRefresh_Private(ksp);CHKERRQ(ierr);
+  nk   = defcg->nk;
+
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,Amat,X,R);CHKERRQ(ierr);           /*    r <- b - Ax                       */
+    ierr = VecAYPX(R,-1.0,B);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(B,R);CHKERRQ(ierr);                         /*    r <- b (x is 0)                   */
+  }
+  if (nk) {                                                    /*    x <- x + W (W^T A W)^{-1} W^T r   */
+    ierr = VecMDot(R,nk,defcg->W,mu);CHKERRQ(ierr);
+    ierr = KSPDEFCGSolveCoarse_Private(ksp,mu);CHKERRQ(ierr);
+    ierr = VecMAXPY(X,nk,mu,defcg->W);CHKERRQ(ierr);
+    for (i=0; i<nk; i++) mu[i] = -mu[i];
+    ierr = VecMAXPY(R,nk,mu,defcg->AW);CHKERRQ(ierr);         /*    r <- r - A W (W^T A W)^{-1} W^T r */
+  }
+  ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                   /*    z <- Br                           */
+
+  /* W^T A z and r^T z with a single reduction */
+  for (i=0; i<nk; i++) defcg->BAZ[i] = defcg->AW[i];
+  defcg->BAZ[nk] = R;
+  ierr = VecMDot(Z,nk+1,defcg->BAZ,mu);CHKERRQ(ierr);
+  beta = mu[nk];
+  KSPCheckDot(ksp,beta);
+  ierr = VecCopy(Z,Pv);CHKERRQ(ierr);
+  if (nk) {                                                    /*    p <- z - W (W^T A W)^{-1} W^T A z */
+    ierr = KSPDEFCGSolveCoarse_Private(ksp,mu);CHKERRQ(ierr);
+    for (i=0; i<nk; i++) mu[i] = -mu[i];
+    ierr = VecMAXPY(Pv,nk,mu,defcg->W);CHKERRQ(ierr);
+  }
+  switch (ksp->normtype) {
+  case KSP_NORM_PRECONDITIONED:
+    ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);
+    break;
+  case KSP_NORM_UNPRECONDITIONED:
+    ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+    break;
+  case KSP_NORM_NATURAL:
+    dp = PetscSqrtReal(PetscAbsScalar(beta));
+    break;
+  case KSP_NORM_NONE:
+    dp = 0.0;
+    break;
+  default: SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"%s",KSPNormTypes[ksp->normtype]);
+  }
+  KSPCheckNorm(ksp,dp);
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its   = 0;
+  ksp->rnorm = dp;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,0,dp);CHKERRQ(ierr);
+  ierr = (*ksp->converged)(ksp,0,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+
+  for (i=0; !ksp->reason && i<ksp->max_it; i++) {
+    ierr = KSP_MatMult(ksp,Amat,Pv,Q);CHKERRQ(ierr);          /*    q <- Ap                           */
+    ierr = VecDot(Q,Pv,&pq);CHKERRQ(ierr);
+    KSPCheckDot(ksp,pq);
+    if (PetscRealPart(pq) <= 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite matrix, p'Ap %g",(double)PetscRealPart(pq));
+      ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      ierr        = PetscInfo(ksp,"diverging due to indefinite or negative definite matrix\n");CHKERRQ(ierr);
+      break;
+    }
+    alpha = beta/pq;                                           /*    alpha <- r'z/p'Ap                 */
+    if (np < defcg->l && defcg->k) {                           /*    keep p, Ap and, below, BAp        */
+      ierr = VecCopy(Pv,defcg->P[np]);CHKERRQ(ierr);
+      ierr = VecCopy(Q,defcg->AP[np]);CHKERRQ(ierr);
+      ierr = VecCopy(Z,defcg->BAP[np]);CHKERRQ(ierr);
+    }
+    ierr = VecAXPY(X,alpha,Pv);CHKERRQ(ierr);                  /*    x <- x + alpha p                  */
+    ierr = VecAXPY(R,-alpha,Q);CHKERRQ(ierr);                  /*    r <- r - alpha Ap                 */
+    ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                 /*    z <- Br                           */
+    if (np < defcg->l && defcg->k) {                           /*    BAp = (z_old - z)/alpha           */
+      ierr = VecAXPBY(defcg->BAP[np],-1.0/alpha,1.0/alpha,Z);CHKERRQ(ierr);
+      np++;
+    }
+    betaold = beta;
+    defcg->BAZ[nk] = R;
+    ierr = VecMDot(Z,nk+1,defcg->BAZ,mu);CHKERRQ(ierr);
+    beta = mu[nk];
+    KSPCheckDot(ksp,beta);
+    switch (ksp->normtype) {
+    case KSP_NORM_PRECONDITIONED:
+      ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);
+      break;
+    case KSP_NORM_UNPRECONDITIONED:
+      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+      break;
+    case KSP_NORM_NATURAL:
+      dp = PetscSqrtReal(PetscAbsScalar(beta));
+      break;
+    default:
+      dp = 0.0;
+      break;
+    }
+    KSPCheckNorm(ksp,dp);
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->its   = i+1;
+    ksp->rnorm = dp;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
+    ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+    if (ksp->reason) break;
+    ierr = VecAYPX(Pv,beta/betaold,Z);CHKERRQ(ierr);          /*    p <- z + beta p - W mu            */
+    if (nk) {
+      ierr = KSPDEFCGSolveCoarse_Private(ksp,mu);CHKERRQ(ierr);
+      for (j=0; j<nk; j++) mu[j] = -mu[j];
+      ierr = VecMAXPY(Pv,nk,mu,defcg->W);CHKERRQ(ierr);
+    }
+  }
+  if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+  if (defcg->k && np) {ierr = KSPDEFCGHarvest_Private(ksp,np);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_DEFCG(KSP ksp)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDestroyVecs(defcg->k,&defcg->W);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(defcg->k,&defcg->AW);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(defcg->k,&defcg->BAW);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(defcg->k,&defcg->Wn);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(defcg->k,&defcg->AWn);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(defcg->k,&defcg->BAWn);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(defcg->l,&defcg->P);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(defcg->l,&defcg->AP);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(defcg->l,&defcg->BAP);CHKERRQ(ierr);
+  ierr = PetscFree6(defcg->WtAW,defcg->F,defcg->H,defcg->mu,defcg->work,defcg->theta);CHKERRQ(ierr);
+  ierr = PetscFree4(defcg->rwork,defcg->Z,defcg->AZ,defcg->BAZ);CHKERRQ(ierr);
+  defcg->nk    = 0;
+  defcg->valid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_DEFCG(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_DEFCG(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDEFCGSetRecycleSize_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDEFCGGetRecycleSize_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_DEFCG(KSP ksp,PetscViewer viewer)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  deflation vectors=%D (currently %D), harvested directions=%D\n",defcg->k,defcg->nk,defcg->l);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_DEFCG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  PetscInt       k = defcg->k,l = defcg->l;
+  PetscBool      flg1,flg2;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP DEFCG options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_defcg_recycle","Number of deflation vectors kept across solves","KSPDEFCGSetRecycleSize",k,&k,&flg1);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_defcg_harvest","Number of search directions of a solve used to update the deflation vectors","KSPDEFCGSetRecycleSize",l,&l,&flg2);CHKERRQ(ierr);
+  if (flg1 || flg2) {ierr = KSPDEFCGSetRecycleSize(ksp,k,flg2 ? l : PETSC_DEFAULT);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDEFCGSetRecycleSize_DEFCG(KSP ksp,PetscInt k,PetscInt l)
+{
+  KSP_DEFCG      *defcg = (KSP_DEFCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (k < 0) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"The number of deflation vectors cannot be negative");
+  if (l == PETSC_DEFAULT || l == PETSC_DECIDE) l = 2*k;
+  if ((k != defcg->k || l != defcg->l) && ksp->setupstage) {ierr = KSPReset(ksp);CHKERRQ(ierr);}
+  defcg->k = k;
+  defcg->l = l;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDEFCGGetRecycleSize_DEFCG(KSP ksp,PetscInt *k,PetscInt *l,PetscInt *nk)
+{
+  KSP_DEFCG *defcg = (KSP_DEFCG*)ksp->data;
+
+  PetscFunctionBegin;
+  if (k)  *k  = defcg->k;
+  if (l)  *l  = defcg->l;
+  if (nk) *nk = defcg->nk;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPDEFCGSetRecycleSize - Sets the number of approximate eigenvectors that KSPDEFCG keeps across solves, and the number of search
+   directions of each solve from which they are updated
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+.  k - the number of deflation vectors, default 8; 0 gives CG
+-  l - the number of harvested search directions, at least k, or PETSC_DEFAULT for 2 k
+
+   Options Database Keys:
++  -ksp_defcg_recycle <k> - the number of deflation vectors
+-  -ksp_defcg_harvest <l> - the number of harvested search directions
+
+   Notes:
+   Changing the sizes after the solver has been set up discards the deflation space.
+
+   Level: intermediate
+
+.seealso: KSPDEFCG, KSPDEFCGGetRecycleSize()
+@*/
+PetscErrorCode KSPDEFCGSetRecycleSize(KSP ksp,PetscInt k,PetscInt l)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,k,2);
+  PetscValidLogicalCollectiveInt(ksp,l,3);
+  ierr = PetscTryMethod(ksp,"KSPDEFCGSetRecycleSize_C",(KSP,PetscInt,PetscInt),(ksp,k,l));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPDEFCGGetRecycleSize - Gets the sizes of the deflation space of KSPDEFCG
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov solver context
+
+   Output Parameters:
++  k - the maximum number of deflation vectors, or NULL
+.  l - the number of harvested search directions, or NULL
+-  nk - the number of deflation vectors currently in use, or NULL
+
+   Level: intermediate
+
+.seealso: KSPDEFCG, KSPDEFCGSetRecycleSize()
+@*/
+PetscErrorCode KSPDEFCGGetRecycleSize(KSP ksp,PetscInt *k,PetscInt *l,PetscInt *nk)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  ierr = PetscUseMethod(ksp,"KSPDEFCGGetRecycleSize_C",(KSP,PetscInt*,PetscInt*,PetscInt*),(ksp,k,l,nk));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPDEFCG - Deflated preconditioned conjugate gradient that recycles approximate eigenvectors across solves
+
+   Options Database Keys:
++   -ksp_defcg_recycle <k> - number of deflation vectors, see KSPDEFCGSetRecycleSize()
+-   -ksp_defcg_harvest <l> - number of search directions of a solve used to update them
+
+   Level: intermediate
+
+   Notes:
+   The iteration is CG on the complement of a deflation space W: the initial guess is corrected with W (W^T A W)^{-1} W^T r and the
+   search directions are made A-orthogonal to W, so the eigenvalues of B A captured by W no longer slow down the convergence. The
+   first l search directions of each solve are stored, and at the end of the solve W is replaced by the approximate eigenvectors of
+   B A for its k smallest eigenvalues in the space spanned by W and these directions, B being the preconditioner.
+
+   The first solve is plain preconditioned CG; the next solves, e.g., for new right-hand sides or for matrices that change slowly
+   along a sequence of Newton steps or time steps, are deflated. When the operators have a new state, A W and B A W are recomputed at
+   the start of the solve with k products with the matrix and k applications of the preconditioner.
+
+   The operator and the preconditioner must be symmetric positive definite. Only left preconditioning is supported, the norms are the
+   same as for KSPCG. KSPSolveTranspose() is not supported.
+
+   References:
++  1. - Y. Saad, M. Yeung, J. Erhel and F. Guyomarc'h, A deflated version of the conjugate gradient algorithm, SIAM J. Sci. Comput., 2000.
+-  2. - A. Chapman and Y. Saad, Deflated and augmented Krylov subspace techniques, Numer. Linear Algebra Appl., 1997.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPCG, KSPGCRODR, KSPDEFCGSetRecycleSize()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_DEFCG(KSP ksp)
+{
+  KSP_DEFCG      *defcg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = PetscNewLog(ksp,&defcg);CHKERRQ(ierr);
+  ksp->data = (void*)defcg;
+  defcg->k  = 8;
+  defcg->l  = 16;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_DEFCG;
+  ksp->ops->solve          = KSPSolve_DEFCG;
+  ksp->ops->reset          = KSPReset_DEFCG;
+  ksp->ops->destroy        = KSPDestroy_DEFCG;
+  ksp->ops->view           = KSPView_DEFCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_DEFCG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDEFCGSetRecycleSize_C",KSPDEFCGSetRecycleSize_DEFCG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPDEFCGGetRecycleSize_C",KSPDEFCGGetRecycleSize_DEFCG);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,480 @@
+
+/*
+    Enlarged conjugate gradient: block CG on the enlarged Krylov space spanned by the residual split over subdomains
+*/
+#include <petsc/private/kspimpl.h>              /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+typedef struct {
+  PetscInt    t;                    /* number of subdomains requested with KSPECGSetEnlargingFactor(), or PETSC_DEFAULT */
+  PetscInt    ts;                   /* number of subdomains of the splitting of the last solve */
+  PetscBool   pcsplit;              /* the splitting comes from the subdomains of the preconditioner */
+  PetscInt    *part;                /* subdomain of each local row */
+  PetscInt    talloc;               /* the small arrays below are allocated for talloc subdomains */
+  Mat         R,Z,P,Q;              /* block residual, its preconditioned version, search directions and their image by A, t columns */
+  Mat         Xw;                   /* wrapper of the solution as a matrix with one column */
+  PetscScalar *work,*T,*L,*TL,*v;
+} KSP_ECG;
+
+static PetscErrorCode KSPSetUp_ECG(KSP ksp)
+{
+  KSP_ECG        *ecg = (KSP_ECG*)ksp->data;
+  PetscInt       m,N;
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ksp->pc_side == PC_RIGHT || ksp->pc_side == PC_SYMMETRIC) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPECG only supports left preconditioning");
+  ierr = KSPSetWorkVecs(ksp,1);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)ksp,&comm);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(ksp->work[0],&m);CHKERRQ(ierr);
+  ierr = VecGetSize(ksp->work[0],&N);CHKERRQ(ierr);
+  ierr = MatCreateDense(comm,m,PETSC_DECIDE,N,1,NULL,&ecg->Xw);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)ecg->Xw);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m,&ecg->part);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Assigns each local row to a subdomain: by default the subdomains of PCASM, without overlap, or the blocks of PCBJACOBI, as long as they
+   partition the local rows, grouped into at most 8 consecutive sets so that t does not grow with the number of processes; otherwise the
+   rows are split into t contiguous parts of the global numbering, which follow the parallel layout
+*/
+static PetscErrorCode KSPECGSetUpSplitting_Private(KSP ksp)
+{
+  KSP_ECG        *ecg = (KSP_ECG*)ksp->data;
+  PetscInt       i,j,b,m,N,rstart,rend,n = 0,offset,total,nidx,t;
+  const PetscInt *idx,*lens;
+  IS             *is,*is_local;
+  PetscBool      isasm,isbjacobi,valid = PETSC_FALSE,gvalid;
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)ksp,&comm);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(ksp->vec_sol,&rstart,&rend);CHKERRQ(ierr);
+  ierr = VecGetSize(ksp->vec_sol,&N);CHKERRQ(ierr);
+  m    = rend-rstart;
+  ierr = PetscObjectTypeCompare((PetscObject)ksp->pc,PCASM,&isasm);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ksp->pc,PCBJACOBI,&isbjacobi);CHKERRQ(ierr);
+  if (ecg->t == PETSC_DEFAULT && (isasm || isbjacobi)) {
+    for (i=0; i<m; i++) ecg->part[i] = -1;
+    if (isasm) {
+      ierr  = PCASMGetLocalSubdomains(ksp->pc,&n,&is,&is_local);CHKERRQ(ierr);
+      valid = (PetscBool)(n == 1 || is_local);
+      if (!is_local && n == 1) {
+        for (i=0; i<m; i++) ecg->part[i] = 0;
+      } else if (is_local) {
+        for (b=0; b<n && valid; b++) {
+          ierr = ISGetLocalSize(is_local[b],&nidx);CHKERRQ(ierr);
+          ierr = ISGetIndices(is_local[b],&idx);CHKERRQ(ierr);
+          for (j=0; j<nidx; j++) {
+            if (idx[j] < rstart || idx[j] >= rend || ecg->part[idx[j]-rstart] >= 0) {valid = PETSC_FALSE; break;}
+            ecg->part[idx[j]-rstart] = b;
+          }
+          ierr = ISRestoreIndices(is_local[b],&idx);CHKERRQ(ierr);
+        }
+      }
+    } else {
+      ierr = PCBJacobiGetLocalBlocks(ksp->pc,&n,&lens);CHKERRQ(ierr);
+      for (b=0,i=0; b<n && lens; b++) for (j=0; j<lens[b] && i<m; j++) ecg->part[i++] = b;
+      valid = PETSC_TRUE;
+    }
+    for (i=0; i<m && valid; i++) if (ecg->part[i] < 0) valid = PETSC_FALSE;
+    ierr = MPIU_Allreduce(&valid,&gvalid,1,MPIU_BOOL,MPI_LAND,comm);CHKERRQ(ierr);
+    if (gvalid) {
+      ierr = MPI_Scan(&n,&offset,1,MPIU_INT,MPI_SUM,comm);CHKERRMPI(ierr);
+      ierr = MPIU_Allreduce(&n,&total,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+      offset -= n;
+      ecg->ts = PetscMin(total,8);
+      for (i=0; i<m; i++) ecg->part[i] = (PetscInt)(((PetscInt64)(ecg->part[i]+offset)*ecg->ts)/total);
+    } else {
+      ierr = PetscInfo(ksp,"The subdomains of the preconditioner do not partition the local rows, the rows are split along the parallel layout\n");CHKERRQ(ierr);
+    }
+    ecg->pcsplit = gvalid;
+  } else ecg->pcsplit = PETSC_FALSE;
+  if (!ecg->pcsplit) {
+    ecg->ts = ecg->t == PETSC_DEFAULT ? 8 : ecg->t;
+    for (i=0; i<m; i++) ecg->part[i] = (PetscInt)(((PetscInt64)(rstart+i)*ecg->ts)/N);
+  }
+  t = ecg->ts;
+  if (t != ecg->talloc) {
+    ierr = PetscFree5(ecg->work,ecg->T,ecg->L,ecg->TL,ecg->v);CHKERRQ(ierr);
+    ierr = PetscMalloc5(2*t*t+1,&ecg->work,t*t,&ecg->T,t*t,&ecg->L,t*t,&ecg->TL,t,&ecg->v);CHKERRQ(ierr);
+    ecg->talloc = t;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* (re)creates the dense block *M when it does not have p columns */
+static PetscErrorCode KSPECGGetBlock_Private(KSP ksp,PetscInt p,Mat *M)
+{
+  PetscInt       q = -1,m,N;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (*M) {ierr = MatGetSize(*M,NULL,&q);CHKERRQ(ierr);}
+  if (q == p) PetscFunctionReturn(0);
+  ierr = MatDestroy(M);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(ksp->vec_sol,&m);CHKERRQ(ierr);
+  ierr = VecGetSize(ksp->vec_sol,&N);CHKERRQ(ierr);
+  ierr = MatCreateDense(PetscObjectComm((PetscObject)ksp),m,PETSC_DECIDE,N,p,NULL,M);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(*M,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*M,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)*M);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* local part of the squared norm used in the convergence test, the residual is the sum of the columns of R and M r the sum of those of Z */
+static PetscErrorCode KSPECGNormLocal_Private(KSP ksp,PetscScalar *d)
+{
+  KSP_ECG           *ecg = (KSP_ECG*)ksp->data;
+  const PetscScalar *r,*z;
+  PetscScalar       ri,zi;
+  PetscInt          i,j,m,t,ldr,ldz;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  *d = 0.0;
+  if (ksp->normtype == KSP_NORM_NONE) PetscFunctionReturn(0);
+  ierr = MatGetLocalSize(ecg->R,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(ecg->R,NULL,&t);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(ecg->R,&ldr);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(ecg->Z,&ldz);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(ecg->R,&r);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(ecg->Z,&z);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ri = zi = 0.0;
+    for (j=0; j<t; j++) {
+      ri += r[i+j*ldr];
+      zi += z[i+j*ldz];
+    }
+    switch (ksp->normtype) {
+    case KSP_NORM_PRECONDITIONED:   *d += PetscConj(zi)*zi; break;
+    case KSP_NORM_UNPRECONDITIONED: *d += PetscConj(ri)*ri; break;
+    case KSP_NORM_NATURAL:          *d += PetscConj(ri)*zi; break;
+    default: SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"%s",KSPNormTypes[ksp->normtype]);
+    }
+  }
+  ierr = MatDenseRestoreArrayRead(ecg->Z,&z);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(ecg->R,&r);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*m*t+2.0*m);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   ECG in the Orthomin form: block conjugate gradient, as in KSPMatSolve_CG(), applied to A X = T(r0), whose t columns are the restrictions of
+   the initial residual to the subdomains. Only the sums of the columns matter, x = x0 + X 1 and r = R 1, so the block of iterates is never
+   formed. With Z = M R each iteration performs
+
+      Q = A P, [P^H Q, P^H R]          one MatMatMult() and one reduction
+      P^H Q = (T T^H)^{-1}             rank revealing, the numerically dependent directions are dropped
+      x += P T T^H P^H R 1, R -= Q T T^H P^H R
+      Z = M R, [Q^H Z, norm of R 1]    one PCMatApply() and one reduction
+      P = Z - P T T^H Q^H Z
+*/
+static PetscErrorCode KSPSolve_ECG(KSP ksp)
+{
+  KSP_ECG        *ecg = (KSP_ECG*)ksp->data;
+  Mat            A,X[2],Y[2];
+  Vec            r;
+  PetscScalar    *work,*ra,*xa,dot,one = 1.0,zero = 0.0;
+  PetscReal      dp;
+  PetscInt       i,j,m,t,pn,ld,rstart;
+  PetscBLASInt   bt,bpn;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ksp->transpose_solve) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPSolveTranspose() is not supported by KSPECG");
+  ierr = PCGetOperators(ksp->pc,&A,NULL);CHKERRQ(ierr);
+  ierr = KSPECGSetUpSplitting_Private(ksp);CHKERRQ(ierr);
+  t    = ecg->ts;
+  work = ecg->work;
+  ierr = KSPECGGetBlock_Private(ksp,t,&ecg->R);CHKERRQ(ierr);
+  ierr = KSPECGGetBlock_Private(ksp,t,&ecg->Z);CHKERRQ(ierr);
+  ierr = KSPECGGetBlock_Private(ksp,t,&ecg->P);CHKERRQ(ierr);
+  ierr = MatDestroy(&ecg->Q);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(ksp->vec_sol,&m);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(ksp->vec_sol,&rstart,NULL);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(t,&bt);CHKERRQ(ierr);
+
+  /* r = b - A x, R = T(r) and Z = M R */
+  r    = ksp->work[0];
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,A,ksp->vec_sol,r);CHKERRQ(ierr);
+    ierr = VecAYPX(r,-1.0,ksp->vec_rhs);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(ksp->vec_rhs,r);CHKERRQ(ierr);
+  }
+  ierr = MatZeroEntries(ecg->R);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(ecg->R,&ld);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(ecg->R,&ra);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(r,(const PetscScalar**)&xa);CHKERRQ(ierr);
+  for (i=0; i<m; i++) ra[i+ecg->part[i]*ld] = xa[i];
+  ierr = VecRestoreArrayRead(r,(const PetscScalar**)&xa);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(ecg->R,&ra);CHKERRQ(ierr);
+  ierr = PCMatApply(ksp->pc,ecg->R,ecg->Z);CHKERRQ(ierr);
+  ierr = KSPECGNormLocal_Private(ksp,&dot);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&dot,1,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  ierr = MatCopy(ecg->Z,ecg->P,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  while (PETSC_TRUE) {
+    dp   = PetscSqrtReal(PetscAbsScalar(dot));
+    KSPCheckNorm(ksp,dp);
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->rnorm = dp;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,dp);CHKERRQ(ierr);
+    ierr = (*ksp->converged)(ksp,ksp->its,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+    if (ksp->reason) break;
+    if (ksp->its >= ksp->max_it) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+
+    /* Q = A P, [P^H Q, P^H R] and the A-orthonormalization P T */
+    ierr = MatMatMult(A,ecg->P,ecg->Q ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,PETSC_DEFAULT,&ecg->Q);CHKERRQ(ierr);
+    X[0] = ecg->P; Y[0] = ecg->Q;
+    X[1] = ecg->P; Y[1] = ecg->R;
+    ierr = KSPBlockInnerProducts_Private(ksp,2,X,Y,0,work);CHKERRQ(ierr);
+    ierr = KSPBlockOrthonormalize_Private(t,work,NULL,PETSC_SMALL,&pn,ecg->T,NULL,0);CHKERRQ(ierr);
+    if (!pn) {
+      ierr = PetscInfo1(ksp,"Breakdown of the block of search directions at iteration %D\n",ksp->its);CHKERRQ(ierr);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+    if (pn < t) {ierr = PetscInfo3(ksp,"Dropping %D of the %D search directions at iteration %D\n",t-pn,t,ksp->its);CHKERRQ(ierr);}
+    ierr = PetscBLASIntCast(pn,&bpn);CHKERRQ(ierr);
+
+    /* TL = T T^H P^H R, x += P TL 1, R -= Q TL */
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bpn,&bt,&bt,&one,ecg->T,&bt,work+t*t,&bt,&zero,ecg->L,&bpn));
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bt,&bt,&bpn,&one,ecg->T,&bt,ecg->L,&bpn,&zero,ecg->TL,&bt));
+    for (i=0; i<t; i++) for (ecg->v[i]=0.0,j=0; j<t; j++) ecg->v[i] += ecg->TL[i+j*t];
+    ierr = PetscLogFlops(4.0*t*t*pn+t*t);CHKERRQ(ierr);
+    ierr = VecGetArray(ksp->vec_sol,&xa);CHKERRQ(ierr);
+    ierr = MatDensePlaceArray(ecg->Xw,xa);CHKERRQ(ierr);
+    ierr = KSPBlockGemm_Private(1.0,ecg->P,ecg->v,t,1.0,ecg->Xw);CHKERRQ(ierr);
+    ierr = MatDenseResetArray(ecg->Xw);CHKERRQ(ierr);
+    ierr = VecRestoreArray(ksp->vec_sol,&xa);CHKERRQ(ierr);
+    ierr = KSPBlockGemm_Private(-1.0,ecg->Q,ecg->TL,t,1.0,ecg->R);CHKERRQ(ierr);
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->its++;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+    /* Z = M R, [Q^H Z, norm] */
+    ierr = PCMatApply(ksp->pc,ecg->R,ecg->Z);CHKERRQ(ierr);
+    X[0] = ecg->Q; Y[0] = ecg->Z;
+    ierr = KSPECGNormLocal_Private(ksp,work+t*t);CHKERRQ(ierr);
+    ierr = KSPBlockInnerProducts_Private(ksp,1,X,Y,1,work);CHKERRQ(ierr);
+    dot  = work[t*t];
+
+    /* P = Z - P T T^H Q^H Z, Q is used as work space before it is recomputed */
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bpn,&bt,&bt,&one,ecg->T,&bt,work,&bt,&zero,ecg->L,&bpn));
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bt,&bt,&bpn,&one,ecg->T,&bt,ecg->L,&bpn,&zero,ecg->TL,&bt));
+    ierr = PetscLogFlops(4.0*t*t*pn);CHKERRQ(ierr);
+    ierr = KSPBlockGemm_Private(-1.0,ecg->P,ecg->TL,t,0.0,ecg->Q);CHKERRQ(ierr);
+    ierr = MatAXPY(ecg->Q,1.0,ecg->Z,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatCopy(ecg->Q,ecg->P,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_ECG(KSP ksp)
+{
+  KSP_ECG        *ecg = (KSP_ECG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDestroy(&ecg->R);CHKERRQ(ierr);
+  ierr = MatDestroy(&ecg->Z);CHKERRQ(ierr);
+  ierr = MatDestroy(&ecg->P);CHKERRQ(ierr);
+  ierr = MatDestroy(&ecg->Q);CHKERRQ(ierr);
+  ierr = MatDestroy(&ecg->Xw);CHKERRQ(ierr);
+  ierr = PetscFree(ecg->part);CHKERRQ(ierr);
+  ierr = PetscFree5(ecg->work,ecg->T,ecg->L,ecg->TL,ecg->v);CHKERRQ(ierr);
+  ecg->talloc = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_ECG(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_ECG(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPECGSetEnlargingFactor_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPECGGetEnlargingFactor_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_ECG(KSP ksp,PetscViewer viewer)
+{
+  KSP_ECG        *ecg = (KSP_ECG*)ksp->data;
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    if (ecg->ts) {ierr = PetscViewerASCIIPrintf(viewer,"  enlarging factor %D, %s\n",ecg->ts,ecg->pcsplit ? "subdomains of the preconditioner" : "split along the parallel layout");CHKERRQ(ierr);}
+    else if (ecg->t == PETSC_DEFAULT) {ierr = PetscViewerASCIIPrintf(viewer,"  enlarging factor 8, grouping the subdomains of the preconditioner when possible\n");CHKERRQ(ierr);}
+    else {ierr = PetscViewerASCIIPrintf(viewer,"  enlarging factor %D\n",ecg->t);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_ECG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_ECG        *ecg = (KSP_ECG*)ksp->data;
+  PetscInt       t = ecg->t;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP ECG options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_ecg_enlarging_factor","Number of subdomains the residual is split over","KSPECGSetEnlargingFactor",t,&t,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPECGSetEnlargingFactor(ksp,t);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPECGSetEnlargingFactor_ECG(KSP ksp,PetscInt t)
+{
+  KSP_ECG *ecg = (KSP_ECG*)ksp->data;
+
+  PetscFunctionBegin;
+  if (t != PETSC_DEFAULT && t < 1) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"The enlarging factor must be positive");
+  ecg->t = t;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPECGGetEnlargingFactor_ECG(KSP ksp,PetscInt *t)
+{
+  KSP_ECG *ecg = (KSP_ECG*)ksp->data;
+
+  PetscFunctionBegin;
+  *t = ecg->ts ? ecg->ts : ecg->t;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPECGSetEnlargingFactor - Sets the number of subdomains KSPECG splits the residual over, which is the number of search directions of
+   each iteration
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+-  t - the enlarging factor, or PETSC_DEFAULT
+
+   Options Database Key:
+.  -ksp_ecg_enlarging_factor <t> - the enlarging factor
+
+   Notes:
+   With a given t the rows are split into t contiguous parts of the global numbering, so that with t a multiple of the number of processes
+   each process splits its rows into t/size parts. With PETSC_DEFAULT, the default, t = 8 and, when the preconditioner is PCASM or
+   PCBJACOBI, the subdomains of PCASM (without overlap) or the blocks of PCBJACOBI are grouped into t sets of consecutive subdomains, or
+   are used as they are if there are fewer than 8 of them, so that each direction spans whole subdomains of the preconditioner.
+
+   Level: intermediate
+
+.seealso: KSPECG, KSPECGGetEnlargingFactor()
+@*/
+PetscErrorCode KSPECGSetEnlargingFactor(KSP ksp,PetscInt t)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,t,2);
+  ierr = PetscTryMethod(ksp,"KSPECGSetEnlargingFactor_C",(KSP,PetscInt),(ksp,t));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPECGGetEnlargingFactor - Gets the number of subdomains KSPECG splits the residual over
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov solver context
+
+   Output Parameter:
+.  t - the enlarging factor of the last solve, or the one that was set before the first solve
+
+   Level: intermediate
+
+.seealso: KSPECG, KSPECGSetEnlargingFactor()
+@*/
+PetscErrorCode KSPECGGetEnlargingFactor(KSP ksp,PetscInt *t)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidIntPointer(t,2);
+  ierr = PetscUseMethod(ksp,"KSPECGGetEnlargingFactor_C",(KSP,PetscInt*),(ksp,t));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPECG - Enlarged conjugate gradient, for symmetric (Hermitian) positive definite matrices and preconditioners
+
+   Options Database Keys:
+.   -ksp_ecg_enlarging_factor <t> - number of subdomains the residual is split over, see KSPECGSetEnlargingFactor()
+
+   Level: intermediate
+
+   Notes:
+   The initial residual r is split into t vectors, its restrictions to t subdomains, and the iteration is the block conjugate gradient
+   of KSPMatSolve() applied to these t right-hand sides, of which only the sum matters. The iterate minimizes the A-norm of the error over
+   the enlarged Krylov space, which grows by t directions per iteration, so far fewer iterations than KSPCG are usually needed on
+   problems with heterogeneous coefficients. Each iteration performs one MatMatMult() and one PCMatApply() with t columns and two global
+   reductions, as KSPCG, each of them carrying O(t^2) numbers; the search directions that become numerically dependent are dropped from
+   the update at each iteration.
+
+   Only left preconditioning is supported. All the norm types cost the same, the preconditioned residual is the sum of the columns of
+   the preconditioned block residual. The subdomains are those of PCASM or PCBJACOBI when the preconditioner is one of them, see
+   KSPECGSetEnlargingFactor().
+
+   References:
++  1. - L. Grigori, S. Moufawad and F. Nataf, Enlarged Krylov subspace conjugate gradient methods for reducing communication, SIAM J.
+        Matrix Anal. Appl., 2016.
+-  2. - L. Grigori and O. Tissot, Scalable linear solvers based on enlarged Krylov subspaces with dynamic reduction of search directions,
+        SIAM J. Sci. Comput., 2019.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPCG, KSPMatSolve(), KSPECGSetEnlargingFactor()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_ECG(KSP ksp)
+{
+  KSP_ECG        *ecg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = PetscNewLog(ksp,&ecg);CHKERRQ(ierr);
+  ksp->data = (void*)ecg;
+  ecg->t    = PETSC_DEFAULT;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_ECG;
+  ksp->ops->solve          = KSPSolve_ECG;
+  ksp->ops->reset          = KSPReset_ECG;
+  ksp->ops->destroy        = KSPDestroy_ECG;
+  ksp->ops->view           = KSPView_ECG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_ECG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPECGSetEnlargingFactor_C",KSPECGSetEnlargingFactor_ECG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPECGGetEnlargingFactor_C",KSPECGGetEnlargingFactor_ECG);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -1,5 +1,7 @@
 
 #include <../src/ksp/ksp/impls/cheby/chebyshevimpl.h>    /*I "petscksp.h" I*/
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+#include <petsc/private/pcimpl.h>
 
 static PetscErrorCode KSPReset_Chebyshev(KSP ksp)
 {
@@ -10,6 +12,24 @@ static PetscErrorCode KSPReset_Chebyshev(KSP ksp)
   if (cheb->kspest) {
     ierr = KSPReset(cheb->kspest);CHKERRQ(ierr);
   }
+  ierr = VecDestroy(&cheb->vpow);CHKERRQ(ierr);
+  ierr = VecDestroy(&cheb->dinv);CHKERRQ(ierr);
+  cheb->dinvid = 0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   One step of the power iteration vpow = B^{-1}A vpow/||B^{-1}A vpow|| for a normalized vpow, lambda = ||B^{-1}A vpow||
+*/
+static PetscErrorCode KSPChebyshevPowerStep_Private(KSP ksp,Mat Amat,PetscReal *lambda)
+{
+  KSP_Chebyshev  *cheb = (KSP_Chebyshev*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSP_MatMult(ksp,Amat,cheb->vpow,ksp->work[2]);CHKERRQ(ierr);
+  ierr = KSP_PCApply(ksp,ksp->work[2],cheb->vpow);CHKERRQ(ierr);
+  ierr = VecNormalize(cheb->vpow,lambda);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -67,56 +87,79 @@ static PetscErrorCode KSPSetUp_Chebyshev(KSP ksp)
     ierr = PetscObjectStateGet((PetscObject)Amat,&amatstate);CHKERRQ(ierr);
     ierr = PetscObjectStateGet((PetscObject)Pmat,&pmatstate);CHKERRQ(ierr);
     if (amatid != cheb->amatid || pmatid != cheb->pmatid || amatstate != cheb->amatstate || pmatstate != cheb->pmatstate) {
-      PetscReal          max=0.0,min=0.0;
+      PetscReal          max=0.0,min=0.0,lambda;
       Vec                B;
       KSPConvergedReason reason;
-      ierr = KSPSetPC(cheb->kspest,ksp->pc);CHKERRQ(ierr);
-      if (cheb->usenoisy) {
-        B = ksp->work[1];
-        ierr = KSPSetNoisy_Private(B);CHKERRQ(ierr);
-      } else {
-        PetscBool change;
-
-        if (!ksp->vec_rhs) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Chebyshev must use a noisy right hand side to estimate the eigenvalues when no right hand side is available");
-        ierr = PCPreSolveChangeRHS(ksp->pc,&change);CHKERRQ(ierr);
-        if (change) {
-          B = ksp->work[1];
-          ierr = VecCopy(ksp->vec_rhs,B);CHKERRQ(ierr);
-        } else B = ksp->vec_rhs;
-      }
-      ierr = KSPSolve(cheb->kspest,B,ksp->work[0]);CHKERRQ(ierr);
-      ierr = KSPGetConvergedReason(cheb->kspest,&reason);CHKERRQ(ierr);
-      if (reason == KSP_DIVERGED_ITS) {
-        ierr = PetscInfo(ksp,"Eigen estimator ran for prescribed number of iterations\n");CHKERRQ(ierr);
-      } else if (reason == KSP_DIVERGED_PC_FAILED) {
-        PetscInt       its;
-        PCFailedReason pcreason;
-
-        ierr = KSPGetIterationNumber(cheb->kspest,&its);CHKERRQ(ierr);
-        if (ksp->normtype == KSP_NORM_NONE) {
-          PetscInt  sendbuf,recvbuf;
-          ierr = PCGetFailedReasonRank(ksp->pc,&pcreason);CHKERRQ(ierr);
-          sendbuf = (PetscInt)pcreason;
-          ierr = MPI_Allreduce(&sendbuf,&recvbuf,1,MPIU_INT,MPI_MAX,PetscObjectComm((PetscObject)ksp));CHKERRMPI(ierr);
-          ierr = PCSetFailedReason(ksp->pc,(PCFailedReason) recvbuf);CHKERRQ(ierr);
+      PetscBool          reuse = PETSC_FALSE;
+
+      /* keep the estimates of a matrix whose values changed little, as measured by one more step of a power iteration */
+      if (cheb->reusetol > 0.0 && cheb->vpow && amatid == cheb->amatid && pmatid == cheb->pmatid) {
+        ierr = KSPChebyshevPowerStep_Private(ksp,Amat,&lambda);CHKERRQ(ierr);
+        if (!PetscIsInfOrNanReal(lambda) && PetscAbsReal(lambda - cheb->lambdapow) <= cheb->reusetol*cheb->lambdapow) {
+          ierr  = PetscInfo2(ksp,"Reusing the eigenvalue estimates, power iteration estimate changed from %g to %g\n",(double)cheb->lambdapow,(double)lambda);CHKERRQ(ierr);
+          reuse = PETSC_TRUE;
         }
-        ierr = PCGetFailedReason(ksp->pc,&pcreason);CHKERRQ(ierr);
-        ksp->reason = KSP_DIVERGED_PC_FAILED;
-        ierr = PetscInfo3(ksp,"Eigen estimator failed: %s %s at iteration %D",KSPConvergedReasons[reason],PCFailedReasons[pcreason],its);CHKERRQ(ierr);
-        PetscFunctionReturn(0);
-      } else if (reason == KSP_CONVERGED_RTOL || reason == KSP_CONVERGED_ATOL) {
-        ierr = PetscInfo(ksp,"Eigen estimator converged prematurely. Should not happen except for small or low rank problem\n");CHKERRQ(ierr);
-      } else if (reason < 0) {
-        ierr = PetscInfo1(ksp,"Eigen estimator failed %s, using estimates anyway\n",KSPConvergedReasons[reason]);CHKERRQ(ierr);
+        cheb->lambdapow = lambda;
       }
+      if (!reuse) {
+        ierr = KSPSetPC(cheb->kspest,ksp->pc);CHKERRQ(ierr);
+        if (cheb->usenoisy) {
+          B = ksp->work[1];
+          ierr = KSPSetNoisy_Private(B);CHKERRQ(ierr);
+        } else {
+          PetscBool change;
+
+          if (!ksp->vec_rhs) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Chebyshev must use a noisy right hand side to estimate the eigenvalues when no right hand side is available");
+          ierr = PCPreSolveChangeRHS(ksp->pc,&change);CHKERRQ(ierr);
+          if (change) {
+            B = ksp->work[1];
+            ierr = VecCopy(ksp->vec_rhs,B);CHKERRQ(ierr);
+          } else B = ksp->vec_rhs;
+        }
+        ierr = KSPSolve(cheb->kspest,B,ksp->work[0]);CHKERRQ(ierr);
+        ierr = KSPGetConvergedReason(cheb->kspest,&reason);CHKERRQ(ierr);
+        if (reason == KSP_DIVERGED_ITS) {
+          ierr = PetscInfo(ksp,"Eigen estimator ran for prescribed number of iterations\n");CHKERRQ(ierr);
+        } else if (reason == KSP_DIVERGED_PC_FAILED) {
+          PetscInt       its;
+          PCFailedReason pcreason;
+
+          ierr = KSPGetIterationNumber(cheb->kspest,&its);CHKERRQ(ierr);
+          if (ksp->normtype == KSP_NORM_NONE) {
+            PetscInt  sendbuf,recvbuf;
+            ierr = PCGetFailedReasonRank(ksp->pc,&pcreason);CHKERRQ(ierr);
+            sendbuf = (PetscInt)pcreason;
+            ierr = MPI_Allreduce(&sendbuf,&recvbuf,1,MPIU_INT,MPI_MAX,PetscObjectComm((PetscObject)ksp));CHKERRMPI(ierr);
+            ierr = PCSetFailedReason(ksp->pc,(PCFailedReason) recvbuf);CHKERRQ(ierr);
+          }
+          ierr = PCGetFailedReason(ksp->pc,&pcreason);CHKERRQ(ierr);
+          ksp->reason = KSP_DIVERGED_PC_FAILED;
+          ierr = PetscInfo3(ksp,"Eigen estimator failed: %s %s at iteration %D",KSPConvergedReasons[reason],PCFailedReasons[pcreason],its);CHKERRQ(ierr);
+          PetscFunctionReturn(0);
+        } else if (reason == KSP_CONVERGED_RTOL || reason == KSP_CONVERGED_ATOL) {
+          ierr = PetscInfo(ksp,"Eigen estimator converged prematurely. Should not happen except for small or low rank problem\n");CHKERRQ(ierr);
+        } else if (reason < 0) {
+          ierr = PetscInfo1(ksp,"Eigen estimator failed %s, using estimates anyway\n",KSPConvergedReasons[reason]);CHKERRQ(ierr);
+        }
 
-      ierr = KSPChebyshevComputeExtremeEigenvalues_Private(cheb->kspest,&min,&max);CHKERRQ(ierr);
-      ierr = KSPSetPC(cheb->kspest,NULL);CHKERRQ(ierr);
+        ierr = KSPChebyshevComputeExtremeEigenvalues_Private(cheb->kspest,&min,&max);CHKERRQ(ierr);
+        ierr = KSPSetPC(cheb->kspest,NULL);CHKERRQ(ierr);
 
-      cheb->emin_computed = min;
-      cheb->emax_computed = max;
-      cheb->emin = cheb->tform[0]*min + cheb->tform[1]*max;
-      cheb->emax = cheb->tform[2]*min + cheb->tform[3]*max;
+        cheb->emin_computed = min;
+        cheb->emax_computed = max;
+        cheb->emin = cheb->tform[0]*min + cheb->tform[1]*max;
+        cheb->emax = cheb->tform[2]*min + cheb->tform[3]*max;
+
+        /* start the power iteration used to decide if later estimates can be reused */
+        if (cheb->reusetol > 0.0) {
+          PetscInt its;
+
+          if (!cheb->vpow) {ierr = VecDuplicate(ksp->work[0],&cheb->vpow);CHKERRQ(ierr);}
+          ierr = KSPSetNoisy_Private(cheb->vpow);CHKERRQ(ierr);
+          ierr = VecNormalize(cheb->vpow,NULL);CHKERRQ(ierr);
+          for (its=0; its<3; its++) {ierr = KSPChebyshevPowerStep_Private(ksp,Amat,&cheb->lambdapow);CHKERRQ(ierr);}
+        }
+      }
 
       cheb->amatid    = amatid;
       cheb->pmatid    = pmatid;
@@ -186,6 +229,27 @@ static PetscErrorCode KSPChebyshevEstEigSetUseNoisy_Chebyshev(KSP ksp,PetscBool
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode KSPChebyshevEstEigSetReuseTolerance_Chebyshev(KSP ksp,PetscReal rtol)
+{
+  KSP_Chebyshev  *cheb = (KSP_Chebyshev*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (rtol < 0.0) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Tolerance %g must be nonnegative",(double)rtol);
+  cheb->reusetol = rtol;
+  if (rtol == 0.0) {ierr = VecDestroy(&cheb->vpow);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPChebyshevSetFused_Chebyshev(KSP ksp,PetscBool flg)
+{
+  KSP_Chebyshev  *cheb = (KSP_Chebyshev*)ksp->data;
+
+  PetscFunctionBegin;
+  cheb->usefused = flg;
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPChebyshevSetEigenvalues - Sets estimates for the extreme eigenvalues
    of the preconditioned problem.
@@ -217,6 +281,49 @@ PetscErrorCode  KSPChebyshevSetEigenvalues(KSP ksp,PetscReal emax,PetscReal emin
   PetscFunctionReturn(0);
 }
 
+/*@
+   KSPChebyshevGetEigenvalues - Gets the estimates for the extreme eigenvalues of the preconditioned problem used by KSPCHEBYSHEV
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameters:
++  emax - the estimate of the largest eigenvalue
+-  emin - the estimate of the smallest eigenvalue
+
+   Notes:
+   These are the values set with KSPChebyshevSetEigenvalues() or, after the KSP is set up, the estimates computed with
+   KSPChebyshevEstEigSet() transformed into the Chebyshev bounds. They are 0 when neither is available or the KSP is not KSPCHEBYSHEV.
+
+   Level: intermediate
+
+.seealso: KSPChebyshevSetEigenvalues(), KSPChebyshevEstEigSet()
+@*/
+PetscErrorCode KSPChebyshevGetEigenvalues(KSP ksp,PetscReal *emax,PetscReal *emin)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidRealPointer(emax,2);
+  PetscValidRealPointer(emin,3);
+  *emax = *emin = 0.0;
+  ierr = PetscTryMethod(ksp,"KSPChebyshevGetEigenvalues_C",(KSP,PetscReal*,PetscReal*),(ksp,emax,emin));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPChebyshevGetEigenvalues_Chebyshev(KSP ksp,PetscReal *emax,PetscReal *emin)
+{
+  KSP_Chebyshev *cheb = (KSP_Chebyshev*)ksp->data;
+
+  PetscFunctionBegin;
+  *emax = cheb->emax;
+  *emin = cheb->emin;
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPChebyshevEstEigSet - Automatically estimate the eigenvalues to use for Chebyshev
 
@@ -293,6 +400,73 @@ PetscErrorCode KSPChebyshevEstEigSetUseNoisy(KSP ksp,PetscBool use)
   PetscFunctionReturn(0);
 }
 
+/*@
+   KSPChebyshevEstEigSetReuseTolerance - keep the eigenvalue estimates when the values of the operator change little
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - linear solver context
+-  rtol - the largest relative change of the estimate of the largest eigenvalue for which the estimates are kept, 0.0 (the default)
+          estimates the eigenvalues again every time the operator changes
+
+   Options Database:
+.  -ksp_chebyshev_esteig_reuse_tol <rtol>
+
+   Notes:
+   When the operators keep their nonzero structure, for example the Jacobians of a Newton method, the change is measured with one step of a
+   power iteration for the preconditioned operator, which costs one matrix-vector product and one application of the preconditioner instead of
+   the steps of the Krylov method used for the estimates. If the power iteration estimate changed by less than rtol, the previous estimates are kept.
+   The power iteration continues across the changes of the operator, so its estimate also improves over time.
+
+   Level: intermediate
+
+.seealso: KSPChebyshevEstEigSet(), KSPChebyshevEstEigSetUseNoisy()
+@*/
+PetscErrorCode KSPChebyshevEstEigSetReuseTolerance(KSP ksp,PetscReal rtol)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveReal(ksp,rtol,2);
+  ierr = PetscTryMethod(ksp,"KSPChebyshevEstEigSetReuseTolerance_C",(KSP,PetscReal),(ksp,rtol));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPChebyshevSetFused - use a fused kernel for the Chebyshev iterations with PCJACOBI or PCPBJACOBI and AIJ matrices
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - linear solver context
+-  flg - PETSC_TRUE to use the fused kernel, the default is PETSC_FALSE
+
+   Options Database:
+.  -ksp_chebyshev_fused <true,false>
+
+   Notes:
+   The fused kernel computes the residual, applies the (point-block) Jacobi preconditioner and updates the iterate in one pass over the rows of
+   the matrix, instead of separate MatMult(), PCApply() and vector operations. It is only used for MATSEQAIJ and MATMPIAIJ operators without
+   a null space attached with MatSetNullSpace(), and gives the same iterates as the separate operations. Its time and flops are logged
+   under both the MatMult and the PCApply events.
+
+   Level: advanced
+
+.seealso: KSPCHEBYSHEV, PCJACOBI, PCPBJACOBI
+@*/
+PetscErrorCode KSPChebyshevSetFused(KSP ksp,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveBool(ksp,flg,2);
+  ierr = PetscTryMethod(ksp,"KSPChebyshevSetFused_C",(KSP,PetscBool),(ksp,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
   KSPChebyshevEstEigGetKSP - Get the Krylov method context used to estimate eigenvalues for the Chebyshev method.  If
   a Krylov method is not being used for this purpose, NULL is returned.  The reference count of the returned KSP is
@@ -336,11 +510,13 @@ static PetscErrorCode KSPSetFromOptions_Chebyshev(PetscOptionItems *PetscOptions
   PetscInt       neigarg = 2, nestarg = 4;
   PetscReal      eminmax[2] = {0., 0.};
   PetscReal      tform[4] = {PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE};
-  PetscBool      flgeig, flgest;
+  PetscBool      flgeig, flgest, flg;
+  PetscReal      rtol;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"KSP Chebyshev Options");CHKERRQ(ierr);
   ierr = PetscOptionsInt("-ksp_chebyshev_esteig_steps","Number of est steps in Chebyshev","",cheb->eststeps,&cheb->eststeps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-ksp_chebyshev_fused","Fuse the residual, Jacobi scaling and update for AIJ matrices","KSPChebyshevSetFused",cheb->usefused,&cheb->usefused,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsRealArray("-ksp_chebyshev_eigenvalues","extreme eigenvalues","KSPChebyshevSetEigenvalues",eminmax,&neigarg,&flgeig);CHKERRQ(ierr);
   if (flgeig) {
     if (neigarg != 2) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_INCOMP,"-ksp_chebyshev_eigenvalues: must specify 2 parameters, min and max eigenvalues");
@@ -369,12 +545,186 @@ static PetscErrorCode KSPSetFromOptions_Chebyshev(PetscOptionItems *PetscOptions
 
   if (cheb->kspest) {
     ierr = PetscOptionsBool("-ksp_chebyshev_esteig_noisy","Use noisy right hand side for estimate","KSPChebyshevEstEigSetUseNoisy",cheb->usenoisy,&cheb->usenoisy,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsReal("-ksp_chebyshev_esteig_reuse_tol","Keep the estimates if the power iteration estimate changes less than this","KSPChebyshevEstEigSetReuseTolerance",cheb->reusetol,&rtol,&flg);CHKERRQ(ierr);
+    if (flg) {ierr = KSPChebyshevEstEigSetReuseTolerance(ksp,rtol);CHKERRQ(ierr);}
     ierr = KSPSetFromOptions(cheb->kspest);CHKERRQ(ierr);
   }
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+/*
+   Decides if KSPSolve_Chebyshev() can use the fused kernel: the operator is MATSEQAIJ or MATMPIAIJ and the
+   preconditioner is PCJACOBI, whose diagonal is cached in dinv, or PCPBJACOBI, whose inverted blocks are kept by the Mat.
+   The kernel does not remove a null space of the operator from the preconditioned residual as KSP_PCApply() does, so
+   operators with a null space use the separate kernels.
+*/
+static PetscErrorCode KSPChebyshevFusedSetUp_Private(KSP ksp,Mat Amat,Mat Pmat,PetscBool *fused,PetscInt *bs,const MatScalar **bdiag)
+{
+  KSP_Chebyshev    *cheb = (KSP_Chebyshev*)ksp->data;
+  PetscErrorCode   ierr;
+  PetscBool        isaij,isaijo = PETSC_TRUE,isjacobi,ispbjacobi;
+  MatNullSpace     nullsp;
+  PetscObjectId    id;
+  PetscObjectState state;
+
+  PetscFunctionBegin;
+  *fused = PETSC_FALSE;
+  *bs    = 1;
+  *bdiag = NULL;
+  if (!cheb->usefused || ksp->transpose_solve) PetscFunctionReturn(0);
+  ierr = MatGetNullSpace(Amat,&nullsp);CHKERRQ(ierr);
+  if (nullsp) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)Amat,MATMPIAIJ,&isaij);CHKERRQ(ierr);
+  if (isaij) {
+    Mat_MPIAIJ *aij = (Mat_MPIAIJ*)Amat->data;
+
+    ierr = PetscObjectTypeCompare((PetscObject)aij->A,MATSEQAIJ,&isaij);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)aij->B,MATSEQAIJ,&isaijo);CHKERRQ(ierr);
+  } else {
+    ierr = PetscObjectTypeCompare((PetscObject)Amat,MATSEQAIJ,&isaij);CHKERRQ(ierr);
+  }
+  if (!isaij || !isaijo) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)ksp->pc,PCJACOBI,&isjacobi);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ksp->pc,PCPBJACOBI,&ispbjacobi);CHKERRQ(ierr);
+  if (isjacobi) {
+    ierr = PetscObjectGetId((PetscObject)Pmat,&id);CHKERRQ(ierr);
+    ierr = PetscObjectStateGet((PetscObject)Pmat,&state);CHKERRQ(ierr);
+    if (!cheb->dinv) {ierr = VecDuplicate(ksp->vec_rhs,&cheb->dinv);CHKERRQ(ierr);}
+    if (id != cheb->dinvid || state != cheb->dinvstate) {
+      /* the diagonal is obtained by applying the preconditioner to ones, so all the PCJacobiType variants are supported */
+      ierr = VecSet(ksp->work[2],1.0);CHKERRQ(ierr);
+      ierr = PCApply(ksp->pc,ksp->work[2],cheb->dinv);CHKERRQ(ierr);
+      cheb->dinvid    = id;
+      cheb->dinvstate = state;
+    }
+    *fused = PETSC_TRUE;
+  } else if (ispbjacobi) {
+    ierr   = MatInvertBlockDiagonal(Pmat,bdiag);CHKERRQ(ierr);
+    ierr   = MatGetBlockSize(Pmat,bs);CHKERRQ(ierr);
+    *fused = PETSC_TRUE;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   The fused Chebyshev step for Jacobi preconditioned AIJ matrices, computes in one sweep over the rows
+.vb
+     r      = b - A xk
+     xkp1   = alpha xkm1 + beta xk + gam D r
+.ve
+   where D is dinv, or the bs x bs blocks of bdiag. The norm of r, or of D r, is computed if requested by normtype.
+   MATMPIAIJ needs a second sweep for the off-diagonal part, the first sweep overlaps with the ghost update of xk.
+   The sweep does the work of both MatMult() and PCApply(), so it is logged in both events.
+*/
+static PetscErrorCode KSPChebyshevFusedStep_Private(KSP ksp,Mat A,Vec dinv,PetscInt bs,const MatScalar *bdiag,Vec b,Vec xkm1,Vec xk,Vec r,Vec xkp1,PetscScalar alpha,PetscScalar beta,PetscScalar gam,PetscReal *rnorm)
+{
+  PetscErrorCode    ierr;
+  PetscBool         ismpi;
+  Mat               Ad,Ao = NULL;
+  Mat_MPIAIJ        *aij = NULL;
+  Mat_SeqAIJ        *ad,*ao = NULL;
+  const MatScalar   *aa,*aoa = NULL,*v;
+  const PetscInt    *aj;
+  const PetscScalar *x,*lx = NULL,*bb,*xm1,*d = NULL;
+  PetscScalar       *t,*y,sum,z[8],*zz = z;
+  PetscInt          m,mbs,i,ib,k,j,n;
+  PetscReal         nrm = 0.0,gnrm;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(MAT_Mult,A,xk,r,0);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PC_Apply,ksp->pc,r,xkp1,0);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATMPIAIJ,&ismpi);CHKERRQ(ierr);
+  if (ismpi) {
+    aij  = (Mat_MPIAIJ*)A->data;
+    Ad   = aij->A;
+    Ao   = aij->B;
+    ao   = (Mat_SeqAIJ*)Ao->data;
+    ierr = VecScatterBegin(aij->Mvctx,xk,aij->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  } else Ad = A;
+  ad   = (Mat_SeqAIJ*)Ad->data;
+  m    = Ad->rmap->n;
+  mbs  = m/bs;
+  if (bs > 8) {ierr = PetscMalloc1(bs,&zz);CHKERRQ(ierr);}
+  ierr = MatSeqAIJGetArrayRead(Ad,&aa);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xk,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xkm1,&xm1);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(b,&bb);CHKERRQ(ierr);
+  ierr = VecGetArray(r,&t);CHKERRQ(ierr);
+  ierr = VecGetArray(xkp1,&y);CHKERRQ(ierr);
+  if (dinv) {ierr = VecGetArrayRead(dinv,&d);CHKERRQ(ierr);}
+  if (ismpi) {
+    /* diagonal part of A xk while the ghost values are communicated */
+    for (i=0; i<m; i++) {
+      n   = ad->i[i+1] - ad->i[i];
+      aj  = ad->j + ad->i[i];
+      v   = aa + ad->i[i];
+      sum = 0.0;
+      PetscSparseDensePlusDot(sum,x,v,aj,n);
+      t[i] = sum;
+    }
+    ierr = VecScatterEnd(aij->Mvctx,xk,aij->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(aij->lvec,&lx);CHKERRQ(ierr);
+    ierr = MatSeqAIJGetArrayRead(Ao,&aoa);CHKERRQ(ierr);
+  }
+  for (ib=0; ib<mbs; ib++) {
+    /* residual of the rows of the block */
+    for (k=0; k<bs; k++) {
+      i = ib*bs + k;
+      if (ismpi) {
+        n   = ao->i[i+1] - ao->i[i];
+        aj  = ao->j + ao->i[i];
+        v   = aoa + ao->i[i];
+        sum = t[i];
+        PetscSparseDensePlusDot(sum,lx,v,aj,n);
+      } else {
+        n   = ad->i[i+1] - ad->i[i];
+        aj  = ad->j + ad->i[i];
+        v   = aa + ad->i[i];
+        sum = 0.0;
+        PetscSparseDensePlusDot(sum,x,v,aj,n);
+      }
+      t[i] = bb[i] - sum;
+    }
+    /* Jacobi scaling, in the same order of operations as PCApply() */
+    if (d) zz[0] = t[ib]*d[ib];
+    else {
+      for (k=0; k<bs; k++) {
+        zz[k] = 0.0;
+        for (j=0; j<bs; j++) zz[k] += bdiag[k+j*bs]*t[ib*bs+j];
+      }
+      bdiag += bs*bs;
+    }
+    /* update */
+    for (k=0; k<bs; k++) {
+      i = ib*bs + k;
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) nrm += PetscRealPart(zz[k]*PetscConj(zz[k]));
+      else if (ksp->normtype) nrm += PetscRealPart(t[i]*PetscConj(t[i]));
+      y[i] = alpha*xm1[i] + beta*x[i] + gam*zz[k];
+    }
+  }
+  if (ismpi) {
+    ierr = MatSeqAIJRestoreArrayRead(Ao,&aoa);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(aij->lvec,&lx);CHKERRQ(ierr);
+  }
+  if (dinv) {ierr = VecRestoreArrayRead(dinv,&d);CHKERRQ(ierr);}
+  ierr = VecRestoreArray(xkp1,&y);CHKERRQ(ierr);
+  ierr = VecRestoreArray(r,&t);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(b,&bb);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xkm1,&xm1);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xk,&x);CHKERRQ(ierr);
+  ierr = MatSeqAIJRestoreArrayRead(Ad,&aa);CHKERRQ(ierr);
+  if (bs > 8) {ierr = PetscFree(zz);CHKERRQ(ierr);}
+  ierr = PetscLogFlops(2.0*(ad->nz + (ao ? ao->nz : 0)) + (2.0*bs + 5.0)*m + (ksp->normtype ? 2.0*m : 0.0));CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PC_Apply,ksp->pc,r,xkp1,0);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_Mult,A,xk,r,0);CHKERRQ(ierr);
+  if (ksp->normtype) {
+    ierr   = MPIU_Allreduce(&nrm,&gnrm,1,MPIU_REAL,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRMPI(ierr);
+    *rnorm = PetscSqrtReal(gnrm);
+  }
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
 {
   KSP_Chebyshev  *cheb = (KSP_Chebyshev*)ksp->data;
@@ -384,13 +734,16 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
   PetscReal      rnorm = 0.0;
   Vec            sol_orig,b,p[3],r;
   Mat            Amat,Pmat;
-  PetscBool      diagonalscale;
+  PetscBool      diagonalscale,fused;
+  PetscInt       bs;
+  const MatScalar *bdiag;
 
   PetscFunctionBegin;
   ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
   if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
 
   ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = KSPChebyshevFusedSetUp_Private(ksp,Amat,Pmat,&fused,&bs,&bdiag);CHKERRQ(ierr);
   ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
   ksp->its = 0;
   ierr   = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
@@ -461,45 +814,65 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
     ksp->its++;
     ierr   = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
 
-    ierr = KSP_MatMult(ksp,Amat,p[k],r);CHKERRQ(ierr);          /*  r = b - Ap[k]    */
-    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
-    /* calculate residual norm if requested */
-    if (ksp->normtype) {
-      switch (ksp->normtype) {
-      case KSP_NORM_PRECONDITIONED:
-        ierr = KSP_PCApply(ksp,r,p[kp1]);CHKERRQ(ierr);             /*  p[kp1] = B^{-1}r  */
-        ierr = VecNorm(p[kp1],NORM_2,&rnorm);CHKERRQ(ierr);
-        break;
-      case KSP_NORM_UNPRECONDITIONED:
-      case KSP_NORM_NATURAL:
-        ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
-        break;
-      default:
-        rnorm = 0.0;
-        break;
+    if (fused) {
+      c[kp1] = 2.0*mu*c[k] - c[km1];
+      omega  = omegaprod*c[k]/c[kp1];
+
+      /* r^{k} = b - Ay^{k} and y^{k+1} = omega(y^{k} - y^{k-1} + Gamma*scale*B^{-1}r^{k}) + y^{k-1} in one sweep */
+      ierr = KSPChebyshevFusedStep_Private(ksp,Amat,bdiag ? NULL : cheb->dinv,bs,bdiag,b,p[km1],p[k],r,p[kp1],1.0-omega,omega,omega*Gamma*scale,&rnorm);CHKERRQ(ierr);
+      if (ksp->normtype) {
+        KSPCheckNorm(ksp,rnorm);
+        ierr         = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+        ksp->rnorm   = rnorm;
+        ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+        ierr = KSPLogResidualHistory(ksp,rnorm);CHKERRQ(ierr);
+        ierr = KSPMonitor(ksp,i,rnorm);CHKERRQ(ierr);
+        ierr = (*ksp->converged)(ksp,i,rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+        if (ksp->reason) break;
       }
-      KSPCheckNorm(ksp,rnorm);
-      ierr         = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
-      ksp->rnorm   = rnorm;
-      ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
-      ierr = KSPLogResidualHistory(ksp,rnorm);CHKERRQ(ierr);
-      ierr = KSPMonitor(ksp,i,rnorm);CHKERRQ(ierr);
-      ierr = (*ksp->converged)(ksp,i,rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
-      if (ksp->reason) break;
-      if (ksp->normtype != KSP_NORM_PRECONDITIONED) {
+      ksp->vec_sol = p[k];
+      ierr = KSPLogErrorHistory(ksp);CHKERRQ(ierr);
+    } else {
+      ierr = KSP_MatMult(ksp,Amat,p[k],r);CHKERRQ(ierr);          /*  r = b - Ap[k]    */
+      ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+      /* calculate residual norm if requested */
+      if (ksp->normtype) {
+        switch (ksp->normtype) {
+        case KSP_NORM_PRECONDITIONED:
+          ierr = KSP_PCApply(ksp,r,p[kp1]);CHKERRQ(ierr);             /*  p[kp1] = B^{-1}r  */
+          ierr = VecNorm(p[kp1],NORM_2,&rnorm);CHKERRQ(ierr);
+          break;
+        case KSP_NORM_UNPRECONDITIONED:
+        case KSP_NORM_NATURAL:
+          ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+          break;
+        default:
+          rnorm = 0.0;
+          break;
+        }
+        KSPCheckNorm(ksp,rnorm);
+        ierr         = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+        ksp->rnorm   = rnorm;
+        ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+        ierr = KSPLogResidualHistory(ksp,rnorm);CHKERRQ(ierr);
+        ierr = KSPMonitor(ksp,i,rnorm);CHKERRQ(ierr);
+        ierr = (*ksp->converged)(ksp,i,rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+        if (ksp->reason) break;
+        if (ksp->normtype != KSP_NORM_PRECONDITIONED) {
+          ierr = KSP_PCApply(ksp,r,p[kp1]);CHKERRQ(ierr);             /*  p[kp1] = B^{-1}r  */
+        }
+      } else {
         ierr = KSP_PCApply(ksp,r,p[kp1]);CHKERRQ(ierr);             /*  p[kp1] = B^{-1}r  */
       }
-    } else {
-      ierr = KSP_PCApply(ksp,r,p[kp1]);CHKERRQ(ierr);             /*  p[kp1] = B^{-1}r  */
-    }
-    ksp->vec_sol = p[k];
-    ierr = KSPLogErrorHistory(ksp);CHKERRQ(ierr);
+      ksp->vec_sol = p[k];
+      ierr = KSPLogErrorHistory(ksp);CHKERRQ(ierr);
 
-    c[kp1] = 2.0*mu*c[k] - c[km1];
-    omega  = omegaprod*c[k]/c[kp1];
+      c[kp1] = 2.0*mu*c[k] - c[km1];
+      omega  = omegaprod*c[k]/c[kp1];
 
-    /* y^{k+1} = omega(y^{k} - y^{k-1} + Gamma*r^{k}) + y^{k-1} */
-    ierr = VecAXPBYPCZ(p[kp1],1.0-omega,omega,omega*Gamma*scale,p[km1],p[k]);CHKERRQ(ierr);
+      /* y^{k+1} = omega(y^{k} - y^{k-1} + Gamma*r^{k}) + y^{k-1} */
+      ierr = VecAXPBYPCZ(p[kp1],1.0-omega,omega,omega*Gamma*scale,p[km1],p[k]);CHKERRQ(ierr);
+    }
 
     ktmp = km1;
     km1  = k;
@@ -568,6 +941,9 @@ static  PetscErrorCode KSPView_Chebyshev(KSP ksp,PetscViewer viewer)
       if (cheb->usenoisy) {
         ierr = PetscViewerASCIIPrintf(viewer,"  estimating eigenvalues using noisy right hand side\n");CHKERRQ(ierr);
       }
+      if (cheb->reusetol > 0.0) {
+        ierr = PetscViewerASCIIPrintf(viewer,"  reusing the estimates if the power iteration estimate changes less than %g\n",(double)cheb->reusetol);CHKERRQ(ierr);
+      }
     }
   }
   PetscFunctionReturn(0);
@@ -580,10 +956,15 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
 
   PetscFunctionBegin;
   ierr = KSPDestroy(&cheb->kspest);CHKERRQ(ierr);
+  ierr = VecDestroy(&cheb->vpow);CHKERRQ(ierr);
+  ierr = VecDestroy(&cheb->dinv);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetEigenvalues_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevGetEigenvalues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSet_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetUseNoisy_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigGetKSP_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetReuseTolerance_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetFused_C",NULL);CHKERRQ(ierr);
   ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -597,7 +978,9 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
 .   -ksp_chebyshev_esteig <a,b,c,d> - estimate eigenvalues using a Krylov method, then use this
                          transform for Chebyshev eigenvalue bounds (KSPChebyshevEstEigSet())
 .   -ksp_chebyshev_esteig_steps - number of estimation steps
--   -ksp_chebyshev_esteig_noisy - use noisy number generator to create right hand side for eigenvalue estimator
+.   -ksp_chebyshev_esteig_noisy - use noisy number generator to create right hand side for eigenvalue estimator
+.   -ksp_chebyshev_esteig_reuse_tol <rtol> - keep the eigenvalue estimates when the operator changes little (KSPChebyshevEstEigSetReuseTolerance())
+-   -ksp_chebyshev_fused <true,false> - fuse the residual, Jacobi scaling and update for AIJ matrices with PCJACOBI and PCPBJACOBI (KSPChebyshevSetFused())
 
    Level: beginner
 
@@ -610,8 +993,8 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
           The user should call KSPChebyshevSetEigenvalues() if they have eigenvalue estimates.
 
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP,
-           KSPChebyshevSetEigenvalues(), KSPChebyshevEstEigSet(), KSPChebyshevEstEigSetUseNoisy()
-           KSPRICHARDSON, KSPCG, PCMG
+           KSPChebyshevSetEigenvalues(), KSPChebyshevGetEigenvalues(), KSPChebyshevEstEigSet(), KSPChebyshevEstEigSetUseNoisy(),
+           KSPChebyshevEstEigSetReuseTolerance(), KSPChebyshevSetFused(), KSPRICHARDSON, KSPCG, PCMG
 
 M*/
 
@@ -638,6 +1021,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
   chebyshevP->tform[3] = 1.1;
   chebyshevP->eststeps = 10;
   chebyshevP->usenoisy = PETSC_TRUE;
+  chebyshevP->usefused = PETSC_FALSE;
   ksp->setupnewmatrix = PETSC_TRUE;
 
   ksp->ops->setup          = KSPSetUp_Chebyshev;
@@ -650,8 +1034,11 @@ PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
   ksp->ops->reset          = KSPReset_Chebyshev;
 
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetEigenvalues_C",KSPChebyshevSetEigenvalues_Chebyshev);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevGetEigenvalues_C",KSPChebyshevGetEigenvalues_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSet_C",KSPChebyshevEstEigSet_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetUseNoisy_C",KSPChebyshevEstEigSetUseNoisy_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigGetKSP_C",KSPChebyshevEstEigGetKSP_Chebyshev);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetReuseTolerance_C",KSPChebyshevEstEigSetReuseTolerance_Chebyshev);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetFused_C",KSPChebyshevSetFused_Chebyshev);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -17,6 +17,15 @@ typedef struct {
   /* For tracking when to update the eigenvalue estimates */
   PetscObjectId    amatid,    pmatid;
   PetscObjectState amatstate, pmatstate;
+  /* For reusing the eigenvalue estimates when the operator changes little */
+  PetscReal        reusetol;     /* largest relative change of the power iteration estimate that keeps the estimates */
+  Vec              vpow;         /* approximate dominant eigenvector of the preconditioned operator */
+  PetscReal        lambdapow;    /* power iteration estimate of the largest eigenvalue obtained with vpow */
+  /* For the fused residual, Jacobi scaling and update kernel */
+  PetscBool        usefused;
+  Vec              dinv;         /* inverse diagonal applied by PCJACOBI */
+  PetscObjectId    dinvid;
+  PetscObjectState dinvstate;
 } KSP_Chebyshev;
 
 #endif
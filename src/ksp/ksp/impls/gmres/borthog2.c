@@ -25,6 +25,8 @@
 
     Notes:
     Use KSPGMRESSetCGSRefinementType() to determine if iterative refinement is to be used.
+    With KSPSetBatchReductions() and refine_ifneeded the norm used in the refinement test is obtained from the same
+    reduction as the inner products.
     This is much faster than KSPGMRESModifiedGramSchmidtOrthogonalization() but has the small possibility of stability issues
     that can usually be handled by using a a single step of iterative refinement with KSPGMRESSetCGSRefinementType()
 
@@ -40,8 +42,9 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
   PetscErrorCode ierr;
   PetscInt       j;
   PetscScalar    *hh,*hes,*lhh;
-  PetscReal      hnrm, wnrm;
+  PetscReal      hnrm, wnrm, vnrm = 0.0;
   PetscBool      refine = (PetscBool)(gmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS);
+  PetscBool      batched = (PetscBool)(ksp->batchreductions && gmres->cgstype == KSP_GMRES_CGS_REFINE_IFNEEDED);
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
@@ -64,7 +67,18 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
      This is really a matrix-vector product, with the matrix stored
      as pointer to rows
   */
-  ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  if (batched) {
+    /* compute the norm of vnew in the same reduction so the refinement test needs no additional reduction */
+    ierr = VecMDotBegin(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+    ierr = VecNormBegin(VEC_VV(it+1),NORM_2,&vnrm);CHKERRQ(ierr);
+    ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(it+1)));CHKERRQ(ierr);
+    ierr = VecMDotEnd(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr);
+    ierr = VecNormEnd(VEC_VV(it+1),NORM_2,&vnrm);CHKERRQ(ierr);
+    KSPCheckNorm(ksp,vnrm);
+    if (ksp->reason) goto done;
+  } else {
+    ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  }
   for (j=0; j<=it; j++) {
     KSPCheckDot(ksp,lhh[j]);
     if (ksp->reason) goto done;
@@ -90,10 +104,16 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
     hnrm = 0.0;
     for (j=0; j<=it; j++) hnrm +=  PetscRealPart(lhh[j] * PetscConj(lhh[j]));
 
-    hnrm = PetscSqrtReal(hnrm);
-    ierr = VecNorm(VEC_VV(it+1),NORM_2, &wnrm);CHKERRQ(ierr);
-    KSPCheckNorm(ksp,wnrm);
-    if (ksp->reason) goto done;
+    if (batched) {
+      /* the basis is orthonormal so ||vnew - V h||^2 = ||vnew||^2 - ||h||^2; cancellation in this estimate only errs toward refining */
+      wnrm = PetscSqrtReal(PetscMax(vnrm*vnrm - hnrm,0.0));
+      hnrm = PetscSqrtReal(hnrm);
+    } else {
+      hnrm = PetscSqrtReal(hnrm);
+      ierr = VecNorm(VEC_VV(it+1),NORM_2, &wnrm);CHKERRQ(ierr);
+      KSPCheckNorm(ksp,wnrm);
+      if (ksp->reason) goto done;
+    }
     if (wnrm < hnrm) {
       refine = PETSC_TRUE;
       ierr   = PetscInfo2(ksp,"Performing iterative refinement wnorm %g hnorm %g\n",(double)wnrm,(double)hnrm);CHKERRQ(ierr);
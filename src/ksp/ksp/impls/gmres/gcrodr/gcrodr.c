@@ -0,0 +1,870 @@
+
+/*
+    GCRO-DR: GMRES with deflated restarting that keeps the deflation space across solves
+*/
+#include <petsc/private/kspimpl.h>              /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+typedef struct {
+  PetscInt         m;               /* dimension of the search space of a cycle, recycled vectors included */
+  PetscInt         k;               /* maximum number of recycled vectors */
+  PetscInt         nk;              /* number of recycled vectors currently in U and C */
+  Vec              *U,*C;           /* recycled space and its image by the operator, C is orthonormal and Op U = C */
+  Vec              *Un,*Cn;         /* space for the next U and C */
+  Vec              *V;              /* Arnoldi vectors, m+1 */
+  Vec              *W,*Z;           /* arrays of pointers [C V] and [U V], no vectors are allocated */
+  Vec              sol_temp,tmp;
+  PetscScalar      *G;              /* (m+1) x m matrix such that Op [U D, V_p] = [C, V_{p+1}] G, leading dimension m+1 */
+  PetscScalar      *Gw,*B,*y,*h,*P,*GP,*R,*tau,*vr,*work;
+  PetscReal        *d;              /* D = diag(1/||u_i||), improves the conditioning of G */
+  PetscReal        *wr,*wi,*mu,*rwork;
+  PetscInt         *perm;
+  PetscBLASInt     lwork;
+  PetscInt         it;              /* number of Arnoldi steps of the current cycle, the current correction is [U D, V_it] y */
+  PetscBool        valid;           /* C = Op U for the operators below */
+  PetscObjectId    Aid,Pid;
+  PetscObjectState Astate,Pstate;
+  PetscInt         mmax,kmax;       /* largest restart and number of recycled vectors, the arrays are allocated for these */
+  PetscInt         mc,kc;           /* restart and number of recycled vectors of the next cycle */
+  PetscBool        adaptive;        /* choose mc and kc after each cycle */
+  PetscInt         budget;          /* maximum number of vectors of the adaptive method */
+  PetscInt         mmin,dir,dm;     /* smallest restart, direction and size of the last change of the restart */
+  PetscReal        eprev;           /* residual reduction per unit of work of the previous cycle, in log scale */
+  PetscReal        wop;             /* estimated flops per vector entry of one application of the operator and the preconditioner */
+} KSP_GCRODR;
+
+static PetscErrorCode KSPSetUp_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       m = gcrodr->m,k = gcrodr->k,budget;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (k >= m) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"The number of recycled vectors %D must be smaller than the restart %D",k,m);
+  if (ksp->pc_side == PC_SYMMETRIC) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"No symmetric preconditioning for KSPGCRODR");
+  if (gcrodr->adaptive) {
+    /* each recycled vector costs 4 vectors, U, C and the space for their update; the recycled space is kept below a third of the restart */
+    budget       = gcrodr->budget == PETSC_DEFAULT ? m+1+4*k : gcrodr->budget;
+    gcrodr->mmin = PetscMin(m,5);
+    k            = PetscMin(k,(budget-1)/7);
+    m            = budget-1-4*k;
+    if (m < gcrodr->mmin) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"A memory budget of %D vectors is too small for KSPGCRODR, at least %D are needed",budget,gcrodr->mmin+1);
+    gcrodr->mc    = PetscMin(gcrodr->m,m);
+    gcrodr->kc    = PetscMin(k,(gcrodr->mc*gcrodr->k)/gcrodr->m);
+    gcrodr->dir   = -1;
+    gcrodr->dm    = PetscMax(1,m/4);
+    gcrodr->eprev = 0.0;
+  } else {
+    gcrodr->mc = m;
+    gcrodr->kc = k;
+  }
+  gcrodr->mmax = m;
+  gcrodr->kmax = k;
+  ierr = KSPSetWorkVecs(ksp,4);CHKERRQ(ierr);
+  /* the Arnoldi vectors are created when a cycle first needs them */
+  ierr = PetscCalloc1(m+1,&gcrodr->V);CHKERRQ(ierr);
+  if (k) {
+    ierr = KSPCreateVecs(ksp,k,&gcrodr->U,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&gcrodr->C,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&gcrodr->Un,0,NULL);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&gcrodr->Cn,0,NULL);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->U);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->C);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->Un);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->Cn);CHKERRQ(ierr);
+  }
+  ierr = VecDuplicate(ksp->work[0],&gcrodr->tmp);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)gcrodr->tmp);CHKERRQ(ierr);
+  gcrodr->lwork = (PetscBLASInt)(64*(m+1)+(m+1)*(m+1));
+  ierr = PetscMalloc7((m+1)*m,&gcrodr->G,(m+1)*m,&gcrodr->Gw,(m+1)*m,&gcrodr->B,m+1,&gcrodr->y,m+1,&gcrodr->h,m*m,&gcrodr->vr,gcrodr->lwork,&gcrodr->work);CHKERRQ(ierr);
+  ierr = PetscMalloc4(m*k,&gcrodr->P,(m+1)*k,&gcrodr->GP,k*k,&gcrodr->R,k,&gcrodr->tau);CHKERRQ(ierr);
+  ierr = PetscMalloc6(k,&gcrodr->d,m,&gcrodr->wr,m,&gcrodr->wi,m,&gcrodr->mu,2*m,&gcrodr->rwork,m,&gcrodr->perm);CHKERRQ(ierr);
+  ierr = PetscMalloc2(k+m+1,&gcrodr->W,k+m,&gcrodr->Z);CHKERRQ(ierr);
+  gcrodr->nk    = 0;
+  gcrodr->it    = 0;
+  gcrodr->valid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/* creates the Arnoldi vectors V[0..n-1] that do not exist yet */
+static PetscErrorCode KSPGCRODRGetVecs_Private(KSP ksp,PetscInt n)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    if (gcrodr->V[i]) continue;
+    ierr = VecDuplicate(ksp->work[0],&gcrodr->V[i]);CHKERRQ(ierr);
+    ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)gcrodr->V[i]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* y <- Op x, with Op = B A (left preconditioning) or A B (right preconditioning) */
+static PetscErrorCode KSPGCRODRApply_Private(KSP ksp,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSP_PCApplyBAorAB(ksp,x,y,ksp->work[2]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Makes C = Op U hold for the current operators: when the operators have changed since C was computed, C is recomputed and
+   orthonormalized with a Cholesky QR, C = Q R, and U is replaced by U R^{-1}. This costs nk applications of the operator per
+   solve, the harmonic Ritz vectors of the previous systems then deflate the new one.
+*/
+static PetscErrorCode KSPGCRODRRefreshImage_Private(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       i,j,nk = gcrodr->nk;
+  PetscScalar    *R = gcrodr->R,sone = 1.0;
+  PetscBLASInt   bnk,info;
+  Mat            A,P;
+  Vec            *swap;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&A,&P);CHKERRQ(ierr);
+  if (gcrodr->valid && gcrodr->Aid == ((PetscObject)A)->id && gcrodr->Astate == ((PetscObject)A)->state && gcrodr->Pid == ((PetscObject)P)->id && gcrodr->Pstate == ((PetscObject)P)->state) PetscFunctionReturn(0);
+  gcrodr->Aid    = ((PetscObject)A)->id;
+  gcrodr->Astate = ((PetscObject)A)->state;
+  gcrodr->Pid    = ((PetscObject)P)->id;
+  gcrodr->Pstate = ((PetscObject)P)->state;
+  gcrodr->valid  = PETSC_TRUE;
+  if (gcrodr->adaptive) {
+    MatInfo   info;
+    PetscInt  N;
+    PetscBool has;
+
+    /* the preconditioner is assumed to cost as much as the operator; the estimate is the same on all the processes */
+    gcrodr->wop = 40.0;
+    ierr = MatGetSize(A,&N,NULL);CHKERRQ(ierr);
+    ierr = MatHasOperation(A,MATOP_GETINFO,&has);CHKERRQ(ierr);
+    if (has && N) {
+      ierr = MatGetInfo(A,MAT_GLOBAL_SUM,&info);CHKERRQ(ierr);
+      gcrodr->wop = 4.0*info.nz_used/N;
+    }
+  }
+  if (!nk) PetscFunctionReturn(0);
+  for (i=0; i<nk; i++) {ierr = KSPGCRODRApply_Private(ksp,gcrodr->U[i],gcrodr->C[i]);CHKERRQ(ierr);}
+  ierr = PetscArrayzero(R,nk*nk);CHKERRQ(ierr);
+  for (j=0; j<nk; j++) {ierr = VecMDot(gcrodr->C[j],j+1,gcrodr->C,R+j*nk);CHKERRQ(ierr);}
+  ierr = PetscBLASIntCast(nk,&bnk);CHKERRQ(ierr);
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bnk,R,&bnk,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) {
+    ierr = PetscInfo1(ksp,"The image of the recycled space is rank deficient (potrf info %d), the recycled space is discarded\n",(int)info);CHKERRQ(ierr);
+    gcrodr->nk = 0;
+    PetscFunctionReturn(0);
+  }
+  /* columns of R^{-1} in B, then C <- C R^{-1} and U <- U R^{-1} */
+  ierr = PetscArrayzero(gcrodr->B,nk*nk);CHKERRQ(ierr);
+  for (i=0; i<nk; i++) gcrodr->B[i*(nk+1)] = 1.0;
+  PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","U","N","N",&bnk,&bnk,&sone,R,&bnk,gcrodr->B,&bnk));
+  for (j=0; j<nk; j++) {
+    ierr = VecSet(gcrodr->Cn[j],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(gcrodr->Cn[j],j+1,gcrodr->B+j*nk,gcrodr->C);CHKERRQ(ierr);
+    ierr = VecSet(gcrodr->Un[j],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(gcrodr->Un[j],j+1,gcrodr->B+j*nk,gcrodr->U);CHKERRQ(ierr);
+  }
+  swap = gcrodr->C; gcrodr->C = gcrodr->Cn; gcrodr->Cn = swap;
+  swap = gcrodr->U; gcrodr->U = gcrodr->Un; gcrodr->Un = swap;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Replaces U and C with the harmonic Ritz vectors of Op with respect to the space [U D, V_p] of the last cycle, associated with
+   the harmonic Ritz values of smallest magnitude. These solve G^H G z = theta G^H [C V_{p+1}]^H [U D V_p] z, computed here as the
+   eigenvectors of largest eigenvalues mu = 1/theta of M = G^+ [C V_{p+1}]^H [U D V_p].
+*/
+static PetscErrorCode KSPGCRODRRecycle_Private(KSP ksp,PetscInt p)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       i,j,c,nk = gcrodr->nk,q = nk+p,kk = PetscMin(gcrodr->kc,q),ld = gcrodr->mmax+1,cnt;
+  PetscScalar    *G = gcrodr->G,*Gw = gcrodr->Gw,*B = gcrodr->B,*P = gcrodr->P,*GP = gcrodr->GP,*R = gcrodr->R,*vr = gcrodr->vr;
+  PetscScalar    sone = 1.0,szero = 0.0;
+  PetscReal      *mu = gcrodr->mu;
+  PetscBLASInt   bq,bq1,bkk,bld,info;
+  Vec            *swap;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(q,&bq);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(q+1,&bq1);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ld,&bld);CHKERRQ(ierr);
+  /* B = [C V_{p+1}]^H [U D V_p] = [C^H U D, 0; V_{p+1}^H U D, I_{p+1,p}] */
+  ierr = PetscArrayzero(B,ld*q);CHKERRQ(ierr);
+  for (j=0; j<nk; j++) {
+    ierr = VecMDot(gcrodr->U[j],q+1,gcrodr->W,B+j*ld);CHKERRQ(ierr);
+    for (i=0; i<q+1; i++) B[i+j*ld] *= gcrodr->d[j];
+  }
+  for (j=nk; j<q; j++) B[j+j*ld] = 1.0;
+  /* M = G^+ B, in the first q rows of B */
+  for (j=0; j<q; j++) {ierr = PetscArraycpy(Gw+j*ld,G+j*ld,q+1);CHKERRQ(ierr);}
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgels",LAPACKgels_("N",&bq1,&bq,&bq,Gw,&bld,B,&bld,gcrodr->work,&gcrodr->lwork,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine xGELS %d",(int)info);
+  for (j=0; j<q; j++) {ierr = PetscArraycpy(Gw+j*q,B+j*ld,q);CHKERRQ(ierr);}
+#if !defined(PETSC_USE_COMPLEX)
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","V",&bq,Gw,&bq,gcrodr->wr,gcrodr->wi,NULL,&bq,vr,&bq,gcrodr->work,&gcrodr->lwork,&info));
+  for (i=0; i<q; i++) mu[i] = -PetscSqrtReal(gcrodr->wr[i]*gcrodr->wr[i]+gcrodr->wi[i]*gcrodr->wi[i]);
+#else
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","V",&bq,Gw,&bq,B,NULL,&bq,vr,&bq,gcrodr->work,&gcrodr->lwork,gcrodr->rwork,&info));
+  for (i=0; i<q; i++) mu[i] = -PetscAbsScalar(B[i]);
+#endif
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine xGEEV %d",(int)info);
+  for (i=0; i<q; i++) gcrodr->perm[i] = i;
+  ierr = PetscSortRealWithPermutation(q,mu,gcrodr->perm);CHKERRQ(ierr);
+  /* P = the selected eigenvectors, a complex conjugate pair contributes its real and imaginary parts and is dropped if only one slot is left */
+  for (c=0,cnt=0; c<q && cnt<kk; c++) {
+    i = gcrodr->perm[c];
+#if !defined(PETSC_USE_COMPLEX)
+    if (gcrodr->wi[i] < 0.0) continue;
+    if (gcrodr->wi[i] > 0.0) {
+      if (cnt+2 > kk) continue;
+      ierr = PetscArraycpy(P+cnt*q,vr+i*q,2*q);CHKERRQ(ierr);
+      cnt += 2;
+      continue;
+    }
+#endif
+    ierr = PetscArraycpy(P+cnt*q,vr+i*q,q);CHKERRQ(ierr);
+    cnt++;
+  }
+  kk   = cnt;
+  if (!kk) PetscFunctionReturn(0);
+  ierr = PetscBLASIntCast(kk,&bkk);CHKERRQ(ierr);
+  /* G P = Q R */
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bq1,&bkk,&bq,&sone,G,&bld,P,&bq,&szero,GP,&bq1));
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgeqrf",LAPACKgeqrf_(&bq1,&bkk,GP,&bq1,gcrodr->tau,gcrodr->work,&gcrodr->lwork,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine xGEQRF %d",(int)info);
+  ierr = PetscArrayzero(R,kk*kk);CHKERRQ(ierr);
+  for (j=0; j<kk; j++) for (i=0; i<=j; i++) R[i+j*kk] = GP[i+j*(q+1)];
+  for (j=0; j<kk; j++) if (PetscAbsScalar(R[j+j*kk]) == 0.0) break;
+  if (j < kk) {
+    ierr = PetscInfo2(ksp,"Harmonic Ritz vectors are linearly dependent, %D instead of %D vectors are recycled\n",j,kk);CHKERRQ(ierr);
+    kk   = j;
+    ierr = PetscBLASIntCast(kk,&bkk);CHKERRQ(ierr);
+    for (j=0; j<kk; j++) for (i=0; i<=j; i++) R[i+j*kk] = GP[i+j*(q+1)];
+  }
+  if (!kk) {ierr = PetscFPTrapPop();CHKERRQ(ierr); gcrodr->nk = 0; PetscFunctionReturn(0);}
+  PetscStackCallBLAS("LAPACKorgqr",LAPACKorgqr_(&bq1,&bkk,&bkk,GP,&bq1,gcrodr->tau,gcrodr->work,&gcrodr->lwork,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine xORGQR %d",(int)info);
+  /* C <- [C V_{p+1}] Q and U <- [U D V_p] P R^{-1}, so that Op U = C still holds */
+  PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","U","N","N",&bq,&bkk,&sone,R,&bkk,P,&bq));
+  for (j=0; j<kk; j++) {
+    for (i=0; i<nk; i++) P[i+j*q] *= gcrodr->d[i];
+    ierr = VecSet(gcrodr->Cn[j],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(gcrodr->Cn[j],q+1,GP+j*(q+1),gcrodr->W);CHKERRQ(ierr);
+    ierr = VecSet(gcrodr->Un[j],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(gcrodr->Un[j],q,P+j*q,gcrodr->Z);CHKERRQ(ierr);
+  }
+  swap = gcrodr->C; gcrodr->C = gcrodr->Cn; gcrodr->Cn = swap;
+  swap = gcrodr->U; gcrodr->U = gcrodr->Un; gcrodr->Un = swap;
+  gcrodr->nk = kk;
+  PetscFunctionReturn(0);
+}
+
+/*
+   One cycle: Arnoldi of (I - C C^H) Op started from r/||r||, which is orthogonal to C, the correction minimizes the residual over
+   [U V_p]; the residual is updated without applying the operator since it lies in [C V_{p+1}]
+*/
+static PetscErrorCode KSPGCRODRCycle_Private(KSP ksp,Vec r,Vec dx)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       i,j,nk = gcrodr->nk,ld = gcrodr->mmax+1,p,steps = gcrodr->mc-nk,n;
+  PetscScalar    *G = gcrodr->G,*Gw = gcrodr->Gw,*y = gcrodr->y,*h = gcrodr->h;
+  PetscReal      beta,hnorm,rnorm;
+  PetscBLASInt   bn,bn1,bld,one = 1,info;
+  PetscBool      breakdown = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPGCRODRGetVecs_Private(ksp,steps+1);CHKERRQ(ierr);
+  for (i=0; i<nk; i++) gcrodr->W[i] = gcrodr->C[i];
+  for (i=0; i<=steps; i++) gcrodr->W[nk+i] = gcrodr->V[i];
+  for (i=0; i<nk; i++) gcrodr->Z[i] = gcrodr->U[i];
+  for (i=0; i<steps; i++) gcrodr->Z[nk+i] = gcrodr->V[i];
+  ierr = PetscArrayzero(G,ld*gcrodr->mc);CHKERRQ(ierr);
+  for (i=0; i<nk; i++) {ierr = VecNormBegin(gcrodr->U[i],NORM_2,gcrodr->d+i);CHKERRQ(ierr);}
+  for (i=0; i<nk; i++) {
+    ierr = VecNormEnd(gcrodr->U[i],NORM_2,gcrodr->d+i);CHKERRQ(ierr);
+    gcrodr->d[i] = 1.0/gcrodr->d[i];
+    G[i+i*ld]    = gcrodr->d[i];
+  }
+  ierr = VecCopy(r,gcrodr->V[0]);CHKERRQ(ierr);
+  ierr = VecNormalize(gcrodr->V[0],&beta);CHKERRQ(ierr);
+  for (p=0; p<steps; ) {
+    ierr = KSPGCRODRApply_Private(ksp,gcrodr->V[p],gcrodr->V[p+1]);CHKERRQ(ierr);
+    /* classical Gram-Schmidt against [C V_p], twice */
+    for (j=0; j<2; j++) {
+      ierr = VecMDot(gcrodr->V[p+1],nk+p+1,gcrodr->W,h);CHKERRQ(ierr);
+      for (i=0; i<nk+p+1; i++) {
+        G[i+(nk+p)*ld] += h[i];
+        h[i]            = -h[i];
+      }
+      ierr = VecMAXPY(gcrodr->V[p+1],nk+p+1,h,gcrodr->W);CHKERRQ(ierr);
+    }
+    ierr = VecNorm(gcrodr->V[p+1],NORM_2,&hnorm);CHKERRQ(ierr);
+    KSPCheckNorm(ksp,hnorm);
+    if (hnorm <= 10.0*PETSC_MACHINE_EPSILON*beta) {
+      ierr      = PetscInfo2(ksp,"Happy breakdown at step %D, norm of the new Arnoldi vector %g\n",p,(double)hnorm);CHKERRQ(ierr);
+      breakdown = PETSC_TRUE;
+      hnorm     = 0.0;
+      ierr      = VecSet(gcrodr->V[p+1],0.0);CHKERRQ(ierr);
+    } else {
+      ierr = VecScale(gcrodr->V[p+1],1.0/hnorm);CHKERRQ(ierr);
+    }
+    G[nk+p+1+(nk+p)*ld] = hnorm;
+    p++;
+
+    /* min || beta e_{nk} - G y ||, the last entry of the solution of the least squares problem gives the residual norm */
+    n    = nk+p;
+    for (j=0; j<n; j++) {ierr = PetscArraycpy(Gw+j*ld,G+j*ld,n+1);CHKERRQ(ierr);}
+    ierr = PetscArrayzero(y,n+1);CHKERRQ(ierr);
+    y[nk] = beta;
+    ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(n+1,&bn1);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(ld,&bld);CHKERRQ(ierr);
+    ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+    PetscStackCallBLAS("LAPACKgels",LAPACKgels_("N",&bn1,&bn,&one,Gw,&bld,y,&bn1,gcrodr->work,&gcrodr->lwork,&info));
+    ierr = PetscFPTrapPop();CHKERRQ(ierr);
+    if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine xGELS %d",(int)info);
+    rnorm = PetscAbsScalar(y[n]);
+    gcrodr->it = p;
+
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->its++;
+    ksp->rnorm = ksp->normtype != KSP_NORM_NONE ? rnorm : 0.0;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ierr = KSPLogResidualHistory(ksp,ksp->rnorm);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,ksp->rnorm);CHKERRQ(ierr);
+    ierr = (*ksp->converged)(ksp,ksp->its,ksp->rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+    if (ksp->reason || breakdown) break;
+    if (ksp->its >= ksp->max_it) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+  }
+
+  /* dx <- dx + [U D V_p] y, r <- [C V_{p+1}] (beta e_{nk} - G y) */
+  n = nk+p;
+  for (i=0; i<nk; i++) h[i] = y[i]*gcrodr->d[i];
+  for (i=nk; i<n; i++) h[i] = y[i];
+  ierr = VecMAXPY(dx,n,h,gcrodr->Z);CHKERRQ(ierr);
+  ierr = PetscArrayzero(h,n+1);CHKERRQ(ierr);
+  h[nk] = beta;
+  for (j=0; j<n; j++) for (i=0; i<=PetscMin(j+1,n); i++) h[i] -= G[i+j*ld]*y[j];
+  ierr = VecSet(r,0.0);CHKERRQ(ierr);
+  ierr = VecMAXPY(r,n+1,h,gcrodr->W);CHKERRQ(ierr);
+  gcrodr->it = 0;
+  if (gcrodr->kc) {ierr = KSPGCRODRRecycle_Private(ksp,p);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+   Work of a cycle of p Arnoldi steps that started with nk recycled vectors, in flops per vector entry: p applications of the
+   operator and preconditioner, the two passes of classical Gram-Schmidt against [C V_j], and the update of the recycled space
+   (B = [C V_{p+1}]^H U D and the new U and C) when vectors are recycled
+*/
+static PetscReal KSPGCRODRCycleCost_Private(KSP_GCRODR *gcrodr,PetscInt nk,PetscInt p)
+{
+  PetscReal cost = p*gcrodr->wop + 2.0*nk;
+  PetscInt  j,q = nk+p;
+
+  for (j=0; j<p; j++) cost += 8.0*(nk+j+1) + 3.0;
+  if (gcrodr->kc) cost += 2.0*nk*(q+1) + 4.0*PetscMin(gcrodr->kc,q)*q;
+  return cost;
+}
+
+/*
+   Chooses the restart of the next cycle from the residual reduction of the last one, with ratio = ||r_end||/||r_start||, and its
+   cost from KSPGCRODRCycleCost_Private(). The restart climbs towards the largest reduction per unit of work and jumps to the
+   largest one the memory budget allows when a cycle stagnates. The cost model only depends on the sizes of the cycle and the
+   number of nonzeros of the operator, so all the processes make the same choice and the iterations are reproducible.
+   The number of recycled vectors follows the restart in the proportion given with KSPGCRODRSetRecycleSize() and
+   KSPGCRODRSetRestart(); the recycled vectors are ordered so that dropping the last ones keeps Op U = C.
+*/
+static PetscErrorCode KSPGCRODRAdapt_Private(KSP ksp,PetscReal ratio,PetscReal cost)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscReal      e;
+  PetscInt       mc = gcrodr->mc;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ratio > 0.99) {
+    gcrodr->mc    = gcrodr->mmax;
+    gcrodr->dir   = -1;
+    gcrodr->dm    = PetscMax(1,gcrodr->mmax/4);
+    gcrodr->eprev = 0.0;
+  } else if (ratio > 0.0 && cost > 0.0) {
+    e = -PetscLogReal(ratio)/cost;
+    if (e < gcrodr->eprev) {
+      gcrodr->dir = -gcrodr->dir;
+      gcrodr->dm  = PetscMax(1,gcrodr->dm/2);
+    }
+    gcrodr->eprev = e;
+    gcrodr->mc    = PetscMin(PetscMax(mc+gcrodr->dir*gcrodr->dm,gcrodr->mmin),gcrodr->mmax);
+  }
+  gcrodr->kc = PetscMin(gcrodr->kmax,(gcrodr->mc*gcrodr->k)/gcrodr->m);
+  gcrodr->nk = PetscMin(gcrodr->nk,gcrodr->kc);
+  if (gcrodr->mc != mc) {ierr = PetscInfo5(ksp,"Cycle reduced the residual by %g for %g flops per entry, restart %D -> %D with %D recycled vectors\n",(double)ratio,(double)cost,mc,gcrodr->mc,gcrodr->kc);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  Vec            x,b,r,dx;
+  PetscInt       i,nk,its0;
+  PetscReal      rnorm,rnorm0;
+  PetscScalar    *h = gcrodr->h;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ksp->transpose_solve) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPSolveTranspose() is not supported by KSPGCRODR");
+  x    = ksp->vec_sol;
+  b    = ksp->vec_rhs;
+  r    = ksp->work[0];
+  dx   = ksp->work[3];
+  ierr = KSPInitialResidual(ksp,x,ksp->work[1],ksp->work[2],r,b);CHKERRQ(ierr);
+  ierr = VecSet(dx,0.0);CHKERRQ(ierr);
+  gcrodr->it = 0;
+
+  /* project out the recycled space: dx <- U C^H r, r <- r - C C^H r */
+  ierr = KSPGCRODRRefreshImage_Private(ksp);CHKERRQ(ierr);
+  nk   = gcrodr->nk;
+  if (nk) {
+    ierr = VecMDot(r,nk,gcrodr->C,h);CHKERRQ(ierr);
+    ierr = VecMAXPY(dx,nk,h,gcrodr->U);CHKERRQ(ierr);
+    for (i=0; i<nk; i++) h[i] = -h[i];
+    ierr = VecMAXPY(r,nk,h,gcrodr->C);CHKERRQ(ierr);
+  }
+  ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,rnorm);
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its   = 0;
+  ksp->rnorm = ksp->normtype != KSP_NORM_NONE ? rnorm : 0.0;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,ksp->rnorm);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,0,ksp->rnorm);CHKERRQ(ierr);
+  ierr = (*ksp->converged)(ksp,0,ksp->rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  while (!ksp->reason && rnorm > 0.0) {
+    if (ksp->its >= ksp->max_it) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    rnorm0 = rnorm;
+    nk     = gcrodr->nk;
+    its0   = ksp->its;
+    ierr   = KSPGCRODRCycle_Private(ksp,r,dx);CHKERRQ(ierr);
+    ierr   = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+    if (gcrodr->adaptive) {ierr = KSPGCRODRAdapt_Private(ksp,rnorm/rnorm0,KSPGCRODRCycleCost_Private(gcrodr,nk,ksp->its-its0));CHKERRQ(ierr);}
+  }
+  if (!ksp->reason) ksp->reason = KSP_CONVERGED_ATOL;
+
+  /* x <- x + dx, with the preconditioner applied to dx for right preconditioning */
+  ierr = KSPUnwindPreconditioner(ksp,dx,gcrodr->tmp);CHKERRQ(ierr);
+  ierr = VecAXPY(x,1.0,dx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBuildSolution_GCRODR(KSP ksp,Vec ptr,Vec *result)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       i,nk = gcrodr->nk,n = gcrodr->nk+gcrodr->it;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!gcrodr->sol_temp) {
+      ierr = VecDuplicate(ksp->vec_sol,&gcrodr->sol_temp);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)gcrodr->sol_temp);CHKERRQ(ierr);
+    }
+    ptr = gcrodr->sol_temp;
+  }
+  /* the correction of the completed cycles plus the one of the current cycle */
+  ierr = VecCopy(ksp->work[3],ptr);CHKERRQ(ierr);
+  if (gcrodr->it) {
+    for (i=0; i<n; i++) gcrodr->h[i] = i < nk ? gcrodr->y[i]*gcrodr->d[i] : gcrodr->y[i];
+    ierr = VecMAXPY(ptr,n,gcrodr->h,gcrodr->Z);CHKERRQ(ierr);
+  }
+  ierr = KSPUnwindPreconditioner(ksp,ptr,gcrodr->tmp);CHKERRQ(ierr);
+  ierr = VecAXPY(ptr,1.0,ksp->vec_sol);CHKERRQ(ierr);
+  if (result) *result = ptr;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (gcrodr->V) {
+    for (i=0; i<=gcrodr->mmax; i++) {ierr = VecDestroy(&gcrodr->V[i]);CHKERRQ(ierr);}
+    ierr = PetscFree(gcrodr->V);CHKERRQ(ierr);
+  }
+  ierr = VecDestroyVecs(gcrodr->kmax,&gcrodr->U);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->kmax,&gcrodr->C);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->kmax,&gcrodr->Un);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->kmax,&gcrodr->Cn);CHKERRQ(ierr);
+  ierr = VecDestroy(&gcrodr->sol_temp);CHKERRQ(ierr);
+  ierr = VecDestroy(&gcrodr->tmp);CHKERRQ(ierr);
+  ierr = PetscFree7(gcrodr->G,gcrodr->Gw,gcrodr->B,gcrodr->y,gcrodr->h,gcrodr->vr,gcrodr->work);CHKERRQ(ierr);
+  ierr = PetscFree4(gcrodr->P,gcrodr->GP,gcrodr->R,gcrodr->tau);CHKERRQ(ierr);
+  ierr = PetscFree6(gcrodr->d,gcrodr->wr,gcrodr->wi,gcrodr->mu,gcrodr->rwork,gcrodr->perm);CHKERRQ(ierr);
+  ierr = PetscFree2(gcrodr->W,gcrodr->Z);CHKERRQ(ierr);
+  gcrodr->nk    = 0;
+  gcrodr->valid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_GCRODR(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_GCRODR(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRestart_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRecycleSize_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRGetRecycleSize_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetAdaptiveRestart_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetMemoryBudget_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_GCRODR(KSP ksp,PetscViewer viewer)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscBool      iascii;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, recycled vectors=%D (currently %D)\n",gcrodr->m,gcrodr->k,gcrodr->nk);CHKERRQ(ierr);
+    if (gcrodr->adaptive) {
+      if (gcrodr->budget == PETSC_DEFAULT) {ierr = PetscViewerASCIIPrintf(viewer,"  adaptive restart, memory budget of the restart above\n");CHKERRQ(ierr);}
+      else {ierr = PetscViewerASCIIPrintf(viewer,"  adaptive restart, memory budget %D vectors\n",gcrodr->budget);CHKERRQ(ierr);}
+      if (gcrodr->mmax) {ierr = PetscViewerASCIIPrintf(viewer,"  next cycle: restart=%D in [%D,%D], recycled vectors=%D\n",gcrodr->mc,gcrodr->mmin,gcrodr->mmax,gcrodr->kc);CHKERRQ(ierr);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_GCRODR(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       m = gcrodr->m,k = gcrodr->k,budget = gcrodr->budget;
+  PetscBool      flg,adaptive = gcrodr->adaptive;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP GCRODR options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_gcrodr_restart","Dimension of the search space of a cycle","KSPGCRODRSetRestart",m,&m,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGCRODRSetRestart(ksp,m);CHKERRQ(ierr);}
+  ierr = PetscOptionsInt("-ksp_gcrodr_recycle","Number of vectors kept across cycles and solves","KSPGCRODRSetRecycleSize",k,&k,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGCRODRSetRecycleSize(ksp,k);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-ksp_gcrodr_adaptive","Choose the restart and the number of recycled vectors after each cycle","KSPGCRODRSetAdaptiveRestart",adaptive,&adaptive,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGCRODRSetAdaptiveRestart(ksp,adaptive);CHKERRQ(ierr);}
+  ierr = PetscOptionsInt("-ksp_gcrodr_memory_budget","Maximum number of vectors of the adaptive restart","KSPGCRODRSetMemoryBudget",budget,&budget,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGCRODRSetMemoryBudget(ksp,budget);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRSetRestart_GCRODR(KSP ksp,PetscInt m)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (m < 2) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Restart must be at least 2");
+  if (m != gcrodr->m && ksp->setupstage) {ierr = KSPReset(ksp);CHKERRQ(ierr);}
+  gcrodr->m = m;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRSetRecycleSize_GCRODR(KSP ksp,PetscInt k)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (k < 0) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"The number of recycled vectors cannot be negative");
+  if (k != gcrodr->k && ksp->setupstage) {ierr = KSPReset(ksp);CHKERRQ(ierr);}
+  gcrodr->k = k;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRGetRecycleSize_GCRODR(KSP ksp,PetscInt *k,PetscInt *nk)
+{
+  KSP_GCRODR *gcrodr = (KSP_GCRODR*)ksp->data;
+
+  PetscFunctionBegin;
+  if (k)  *k  = gcrodr->k;
+  if (nk) *nk = gcrodr->nk;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRSetAdaptiveRestart_GCRODR(KSP ksp,PetscBool flg)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (flg != gcrodr->adaptive && ksp->setupstage) {ierr = KSPReset(ksp);CHKERRQ(ierr);}
+  gcrodr->adaptive = flg;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRSetMemoryBudget_GCRODR(KSP ksp,PetscInt budget)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (budget != PETSC_DEFAULT && budget < 1) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"The memory budget must be positive");
+  if (budget != gcrodr->budget && gcrodr->adaptive && ksp->setupstage) {ierr = KSPReset(ksp);CHKERRQ(ierr);}
+  gcrodr->budget = budget;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRSetRestart - Sets the dimension of the search space of a cycle of KSPGCRODR, recycled vectors included
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+-  m - the restart, default 30
+
+   Options Database Key:
+.  -ksp_gcrodr_restart <m> - the restart
+
+   Notes:
+   After the first cycle each cycle performs m - k Arnoldi steps, with k the number of recycled vectors.
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRSetRecycleSize()
+@*/
+PetscErrorCode KSPGCRODRSetRestart(KSP ksp,PetscInt m)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,m,2);
+  ierr = PetscTryMethod(ksp,"KSPGCRODRSetRestart_C",(KSP,PetscInt),(ksp,m));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRSetRecycleSize - Sets the number of approximate eigenvectors that KSPGCRODR keeps across cycles and across solves
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+-  k - the number of recycled vectors, default 10; 0 gives GMRES
+
+   Options Database Key:
+.  -ksp_gcrodr_recycle <k> - the number of recycled vectors
+
+   Notes:
+   Changing the size after the solver has been set up discards the recycled space.
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRGetRecycleSize(), KSPGCRODRSetRestart()
+@*/
+PetscErrorCode KSPGCRODRSetRecycleSize(KSP ksp,PetscInt k)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,k,2);
+  ierr = PetscTryMethod(ksp,"KSPGCRODRSetRecycleSize_C",(KSP,PetscInt),(ksp,k));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRGetRecycleSize - Gets the maximum and the current number of vectors of the recycled space of KSPGCRODR
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov solver context
+
+   Output Parameters:
++  k - the maximum number of recycled vectors, or NULL
+-  nk - the number of vectors currently recycled, or NULL
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRSetRecycleSize()
+@*/
+PetscErrorCode KSPGCRODRGetRecycleSize(KSP ksp,PetscInt *k,PetscInt *nk)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  ierr = PetscUseMethod(ksp,"KSPGCRODRGetRecycleSize_C",(KSP,PetscInt*,PetscInt*),(ksp,k,nk));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRSetAdaptiveRestart - Lets KSPGCRODR choose the restart and the number of recycled vectors after each cycle
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+-  flg - PETSC_TRUE to adapt the restart, default PETSC_FALSE
+
+   Options Database Key:
+.  -ksp_gcrodr_adaptive <bool> - adapt the restart
+
+   Notes:
+   After each cycle its cost, counted from the applications of the operator and preconditioner, weighted by the number of nonzeros
+   of the operator, the dot products and vector updates of the orthogonalization, and the update of the recycled space, is compared
+   with the reduction of the residual norm. The restart moves in the direction that increases the reduction per unit of work, in
+   smaller steps each time the direction changes; when a cycle reduces the residual norm by
+   less than 1%, the restart jumps to the largest value allowed by the memory budget. The number of recycled vectors follows the
+   restart, in the proportion of the values given with KSPGCRODRSetRecycleSize() and KSPGCRODRSetRestart(), with 0 recycled
+   vectors the method is GMRES with an adaptive restart. The choice carries over to the next calls to KSPSolve().
+
+   The cost is a model, not a measured time, so the decisions and the number of iterations are the same from one run to the next
+   and on all the processes. The preconditioner is assumed to cost as much as the operator.
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRSetMemoryBudget(), KSPGCRODRSetRestart(), KSPGCRODRSetRecycleSize()
+@*/
+PetscErrorCode KSPGCRODRSetAdaptiveRestart(KSP ksp,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveBool(ksp,flg,2);
+  ierr = PetscTryMethod(ksp,"KSPGCRODRSetAdaptiveRestart_C",(KSP,PetscBool),(ksp,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRSetMemoryBudget - Sets the maximum number of vectors of the size of the solution that KSPGCRODR with an adaptive
+   restart may use for its Krylov and recycled spaces
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+-  budget - the number of vectors, or PETSC_DEFAULT for the m + 1 + 4 k vectors of the restart m and the k recycled vectors
+
+   Options Database Key:
+.  -ksp_gcrodr_memory_budget <budget> - the number of vectors
+
+   Notes:
+   Each recycled vector needs 4 vectors and the restart m needs m + 1. The number of recycled vectors is reduced so that it stays
+   below a third of the largest restart, the largest restart then uses the rest of the budget. The Arnoldi vectors are only created
+   when a cycle needs them. The budget does not include the few work vectors common to all the cycles.
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRSetAdaptiveRestart()
+@*/
+PetscErrorCode KSPGCRODRSetMemoryBudget(KSP ksp,PetscInt budget)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,budget,2);
+  ierr = PetscTryMethod(ksp,"KSPGCRODRSetMemoryBudget_C",(KSP,PetscInt),(ksp,budget));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPGCRODR - Generalized conjugate residual with inner orthogonalization and deflated restarting, a GMRES that recycles an
+     approximate invariant subspace across restarts and across solves
+
+   Options Database Keys:
++   -ksp_gcrodr_restart <m> - dimension of the search space of a cycle, see KSPGCRODRSetRestart()
+.   -ksp_gcrodr_recycle <k> - number of recycled vectors, see KSPGCRODRSetRecycleSize()
+.   -ksp_gcrodr_adaptive <bool> - choose the restart and the number of recycled vectors from the cost and the convergence of the cycles, see KSPGCRODRSetAdaptiveRestart()
+-   -ksp_gcrodr_memory_budget <budget> - maximum number of vectors of the adaptive restart, see KSPGCRODRSetMemoryBudget()
+
+   Level: intermediate
+
+   Notes:
+   At the end of each cycle the harmonic Ritz vectors of the preconditioned operator associated with the k harmonic Ritz values of
+   smallest magnitude are kept in a space U together with its image C = Op U, with C orthonormal. The next cycles, and the next calls
+   to KSPSolve(), first remove the component of the residual in C and then run Arnoldi on (I - C C^H) Op, which deflates the
+   eigenvalues that slow down restarted GMRES.
+
+   The recycled space is kept until KSPReset() or a change of its size. When the operators given with KSPSetOperators() have a new
+   state, C is recomputed as Op U and orthonormalized at the start of the solve, which costs k applications of the operator and
+   preconditioner; this is the intended use for sequences of slowly changing systems such as Newton steps or time steps.
+
+   With -ksp_gcrodr_adaptive the restart and the number of recycled vectors are chosen after each cycle from the estimated cost of the
+   cycle and the reduction of the residual it gave, within a memory budget, instead of being tuned for each problem.
+
+   Left preconditioning (default) minimizes the preconditioned residual, right preconditioning the unpreconditioned residual.
+   KSPSolveTranspose() is not supported.
+
+   References:
++  1. - M. L. Parks, E. de Sturler, G. Mackey, D. D. Johnson and S. Maiti, Recycling Krylov subspaces for sequences of linear systems,
+        SIAM J. Sci. Comput., 2006.
+-  2. - P. Jolivet and P.-H. Tournier, Block iterative methods and recycling for improved scalability of linear solvers, SC16, 2016.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPDGMRES, KSPDEFCG,
+           KSPGCRODRSetRestart(), KSPGCRODRSetRecycleSize(), KSPGCRODRSetAdaptiveRestart(), KSPGCRODRSetMemoryBudget()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = PetscNewLog(ksp,&gcrodr);CHKERRQ(ierr);
+  ksp->data = (void*)gcrodr;
+  gcrodr->m      = 30;
+  gcrodr->k      = 10;
+  gcrodr->budget = PETSC_DEFAULT;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_RIGHT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_GCRODR;
+  ksp->ops->solve          = KSPSolve_GCRODR;
+  ksp->ops->reset          = KSPReset_GCRODR;
+  ksp->ops->destroy        = KSPDestroy_GCRODR;
+  ksp->ops->view           = KSPView_GCRODR;
+  ksp->ops->setfromoptions = KSPSetFromOptions_GCRODR;
+  ksp->ops->buildsolution  = KSPBuildSolution_GCRODR;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRestart_C",KSPGCRODRSetRestart_GCRODR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRecycleSize_C",KSPGCRODRSetRecycleSize_GCRODR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRGetRecycleSize_C",KSPGCRODRGetRecycleSize_GCRODR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetAdaptiveRestart_C",KSPGCRODRSetAdaptiveRestart_GCRODR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetMemoryBudget_C",KSPGCRODRSetMemoryBudget_GCRODR);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,280 @@
+/*
+    Block GMRES used by KSPMatSolve() with KSPGMRES
+*/
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>       /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+typedef struct {
+  Mat Vin,AV,W;      /* block the operator is applied to, its product with A, and the result (AV itself with right preconditioning) */
+} KSPMatSolveOp_GMRES;
+
+/* W = M A V (left preconditioning) or W = A M V (right preconditioning), the work blocks are recreated when the number of columns of V changes */
+static PetscErrorCode KSPMatSolveApplyOp_GMRES(KSP ksp,Mat A,Mat V,KSPMatSolveOp_GMRES *op)
+{
+  PetscInt       m,M,p,q = -1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetSize(V,&M,&p);CHKERRQ(ierr);
+  if (op->Vin) {ierr = MatGetSize(op->Vin,NULL,&q);CHKERRQ(ierr);}
+  if (p != q) {
+    if (op->W != op->AV) {ierr = MatDestroy(&op->W);CHKERRQ(ierr);}
+    op->W = NULL;
+    ierr = MatDestroy(&op->AV);CHKERRQ(ierr);
+    ierr = MatDestroy(&op->Vin);CHKERRQ(ierr);
+    ierr = MatGetLocalSize(V,&m,NULL);CHKERRQ(ierr);
+    ierr = MatCreateDense(PetscObjectComm((PetscObject)V),m,PETSC_DECIDE,M,p,NULL,&op->Vin);CHKERRQ(ierr);
+  }
+  if (ksp->pc_side == PC_LEFT) {
+    ierr = MatCopy(V,op->Vin,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatMatMult(A,op->Vin,op->AV ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,PETSC_DEFAULT,&op->AV);CHKERRQ(ierr);
+    if (!op->W) {ierr = MatDuplicate(op->Vin,MAT_DO_NOT_COPY_VALUES,&op->W);CHKERRQ(ierr);}
+    ierr = PCMatApply(ksp->pc,op->AV,op->W);CHKERRQ(ierr);
+  } else {
+    ierr = PCMatApply(ksp->pc,V,op->Vin);CHKERRQ(ierr);
+    ierr = MatMatMult(A,op->Vin,op->AV ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,PETSC_DEFAULT,&op->AV);CHKERRQ(ierr);
+    op->W = op->AV;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* R = B(:,idx) - A X for the k active columns, preconditioned from the left when needed, V is used as work space */
+static PetscErrorCode KSPMatSolveResidual_GMRES(KSP ksp,Mat A,Mat B,const PetscInt idx[],PetscInt k,PetscBool zero,Mat Xa,Mat R,Mat V)
+{
+  Mat               Xk,Rk,Vk,AX;
+  const PetscScalar *b;
+  PetscScalar       *r;
+  PetscInt          j,m,ldb,ldr;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(B,&m,NULL);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(R,&ldr);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(B,&b);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayWrite(R,&r);CHKERRQ(ierr);
+  for (j=0; j<k; j++) {ierr = PetscArraycpy(r+j*ldr,b+idx[j]*ldb,m);CHKERRQ(ierr);}
+  ierr = MatDenseRestoreArrayWrite(R,&r);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(B,&b);CHKERRQ(ierr);
+  ierr = MatDenseGetSubMatrix(R,0,k,&Rk);CHKERRQ(ierr);
+  if (!zero) {
+    ierr = MatDenseGetSubMatrix(Xa,0,k,&Xk);CHKERRQ(ierr);
+    ierr = MatMatMult(A,Xk,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&AX);CHKERRQ(ierr);
+    ierr = MatAXPY(Rk,-1.0,AX,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatDestroy(&AX);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(Xa,&Xk);CHKERRQ(ierr);
+  }
+  if (ksp->pc_side == PC_LEFT) {
+    ierr = MatDenseGetSubMatrix(V,0,k,&Vk);CHKERRQ(ierr);
+    ierr = PCMatApply(ksp->pc,Rk,Vk);CHKERRQ(ierr);
+    ierr = MatCopy(Vk,Rk,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(V,&Vk);CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreSubMatrix(R,&Rk);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* applies the plane rotation (c,s) to the rows r-1 and r of the n columns of x */
+PETSC_STATIC_INLINE void KSPMatSolveRotate_GMRES(PetscScalar c,PetscScalar s,PetscInt n,PetscScalar *x,PetscInt ldx,PetscInt r)
+{
+  PetscScalar t;
+  PetscInt    j;
+
+  for (j=0; j<n; j++) {
+    t              = x[r-1+j*ldx];
+    x[r-1+j*ldx]   = PetscConj(c)*t + PetscConj(s)*x[r+j*ldx];
+    x[r+j*ldx]     = c*x[r+j*ldx] - s*t;
+  }
+}
+
+/*
+   Block GMRES with restart, in the spirit of Vital's block GMRES
+
+   The block Krylov basis V is built with the block Arnoldi process: each new block, the product of the operator with the previous block, is
+   orthogonalized against V with two passes of block classical Gram-Schmidt (two reductions) and then orthonormalized with a rank revealing
+   factorization of its Gram matrix, computed in the second reduction. The directions that are numerically dependent are dropped, so the blocks
+   may shrink instead of breaking down. The band Hessenberg matrix is reduced to triangular form with plane rotations as it is built, which gives
+   the residual norms of all the columns at each iteration. Columns that have converged (relative to their own initial residual) are removed from
+   the block at each restart. An iteration is one block Arnoldi step, the restart is the maximum number of block Arnoldi steps per cycle.
+*/
+PetscErrorCode KSPMatSolve_GMRES(KSP ksp,Mat B,Mat X)
+{
+  KSP_GMRES           *gmres = (KSP_GMRES*)ksp->data;
+  KSPMatSolveOp_GMRES op = {NULL,NULL,NULL};
+  Mat                 A,Xa,R,V,Rk,Vc,Xk,Mx[2],My[2];
+  PetscScalar         *H,*Gls,*work,*T,*cs,*sn,*h,one = 1.0,mone = -1.0,tt;
+  PetscReal           *rnorm,*rnorm0,*d;
+  PetscBool           *conv,first = PETSC_TRUE;
+  PetscInt            *idx,*nrow,m,NN,N,mk,ldh,k,k0,kn,c0,c1,p,nb,i,j,l,q,r;
+  PetscBLASInt        bp,bc1,bnh,bk,bldh;
+  MPI_Comm            comm;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  if (ksp->pc_side == PC_SYMMETRIC) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPMatSolve() with KSPGMRES does not support symmetric preconditioning");
+  ierr = KSPGetOperators(ksp,&A,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)B,&comm);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,&NN,&N);CHKERRQ(ierr);
+  mk   = gmres->max_k;
+  ldh  = (mk+1)*N;
+  ierr = MatCreateDense(comm,m,PETSC_DECIDE,NN,N,NULL,&Xa);CHKERRQ(ierr);
+  ierr = MatCreateDense(comm,m,PETSC_DECIDE,NN,N,NULL,&R);CHKERRQ(ierr);
+  ierr = MatCreateDense(comm,m,PETSC_DECIDE,NN,ldh,NULL,&V);CHKERRQ(ierr);
+  ierr = PetscMalloc7(ldh*mk*N,&H,ldh*N,&Gls,ldh*N+N*N,&work,N*N,&T,2*N*mk*N,&cs,2*N*mk*N,&sn,mk*N,&nrow);CHKERRQ(ierr);
+  ierr = PetscMalloc5(N,&rnorm,N,&rnorm0,N,&d,N,&conv,N,&idx);CHKERRQ(ierr);
+  for (j=0; j<N; j++) idx[j] = j;
+  k = N;
+
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its    = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  if (ksp->guess_zero) {ierr = MatZeroEntries(Xa);CHKERRQ(ierr);}
+  else {ierr = MatCopy(X,Xa,SAME_NONZERO_PATTERN);CHKERRQ(ierr);}
+
+  while (!ksp->reason) {
+    /* orthonormalize the residuals of the active columns, R = V_0 S */
+    ierr = KSPMatSolveResidual_GMRES(ksp,A,B,idx,k,(PetscBool)(first && ksp->guess_zero),Xa,R,V);CHKERRQ(ierr);
+    ierr = MatDenseGetSubMatrix(R,0,k,&Rk);CHKERRQ(ierr);
+    ierr = KSPBlockInnerProducts_Private(ksp,1,&Rk,&Rk,0,work);CHKERRQ(ierr);
+    if (first) {
+      for (j=0; j<k; j++) rnorm0[j] = rnorm[j] = PetscSqrtReal(PetscAbsScalar(work[j+j*k]));
+      ierr = KSPBlockConverged_Private(ksp,k,rnorm,rnorm0,conv);CHKERRQ(ierr);
+      if (ksp->reason) {
+        ierr = MatDenseRestoreSubMatrix(R,&Rk);CHKERRQ(ierr);
+        break;
+      }
+      for (j=0,q=0; j<k; j++) {
+        if (conv[j]) continue;
+        for (i=0,l=0; i<k; i++) if (!conv[i]) work[l++ + q*k] = work[i+j*k];
+        q++;
+      }
+      for (j=0; j<q; j++) for (i=0; i<q; i++) work[i+j*q] = work[i+j*k];
+      if (q < k) {
+        ierr = MatDenseRestoreSubMatrix(R,&Rk);CHKERRQ(ierr);
+        ierr = KSPBlockDeflate_Private(&k,conv,idx,rnorm0,Xa,X,1,&R);CHKERRQ(ierr);
+        ierr = MatDenseGetSubMatrix(R,0,k,&Rk);CHKERRQ(ierr);
+      }
+      first = PETSC_FALSE;
+    }
+    ierr = PetscArrayzero(Gls,ldh*k);CHKERRQ(ierr);
+    ierr = KSPBlockOrthonormalize_Private(k,work,NULL,PETSC_SMALL,&k0,T,Gls,ldh);CHKERRQ(ierr);
+    ierr = MatDenseGetSubMatrix(V,0,k0,&Vc);CHKERRQ(ierr);
+    ierr = KSPBlockGemm_Private(1.0,Rk,T,k,0.0,Vc);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(V,&Vc);CHKERRQ(ierr);
+    ierr = MatDenseRestoreSubMatrix(R,&Rk);CHKERRQ(ierr);
+
+    /* block Arnoldi steps */
+    c0 = 0; c1 = k0;
+    for (nb=0; nb<mk && c1>c0 && !ksp->reason; nb++) {
+      p    = c1-c0;
+      ierr = MatDenseGetSubMatrix(V,c0,c1,&Vc);CHKERRQ(ierr);
+      ierr = KSPMatSolveApplyOp_GMRES(ksp,A,Vc,&op);CHKERRQ(ierr);
+      ierr = MatDenseRestoreSubMatrix(V,&Vc);CHKERRQ(ierr);
+
+      /* two passes of block classical Gram-Schmidt, the second one also computes the Gram matrix of the new block */
+      ierr = MatDenseGetSubMatrix(V,0,c1,&Vc);CHKERRQ(ierr);
+      ierr = KSPBlockInnerProducts_Private(ksp,1,&Vc,&op.W,0,work);CHKERRQ(ierr);
+      ierr = KSPBlockGemm_Private(-1.0,Vc,work,c1,1.0,op.W);CHKERRQ(ierr);
+      for (j=0; j<p; j++) for (i=0; i<c1; i++) H[i+(c0+j)*ldh] = work[i+j*c1];
+      Mx[0] = Vc;   My[0] = op.W;
+      Mx[1] = op.W; My[1] = op.W;
+      ierr = KSPBlockInnerProducts_Private(ksp,2,Mx,My,0,work);CHKERRQ(ierr);
+      ierr = KSPBlockGemm_Private(-1.0,Vc,work,c1,1.0,op.W);CHKERRQ(ierr);
+      ierr = MatDenseRestoreSubMatrix(V,&Vc);CHKERRQ(ierr);
+      for (j=0; j<p; j++) for (i=0; i<c1; i++) H[i+(c0+j)*ldh] += work[i+j*c1];
+      ierr = PetscBLASIntCast(p,&bp);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(c1,&bc1);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bp,&bp,&bc1,&mone,work,&bc1,work,&bc1,&one,work+c1*p,&bp));
+      for (j=0; j<p; j++) {
+        d[j] = PetscRealPart(work[c1*p+j+j*p]);
+        for (i=0; i<c1; i++) d[j] += PetscRealPart(PetscConj(H[i+(c0+j)*ldh])*H[i+(c0+j)*ldh]);
+      }
+      ierr = KSPBlockOrthonormalize_Private(p,work+c1*p,d,PETSC_SMALL,&kn,T,H+c1+c0*ldh,ldh);CHKERRQ(ierr);
+      if (kn < p) {ierr = PetscInfo3(ksp,"Dropping %D of the %D new Krylov directions at iteration %D\n",p-kn,p,ksp->its);CHKERRQ(ierr);}
+      ierr = MatDenseGetSubMatrix(V,c1,c1+kn,&Vc);CHKERRQ(ierr);
+      ierr = KSPBlockGemm_Private(1.0,op.W,T,p,0.0,Vc);CHKERRQ(ierr);
+      ierr = MatDenseRestoreSubMatrix(V,&Vc);CHKERRQ(ierr);
+
+      /* reduce the new columns of the band Hessenberg matrix to triangular form, and update the right-hand sides of the least squares problems */
+      for (j=c0; j<c1; j++) {
+        h       = H+j*ldh;
+        nrow[j] = c1+kn;
+        for (i=0; i<j; i++) for (l=0; l<nrow[i]-1-i; l++) KSPMatSolveRotate_GMRES(cs[2*N*i+l],sn[2*N*i+l],1,h,ldh,nrow[i]-1-l);
+        for (l=0; l<nrow[j]-1-j; l++) {
+          r  = nrow[j]-1-l;
+          tt = PetscSqrtScalar(PetscConj(h[r-1])*h[r-1] + PetscConj(h[r])*h[r]);
+          if (tt == 0.0) {
+            cs[2*N*j+l] = 1.0;
+            sn[2*N*j+l] = 0.0;
+          } else {
+            cs[2*N*j+l] = h[r-1]/tt;
+            sn[2*N*j+l] = h[r]/tt;
+          }
+          KSPMatSolveRotate_GMRES(cs[2*N*j+l],sn[2*N*j+l],1,h,ldh,r);
+          KSPMatSolveRotate_GMRES(cs[2*N*j+l],sn[2*N*j+l],k,Gls,ldh,r);
+        }
+      }
+      for (j=0; j<k; j++) {
+        rnorm[j] = 0.0;
+        for (i=c1; i<c1+kn; i++) rnorm[j] += PetscRealPart(PetscConj(Gls[i+j*ldh])*Gls[i+j*ldh]);
+        rnorm[j] = PetscSqrtReal(rnorm[j]);
+      }
+      ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ksp->its++;
+      ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ierr = KSPBlockConverged_Private(ksp,k,rnorm,rnorm0,conv);CHKERRQ(ierr);
+      c0 = c1;
+      c1 = c1+kn;
+    }
+
+    /* solve the triangular systems and update the active columns of the solution */
+    for (i=0; i<c0; i++) {
+      if (H[i+i*ldh] == 0.0) {
+        ierr = PetscInfo1(ksp,"Singular block Hessenberg matrix at iteration %D\n",ksp->its);CHKERRQ(ierr);
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        c0 = 0;
+        break;
+      }
+    }
+    if (c0) {
+      ierr = PetscBLASIntCast(c0,&bnh);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(k,&bk);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(ldh,&bldh);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","U","N","N",&bnh,&bk,&one,H,&bldh,Gls,&bldh));
+      ierr = MatDenseGetSubMatrix(V,0,c0,&Vc);CHKERRQ(ierr);
+      if (ksp->pc_side == PC_LEFT) {
+        ierr = MatDenseGetSubMatrix(Xa,0,k,&Xk);CHKERRQ(ierr);
+        ierr = KSPBlockGemm_Private(1.0,Vc,Gls,ldh,1.0,Xk);CHKERRQ(ierr);
+        ierr = MatDenseRestoreSubMatrix(Xa,&Xk);CHKERRQ(ierr);
+        ierr = MatDenseRestoreSubMatrix(V,&Vc);CHKERRQ(ierr);
+      } else {
+        ierr = MatDenseGetSubMatrix(R,0,k,&Rk);CHKERRQ(ierr);
+        ierr = KSPBlockGemm_Private(1.0,Vc,Gls,ldh,0.0,Rk);CHKERRQ(ierr);
+        ierr = MatDenseRestoreSubMatrix(V,&Vc);CHKERRQ(ierr);
+        ierr = MatDenseGetSubMatrix(V,0,k,&Vc);CHKERRQ(ierr);
+        ierr = PCMatApply(ksp->pc,Rk,Vc);CHKERRQ(ierr);
+        ierr = MatDenseGetSubMatrix(Xa,0,k,&Xk);CHKERRQ(ierr);
+        ierr = MatAXPY(Xk,1.0,Vc,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+        ierr = MatDenseRestoreSubMatrix(Xa,&Xk);CHKERRQ(ierr);
+        ierr = MatDenseRestoreSubMatrix(V,&Vc);CHKERRQ(ierr);
+        ierr = MatDenseRestoreSubMatrix(R,&Rk);CHKERRQ(ierr);
+      }
+      if (!ksp->reason) {ierr = KSPBlockDeflate_Private(&k,conv,idx,rnorm0,Xa,X,0,NULL);CHKERRQ(ierr);}
+    }
+  }
+
+  /* copy the remaining active columns to the solution */
+  for (j=0; j<k; j++) conv[j] = PETSC_TRUE;
+  ierr = KSPBlockDeflate_Private(&k,conv,idx,NULL,Xa,X,0,NULL);CHKERRQ(ierr);
+  if (op.W != op.AV) {ierr = MatDestroy(&op.W);CHKERRQ(ierr);}
+  ierr = MatDestroy(&op.AV);CHKERRQ(ierr);
+  ierr = MatDestroy(&op.Vin);CHKERRQ(ierr);
+  ierr = PetscFree7(H,Gls,work,T,cs,sn,nrow);CHKERRQ(ierr);
+  ierr = PetscFree5(rnorm,rnorm0,d,conv,idx);CHKERRQ(ierr);
+  ierr = MatDestroy(&V);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = MatDestroy(&Xa);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,368 @@
+
+/*
+    Iterative refinement with an inner solver that may communicate in reduced precision
+*/
+#include <petsc/private/kspimpl.h>              /*I "petscksp.h" I*/
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+#include <petscsf.h>
+
+typedef struct {
+  KSP            inner;     /* solver for the corrections */
+  KSPIRPrecision precision; /* precision of the halo exchanges of the operators in the inner solver */
+} KSP_IR;
+
+/*
+   With KSP_IR_PRECISION_SINGLE, switches the ghost value exchange of MatMult() with a MATMPIAIJ operator to single precision
+   for the inner solve (set) and back (restore). Other matrix types always communicate in full precision.
+*/
+static PetscErrorCode KSPIRCompressOperator_Private(KSP ksp,Mat A,PetscBool set,PetscSFCompression *saved)
+{
+  KSP_IR         *ir = (KSP_IR*)ksp->data;
+  PetscSF        sf;
+  PetscBool      ismpi;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ir->precision != KSP_IR_PRECISION_SINGLE || !(PetscDefined(USE_REAL_DOUBLE) || PetscDefined(USE_REAL___FLOAT128))) PetscFunctionReturn(0);
+  ierr = PetscObjectBaseTypeCompare((PetscObject)A,MATMPIAIJ,&ismpi);CHKERRQ(ierr);
+  if (!ismpi || !((Mat_MPIAIJ*)A->data)->Mvctx) PetscFunctionReturn(0);
+  sf = ((Mat_MPIAIJ*)A->data)->Mvctx;
+  if (set) {
+    ierr = PetscSFGetCompression(sf,saved);CHKERRQ(ierr);
+    ierr = PetscSFSetCompression(sf,PETSCSF_COMPRESSION_SINGLE);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFSetCompression(sf,*saved);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetUp_IR(KSP ksp)
+{
+  KSP_IR         *ir = (KSP_IR*)ksp->data;
+  Mat            A,P;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetWorkVecs(ksp,2);CHKERRQ(ierr);
+  ierr = PCGetOperators(ksp->pc,&A,&P);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ir->inner,A,P);CHKERRQ(ierr);
+  ierr = KSPSetUp(ir->inner);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_IR(KSP ksp)
+{
+  KSP_IR             *ir = (KSP_IR*)ksp->data;
+  Mat                Amat,Pmat;
+  Vec                x,b,r,d;
+  PetscSFCompression Asaved = PETSCSF_COMPRESSION_NONE,Psaved = PETSCSF_COMPRESSION_NONE;
+  PetscReal          rnorm = 0.0;
+  PetscInt           i,its;
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (ksp->transpose_solve) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPSolveTranspose() is not supported by KSPIR");
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ir->inner,Amat,Pmat);CHKERRQ(ierr);
+  x    = ksp->vec_sol;
+  b    = ksp->vec_rhs;
+  r    = ksp->work[0];
+  d    = ksp->work[1];
+
+  if (!ksp->guess_zero) {                          /*   r <- b - A x     */
+    ierr = KSP_MatMult(ksp,Amat,x,r);CHKERRQ(ierr);
+    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(b,r);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  for (i=0; ; i++) {
+    if (ksp->normtype != KSP_NORM_NONE) {
+      ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr); /*   rnorm <- r'*r     */
+      KSPCheckNorm(ksp,rnorm);
+    }
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->rnorm = rnorm;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ierr = KSPLogResidualHistory(ksp,rnorm);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,i,rnorm);CHKERRQ(ierr);
+    ierr = (*ksp->converged)(ksp,i,rnorm,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+    if (ksp->reason) break;
+    if (i == ksp->max_it) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+
+    /* correction from the inner solver, which only needs to reduce the residual by a modest factor */
+    ierr = KSPIRCompressOperator_Private(ksp,Amat,PETSC_TRUE,&Asaved);CHKERRQ(ierr);
+    if (Pmat != Amat) {ierr = KSPIRCompressOperator_Private(ksp,Pmat,PETSC_TRUE,&Psaved);CHKERRQ(ierr);}
+    ierr = KSPSolve(ir->inner,r,d);CHKERRQ(ierr);
+    if (Pmat != Amat) {ierr = KSPIRCompressOperator_Private(ksp,Pmat,PETSC_FALSE,&Psaved);CHKERRQ(ierr);}
+    ierr = KSPIRCompressOperator_Private(ksp,Amat,PETSC_FALSE,&Asaved);CHKERRQ(ierr);
+    ierr = KSPGetConvergedReason(ir->inner,&reason);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ir->inner,&its);CHKERRQ(ierr);
+    ierr = PetscInfo3(ksp,"Refinement step %D: inner solver %s in %D iterations\n",i,KSPConvergedReasons[reason],its);CHKERRQ(ierr);
+    if (reason < 0 && reason != KSP_DIVERGED_ITS) {
+      ksp->reason = reason;
+      break;
+    }
+    ierr = VecAXPY(x,1.0,d);CHKERRQ(ierr);         /*   x  <- x + d      */
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->its++;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+    /* the residual is always computed with the outer operator, in full precision */
+    ierr = KSP_MatMult(ksp,Amat,x,r);CHKERRQ(ierr); /*   r  <- b - Ax      */
+    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_IR(KSP ksp,PetscViewer viewer)
+{
+  KSP_IR         *ir = (KSP_IR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  inner precision: %s\n",KSPIRPrecisions[ir->precision]);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"Inner KSP solver details\n");CHKERRQ(ierr);
+  }
+  ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+  ierr = KSPView(ir->inner,viewer);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_IR(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_IR         *ir = (KSP_IR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* set the options prefix of the inner solver, since the parent prefix will be valid at this point */
+  ierr = KSPSetOptionsPrefix(ir->inner,((PetscObject)ksp)->prefix);CHKERRQ(ierr);
+  ierr = KSPAppendOptionsPrefix(ir->inner,"ir_");CHKERRQ(ierr);
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP IR options");CHKERRQ(ierr);
+  ierr = PetscOptionsEnum("-ksp_ir_inner_precision","Precision of the ghost value exchanges of the inner solver","KSPIRSetInnerPrecision",KSPIRPrecisions,(PetscEnum)ir->precision,(PetscEnum*)&ir->precision,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ir->inner);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_IR(KSP ksp)
+{
+  KSP_IR         *ir = (KSP_IR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset(ir->inner);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_IR(KSP ksp)
+{
+  KSP_IR         *ir = (KSP_IR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_IR(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroy(&ir->inner);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPIRSetInnerPrecision_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPIRGetInnerPrecision_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPIRGetInnerKSP_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPIRSetInnerPrecision_IR(KSP ksp,KSPIRPrecision precision)
+{
+  KSP_IR *ir = (KSP_IR*)ksp->data;
+
+  PetscFunctionBegin;
+  ir->precision = precision;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPIRGetInnerPrecision_IR(KSP ksp,KSPIRPrecision *precision)
+{
+  KSP_IR *ir = (KSP_IR*)ksp->data;
+
+  PetscFunctionBegin;
+  *precision = ir->precision;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPIRGetInnerKSP_IR(KSP ksp,KSP *inner)
+{
+  KSP_IR *ir = (KSP_IR*)ksp->data;
+
+  PetscFunctionBegin;
+  *inner = ir->inner;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPIRSetInnerPrecision - Sets the precision of the communication of the operators in the inner solver of KSPIR
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov solver context
+-  precision - KSP_IR_PRECISION_FULL (default) or KSP_IR_PRECISION_SINGLE
+
+   Options Database Key:
+.  -ksp_ir_inner_precision <full,single> - the precision of the ghost value exchanges of the inner solver
+
+   Notes:
+   With KSP_IR_PRECISION_SINGLE the ghost values needed by MatMult() of MATMPIAIJ operators are sent in single precision during
+   the inner solves, see PetscSFSetCompression(); the outer residuals are computed with full precision communication. The inner
+   solver uses the operators of the outer solver, no copy is made, and their entries stay in full precision. This has no effect
+   for other matrix types, on one process, or when PETSc is configured with single precision.
+
+   Level: intermediate
+
+.seealso: KSPIR, KSPIRGetInnerPrecision(), KSPIRGetInnerKSP(), KSPIRPrecision
+@*/
+PetscErrorCode KSPIRSetInnerPrecision(KSP ksp,KSPIRPrecision precision)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,precision,2);
+  ierr = PetscTryMethod(ksp,"KSPIRSetInnerPrecision_C",(KSP,KSPIRPrecision),(ksp,precision));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPIRGetInnerPrecision - Gets the precision of the communication of the operators in the inner solver of KSPIR
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov solver context
+
+   Output Parameter:
+.  precision - the precision, see KSPIRSetInnerPrecision()
+
+   Level: intermediate
+
+.seealso: KSPIR, KSPIRSetInnerPrecision(), KSPIRPrecision
+@*/
+PetscErrorCode KSPIRGetInnerPrecision(KSP ksp,KSPIRPrecision *precision)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidPointer(precision,2);
+  ierr = PetscUseMethod(ksp,"KSPIRGetInnerPrecision_C",(KSP,KSPIRPrecision*),(ksp,precision));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPIRGetInnerKSP - Gets the KSP that computes the corrections of KSPIR
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov solver context
+
+   Output Parameter:
+.  inner - the inner KSP
+
+   Notes:
+   The options prefix of the inner KSP is the prefix of ksp followed by ir_, e.g., -ir_ksp_type gmres -ir_pc_type gamg
+
+   Level: intermediate
+
+.seealso: KSPIR, KSPIRSetInnerPrecision()
+@*/
+PetscErrorCode KSPIRGetInnerKSP(KSP ksp,KSP *inner)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidPointer(inner,2);
+  ierr = PetscUseMethod(ksp,"KSPIRGetInnerKSP_C",(KSP,KSP*),(ksp,inner));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPIR - Mixed precision iterative refinement
+
+   Each iteration computes the residual r = b - A x with the operator of the KSP, solves A d = r approximately with an inner KSP,
+   and updates x = x + d. The convergence test is applied to the residual of the outer iteration, so the solution is as accurate
+   as with a solver that works in full precision, while the inner solver, e.g., GMRES with GAMG, only needs to reduce the residual
+   by a modest factor and may communicate in reduced precision, see KSPIRSetInnerPrecision().
+
+   Options Database Keys:
+.   -ksp_ir_inner_precision <full,single> - the precision of the ghost value exchanges of the inner solver, see KSPIRSetInnerPrecision()
+
+   Level: intermediate
+
+   Notes:
+   Options for the inner solver are prefixed with -ir_, e.g., -ir_ksp_type gmres -ir_pc_type gamg -ir_ksp_rtol 1e-4. The inner
+   solver uses by default a relative tolerance of 1e-4. The preconditioner of the outer KSP is not used, it is of type PCNONE.
+
+   Only the unpreconditioned norm of the residual is available, an iteration is one refinement step.
+
+   Only the communication of the inner solver is compressed: PETSc is compiled for a single scalar type, so the inner solver
+   stores its operators and vectors and computes in full precision. With -ksp_ir_inner_precision single the ghost value
+   exchanges of MatMult() with MATMPIAIJ operators use single precision, which halves their message sizes; with the default
+   KSP_IR_PRECISION_FULL, KSPIR is plain iterative refinement in full precision.
+
+   KSPSolveTranspose() is not supported.
+
+   References:
+.  1. - E. Carson and N. J. Higham, Accelerating the solution of linear systems by iterative refinement in three precisions, SIAM J. Sci. Comput., 2018.
+
+.seealso: KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPRICHARDSON, PCKSP, KSPIRGetInnerKSP(),
+          KSPIRSetInnerPrecision()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_IR(KSP ksp)
+{
+  KSP_IR         *ir;
+  PC             pc;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr          = PetscNewLog(ksp,&ir);CHKERRQ(ierr);
+  ir->precision = KSP_IR_PRECISION_FULL;
+  ksp->data     = (void*)ir;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_RIGHT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_IR;
+  ksp->ops->solve          = KSPSolve_IR;
+  ksp->ops->reset          = KSPReset_IR;
+  ksp->ops->destroy        = KSPDestroy_IR;
+  ksp->ops->view           = KSPView_IR;
+  ksp->ops->setfromoptions = KSPSetFromOptions_IR;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PCSetType(pc,PCNONE);CHKERRQ(ierr);
+
+  /* create the inner KSP */
+  ierr = KSPCreate(PetscObjectComm((PetscObject)ksp),&ir->inner);CHKERRQ(ierr);
+  ierr = PetscObjectIncrementTabLevel((PetscObject)ir->inner,(PetscObject)ksp,1);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ir->inner,1.e-4,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)ir->inner);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPIRSetInnerPrecision_C",KSPIRSetInnerPrecision_IR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPIRGetInnerPrecision_C",KSPIRGetInnerPrecision_IR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPIRGetInnerKSP_C",KSPIRGetInnerKSP_IR);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
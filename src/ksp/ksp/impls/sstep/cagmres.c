@@ -0,0 +1,509 @@
+
+/*
+    This file implements the communication-avoiding (s-step) GMRES method
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h>       /*I  "petscksp.h"  I*/
+
+typedef struct {
+  KSP_SStep   sstep;                   /* must be first */
+  PetscInt    max_k;                   /* restart */
+  PetscInt    nc;                      /* number of columns of the Hessenberg matrix in the current cycle */
+  Vec         *Q;                      /* orthonormal basis of the Krylov space, max_k+1 vectors */
+  PetscScalar *H;                      /* Hessenberg matrix, (max_k+1) x max_k */
+  PetscScalar *HR;                     /* H reduced to upper triangular form by Givens rotations */
+  PetscScalar *cs,*sn,*rs;             /* the rotations and the rotated right hand side */
+  PetscScalar *C,*C2,*R,*R2,*G,*Z,*T;  /* work space of the block orthogonalization */
+  PetscReal   *gd;
+  Vec         sol_temp;                /* holds the solution built during the iteration for the monitors */
+} KSP_CAGMRES;
+
+#define HES(a,i,j) ((a)[(i)+(j)*(ca->max_k+1)])
+
+static PetscErrorCode KSPSetUp_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       m = ca->max_k,s = ca->sstep.s;
+
+  PetscFunctionBegin;
+  ierr = KSPSStepSetUp_Private(ksp);CHKERRQ(ierr);
+  ierr = KSPSetWorkVecs(ksp,2);CHKERRQ(ierr);
+  ierr = KSPCreateVecs(ksp,m+1,&ca->Q,0,NULL);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,m+1,ca->Q);CHKERRQ(ierr);
+  ierr = PetscCalloc5((m+1)*m,&ca->H,(m+1)*m,&ca->HR,m+1,&ca->cs,m+1,&ca->sn,m+1,&ca->rs);CHKERRQ(ierr);
+  ierr = PetscMalloc7(2*(m+1)*s,&ca->C,s*s,&ca->R,s*s,&ca->R2,s*s,&ca->G,(m+1)*(s+1),&ca->Z,(m+1)*s,&ca->T,s,&ca->gd);CHKERRQ(ierr);
+  ca->C2 = ca->C+(m+1)*s;
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(2*(m+1)*m+3*(m+1)+4*(m+1)*s+3*s*s+(m+1)*(s+1))*sizeof(PetscScalar)+s*sizeof(PetscReal));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSStepReset_Private(ksp);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(ca->max_k+1,&ca->Q);CHKERRQ(ierr);
+  ierr = VecDestroy(&ca->sol_temp);CHKERRQ(ierr);
+  ierr = PetscFree5(ca->H,ca->HR,ca->cs,ca->sn,ca->rs);CHKERRQ(ierr);
+  ierr = PetscFree7(ca->C,ca->R,ca->R2,ca->G,ca->Z,ca->T,ca->gd);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_CAGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_CAGMRES(ksp);CHKERRQ(ierr);
+  ierr = KSPSStepDestroy_Private(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Cholesky factorization G = R^H R of the n x n Gram matrix G, stopping at the first pivot that shows that the vector
+   is (numerically) dependent on the previous ones relative to its norm before the projection, ref. Pivots that lost
+   more than half of the digits by cancellation are flagged, they cannot be trusted when G was obtained by updating
+   the Gram matrix before the projection (Pythagorean formula).
+*/
+static void KSPCAGMRESCholesky(PetscInt n,const PetscScalar *G,const PetscReal *ref,PetscScalar *R,PetscInt *nok,PetscBool *inaccurate)
+{
+  const PetscReal tol = 1.e8*PETSC_MACHINE_EPSILON*PETSC_MACHINE_EPSILON;
+  PetscInt        i,j,k;
+  PetscReal       d;
+  PetscScalar     t;
+
+  *nok        = 0;
+  *inaccurate = PETSC_FALSE;
+  for (i=0; i<n*n; i++) R[i] = 0.0;
+  for (j=0; j<n; j++) {
+    d = PetscRealPart(G[j+j*n]);
+    for (k=0; k<j; k++) d -= PetscRealPart(PetscConj(R[k+j*n])*R[k+j*n]);
+    if (d <= tol*ref[j]) {*nok = j; return;}
+    if (d < PetscSqrtReal(PETSC_MACHINE_EPSILON)*ref[j]) *inaccurate = PETSC_TRUE;
+    R[j+j*n] = PetscSqrtReal(d);
+    for (i=j+1; i<n; i++) {
+      t = G[j+i*n];
+      for (k=0; k<j; k++) t -= PetscConj(R[k+j*n])*R[k+i*n];
+      R[j+i*n] = t/R[j+j*n];
+    }
+  }
+  *nok = j;
+}
+
+/*
+   One pass of block classical Gram-Schmidt of the nw vectors W against the N orthonormal vectors Q followed by the
+   Cholesky QR factorization of W: W = Q C + Wnew R. C and the Gram matrix of W are computed with a single reduction
+   and the Gram matrix of the projected vectors is obtained from the Pythagorean formula, falling back to a second
+   reduction when that is inaccurate. Only the first nok vectors of Wnew are valid.
+*/
+static PetscErrorCode KSPCAGMRESBlockOrthogonalizePass(KSP ksp,PetscInt N,Vec *Q,PetscInt nw,Vec *W,PetscScalar *C,PetscScalar *R,PetscInt *nok)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       i,j,k;
+  PetscScalar    *G = ca->G,*t = ca->T;
+  PetscReal      *gd = ca->gd;
+  PetscBool      inaccurate;
+  MPI_Comm       comm = PetscObjectComm((PetscObject)ksp);
+
+  PetscFunctionBegin;
+  *nok = 0;
+  for (j=0; j<nw; j++) {
+    ierr = VecMDotBegin(W[j],N,Q,C+j*N);CHKERRQ(ierr);
+    ierr = VecMDotBegin(W[j],nw,W,G+j*nw);CHKERRQ(ierr);
+  }
+  ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+  for (j=0; j<nw; j++) {
+    ierr = VecMDotEnd(W[j],N,Q,C+j*N);CHKERRQ(ierr);
+    ierr = VecMDotEnd(W[j],nw,W,G+j*nw);CHKERRQ(ierr);
+  }
+  for (j=0; j<nw; j++) {
+    gd[j] = PetscRealPart(G[j+j*nw]);
+    for (i=0; i<N; i++) t[i] = -C[i+j*N];
+    ierr = VecMAXPY(W[j],N,t,Q);CHKERRQ(ierr);
+    for (i=0; i<nw; i++) for (k=0; k<N; k++) G[i+j*nw] -= PetscConj(C[k+i*N])*C[k+j*N];
+  }
+  KSPCAGMRESCholesky(nw,G,gd,R,nok,&inaccurate);
+  if (*nok < nw || inaccurate) {
+    for (j=0; j<nw; j++) {ierr = VecMDotBegin(W[j],nw,W,G+j*nw);CHKERRQ(ierr);}
+    ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+    for (j=0; j<nw; j++) {ierr = VecMDotEnd(W[j],nw,W,G+j*nw);CHKERRQ(ierr);}
+    KSPCAGMRESCholesky(nw,G,gd,R,nok,&inaccurate);
+  }
+  /* W <- W R^{-1} */
+  for (j=0; j<*nok; j++) {
+    for (i=0; i<j; i++) t[i] = -R[i+j*nw];
+    ierr = VecMAXPY(W[j],j,t,W);CHKERRQ(ierr);
+    ierr = VecScale(W[j],1.0/R[j+j*nw]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orthogonalizes the nw vectors Q[N],...,Q[N+nw-1] against Q[0],...,Q[N-1] and each other with two passes of block
+   classical Gram-Schmidt and Cholesky QR, giving Wold = Q C + Wnew R in ca->C (N x nw) and ca->R (nw x nw). When
+   fewer than nw vectors are independent only the first nok are orthonormalized.
+*/
+static PetscErrorCode KSPCAGMRESBlockOrthogonalize(KSP ksp,PetscInt N,PetscInt nw,PetscInt *nok)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,nok1 = 0,nok2 = 0;
+  PetscScalar    *C = ca->C,*C2 = ca->C2,*R = ca->R,*R2 = ca->R2,t;
+
+  PetscFunctionBegin;
+  *nok = 0;
+  ierr = KSPCAGMRESBlockOrthogonalizePass(ksp,N,ca->Q,nw,ca->Q+N,C,R,&nok1);CHKERRQ(ierr);
+  if (!nok1) {*nok = 0; PetscFunctionReturn(0);}
+  ierr = KSPCAGMRESBlockOrthogonalizePass(ksp,N,ca->Q,nok1,ca->Q+N,C2,R2,&nok2);CHKERRQ(ierr);
+  /* combine the passes: C <- C + C2 R, R <- R2 R where only the first nok1 rows of R are valid */
+  for (j=0; j<nw; j++) {
+    for (i=0; i<N; i++) {
+      for (t=0.0,k=0; k<PetscMin(j+1,nok1); k++) t += C2[i+k*N]*R[k+j*nw];
+      C[i+j*N] += t;
+    }
+  }
+  for (j=nw-1; j>=0; j--) {
+    for (i=0; i<nw; i++) {
+      t = 0.0;
+      if (i < nok2) for (k=i; k<PetscMin(j+1,nok1); k++) t += R2[i+k*nok1]*R[k+j*nw];
+      R[i+j*nw] = t;
+    }
+  }
+  *nok = nok2;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes the columns nc,...,nc+ncol-1 of the Hessenberg matrix from the block orthogonalization.
+
+   With w_0 = q_nc, the new vectors [w_0,...,w_ncol] = Q Z satisfy Op [w_0,...,w_{ncol-1}] = [w_0,...,w_ncol] B where
+   B is the tridiagonal change of basis matrix. With Op Q(:,0:nc-1) = Q H(:,0:nc-1) this gives
+      Op Q(:,nc:nc+ncol-1) Zb = Q (Z B - H(:,0:nc-1) Z(0:nc-1,:))
+   where the upper triangular Zb = Z(nc:nc+ncol-1,0:ncol-1).
+*/
+static PetscErrorCode KSPCAGMRESUpdateHessenberg(KSP ksp,PetscInt nw,PetscInt nok,PetscInt ncol)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  KSP_SStep      *ss = &ca->sstep;
+  PetscInt       nc = ca->nc,N = nc+1,nrow = N+nok,ldz = ca->max_k+1,i,j,k;
+  PetscScalar    *Z = ca->Z,*T = ca->T,*H = ca->H,a,b,c;
+
+  PetscFunctionBegin;
+  for (i=0; i<ldz*(ncol+1); i++) Z[i] = 0.0;
+  Z[nc] = 1.0;
+  for (j=1; j<=ncol; j++) {
+    for (i=0; i<N; i++) Z[i+j*ldz] = ca->C[i+(j-1)*N];
+    for (i=0; i<PetscMin(j,nok); i++) Z[N+i+j*ldz] = ca->R[i+(j-1)*nw];
+  }
+  for (k=0; k<ncol; k++) {
+    if (ss->shifts) {a = ss->alpha[k]; b = ss->beta[k]; c = ss->gamma[k];}
+    else            {a = 0.0; b = 1.0; c = 0.0;}
+    for (i=0; i<nrow; i++) {
+      T[i+k*ldz] = a*Z[i+k*ldz] + b*Z[i+(k+1)*ldz];
+      if (k) T[i+k*ldz] += c*Z[i+(k-1)*ldz];
+    }
+    for (j=0; j<nc; j++) {
+      if (Z[j+k*ldz] == (PetscScalar)0.0) continue;
+      for (i=0; i<=PetscMin(j+1,nc); i++) T[i+k*ldz] -= HES(H,i,j)*Z[j+k*ldz];
+    }
+  }
+  /* H(:,nc:nc+ncol-1) = T Zb^{-1}, truncated to Hessenberg form */
+  for (k=0; k<ncol; k++) {
+    for (i=nrow; i<ldz; i++) HES(H,i,nc+k) = 0.0;
+    for (i=0; i<nrow; i++) {
+      a = T[i+k*ldz];
+      for (j=0; j<k; j++) a -= HES(H,i,nc+j)*Z[nc+j+k*ldz];
+      HES(H,i,nc+k) = a/Z[nc+k+k*ldz];
+    }
+    for (i=nc+k+2; i<nrow; i++) HES(H,i,nc+k) = 0.0;
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Applies the previous Givens rotations to column c of the Hessenberg matrix and computes a new one */
+static PetscErrorCode KSPCAGMRESGivens(KSP ksp,PetscInt c,PetscReal *res)
+{
+  KSP_CAGMRES *ca = (KSP_CAGMRES*)ksp->data;
+  PetscScalar *hr = &HES(ca->HR,0,c),tt;
+  PetscInt    i;
+
+  PetscFunctionBegin;
+  for (i=0; i<=c+1; i++) hr[i] = HES(ca->H,i,c);
+  for (i=0; i<c; i++) {
+    tt      = hr[i];
+    hr[i]   = PetscConj(ca->cs[i])*tt + ca->sn[i]*hr[i+1];
+    hr[i+1] = ca->cs[i]*hr[i+1] - ca->sn[i]*tt;
+  }
+  tt = PetscSqrtScalar(PetscConj(hr[c])*hr[c] + PetscConj(hr[c+1])*hr[c+1]);
+  if (tt == (PetscScalar)0.0) {
+    if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"tt == 0.0");
+    ksp->reason = KSP_DIVERGED_NULL;
+    PetscFunctionReturn(0);
+  }
+  ca->cs[c]   = hr[c]/tt;
+  ca->sn[c]   = hr[c+1]/tt;
+  ca->rs[c+1] = -(ca->sn[c]*ca->rs[c]);
+  ca->rs[c]   = PetscConj(ca->cs[c])*ca->rs[c];
+  hr[c]       = tt;
+  hr[c+1]     = 0.0;
+  *res        = PetscAbsScalar(ca->rs[c+1]);
+  PetscFunctionReturn(0);
+}
+
+/* Adds the correction from the first n columns of the current cycle to vs and puts the result in vdest */
+static PetscErrorCode KSPCAGMRESBuildSoln(KSP ksp,PetscInt n,Vec vs,Vec vdest)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscScalar    *y = ca->T,tt;
+  PetscInt       i,k;
+
+  PetscFunctionBegin;
+  if (vdest != vs) {ierr = VecCopy(vs,vdest);CHKERRQ(ierr);}
+  if (n < 1) PetscFunctionReturn(0);
+  for (k=n-1; k>=0; k--) {
+    if (HES(ca->HR,k,k) == (PetscScalar)0.0) {
+      if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Likely your matrix or preconditioner is singular. HR(k,k) is identically zero; k = %D",k);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      ierr = PetscInfo1(ksp,"Likely your matrix or preconditioner is singular. HR(k,k) is identically zero; k = %D\n",k);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    tt = ca->rs[k];
+    for (i=k+1; i<n; i++) tt -= HES(ca->HR,k,i)*y[i];
+    y[k] = tt/HES(ca->HR,k,k);
+  }
+  ierr = VecSet(ksp->work[0],0.0);CHKERRQ(ierr);
+  ierr = VecMAXPY(ksp->work[0],n,y,ca->Q);CHKERRQ(ierr);
+  ierr = KSPUnwindPreconditioner(ksp,ksp->work[0],ksp->work[1]);CHKERRQ(ierr);
+  ierr = VecAXPY(vdest,1.0,ksp->work[0]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPCAGMRESCycle(KSP ksp)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  KSP_SStep      *ss = &ca->sstep;
+  PetscErrorCode ierr;
+  PetscReal      res;
+  PetscInt       nw,nok = 0,ncol,j,nwarm = PetscMin(2*ss->s,ca->max_k);
+  PetscBool      breakdown = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ca->nc = 0;
+  ierr = VecNormalize(ca->Q[0],&res);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res);
+  ca->rs[0]  = res;
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = res;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr        = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+
+  while (!ksp->reason && !breakdown && ca->nc < ca->max_k && ksp->its < ksp->max_it) {
+    /* the first iterations of each solve are classical GMRES steps that provide the Ritz values for the basis */
+    nw   = ss->shifts ? PetscMin(ss->s,ca->max_k-ca->nc) : 1;
+    ierr = KSPSStepMatPowers_Private(ksp,nw,ca->Q+ca->nc,ksp->work[1]);CHKERRQ(ierr);
+    ierr = KSPCAGMRESBlockOrthogonalize(ksp,ca->nc+1,nw,&nok);CHKERRQ(ierr);
+    if (nok < nw) {
+      ierr = PetscInfo3(ksp,"Only %D of the %D vectors of the block at column %D are independent\n",nok,nw,ca->nc);CHKERRQ(ierr);
+      breakdown = PETSC_TRUE;
+    }
+    /* when even the first vector is dependent the Krylov space is invariant (happy breakdown) */
+    ncol = nok ? nok : 1;
+    ierr = KSPCAGMRESUpdateHessenberg(ksp,nw,nok,ncol);CHKERRQ(ierr);
+    for (j=0; j<ncol; j++) {
+      ierr = KSPCAGMRESGivens(ksp,ca->nc,&res);CHKERRQ(ierr);
+      if (ksp->reason) break;
+      ca->nc++;
+      ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ksp->its++;
+      ksp->rnorm = res;
+      ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason || ksp->its >= ksp->max_it) break;
+    }
+    if (!nok && !ksp->reason) {
+      if (ksp->normtype == KSP_NORM_NONE) ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+      else if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the happy break down, but convergence was not indicated. Residual norm = %g",(double)res);
+      else ksp->reason = KSP_DIVERGED_BREAKDOWN;
+    }
+    if (!ss->shifts && ca->nc >= nwarm && !ksp->reason) {
+      ierr = KSPSStepComputeShifts_Private(ksp,ca->nc,ca->H,ca->max_k+1);CHKERRQ(ierr);
+    }
+  }
+  ierr = KSPCAGMRESBuildSoln(ksp,ca->nc,ksp->vec_sol,ksp->vec_sol);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->reason      = KSP_CONVERGED_ITERATING;
+  ca->nc           = 0;
+  ca->sstep.shifts = PETSC_FALSE;
+  while (!ksp->reason) {
+    ierr = KSPInitialResidual(ksp,ksp->vec_sol,ksp->work[0],ksp->work[1],ca->Q[0],ksp->vec_rhs);CHKERRQ(ierr);
+    ierr = KSPCAGMRESCycle(ksp);CHKERRQ(ierr);
+    if (ksp->its >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  ca->nc          = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBuildSolution_CAGMRES(KSP ksp,Vec ptr,Vec *result)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!ca->sol_temp) {
+      ierr = VecDuplicate(ksp->vec_sol,&ca->sol_temp);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)ca->sol_temp);CHKERRQ(ierr);
+    }
+    ptr = ca->sol_temp;
+  }
+  ierr = KSPCAGMRESBuildSoln(ksp,ca->nc,ksp->vec_sol,ptr);CHKERRQ(ierr);
+  if (result) *result = ptr;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_CAGMRES(KSP ksp,PetscViewer viewer)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, block classical Gram-Schmidt with Cholesky QR, two passes\n",ca->max_k);CHKERRQ(ierr);
+  }
+  ierr = KSPSStepView_Private(ksp,viewer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_CAGMRES(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       restart;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP CAGMRES Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_gmres_restart","Number of Krylov search directions","KSPGMRESSetRestart",ca->max_k,&restart,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetRestart(ksp,restart);CHKERRQ(ierr);}
+  ierr = KSPSStepSetFromOptions_Private(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGMRESSetRestart_CAGMRES(KSP ksp,PetscInt max_k)
+{
+  KSP_CAGMRES    *ca = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (max_k < 1) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Restart must be positive");
+  if (ksp->setupstage && ca->max_k != max_k) {
+    /* free the data structures, then create them again */
+    ierr = KSPReset_CAGMRES(ksp);CHKERRQ(ierr);
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  ca->max_k = max_k;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGMRESGetRestart_CAGMRES(KSP ksp,PetscInt *max_k)
+{
+  PetscFunctionBegin;
+  *max_k = ((KSP_CAGMRES*)ksp->data)->max_k;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPCAGMRES - Communication-avoiding (s-step) GMRES
+
+   Options Database Keys:
++   -ksp_gmres_restart <restart> - the number of Krylov directions to orthogonalize against
+.   -ksp_sstep_size <s> - the number of Krylov vectors generated and orthogonalized at once
+-   -ksp_sstep_basis <monomial,newton,chebyshev> - the polynomial basis of the blocks of s vectors
+
+   Level: intermediate
+
+   Notes:
+   The method generates s Krylov vectors with s applications of the (preconditioned) operator without intermediate
+   inner products (the matrix powers kernel), then orthogonalizes them against the previous basis and each other with
+   two passes of block classical Gram-Schmidt and Cholesky QR. Each pass needs a single global reduction, so the
+   number of reductions per iteration is 2/s instead of 2 for KSPGMRES with classical Gram-Schmidt. In exact
+   arithmetic the iterates are those of GMRES.
+
+   The first 2s iterations of each solve are classical GMRES iterations; the Ritz values of their Hessenberg matrix
+   give the shifts of the Newton basis (or the interval of the Chebyshev basis) that keeps the blocks well conditioned,
+   see KSPSStepSetBasis(). If the vectors of a block become numerically dependent the method restarts.
+
+   Supports left and right preconditioning, the default is left preconditioning.
+
+   References:
+.    1. - M. Hoemmen, Communication-avoiding Krylov subspace methods, PhD thesis, UC Berkeley, 2010.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPSSTEPCG, KSPPGMRES,
+           KSPPIPEFGMRES, KSPSStepSetSize(), KSPSStepSetBasis(), KSPGMRESSetRestart()
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *ca;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = PetscNewLog(ksp,&ca);CHKERRQ(ierr);
+  ksp->data = (void*)ca;
+  ca->max_k = 30;
+  ierr = KSPSStepCreate_Private(ksp);CHKERRQ(ierr);
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_RIGHT,1);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_CAGMRES;
+  ksp->ops->solve          = KSPSolve_CAGMRES;
+  ksp->ops->reset          = KSPReset_CAGMRES;
+  ksp->ops->destroy        = KSPDestroy_CAGMRES;
+  ksp->ops->view           = KSPView_CAGMRES;
+  ksp->ops->setfromoptions = KSPSetFromOptions_CAGMRES;
+  ksp->ops->buildsolution  = KSPBuildSolution_CAGMRES;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_CAGMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPGMRESGetRestart_CAGMRES);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
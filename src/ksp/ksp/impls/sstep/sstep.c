@@ -0,0 +1,376 @@
+
+/*
+   Code shared by the s-step Krylov methods: the choice of the polynomial basis and the matrix powers kernel
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h>       /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
+
+/*@
+   KSPSStepSetSize - Sets the number of Krylov vectors the s-step methods KSPSSTEPCG and KSPCAGMRES generate and
+   orthogonalize at once
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  s - the step size
+
+   Options Database:
+.  -ksp_sstep_size <s> - the step size
+
+   Notes:
+   The methods need one global reduction per s iterations (two for KSPCAGMRES) instead of one or two per iteration.
+   Large values of s make the basis ill-conditioned, values between 2 and 8 are typical. The default is 4.
+
+   Level: intermediate
+
+.seealso: KSPSSTEPCG, KSPCAGMRES, KSPSStepGetSize(), KSPSStepSetBasis()
+@*/
+PetscErrorCode KSPSStepSetSize(KSP ksp,PetscInt s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,s,2);
+  ierr = PetscTryMethod(ksp,"KSPSStepSetSize_C",(KSP,PetscInt),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSStepGetSize - Gets the number of Krylov vectors the s-step methods generate and orthogonalize at once
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameter:
+.  s - the step size
+
+   Level: intermediate
+
+.seealso: KSPSSTEPCG, KSPCAGMRES, KSPSStepSetSize()
+@*/
+PetscErrorCode KSPSStepGetSize(KSP ksp,PetscInt *s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidIntPointer(s,2);
+  ierr = PetscUseMethod(ksp,"KSPSStepGetSize_C",(KSP,PetscInt*),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSStepSetBasis - Sets the polynomial basis the s-step methods KSPSSTEPCG and KSPCAGMRES use to generate s
+   Krylov vectors at once
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  basis - KSP_SSTEP_BASIS_MONOMIAL, KSP_SSTEP_BASIS_NEWTON or KSP_SSTEP_BASIS_CHEBYSHEV
+
+   Options Database:
+.  -ksp_sstep_basis <monomial,newton,chebyshev> - the basis
+
+   Notes:
+   All bases are scaled with the largest Ritz value found during the first iterations of each solve, which are
+   performed with the classical method. The Newton basis (the default) uses Leja ordered Ritz values as shifts, the
+   Chebyshev basis uses the Chebyshev polynomials of the interval spanned by the real parts of the Ritz values. The
+   monomial basis is only suitable for small s.
+
+   Level: intermediate
+
+.seealso: KSPSSTEPCG, KSPCAGMRES, KSPSStepGetBasis(), KSPSStepSetSize(), KSPSStepBasis
+@*/
+PetscErrorCode KSPSStepSetBasis(KSP ksp,KSPSStepBasis basis)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,basis,2);
+  ierr = PetscTryMethod(ksp,"KSPSStepSetBasis_C",(KSP,KSPSStepBasis),(ksp,basis));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSStepGetBasis - Gets the polynomial basis the s-step methods use to generate s Krylov vectors at once
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameter:
+.  basis - the basis
+
+   Level: intermediate
+
+.seealso: KSPSSTEPCG, KSPCAGMRES, KSPSStepSetBasis()
+@*/
+PetscErrorCode KSPSStepGetBasis(KSP ksp,KSPSStepBasis *basis)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidPointer(basis,2);
+  ierr = PetscUseMethod(ksp,"KSPSStepGetBasis_C",(KSP,KSPSStepBasis*),(ksp,basis));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSStepSetSize_SStep(KSP ksp,PetscInt s)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Step size %D must be positive",s);
+  if (ksp->setupstage && ss->s != s) {
+    /* free the data structures, then create them again */
+    ierr = (*ksp->ops->reset)(ksp);CHKERRQ(ierr);
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  ss->s = s;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSStepGetSize_SStep(KSP ksp,PetscInt *s)
+{
+  PetscFunctionBegin;
+  *s = KSPSStepData(ksp)->s;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSStepSetBasis_SStep(KSP ksp,KSPSStepBasis basis)
+{
+  PetscFunctionBegin;
+  KSPSStepData(ksp)->basis = basis;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSStepGetBasis_SStep(KSP ksp,KSPSStepBasis *basis)
+{
+  PetscFunctionBegin;
+  *basis = KSPSStepData(ksp)->basis;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepCreate_Private(KSP ksp)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ss->s     = 4;
+  ss->basis = KSP_SSTEP_BASIS_NEWTON;
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetSize_C",KSPSStepSetSize_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepGetSize_C",KSPSStepGetSize_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetBasis_C",KSPSStepSetBasis_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepGetBasis_C",KSPSStepGetBasis_SStep);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepSetUp_Private(KSP ksp)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(ss->s,&ss->alpha,ss->s,&ss->beta,ss->s,&ss->gamma);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,ss->s*(sizeof(PetscScalar)+2*sizeof(PetscReal)));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepReset_Private(KSP ksp)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(ss->alpha,ss->beta,ss->gamma);CHKERRQ(ierr);
+  ss->shifts = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepDestroy_Private(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetSize_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepGetSize_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetBasis_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepGetBasis_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepSetFromOptions_Private(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+  PetscInt       s;
+  KSPSStepBasis  basis;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsInt("-ksp_sstep_size","Number of Krylov vectors generated at once","KSPSStepSetSize",ss->s,&s,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSStepSetSize(ksp,s);CHKERRQ(ierr);}
+  ierr = PetscOptionsEnum("-ksp_sstep_basis","Polynomial basis of the s-step blocks","KSPSStepSetBasis",KSPSStepBases,(PetscEnum)ss->basis,(PetscEnum*)&basis,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSStepSetBasis(ksp,basis);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepView_Private(KSP ksp,PetscViewer viewer)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  step size s=%D, %s basis\n",ss->s,KSPSStepBases[ss->basis]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPSStepComputeShifts_Private - computes the coefficients of the recurrence generating the basis from the Ritz values
+   of the operator, the eigenvalues of the n x n upper Hessenberg (or tridiagonal) matrix H with leading dimension ldh
+
+   The Newton shifts are the Ritz values in (modified) Leja order: each shift maximizes the product of its distances to
+   the previous ones. In real arithmetic a complex conjugate pair a +- ib is applied as the real quadratic factor
+   (Op - a)^2 + b^2, which gives the recurrence coefficient gamma = -b^2/beta on the second vector of the pair.
+*/
+PetscErrorCode KSPSStepComputeShifts_Private(KSP ksp,PetscInt n,const PetscScalar *H,PetscInt ldh)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,best,nchosen = 0,s = ss->s;
+  PetscBLASInt   bn,lwork,idummy = 1,lierr;
+  PetscScalar    *A,*work,sdummy = 0;
+  PetscReal      *re,*im,*cre,*cim,*rwork,sigma = 0.0,lo = PETSC_MAX_REAL,hi = PETSC_MIN_REAL,center,width,val,bestval,dist;
+  PetscBool      *used;
+#if defined(PETSC_USE_COMPLEX)
+  PetscScalar    *eigs;
+#endif
+
+  PetscFunctionBegin;
+  if (n < 1) PetscFunctionReturn(0);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(5*n,&lwork);CHKERRQ(ierr);
+  ierr = PetscMalloc7(n*n,&A,5*n,&work,2*n,&re,2*s,&cre,2*s,&cim,2*n,&rwork,n,&used);CHKERRQ(ierr);
+  im   = re+n;
+  for (j=0; j<n; j++) for (i=0; i<n; i++) A[i+j*n] = H[i+j*ldh];
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if !defined(PETSC_USE_COMPLEX)
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","N",&bn,A,&bn,re,im,&sdummy,&idummy,&sdummy,&idummy,work,&lwork,&lierr));
+#else
+  ierr = PetscMalloc1(n,&eigs);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","N",&bn,A,&bn,eigs,&sdummy,&idummy,&sdummy,&idummy,work,&lwork,rwork,&lierr));
+  for (i=0; i<n; i++) {re[i] = PetscRealPart(eigs[i]); im[i] = PetscImaginaryPart(eigs[i]);}
+  ierr = PetscFree(eigs);CHKERRQ(ierr);
+#endif
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (lierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)lierr);
+
+  for (i=0; i<n; i++) {
+    sigma = PetscMax(sigma,PetscSqrtReal(re[i]*re[i]+im[i]*im[i]));
+    lo    = PetscMin(lo,re[i]);
+    hi    = PetscMax(hi,re[i]);
+  }
+  if (sigma == 0.0) sigma = 1.0;
+  switch (ss->basis) {
+  case KSP_SSTEP_BASIS_MONOMIAL:
+    for (j=0; j<s; j++) {ss->alpha[j] = 0.0; ss->beta[j] = sigma; ss->gamma[j] = 0.0;}
+    break;
+  case KSP_SSTEP_BASIS_CHEBYSHEV:
+    /* enlarge the interval a bit since the Ritz values lie inside the spectrum */
+    center = 0.5*(hi+lo);
+    width  = 0.5*(hi-lo) + 0.05*sigma;
+    for (j=0; j<s; j++) {
+      ss->alpha[j] = center;
+      ss->beta[j]  = j ? 0.5*width : width;
+      ss->gamma[j] = j ? 0.5*width : 0.0;
+    }
+    break;
+  case KSP_SSTEP_BASIS_NEWTON:
+    ierr = PetscArrayzero(used,n);CHKERRQ(ierr);
+    for (j=0; j<s;) {
+      best    = -1;
+      bestval = PETSC_MIN_REAL;
+      for (i=0; i<n; i++) {
+#if !defined(PETSC_USE_COMPLEX)
+        if (im[i] < 0.0) continue; /* represented by its conjugate */
+#endif
+        if (used[i]) continue;
+        if (!nchosen) val = re[i]*re[i]+im[i]*im[i];
+        else {
+          for (val=0.0,k=0; k<nchosen; k++) {
+            dist = PetscSqrtReal((re[i]-cre[k])*(re[i]-cre[k])+(im[i]-cim[k])*(im[i]-cim[k]));
+            if (dist == 0.0) break;
+            val += PetscLogReal(dist);
+          }
+          if (k < nchosen) continue;
+        }
+        if (val > bestval) {best = i; bestval = val;}
+      }
+      if (best < 0) { /* all Ritz values have been used, start over */
+        if (!nchosen) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"No Ritz value available");
+        ierr    = PetscArrayzero(used,n);CHKERRQ(ierr);
+        nchosen = 0;
+        continue;
+      }
+      used[best] = PETSC_TRUE;
+#if !defined(PETSC_USE_COMPLEX)
+      if (im[best] > 0.0 && j+1 < s) {
+        ss->alpha[j]   = re[best];   ss->beta[j]   = sigma; ss->gamma[j]   = 0.0;
+        ss->alpha[j+1] = re[best];   ss->beta[j+1] = sigma; ss->gamma[j+1] = -im[best]*im[best]/sigma;
+        cre[nchosen]   = re[best];   cim[nchosen++] = im[best];
+        cre[nchosen]   = re[best];   cim[nchosen++] = -im[best];
+        j += 2;
+      } else {
+        ss->alpha[j] = re[best]; ss->beta[j] = sigma; ss->gamma[j] = 0.0;
+        cre[nchosen] = re[best]; cim[nchosen++] = 0.0;
+        j++;
+      }
+#else
+      ss->alpha[j] = PetscCMPLX(re[best],im[best]); ss->beta[j] = sigma; ss->gamma[j] = 0.0;
+      cre[nchosen] = re[best]; cim[nchosen++] = im[best];
+      j++;
+#endif
+    }
+    break;
+  }
+  ss->shifts = PETSC_TRUE;
+  ierr = PetscInfo4(ksp,"Computed %s basis for s=%D from %D Ritz values, largest modulus %g\n",KSPSStepBases[ss->basis],s,n,(double)sigma);CHKERRQ(ierr);
+  ierr = PetscFree7(A,work,re,cre,cim,rwork,used);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPSStepMatPowers_Private - generates w[1],...,w[nw] from w[0] with the recurrence of the basis and the
+   (preconditioned) operator of the KSP, with the monomial basis of scaling one when the shifts are not yet known
+*/
+PetscErrorCode KSPSStepMatPowers_Private(KSP ksp,PetscInt nw,Vec *w,Vec work)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  if (nw > ss->s) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Cannot generate %D vectors with step size %D",nw,ss->s);
+  for (j=0; j<nw; j++) {
+    ierr = KSP_PCApplyBAorAB(ksp,w[j],w[j+1],work);CHKERRQ(ierr);
+    if (!ss->shifts) continue;
+    if (ss->alpha[j] != (PetscScalar)0.0) {ierr = VecAXPY(w[j+1],-ss->alpha[j],w[j]);CHKERRQ(ierr);}
+    if (j && ss->gamma[j] != 0.0) {ierr = VecAXPY(w[j+1],-ss->gamma[j],w[j-1]);CHKERRQ(ierr);}
+    ierr = VecScale(w[j+1],1.0/ss->beta[j]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,383 @@
+
+/*
+    This file implements the s-step (communication-avoiding) conjugate gradient method
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h>       /*I  "petscksp.h"  I*/
+
+typedef struct {
+  KSP_SStep   sstep;                   /* must be first */
+  Vec         *Y;                      /* basis [p, Op p, ..., Op^s p, z, Op z, ..., Op^{s-1} z] in the basis polynomials, 2s+1 vectors */
+  Vec         *YT;                     /* the same multiplied by the preconditioner matrix M, i.e. built from r and A */
+  PetscScalar *G;                      /* Gram matrix YT^H Y */
+  PetscScalar *Gn;                     /* Gram matrix needed for the residual norm: Y^H Y or YT^H YT */
+  PetscScalar *w;                      /* coordinates in the basis and the Lanczos matrix of the first iterations */
+} KSP_SSTEPCG;
+
+static PetscErrorCode KSPSetUp_SSTEPCG(KSP ksp)
+{
+  KSP_SSTEPCG    *sc = (KSP_SSTEPCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       nb = 2*sc->sstep.s+1;
+
+  PetscFunctionBegin;
+  ierr = KSPSStepSetUp_Private(ksp);CHKERRQ(ierr);
+  ierr = KSPSetWorkVecs(ksp,5);CHKERRQ(ierr);
+  ierr = KSPCreateVecs(ksp,nb,&sc->Y,nb,&sc->YT);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,nb,sc->Y);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,nb,sc->YT);CHKERRQ(ierr);
+  ierr = PetscMalloc3(nb*nb,&sc->G,nb*nb,&sc->Gn,nb*nb+5*nb,&sc->w);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(3*nb*nb+5*nb)*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_SSTEPCG(KSP ksp)
+{
+  KSP_SSTEPCG    *sc = (KSP_SSTEPCG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       nb = 2*sc->sstep.s+1;
+
+  PetscFunctionBegin;
+  ierr = KSPSStepReset_Private(ksp);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nb,&sc->Y);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nb,&sc->YT);CHKERRQ(ierr);
+  ierr = PetscFree3(sc->G,sc->Gn,sc->w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_SSTEPCG(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_SSTEPCG(ksp);CHKERRQ(ierr);
+  ierr = KSPSStepDestroy_Private(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* u^H G v for the n x n matrix G */
+PETSC_STATIC_INLINE PetscScalar KSPSSTEPCGQuadraticForm(PetscInt n,const PetscScalar *G,const PetscScalar *u,const PetscScalar *v)
+{
+  PetscInt    i,j;
+  PetscScalar sum = 0.0,t;
+
+  for (j=0; j<n; j++) {
+    if (v[j] == (PetscScalar)0.0) continue;
+    for (t=0.0,i=0; i<n; i++) t += PetscConj(u[i])*G[i+j*n];
+    sum += t*v[j];
+  }
+  return sum;
+}
+
+/*
+   Generates len basis vectors after y[0] (and yt[0] = M y[0]) with the recurrence of the basis:
+   yt[j+1] = (A y[j] - alpha_j yt[j] - gamma_j yt[j-1])/beta_j and y[j+1] = M^{-1} (the same)
+*/
+static PetscErrorCode KSPSSTEPCGMatPowers(KSP ksp,Mat A,PetscInt len,Vec *y,Vec *yt,Vec t)
+{
+  KSP_SStep      *ss = KSPSStepData(ksp);
+  PetscErrorCode ierr;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  for (j=0; j<len; j++) {
+    ierr = KSP_MatMult(ksp,A,y[j],t);CHKERRQ(ierr);
+    ierr = KSP_PCApply(ksp,t,y[j+1]);CHKERRQ(ierr);
+    ierr = VecWAXPY(yt[j+1],-ss->alpha[j],yt[j],t);CHKERRQ(ierr);
+    ierr = VecAXPY(y[j+1],-ss->alpha[j],y[j]);CHKERRQ(ierr);
+    if (j && ss->gamma[j] != 0.0) {
+      ierr = VecAXPY(yt[j+1],-ss->gamma[j],yt[j-1]);CHKERRQ(ierr);
+      ierr = VecAXPY(y[j+1],-ss->gamma[j],y[j-1]);CHKERRQ(ierr);
+    }
+    ierr = VecScale(yt[j+1],1.0/ss->beta[j]);CHKERRQ(ierr);
+    ierr = VecScale(y[j+1],1.0/ss->beta[j]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Computes the residual norm of the current iterate and runs the monitors and the convergence test */
+static PetscErrorCode KSPSSTEPCGConverged(KSP ksp,PetscScalar gamma,PetscReal dp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ksp->normtype == KSP_NORM_NATURAL) dp = PetscSqrtReal(PetscAbsScalar(gamma));
+  else if (ksp->normtype == KSP_NORM_NONE) dp = 0.0;
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = dp;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,dp);CHKERRQ(ierr);
+  ierr = (*ksp->converged)(ksp,ksp->its,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_SSTEPCG(KSP ksp)
+{
+  KSP_SSTEPCG    *sc = (KSP_SSTEPCG*)ksp->data;
+  KSP_SStep      *ss = &sc->sstep;
+  PetscErrorCode ierr;
+  PetscInt       s = ss->s,nb = 2*s+1,nwarm = 2*s,i,j,k;
+  PetscScalar    gamma,gammanew,delta,alpha,beta,*G = sc->G,*Gn = sc->Gn,*T = sc->w;
+  PetscScalar    *pc = T+nb*nb,*rc = pc+nb,*xc = rc+nb,*wc = xc+nb,*lanczos = wc+nb;
+  PetscReal      dp = 0.0;
+  Vec            X,B,R,Z,P,PT,W,*Y = sc->Y,*YT = sc->YT;
+  Mat            Amat,Pmat;
+  PetscBool      diagonalscale;
+  MPI_Comm       comm;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)ksp,&comm);CHKERRQ(ierr);
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(comm,PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+
+  X  = ksp->vec_sol;
+  B  = ksp->vec_rhs;
+  R  = ksp->work[0];
+  Z  = ksp->work[1];
+  P  = ksp->work[2];
+  PT = ksp->work[3];
+  W  = ksp->work[4];
+
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+
+  ksp->its   = 0;
+  ss->shifts = PETSC_FALSE;
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,Amat,X,R);CHKERRQ(ierr);             /*    r <- b - Ax     */
+    ierr = VecAYPX(R,-1.0,B);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(B,R);CHKERRQ(ierr);                          /*    r <- b (x is 0) */
+  }
+  ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                    /*    z <- Br         */
+  ierr = VecCopy(Z,P);CHKERRQ(ierr);                            /*    p <- z          */
+  ierr = VecCopy(R,PT);CHKERRQ(ierr);                           /*    pt <- r = M p   */
+  ierr = VecDotBegin(Z,R,&gamma);CHKERRQ(ierr);
+  if (ksp->normtype == KSP_NORM_PRECONDITIONED) {ierr = VecNormBegin(Z,NORM_2,&dp);CHKERRQ(ierr);}
+  else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);}
+  ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+  ierr = VecDotEnd(Z,R,&gamma);CHKERRQ(ierr);
+  if (ksp->normtype == KSP_NORM_PRECONDITIONED) {ierr = VecNormEnd(Z,NORM_2,&dp);CHKERRQ(ierr);}
+  else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {ierr = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);}
+  KSPCheckDot(ksp,gamma);
+  if (PetscRealPart(gamma) < 0.0) {
+    if (ksp->errorifnotconverged) SETERRQ(comm,PETSC_ERR_NOT_CONVERGED,"Detected indefinite preconditioner");
+    ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+    PetscFunctionReturn(0);
+  }
+  ierr = KSPSSTEPCGConverged(ksp,gamma,dp);CHKERRQ(ierr);
+  if (ksp->reason) PetscFunctionReturn(0);
+
+  /* the first 2s iterations are classical CG iterations, their Lanczos matrix gives the Ritz values for the basis */
+  ierr = PetscArrayzero(lanczos,nb);CHKERRQ(ierr);
+  ierr = PetscArrayzero(T,nb*nb);CHKERRQ(ierr);
+  for (i=0; i<nwarm && ksp->its < ksp->max_it; i++) {
+    ierr = KSP_MatMult(ksp,Amat,P,W);CHKERRQ(ierr);             /*    w <- Ap         */
+    ierr = VecDot(W,P,&delta);CHKERRQ(ierr);                    /*    delta <- p'Ap   */
+    KSPCheckDot(ksp,delta);
+    if (PetscRealPart(delta) <= 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ(comm,PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite matrix");
+      ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      PetscFunctionReturn(0);
+    }
+    alpha = gamma/delta;
+    ierr  = VecAXPY(X,alpha,P);CHKERRQ(ierr);                   /*    x <- x + alpha p */
+    ierr  = VecAXPY(R,-alpha,W);CHKERRQ(ierr);                  /*    r <- r - alpha w */
+    ierr  = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                 /*    z <- Br          */
+    ierr  = VecDotBegin(Z,R,&gammanew);CHKERRQ(ierr);
+    if (ksp->normtype == KSP_NORM_PRECONDITIONED) {ierr = VecNormBegin(Z,NORM_2,&dp);CHKERRQ(ierr);}
+    else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);}
+    ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+    ierr = VecDotEnd(Z,R,&gammanew);CHKERRQ(ierr);
+    if (ksp->normtype == KSP_NORM_PRECONDITIONED) {ierr = VecNormEnd(Z,NORM_2,&dp);CHKERRQ(ierr);}
+    else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {ierr = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);}
+    KSPCheckDot(ksp,gammanew);
+    if (PetscRealPart(gammanew) < 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ(comm,PETSC_ERR_NOT_CONVERGED,"Detected indefinite preconditioner");
+      ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+      PetscFunctionReturn(0);
+    }
+    beta  = gammanew/gamma;
+    gamma = gammanew;
+    ierr  = VecAYPX(P,beta,Z);CHKERRQ(ierr);                    /*    p <- z + beta p  */
+    ierr  = VecAYPX(PT,beta,R);CHKERRQ(ierr);                   /*    pt <- r + beta pt */
+    /* Lanczos matrix from the CG coefficients */
+    T[i+i*nb] = 1.0/alpha + (i ? lanczos[i-1] : 0.0);
+    if (i+1 < nwarm) {
+      lanczos[i]       = beta/alpha;
+      T[i+(i+1)*nb]    = PetscSqrtScalar(beta)/alpha;
+      T[i+1+i*nb]      = T[i+(i+1)*nb];
+    }
+    ksp->its++;
+    ierr = KSPSSTEPCGConverged(ksp,gamma,dp);CHKERRQ(ierr);
+    if (ksp->reason) PetscFunctionReturn(0);
+  }
+  if (ksp->its >= ksp->max_it) {
+    ksp->reason = KSP_DIVERGED_ITS;
+    PetscFunctionReturn(0);
+  }
+  ierr = KSPSStepComputeShifts_Private(ksp,i,T,nb);CHKERRQ(ierr);
+
+  while (!ksp->reason) {
+    /* matrix powers kernel: the bases of the search direction and of the preconditioned residual */
+    ierr = VecCopy(P,Y[0]);CHKERRQ(ierr);
+    ierr = VecCopy(PT,YT[0]);CHKERRQ(ierr);
+    ierr = KSPSSTEPCGMatPowers(ksp,Amat,s,Y,YT,W);CHKERRQ(ierr);
+    ierr = VecCopy(Z,Y[s+1]);CHKERRQ(ierr);
+    ierr = VecCopy(R,YT[s+1]);CHKERRQ(ierr);
+    ierr = KSPSSTEPCGMatPowers(ksp,Amat,s-1,Y+s+1,YT+s+1,W);CHKERRQ(ierr);
+
+    /* all the inner products of the next s iterations with a single reduction */
+    for (j=0; j<nb; j++) {
+      ierr = VecMDotBegin(Y[j],nb,YT,G+j*nb);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) {ierr = VecMDotBegin(Y[j],nb,Y,Gn+j*nb);CHKERRQ(ierr);}
+      else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {ierr = VecMDotBegin(YT[j],nb,YT,Gn+j*nb);CHKERRQ(ierr);}
+    }
+    ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+    for (j=0; j<nb; j++) {
+      ierr = VecMDotEnd(Y[j],nb,YT,G+j*nb);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) {ierr = VecMDotEnd(Y[j],nb,Y,Gn+j*nb);CHKERRQ(ierr);}
+      else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {ierr = VecMDotEnd(YT[j],nb,YT,Gn+j*nb);CHKERRQ(ierr);}
+    }
+
+    /* s CG iterations on the coordinates in the basis, Op Y(:,j) = Y (B e_j) with the tridiagonal blocks of B */
+    ierr = PetscArrayzero(pc,nb);CHKERRQ(ierr);
+    ierr = PetscArrayzero(rc,nb);CHKERRQ(ierr);
+    ierr = PetscArrayzero(xc,nb);CHKERRQ(ierr);
+    pc[0]   = 1.0;
+    rc[s+1] = 1.0;
+    for (j=0; j<s; j++) {
+      ierr = PetscArrayzero(wc,nb);CHKERRQ(ierr);
+      for (k=0; k<nb; k++) {
+        PetscInt l = k <= s ? k : k-s-1; /* position in the block, the last vector of each block is not multiplied */
+
+        if (l == (k <= s ? s : s-1) || pc[k] == (PetscScalar)0.0) continue;
+        wc[k]   += ss->alpha[l]*pc[k];
+        wc[k+1] += ss->beta[l]*pc[k];
+        if (l) wc[k-1] += ss->gamma[l]*pc[k];
+      }
+      delta = KSPSSTEPCGQuadraticForm(nb,G,pc,wc);              /*    delta <- p'Ap    */
+      KSPCheckDot(ksp,delta);
+      if (PetscRealPart(delta) <= 0.0) {
+        if (ksp->errorifnotconverged) SETERRQ(comm,PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite matrix");
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+        break;
+      }
+      alpha = gamma/delta;
+      for (k=0; k<nb; k++) {
+        xc[k] += alpha*pc[k];
+        rc[k] -= alpha*wc[k];
+      }
+      gammanew = KSPSSTEPCGQuadraticForm(nb,G,rc,rc);           /*    gamma <- r'Br    */
+      KSPCheckDot(ksp,gammanew);
+      if (PetscRealPart(gammanew) < 0.0) {
+        if (ksp->errorifnotconverged) SETERRQ(comm,PETSC_ERR_NOT_CONVERGED,"Detected indefinite preconditioner");
+        ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+        break;
+      }
+      beta  = gammanew/gamma;
+      gamma = gammanew;
+      for (k=0; k<nb; k++) pc[k] = rc[k] + beta*pc[k];
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED || ksp->normtype == KSP_NORM_UNPRECONDITIONED) dp = PetscSqrtReal(PetscAbsScalar(KSPSSTEPCGQuadraticForm(nb,Gn,rc,rc)));
+      ksp->its++;
+      ierr = KSPSSTEPCGConverged(ksp,gamma,dp);CHKERRQ(ierr);
+      if (ksp->reason) break;
+      if (ksp->its >= ksp->max_it) {
+        ksp->reason = KSP_DIVERGED_ITS;
+        break;
+      }
+    }
+
+    /* back to the vectors */
+    ierr = VecMAXPY(X,nb,xc,Y);CHKERRQ(ierr);
+    if (ksp->reason) break;
+    ierr = VecSet(R,0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(R,nb,rc,YT);CHKERRQ(ierr);
+    ierr = VecSet(Z,0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(Z,nb,rc,Y);CHKERRQ(ierr);
+    ierr = VecSet(P,0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(P,nb,pc,Y);CHKERRQ(ierr);
+    ierr = VecSet(PT,0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(PT,nb,pc,YT);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_SSTEPCG(KSP ksp,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSStepView_Private(ksp,viewer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_SSTEPCG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP SSTEPCG Options");CHKERRQ(ierr);
+  ierr = KSPSStepSetFromOptions_Private(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPSSTEPCG - s-step (communication-avoiding) preconditioned conjugate gradient method
+
+   Options Database Keys:
++   -ksp_sstep_size <s> - the number of iterations per block
+-   -ksp_sstep_basis <monomial,newton,chebyshev> - the polynomial basis of the blocks
+
+   Level: intermediate
+
+   Notes:
+   Each block of s iterations first builds bases of the Krylov spaces of dimension s+1 and s of the search direction
+   and of the preconditioned residual with 2s-1 applications of the matrix and of the preconditioner without
+   intermediate inner products (the matrix powers kernel). All the inner products of the next s iterations are then
+   obtained from the Gram matrix of the basis, computed with a single global reduction, and the iterations are carried
+   out on the coordinates in the basis. This reduces the number of global reductions per iteration from 2 (KSPCG) to
+   1/s at the cost of about twice the number of matrix-vector products and preconditioner applications. In exact
+   arithmetic the iterates are those of KSPCG.
+
+   The first 2s iterations of each solve are classical CG iterations; the Ritz values of their Lanczos matrix give the
+   shifts of the Newton basis (or the interval of the Chebyshev basis) that keeps the basis well conditioned, see
+   KSPSStepSetBasis().
+
+   Only left preconditioning is supported; the preconditioner must be symmetric positive definite. The natural norm is
+   the default, the preconditioned and unpreconditioned norms need a second Gram matrix in the same reduction.
+
+   References:
++    1. - A. T. Chronopoulos and C. W. Gear, s-step iterative methods for symmetric linear systems, J. Comput. Appl. Math., 1989.
+-    2. - E. Carson, Communication-avoiding Krylov subspace methods in theory and practice, PhD thesis, UC Berkeley, 2015.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPCG, KSPCAGMRES, KSPPIPECG,
+           KSPPIPELCG, KSPSStepSetSize(), KSPSStepSetBasis()
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_SSTEPCG(KSP ksp)
+{
+  KSP_SSTEPCG    *sc;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = PetscNewLog(ksp,&sc);CHKERRQ(ierr);
+  ksp->data = (void*)sc;
+  ierr = KSPSStepCreate_Private(ksp);CHKERRQ(ierr);
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_SSTEPCG;
+  ksp->ops->solve          = KSPSolve_SSTEPCG;
+  ksp->ops->reset          = KSPReset_SSTEPCG;
+  ksp->ops->destroy        = KSPDestroy_SSTEPCG;
+  ksp->ops->view           = KSPView_SSTEPCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_SSTEPCG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,38 @@
+/*
+   Private data structure shared by the s-step Krylov methods KSPSSTEPCG and KSPCAGMRES
+*/
+#if !defined(PETSC_SSTEPIMPL_H)
+#define PETSC_SSTEPIMPL_H
+
+#include <petsc/private/kspimpl.h>
+
+/*
+   The s Krylov vectors of a block are generated with the three term recurrence
+
+      w_{j+1} = (Op w_j - alpha_j w_j - gamma_j w_{j-1})/beta_j,   j = 0,...,s-1
+
+   so that Op [w_0,...,w_{s-1}] = [w_0,...,w_s] B with the (s+1) x s tridiagonal change of basis matrix
+   B(j,j) = alpha_j, B(j+1,j) = beta_j and B(j-1,j) = gamma_j. The coefficients are computed from Ritz values of Op
+   obtained during the first iterations of each solve, which are done with the classical method.
+*/
+typedef struct {
+  PetscInt      s;                     /* number of Krylov vectors generated per block */
+  KSPSStepBasis basis;                 /* polynomial basis of the blocks */
+  PetscScalar   *alpha;                /* coefficients of the recurrence, see above */
+  PetscReal     *beta,*gamma;
+  PetscBool     shifts;                /* the coefficients have been computed for the current solve */
+} KSP_SStep;
+
+/* the data structures of KSPSSTEPCG and KSPCAGMRES begin with a KSP_SStep */
+#define KSPSStepData(ksp) ((KSP_SStep*)(ksp)->data)
+
+PETSC_INTERN PetscErrorCode KSPSStepCreate_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPSStepSetUp_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPSStepReset_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPSStepDestroy_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPSStepSetFromOptions_Private(PetscOptionItems*,KSP);
+PETSC_INTERN PetscErrorCode KSPSStepView_Private(KSP,PetscViewer);
+PETSC_INTERN PetscErrorCode KSPSStepComputeShifts_Private(KSP,PetscInt,const PetscScalar*,PetscInt);
+PETSC_INTERN PetscErrorCode KSPSStepMatPowers_Private(KSP,PetscInt,Vec*,Vec);
+
+#endif
@@ -112,6 +112,9 @@ PetscErrorCode  PCInitializePackage(void)
 
 const char *const KSPCGTypes[]                  = {"SYMMETRIC","HERMITIAN","KSPCGType","KSP_CG_",NULL};
 const char *const KSPGMRESCGSRefinementTypes[]  = {"REFINE_NEVER", "REFINE_IFNEEDED", "REFINE_ALWAYS","KSPGMRESRefinementType","KSP_GMRES_CGS_",NULL};
+const char *const KSPSStepBases[]               = {"MONOMIAL","NEWTON","CHEBYSHEV","KSPSStepBasis","KSP_SSTEP_BASIS_",NULL};
+const char *const KSPIRPrecisions[]             = {"FULL","SINGLE","KSPIRPrecision","KSP_IR_PRECISION_",NULL};
+const char *const KSPBatchMethods[]             = {"BCGS","GMRES","KSPBatchMethod","KSP_BATCH_",NULL};
 const char *const KSPNormTypes_Shifted[]        = {"DEFAULT","NONE","PRECONDITIONED","UNPRECONDITIONED","NATURAL","KSPNormType","KSP_NORM_",NULL};
 const char *const*const KSPNormTypes = KSPNormTypes_Shifted + 1;
 const char *const KSPConvergedReasons_Shifted[] = {"DIVERGED_PC_FAILED","DIVERGED_INDEFINITE_MAT","DIVERGED_NANORINF","DIVERGED_INDEFINITE_PC",
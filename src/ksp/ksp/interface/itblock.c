@@ -0,0 +1,231 @@
+/*
+   Dense kernels shared by the block Krylov methods KSPCG and KSPGMRES use in KSPMatSolve()
+*/
+#include <petsc/private/kspimpl.h>
+#include <petscblaslapack.h>
+
+/*
+   KSPBlockInnerProducts_Private - Computes the small dense matrices G_i = X_i^H Y_i, i = 0,...,n-1, of blocks of vectors stored as MATDENSE with
+   a single MPI_Allreduce()
+
+   The G_i are stored one after the other in G, column major with leading dimension the number of columns of X_i. The nextra entries that follow
+   them must contain local contributions (for example local parts of column norms), they are summed in the same reduction.
+*/
+PetscErrorCode KSPBlockInnerProducts_Private(KSP ksp,PetscInt n,const Mat X[],const Mat Y[],PetscInt nextra,PetscScalar *G)
+{
+  const PetscScalar *x,*y;
+  PetscScalar       one = 1.0,zero = 0.0;
+  PetscInt          i,j,m,kx,ky,ldx,ldy,size = 0;
+  PetscBLASInt      bm,bkx,bky,bldx,bldy;
+  PetscMPIInt       len;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    ierr = MatGetLocalSize(X[i],&m,NULL);CHKERRQ(ierr);
+    ierr = MatGetSize(X[i],NULL,&kx);CHKERRQ(ierr);
+    ierr = MatGetSize(Y[i],NULL,&ky);CHKERRQ(ierr);
+    if (m && kx && ky) {
+      ierr = MatDenseGetLDA(X[i],&ldx);CHKERRQ(ierr);
+      ierr = MatDenseGetLDA(Y[i],&ldy);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(m,&bm);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(kx,&bkx);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(ky,&bky);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(ldx,&bldx);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(ldy,&bldy);CHKERRQ(ierr);
+      ierr = MatDenseGetArrayRead(X[i],&x);CHKERRQ(ierr);
+      ierr = MatDenseGetArrayRead(Y[i],&y);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bkx,&bky,&bm,&one,x,&bldx,y,&bldy,&zero,G+size,&bkx));
+      ierr = MatDenseRestoreArrayRead(Y[i],&y);CHKERRQ(ierr);
+      ierr = MatDenseRestoreArrayRead(X[i],&x);CHKERRQ(ierr);
+      ierr = PetscLogFlops(2.0*m*kx*ky);CHKERRQ(ierr);
+    } else {
+      for (j=0; j<kx*ky; j++) G[size+j] = 0.0;
+    }
+    size += kx*ky;
+  }
+  ierr = PetscMPIIntCast(size+nextra,&len);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,G,len,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPBlockGemm_Private - Computes Y = beta Y + alpha X C, where C is a small dense matrix with leading dimension ldc
+*/
+PetscErrorCode KSPBlockGemm_Private(PetscScalar alpha,Mat X,const PetscScalar *C,PetscInt ldc,PetscScalar beta,Mat Y)
+{
+  const PetscScalar *x;
+  PetscScalar       *y;
+  PetscInt          m,kx,ky,ldx,ldy;
+  PetscBLASInt      bm,bkx,bky,bldx,bldy,bldc;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(Y,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(X,NULL,&kx);CHKERRQ(ierr);
+  ierr = MatGetSize(Y,NULL,&ky);CHKERRQ(ierr);
+  if (!m || !ky) PetscFunctionReturn(0);
+  if (!kx) {
+    ierr = MatScale(Y,beta);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(Y,&ldy);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(m,&bm);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(kx,&bkx);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ky,&bky);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldx,&bldx);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldy,&bldy);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldc,&bldc);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(Y,&y);CHKERRQ(ierr);
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bm,&bky,&bkx,&alpha,x,&bldx,C,&bldc,&beta,y,&bldy));
+  ierr = MatDenseRestoreArray(Y,&y);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*m*kx*ky);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPBlockOrthonormalize_Private - Given the p x p Gram matrix G = W^H W (or W^H A W) of a block W of p vectors, computes a p x k matrix T and a
+   k x p matrix S (leading dimension lds, may be NULL) such that the k columns of W T are orthonormal (A-orthonormal) and W = (W T) S, up to the directions
+   that are dropped because they are numerically linearly dependent
+
+   The columns of W are first scaled to unit length, their squared norms are d or, if d is NULL, the diagonal of G. A direction is dropped when the
+   corresponding eigenvalue of the scaled Gram matrix is below tol, so k < p signals a (partial) breakdown of the block method. G is overwritten.
+*/
+PetscErrorCode KSPBlockOrthonormalize_Private(PetscInt p,PetscScalar *G,const PetscReal *d,PetscReal tol,PetscInt *k,PetscScalar *T,PetscScalar *S,PetscInt lds)
+{
+  PetscScalar    *work;
+  PetscReal      *scale,*eig,sq;
+  PetscInt       i,j,l;
+  PetscBLASInt   bp,lwork,lierr;
+#if defined(PETSC_USE_COMPLEX)
+  PetscReal      *rwork;
+#endif
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *k = 0;
+  if (!p) PetscFunctionReturn(0);
+  ierr  = PetscBLASIntCast(p,&bp);CHKERRQ(ierr);
+  lwork = 3*bp;
+  ierr  = PetscMalloc3(p,&scale,p,&eig,lwork,&work);CHKERRQ(ierr);
+  for (i=0; i<p; i++) {
+    sq       = d ? d[i] : PetscRealPart(G[i+i*p]);
+    scale[i] = sq > 0.0 ? 1.0/PetscSqrtReal(sq) : 0.0;
+  }
+  for (j=0; j<p; j++) for (i=0; i<p; i++) G[i+j*p] *= scale[i]*scale[j];
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if !defined(PETSC_USE_COMPLEX)
+  PetscStackCallBLAS("LAPACKsyev",LAPACKsyev_("V","U",&bp,G,&bp,eig,work,&lwork,&lierr));
+#else
+  ierr = PetscMalloc1(3*p,&rwork);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKsyev",LAPACKsyev_("V","U",&bp,G,&bp,eig,work,&lwork,rwork,&lierr));
+  ierr = PetscFree(rwork);CHKERRQ(ierr);
+#endif
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (lierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYEV Lapack routine %d",(int)lierr);
+  /* the eigenvalues are in ascending order, keep the largest first */
+  for (l=p-1; l>=0 && eig[l] > tol; l--) {
+    sq = PetscSqrtReal(eig[l]);
+    for (i=0; i<p; i++) {
+      T[i+*k*p]   = scale[i]*G[i+l*p]/sq;
+      if (S) S[*k+i*lds] = scale[i] > 0.0 ? sq*PetscConj(G[i+l*p])/scale[i] : 0.0;
+    }
+    (*k)++;
+  }
+  ierr = PetscFree3(scale,eig,work);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPBlockConverged_Private - Convergence test of the block methods: column j has converged when rnorm[j] <= max(rtol*rnorm0[j],abstol), that is
+   relative to the initial residual of each column
+
+   Sets ksp->rnorm to the largest residual norm, logs it and calls the monitors with it, and sets ksp->reason once all the columns have
+   converged, one diverges, or the maximum number of iterations is reached
+*/
+PetscErrorCode KSPBlockConverged_Private(KSP ksp,PetscInt k,const PetscReal rnorm[],const PetscReal rnorm0[],PetscBool converged[])
+{
+  PetscReal      rmax = 0.0;
+  PetscInt       j,nconv = 0;
+  PetscBool      atol = PETSC_TRUE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (j=0; j<k; j++) {
+    rmax         = PetscMax(rmax,rnorm[j]);
+    converged[j] = PETSC_FALSE;
+    if (ksp->normtype == KSP_NORM_NONE) continue;
+    if (PetscIsInfOrNanReal(rnorm[j])) {
+      ksp->reason = KSP_DIVERGED_NANORINF;
+      rmax        = rnorm[j];
+    } else if (rnorm[j] <= PetscMax(ksp->rtol*rnorm0[j],ksp->abstol)) {
+      converged[j] = PETSC_TRUE;
+      if (rnorm[j] >= ksp->abstol) atol = PETSC_FALSE;
+      nconv++;
+    } else if (rnorm[j] >= ksp->divtol*rnorm0[j]) {
+      ksp->reason = KSP_DIVERGED_DTOL;
+    }
+  }
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = rmax;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,rmax);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,rmax);CHKERRQ(ierr);
+  if (ksp->reason) {
+    ierr = PetscInfo2(ksp,"Block method %s at iteration %D\n",KSPConvergedReasons[ksp->reason],ksp->its);CHKERRQ(ierr);
+  } else if (k && nconv == k) {
+    ksp->reason = atol ? KSP_CONVERGED_ATOL : KSP_CONVERGED_RTOL;
+    ierr = PetscInfo2(ksp,"All %D columns have converged at iteration %D\n",k,ksp->its);CHKERRQ(ierr);
+  } else if (ksp->its >= ksp->max_it) {
+    ksp->reason = ksp->normtype == KSP_NORM_NONE ? KSP_CONVERGED_ITS : KSP_DIVERGED_ITS;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPBlockDeflate_Private - Removes the columns j < k with del[j] set from the active columns of a block method: they are copied from Xa, which holds
+   the active columns of the solution, to the columns idx[j] of X, and the remaining active columns of Xa, of the n blocks M, of idx, and of r (if
+   not NULL) are shifted to the front. On output k is the number of remaining active columns.
+*/
+PetscErrorCode KSPBlockDeflate_Private(PetscInt *k,const PetscBool del[],PetscInt idx[],PetscReal r[],Mat Xa,Mat X,PetscInt n,Mat M[])
+{
+  PetscScalar    *xa,*x,*v;
+  PetscInt       i,j,l,m,lda,ldx,nk = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(Xa,&m,NULL);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(Xa,&lda);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(Xa,&xa);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(X,&x);CHKERRQ(ierr);
+  for (j=0; j<*k; j++) {
+    if (del[j]) {
+      ierr = PetscArraycpy(x+idx[j]*ldx,xa+j*lda,m);CHKERRQ(ierr);
+    } else {
+      if (nk != j) {
+        ierr = PetscArraycpy(xa+nk*lda,xa+j*lda,m);CHKERRQ(ierr);
+        idx[nk] = idx[j];
+        if (r) r[nk] = r[j];
+      }
+      nk++;
+    }
+  }
+  ierr = MatDenseRestoreArray(X,&x);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(Xa,&xa);CHKERRQ(ierr);
+  for (i=0; i<n && nk < *k; i++) {
+    ierr = MatDenseGetLDA(M[i],&lda);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(M[i],&v);CHKERRQ(ierr);
+    for (j=0,l=0; j<*k; j++) {
+      if (del[j]) continue;
+      if (l != j) {ierr = PetscArraycpy(v+l*lda,v+j*lda,m);CHKERRQ(ierr);}
+      l++;
+    }
+    ierr = MatDenseRestoreArray(M[i],&v);CHKERRQ(ierr);
+  }
+  *k = nk;
+  PetscFunctionReturn(0);
+}
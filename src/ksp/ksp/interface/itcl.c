@@ -487,6 +487,19 @@ PetscErrorCode  KSPSetFromOptions(KSP ksp)
     ierr = KSPSetLagNorm(ksp,flag);CHKERRQ(ierr);
   }
 
+  ierr = PetscOptionsBool("-ksp_batch_reductions","Merge the reductions of each iteration into one MPI_Allreduce()","KSPSetBatchReductions",ksp->batchreductions,&flag,&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = KSPSetBatchReductions(ksp,flag);CHKERRQ(ierr);
+  }
+
+  nmax = ksp->chknormevery;
+  flag = ksp->chknormpredict;
+  ierr = PetscOptionsInt("-ksp_check_norm_every","Compute the residual norm only every k iterations","KSPSetCheckNormEvery",nmax,&nmax,&flg);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-ksp_check_norm_predict","Compute the residual norm earlier when convergence is predicted","KSPSetCheckNormEvery",flag,&flag,&set);CHKERRQ(ierr);
+  if (flg || set) {
+    ierr = KSPSetCheckNormEvery(ksp,nmax,flag);CHKERRQ(ierr);
+  }
+
   ierr = KSPGetDiagonalScale(ksp,&flag);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-ksp_diagonal_scale","Diagonal scale matrix before building preconditioner","KSPSetDiagonalScale",flag,&flag,&flg);CHKERRQ(ierr);
   if (flg) {
@@ -365,6 +365,130 @@ PetscErrorCode  KSPSetLagNorm(KSP ksp,PetscBool flg)
   PetscFunctionReturn(0);
 }
 
+/*@
+   KSPSetBatchReductions - Merges the independent global reductions (inner products and norms) of each iteration
+   into a single MPI_Allreduce(), started with MPI_Iallreduce() when available, so that it may overlap other work.
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - Krylov solver context
+-  flg - PETSC_TRUE or PETSC_FALSE
+
+   Options Database Keys:
+.  -ksp_batch_reductions - batch the reductions of each iteration
+
+   Notes:
+   Currently used by KSPCG, KSPBCGS and the classical Gram-Schmidt orthogonalization of KSPGMRES (and the methods
+   that share it, such as KSPFGMRES and KSPLGMRES). The reductions are queued with VecDotBegin(), VecNormBegin() and
+   VecMDotBegin() and completed together, see PetscCommSplitReductionBegin().
+
+   Batching does not change the computed iterates in exact arithmetic. Some methods may perform a little additional
+   local work, for example KSPCG with KSP_NORM_UNPRECONDITIONED applies the preconditioner before the convergence
+   test so that the residual norm and the next inner product share one reduction.
+
+   Level: advanced
+
+.seealso: KSPSetLagNorm(), KSPGetBatchReductions(), VecNormBegin(), VecDotBegin(), PetscCommSplitReductionBegin()
+@*/
+PetscErrorCode  KSPSetBatchReductions(KSP ksp,PetscBool flg)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveBool(ksp,flg,2);
+  ksp->batchreductions = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGetBatchReductions - Determines if the independent global reductions of each iteration are merged
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - Krylov solver context
+
+   Output Parameter:
+.  flg - PETSC_TRUE if the reductions are batched
+
+   Level: advanced
+
+.seealso: KSPSetBatchReductions()
+@*/
+PetscErrorCode  KSPGetBatchReductions(KSP ksp,PetscBool *flg)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidBoolPointer(flg,2);
+  *flg = ksp->batchreductions;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSetCheckNormEvery - Computes the residual norm, and runs the convergence test, only every few iterations
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp     - Krylov solver context
+.  k       - number of iterations between two computations of the norm, 1 computes it at every iteration
+-  predict - check earlier when the convergence rate observed between the last two checks predicts convergence before the next one
+
+   Options Database Keys:
++  -ksp_check_norm_every <k> - number of iterations between two checks
+-  -ksp_check_norm_predict - check earlier when convergence is predicted
+
+   Notes:
+   Currently only works with KSPCG and KSPBCGS, for which the residual norm costs a global reduction of its own. The
+   norm is then computed together with the inner product of the next iteration, as with KSPSetBatchReductions(). The
+   iterations that skip the norm are neither monitored nor tested, the norm is always computed at the last iteration
+   allowed by KSPSetTolerances(), so that the solver only stops on a norm of the final iterate.
+
+   The method may perform up to k-1 iterations more than needed; with predict, the norm is computed at the iteration at
+   which the geometric mean of the reduction factors since the previous check reaches the tolerance of
+   KSPConvergedDefault(), if that comes sooner.
+
+   Level: advanced
+
+.seealso: KSPSetCheckNormIteration(), KSPSetBatchReductions(), KSPSetLagNorm(), KSPGetCheckNormEvery()
+@*/
+PetscErrorCode  KSPSetCheckNormEvery(KSP ksp,PetscInt k,PetscBool predict)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,k,2);
+  PetscValidLogicalCollectiveBool(ksp,predict,3);
+  if (k < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of iterations between two checks %D must be positive",k);
+  ksp->chknormevery   = k;
+  ksp->chknormpredict = predict;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGetCheckNormEvery - Gets the number of iterations between two computations of the residual norm
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - Krylov solver context
+
+   Output Parameters:
++  k       - number of iterations between two computations of the norm
+-  predict - PETSC_TRUE if the norm is computed earlier when convergence is predicted
+
+   Level: advanced
+
+.seealso: KSPSetCheckNormEvery()
+@*/
+PetscErrorCode  KSPGetCheckNormEvery(KSP ksp,PetscInt *k,PetscBool *predict)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  if (k) *k = ksp->chknormevery;
+  if (predict) *predict = ksp->chknormpredict;
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPSetSupportedNorm - Sets a norm and preconditioner side supported by a KSP
 
@@ -707,6 +831,7 @@ PetscErrorCode  KSPCreate(MPI_Comm comm,KSP *inksp)
   ksp->divtol  = 1.e4;
 
   ksp->chknorm        = -1;
+  ksp->chknormevery   = 1;
   ksp->normtype       = ksp->normtype_set = KSP_NORM_DEFAULT;
   ksp->rnorm          = 0.0;
   ksp->its            = 0;
@@ -1403,6 +1403,33 @@ PetscErrorCode  KSPConvergedDefault(KSP ksp,PetscInt n,PetscReal rnorm,KSPConver
   PetscFunctionReturn(0);
 }
 
+/*
+   KSPCheckNormSchedule_Private - Records the residual norm rnorm computed at iteration it and chooses the next iteration at
+   which it is computed, see KSPSetCheckNormEvery(). With prediction the mean reduction factor per iteration since the previous
+   check gives the number of iterations needed to reach ksp->ttol, which KSPConvergedDefault() sets at iteration 0.
+*/
+PetscErrorCode KSPCheckNormSchedule_Private(KSP ksp,PetscInt it,PetscReal rnorm)
+{
+  PetscInt       step = ksp->chknormevery;
+  PetscReal      rate;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ksp->chknormpredict && it > ksp->chknormlast && ksp->chknormlast >= 0 && ksp->ttol > 0.0 && rnorm > ksp->ttol && rnorm < ksp->chknormlastnorm) {
+    rate = PetscPowReal(rnorm/ksp->chknormlastnorm,1.0/(it-ksp->chknormlast));
+    if (rate < 1.0) {
+      PetscReal pred = PetscLogReal(ksp->ttol/rnorm)/PetscLogReal(rate);
+
+      if (pred < step) step = PetscMax(1,(PetscInt)PetscCeilReal(pred));
+    }
+  }
+  ksp->chknormlast     = it;
+  ksp->chknormlastnorm = rnorm;
+  ksp->chknormnext     = it+step;
+  if (step > 1) {ierr = PetscInfo2(ksp,"Next residual norm at iteration %D, %D iterations from now\n",it+step,step);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 /*@C
    KSPConvergedDefaultDestroy - Frees the space used by the KSPConvergedDefault() function context
 
@@ -1182,9 +1182,11 @@ static PetscErrorCode KSPViewFinalMatResidual_Internal(KSP ksp, Mat B, Mat X, Pe
    Notes:
      This is a stripped-down version of KSPSolve(), which only handles -ksp_view, -ksp_converged_reason, and -ksp_view_final_residual.
 
+     KSPCG, KSPGMRES, and KSPHPDDM use block methods, even for a single right-hand side; other types are solved column by column with KSPSolve().
+
    Level: intermediate
 
-.seealso:  KSPSolve(), MatMatSolve(), MATDENSE, KSPHPDDM, PCBJACOBI, PCASM
+.seealso:  KSPSolve(), MatMatSolve(), MATDENSE, KSPCG, KSPGMRES, KSPHPDDM, PCBJACOBI, PCASM
 @*/
 PetscErrorCode KSPMatSolve(KSP ksp, Mat B, Mat X)
 {
@@ -9,6 +9,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_PIPECGRR(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPELCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPEPRCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPECG2(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_SSTEPCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_CGNE(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_NASH(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_STCG(KSP);
@@ -33,6 +34,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_QCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_BiCG(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_FGMRES(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PIPEFGMRES(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_CAGMRES(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_MINRES(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_SYMMLQ(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_LGMRES(KSP);
@@ -44,6 +46,11 @@ PETSC_EXTERN PetscErrorCode KSPCreate_PGMRES(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_DGMRES(KSP);
 #endif
 PETSC_EXTERN PetscErrorCode KSPCreate_TSIRM(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_IR(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_DEFCG(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_ECG(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_Batch(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_CGLS(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_FETIDP(KSP);
 #if defined(PETSC_HAVE_HPDDM)
@@ -72,6 +79,7 @@ PetscErrorCode KSPRegisterAll(void)
   ierr = KSPRegister(KSPPIPELCG,     KSPCreate_PIPELCG);CHKERRQ(ierr);
   ierr = KSPRegister(KSPPIPEPRCG,    KSPCreate_PIPEPRCG);CHKERRQ(ierr);
   ierr = KSPRegister(KSPPIPECG2,     KSPCreate_PIPECG2);CHKERRQ(ierr);
+  ierr = KSPRegister(KSPSSTEPCG,     KSPCreate_SSTEPCG);CHKERRQ(ierr);
   ierr = KSPRegister(KSPCGNE,        KSPCreate_CGNE);CHKERRQ(ierr);
   ierr = KSPRegister(KSPNASH,        KSPCreate_NASH);CHKERRQ(ierr);
   ierr = KSPRegister(KSPSTCG,        KSPCreate_STCG);CHKERRQ(ierr);
@@ -98,6 +106,7 @@ PetscErrorCode KSPRegisterAll(void)
   ierr = KSPRegister(KSPBICG,        KSPCreate_BiCG);CHKERRQ(ierr);
   ierr = KSPRegister(KSPFGMRES,      KSPCreate_FGMRES);CHKERRQ(ierr);
   ierr = KSPRegister(KSPPIPEFGMRES,  KSPCreate_PIPEFGMRES);CHKERRQ(ierr);
+  ierr = KSPRegister(KSPCAGMRES,     KSPCreate_CAGMRES);CHKERRQ(ierr);
   ierr = KSPRegister(KSPMINRES,      KSPCreate_MINRES);CHKERRQ(ierr);
   ierr = KSPRegister(KSPSYMMLQ,      KSPCreate_SYMMLQ);CHKERRQ(ierr);
   ierr = KSPRegister(KSPLGMRES,      KSPCreate_LGMRES);CHKERRQ(ierr);
@@ -109,6 +118,11 @@ PetscErrorCode KSPRegisterAll(void)
   ierr = KSPRegister(KSPDGMRES,      KSPCreate_DGMRES);CHKERRQ(ierr);
 #endif
   ierr = KSPRegister(KSPTSIRM,       KSPCreate_TSIRM);CHKERRQ(ierr);
+  ierr = KSPRegister(KSPIR,          KSPCreate_IR);CHKERRQ(ierr);
+  ierr = KSPRegister(KSPGCRODR,      KSPCreate_GCRODR);CHKERRQ(ierr);
+  ierr = KSPRegister(KSPDEFCG,       KSPCreate_DEFCG);CHKERRQ(ierr);
+  ierr = KSPRegister(KSPECG,         KSPCreate_ECG);CHKERRQ(ierr);
+  ierr = KSPRegister(KSPBATCH,       KSPCreate_Batch);CHKERRQ(ierr);
   ierr = KSPRegister(KSPCGLS,        KSPCreate_CGLS);CHKERRQ(ierr);
   ierr = KSPRegister(KSPFETIDP,      KSPCreate_FETIDP);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_HPDDM)
@@ -0,0 +1,136 @@
+
+static char help[] = "Tests KSPMatSolve() with the block methods of KSPCG and KSPGMRES.\n\
+  -m <m>       : the grid is m x m\n\
+  -N <N>       : number of right-hand sides\n\
+  -beta <beta> : convection coefficient, makes the operator nonsymmetric\n\
+  -dependent   : the last right-hand side is a combination of the first two\n\n";
+
+#include <petscksp.h>
+
+int main(int argc,char **args)
+{
+  Mat                A,B,X,R;
+  KSP                ksp;
+  Vec                b,x;
+  PetscRandom        rand;
+  PetscReal          beta = 0.0,*norms,*bnorms,rmax = 0.0;
+  PetscInt           m = 16,N = 6,i,j,Istart,Iend,its,itsmax = 0;
+  PetscBool          dependent = PETSC_FALSE;
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-N",&N,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-beta",&beta,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-dependent",&dependent,NULL);CHKERRQ(ierr);
+
+  /* five point Laplacian with an optional upwind convection term in the x direction */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (i=Istart; i<Iend; i++) {
+    PetscInt row = i/m,col = i%m;
+    if (row > 0)   {ierr = MatSetValue(A,i,i-m,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (row < m-1) {ierr = MatSetValue(A,i,i+m,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (col > 0)   {ierr = MatSetValue(A,i,i-1,-1.0-beta,INSERT_VALUES);CHKERRQ(ierr);}
+    if (col < m-1) {ierr = MatSetValue(A,i,i+1,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,i,i,4.0+beta,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateDense(PETSC_COMM_WORLD,Iend-Istart,PETSC_DECIDE,m*m,N,NULL,&B);CHKERRQ(ierr);
+  ierr = MatCreateDense(PETSC_COMM_WORLD,Iend-Istart,PETSC_DECIDE,m*m,N,NULL,&X);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = MatSetRandom(B,rand);CHKERRQ(ierr);
+  if (dependent && N > 2) {
+    Vec b0,b1;
+
+    ierr = MatDenseGetColumnVecRead(B,0,&b0);CHKERRQ(ierr);
+    ierr = VecDuplicate(b0,&b1);CHKERRQ(ierr);
+    ierr = VecCopy(b0,b1);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecRead(B,0,&b0);CHKERRQ(ierr);
+    ierr = MatDenseGetColumnVecRead(B,1,&b0);CHKERRQ(ierr);
+    ierr = VecAXPY(b1,2.0,b0);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecRead(B,1,&b0);CHKERRQ(ierr);
+    ierr = MatDenseGetColumnVecWrite(B,N-1,&b0);CHKERRQ(ierr);
+    ierr = VecCopy(b1,b0);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecWrite(B,N-1,&b0);CHKERRQ(ierr);
+    ierr = VecDestroy(&b1);CHKERRQ(ierr);
+  }
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPMatSolve(ksp,B,X);CHKERRQ(ierr);
+  ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"KSPMatSolve() %s\n",reason > 0 ? "converged" : "did not converge");CHKERRQ(ierr);
+
+  /* check the true residuals */
+  ierr = MatMatMult(A,X,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&R);CHKERRQ(ierr);
+  ierr = MatAYPX(R,-1.0,B,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = PetscMalloc2(N,&norms,N,&bnorms);CHKERRQ(ierr);
+  ierr = MatGetColumnNorms(R,NORM_2,norms);CHKERRQ(ierr);
+  ierr = MatGetColumnNorms(B,NORM_2,bnorms);CHKERRQ(ierr);
+  for (j=0; j<N; j++) rmax = PetscMax(rmax,norms[j]/bnorms[j]);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Largest relative residual %s\n",rmax < 1.e-6 ? "< 1e-6" : "too large");CHKERRQ(ierr);
+
+  /* the block method must not need more iterations than the worst column solved alone */
+  for (j=0; j<N; j++) {
+    ierr = MatDenseGetColumnVecRead(B,j,&b);CHKERRQ(ierr);
+    ierr = MatDenseGetColumnVecWrite(X,j,&x);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecWrite(X,j,&x);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecRead(B,j,&b);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp,&i);CHKERRQ(ierr);
+    itsmax = PetscMax(itsmax,i);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Block iterations %s single right-hand side iterations\n",its <= itsmax ? "<=" : ">");CHKERRQ(ierr);
+
+  ierr = PetscFree2(norms,bnorms);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = MatDestroy(&X);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex62_1.out
+      args: -pc_type jacobi
+      test:
+         suffix: cg
+         args: -ksp_type cg
+      test:
+         suffix: cg_2
+         nsize: 2
+         args: -ksp_type cg -N 8 -ksp_matsolve_batch_size 5 -ksp_norm_type {{preconditioned unpreconditioned natural}}
+      test:
+         suffix: cg_single
+         args: -ksp_type cg -N 1
+      test:
+         suffix: cg_dependent
+         args: -ksp_type cg -dependent
+      test:
+         suffix: gmres
+         args: -ksp_type gmres -beta 0.5 -ksp_pc_side {{left right}} -ksp_gmres_restart {{8 30}}
+      test:
+         suffix: gmres_2
+         nsize: 2
+         args: -ksp_type gmres -beta 0.5 -N 8 -ksp_matsolve_batch_size 5 -ksp_gmres_restart 5
+      test:
+         suffix: gmres_single
+         args: -ksp_type gmres -beta 0.5 -N 1
+      test:
+         suffix: gmres_dependent
+         args: -ksp_type gmres -beta 0.5 -dependent
+
+TEST*/
@@ -0,0 +1,99 @@
+static char help[] = "Tests KSPIR on an operator whose entries are not representable in single precision.\n\
+  -m <m> : the grid is m x m\n\n";
+
+#include <petscksp.h>
+
+/* Solves with the given inner precision and at most maxit refinement steps, from a zero initial guess */
+static PetscErrorCode Solve(KSP ksp,KSPIRPrecision precision,PetscInt maxit,Vec b,Vec x,PetscInt *its)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = KSPIRSetInnerPrecision(ksp,precision);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-12,PETSC_DEFAULT,PETSC_DEFAULT,maxit);CHKERRQ(ierr);
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  ierr = KSPGetIterationNumber(ksp,its);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            x,xs,b,u;
+  KSP            ksp;
+  KSPIRPrecision precision;
+  PetscReal      norm,diff;
+  PetscInt       m = 16,i,Istart,Iend,its,maxit;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+
+  /* anisotropic five point operator with coefficients 1/3 and 2/3 */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (i=Istart; i<Iend; i++) {
+    PetscInt row = i/m,col = i%m;
+    if (row > 0)   {ierr = MatSetValue(A,i,i-m,-1.0/3.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (row < m-1) {ierr = MatSetValue(A,i,i+m,-1.0/3.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (col > 0)   {ierr = MatSetValue(A,i,i-1,-2.0/3.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (col < m-1) {ierr = MatSetValue(A,i,i+1,-2.0/3.0,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,i,i,2.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&xs);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&u);CHKERRQ(ierr);
+  ierr = VecSet(u,1.0);CHKERRQ(ierr);
+  ierr = MatMult(A,u,b);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetType(ksp,KSPIR);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPGetTolerances(ksp,NULL,NULL,NULL,&maxit);CHKERRQ(ierr);
+
+  /* a single refinement step shows whether the inner solve ran with single precision ghost values */
+  ierr = Solve(ksp,KSP_IR_PRECISION_FULL,1,b,x,&its);CHKERRQ(ierr);
+  ierr = Solve(ksp,KSP_IR_PRECISION_SINGLE,1,b,xs,&its);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecAXPY(xs,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(xs,NORM_2,&diff);CHKERRQ(ierr);
+  diff /= norm;
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"First correction with single precision communication: %s\n",diff == 0.0 ? "identical" : (diff > 1.e-12 && diff < 1.e-5 ? "differs by single precision rounding" : "differs too much"));CHKERRQ(ierr);
+
+  /* the outer iteration reaches the same accuracy with both inner precisions */
+  for (precision=KSP_IR_PRECISION_FULL; precision<=KSP_IR_PRECISION_SINGLE; precision=(KSPIRPrecision)(precision+1)) {
+    ierr = Solve(ksp,precision,maxit,b,x,&its);CHKERRQ(ierr);
+    ierr = VecAXPY(x,-1.0,u);CHKERRQ(ierr);
+    ierr = VecNorm(x,NORM_2,&norm);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Inner precision %s: norm of error %s, refinement steps %D\n",KSPIRPrecisions[precision],norm < 1.e-10 ? "< 1e-10" : "too large",its);CHKERRQ(ierr);
+  }
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&u);CHKERRQ(ierr);
+  ierr = VecDestroy(&xs);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      requires: double
+      args: -ir_ksp_type gmres -ir_pc_type jacobi
+      test:
+         suffix: 1
+         nsize: 2
+      test:
+         suffix: seq
+      test:
+         suffix: gamg
+         nsize: 2
+         args: -ir_ksp_type cg -ir_pc_type gamg -ir_ksp_rtol 1e-3 -ksp_monitor_short
+
+TEST*/
@@ -0,0 +1,127 @@
+
+static char help[] = "Solves a sequence of slowly changing linear systems with the recycling solvers KSPGCRODR and KSPDEFCG.\n\
+  -m <m>       : the grid is m x m\n\
+  -nsys <n>    : number of systems in the sequence\n\
+  -beta <beta> : convection coefficient, makes the operator nonsymmetric\n\n";
+
+#include <petscksp.h>
+
+/* five point Laplacian with an upwind convection term and a reaction term that grows along the sequence */
+static PetscErrorCode FormOperator(Mat A,PetscInt m,PetscReal beta,PetscInt t)
+{
+  PetscInt       i,Istart,Iend;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (i=Istart; i<Iend; i++) {
+    PetscInt  row = i/m,col = i%m;
+    PetscReal c = 0.002*t*(1.0+PetscSinReal(0.1*row)*PetscSinReal(0.1*col));
+
+    if (row > 0)   {ierr = MatSetValue(A,i,i-m,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (row < m-1) {ierr = MatSetValue(A,i,i+m,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (col > 0)   {ierr = MatSetValue(A,i,i-1,-1.0-beta,INSERT_VALUES);CHKERRQ(ierr);}
+    if (col < m-1) {ierr = MatSetValue(A,i,i+1,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,i,i,4.0+beta+c,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode FormRHS(Vec b,PetscInt t)
+{
+  PetscInt       i,Istart,Iend;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecGetOwnershipRange(b,&Istart,&Iend);CHKERRQ(ierr);
+  for (i=Istart; i<Iend; i++) {ierr = VecSetValue(b,i,1.0+PetscSinReal(0.37*i+0.5*t),INSERT_VALUES);CHKERRQ(ierr);}
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat                A;
+  KSP                ksp[2];
+  Vec                b,x,r;
+  PetscReal          beta = 0.0,rnorm,bnorm;
+  PetscInt           m = 32,nsys = 6,t,j,its,total[2] = {0,0};
+  PetscBool          view = PETSC_FALSE;
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsys",&nsys,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-beta",&beta,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view_iterations",&view,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+
+  /* the second solver is the same method without recycling */
+  for (j=0; j<2; j++) {
+    ierr = KSPCreate(PETSC_COMM_WORLD,&ksp[j]);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp[j],A,A);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp[j]);CHKERRQ(ierr);
+  }
+  ierr = KSPGCRODRSetRecycleSize(ksp[1],0);CHKERRQ(ierr);
+  ierr = KSPDEFCGSetRecycleSize(ksp[1],0,0);CHKERRQ(ierr);
+
+  for (t=0; t<nsys; t++) {
+    ierr = FormOperator(A,m,beta,t);CHKERRQ(ierr);
+    ierr = FormRHS(b,t);CHKERRQ(ierr);
+    for (j=0; j<2; j++) {
+      ierr = VecSet(x,0.0);CHKERRQ(ierr);
+      ierr = KSPSolve(ksp[j],b,x);CHKERRQ(ierr);
+      ierr = KSPGetConvergedReason(ksp[j],&reason);CHKERRQ(ierr);
+      if (reason < 0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D: %s\n",t,KSPConvergedReasons[reason]);CHKERRQ(ierr);}
+      ierr = MatMult(A,x,r);CHKERRQ(ierr);
+      ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+      ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+      ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+      if (rnorm > 1.e-4*bnorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D: relative residual %g too large\n",t,(double)(rnorm/bnorm));CHKERRQ(ierr);}
+      ierr = KSPGetIterationNumber(ksp[j],&its);CHKERRQ(ierr);
+      if (view) {ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D %s recycling: %D iterations\n",t,j ? "without" : "with",its);CHKERRQ(ierr);}
+      if (t) total[j] += its;
+    }
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Systems after the first one need %s iterations with recycling\n",total[0] < total[1] ? "fewer" : "more");CHKERRQ(ierr);
+
+  for (j=0; j<2; j++) {ierr = KSPDestroy(&ksp[j]);CHKERRQ(ierr);}
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex65_1.out
+      test:
+         suffix: gcrodr
+         nsize: {{1 2}}
+         args: -ksp_type gcrodr -beta 0.3 -pc_type jacobi -ksp_pc_side {{left right}}
+      test:
+         suffix: defcg
+         nsize: {{1 2}}
+         args: -ksp_type defcg -pc_type jacobi -ksp_norm_type {{preconditioned unpreconditioned natural}}
+      test:
+         suffix: gcrodr_adaptive
+         nsize: {{1 2}}
+         args: -ksp_type gcrodr -beta 0.3 -pc_type jacobi -ksp_pc_side {{left right}} -ksp_gcrodr_adaptive -ksp_gcrodr_memory_budget {{40 71}}
+
+   test:
+      suffix: gcrodr_adaptive_its
+      nsize: {{1 3}}
+      args: -ksp_type gcrodr -beta 0.3 -pc_type jacobi -ksp_gcrodr_adaptive -ksp_gcrodr_memory_budget 40 -view_iterations
+      output_file: output/ex65_gcrodr_adaptive_its.out
+
+TEST*/
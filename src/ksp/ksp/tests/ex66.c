@@ -0,0 +1,134 @@
+
+static char help[] = "Tests the fused kernel and the reuse of the eigenvalue estimates of KSPCHEBYSHEV.\n\
+  -m <m>       : the grid is m x m\n\
+  -bs <bs>     : number of coupled unknowns per grid point\n\
+  -nsys <n>    : number of systems in the sequence\n\
+  -nullspace   : attach a constant null space to the operator, the fused kernel is then not used\n\n";
+
+#include <petscksp.h>
+
+/* five point Laplacian for each of the bs components coupled at each grid point, with a shift that grows slowly along the sequence */
+static PetscErrorCode FormOperator(Mat A,PetscInt m,PetscInt bs,PetscInt t)
+{
+  PetscInt       i,c,d,Istart,Iend;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (i=Istart/bs; i<Iend/bs; i++) {
+    PetscInt row = i/m,col = i%m;
+
+    for (c=0; c<bs; c++) {
+      PetscInt r = i*bs+c;
+
+      if (row > 0)   {ierr = MatSetValue(A,r,r-m*bs,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      if (row < m-1) {ierr = MatSetValue(A,r,r+m*bs,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      if (col > 0)   {ierr = MatSetValue(A,r,r-bs,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      if (col < m-1) {ierr = MatSetValue(A,r,r+bs,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      for (d=0; d<bs; d++) {ierr = MatSetValue(A,r,i*bs+d,d == c ? 4.0+0.01*t*(1.0+c) : 0.5,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* counts the eigenvalue estimates, each one starts with iteration 0 of the estimator */
+static PetscErrorCode CountEstimates(KSP kspest,PetscInt it,PetscReal rnorm,void *ctx)
+{
+  PetscFunctionBeginUser;
+  if (!it) (*(PetscInt*)ctx)++;
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  KSP            ksp[2],kspest;
+  Vec            b,x[2];
+  PetscReal      norm,diff,dmax = 0.0;
+  PetscInt       m = 16,bs = 1,nsys = 4,t,j,nest = 0;
+  PetscBool      nullspace = PETSC_FALSE;
+  MatNullSpace   nsp;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-bs",&bs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsys",&nsys,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-nullspace",&nullspace,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*m*bs,m*m*bs);CHKERRQ(ierr);
+  ierr = MatSetBlockSize(A,bs);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,4+bs,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,4+bs,NULL,2,NULL);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x[0],&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x[0],&x[1]);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+  if (nullspace) {
+    ierr = MatNullSpaceCreate(PETSC_COMM_WORLD,PETSC_TRUE,0,NULL,&nsp);CHKERRQ(ierr);
+    ierr = MatSetNullSpace(A,nsp);CHKERRQ(ierr);
+    ierr = MatNullSpaceDestroy(&nsp);CHKERRQ(ierr);
+  }
+
+  /* the first solver uses the fused kernel, the second one computes the same iterates with separate MatMult(), PCApply() and vector operations */
+  for (j=0; j<2; j++) {
+    ierr = KSPCreate(PETSC_COMM_WORLD,&ksp[j]);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp[j],A,A);CHKERRQ(ierr);
+    ierr = KSPSetType(ksp[j],KSPCHEBYSHEV);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp[j],1.e-10,PETSC_DEFAULT,PETSC_DEFAULT,20);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp[j]);CHKERRQ(ierr);
+  }
+  ierr = KSPChebyshevSetFused(ksp[0],PETSC_TRUE);CHKERRQ(ierr);
+  ierr = KSPChebyshevSetFused(ksp[1],PETSC_FALSE);CHKERRQ(ierr);
+  ierr = KSPChebyshevEstEigGetKSP(ksp[0],&kspest);CHKERRQ(ierr);
+  ierr = KSPMonitorSet(kspest,CountEstimates,&nest,NULL);CHKERRQ(ierr);
+
+  for (t=0; t<nsys; t++) {
+    ierr = FormOperator(A,m,bs,t);CHKERRQ(ierr);
+    for (j=0; j<2; j++) {
+      ierr = KSPSetOperators(ksp[j],A,A);CHKERRQ(ierr);
+      ierr = KSPSolve(ksp[j],b,x[j]);CHKERRQ(ierr);
+    }
+    ierr = VecNorm(x[1],NORM_2,&norm);CHKERRQ(ierr);
+    ierr = VecAXPY(x[1],-1.0,x[0]);CHKERRQ(ierr);
+    ierr = VecNorm(x[1],NORM_2,&diff);CHKERRQ(ierr);
+    dmax = PetscMax(dmax,diff/norm);
+  }
+  if (dmax < 1.e-12) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Fused and separate kernels give the same iterates\n");CHKERRQ(ierr);}
+  else {ierr = PetscPrintf(PETSC_COMM_WORLD,"Fused and separate kernels differ by %g\n",(double)dmax);CHKERRQ(ierr);}
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Eigenvalues estimated %D times for %D systems\n",nest,nsys);CHKERRQ(ierr);
+
+  for (j=0; j<2; j++) {
+    ierr = KSPDestroy(&ksp[j]);CHKERRQ(ierr);
+    ierr = VecDestroy(&x[j]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      nsize: {{1 2}}
+      args: -pc_type {{jacobi pbjacobi}} -bs {{1 3}} -ksp_norm_type {{none preconditioned unpreconditioned}}
+      test:
+         suffix: fused
+         output_file: output/ex66_fused.out
+      test:
+         suffix: reuse
+         args: -ksp_chebyshev_esteig_reuse_tol 0.1
+         output_file: output/ex66_reuse.out
+
+   test:
+      suffix: nullspace
+      nsize: 2
+      args: -pc_type jacobi -nullspace
+      output_file: output/ex66_fused.out
+
+TEST*/
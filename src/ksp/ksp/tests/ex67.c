@@ -0,0 +1,115 @@
+
+static char help[] = "Compares KSPECG with KSPCG on a diffusion problem with high contrast coefficients.\n\
+  -m <m>       : the grid is m x m\n\
+  -kappa <k>   : coefficient in the channels, 1 elsewhere\n\n";
+
+#include <petscksp.h>
+
+/* coefficient of the cell (i,j), horizontal channels of high conductivity every 8 cells */
+static PetscReal Coefficient(PetscInt i,PetscInt j,PetscReal kappa)
+{
+  return (j%8 == 3 && i%16 > 1) ? kappa : 1.0;
+}
+
+/* five point finite volume discretization of -div(k grad u) with homogeneous Dirichlet boundary conditions */
+static PetscErrorCode FormOperator(Mat A,PetscInt m,PetscReal kappa)
+{
+  PetscInt       n,Istart,Iend;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (n=Istart; n<Iend; n++) {
+    PetscInt  i = n%m,j = n/m,d;
+    PetscInt  ni[4] = {i-1,i+1,i,i},nj[4] = {j,j,j-1,j+1};
+    PetscReal k = Coefficient(i,j,kappa),diag = 0.0,w;
+
+    for (d=0; d<4; d++) {
+      if (ni[d] < 0 || ni[d] >= m || nj[d] < 0 || nj[d] >= m) w = 2.0*k;
+      else {
+        PetscReal kn = Coefficient(ni[d],nj[d],kappa);
+
+        w    = 2.0*k*kn/(k+kn);
+        ierr = MatSetValue(A,n,nj[d]*m+ni[d],-w,INSERT_VALUES);CHKERRQ(ierr);
+      }
+      diag += w;
+    }
+    ierr = MatSetValue(A,n,n,diag,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat                A;
+  KSP                ksp[2];
+  Vec                b,x,r;
+  PetscReal          kappa = 1.e4,rnorm,bnorm;
+  PetscInt           m = 48,j,its[2];
+  PetscBool          view = PETSC_FALSE;
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-kappa",&kappa,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view_iterations",&view,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = FormOperator(A,m,kappa);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+  ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+
+  /* the second solver is KSPCG with the same preconditioner and tolerances */
+  for (j=0; j<2; j++) {
+    ierr = KSPCreate(PETSC_COMM_WORLD,&ksp[j]);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp[j],A,A);CHKERRQ(ierr);
+    ierr = KSPSetType(ksp[j],KSPECG);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp[j],1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,1000);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp[j]);CHKERRQ(ierr);
+  }
+  ierr = KSPSetType(ksp[1],KSPCG);CHKERRQ(ierr);
+
+  for (j=0; j<2; j++) {
+    ierr = VecSet(x,0.0);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp[j],b,x);CHKERRQ(ierr);
+    ierr = KSPGetConvergedReason(ksp[j],&reason);CHKERRQ(ierr);
+    if (reason < 0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s\n",j ? "KSPCG" : "KSPECG",KSPConvergedReasons[reason]);CHKERRQ(ierr);}
+    ierr = MatMult(A,x,r);CHKERRQ(ierr);
+    ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+    if (rnorm > 1.e-4*bnorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: relative residual %g too large\n",j ? "KSPCG" : "KSPECG",(double)(rnorm/bnorm));CHKERRQ(ierr);}
+    ierr = KSPGetIterationNumber(ksp[j],&its[j]);CHKERRQ(ierr);
+    if (view) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %D iterations\n",j ? "KSPCG" : "KSPECG",its[j]);CHKERRQ(ierr);}
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"KSPECG needs %s iterations than KSPCG\n",its[0] < its[1] ? "fewer" : "more");CHKERRQ(ierr);
+
+  for (j=0; j<2; j++) {ierr = KSPDestroy(&ksp[j]);CHKERRQ(ierr);}
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      nsize: {{1 2}}
+      output_file: output/ex67_1.out
+      test:
+         suffix: jacobi
+         args: -pc_type jacobi -ksp_ecg_enlarging_factor {{4 8}} -ksp_norm_type {{unpreconditioned preconditioned natural}}
+      test:
+         suffix: bjacobi
+         args: -pc_type bjacobi -pc_bjacobi_blocks {{8 16}} -sub_pc_type icc
+      test:
+         suffix: asm
+         args: -pc_type asm -pc_asm_blocks 8 -pc_asm_type basic -sub_pc_type icc
+
+TEST*/
@@ -0,0 +1,121 @@
+
+static char help[] = "Solves many independent small nonsymmetric systems of different sizes with KSPBATCH.\n\
+  -nsys <n>       : number of systems per process\n\
+  -use_section    : describes the systems with KSPBatchSetSection()\n\
+  -use_vbs        : describes the systems with MatSetVariableBlockSizes()\n\n";
+
+#include <petscksp.h>
+#include <petscsection.h>
+
+/* size of the local system s, from 1 to 12 */
+static PetscInt SystemSize(PetscInt s)
+{
+  return 1 + (7*s)%12;
+}
+
+int main(int argc,char **args)
+{
+  Mat                      A;
+  KSP                      ksp;
+  Vec                      b,x,r;
+  PetscSection             section;
+  const KSPConvergedReason *reasons;
+  const PetscInt           *its;
+  const PetscScalar        *ra,*ba;
+  PetscReal                rtol = 1.e-8,rnorm,bnorm;
+  PetscInt                 nsys = 40,n,m = 0,s,i,j,Istart,off,*bsizes,nfailed = 0;
+  PetscBool                usesection = PETSC_FALSE,usevbs = PETSC_FALSE;
+  PetscErrorCode           ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsys",&nsys,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-use_section",&usesection,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-use_vbs",&usevbs,NULL);CHKERRQ(ierr);
+
+  ierr = PetscMalloc1(nsys,&bsizes);CHKERRQ(ierr);
+  for (s=0; s<nsys; s++) {
+    bsizes[s] = SystemSize(s);
+    m        += bsizes[s];
+  }
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,m,m,PETSC_DETERMINE,PETSC_DETERMINE,12,NULL,0,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,NULL);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+
+  /* dense diagonally dominant nonsymmetric blocks, the right-hand side of the system 3 is zero */
+  for (s=0,off=Istart; s<nsys; off+=bsizes[s++]) {
+    n = bsizes[s];
+    for (i=0; i<n; i++) {
+      for (j=0; j<n; j++) {ierr = MatSetValue(A,off+i,off+j,i == j ? 2.0+0.5*n+0.1*s : PetscSinReal(1.3*i+0.7*j+s),INSERT_VALUES);CHKERRQ(ierr);}
+      ierr = VecSetValue(b,off+i,s == 3 ? 0.0 : 1.0+PetscCosReal(0.3*(off+i)),INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+  if (usevbs) {ierr = MatSetVariableBlockSizes(A,nsys,bsizes);CHKERRQ(ierr);}
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetType(ksp,KSPBATCH);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,rtol,PETSC_DEFAULT,PETSC_DEFAULT,200);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  if (usesection) {
+    ierr = PetscSectionCreate(PETSC_COMM_SELF,&section);CHKERRQ(ierr);
+    ierr = PetscSectionSetChart(section,0,nsys);CHKERRQ(ierr);
+    for (s=0; s<nsys; s++) {ierr = PetscSectionSetDof(section,s,bsizes[s]);CHKERRQ(ierr);}
+    ierr = PetscSectionSetUp(section);CHKERRQ(ierr);
+    ierr = KSPBatchSetSection(ksp,section);CHKERRQ(ierr);
+    ierr = PetscSectionDestroy(&section);CHKERRQ(ierr);
+  }
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+
+  /* every system must reach its own relative tolerance, the zero system at iteration 0 */
+  ierr = KSPBatchGetConvergedReasons(ksp,&n,&reasons,&its);CHKERRQ(ierr);
+  if (n != nsys) {ierr = PetscPrintf(PETSC_COMM_SELF,"Found %D systems instead of %D\n",n,nsys);CHKERRQ(ierr);}
+  ierr = MatMult(A,x,r);CHKERRQ(ierr);
+  ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(r,&ra);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(b,&ba);CHKERRQ(ierr);
+  for (s=0,off=0; s<PetscMin(n,nsys); off+=bsizes[s++]) {
+    for (rnorm=0.0,bnorm=0.0,i=off; i<off+bsizes[s]; i++) {
+      rnorm += PetscRealPart(ra[i]*PetscConj(ra[i]));
+      bnorm += PetscRealPart(ba[i]*PetscConj(ba[i]));
+    }
+    if (reasons[s] <= 0 || PetscSqrtReal(rnorm) > 10.0*rtol*PetscSqrtReal(bnorm) || (s == 3 && its[s])) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"System %D: %s after %D iterations, residual %g\n",s,KSPConvergedReasons[reasons[s]],its[s],(double)PetscSqrtReal(rnorm));CHKERRQ(ierr);
+      nfailed++;
+    }
+  }
+  ierr = VecRestoreArrayRead(b,&ba);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(r,&ra);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nfailed,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  if (!nfailed) {ierr = PetscPrintf(PETSC_COMM_WORLD,"All systems converged\n");CHKERRQ(ierr);}
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = PetscFree(bsizes);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      nsize: {{1 2}}
+      output_file: output/ex68_1.out
+      test:
+         suffix: detect
+         args: -ksp_batch_method {{bcgs gmres}} -pc_type {{none jacobi}}
+      test:
+         suffix: section
+         args: -use_section -ksp_batch_method {{bcgs gmres}} -ksp_gmres_restart 4 -pc_type jacobi
+      test:
+         suffix: vbs
+         args: -use_vbs -ksp_batch_method {{bcgs gmres}} -pc_type {{jacobi vpbjacobi}}
+
+TEST*/
@@ -0,0 +1,149 @@
+
+static char help[] = "Solves a sequence of diffusion problems whose coefficient changes with PCGAMG, reusing the interpolations with and without refreshing them.\n\
+  -m <m>       : the grid is m x m\n\
+  -nsys <n>    : number of systems in the sequence\n\
+  -kappa <k>   : growth of the coefficient along the sequence\n\n";
+
+#include <petscksp.h>
+
+/* coefficient of the cell (i,j) for the system t, grows in the right half of the domain */
+static PetscReal Coefficient(PetscInt i,PetscInt j,PetscInt m,PetscInt t,PetscReal kappa)
+{
+  return 1.0 + (2*i >= m ? kappa*t*(1.0 + 0.5*PetscSinReal(0.3*j)) : 0.0);
+}
+
+/* five point finite volume discretization of -div(k grad u) with homogeneous Dirichlet boundary conditions */
+static PetscErrorCode FormOperator(Mat A,PetscInt m,PetscInt t,PetscReal kappa)
+{
+  PetscInt       n,Istart,Iend;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (n=Istart; n<Iend; n++) {
+    PetscInt  i = n%m,j = n/m,d;
+    PetscInt  ni[4] = {i-1,i+1,i,i},nj[4] = {j,j,j-1,j+1};
+    PetscReal k = Coefficient(i,j,m,t,kappa),diag = 0.0,w;
+
+    for (d=0; d<4; d++) {
+      if (ni[d] < 0 || ni[d] >= m || nj[d] < 0 || nj[d] >= m) w = 2.0*k;
+      else {
+        PetscReal kn = Coefficient(ni[d],nj[d],m,t,kappa);
+
+        w    = 2.0*k*kn/(k+kn);
+        ierr = MatSetValue(A,n,nj[d]*m+ni[d],-w,INSERT_VALUES);CHKERRQ(ierr);
+      }
+      diag += w;
+    }
+    ierr = MatSetValue(A,n,n,diag,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat                A;
+  KSP                ksp[2];
+  PC                 pc;
+  Vec                b,x,r;
+  PetscReal          kappa = 20.0,rnorm,bnorm;
+  PetscInt           m = 64,nsys = 5,t,j,its,nfailed = 0;
+  PetscBool          view = PETSC_FALSE;
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsys",&nsys,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-kappa",&kappa,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view_iterations",&view,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_SPD,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+  ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+
+  /* the second solver keeps the interpolations of the first system */
+  for (j=0; j<2; j++) {
+    ierr = KSPCreate(PETSC_COMM_WORLD,&ksp[j]);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp[j],A,A);CHKERRQ(ierr);
+    ierr = KSPSetType(ksp[j],KSPCG);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp[j],1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,500);CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp[j],&pc);CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCGAMG);CHKERRQ(ierr);
+    ierr = PCGAMGSetReuseInterpolation(pc,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp[j]);CHKERRQ(ierr);
+  }
+  ierr = PCGAMGSetRefreshTolerance(pc,-1.0);CHKERRQ(ierr);
+
+  for (t=0; t<nsys; t++) {
+    ierr = FormOperator(A,m,t,kappa);CHKERRQ(ierr);
+    for (j=0; j<2; j++) {
+      ierr = KSPSetOperators(ksp[j],A,A);CHKERRQ(ierr);
+      ierr = VecSet(x,0.0);CHKERRQ(ierr);
+      ierr = KSPSolve(ksp[j],b,x);CHKERRQ(ierr);
+      ierr = KSPGetConvergedReason(ksp[j],&reason);CHKERRQ(ierr);
+      if (reason < 0) {
+        ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D %s refresh: %s\n",t,j ? "without" : "with",KSPConvergedReasons[reason]);CHKERRQ(ierr);
+        nfailed++;
+      }
+      ierr = MatMult(A,x,r);CHKERRQ(ierr);
+      ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+      ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+      if (rnorm > 1.e-4*bnorm) {
+        ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D %s refresh: relative residual %g too large\n",t,j ? "without" : "with",(double)(rnorm/bnorm));CHKERRQ(ierr);
+        nfailed++;
+      }
+      ierr = KSPGetIterationNumber(ksp[j],&its);CHKERRQ(ierr);
+      if (view) {ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D %s refresh: %D iterations\n",t,j ? "without" : "with",its);CHKERRQ(ierr);}
+    }
+  }
+  if (!nfailed) {ierr = PetscPrintf(PETSC_COMM_WORLD,"All systems converged\n");CHKERRQ(ierr);}
+  ierr = KSPGetPC(ksp[0],&pc);CHKERRQ(ierr);
+  ierr = PCViewFromOptions(pc,NULL,"-view_refresh");CHKERRQ(ierr);
+
+  for (j=0; j<2; j++) {ierr = KSPDestroy(&ksp[j]);CHKERRQ(ierr);}
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      nsize: {{1 2}}
+      args: -pc_gamg_refresh_tol {{0 0.1}} -view_refresh
+      filter: grep -E "converged|refreshes" | sed -e "s/.*, //"
+      test:
+         suffix: refresh
+         args: -pc_gamg_use_sa_esteig {{0 1}}
+         output_file: output/ex69_refresh.out
+      test:
+         suffix: refresh_rank_reduction
+         args: -pc_gamg_coarse_eq_limit 100 -pc_gamg_process_eq_limit 200
+         output_file: output/ex69_refresh.out
+      test:
+         suffix: mis2
+         args: -mat_coarsen_type mis2
+         output_file: output/ex69_mis2.out
+
+   test:
+      suffix: refresh_drift
+      nsize: {{1 2}}
+      args: -pc_gamg_refresh_tol 2 -view_refresh
+      filter: grep -E "converged|refreshes" | sed -e "s/.*, //"
+
+   test:
+      suffix: additive_concurrent
+      nsize: 3
+      args: -pc_mg_type additive -pc_mg_additive_concurrent
+      output_file: output/ex69_1.out
+
+TEST*/
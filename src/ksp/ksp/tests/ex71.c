@@ -0,0 +1,130 @@
+
+static char help[] = "Solves a vector diffusion problem with PCGAMG, with the operator stored in AIJ and in BAIJ format.\n\
+  -m <m>       : the grid is m x m x m\n\
+  -nsolves <n> : number of solves, the operator is rescaled between them\n\n";
+
+#include <petscksp.h>
+
+/* three unknowns per node coupled along the edges of the grid, more strongly in the direction of the edge; Dirichlet boundary */
+static PetscErrorCode FormOperator(Mat A,PetscInt m,PetscReal scale)
+{
+  PetscInt       n,nb,Istart,Iend,d,k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (n=Istart/3; n<Iend/3; n++) {
+    PetscInt    c[3] = {n%m,(n/m)%m,n/(m*m)},stride = 1;
+    PetscScalar diag[9] = {0},off[9];
+
+    for (d=0; d<3; d++,stride*=m) {
+      for (k=0; k<9; k++) off[k] = 0.0;
+      for (k=0; k<3; k++) off[4*k] = -scale;
+      off[4*d] = -1.5*scale;
+      for (k=0; k<9; k++) diag[k] -= 2.0*off[k];
+      if (c[d] > 0) {nb = n-stride; ierr = MatSetValuesBlocked(A,1,&n,1,&nb,off,INSERT_VALUES);CHKERRQ(ierr);}
+      if (c[d] < m-1) {nb = n+stride; ierr = MatSetValuesBlocked(A,1,&n,1,&nb,off,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+    ierr = MatSetValuesBlocked(A,1,&n,1,&n,diag,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A[2],B;
+  MatNullSpace   nearnull;
+  KSP            ksp[2],smoother;
+  PC             pc;
+  Vec            coords,b,x;
+  PetscInt       m = 8,nsolves = 2,n,Istart,Iend,i,j,its[2],nlevels;
+  PetscScalar    *c;
+  PetscBool      isbaij;
+  const char     *fmt[2] = {"AIJ","BAIJ"};
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsolves",&nsolves,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,3*m*m*m,3*m*m*m,21,NULL,21,NULL,&A[0]);CHKERRQ(ierr);
+  ierr = MatSetBlockSize(A[0],3);CHKERRQ(ierr);
+  ierr = MatSetOption(A[0],MAT_SPD,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatCreateBAIJ(PETSC_COMM_WORLD,3,PETSC_DECIDE,PETSC_DECIDE,3*m*m*m,3*m*m*m,7,NULL,7,NULL,&A[1]);CHKERRQ(ierr);
+  ierr = MatSetOption(A[1],MAT_SPD,PETSC_TRUE);CHKERRQ(ierr);
+
+  /* the rigid body modes, from the coordinates of the nodes, are the near null space */
+  ierr = MatCreateVecs(A[0],&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&coords);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(coords,&Istart,&Iend);CHKERRQ(ierr);
+  ierr = VecGetArray(coords,&c);CHKERRQ(ierr);
+  for (n=Istart/3; n<Iend/3; n++) {
+    c[3*n-Istart]   = (PetscReal)(n%m)/m;
+    c[3*n-Istart+1] = (PetscReal)((n/m)%m)/m;
+    c[3*n-Istart+2] = (PetscReal)(n/(m*m))/m;
+  }
+  ierr = VecRestoreArray(coords,&c);CHKERRQ(ierr);
+  ierr = MatNullSpaceCreateRigidBody(coords,&nearnull);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+
+  for (j=0; j<2; j++) {
+    ierr = MatSetNearNullSpace(A[j],nearnull);CHKERRQ(ierr);
+    ierr = KSPCreate(PETSC_COMM_WORLD,&ksp[j]);CHKERRQ(ierr);
+    ierr = KSPSetType(ksp[j],KSPCG);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp[j],1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,200);CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp[j],&pc);CHKERRQ(ierr);
+    ierr = PCSetType(pc,PCGAMG);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp[j]);CHKERRQ(ierr);
+  }
+
+  for (i=0; i<nsolves; i++) {
+    for (j=0; j<2; j++) {
+      ierr = FormOperator(A[j],m,1.0+i);CHKERRQ(ierr);
+      ierr = KSPSetOperators(ksp[j],A[j],A[j]);CHKERRQ(ierr);
+      ierr = VecSet(x,0.0);CHKERRQ(ierr);
+      ierr = KSPSolve(ksp[j],b,x);CHKERRQ(ierr);
+      ierr = KSPGetIterationNumber(ksp[j],&its[j]);CHKERRQ(ierr);
+    }
+    if (its[0] != its[1]) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Solve %D: %D iterations with AIJ, %D with BAIJ\n",i,its[0],its[1]);CHKERRQ(ierr);}
+  }
+
+  /* the coarse operators keep the format of the fine operator */
+  for (j=0; j<2; j++) {
+    ierr = KSPGetPC(ksp[j],&pc);CHKERRQ(ierr);
+    ierr = PCMGGetLevels(pc,&nlevels);CHKERRQ(ierr);
+    for (i=0; i<nlevels-1; i++) {
+      ierr = PCMGGetSmoother(pc,i,&smoother);CHKERRQ(ierr);
+      ierr = KSPGetOperators(smoother,&B,NULL);CHKERRQ(ierr);
+      ierr = PetscObjectBaseTypeCompareAny((PetscObject)B,&isbaij,MATSEQBAIJ,MATMPIBAIJ,"");CHKERRQ(ierr);
+      if (isbaij != (PetscBool)j) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Level %D of the %s solver is not %s\n",i,fmt[j],fmt[j]);CHKERRQ(ierr);}
+    }
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"AIJ and BAIJ hierarchies agree\n");CHKERRQ(ierr);
+
+  for (j=0; j<2; j++) {
+    ierr = KSPDestroy(&ksp[j]);CHKERRQ(ierr);
+    ierr = MatDestroy(&A[j]);CHKERRQ(ierr);
+  }
+  ierr = MatNullSpaceDestroy(&nearnull);CHKERRQ(ierr);
+  ierr = VecDestroy(&coords);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      nsize: {{1 2 4}}
+      args: -pc_gamg_coarse_eq_limit 60 -mg_levels_pc_type {{jacobi pbjacobi sor}}
+      output_file: output/ex71_1.out
+      test:
+         suffix: baij
+      test:
+         suffix: baij_reuse
+         args: -pc_gamg_reuse_interpolation -nsolves 3 -pc_gamg_keep_aij_products {{0 1}}
+
+TEST*/
@@ -0,0 +1,104 @@
+
+static char help[] = "Solves a 2D Laplacian with the additive cycle of PCGAMG, smoothing the levels in sequence and concurrently on groups of processes.\n\
+  -m <m>            : the grid is m x m\n\
+  -check_apply <b>  : check that both preconditioners give the same result\n\n";
+
+#include <petscksp.h>
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  KSP            ksp[2];
+  PC             pc[2];
+  Vec            b,x,y[2];
+  PetscReal      rnorm,ynorm;
+  PetscInt       m = 48,n,Istart,Iend,its[2],j;
+  PetscBool      check = PETSC_TRUE,flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-check_apply",&check,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,4,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_SPD,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (n=Istart; n<Iend; n++) {
+    PetscInt i = n%m,k = n/m;
+
+    if (i > 0)   {ierr = MatSetValue(A,n,n-1,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i < m-1) {ierr = MatSetValue(A,n,n+1,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (k > 0)   {ierr = MatSetValue(A,n,n-m,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (k < m-1) {ierr = MatSetValue(A,n,n+m,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,n,n,4.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+
+  /* the second solver smooths the levels concurrently */
+  for (j=0; j<2; j++) {
+    ierr = KSPCreate(PETSC_COMM_WORLD,&ksp[j]);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp[j],A,A);CHKERRQ(ierr);
+    ierr = KSPSetType(ksp[j],KSPCG);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp[j],1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,500);CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp[j],&pc[j]);CHKERRQ(ierr);
+    ierr = PCSetType(pc[j],PCGAMG);CHKERRQ(ierr);
+    ierr = PCMGSetType(pc[j],PC_MG_ADDITIVE);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp[j]);CHKERRQ(ierr);
+    ierr = PCMGAdditiveSetConcurrent(pc[j],j ? PETSC_TRUE : PETSC_FALSE);CHKERRQ(ierr);
+    ierr = VecSet(x,0.0);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp[j],b,x);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp[j],&its[j]);CHKERRQ(ierr);
+    ierr = PetscOptionsHasName(NULL,NULL,"-view_iterations",&flg);CHKERRQ(ierr);
+    if (flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s cycle: %D iterations\n",j ? "Concurrent" : "Sequential",its[j]);CHKERRQ(ierr);}
+  }
+
+  /* both cycles compute the same sum of the level corrections */
+  if (check) {
+    for (j=0; j<2; j++) {
+      ierr = VecDuplicate(b,&y[j]);CHKERRQ(ierr);
+      ierr = PCApply(pc[j],b,y[j]);CHKERRQ(ierr);
+    }
+    ierr = VecNorm(y[0],NORM_2,&ynorm);CHKERRQ(ierr);
+    ierr = VecAXPY(y[1],-1.0,y[0]);CHKERRQ(ierr);
+    ierr = VecNorm(y[1],NORM_2,&rnorm);CHKERRQ(ierr);
+    if (rnorm > 1.e-10*ynorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Preconditioners differ by %g\n",(double)(rnorm/ynorm));CHKERRQ(ierr);}
+    for (j=0; j<2; j++) {ierr = VecDestroy(&y[j]);CHKERRQ(ierr);}
+  }
+  if (PetscAbs(its[0]-its[1]) > 1) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Sequential cycle: %D iterations, concurrent cycle: %D iterations\n",its[0],its[1]);CHKERRQ(ierr);}
+  else {ierr = PetscPrintf(PETSC_COMM_WORLD,"Sequential and concurrent additive cycles agree\n");CHKERRQ(ierr);}
+
+  for (j=0; j<2; j++) {ierr = KSPDestroy(&ksp[j]);CHKERRQ(ierr);}
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      nsize: {{1 2 3 5}}
+      args: -pc_gamg_coarse_eq_limit 40 -mg_levels_pc_type jacobi
+      output_file: output/ex72_1.out
+      test:
+         suffix: richardson
+         args: -mg_levels_ksp_type richardson -mg_levels_ksp_max_it {{1 2}}
+      test:
+         suffix: chebyshev
+         args: -mg_levels_ksp_type chebyshev -pc_gamg_use_sa_esteig {{0 1}}
+      test:
+         suffix: rank_reduction
+         args: -mg_levels_ksp_type richardson -pc_gamg_process_eq_limit 300 -pc_gamg_use_parallel_coarse_grid_solver
+
+   # the default PCSOR smoother is processor local, so the copies on the groups are different smoothers
+   test:
+      suffix: sor
+      nsize: {{1 3}}
+      args: -pc_gamg_coarse_eq_limit 40 -check_apply 0
+      output_file: output/ex72_1.out
+
+TEST*/
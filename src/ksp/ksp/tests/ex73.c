@@ -0,0 +1,161 @@
+
+static char help[] = "Solves a sequence of Stokes-like saddle point problems with PCFIELDSPLIT and a SELFP Schur complement preconditioner,\n\
+reusing the extracted blocks and the Schur complement approximation, and compares with solvers set up from scratch.\n\
+  -m <m>       : the velocity and pressure grids are m x m\n\
+  -nsys <n>    : number of systems in the sequence\n\
+  -plan <bool> : record where the nonzeros of the reused blocks are, see MAT_SUBMATRIX_PLAN\n\n";
+
+#include <petscksp.h>
+
+/*
+   The velocity unknowns are the even and the pressure unknowns the odd global indices:
+      [ A  B^T ]  A = (1 + t) Laplacian + t I,  B = a forward difference,  C = t/10 Laplacian
+      [ B  -C  ]
+   the values change with t but the nonzero pattern does not
+*/
+static PetscErrorCode FormOperator(Mat M,PetscInt m,PetscInt t)
+{
+  PetscInt       n,Istart,Iend;
+  PetscReal      s = 1.0 + 0.5*t;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetOwnershipRange(M,&Istart,&Iend);CHKERRQ(ierr);
+  for (n=Istart; n<Iend; n++) {
+    PetscInt k = n/2,i = k%m,j = k/m,d;
+    PetscInt ni[4] = {i-1,i+1,i,i},nj[4] = {j,j,j-1,j+1};
+
+    if (n%2 == 0) {
+      for (d=0; d<4; d++) {
+        if (ni[d] >= 0 && ni[d] < m && nj[d] >= 0 && nj[d] < m) {ierr = MatSetValue(M,n,2*(nj[d]*m+ni[d]),-s,INSERT_VALUES);CHKERRQ(ierr);}
+      }
+      ierr = MatSetValue(M,n,n,4.0*s + 0.1*t,INSERT_VALUES);CHKERRQ(ierr);
+      ierr = MatSetValue(M,n,n+1,-1.0,INSERT_VALUES);CHKERRQ(ierr);
+      if (i < m-1) {ierr = MatSetValue(M,n,n+3,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    } else {
+      ierr = MatSetValue(M,n,n-1,-1.0,INSERT_VALUES);CHKERRQ(ierr);
+      if (i > 0) {ierr = MatSetValue(M,n,n-3,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      for (d=0; d<4; d++) {
+        if (ni[d] >= 0 && ni[d] < m && nj[d] >= 0 && nj[d] < m) {ierr = MatSetValue(M,n,2*(nj[d]*m+ni[d])+1,0.01*(t+1),INSERT_VALUES);CHKERRQ(ierr);}
+      }
+      ierr = MatSetValue(M,n,n,-0.04*(t+1),INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(M,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(M,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CreateSolver(Mat M,IS is[],KSP *ksp)
+{
+  PC             pc;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = KSPCreate(PETSC_COMM_WORLD,ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(*ksp,M,M);CHKERRQ(ierr);
+  ierr = KSPSetType(*ksp,KSPFGMRES);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(*ksp,1.e-10,PETSC_DEFAULT,PETSC_DEFAULT,200);CHKERRQ(ierr);
+  ierr = KSPGetPC(*ksp,&pc);CHKERRQ(ierr);
+  ierr = PCSetType(pc,PCFIELDSPLIT);CHKERRQ(ierr);
+  ierr = PCFieldSplitSetIS(pc,"u",is[0]);CHKERRQ(ierr);
+  ierr = PCFieldSplitSetIS(pc,"p",is[1]);CHKERRQ(ierr);
+  ierr = PCFieldSplitSetType(pc,PC_COMPOSITE_SCHUR);CHKERRQ(ierr);
+  ierr = PCFieldSplitSetSchurPre(pc,PC_FIELDSPLIT_SCHUR_PRE_SELFP,NULL);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(*ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            M,Sub[2] = {NULL,NULL},Subnew;
+  KSP            ksp,kspnew;
+  Vec            b,x,xnew;
+  IS             is[2];
+  PetscReal      nrm,err;
+  PetscInt       m = 16,nsys = 4,t,f,its,itsnew,n,N,rstart,nfailed = 0;
+  PetscBool      equal,plan = PETSC_TRUE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nsys",&nsys,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-plan",&plan,NULL);CHKERRQ(ierr);
+
+  /* both unknowns of a grid point on the same process */
+  n    = PETSC_DECIDE;
+  N    = m*m;
+  ierr = PetscSplitOwnership(PETSC_COMM_WORLD,&n,&N);CHKERRQ(ierr);
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,2*n,2*n,2*N,2*N,12,NULL,12,NULL,&M);CHKERRQ(ierr);
+  ierr = MatSetBlockSize(M,2);CHKERRQ(ierr);
+  ierr = MatSetOption(M,MAT_SUBMATRIX_PLAN,plan);CHKERRQ(ierr);
+  ierr = FormOperator(M,m,0);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(M,&rstart,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(M,&n,NULL);CHKERRQ(ierr);
+  for (f=0; f<2; f++) {ierr = ISCreateStride(PETSC_COMM_WORLD,n/2,rstart+f,2,&is[f]);CHKERRQ(ierr);}
+  ierr = MatCreateVecs(M,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&xnew);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+  ierr = CreateSolver(M,is,&ksp);CHKERRQ(ierr);
+
+  for (t=0; t<nsys; t++) {
+    ierr = FormOperator(M,m,t);CHKERRQ(ierr);
+
+    /* submatrices extracted again, with the values of this system */
+    for (f=0; f<2; f++) {
+      ierr = MatCreateSubMatrix(M,is[f],is[1-f],t ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,&Sub[f]);CHKERRQ(ierr);
+      ierr = MatCreateSubMatrix(M,is[f],is[1-f],MAT_INITIAL_MATRIX,&Subnew);CHKERRQ(ierr);
+      ierr = MatEqual(Sub[f],Subnew,&equal);CHKERRQ(ierr);
+      if (!equal) {
+        ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D: reused submatrix %D differs\n",t,f);CHKERRQ(ierr);
+        nfailed++;
+      }
+      ierr = MatDestroy(&Subnew);CHKERRQ(ierr);
+    }
+
+    /* the solver of the sequence reuses its blocks and Schur complement approximation, the other is set up from scratch */
+    ierr = KSPSetOperators(ksp,M,M);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+    ierr = CreateSolver(M,is,&kspnew);CHKERRQ(ierr);
+    ierr = KSPSolve(kspnew,b,xnew);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(kspnew,&itsnew);CHKERRQ(ierr);
+    ierr = KSPDestroy(&kspnew);CHKERRQ(ierr);
+    ierr = VecNorm(xnew,NORM_2,&nrm);CHKERRQ(ierr);
+    ierr = VecAXPY(xnew,-1.0,x);CHKERRQ(ierr);
+    ierr = VecNorm(xnew,NORM_2,&err);CHKERRQ(ierr);
+    if (its != itsnew || err > 1.e-8*nrm) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"System %D: %D iterations with reuse, %D without, relative difference of the solutions %g\n",t,its,itsnew,(double)(err/nrm));CHKERRQ(ierr);
+      nfailed++;
+    }
+  }
+  if (!nfailed) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Reused setups agree with new setups\n");CHKERRQ(ierr);}
+
+  for (f=0; f<2; f++) {
+    ierr = MatDestroy(&Sub[f]);CHKERRQ(ierr);
+    ierr = ISDestroy(&is[f]);CHKERRQ(ierr);
+  }
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&xnew);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&M);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      nsize: {{1 3}}
+      output_file: output/ex73_1.out
+      requires: !single
+      args: -fieldsplit_u_ksp_type preonly -fieldsplit_u_pc_type bjacobi -fieldsplit_p_ksp_type gmres -fieldsplit_p_pc_type jacobi -fieldsplit_p_ksp_rtol 1.e-6
+      test:
+         suffix: selfp
+         args: -pc_fieldsplit_schur_fact_type {{diag full}} -fieldsplit_p_mat_schur_complement_ainv_type {{diag lump blockdiag}}
+      test:
+         suffix: selfp_no_plan
+         args: -plan false
+
+TEST*/
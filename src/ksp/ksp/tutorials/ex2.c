@@ -238,6 +238,37 @@ int main(int argc,char **args)
       args: -ksp_monitor_short -m 5 -n 5 -mat_view draw -ksp_gmres_cgs_refinement_type refine_always -nox
       output_file: output/ex2_2.out
 
+   test:
+      suffix: batch_reductions_cg
+      nsize: 2
+      args: -ksp_monitor_short -m 9 -n 9 -ksp_type cg -ksp_batch_reductions
+
+   test:
+      suffix: batch_reductions_bcgs
+      nsize: 2
+      args: -ksp_monitor_short -m 9 -n 9 -ksp_type bcgs -ksp_batch_reductions
+
+   test:
+      suffix: batch_reductions_gmres
+      nsize: 2
+      args: -ksp_monitor_short -m 9 -n 9 -ksp_gmres_cgs_refinement_type refine_ifneeded -ksp_batch_reductions
+
+   test:
+      suffix: check_norm_every_cg
+      nsize: 2
+      args: -ksp_monitor_short -m 9 -n 9 -ksp_type cg -ksp_norm_type unpreconditioned -ksp_check_norm_every 4 -ksp_check_norm_predict
+
+   test:
+      suffix: check_norm_every_bcgs
+      nsize: 2
+      args: -ksp_monitor_short -m 9 -n 9 -ksp_type bcgs -ksp_check_norm_every 4
+
+   test:
+      suffix: matmult_compression
+      nsize: 2
+      args: -ksp_monitor_short -m 9 -n 9 -ksp_type cg -matmult_vecscatter_compression single
+      requires: double
+
    test:
       suffix: bjacobi
       nsize: 4
@@ -342,4 +373,22 @@ int main(int argc,char **args)
       nsize: 4
       args: -ksp_monitor_short -ksp_type pipecg2 -m 15 -n 9 -ksp_norm_type {{preconditioned unpreconditioned natural}}
 
+   test:
+      suffix: sstepcg
+      args: -ksp_monitor_short -ksp_type sstepcg -m 15 -n 15 -ksp_sstep_size 3 -ksp_sstep_basis {{monomial newton chebyshev}}
+
+   test:
+      suffix: sstepcg_2
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sstepcg -m 15 -n 15 -ksp_sstep_size 2 -ksp_norm_type unpreconditioned
+
+   test:
+      suffix: cagmres
+      args: -ksp_monitor_short -ksp_type cagmres -m 15 -n 15 -ksp_sstep_size 3 -ksp_gmres_restart 12 -ksp_sstep_basis {{monomial newton chebyshev}}
+
+   test:
+      suffix: cagmres_2
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type cagmres -m 15 -n 15 -ksp_sstep_size 3 -ksp_gmres_restart 12 -ksp_pc_side right
+
  TEST*/
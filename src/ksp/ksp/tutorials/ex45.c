@@ -167,4 +167,26 @@ PetscErrorCode ComputeMatrix(KSP ksp,Mat jac,Mat B,void *ctx)
       nsize: 4
       args: -ksp_type fgmres -ksp_monitor_short -pc_type mg -mg_levels_ksp_type richardson -mg_levels_pc_type jacobi -pc_mg_levels 2 -da_grid_x 65 -da_grid_y 65 -da_grid_z 65 -mg_coarse_pc_type telescope -mg_coarse_pc_telescope_reduction_factor 2 -mg_coarse_telescope_pc_type mg -mg_coarse_telescope_pc_mg_galerkin pmat -mg_coarse_telescope_pc_mg_levels 3 -mg_coarse_telescope_mg_levels_ksp_type richardson -mg_coarse_telescope_mg_levels_pc_type jacobi -mg_levels_ksp_type richardson -mg_coarse_telescope_mg_levels_ksp_type richardson -ksp_rtol 1.0e-4
 
+   testset:
+      args: -ksp_monitor_short -da_grid_x 21 -da_grid_y 21 -da_grid_z 21 -pc_type mg -pc_mg_levels 2 -mg_levels_ksp_type richardson -mg_levels_pc_type jacobi -mat_blr_block_size 64 -mat_blr_tol 1.e-4
+      test:
+         suffix: blr
+         args: -mg_coarse_pc_factor_mat_solver_type blr -mat_factor_view ::ascii_info
+      test:
+         suffix: blr_redundant
+         nsize: 4
+         filter: grep -oE "[0-9]+ KSP Residual norm .*|^Residual norm .*|low-rank off-diagonal blocks .*|entries in the factors .*" | sort -u
+         args: -mg_coarse_redundant_pc_factor_mat_solver_type blr -mat_factor_view ::ascii_info
+
+   # the squared graph gives a nearly dense coarse operator, whose BLR factors are smaller than its sparse LU factors
+   testset:
+      args: -ksp_monitor_short -da_grid_x 29 -da_grid_y 29 -da_grid_z 29 -pc_type gamg -pc_gamg_agg_nsmooths 1 -pc_gamg_square_graph 10 -pc_mg_levels 2 -mg_coarse_sub_pc_factor_mat_ordering_type nd -mat_factor_view ::ascii_info
+      filter: grep -v "I-node"
+      test:
+         suffix: blr_gamg
+         args: -mg_coarse_sub_pc_factor_mat_solver_type blr -mg_coarse_sub_mat_blr_block_size 64 -mg_coarse_sub_mat_blr_tol 1.e-3
+      test:
+         suffix: blr_gamg_sparse
+         args: -mg_coarse_sub_pc_factor_mat_solver_type petsc
+
 TEST*/
@@ -983,6 +983,13 @@ PetscErrorCode elem_3d_elast_v_25(PetscScalar *dd)
       suffix: nns
       args: -ne 9 -alpha 1.e-3 -ksp_converged_reason -ksp_type cg -ksp_max_it 50 -pc_type gamg -pc_gamg_type agg -pc_gamg_agg_nsmooths 1 -pc_gamg_coarse_eq_limit 1000 -mg_levels_ksp_type chebyshev -mg_levels_pc_type sor -pc_gamg_reuse_interpolation true -two_solves -use_mat_nearnullspace -mg_levels_esteig_ksp_max_it 10
 
+   test:
+      suffix: coarse_subcomm
+      nsize: 8
+      args: -ne 13 -alpha 1.e-3 -ksp_converged_reason -ksp_type cg -pc_type gamg -pc_gamg_agg_nsmooths 1 -mg_levels_ksp_type chebyshev -mg_levels_pc_type jacobi -use_mat_nearnullspace -pc_gamg_reuse_interpolation -two_solves -pc_gamg_use_parallel_coarse_grid_solver -pc_gamg_coarse_subcomm -pc_gamg_coarse_eq_limit 600 -pc_gamg_process_eq_limit 100 -pc_gamg_coarse_grid_layout_type {{spread compact}} -ksp_view
+      output_file: output/ex56_coarse_subcomm.out
+      filter: grep -E "converged|telescope|subcomm_size|of its processes"
+
    test:
       suffix: nns_telescope
       nsize: 2
@@ -244,6 +244,12 @@ int main(int argc,char **args)
       nsize: 2
       args: -ksp_view ::ascii_info_detail
 
+   test:
+      suffix: threads
+      nsize: 2
+      args: -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always -pc_bjacobi_threads 2
+      output_file: output/ex7_1.out
+
    test:
       suffix: viennacl
       requires: viennacl
@@ -86,6 +86,7 @@ typedef struct {
   PetscBool    use_composite_pc;
   PetscBool    random_initial_guess;
   PetscBool    random_real;
+  PetscInt     nsolves;
 } AppCtx;
 
 static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
@@ -110,6 +111,7 @@ static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   options->use_composite_pc = PETSC_FALSE;
   options->random_initial_guess = PETSC_FALSE;
   options->random_real = PETSC_FALSE;
+  options->nsolves = 1;
 
   ierr = PetscOptionsBegin(comm,NULL,"Problem Options",NULL);CHKERRQ(ierr);
   pde  = options->pde;
@@ -124,6 +126,7 @@ static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
   ierr = PetscOptionsBool("-use_composite_pc","Multiplicative composite with BDDC + Richardson/Jacobi",__FILE__,options->use_composite_pc,&options->use_composite_pc,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-random_initial_guess","Solve A x = 0 with random initial guess, instead of A x = b with random b",__FILE__,options->random_initial_guess,&options->random_initial_guess,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-random_real","Use real-valued b (or x, if -random_initial_guess) instead of default scalar type",__FILE__,options->random_real,&options->random_real,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-nsolves","Number of solves, the operator is scaled before each new solve",__FILE__,options->nsolves,&options->nsolves,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
 
   for (n=options->dim;n<3;n++) options->cells[n] = 0;
@@ -442,6 +445,13 @@ int main(int argc,char **args)
   ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
   ierr = PetscLogStagePop();CHKERRQ(ierr);
 
+  /* change the values of the operator: the preconditioner is set up again with the same pattern */
+  for (i=1;i<user.nsolves;i++) {
+    ierr = MatScale(A,2.0);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  }
+
   /* cleanup */
   ierr = VecDestroy(&x);CHKERRQ(ierr);
   ierr = VecDestroy(&b);CHKERRQ(ierr);
@@ -598,6 +608,32 @@ int main(int argc,char **args)
    suffix: bddc_elast_deluxe_layers_adapt
    requires: mumps !complex
    args: -pde_type Elasticity -cells 7,9,8 -dim 3 -ksp_converged_reason -pc_bddc_coarse_redundant_pc_type svd -ksp_error_if_not_converged -pc_bddc_monolithic -sub_schurs_mat_solver_type mumps -pc_bddc_use_deluxe_scaling -pc_bddc_adaptive_threshold 2.0 -pc_bddc_schur_layers {{1 10}separate_output} -pc_bddc_adaptive_userdefined {{0 1}separate output} -sub_schurs_schur_mat_type seqdense
+ test:
+   nsize: 8
+   filter: grep -v "variant HERMITIAN"
+   suffix: bddc_elast_deluxe_layers_adapt_threads
+   requires: mumps !complex
+   output_file: output/ex71_bddc_elast_deluxe_layers_adapt_pc_bddc_schur_layers-1_pc_bddc_adaptive_userdefined-0.out
+   args: -pde_type Elasticity -cells 7,9,8 -dim 3 -ksp_converged_reason -pc_bddc_coarse_redundant_pc_type svd -ksp_error_if_not_converged -pc_bddc_monolithic -sub_schurs_mat_solver_type mumps -pc_bddc_use_deluxe_scaling -pc_bddc_adaptive_threshold 2.0 -pc_bddc_schur_layers 1 -sub_schurs_schur_mat_type seqdense -pc_bddc_threads 2
+ test:
+   nsize: 8
+   filter: grep -v "variant HERMITIAN"
+   suffix: bddc_elast_deluxe_layers_adapt_reuse
+   requires: mumps !complex
+   args: -pde_type Elasticity -cells 7,9,8 -dim 3 -ksp_converged_reason -pc_bddc_coarse_redundant_pc_type svd -ksp_error_if_not_converged -pc_bddc_monolithic -sub_schurs_mat_solver_type mumps -pc_bddc_use_deluxe_scaling -pc_bddc_adaptive_threshold 2.0 -pc_bddc_schur_layers 1 -sub_schurs_schur_mat_type seqdense -pc_bddc_adaptive_reuse -nsolves 2
+ # adaptive selection without MUMPS or MKL_PARDISO, the Schur complements on the subsets are computed explicitly
+ test:
+   nsize: 8
+   filter: grep -v "variant HERMITIAN"
+   suffix: bddc_elast_deluxe_layers_adapt_native
+   requires: !complex
+   args: -pde_type Elasticity -cells 7,9,8 -dim 3 -ksp_converged_reason -pc_bddc_coarse_redundant_pc_type svd -ksp_error_if_not_converged -pc_bddc_monolithic -sub_schurs_mat_solver_type petsc -pc_bddc_use_deluxe_scaling -pc_bddc_adaptive_threshold 2.0 -pc_bddc_schur_layers {{1 10}separate_output} -nsolves 2 -pc_bddc_adaptive_reuse
+ test:
+   nsize: 4
+   suffix: bddc_elast_2d_adapt_native
+   requires: !complex
+   args: -pde_type Elasticity -cells 14,14 -dim 2 -ksp_converged_reason -pc_bddc_coarse_redundant_pc_type svd -ksp_error_if_not_converged -pc_bddc_monolithic -sub_schurs_mat_solver_type petsc -pc_bddc_use_deluxe_scaling {{0 1}separate_output} -pc_bddc_adaptive_threshold 2.0 -ksp_view
+   filter: grep -E "CONVERGED|Global dofs sizes"
  # gitlab runners have a quite old MKL (2016) which interacts badly with AMD machines (not Intel-based ones!)
  # this is the reason behind the filtering rule
  test:
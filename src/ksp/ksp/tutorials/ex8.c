@@ -293,4 +293,8 @@ int main(int argc,char **args)
       suffix: 1
       args: -print_error
 
+   test:
+      suffix: threads
+      args: -print_error -user_set_subdomains -pc_asm_threads 2
+
 TEST*/
@@ -713,6 +713,133 @@ PetscErrorCode  MatSchurComplementGetAinvType(Mat S,MatSchurComplementAinvType *
   PetscFunctionReturn(0);
 }
 
+/*
+   Kept on the matrix created by MatCreateSchurComplementPmat() to compute it again with MAT_REUSE_MATRIX, using the
+   symbolic products of the first call, while the nonzero patterns of A01, A10 and A11 do not change
+*/
+typedef struct {
+  MatSchurComplementAinvType ainvtype;
+  PetscInt                   bs;                 /* block size of A00 */
+  PetscObjectId              id[3];              /* of A01, A10 and A11 */
+  PetscObjectState           nonzerostate[3];
+  Mat                        A00inv;             /* inverse of the block diagonal of A00, for MAT_SCHUR_COMPLEMENT_AINV_BLOCK_DIAG */
+  Mat                        AdB;                /* inv(diag(A00)) A01 */
+  Mat                        P;                  /* A10 inv(diag(A00)) A01, NULL if A11 is NULL since then Sp = -P */
+} Mat_SchurComplementPmat;
+
+static PetscErrorCode MatSchurComplementPmatDestroy_Private(void *ptr)
+{
+  Mat_SchurComplementPmat *sp = (Mat_SchurComplementPmat*)ptr;
+  PetscErrorCode          ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDestroy(&sp->A00inv);CHKERRQ(ierr);
+  ierr = MatDestroy(&sp->AdB);CHKERRQ(ierr);
+  ierr = MatDestroy(&sp->P);CHKERRQ(ierr);
+  ierr = PetscFree(sp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSchurComplementPmatState_Private(Mat A01,Mat A10,Mat A11,PetscObjectId id[],PetscObjectState nonzerostate[])
+{
+  Mat            A[3] = {A01,A10,A11};
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<3; i++) {
+    id[i]           = 0;
+    nonzerostate[i] = 0;
+    if (A[i]) {
+      ierr = PetscObjectGetId((PetscObject)A[i],&id[i]);CHKERRQ(ierr);
+      ierr = MatGetNonzeroState(A[i],&nonzerostate[i]);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* fills the inverse of the block diagonal of A00 in C, preallocated by MatInvertBlockDiagonalMat() */
+static PetscErrorCode MatSchurComplementPmatInvertBlockDiagonal_Private(Mat A00,Mat C)
+{
+  PetscErrorCode    ierr;
+  const PetscScalar *vals;
+  PetscInt          bs,i,rstart,rend;
+
+  PetscFunctionBegin;
+  ierr = MatInvertBlockDiagonal(A00,&vals);CHKERRQ(ierr);
+  ierr = MatGetBlockSize(A00,&bs);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(C,&rstart,&rend);CHKERRQ(ierr);
+  ierr = MatSetOption(C,MAT_ROW_ORIENTED,PETSC_FALSE);CHKERRQ(ierr);
+  for (i = rstart/bs; i < rend/bs; i++) {
+    ierr = MatSetValuesBlocked(C,1,&i,1,&i,&vals[(i-rstart/bs)*bs*bs],INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetOption(C,MAT_ROW_ORIENTED,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* computes the inverse of diag(A00), or of its lumped version, times A01 in AdB, which has the nonzero pattern of A01 */
+static PetscErrorCode MatSchurComplementPmatScaleA01_Private(Mat A00,MatSchurComplementAinvType ainvtype,Mat AdB)
+{
+  PetscErrorCode ierr;
+  Vec            diag;
+
+  PetscFunctionBegin;
+  ierr = MatCreateVecs(A00,&diag,NULL);CHKERRQ(ierr);
+  if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_LUMP) {
+    ierr = MatGetRowSum(A00,diag);CHKERRQ(ierr);
+  } else {
+    ierr = MatGetDiagonal(A00,diag);CHKERRQ(ierr);
+  }
+  ierr = VecReciprocal(diag);CHKERRQ(ierr);
+  ierr = MatDiagonalScale(AdB,diag,NULL);CHKERRQ(ierr);
+  ierr = VecDestroy(&diag);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* recomputes Sp numerically if it was created by MatCreateSchurComplementPmat() for blocks with the same nonzero patterns */
+static PetscErrorCode MatCreateSchurComplementPmatReuse_Private(Mat A00,Mat A01,Mat A10,Mat A11,MatSchurComplementAinvType ainvtype,Mat Sp,PetscBool *reused)
+{
+  PetscErrorCode          ierr;
+  PetscContainer          container;
+  Mat_SchurComplementPmat *sp;
+  PetscObjectId           id[3];
+  PetscObjectState        nonzerostate[3];
+  PetscInt                bs,i;
+  Mat                     P;
+
+  PetscFunctionBegin;
+  *reused = PETSC_FALSE;
+  ierr = PetscObjectQuery((PetscObject)Sp,"MatSchurComplementPmat",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) PetscFunctionReturn(0);
+  ierr = PetscContainerGetPointer(container,(void**)&sp);CHKERRQ(ierr);
+  ierr = MatGetBlockSize(A00,&bs);CHKERRQ(ierr);
+  ierr = MatSchurComplementPmatState_Private(A01,A10,A11,id,nonzerostate);CHKERRQ(ierr);
+  if (sp->ainvtype != ainvtype || (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_BLOCK_DIAG && sp->bs != bs)) PetscFunctionReturn(0);
+  for (i=0; i<3; i++) if (sp->id[i] != id[i] || sp->nonzerostate[i] != nonzerostate[i]) PetscFunctionReturn(0);
+
+  if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_BLOCK_DIAG) {
+    ierr = MatSchurComplementPmatInvertBlockDiagonal_Private(A00,sp->A00inv);CHKERRQ(ierr);
+    ierr = MatMatMult(sp->A00inv,A01,MAT_REUSE_MATRIX,PETSC_DEFAULT,&sp->AdB);CHKERRQ(ierr);
+  } else {
+    ierr = MatCopy(A01,sp->AdB,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatSchurComplementPmatScaleA01_Private(A00,ainvtype,sp->AdB);CHKERRQ(ierr);
+  }
+  P    = sp->P ? sp->P : Sp;
+  ierr = MatMatMult(A10,sp->AdB,MAT_REUSE_MATRIX,PETSC_DEFAULT,&P);CHKERRQ(ierr);
+  if (!sp->P) {
+    ierr = MatScale(Sp,-1.0);CHKERRQ(ierr);
+  } else {
+    /* the nonzero pattern of Sp is the union of those of P and A11 */
+    ierr = MatZeroEntries(Sp);CHKERRQ(ierr);
+    ierr = MatAXPY(Sp,-1.0,sp->P,SUBSET_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatAXPY(Sp,1.0,A11,SUBSET_NONZERO_PATTERN);CHKERRQ(ierr);
+  }
+  *reused = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
 /*@
     MatCreateSchurComplementPmat - create a preconditioning matrix for the Schur complement by assembling Sp = A11 - A10 inv(diag(A00)) A01
 
@@ -735,6 +862,10 @@ PetscErrorCode  MatSchurComplementGetAinvType(Mat S,MatSchurComplementAinvType *
     the (0,0) block A00 in place of A00^{-1}. This rarely produce a scalable algorithm. Optionally, A00 can be lumped
     before forming inv(diag(A00)).
 
+    Sp keeps inv(diag(A00)) A01 and, if A11 is given, A10 inv(diag(A00)) A01 with the data of the matrix products, so that
+    MAT_REUSE_MATRIX only computes the products numerically, in place, when A01, A10 and A11 have the same nonzero
+    patterns as in the call that created Sp. Otherwise Sp is destroyed and created again.
+
     Level: advanced
 
 .seealso: MatCreateSchurComplement(), MatGetSchurComplement(), MatSchurComplementGetPmat(), MatSchurComplementAinvType
@@ -761,44 +892,53 @@ PetscErrorCode  MatCreateSchurComplementPmat(Mat A00,Mat A01,Mat A10,Mat A11,Mat
       ierr = MatCopy(A11,*Spmat,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
     }
   } else {
-    Mat AdB;
-    Vec diag;
-
+    Mat                     P;
+    Mat_SchurComplementPmat *sp;
+    PetscContainer          container;
+    PetscBool               reused;
+
+    if (preuse == MAT_REUSE_MATRIX) {
+      ierr = MatCreateSchurComplementPmatReuse_Private(A00,A01,A10,A11,ainvtype,*Spmat,&reused);CHKERRQ(ierr);
+      if (reused) PetscFunctionReturn(0);
+    }
+    ierr = PetscNew(&sp);CHKERRQ(ierr);
+    sp->ainvtype = ainvtype;
+    ierr = MatGetBlockSize(A00,&sp->bs);CHKERRQ(ierr);
+    ierr = MatSchurComplementPmatState_Private(A01,A10,A11,sp->id,sp->nonzerostate);CHKERRQ(ierr);
     if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_LUMP || ainvtype == MAT_SCHUR_COMPLEMENT_AINV_DIAG) {
-      ierr = MatDuplicate(A01,MAT_COPY_VALUES,&AdB);CHKERRQ(ierr);
-      ierr = MatCreateVecs(A00,&diag,NULL);CHKERRQ(ierr);
-      if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_LUMP) {
-        ierr = MatGetRowSum(A00,diag);CHKERRQ(ierr);
-      } else {
-        ierr = MatGetDiagonal(A00,diag);CHKERRQ(ierr);
-      }
-      ierr = VecReciprocal(diag);CHKERRQ(ierr);
-      ierr = MatDiagonalScale(AdB,diag,NULL);CHKERRQ(ierr);
-      ierr = VecDestroy(&diag);CHKERRQ(ierr);
+      ierr = MatDuplicate(A01,MAT_COPY_VALUES,&sp->AdB);CHKERRQ(ierr);
+      ierr = MatSchurComplementPmatScaleA01_Private(A00,ainvtype,sp->AdB);CHKERRQ(ierr);
     } else if (ainvtype == MAT_SCHUR_COMPLEMENT_AINV_BLOCK_DIAG) {
-      Mat      A00_inv;
       MatType  type;
       MPI_Comm comm;
 
       ierr = PetscObjectGetComm((PetscObject)A00,&comm);CHKERRQ(ierr);
       ierr = MatGetType(A00,&type);CHKERRQ(ierr);
-      ierr = MatCreate(comm,&A00_inv);CHKERRQ(ierr);
-      ierr = MatSetType(A00_inv,type);CHKERRQ(ierr);
-      ierr = MatInvertBlockDiagonalMat(A00,A00_inv);CHKERRQ(ierr);
-      ierr = MatMatMult(A00_inv,A01,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&AdB);CHKERRQ(ierr);
-      ierr = MatDestroy(&A00_inv);CHKERRQ(ierr);
-    } else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Unknown MatSchurComplementAinvType: %D", ainvtype);
-    /* Cannot really reuse Spmat in MatMatMult() because of MatAYPX() -->
-         MatAXPY() --> MatHeaderReplace() --> MatDestroy_XXX_MatMatMult()  */
-    ierr     = MatDestroy(Spmat);CHKERRQ(ierr);
-    ierr     = MatMatMult(A10,AdB,MAT_INITIAL_MATRIX,PETSC_DEFAULT,Spmat);CHKERRQ(ierr);
+      ierr = MatCreate(comm,&sp->A00inv);CHKERRQ(ierr);
+      ierr = MatSetType(sp->A00inv,type);CHKERRQ(ierr);
+      ierr = MatInvertBlockDiagonalMat(A00,sp->A00inv);CHKERRQ(ierr);
+      ierr = MatMatMult(sp->A00inv,A01,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&sp->AdB);CHKERRQ(ierr);
+    } else {
+      ierr = PetscFree(sp);CHKERRQ(ierr);
+      SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Unknown MatSchurComplementAinvType: %D", ainvtype);
+    }
+    ierr = MatDestroy(Spmat);CHKERRQ(ierr);
+    ierr = MatMatMult(A10,sp->AdB,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&P);CHKERRQ(ierr);
     if (!A11) {
-      ierr = MatScale(*Spmat,-1.0);CHKERRQ(ierr);
+      ierr   = MatScale(P,-1.0);CHKERRQ(ierr);
+      *Spmat = P;
     } else {
+      /* MatAYPX() --> MatAXPY() --> MatHeaderReplace() destroys the data of the product, so it is done on a copy */
+      sp->P = P;
+      ierr  = MatDuplicate(P,MAT_COPY_VALUES,Spmat);CHKERRQ(ierr);
       /* TODO: when can we pass SAME_NONZERO_PATTERN? */
-      ierr = MatAYPX(*Spmat,-1,A11,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+      ierr  = MatAYPX(*Spmat,-1,A11,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
     }
-    ierr = MatDestroy(&AdB);CHKERRQ(ierr);
+    ierr = PetscContainerCreate(PetscObjectComm((PetscObject)*Spmat),&container);CHKERRQ(ierr);
+    ierr = PetscContainerSetPointer(container,sp);CHKERRQ(ierr);
+    ierr = PetscContainerSetUserDestroy(container,MatSchurComplementPmatDestroy_Private);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)*Spmat,"MatSchurComplementPmat",(PetscObject)container);CHKERRQ(ierr);
+    ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
@@ -34,6 +34,7 @@ static PetscErrorCode PCView_ASM(PC pc,PetscViewer viewer)
     ierr = PetscViewerASCIIPrintf(viewer,"  restriction/interpolation type - %s\n",PCASMTypes[osm->type]);CHKERRQ(ierr);
     if (osm->dm_subdomains) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: using DM to define subdomains\n");CHKERRQ(ierr);}
     if (osm->loctype != PC_COMPOSITE_ADDITIVE) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: local solve composition type - %s\n",PCCompositeTypes[osm->loctype]);CHKERRQ(ierr);}
+    else if (osm->nthreads > 1) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: local blocks are solved concurrently by up to %D threads\n",osm->nthreads);CHKERRQ(ierr);}
     ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)pc),&rank);CHKERRMPI(ierr);
     ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
     if (format != PETSC_VIEWER_ASCII_INFO_DETAIL) {
@@ -434,19 +435,11 @@ static PetscErrorCode PCSetUp_ASM(PC pc)
 
 static PetscErrorCode PCSetUpOnBlocks_ASM(PC pc)
 {
-  PC_ASM             *osm = (PC_ASM*)pc->data;
-  PetscErrorCode     ierr;
-  PetscInt           i;
-  KSPConvergedReason reason;
+  PC_ASM         *osm = (PC_ASM*)pc->data;
+  PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  for (i=0; i<osm->n_local_true; i++) {
-    ierr = KSPSetUp(osm->ksp[i]);CHKERRQ(ierr);
-    ierr = KSPGetConvergedReason(osm->ksp[i],&reason);CHKERRQ(ierr);
-    if (reason == KSP_DIVERGED_PC_FAILED) {
-      pc->failedreason = PC_SUBPC_ERROR;
-    }
-  }
+  ierr = PCSetUpBlocks_Private(pc,osm->nthreads,osm->n_local_true,osm->ksp);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -480,36 +473,54 @@ static PetscErrorCode PCApply_ASM(PC pc,Vec x,Vec y)
     ierr = VecScatterBegin(osm->restriction, x, osm->lx, INSERT_VALUES, forward);CHKERRQ(ierr);
     ierr = VecScatterEnd(osm->restriction, x, osm->lx, INSERT_VALUES, forward);CHKERRQ(ierr);
 
-    /* restrict local RHS to the overlapping 0-block RHS */
-    ierr = VecScatterBegin(osm->lrestriction[0], osm->lx, osm->x[0], INSERT_VALUES, forward);CHKERRQ(ierr);
-    ierr = VecScatterEnd(osm->lrestriction[0], osm->lx, osm->x[0], INSERT_VALUES, forward);CHKERRQ(ierr);
-
-    /* do the local solves */
-    for (i = 0; i < n_local_true; ++i) {
-
-      /* solve the overlapping i-block */
-      ierr = PetscLogEventBegin(PC_ApplyOnBlocks, osm->ksp[i], osm->x[i], osm->y[i],0);CHKERRQ(ierr);
-      ierr = KSPSolve(osm->ksp[i], osm->x[i], osm->y[i]);CHKERRQ(ierr);
-      ierr = KSPCheckSolve(osm->ksp[i], pc, osm->y[i]);CHKERRQ(ierr);
-      ierr = PetscLogEventEnd(PC_ApplyOnBlocks, osm->ksp[i], osm->x[i], osm->y[i], 0);CHKERRQ(ierr);
-
-      if (osm->lprolongation) { /* interpolate the non-overlapping i-block solution to the local solution (only for restrictive additive) */
-        ierr = VecScatterBegin(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
-        ierr = VecScatterEnd(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
-      } else { /* interpolate the overlapping i-block solution to the local solution */
-        ierr = VecScatterBegin(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
-        ierr = VecScatterEnd(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+    if (osm->loctype == PC_COMPOSITE_ADDITIVE && osm->nthreads > 1 && n_local_true > 1) {
+      /* the blocks are independent: restrict all the RHS, solve the blocks concurrently, then add the solutions */
+      for (i = 0; i < n_local_true; ++i) {
+        ierr = VecScatterBegin(osm->lrestriction[i], osm->lx, osm->x[i], INSERT_VALUES, forward);CHKERRQ(ierr);
+        ierr = VecScatterEnd(osm->lrestriction[i], osm->lx, osm->x[i], INSERT_VALUES, forward);CHKERRQ(ierr);
+      }
+      ierr = PCSolveBlocks_Private(pc, osm->nthreads, n_local_true, osm->ksp, osm->x, osm->y, PETSC_FALSE);CHKERRQ(ierr);
+      for (i = 0; i < n_local_true; ++i) {
+        if (osm->lprolongation) {
+          ierr = VecScatterBegin(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+          ierr = VecScatterEnd(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+        } else {
+          ierr = VecScatterBegin(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+          ierr = VecScatterEnd(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+        }
       }
+    } else {
+      /* restrict local RHS to the overlapping 0-block RHS */
+      ierr = VecScatterBegin(osm->lrestriction[0], osm->lx, osm->x[0], INSERT_VALUES, forward);CHKERRQ(ierr);
+      ierr = VecScatterEnd(osm->lrestriction[0], osm->lx, osm->x[0], INSERT_VALUES, forward);CHKERRQ(ierr);
+
+      /* do the local solves */
+      for (i = 0; i < n_local_true; ++i) {
+
+        /* solve the overlapping i-block */
+        ierr = PetscLogEventBegin(PC_ApplyOnBlocks, osm->ksp[i], osm->x[i], osm->y[i],0);CHKERRQ(ierr);
+        ierr = KSPSolve(osm->ksp[i], osm->x[i], osm->y[i]);CHKERRQ(ierr);
+        ierr = KSPCheckSolve(osm->ksp[i], pc, osm->y[i]);CHKERRQ(ierr);
+        ierr = PetscLogEventEnd(PC_ApplyOnBlocks, osm->ksp[i], osm->x[i], osm->y[i], 0);CHKERRQ(ierr);
+
+        if (osm->lprolongation) { /* interpolate the non-overlapping i-block solution to the local solution (only for restrictive additive) */
+          ierr = VecScatterBegin(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+          ierr = VecScatterEnd(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+        } else { /* interpolate the overlapping i-block solution to the local solution */
+          ierr = VecScatterBegin(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+          ierr = VecScatterEnd(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+        }
 
-      if (i < n_local_true-1) {
-        /* restrict local RHS to the overlapping (i+1)-block RHS */
-        ierr = VecScatterBegin(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
-        ierr = VecScatterEnd(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
+        if (i < n_local_true-1) {
+          /* restrict local RHS to the overlapping (i+1)-block RHS */
+          ierr = VecScatterBegin(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
+          ierr = VecScatterEnd(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
 
-        if (osm->loctype == PC_COMPOSITE_MULTIPLICATIVE) {
-          /* update the overlapping (i+1)-block RHS using the current local solution */
-          ierr = MatMult(osm->lmats[i+1], osm->ly, osm->y[i+1]);CHKERRQ(ierr);
-          ierr = VecAXPBY(osm->x[i+1],-1.,1., osm->y[i+1]);CHKERRQ(ierr);
+          if (osm->loctype == PC_COMPOSITE_MULTIPLICATIVE) {
+            /* update the overlapping (i+1)-block RHS using the current local solution */
+            ierr = MatMult(osm->lmats[i+1], osm->ly, osm->y[i+1]);CHKERRQ(ierr);
+            ierr = VecAXPBY(osm->x[i+1],-1.,1., osm->y[i+1]);CHKERRQ(ierr);
+          }
         }
       }
     }
@@ -530,7 +541,19 @@ static PetscErrorCode PCMatApply_ASM(PC pc,Mat X,Mat Y)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  if (osm->n_local_true > 1) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Not yet implemented");
+  if (osm->n_local_true > 1) { /* the blocks are solved one column at a time */
+    Vec y;
+
+    ierr = MatGetSize(X,NULL,&N);CHKERRQ(ierr);
+    for (i=0; i<N; i++) {
+      ierr = MatDenseGetColumnVecRead(X,i,&x);CHKERRQ(ierr);
+      ierr = MatDenseGetColumnVecWrite(Y,i,&y);CHKERRQ(ierr);
+      ierr = PCApply_ASM(pc,x,y);CHKERRQ(ierr);
+      ierr = MatDenseRestoreColumnVecWrite(Y,i,&y);CHKERRQ(ierr);
+      ierr = MatDenseRestoreColumnVecRead(X,i,&x);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
   /*
      support for limiting the restriction or interpolation to only local
      subdomain values (leaving the other values 0).
@@ -730,6 +753,7 @@ static PetscErrorCode PCDestroy_ASM(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetType_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetLocalType_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetLocalType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetThreads_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetSortIndices_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetSubKSP_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetSubMatType_C",NULL);CHKERRQ(ierr);
@@ -741,7 +765,7 @@ static PetscErrorCode PCSetFromOptions_ASM(PetscOptionItems *PetscOptionsObject,
 {
   PC_ASM         *osm = (PC_ASM*)pc->data;
   PetscErrorCode ierr;
-  PetscInt       blocks,ovl;
+  PetscInt       blocks,ovl,nthreads;
   PetscBool      flg;
   PCASMType      asmtype;
   PCCompositeType loctype;
@@ -771,6 +795,8 @@ static PetscErrorCode PCSetFromOptions_ASM(PetscOptionItems *PetscOptionsObject,
   flg  = PETSC_FALSE;
   ierr = PetscOptionsEnum("-pc_asm_local_type","Type of local solver composition","PCASMSetLocalType",PCCompositeTypes,(PetscEnum)osm->loctype,(PetscEnum*)&loctype,&flg);CHKERRQ(ierr);
   if (flg) {ierr = PCASMSetLocalType(pc,loctype);CHKERRQ(ierr); }
+  ierr = PetscOptionsInt("-pc_asm_threads","Number of threads solving the local blocks concurrently","PCASMSetThreads",osm->nthreads,&nthreads,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = PCASMSetThreads(pc,nthreads);CHKERRQ(ierr);}
   ierr = PetscOptionsFList("-pc_asm_sub_mat_type","Subsolve Matrix Type","PCASMSetSubMatType",MatList,NULL,sub_mat_type,256,&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = PCASMSetSubMatType(pc,sub_mat_type);CHKERRQ(ierr);
@@ -907,6 +933,23 @@ static PetscErrorCode  PCASMGetLocalType_ASM(PC pc, PCCompositeType *type)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PCASMSetThreads_ASM(PC pc,PetscInt nthreads)
+{
+  PC_ASM *osm = (PC_ASM*)pc->data;
+
+  PetscFunctionBegin;
+  if (nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",nthreads);
+#if !(defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY))
+  if (nthreads > 1) {
+    PetscErrorCode ierr;
+
+    ierr = PetscInfo1(pc,"Solving the blocks one after another, %D threads require PETSc configured with OpenMP and --with-threadsafety\n",nthreads);CHKERRQ(ierr);
+  }
+#endif
+  osm->nthreads = nthreads;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode  PCASMSetSortIndices_ASM(PC pc,PetscBool  doSort)
 {
   PC_ASM *osm = (PC_ASM*)pc->data;
@@ -1240,6 +1283,42 @@ PetscErrorCode PCASMGetLocalType(PC pc, PCCompositeType *type)
   PetscFunctionReturn(0);
 }
 
+/*@
+  PCASMSetThreads - Sets the number of threads that set up and solve the local blocks of the additive
+  Schwarz method concurrently.
+
+  Logically Collective on pc
+
+  Input Parameters:
++ pc  - the preconditioner context
+- nthreads - the number of threads, 1 (the default) solves the local blocks one after another
+
+  Options Database Key:
+. -pc_asm_threads <nthreads> - sets the number of threads
+
+  Notes:
+  Only has an effect when a process owns several subdomains. The blocks are only solved concurrently with the
+  PC_COMPOSITE_ADDITIVE local type, the multiplicative local type always solves them one after another. The
+  restriction and prolongation of the blocks remain sequential.
+
+  This requires PETSc to be configured with OpenMP and --with-threadsafety, otherwise the blocks are solved
+  one after another. See PCBJacobiSetThreads() for the requirements on the sub-solvers.
+
+  Level: intermediate
+
+.seealso: PCASMSetLocalSubdomains(), PCASMSetLocalType(), PCBJacobiSetThreads(), PCASM
+@*/
+PetscErrorCode PCASMSetThreads(PC pc,PetscInt nthreads)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveInt(pc,nthreads,2);
+  ierr = PetscTryMethod(pc,"PCASMSetThreads_C",(PC,PetscInt),(pc,nthreads));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
     PCASMSetSortIndices - Determines whether subdomain indices are sorted.
 
@@ -1312,7 +1391,8 @@ PetscErrorCode  PCASMGetSubKSP(PC pc,PetscInt *n_local,PetscInt *first_local,KSP
 +  -pc_asm_blocks <blks> - Sets total blocks
 .  -pc_asm_overlap <ovl> - Sets overlap
 .  -pc_asm_type [basic,restrict,interpolate,none] - Sets ASM type, default is restrict
--  -pc_asm_local_type [additive, multiplicative] - Sets ASM type, default is additive
+.  -pc_asm_local_type [additive, multiplicative] - Sets ASM type, default is additive
+-  -pc_asm_threads <n> - solve the subdomains of each process with up to n threads concurrently
 
      IMPORTANT: If you run with, for example, 3 blocks on 1 processor or 3 blocks on 3 processors you
       will get a different convergence rate due to the default option of -pc_asm_type restrict. Use
@@ -1339,7 +1419,7 @@ PetscErrorCode  PCASMGetSubKSP(PC pc,PetscInt *n_local,PetscInt *first_local,KSP
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC,
            PCBJACOBI, PCASMGetSubKSP(), PCASMSetLocalSubdomains(), PCASMType, PCASMGetType(), PCASMSetLocalType(), PCASMGetLocalType()
-           PCASMSetTotalSubdomains(), PCSetModifySubMatrices(), PCASMSetOverlap(), PCASMSetType(), PCCompositeType
+           PCASMSetTotalSubdomains(), PCSetModifySubMatrices(), PCASMSetOverlap(), PCASMSetType(), PCCompositeType, PCASMSetThreads()
 
 M*/
 
@@ -1370,6 +1450,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_ASM(PC pc)
   osm->sort_indices      = PETSC_TRUE;
   osm->dm_subdomains     = PETSC_FALSE;
   osm->sub_mat_type      = NULL;
+  osm->nthreads          = 1;
 
   pc->data                 = (void*)osm;
   pc->ops->apply           = PCApply_ASM;
@@ -1390,6 +1471,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_ASM(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetType_C",PCASMGetType_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetLocalType_C",PCASMSetLocalType_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetLocalType_C",PCASMGetLocalType_ASM);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetThreads_C",PCASMSetThreads_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMSetSortIndices_C",PCASMSetSortIndices_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetSubKSP_C",PCASMGetSubKSP_ASM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCASMGetSubMatType_C",PCASMGetSubMatType_ASM);CHKERRQ(ierr);
@@ -119,6 +119,14 @@ PetscErrorCode PCSetFromOptions_BDDC(PetscOptionItems *PetscOptionsObject,PC pc)
   if (nt == 1) pcbddc->adaptive_threshold[1] = pcbddc->adaptive_threshold[0];
   ierr = PetscOptionsInt("-pc_bddc_adaptive_nmin","Minimum number of constraints per connected components","none",pcbddc->adaptive_nmin,&pcbddc->adaptive_nmin,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_bddc_adaptive_nmax","Maximum number of constraints per connected components","none",pcbddc->adaptive_nmax,&pcbddc->adaptive_nmax,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-pc_bddc_adaptive_reuse","Reuse the adaptively selected constraints if only the values of the operator change","none",pcbddc->adaptive_reuse,&pcbddc->adaptive_reuse,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-pc_bddc_threads","Number of threads working on different subsets concurrently during setup","none",pcbddc->nthreads,&pcbddc->nthreads,NULL);CHKERRQ(ierr);
+  if (pcbddc->nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",pcbddc->nthreads);
+#if !(defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY))
+  if (pcbddc->nthreads > 1) {
+    ierr = PetscInfo1(pc,"Working on the subsets one after another, %D threads require PETSc configured with OpenMP and --with-threadsafety\n",pcbddc->nthreads);CHKERRQ(ierr);
+  }
+#endif
   ierr = PetscOptionsBool("-pc_bddc_symmetric","Symmetric computation of primal basis functions","none",pcbddc->symmetric_primal,&pcbddc->symmetric_primal,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_bddc_coarse_adj","Number of processors where to map the coarse adjacency list","none",pcbddc->coarse_adj_red,&pcbddc->coarse_adj_red,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-pc_bddc_benign_trick","Apply the benign subspace trick to saddle point problems with discontinuous pressures","none",pcbddc->benign_saddle_point,&pcbddc->benign_saddle_point,NULL);CHKERRQ(ierr);
@@ -194,6 +202,12 @@ static PetscErrorCode PCView_BDDC(PC pc,PetscViewer viewer)
     }
     ierr = PetscViewerASCIIPrintf(viewer,"  Min constraints / connected component: %D\n",pcbddc->adaptive_nmin);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  Max constraints / connected component: %D\n",pcbddc->adaptive_nmax);CHKERRQ(ierr);
+    if (pcbddc->adaptive_reuse) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  Reuse adaptive constraints if only the values of the operator change: %d\n",pcbddc->adaptive_reuse);CHKERRQ(ierr);
+    }
+    if (pcbddc->nthreads > 1) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  Threads working on the subsets during setup: %D\n",pcbddc->nthreads);CHKERRQ(ierr);
+    }
     ierr = PetscViewerASCIIPrintf(viewer,"  Invert exact Schur complement for adaptive selection: %d\n",pcbddc->sub_schurs_exact_schur);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  Symmetric computation of primal basis functions: %d\n",pcbddc->symmetric_primal);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  Num. Procs. to map coarse adjacency list: %D\n",pcbddc->coarse_adj_red);CHKERRQ(ierr);
@@ -1597,7 +1611,7 @@ PetscErrorCode PCSetUp_BDDC(PC pc)
   PetscMPIInt     size;
   PetscBool       computesubschurs;
   PetscBool       computeconstraintsmatrix;
-  PetscBool       new_nearnullspace_provided,ismatis,rl;
+  PetscBool       new_nearnullspace_provided,ismatis,rl,reuseadaptive;
   PetscErrorCode  ierr;
 
   PetscFunctionBegin;
@@ -1750,24 +1764,6 @@ PetscErrorCode PCSetUp_BDDC(PC pc)
     ierr = PCBDDCScalingSetUp(pc);CHKERRQ(ierr);
   }
 
-  /* finish setup solvers and do adaptive selection of constraints */
-  sub_schurs = pcbddc->sub_schurs;
-  if (sub_schurs && sub_schurs->schur_explicit) {
-    if (computesubschurs) {
-      ierr = PCBDDCSetUpSubSchurs(pc);CHKERRQ(ierr);
-    }
-    ierr = PCBDDCSetUpLocalSolvers(pc,PETSC_TRUE,PETSC_FALSE);CHKERRQ(ierr);
-  } else {
-    ierr = PCBDDCSetUpLocalSolvers(pc,PETSC_TRUE,PETSC_FALSE);CHKERRQ(ierr);
-    if (computesubschurs) {
-      ierr = PCBDDCSetUpSubSchurs(pc);CHKERRQ(ierr);
-    }
-  }
-  if (pcbddc->adaptive_selection) {
-    ierr = PCBDDCAdaptiveSelection(pc);CHKERRQ(ierr);
-    computeconstraintsmatrix = PETSC_TRUE;
-  }
-
   /* infer if NullSpace object attached to Mat via MatSetNearNullSpace has changed */
   new_nearnullspace_provided = PETSC_FALSE;
   ierr = MatGetNearNullSpace(pc->pmat,&nearnullspace);CHKERRQ(ierr);
@@ -1801,6 +1797,34 @@ PetscErrorCode PCSetUp_BDDC(PC pc)
     }
   }
 
+  /* the adaptively selected constraints are reused if the user asked for it and the topology did not change */
+  reuseadaptive = (PetscBool)(pcbddc->adaptive_selection && pcbddc->adaptive_reuse && !computeconstraintsmatrix && !new_nearnullspace_provided && pcbddc->ConstraintMatrix);
+
+  /* finish setup solvers and do adaptive selection of constraints */
+  sub_schurs = pcbddc->sub_schurs;
+  if (sub_schurs) sub_schurs->skip_adaptive = reuseadaptive;
+  if (sub_schurs && sub_schurs->schur_explicit) {
+    if (computesubschurs) {
+      ierr = PCBDDCSetUpSubSchurs(pc);CHKERRQ(ierr);
+    }
+    ierr = PCBDDCSetUpLocalSolvers(pc,PETSC_TRUE,PETSC_FALSE);CHKERRQ(ierr);
+  } else {
+    ierr = PCBDDCSetUpLocalSolvers(pc,PETSC_TRUE,PETSC_FALSE);CHKERRQ(ierr);
+    if (computesubschurs) {
+      ierr = PCBDDCSetUpSubSchurs(pc);CHKERRQ(ierr);
+    }
+  }
+
+  /* adaptive selection of constraints: the eigenproblems, and the matrices that define them in PCBDDCSetUpSubSchurs(), are skipped when reusing the constraints */
+  if (pcbddc->adaptive_selection) {
+    if (reuseadaptive) {
+      ierr = PetscInfo(pc,"Reusing the adaptively selected constraints of the previous setup\n");CHKERRQ(ierr);
+    } else {
+      ierr = PCBDDCAdaptiveSelection(pc);CHKERRQ(ierr);
+      computeconstraintsmatrix = PETSC_TRUE;
+    }
+  }
+
   /* Setup constraints and related work vectors */
   /* reset primal space flags */
   ierr = PetscLogEventBegin(PC_BDDC_LocalWork[pcbddc->current_level],pc,0,0,0);CHKERRQ(ierr);
@@ -2956,7 +2980,7 @@ PetscErrorCode PCBDDCCreateFETIDPOperators(PC pc, PetscBool fully_redundant, con
 
    The PETSc implementation also supports multilevel BDDC [3]. Coarse grids are partitioned using a MatPartitioning object.
 
-   Adaptive selection of primal constraints [4] is supported for SPD systems with high-contrast in the coefficients if MUMPS or MKL_PARDISO are present. Future versions of the code will also consider using PASTIX.
+   Adaptive selection of primal constraints [4] is supported for SPD systems with high-contrast in the coefficients. It is efficient if MUMPS or MKL_PARDISO are present; otherwise, the Schur complements on the subsets are computed explicitly with the local solvers, which is only practical for small subdomains and does not support user-defined constraints, a change of basis or the benign trick. Future versions of the code will also consider using PASTIX.
 
    An experimental interface to the FETI-DP method is available. FETI-DP operators could be created using PCBDDCCreateFETIDPOperators(). A stand-alone class for the FETI-DP method will be provided in the next releases.
 
@@ -2974,7 +2998,9 @@ PetscErrorCode PCBDDCCreateFETIDPOperators(PC pc, PetscBool fully_redundant, con
 .    -pc_bddc_coarse_redistribute <0> - size of a subset of processors where the coarse problem will be remapped (the value is ignored if not at the coarsest level)
 .    -pc_bddc_use_deluxe_scaling <false> - use deluxe scaling
 .    -pc_bddc_schur_layers <\-1> - select the economic version of deluxe scaling by specifying the number of layers (-1 corresponds to the original deluxe scaling)
-.    -pc_bddc_adaptive_threshold <0.0> - when a value different than zero is specified, adaptive selection of constraints is performed on edges and faces (requires deluxe scaling and MUMPS or MKL_PARDISO installed)
+.    -pc_bddc_adaptive_threshold <0.0> - when a value different than zero is specified, adaptive selection of constraints is performed on edges and faces (efficient with MUMPS or MKL_PARDISO installed)
+.    -pc_bddc_adaptive_reuse <false> - reuse the adaptively selected constraints when the operator only changes its values, e.g. for a sequence of coefficients
+.    -pc_bddc_threads <1> - number of OpenMP threads solving the eigenproblems of the adaptive selection and inverting the Schur complements on different subsets concurrently (requires PETSc configured with OpenMP and --with-threadsafety)
 -    -pc_bddc_check_level <0> - set verbosity level of debugging output
 
    Options for Dirichlet, Neumann or coarse solver can be set with
@@ -3047,6 +3073,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_BDDC(PC pc)
   pcbddc->sub_schurs_layers         = -1;
   pcbddc->adaptive_threshold[0]     = 0.0;
   pcbddc->adaptive_threshold[1]     = 0.0;
+  pcbddc->nthreads                  = 1;
 
   /* function pointers */
   pc->ops->apply               = PCApply_BDDC;
@@ -179,12 +179,16 @@ typedef struct {
   PetscReal    adaptive_threshold[2];
   PetscInt     adaptive_nmin;
   PetscInt     adaptive_nmax;
+  PetscBool    adaptive_reuse;
   PetscInt*    adaptive_constraints_n;
   PetscInt*    adaptive_constraints_idxs;
   PetscInt*    adaptive_constraints_idxs_ptr;
   PetscScalar* adaptive_constraints_data;
   PetscInt*    adaptive_constraints_data_ptr;
 
+  /* threads working on different subsets concurrently during setup */
+  PetscInt     nthreads;
+
   /* For verbose output of some bddc data structures */
   PetscInt    dbg_flag;
   PetscViewer dbg_viewer;
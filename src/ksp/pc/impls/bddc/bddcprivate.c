@@ -7,6 +7,9 @@
 #include <petsc/private/sfimpl.h>
 #include <petsc/private/dmpleximpl.h>
 #include <petscdmda.h>
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#include <omp.h>
+#endif
 
 static PetscErrorCode MatMPIAIJRestrict(Mat,MPI_Comm,Mat*);
 
@@ -3125,26 +3128,429 @@ PetscErrorCode PCBDDCBenignPopOrPushB0(PC pc, PetscBool pop)
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode PCBDDCAdaptiveSelection(PC pc)
+/* settings shared by the generalized eigenproblems of all the subsets */
+typedef struct {
+  PetscBool allocated_S_St;
+  PetscInt  nmin,nmax;
+  PetscReal lthresh,uthresh;
+  PetscInt  recipe,recipe3_min,recipe3_min_scal;
+} PCBDDCAdaptiveCtx;
+
+/* LAPACK workspace of a thread */
+typedef struct {
+  PetscScalar  *S,*St,*eigv,*work;
+  PetscReal    *eigs,*rwork;
+  PetscBLASInt *iwork,*ifail,lwork;
+} PCBDDCAdaptiveWork;
+
+/*
+   PCBDDCAdaptiveSelectionSubset_Private - Solves the generalized eigenproblems of subset i, with the blocks of the sum of
+   the inverse Schur complements stored in Sarray and Starray, and copies the neigs selected eigenvectors into V.
+
+   It only works on the data of the subset and on the workspace w, so that different subsets can be processed concurrently;
+   debugging output is only printed when the subsets are processed one after another.
+*/
+static PetscErrorCode PCBDDCAdaptiveSelectionSubset_Private(PC pc,PetscInt i,PetscInt subset_size,PetscScalar *Sarray,PetscScalar *Starray,const PCBDDCAdaptiveCtx *ctx,PCBDDCAdaptiveWork *w,PetscInt *neigs,PetscScalar *V)
 {
-  PC_BDDC*        pcbddc = (PC_BDDC*)pc->data;
+  PC_BDDC         *pcbddc = (PC_BDDC*)pc->data;
   PCBDDCSubSchurs sub_schurs = pcbddc->sub_schurs;
-  PetscBLASInt    B_dummyint,B_neigs,B_ierr,B_lwork;
-  PetscBLASInt    *B_iwork,*B_ifail;
-  PetscScalar     *work,lwork;
-  PetscScalar     *St,*S,*eigv;
-  PetscScalar     *Sarray,*Starray;
-  PetscReal       *eigs,thresh,lthresh,uthresh;
-  PetscInt        i,nmax,nmin,nv,cum,mss,cum2,cumarray,maxneigs;
-  PetscBool       allocated_S_St;
+  PetscBLASInt    *B_iwork = w->iwork,*B_ifail = w->ifail,B_lwork = w->lwork;
+  PetscBLASInt    B_N,B_neigs = 0,B_ierr = 0;
+  PetscScalar     *S,*St,*eigv = w->eigv,*work = w->work;
+  PetscReal       *eigs = w->eigs,lthresh = ctx->lthresh,uthresh = ctx->uthresh,upper,lower;
 #if defined(PETSC_USE_COMPLEX)
-  PetscReal       *rwork;
+  PetscReal       *rwork = w->rwork;
 #endif
+  PetscInt        j,nmin = ctx->nmin,nmax = ctx->nmax,eigs_start = 0;
+  PetscBool       same_data = PETSC_FALSE;
+  PetscBool       scal = PETSC_FALSE;
   PetscErrorCode  ierr;
 
+  PetscFunctionBegin;
+  if (pcbddc->use_deluxe_scaling) {
+    upper = PETSC_MAX_REAL;
+    lower = uthresh;
+  } else {
+    if (!sub_schurs->is_posdef) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Not yet implemented without deluxe scaling");
+    upper = 1./uthresh;
+    lower = 0.;
+  }
+  ierr = PetscBLASIntCast(subset_size,&B_N);CHKERRQ(ierr);
+  /* this is experimental: we assume the dofs have been properly grouped to have
+     the diagonal blocks Schur complements either positive or negative definite (true for Stokes) */
+  if (!sub_schurs->is_posdef) {
+    for (j=0;j<subset_size;j++) {
+      if (PetscRealPart(Sarray[j*(subset_size+1)]) < 0.0) {
+        PetscInt k;
+
+        for (k=0;k<subset_size*subset_size;k++) {
+          Sarray[k]  *= -1.0;
+          Starray[k] *= -1.0;
+        }
+        if (sub_schurs->change_primal_sub) {
+          PetscInt       nz;
+          const PetscInt *idxs;
+
+          ierr = ISGetLocalSize(sub_schurs->change_primal_sub[i],&nz);CHKERRQ(ierr);
+          ierr = ISGetIndices(sub_schurs->change_primal_sub[i],&idxs);CHKERRQ(ierr);
+          for (k=0;k<nz;k++) {
+            Sarray [idxs[k]*(subset_size+1)] *= -1.0;
+            Starray[idxs[k]*(subset_size+1)]  = 0.0;
+          }
+          ierr = ISRestoreIndices(sub_schurs->change_primal_sub[i],&idxs);CHKERRQ(ierr);
+        }
+        scal = PETSC_TRUE;
+        break;
+      }
+    }
+  }
+
+  if (ctx->allocated_S_St) { /* S and S_t should be copied since we could need them later */
+    S  = w->S;
+    St = w->St;
+    if (sub_schurs->is_symmetric) {
+      PetscInt k;
+      if (sub_schurs->n_subs == 1) { /* zeroing memory to use PetscArraycmp() later */
+        ierr = PetscArrayzero(S,subset_size*subset_size);CHKERRQ(ierr);
+        ierr = PetscArrayzero(St,subset_size*subset_size);CHKERRQ(ierr);
+      }
+      for (j=0;j<subset_size;j++) {
+        for (k=j;k<subset_size;k++) {
+          S [j*subset_size+k] = Sarray [j*subset_size+k];
+          St[j*subset_size+k] = Starray[j*subset_size+k];
+        }
+      }
+    } else {
+      ierr = PetscArraycpy(S,Sarray,subset_size*subset_size);CHKERRQ(ierr);
+      ierr = PetscArraycpy(St,Starray,subset_size*subset_size);CHKERRQ(ierr);
+    }
+  } else {
+    S = Sarray;
+    St = Starray;
+  }
+  /* see if we can save some work */
+  if (sub_schurs->n_subs == 1 && pcbddc->use_deluxe_scaling) {
+    ierr = PetscArraycmp(S,St,subset_size*subset_size,&same_data);CHKERRQ(ierr);
+  }
+
+  if (same_data && !sub_schurs->change) { /* there's no need of constraints here */
+    B_neigs = 0;
+  } else {
+    if (sub_schurs->is_symmetric) {
+      PetscBLASInt B_itype = 1;
+      PetscBLASInt B_IL, B_IU;
+      PetscReal    eps = -1.0; /* dlamch? */
+      PetscInt     nmin_s;
+      PetscBool    compute_range;
+
+      B_neigs = 0;
+      compute_range = (PetscBool)!same_data;
+      if (nmin >= subset_size) compute_range = PETSC_FALSE;
+
+      if (pcbddc->dbg_flag) {
+        const PetscInt *idxs;
+        PetscInt       nc = 0;
+
+        if (sub_schurs->change_primal_sub) {
+          ierr = ISGetLocalSize(sub_schurs->change_primal_sub[i],&nc);CHKERRQ(ierr);
+        }
+        ierr = ISGetIndices(sub_schurs->is_subs[i],&idxs);CHKERRQ(ierr);
+        ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"Computing for sub %D/%D size %D count %D fid %D (range %d) (change %D).\n",i,sub_schurs->n_subs,subset_size,pcbddc->mat_graph->count[idxs[0]]+1,pcbddc->mat_graph->which_dof[idxs[0]],compute_range,nc);CHKERRQ(ierr);
+        ierr = ISRestoreIndices(sub_schurs->is_subs[i],&idxs);CHKERRQ(ierr);
+      }
+
+      if (compute_range) {
+
+        /* ask for eigenvalues larger than thresh */
+        if (sub_schurs->is_posdef) {
+#if defined(PETSC_USE_COMPLEX)
+          PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+          PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+          ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+        } else { /* no theory so far, but it works nicely */
+          PetscInt  recipe_m = scal ? ctx->recipe3_min_scal : ctx->recipe3_min;
+          PetscReal bb[2];
+
+          switch (ctx->recipe) {
+          case 0:
+            if (scal) { bb[0] = PETSC_MIN_REAL; bb[1] = lthresh; }
+            else { bb[0] = uthresh; bb[1] = PETSC_MAX_REAL; }
+#if defined(PETSC_USE_COMPLEX)
+            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+            ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+            break;
+          case 1:
+            bb[0] = PETSC_MIN_REAL; bb[1] = lthresh*lthresh;
+#if defined(PETSC_USE_COMPLEX)
+            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+            ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+            if (!scal) {
+              PetscBLASInt B_neigs2 = 0;
+
+              bb[0] = PetscMax(lthresh*lthresh,uthresh); bb[1] = PETSC_MAX_REAL;
+              ierr = PetscArraycpy(S,Sarray,subset_size*subset_size);CHKERRQ(ierr);
+              ierr = PetscArraycpy(St,Starray,subset_size*subset_size);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+              B_neigs += B_neigs2;
+            }
+            break;
+          case 2:
+            if (scal) {
+              bb[0] = PETSC_MIN_REAL;
+              bb[1] = 0;
+#if defined(PETSC_USE_COMPLEX)
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+            } else {
+              PetscBLASInt B_neigs2 = 0;
+              PetscBool    import = PETSC_FALSE;
+
+              lthresh = PetscMax(lthresh,0.0);
+              if (lthresh > 0.0) {
+                bb[0] = PETSC_MIN_REAL;
+                bb[1] = lthresh*lthresh;
+
+                import = PETSC_TRUE;
+#if defined(PETSC_USE_COMPLEX)
+                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+                ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+              }
+              bb[0] = PetscMax(lthresh*lthresh,uthresh);
+              bb[1] = PETSC_MAX_REAL;
+              if (import) {
+                ierr = PetscArraycpy(S,Sarray,subset_size*subset_size);CHKERRQ(ierr);
+                ierr = PetscArraycpy(St,Starray,subset_size*subset_size);CHKERRQ(ierr);
+              }
+#if defined(PETSC_USE_COMPLEX)
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+              B_neigs += B_neigs2;
+            }
+            break;
+          case 3:
+            if (!scal) {
+              bb[0] = uthresh;
+              bb[1] = PETSC_MAX_REAL;
+#if defined(PETSC_USE_COMPLEX)
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+            }
+            if (recipe_m > 0 && B_N - B_neigs > 0) {
+              PetscBLASInt B_neigs2 = 0;
+
+              B_IL = 1;
+              ierr = PetscBLASIntCast(PetscMin(recipe_m,B_N - B_neigs),&B_IU);CHKERRQ(ierr);
+              ierr = PetscArraycpy(S,Sarray,subset_size*subset_size);CHKERRQ(ierr);
+              ierr = PetscArraycpy(St,Starray,subset_size*subset_size);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+              B_neigs += B_neigs2;
+            }
+            break;
+          case 4:
+            bb[0] = PETSC_MIN_REAL; bb[1] = lthresh;
+#if defined(PETSC_USE_COMPLEX)
+            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+            ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+            {
+              PetscBLASInt B_neigs2 = 0;
+
+              bb[0] = PetscMax(lthresh+PETSC_SMALL,uthresh); bb[1] = PETSC_MAX_REAL;
+              ierr = PetscArraycpy(S,Sarray,subset_size*subset_size);CHKERRQ(ierr);
+              ierr = PetscArraycpy(St,Starray,subset_size*subset_size);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+              B_neigs += B_neigs2;
+            }
+            break;
+          case 5: /* same as before: first compute all eigenvalues, then filter */
+#if defined(PETSC_USE_COMPLEX)
+            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","A","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","A","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+            ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+            {
+              PetscInt e,k,ne;
+              for (e=0,ne=0;e<B_neigs;e++) {
+                if (eigs[e] < lthresh || eigs[e] > uthresh) {
+                  for (k=0;k<B_N;k++) S[ne*B_N+k] = eigv[e*B_N+k];
+                  eigs[ne] = eigs[e];
+                  ne++;
+                }
+              }
+              ierr = PetscArraycpy(eigv,S,B_N*ne);CHKERRQ(ierr);
+              B_neigs = ne;
+            }
+            break;
+          default:
+            SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"Unknown recipe %D",ctx->recipe);
+          }
+        }
+      } else if (!same_data) { /* this is just to see all the eigenvalues */
+        B_IU = PetscMax(1,PetscMin(B_N,nmax));
+        B_IL = 1;
+#if defined(PETSC_USE_COMPLEX)
+        PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+        PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+        ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+      } else { /* same_data is true, so just get the adaptive functional requested by the user */
+        PetscInt k;
+        if (!sub_schurs->change_primal_sub) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"This should not happen");
+        ierr = ISGetLocalSize(sub_schurs->change_primal_sub[i],&nmax);CHKERRQ(ierr);
+        ierr = PetscBLASIntCast(nmax,&B_neigs);CHKERRQ(ierr);
+        nmin = nmax;
+        ierr = PetscArrayzero(eigv,subset_size*nmax);CHKERRQ(ierr);
+        for (k=0;k<nmax;k++) {
+          eigs[k] = 1./PETSC_SMALL;
+          eigv[k*(subset_size+1)] = 1.0;
+        }
+      }
+      if (B_ierr) {
+        if (B_ierr < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: illegal value for argument %d",-(int)B_ierr);
+        else if (B_ierr <= B_N) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: %d eigenvalues failed to converge",(int)B_ierr);
+        else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: leading minor of order %d is not positive definite",(int)B_ierr-B_N-1);
+      }
+
+      if (B_neigs > nmax) {
+        if (pcbddc->dbg_flag) {
+          ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   found %d eigs, more than maximum required %D.\n",B_neigs,nmax);CHKERRQ(ierr);
+        }
+        if (pcbddc->use_deluxe_scaling) eigs_start = scal ? 0 : B_neigs-nmax;
+        B_neigs = nmax;
+      }
+
+      nmin_s = PetscMin(nmin,B_N);
+      if (B_neigs < nmin_s) {
+        PetscBLASInt B_neigs2 = 0;
+
+        if (pcbddc->use_deluxe_scaling) {
+          if (scal) {
+            B_IU = nmin_s;
+            B_IL = B_neigs + 1;
+          } else {
+            B_IL = B_N - nmin_s + 1;
+            B_IU = B_N - B_neigs;
+          }
+        } else {
+          B_IL = B_neigs + 1;
+          B_IU = nmin_s;
+        }
+        if (pcbddc->dbg_flag) {
+          ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   found %d eigs, less than minimum required %D. Asking for %d to %d incl (fortran like)\n",B_neigs,nmin,B_IL,B_IU);CHKERRQ(ierr);
+        }
+        if (sub_schurs->is_symmetric) {
+          PetscInt k;
+          for (j=0;j<subset_size;j++) {
+            for (k=j;k<subset_size;k++) {
+              S [j*subset_size+k] = Sarray [j*subset_size+k];
+              St[j*subset_size+k] = Starray[j*subset_size+k];
+            }
+          }
+        } else {
+          ierr = PetscArraycpy(S,Sarray,subset_size*subset_size);CHKERRQ(ierr);
+          ierr = PetscArraycpy(St,Starray,subset_size*subset_size);CHKERRQ(ierr);
+        }
+#if defined(PETSC_USE_COMPLEX)
+        PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*subset_size,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
+#else
+        PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*subset_size,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+#endif
+        ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
+        B_neigs += B_neigs2;
+      }
+      if (B_ierr) {
+        if (B_ierr < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: illegal value for argument %d",-(int)B_ierr);
+        else if (B_ierr <= B_N) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: %d eigenvalues failed to converge",(int)B_ierr);
+        else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: leading minor of order %d is not positive definite",(int)B_ierr-B_N-1);
+      }
+      if (pcbddc->dbg_flag) {
+        ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   -> Got %d eigs\n",B_neigs);CHKERRQ(ierr);
+        for (j=0;j<B_neigs;j++) {
+          if (eigs[j] == 0.0) {
+            ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"     Inf\n");CHKERRQ(ierr);
+          } else {
+            if (pcbddc->use_deluxe_scaling) {
+              ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"     %1.6e\n",eigs[j+eigs_start]);CHKERRQ(ierr);
+            } else {
+              ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"     %1.6e\n",1./eigs[j+eigs_start]);CHKERRQ(ierr);
+            }
+          }
+        }
+      }
+    } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Not yet implemented");
+  }
+  *neigs = B_neigs;
+  ierr = PetscArraycpy(V,eigv+eigs_start*subset_size,B_neigs*subset_size);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCBDDCAdaptiveSelection - Computes the adaptive constraints of all the subsets.
+
+   The generalized eigenproblems of different subsets are independent: with -pc_bddc_threads up to that many OpenMP threads
+   solve them concurrently, each with its own LAPACK workspace, and the eigenvectors are stored in slots of the largest size
+   they can have. The change of basis and the compaction of the constraints into the adaptive_constraints arrays follow
+   in order of the subsets. Threads are only used when PETSc is configured with OpenMP and --with-threadsafety and
+   without debugging output of PCBDDC.
+*/
+PetscErrorCode PCBDDCAdaptiveSelection(PC pc)
+{
+  PC_BDDC*           pcbddc = (PC_BDDC*)pc->data;
+  PCBDDCSubSchurs    sub_schurs = pcbddc->sub_schurs;
+  PCBDDCAdaptiveCtx  ctx;
+  PCBDDCAdaptiveWork *w;
+  PetscBLASInt       B_dummyint,B_neigs,B_ierr,B_lwork;
+  PetscScalar        *Sarray = NULL,*Starray = NULL,*S,*St,*eigv,*work,lwork;
+  PetscReal          *eigs,thresh;
+  PetscInt           i,t,nt,nv,cum,mss,cum2,maxneigs;
+  PetscInt           *sizes,*offs,*slots;
+  PetscBLASInt       *B_iwork,*B_ifail;
+#if defined(PETSC_USE_COMPLEX)
+  PetscReal          *rwork;
+#endif
+  PetscErrorCode     ierr = 0;
+
   PetscFunctionBegin;
   if (!sub_schurs) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Adaptive selection of constraints requires SubSchurs data");
-  if (!sub_schurs->schur_explicit) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Adaptive selection of constraints requires MUMPS and/or MKL_CPARDISO");
   if (sub_schurs->n_subs && (!sub_schurs->is_symmetric)) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_SUP,"Adaptive selection not yet implemented for this matrix pencil (herm %d, symm %d, posdef %d)",sub_schurs->is_hermitian,sub_schurs->is_symmetric,sub_schurs->is_posdef);
   ierr = PetscLogEventBegin(PC_BDDC_AdaptiveSetUp[pcbddc->current_level],pc,0,0,0);CHKERRQ(ierr);
 
@@ -3159,36 +3565,51 @@ PetscErrorCode PCBDDCAdaptiveSelection(PC pc)
     ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"Subdomain %04d cc %D (%d,%d).\n",PetscGlobalRank,sub_schurs->n_subs,sub_schurs->is_hermitian,sub_schurs->is_posdef);CHKERRQ(ierr);
   }
 
-  /* max size of subsets */
+  /* sizes of subsets and max size */
+  ierr = PetscMalloc3(sub_schurs->n_subs,&sizes,sub_schurs->n_subs+1,&offs,sub_schurs->n_subs+1,&slots);CHKERRQ(ierr);
   mss = 0;
   for (i=0;i<sub_schurs->n_subs;i++) {
-    PetscInt subset_size;
-
-    ierr = ISGetLocalSize(sub_schurs->is_subs[i],&subset_size);CHKERRQ(ierr);
-    mss = PetscMax(mss,subset_size);
+    ierr = ISGetLocalSize(sub_schurs->is_subs[i],&sizes[i]);CHKERRQ(ierr);
+    mss = PetscMax(mss,sizes[i]);
   }
 
   /* min/max and threshold */
-  nmax = pcbddc->adaptive_nmax > 0 ? pcbddc->adaptive_nmax : mss;
-  nmin = pcbddc->adaptive_nmin > 0 ? pcbddc->adaptive_nmin : 0;
-  nmax = PetscMax(nmin,nmax);
-  allocated_S_St = PETSC_FALSE;
-  if (nmin || !sub_schurs->is_posdef) { /* XXX */
-    allocated_S_St = PETSC_TRUE;
+  ctx.nmax = pcbddc->adaptive_nmax > 0 ? pcbddc->adaptive_nmax : mss;
+  ctx.nmin = pcbddc->adaptive_nmin > 0 ? pcbddc->adaptive_nmin : 0;
+  ctx.nmax = PetscMax(ctx.nmin,ctx.nmax);
+  ctx.allocated_S_St = PETSC_FALSE;
+  if (ctx.nmin || !sub_schurs->is_posdef) { /* XXX */
+    ctx.allocated_S_St = PETSC_TRUE;
+  }
+  ctx.lthresh = pcbddc->adaptive_threshold[0];
+  ctx.uthresh = pcbddc->adaptive_threshold[1];
+  ctx.recipe = 0;
+  ctx.recipe3_min = ctx.recipe3_min_scal = 1;
+  if (!sub_schurs->is_posdef) {
+    ierr = PetscOptionsGetInt(NULL,((PetscObject)pc)->prefix,"-pc_bddc_adaptive_recipe",&ctx.recipe,NULL);CHKERRQ(ierr);
+    if (ctx.recipe < 0 || ctx.recipe > 5) SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Unknown recipe %D",ctx.recipe);
+    ierr = PetscOptionsGetInt(NULL,((PetscObject)pc)->prefix,"-pc_bddc_adaptive_recipe3_min",&ctx.recipe3_min,NULL);CHKERRQ(ierr);
+    ierr = PetscOptionsGetInt(NULL,((PetscObject)pc)->prefix,"-pc_bddc_adaptive_recipe3_min_scal",&ctx.recipe3_min_scal,NULL);CHKERRQ(ierr);
+  }
+
+  /* offsets of the blocks of the subsets and slots for their eigenvectors */
+  nv = 0;
+  if (sub_schurs->is_vertices && pcbddc->use_vertices) { /* complement set of active subsets, each entry is a vertex (boundary made by active subsets, vertices and dirichlet dofs) */
+    ierr = ISGetLocalSize(sub_schurs->is_vertices,&nv);CHKERRQ(ierr);
   }
-
-  /* allocate lapack workspace */
-  cum = cum2 = 0;
-  maxneigs = 0;
+  cum = 0;
+  offs[0] = 0;
+  slots[0] = nv;
   for (i=0;i<sub_schurs->n_subs;i++) {
-    PetscInt n,subset_size;
+    PetscInt n = sub_schurs->n_subs == 1 ? sizes[i] : PetscMin(sizes[i],ctx.nmax); /* with a single subset, the user may ask for all the modes */
 
-    ierr = ISGetLocalSize(sub_schurs->is_subs[i],&subset_size);CHKERRQ(ierr);
-    n = PetscMin(subset_size,nmax);
-    cum += subset_size;
-    cum2 += subset_size*n;
-    maxneigs = PetscMax(maxneigs,n);
+    cum += sizes[i];
+    offs[i+1] = offs[i] + sizes[i]*sizes[i];
+    slots[i+1] = slots[i] + sizes[i]*n;
   }
+  cum2 = slots[sub_schurs->n_subs] - nv;
+
+  /* allocate lapack workspace */
   lwork = 0;
   if (mss) {
     if (sub_schurs->is_symmetric) {
@@ -3220,19 +3641,38 @@ PetscErrorCode PCBDDCAdaptiveSelection(PC pc)
       ierr = PetscFPTrapPop();CHKERRQ(ierr);
     } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Not yet implemented");
   }
-
-  nv = 0;
-  if (sub_schurs->is_vertices && pcbddc->use_vertices) { /* complement set of active subsets, each entry is a vertex (boundary made by active subsets, vertices and dirichlet dofs) */
-    ierr = ISGetLocalSize(sub_schurs->is_vertices,&nv);CHKERRQ(ierr);
-  }
   ierr = PetscBLASIntCast((PetscInt)PetscRealPart(lwork),&B_lwork);CHKERRQ(ierr);
-  if (allocated_S_St) {
-    ierr = PetscMalloc2(mss*mss,&S,mss*mss,&St);CHKERRQ(ierr);
+
+  /* one workspace per thread */
+  nt = 1;
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  if (!pcbddc->dbg_flag) nt = PetscMax(1,PetscMin(pcbddc->nthreads,sub_schurs->n_subs));
+#endif
+  ierr = PetscMalloc1(nt,&w);CHKERRQ(ierr);
+  S = St = NULL;
+  if (ctx.allocated_S_St) {
+    ierr = PetscMalloc2(nt*mss*mss,&S,nt*mss*mss,&St);CHKERRQ(ierr);
   }
-  ierr = PetscMalloc5(mss*mss,&eigv,mss,&eigs,B_lwork,&work,5*mss,&B_iwork,mss,&B_ifail);CHKERRQ(ierr);
+  ierr = PetscMalloc5(nt*mss*mss,&eigv,nt*mss,&eigs,nt*B_lwork,&work,nt*5*mss,&B_iwork,nt*mss,&B_ifail);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+  ierr = PetscMalloc1(nt*7*mss,&rwork);CHKERRQ(ierr);
+#endif
+  for (t=0;t<nt;t++) {
+    w[t].S     = S ? S + t*mss*mss : NULL;
+    w[t].St    = St ? St + t*mss*mss : NULL;
+    w[t].eigv  = eigv + t*mss*mss;
+    w[t].eigs  = eigs + t*mss;
+    w[t].work  = work + t*B_lwork;
+    w[t].iwork = B_iwork + t*5*mss;
+    w[t].ifail = B_ifail + t*mss;
+    w[t].lwork = B_lwork;
 #if defined(PETSC_USE_COMPLEX)
-  ierr = PetscMalloc1(7*mss,&rwork);CHKERRQ(ierr);
+    w[t].rwork = rwork + t*7*mss;
+#else
+    w[t].rwork = NULL;
 #endif
+  }
+
   ierr = PetscMalloc5(nv+sub_schurs->n_subs,&pcbddc->adaptive_constraints_n,
                       nv+sub_schurs->n_subs+1,&pcbddc->adaptive_constraints_idxs_ptr,
                       nv+sub_schurs->n_subs+1,&pcbddc->adaptive_constraints_data_ptr,
@@ -3241,7 +3681,7 @@ PetscErrorCode PCBDDCAdaptiveSelection(PC pc)
   ierr = PetscArrayzero(pcbddc->adaptive_constraints_n,nv+sub_schurs->n_subs);CHKERRQ(ierr);
 
   maxneigs = 0;
-  cum = cumarray = 0;
+  cum = 0;
   pcbddc->adaptive_constraints_idxs_ptr[0] = 0;
   pcbddc->adaptive_constraints_data_ptr[0] = 0;
   if (sub_schurs->is_vertices && pcbddc->use_vertices) {
@@ -3263,412 +3703,72 @@ PetscErrorCode PCBDDCAdaptiveSelection(PC pc)
     ierr = MatSeqAIJGetArray(sub_schurs->sum_S_Ej_tilda_all,&Starray);CHKERRQ(ierr);
   }
 
-  lthresh = pcbddc->adaptive_threshold[0];
-  uthresh = pcbddc->adaptive_threshold[1];
-  for (i=0;i<sub_schurs->n_subs;i++) {
-    const PetscInt *idxs;
-    PetscReal      upper,lower;
-    PetscInt       j,subset_size,eigs_start = 0;
-    PetscBLASInt   B_N;
-    PetscBool      same_data = PETSC_FALSE;
-    PetscBool      scal = PETSC_FALSE;
-
-    if (pcbddc->use_deluxe_scaling) {
-      upper = PETSC_MAX_REAL;
-      lower = uthresh;
-    } else {
-      if (!sub_schurs->is_posdef) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Not yet implemented without deluxe scaling");
-      upper = 1./uthresh;
-      lower = 0.;
-    }
-    ierr = ISGetLocalSize(sub_schurs->is_subs[i],&subset_size);CHKERRQ(ierr);
-    ierr = ISGetIndices(sub_schurs->is_subs[i],&idxs);CHKERRQ(ierr);
-    ierr = PetscBLASIntCast(subset_size,&B_N);CHKERRQ(ierr);
-    /* this is experimental: we assume the dofs have been properly grouped to have
-       the diagonal blocks Schur complements either positive or negative definite (true for Stokes) */
-    if (!sub_schurs->is_posdef) {
-      Mat T;
-
-      for (j=0;j<subset_size;j++) {
-        if (PetscRealPart(*(Sarray+cumarray+j*(subset_size+1))) < 0.0) {
-          ierr = MatCreateSeqDense(PETSC_COMM_SELF,subset_size,subset_size,Sarray+cumarray,&T);CHKERRQ(ierr);
-          ierr = MatScale(T,-1.0);CHKERRQ(ierr);
-          ierr = MatDestroy(&T);CHKERRQ(ierr);
-          ierr = MatCreateSeqDense(PETSC_COMM_SELF,subset_size,subset_size,Starray+cumarray,&T);CHKERRQ(ierr);
-          ierr = MatScale(T,-1.0);CHKERRQ(ierr);
-          ierr = MatDestroy(&T);CHKERRQ(ierr);
-          if (sub_schurs->change_primal_sub) {
-            PetscInt       nz,k;
-            const PetscInt *idxs;
-
-            ierr = ISGetLocalSize(sub_schurs->change_primal_sub[i],&nz);CHKERRQ(ierr);
-            ierr = ISGetIndices(sub_schurs->change_primal_sub[i],&idxs);CHKERRQ(ierr);
-            for (k=0;k<nz;k++) {
-              *( Sarray + cumarray + idxs[k]*(subset_size+1)) *= -1.0;
-              *(Starray + cumarray + idxs[k]*(subset_size+1))  = 0.0;
-            }
-            ierr = ISRestoreIndices(sub_schurs->change_primal_sub[i],&idxs);CHKERRQ(ierr);
-          }
-          scal = PETSC_TRUE;
-          break;
-        }
-      }
-    }
+  /* solve the eigenproblems of the subsets */
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  if (nt > 1) {
+    PetscErrorCode ierrt = 0;
 
-    if (allocated_S_St) { /* S and S_t should be copied since we could need them later */
-      if (sub_schurs->is_symmetric) {
-        PetscInt j,k;
-        if (sub_schurs->n_subs == 1) { /* zeroing memory to use PetscArraycmp() later */
-          ierr = PetscArrayzero(S,subset_size*subset_size);CHKERRQ(ierr);
-          ierr = PetscArrayzero(St,subset_size*subset_size);CHKERRQ(ierr);
-        }
-        for (j=0;j<subset_size;j++) {
-          for (k=j;k<subset_size;k++) {
-            S [j*subset_size+k] = Sarray [cumarray+j*subset_size+k];
-            St[j*subset_size+k] = Starray[cumarray+j*subset_size+k];
-          }
-        }
-      } else {
-        ierr = PetscArraycpy(S,Sarray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-        ierr = PetscArraycpy(St,Starray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
+    #pragma omp parallel for num_threads((int)nt) schedule(dynamic,1) private(ierr)
+    for (i=0;i<sub_schurs->n_subs;i++) {
+      ierr = PCBDDCAdaptiveSelectionSubset_Private(pc,i,sizes[i],Sarray+offs[i],Starray+offs[i],&ctx,&w[omp_get_thread_num()],&pcbddc->adaptive_constraints_n[i+nv],pcbddc->adaptive_constraints_data+slots[i]);
+      if (ierr) {
+        #pragma omp critical
+        ierrt = ierr;
       }
-    } else {
-      S = Sarray + cumarray;
-      St = Starray + cumarray;
-    }
-    /* see if we can save some work */
-    if (sub_schurs->n_subs == 1 && pcbddc->use_deluxe_scaling) {
-      ierr = PetscArraycmp(S,St,subset_size*subset_size,&same_data);CHKERRQ(ierr);
     }
-
-    if (same_data && !sub_schurs->change) { /* there's no need of constraints here */
-      B_neigs = 0;
-    } else {
-      if (sub_schurs->is_symmetric) {
-        PetscBLASInt B_itype = 1;
-        PetscBLASInt B_IL, B_IU;
-        PetscReal    eps = -1.0; /* dlamch? */
-        PetscInt     nmin_s;
-        PetscBool    compute_range;
-
-        B_neigs = 0;
-        compute_range = (PetscBool)!same_data;
-        if (nmin >= subset_size) compute_range = PETSC_FALSE;
-
-        if (pcbddc->dbg_flag) {
-          PetscInt nc = 0;
-
-          if (sub_schurs->change_primal_sub) {
-            ierr = ISGetLocalSize(sub_schurs->change_primal_sub[i],&nc);CHKERRQ(ierr);
-          }
-          ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"Computing for sub %D/%D size %D count %D fid %D (range %d) (change %D).\n",i,sub_schurs->n_subs,subset_size,pcbddc->mat_graph->count[idxs[0]]+1,pcbddc->mat_graph->which_dof[idxs[0]],compute_range,nc);CHKERRQ(ierr);
-        }
-
-        ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
-        if (compute_range) {
-
-          /* ask for eigenvalues larger than thresh */
-          if (sub_schurs->is_posdef) {
-#if defined(PETSC_USE_COMPLEX)
-            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-            PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-            ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-          } else { /* no theory so far, but it works nicely */
-            PetscInt  recipe = 0,recipe_m = 1;
-            PetscReal bb[2];
-
-            ierr = PetscOptionsGetInt(NULL,((PetscObject)pc)->prefix,"-pc_bddc_adaptive_recipe",&recipe,NULL);CHKERRQ(ierr);
-            switch (recipe) {
-            case 0:
-              if (scal) { bb[0] = PETSC_MIN_REAL; bb[1] = lthresh; }
-              else { bb[0] = uthresh; bb[1] = PETSC_MAX_REAL; }
-#if defined(PETSC_USE_COMPLEX)
-              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-              break;
-            case 1:
-              bb[0] = PETSC_MIN_REAL; bb[1] = lthresh*lthresh;
-#if defined(PETSC_USE_COMPLEX)
-              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
+    CHKERRQ(ierrt);
+  } else
 #endif
-              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-              if (!scal) {
-                PetscBLASInt B_neigs2 = 0;
-
-                bb[0] = PetscMax(lthresh*lthresh,uthresh); bb[1] = PETSC_MAX_REAL;
-                ierr = PetscArraycpy(S,Sarray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-                ierr = PetscArraycpy(St,Starray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-#if defined(PETSC_USE_COMPLEX)
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-                ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-                B_neigs += B_neigs2;
-              }
-              break;
-            case 2:
-              if (scal) {
-                bb[0] = PETSC_MIN_REAL;
-                bb[1] = 0;
-#if defined(PETSC_USE_COMPLEX)
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-                ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-              } else {
-                PetscBLASInt B_neigs2 = 0;
-                PetscBool    import = PETSC_FALSE;
-
-                lthresh = PetscMax(lthresh,0.0);
-                if (lthresh > 0.0) {
-                  bb[0] = PETSC_MIN_REAL;
-                  bb[1] = lthresh*lthresh;
-
-                  import = PETSC_TRUE;
-#if defined(PETSC_USE_COMPLEX)
-                  PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-                  PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-                  ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-                }
-                bb[0] = PetscMax(lthresh*lthresh,uthresh);
-                bb[1] = PETSC_MAX_REAL;
-                if (import) {
-                  ierr = PetscArraycpy(S,Sarray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-                  ierr = PetscArraycpy(St,Starray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-                }
-#if defined(PETSC_USE_COMPLEX)
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-                ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-                B_neigs += B_neigs2;
-              }
-              break;
-            case 3:
-              if (scal) {
-                ierr = PetscOptionsGetInt(NULL,((PetscObject)pc)->prefix,"-pc_bddc_adaptive_recipe3_min_scal",&recipe_m,NULL);CHKERRQ(ierr);
-              } else {
-                ierr = PetscOptionsGetInt(NULL,((PetscObject)pc)->prefix,"-pc_bddc_adaptive_recipe3_min",&recipe_m,NULL);CHKERRQ(ierr);
-              }
-              if (!scal) {
-                bb[0] = uthresh;
-                bb[1] = PETSC_MAX_REAL;
-#if defined(PETSC_USE_COMPLEX)
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-                ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-              }
-              if (recipe_m > 0 && B_N - B_neigs > 0) {
-                PetscBLASInt B_neigs2 = 0;
-
-                B_IL = 1;
-                ierr = PetscBLASIntCast(PetscMin(recipe_m,B_N - B_neigs),&B_IU);CHKERRQ(ierr);
-                ierr = PetscArraycpy(S,Sarray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-                ierr = PetscArraycpy(St,Starray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-#if defined(PETSC_USE_COMPLEX)
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-                ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-                B_neigs += B_neigs2;
-              }
-              break;
-            case 4:
-              bb[0] = PETSC_MIN_REAL; bb[1] = lthresh;
-#if defined(PETSC_USE_COMPLEX)
-              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-              {
-                PetscBLASInt B_neigs2 = 0;
-
-                bb[0] = PetscMax(lthresh+PETSC_SMALL,uthresh); bb[1] = PETSC_MAX_REAL;
-                ierr = PetscArraycpy(S,Sarray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-                ierr = PetscArraycpy(St,Starray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-#if defined(PETSC_USE_COMPLEX)
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-                PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","V","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*B_N,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-                ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-                B_neigs += B_neigs2;
-              }
-              break;
-            case 5: /* same as before: first compute all eigenvalues, then filter */
-#if defined(PETSC_USE_COMPLEX)
-              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","A","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-              PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","A","L",&B_N,St,&B_N,S,&B_N,&bb[0],&bb[1],&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-              ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-              {
-                PetscInt e,k,ne;
-                for (e=0,ne=0;e<B_neigs;e++) {
-                  if (eigs[e] < lthresh || eigs[e] > uthresh) {
-                    for (k=0;k<B_N;k++) S[ne*B_N+k] = eigv[e*B_N+k];
-                    eigs[ne] = eigs[e];
-                    ne++;
-                  }
-                }
-                ierr = PetscArraycpy(eigv,S,B_N*ne);CHKERRQ(ierr);
-                B_neigs = ne;
-              }
-              break;
-            default:
-              SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Unknown recipe %D",recipe);
-            }
-          }
-        } else if (!same_data) { /* this is just to see all the eigenvalues */
-          B_IU = PetscMax(1,PetscMin(B_N,nmax));
-          B_IL = 1;
-#if defined(PETSC_USE_COMPLEX)
-          PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-          PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs,eigs,eigv,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-          ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-        } else { /* same_data is true, so just get the adaptive functional requested by the user */
-          PetscInt k;
-          if (!sub_schurs->change_primal_sub) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"This should not happen");
-          ierr = ISGetLocalSize(sub_schurs->change_primal_sub[i],&nmax);CHKERRQ(ierr);
-          ierr = PetscBLASIntCast(nmax,&B_neigs);CHKERRQ(ierr);
-          nmin = nmax;
-          ierr = PetscArrayzero(eigv,subset_size*nmax);CHKERRQ(ierr);
-          for (k=0;k<nmax;k++) {
-            eigs[k] = 1./PETSC_SMALL;
-            eigv[k*(subset_size+1)] = 1.0;
-          }
-        }
-        ierr = PetscFPTrapPop();CHKERRQ(ierr);
-        if (B_ierr) {
-          if (B_ierr < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: illegal value for argument %d",-(int)B_ierr);
-          else if (B_ierr <= B_N) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: %d eigenvalues failed to converge",(int)B_ierr);
-          else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: leading minor of order %d is not positive definite",(int)B_ierr-B_N-1);
-        }
-
-        if (B_neigs > nmax) {
-          if (pcbddc->dbg_flag) {
-            ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   found %d eigs, more than maximum required %D.\n",B_neigs,nmax);CHKERRQ(ierr);
-          }
-          if (pcbddc->use_deluxe_scaling) eigs_start = scal ? 0 : B_neigs-nmax;
-          B_neigs = nmax;
-        }
+  {
+    for (i=0;i<sub_schurs->n_subs;i++) {
+      ierr = PCBDDCAdaptiveSelectionSubset_Private(pc,i,sizes[i],Sarray+offs[i],Starray+offs[i],&ctx,&w[0],&pcbddc->adaptive_constraints_n[i+nv],pcbddc->adaptive_constraints_data+slots[i]);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
 
-        nmin_s = PetscMin(nmin,B_N);
-        if (B_neigs < nmin_s) {
-          PetscBLASInt B_neigs2 = 0;
+  /* change the basis back to the original one and compact the constraints */
+  for (i=0;i<sub_schurs->n_subs;i++) {
+    const PetscInt *idxs;
+    PetscInt       j,subset_size = sizes[i];
+    PetscInt       B_neigs = pcbddc->adaptive_constraints_n[i+nv];
+    PetscScalar    *V = pcbddc->adaptive_constraints_data+slots[i];
 
-          if (pcbddc->use_deluxe_scaling) {
-            if (scal) {
-              B_IU = nmin_s;
-              B_IL = B_neigs + 1;
-            } else {
-              B_IL = B_N - nmin_s + 1;
-              B_IU = B_N - B_neigs;
-            }
-          } else {
-            B_IL = B_neigs + 1;
-            B_IU = nmin_s;
-          }
-          if (pcbddc->dbg_flag) {
-            ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   found %d eigs, less than minimum required %D. Asking for %d to %d incl (fortran like)\n",B_neigs,nmin,B_IL,B_IU);CHKERRQ(ierr);
-          }
-          if (sub_schurs->is_symmetric) {
-            PetscInt j,k;
-            for (j=0;j<subset_size;j++) {
-              for (k=j;k<subset_size;k++) {
-                S [j*subset_size+k] = Sarray [cumarray+j*subset_size+k];
-                St[j*subset_size+k] = Starray[cumarray+j*subset_size+k];
-              }
-            }
-          } else {
-            ierr = PetscArraycpy(S,Sarray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-            ierr = PetscArraycpy(St,Starray+cumarray,subset_size*subset_size);CHKERRQ(ierr);
-          }
-          ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
-#if defined(PETSC_USE_COMPLEX)
-          PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*subset_size,&B_N,work,&B_lwork,rwork,B_iwork,B_ifail,&B_ierr));
-#else
-          PetscStackCallBLAS("LAPACKsygvx",LAPACKsygvx_(&B_itype,"V","I","L",&B_N,St,&B_N,S,&B_N,&lower,&upper,&B_IL,&B_IU,&eps,&B_neigs2,eigs+B_neigs,eigv+B_neigs*subset_size,&B_N,work,&B_lwork,B_iwork,B_ifail,&B_ierr));
-#endif
-          ierr = PetscLogFlops((4.0*subset_size*subset_size*subset_size)/3.0);CHKERRQ(ierr);
-          ierr = PetscFPTrapPop();CHKERRQ(ierr);
-          B_neigs += B_neigs2;
-        }
-        if (B_ierr) {
-          if (B_ierr < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: illegal value for argument %d",-(int)B_ierr);
-          else if (B_ierr <= B_N) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: %d eigenvalues failed to converge",(int)B_ierr);
-          else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYGVX Lapack routine: leading minor of order %d is not positive definite",(int)B_ierr-B_N-1);
-        }
-        if (pcbddc->dbg_flag) {
-          ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   -> Got %d eigs\n",B_neigs);CHKERRQ(ierr);
-          for (j=0;j<B_neigs;j++) {
-            if (eigs[j] == 0.0) {
-              ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"     Inf\n");CHKERRQ(ierr);
-            } else {
-              if (pcbddc->use_deluxe_scaling) {
-                ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"     %1.6e\n",eigs[j+eigs_start]);CHKERRQ(ierr);
-              } else {
-                ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"     %1.6e\n",1./eigs[j+eigs_start]);CHKERRQ(ierr);
-              }
-            }
-          }
-        }
-      } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Not yet implemented");
-    }
-    /* change the basis back to the original one */
     if (sub_schurs->change) {
       Mat change,phi,phit;
 
       if (pcbddc->dbg_flag > 2) {
         PetscInt ii;
         for (ii=0;ii<B_neigs;ii++) {
-          ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   -> Eigenvector (old basis) %d/%d (%d)\n",ii,B_neigs,B_N);CHKERRQ(ierr);
-          for (j=0;j<B_N;j++) {
+          ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   -> Eigenvector (old basis) %D/%D (%D)\n",ii,B_neigs,subset_size);CHKERRQ(ierr);
+          for (j=0;j<subset_size;j++) {
 #if defined(PETSC_USE_COMPLEX)
-            PetscReal r = PetscRealPart(eigv[(ii+eigs_start)*subset_size+j]);
-            PetscReal c = PetscImaginaryPart(eigv[(ii+eigs_start)*subset_size+j]);
+            PetscReal r = PetscRealPart(V[ii*subset_size+j]);
+            PetscReal c = PetscImaginaryPart(V[ii*subset_size+j]);
             ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"       %1.4e + %1.4e i\n",r,c);CHKERRQ(ierr);
 #else
-            ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"       %1.4e\n",eigv[(ii+eigs_start)*subset_size+j]);CHKERRQ(ierr);
+            ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"       %1.4e\n",V[ii*subset_size+j]);CHKERRQ(ierr);
 #endif
           }
         }
       }
       ierr = KSPGetOperators(sub_schurs->change[i],&change,NULL);CHKERRQ(ierr);
-      ierr = MatCreateSeqDense(PETSC_COMM_SELF,subset_size,B_neigs,eigv+eigs_start*subset_size,&phit);CHKERRQ(ierr);
+      ierr = MatCreateSeqDense(PETSC_COMM_SELF,subset_size,B_neigs,V,&phit);CHKERRQ(ierr);
       ierr = MatMatMult(change,phit,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&phi);CHKERRQ(ierr);
       ierr = MatCopy(phi,phit,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
       ierr = MatDestroy(&phit);CHKERRQ(ierr);
       ierr = MatDestroy(&phi);CHKERRQ(ierr);
     }
     maxneigs = PetscMax(B_neigs,maxneigs);
-    pcbddc->adaptive_constraints_n[i+nv] = B_neigs;
     if (B_neigs) {
-      ierr = PetscArraycpy(pcbddc->adaptive_constraints_data+pcbddc->adaptive_constraints_data_ptr[cum],eigv+eigs_start*subset_size,B_neigs*subset_size);CHKERRQ(ierr);
+      /* the slots are in order and at least as large as the constraints, so the data only moves backwards */
+      ierr = PetscArraymove(pcbddc->adaptive_constraints_data+pcbddc->adaptive_constraints_data_ptr[cum],V,B_neigs*subset_size);CHKERRQ(ierr);
 
       if (pcbddc->dbg_flag > 1) {
         PetscInt ii;
         for (ii=0;ii<B_neigs;ii++) {
-          ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   -> Eigenvector %d/%d (%d)\n",ii,B_neigs,B_N);CHKERRQ(ierr);
-          for (j=0;j<B_N;j++) {
+          ierr = PetscViewerASCIISynchronizedPrintf(pcbddc->dbg_viewer,"   -> Eigenvector %D/%D (%D)\n",ii,B_neigs,subset_size);CHKERRQ(ierr);
+          for (j=0;j<subset_size;j++) {
 #if defined(PETSC_USE_COMPLEX)
             PetscReal r = PetscRealPart(pcbddc->adaptive_constraints_data[ii*subset_size+j+pcbddc->adaptive_constraints_data_ptr[cum]]);
             PetscReal c = PetscImaginaryPart(pcbddc->adaptive_constraints_data[ii*subset_size+j+pcbddc->adaptive_constraints_data_ptr[cum]]);
@@ -3679,14 +3779,13 @@ PetscErrorCode PCBDDCAdaptiveSelection(PC pc)
           }
         }
       }
+      ierr = ISGetIndices(sub_schurs->is_subs[i],&idxs);CHKERRQ(ierr);
       ierr = PetscArraycpy(pcbddc->adaptive_constraints_idxs+pcbddc->adaptive_constraints_idxs_ptr[cum],idxs,subset_size);CHKERRQ(ierr);
+      ierr = ISRestoreIndices(sub_schurs->is_subs[i],&idxs);CHKERRQ(ierr);
       pcbddc->adaptive_constraints_idxs_ptr[cum+1] = pcbddc->adaptive_constraints_idxs_ptr[cum] + subset_size;
       pcbddc->adaptive_constraints_data_ptr[cum+1] = pcbddc->adaptive_constraints_data_ptr[cum] + subset_size*B_neigs;
       cum++;
     }
-    ierr = ISRestoreIndices(sub_schurs->is_subs[i],&idxs);CHKERRQ(ierr);
-    /* shift for next computation */
-    cumarray += subset_size*subset_size;
   }
   if (pcbddc->dbg_flag) {
     ierr = PetscViewerFlush(pcbddc->dbg_viewer);CHKERRQ(ierr);
@@ -3699,13 +3798,15 @@ PetscErrorCode PCBDDCAdaptiveSelection(PC pc)
     ierr = MatDestroy(&sub_schurs->sum_S_Ej_inv_all);CHKERRQ(ierr);
     ierr = MatDestroy(&sub_schurs->sum_S_Ej_tilda_all);CHKERRQ(ierr);
   }
-  if (allocated_S_St) {
+  if (ctx.allocated_S_St) {
     ierr = PetscFree2(S,St);CHKERRQ(ierr);
   }
   ierr = PetscFree5(eigv,eigs,work,B_iwork,B_ifail);CHKERRQ(ierr);
 #if defined(PETSC_USE_COMPLEX)
   ierr = PetscFree(rwork);CHKERRQ(ierr);
 #endif
+  ierr = PetscFree(w);CHKERRQ(ierr);
+  ierr = PetscFree3(sizes,offs,slots);CHKERRQ(ierr);
   if (pcbddc->dbg_flag) {
     PetscInt maxneigs_r;
     ierr = MPIU_Allreduce(&maxneigs,&maxneigs_r,1,MPIU_INT,MPI_MAX,PetscObjectComm((PetscObject)pc));CHKERRMPI(ierr);
@@ -9064,6 +9165,7 @@ PetscErrorCode PCBDDCSetUpSubSchurs(PC pc)
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(PC_BDDC_Schurs[pcbddc->current_level],pc,0,0,0);CHKERRQ(ierr);
+  sub_schurs->nthreads = pcbddc->nthreads;
   /* decide the adjacency to be used for determining internal problems for local schur on subsets */
   free_used_adj = PETSC_FALSE;
   if (pcbddc->sub_schurs_layers == -1) {
@@ -9099,9 +9201,11 @@ PetscErrorCode PCBDDCSetUpSubSchurs(PC pc)
   /* setup sub_schurs data */
   ierr = MatCreateSchurComplement(pcis->A_II,pcis->pA_II,pcis->A_IB,pcis->A_BI,pcis->A_BB,&S_j);CHKERRQ(ierr);
   if (!sub_schurs->schur_explicit) {
+    /* user-defined constraints need the change of basis of the explicit branch */
+    if (pcbddc->adaptive_selection && pcbddc->adaptive_userdefined) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Adaptive selection with user-defined constraints requires MUMPS and/or MKL_PARDISO");
     /* pcbddc->ksp_D up to date only if not using MatFactor with Schur complement support */
     ierr = MatSchurComplementSetKSP(S_j,pcbddc->ksp_D);CHKERRQ(ierr);
-    ierr = PCBDDCSubSchursSetUp(sub_schurs,NULL,S_j,PETSC_FALSE,used_xadj,used_adjncy,pcbddc->sub_schurs_layers,NULL,pcbddc->adaptive_selection,PETSC_FALSE,PETSC_FALSE,0,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+    ierr = PCBDDCSubSchursSetUp(sub_schurs,NULL,S_j,PETSC_FALSE,used_xadj,used_adjncy,pcbddc->sub_schurs_layers,pcbddc->use_deluxe_scaling ? NULL : pcis->D,pcbddc->adaptive_selection,PETSC_FALSE,PETSC_FALSE,0,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
   } else {
     Mat       change = NULL;
     Vec       scaling = NULL;
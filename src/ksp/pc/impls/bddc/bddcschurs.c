@@ -2,6 +2,9 @@
 #include <../src/ksp/pc/impls/bddc/bddcprivate.h>
 #include <../src/mat/impls/dense/seq/dense.h>
 #include <petscblaslapack.h>
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#include <omp.h>
+#endif
 
 PETSC_STATIC_INLINE PetscErrorCode PCBDDCAdjGetNextLayer_Private(PetscInt*,PetscInt,PetscBT,PetscInt*,PetscInt*,PetscInt*);
 static PetscErrorCode PCBDDCComputeExplicitSchur(Mat,PetscBool,MatReuse,Mat*);
@@ -399,6 +402,158 @@ static PetscErrorCode PCBDDCComputeExplicitSchur(Mat M, PetscBool issym, MatReus
   PetscFunctionReturn(0);
 }
 
+/* inverts in place a dense block of size n; pivots and work are not referenced with POTRF */
+static PetscErrorCode PCBDDCSubSchursInvertBlock_Private(PetscInt n,PetscScalar *array,PetscBool use_potr,PetscBool use_sytr,PetscBLASInt *pivots,PetscScalar *work,PetscBLASInt B_lwork)
+{
+  PetscBLASInt   B_N,B_ierr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(n,&B_N);CHKERRQ(ierr);
+  if (use_potr) {
+    PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("L",&B_N,array,&B_N,&B_ierr));
+    if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in POTRF Lapack routine %d",(int)B_ierr);
+    PetscStackCallBLAS("LAPACKpotri",LAPACKpotri_("L",&B_N,array,&B_N,&B_ierr));
+    if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in POTRI Lapack routine %d",(int)B_ierr);
+  } else if (use_sytr) {
+    PetscStackCallBLAS("LAPACKsytrf",LAPACKsytrf_("L",&B_N,array,&B_N,pivots,work,&B_lwork,&B_ierr));
+    if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYTRF Lapack routine %d",(int)B_ierr);
+    PetscStackCallBLAS("LAPACKsytri",LAPACKsytri_("L",&B_N,array,&B_N,pivots,work,&B_ierr));
+    if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYTRI Lapack routine %d",(int)B_ierr);
+  } else {
+    PetscStackCallBLAS("LAPACKgetrf",LAPACKgetrf_(&B_N,&B_N,array,&B_N,pivots,&B_ierr));
+    if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in GETRF Lapack routine %d",(int)B_ierr);
+    PetscStackCallBLAS("LAPACKgetri",LAPACKgetri_(&B_N,array,&B_N,pivots,work,&B_lwork,&B_ierr));
+    if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in GETRI Lapack routine %d",(int)B_ierr);
+  }
+  ierr = PetscLogFlops(1.0*n*n*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCBDDCSubSchursInvertBlocks_Private - Inverts in place the dense blocks of the subsets, stored one after another in array.
+
+   Up to sub_schurs->nthreads OpenMP threads invert different blocks concurrently, each with its own LAPACK workspace;
+   B_lwork is the size of the workspace queried for the largest block. Threads are only used when PETSc is configured
+   with OpenMP and --with-threadsafety, otherwise the blocks are inverted in order.
+*/
+static PetscErrorCode PCBDDCSubSchursInvertBlocks_Private(PCBDDCSubSchurs sub_schurs,PetscScalar *array,PetscBool use_potr,PetscBool use_sytr,PetscBLASInt B_lwork)
+{
+  PetscScalar    *work = NULL;
+  PetscBLASInt   *pivots = NULL;
+  PetscInt       i,n = sub_schurs->n_subs,nt = 1,mss = 0,*sizes,*offs;
+  PetscErrorCode ierr = 0;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = PetscMalloc2(n,&sizes,n+1,&offs);CHKERRQ(ierr);
+  offs[0] = 0;
+  for (i=0;i<n;i++) {
+    ierr = ISGetLocalSize(sub_schurs->is_subs[i],&sizes[i]);CHKERRQ(ierr);
+    offs[i+1] = offs[i] + sizes[i]*sizes[i];
+    mss = PetscMax(mss,sizes[i]);
+  }
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  nt = PetscMax(1,PetscMin(sub_schurs->nthreads,n));
+#endif
+  if (!use_potr) {
+    ierr = PetscMalloc2(nt*B_lwork,&work,nt*mss,&pivots);CHKERRQ(ierr);
+  }
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  if (nt > 1) {
+    PetscErrorCode ierrt = 0;
+
+    #pragma omp parallel for num_threads((int)nt) schedule(dynamic,1) private(ierr)
+    for (i=0;i<n;i++) {
+      PetscInt t = omp_get_thread_num();
+
+      ierr = PCBDDCSubSchursInvertBlock_Private(sizes[i],array+offs[i],use_potr,use_sytr,use_potr ? NULL : pivots+t*mss,use_potr ? NULL : work+t*B_lwork,B_lwork);
+      if (ierr) {
+        #pragma omp critical
+        ierrt = ierr;
+      }
+    }
+    CHKERRQ(ierrt);
+  } else
+#endif
+  {
+    for (i=0;i<n;i++) {
+      ierr = PCBDDCSubSchursInvertBlock_Private(sizes[i],array+offs[i],use_potr,use_sytr,pivots,work,B_lwork);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (!use_potr) {
+    ierr = PetscFree2(work,pivots);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(sizes,offs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCBDDCSubSchursCreateSchur_Private - Creates the Schur complement on the boundary dofs is_E (in boundary numbering) of the
+   interior problem AE_II, restricted to the interior dofs is_I. Used when MatFactor with Schur complement support is not present.
+*/
+static PetscErrorCode PCBDDCSubSchursCreateSchur_Private(PCBDDCSubSchurs sub_schurs,Mat A_II,Mat AE_II,Mat A_IB,Mat A_BI,Mat A_BB,IS is_I,IS is_E,Mat *S)
+{
+  Mat            AE_EE,AE_IE,AE_EI;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* EE block */
+  ierr = MatCreateSubMatrix(A_BB,is_E,is_E,MAT_INITIAL_MATRIX,&AE_EE);CHKERRQ(ierr);
+  /* IE block */
+  ierr = MatCreateSubMatrix(A_IB,is_I,is_E,MAT_INITIAL_MATRIX,&AE_IE);CHKERRQ(ierr);
+  /* EI block */
+  if (sub_schurs->is_symmetric) {
+    ierr = MatCreateTranspose(AE_IE,&AE_EI);CHKERRQ(ierr);
+  } else if (sub_schurs->is_hermitian) {
+    ierr = MatCreateHermitianTranspose(AE_IE,&AE_EI);CHKERRQ(ierr);
+  } else {
+    ierr = MatCreateSubMatrix(A_BI,is_E,is_I,MAT_INITIAL_MATRIX,&AE_EI);CHKERRQ(ierr);
+  }
+  ierr = MatCreateSchurComplement(AE_II,AE_II,AE_IE,AE_EI,AE_EE,S);CHKERRQ(ierr);
+  ierr = MatDestroy(&AE_EE);CHKERRQ(ierr);
+  ierr = MatDestroy(&AE_IE);CHKERRQ(ierr);
+  ierr = MatDestroy(&AE_EI);CHKERRQ(ierr);
+  if (AE_II == A_II) { /* we can reuse the same ksp */
+    KSP ksp;
+    ierr = MatSchurComplementGetKSP(sub_schurs->S,&ksp);CHKERRQ(ierr);
+    ierr = MatSchurComplementSetKSP(*S,ksp);CHKERRQ(ierr);
+  } else { /* build new ksp object which inherits ksp and pc types from the original one */
+    KSP       origksp,schurksp;
+    PC        origpc,schurpc;
+    KSPType   ksp_type;
+    PetscInt  n_internal;
+    PetscBool ispcnone;
+
+    ierr = MatSchurComplementGetKSP(sub_schurs->S,&origksp);CHKERRQ(ierr);
+    ierr = MatSchurComplementGetKSP(*S,&schurksp);CHKERRQ(ierr);
+    ierr = KSPGetType(origksp,&ksp_type);CHKERRQ(ierr);
+    ierr = KSPSetType(schurksp,ksp_type);CHKERRQ(ierr);
+    ierr = KSPGetPC(schurksp,&schurpc);CHKERRQ(ierr);
+    ierr = KSPGetPC(origksp,&origpc);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)origpc,PCNONE,&ispcnone);CHKERRQ(ierr);
+    if (!ispcnone) {
+      PCType pc_type;
+      ierr = PCGetType(origpc,&pc_type);CHKERRQ(ierr);
+      ierr = PCSetType(schurpc,pc_type);CHKERRQ(ierr);
+    } else {
+      ierr = PCSetType(schurpc,PCLU);CHKERRQ(ierr);
+    }
+    ierr = ISGetSize(is_I,&n_internal);CHKERRQ(ierr);
+    if (!n_internal) { /* UMFPACK gives error with 0 sized problems */
+      MatSolverType solver = NULL;
+      ierr = PCFactorGetMatSolverType(origpc,(MatSolverType*)&solver);CHKERRQ(ierr);
+      if (solver) {
+        ierr = PCFactorSetMatSolverType(schurpc,solver);CHKERRQ(ierr);
+      }
+    }
+    ierr = KSPSetUp(schurksp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin, PetscBool exact_schur, PetscInt xadj[], PetscInt adjncy[], PetscInt nlayers, Vec scaling, PetscBool compute_Stilda, PetscBool reuse_solvers, PetscBool benign_trick, PetscInt benign_n, PetscInt benign_p0_lidx[], IS benign_zerodiag_subs[], Mat change, IS change_primal)
 {
   Mat                    F,A_II,A_IB,A_BI,A_BB,AE_II;
@@ -413,9 +568,10 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
   PetscInt               i,subset_size,max_subset_size;
   PetscInt               n_B,extra,local_size,global_size;
   PetscInt               local_stash_size;
-  PetscBLASInt           B_N,B_ierr,B_lwork,*pivots;
+  PetscBLASInt           B_N,B_ierr,B_lwork = 0,*pivots;
   MPI_Comm               comm_n;
   PetscBool              deluxe = PETSC_TRUE;
+  PetscBool              compute_sums;
   PetscBool              use_potr = PETSC_FALSE, use_sytr = PETSC_FALSE;
   PetscViewer            matl_dbg_viewer = NULL;
   PetscErrorCode         ierr;
@@ -436,7 +592,9 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
   }
 
   /* preliminary checks */
-  if (!sub_schurs->schur_explicit && compute_Stilda) SETERRQ(PetscObjectComm((PetscObject)sub_schurs->l2gmap),PETSC_ERR_SUP,"Adaptive selection of constraints requires MUMPS and/or MKL_PARDISO");
+  if (!sub_schurs->schur_explicit && compute_Stilda && (change || benign_trick)) SETERRQ(PetscObjectComm((PetscObject)sub_schurs->l2gmap),PETSC_ERR_SUP,"Adaptive selection of constraints with a change of basis or the benign trick requires MUMPS and/or MKL_PARDISO");
+  /* the matrices of the eigenproblems of the adaptive selection are not needed when its constraints are reused */
+  compute_sums = (PetscBool)(compute_Stilda && !sub_schurs->skip_adaptive);
 
   if (benign_trick) sub_schurs->is_posdef = PETSC_FALSE;
 
@@ -755,7 +913,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
     ierr = PetscFree3(ii,jj,v);CHKERRQ(ierr);
   }
   /* matrices for deluxe scaling and adaptive selection */
-  if (compute_Stilda) {
+  if (compute_sums) {
     if (!sub_schurs->sum_S_Ej_tilda_all) {
       ierr = MatDuplicate(sub_schurs->S_Ej_all,MAT_DO_NOT_COPY_VALUES,&sub_schurs->sum_S_Ej_tilda_all);CHKERRQ(ierr);
     }
@@ -770,70 +928,41 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
     /* this code branch is used when MatFactor with Schur complement support is not present or when explicitly requested;
        it is not efficient, unless the economic version of the scaling is used */
     Mat         S_Ej_expl;
+    Vec         Dall = NULL;
     PetscScalar *work;
     PetscInt    j,*dummy_idx;
-    PetscBool   Sdense;
+    PetscBool   Sdense,use_cholesky;
+
+    /* for complexes, symmetric and hermitian at the same time implies null imaginary part */
+    use_cholesky = (PetscBool)((use_potr || use_sytr) && sub_schurs->is_hermitian && sub_schurs->is_symmetric);
+
+    /* import scaling vector (wrong formulation if we have 3D edges) */
+    if (scaling && compute_sums) {
+      const PetscScalar *array;
+      PetscScalar       *array2;
+      const PetscInt    *idxs;
+
+      ierr = ISGetIndices(sub_schurs->is_Ej_all,&idxs);CHKERRQ(ierr);
+      ierr = VecCreateSeq(PETSC_COMM_SELF,local_size,&Dall);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(scaling,&array);CHKERRQ(ierr);
+      ierr = VecGetArray(Dall,&array2);CHKERRQ(ierr);
+      for (i=0;i<local_size;i++) array2[i] = array[idxs[i]];
+      ierr = VecRestoreArray(Dall,&array2);CHKERRQ(ierr);
+      ierr = VecRestoreArrayRead(scaling,&array);CHKERRQ(ierr);
+      ierr = ISRestoreIndices(sub_schurs->is_Ej_all,&idxs);CHKERRQ(ierr);
+      deluxe = PETSC_FALSE;
+    }
 
     ierr = PetscMalloc2(max_subset_size,&dummy_idx,max_subset_size*max_subset_size,&work);CHKERRQ(ierr);
     local_size = 0;
     for (i=0;i<sub_schurs->n_subs;i++) {
       IS  is_subset_B;
-      Mat AE_EE,AE_IE,AE_EI,S_Ej;
+      Mat S_Ej;
 
       /* subsets in original and boundary numbering */
       ierr = ISGlobalToLocalMappingApplyIS(sub_schurs->BtoNmap,IS_GTOLM_DROP,sub_schurs->is_subs[i],&is_subset_B);CHKERRQ(ierr);
-      /* EE block */
-      ierr = MatCreateSubMatrix(A_BB,is_subset_B,is_subset_B,MAT_INITIAL_MATRIX,&AE_EE);CHKERRQ(ierr);
-      /* IE block */
-      ierr = MatCreateSubMatrix(A_IB,is_I,is_subset_B,MAT_INITIAL_MATRIX,&AE_IE);CHKERRQ(ierr);
-      /* EI block */
-      if (sub_schurs->is_symmetric) {
-        ierr = MatCreateTranspose(AE_IE,&AE_EI);CHKERRQ(ierr);
-      } else if (sub_schurs->is_hermitian) {
-        ierr = MatCreateHermitianTranspose(AE_IE,&AE_EI);CHKERRQ(ierr);
-      } else {
-        ierr = MatCreateSubMatrix(A_BI,is_subset_B,is_I,MAT_INITIAL_MATRIX,&AE_EI);CHKERRQ(ierr);
-      }
+      ierr = PCBDDCSubSchursCreateSchur_Private(sub_schurs,A_II,AE_II,A_IB,A_BI,A_BB,is_I,is_subset_B,&S_Ej);CHKERRQ(ierr);
       ierr = ISDestroy(&is_subset_B);CHKERRQ(ierr);
-      ierr = MatCreateSchurComplement(AE_II,AE_II,AE_IE,AE_EI,AE_EE,&S_Ej);CHKERRQ(ierr);
-      ierr = MatDestroy(&AE_EE);CHKERRQ(ierr);
-      ierr = MatDestroy(&AE_IE);CHKERRQ(ierr);
-      ierr = MatDestroy(&AE_EI);CHKERRQ(ierr);
-      if (AE_II == A_II) { /* we can reuse the same ksp */
-        KSP ksp;
-        ierr = MatSchurComplementGetKSP(sub_schurs->S,&ksp);CHKERRQ(ierr);
-        ierr = MatSchurComplementSetKSP(S_Ej,ksp);CHKERRQ(ierr);
-      } else { /* build new ksp object which inherits ksp and pc types from the original one */
-        KSP       origksp,schurksp;
-        PC        origpc,schurpc;
-        KSPType   ksp_type;
-        PetscInt  n_internal;
-        PetscBool ispcnone;
-
-        ierr = MatSchurComplementGetKSP(sub_schurs->S,&origksp);CHKERRQ(ierr);
-        ierr = MatSchurComplementGetKSP(S_Ej,&schurksp);CHKERRQ(ierr);
-        ierr = KSPGetType(origksp,&ksp_type);CHKERRQ(ierr);
-        ierr = KSPSetType(schurksp,ksp_type);CHKERRQ(ierr);
-        ierr = KSPGetPC(schurksp,&schurpc);CHKERRQ(ierr);
-        ierr = KSPGetPC(origksp,&origpc);CHKERRQ(ierr);
-        ierr = PetscObjectTypeCompare((PetscObject)origpc,PCNONE,&ispcnone);CHKERRQ(ierr);
-        if (!ispcnone) {
-          PCType pc_type;
-          ierr = PCGetType(origpc,&pc_type);CHKERRQ(ierr);
-          ierr = PCSetType(schurpc,pc_type);CHKERRQ(ierr);
-        } else {
-          ierr = PCSetType(schurpc,PCLU);CHKERRQ(ierr);
-        }
-        ierr = ISGetSize(is_I,&n_internal);CHKERRQ(ierr);
-        if (!n_internal) { /* UMFPACK gives error with 0 sized problems */
-          MatSolverType solver = NULL;
-          ierr = PCFactorGetMatSolverType(origpc,(MatSolverType*)&solver);CHKERRQ(ierr);
-          if (solver) {
-            ierr = PCFactorSetMatSolverType(schurpc,solver);CHKERRQ(ierr);
-          }
-        }
-        ierr = KSPSetUp(schurksp);CHKERRQ(ierr);
-      }
       ierr = ISGetLocalSize(sub_schurs->is_subs[i],&subset_size);CHKERRQ(ierr);
       ierr = MatCreateSeqDense(PETSC_COMM_SELF,subset_size,subset_size,work,&S_Ej_expl);CHKERRQ(ierr);
       ierr = PCBDDCComputeExplicitSchur(S_Ej,sub_schurs->is_symmetric,MAT_REUSE_MATRIX,&S_Ej_expl);CHKERRQ(ierr);
@@ -842,12 +971,73 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
         for (j=0;j<subset_size;j++) {
           dummy_idx[j]=local_size+j;
         }
+        if (compute_sums && !deluxe) { /* scale as in the explicit branch */
+          Vec         D;
+          PetscScalar *array;
+
+          ierr = VecGetArray(Dall,&array);CHKERRQ(ierr);
+          ierr = VecCreateSeqWithArray(PETSC_COMM_SELF,1,subset_size,array+local_size,&D);CHKERRQ(ierr);
+          ierr = VecRestoreArray(Dall,&array);CHKERRQ(ierr);
+          ierr = VecShift(D,-1.);CHKERRQ(ierr);
+          ierr = MatDiagonalScale(S_Ej_expl,D,D);CHKERRQ(ierr);
+          ierr = VecDestroy(&D);CHKERRQ(ierr);
+        }
         ierr = MatSetValues(sub_schurs->S_Ej_all,subset_size,dummy_idx,subset_size,dummy_idx,work,INSERT_VALUES);CHKERRQ(ierr);
+        /* if adaptivity is requested, invert S_E blocks */
+        if (compute_sums && deluxe) {
+          ierr = MatSetOption(S_Ej_expl,MAT_SPD,sub_schurs->is_posdef);CHKERRQ(ierr);
+          ierr = MatSetOption(S_Ej_expl,MAT_HERMITIAN,sub_schurs->is_hermitian);CHKERRQ(ierr);
+          if (use_cholesky) {
+            ierr = MatCholeskyFactor(S_Ej_expl,NULL,NULL);CHKERRQ(ierr);
+          } else {
+            ierr = MatLUFactor(S_Ej_expl,NULL,NULL,NULL);CHKERRQ(ierr);
+          }
+          ierr = MatSeqDenseInvertFactors_Private(S_Ej_expl);CHKERRQ(ierr);
+          ierr = MatSetValues(sub_schurs->sum_S_Ej_inv_all,subset_size,dummy_idx,subset_size,dummy_idx,work,INSERT_VALUES);CHKERRQ(ierr);
+        }
       } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Not yet implemented for sparse matrices");
       ierr = MatDestroy(&S_Ej);CHKERRQ(ierr);
       ierr = MatDestroy(&S_Ej_expl);CHKERRQ(ierr);
       local_size += subset_size;
     }
+
+    /* for adaptivity, (St^-1)_E are the diagonal blocks of the inverse of the Schur complement on all the subsets,
+       vertices and Dirichlet dofs are not part of it as in the explicit branch */
+    if (compute_sums && local_size) {
+      Mat               S_act;
+      const PetscScalar *rS_data;
+      PetscInt          cum = 0,k;
+
+      ierr = PCBDDCSubSchursCreateSchur_Private(sub_schurs,A_II,AE_II,A_IB,A_BI,A_BB,is_I,sub_schurs->is_Ej_all,&S_act);CHKERRQ(ierr);
+      ierr = MatCreateSeqDense(PETSC_COMM_SELF,local_size,local_size,NULL,&S_Ej_expl);CHKERRQ(ierr);
+      ierr = PCBDDCComputeExplicitSchur(S_act,sub_schurs->is_symmetric,MAT_REUSE_MATRIX,&S_Ej_expl);CHKERRQ(ierr);
+      ierr = MatDestroy(&S_act);CHKERRQ(ierr);
+      ierr = MatSetOption(S_Ej_expl,MAT_SPD,sub_schurs->is_posdef);CHKERRQ(ierr);
+      ierr = MatSetOption(S_Ej_expl,MAT_HERMITIAN,sub_schurs->is_hermitian);CHKERRQ(ierr);
+      if (use_cholesky) {
+        ierr = MatCholeskyFactor(S_Ej_expl,NULL,NULL);CHKERRQ(ierr);
+      } else {
+        ierr = MatLUFactor(S_Ej_expl,NULL,NULL,NULL);CHKERRQ(ierr);
+      }
+      ierr = MatSeqDenseInvertFactors_Private(S_Ej_expl);CHKERRQ(ierr);
+      ierr = MatDenseGetArrayRead(S_Ej_expl,&rS_data);CHKERRQ(ierr);
+      for (i=0;i<sub_schurs->n_subs;i++) {
+        ierr = ISGetLocalSize(sub_schurs->is_subs[i],&subset_size);CHKERRQ(ierr);
+        for (k=0;k<subset_size;k++) {
+          for (j=0;j<subset_size;j++) {
+            work[k*subset_size+j] = rS_data[(cum+k)*local_size+cum+j];
+          }
+        }
+        for (j=0;j<subset_size;j++) {
+          dummy_idx[j]=cum+j;
+        }
+        ierr = MatSetValues(sub_schurs->sum_S_Ej_tilda_all,subset_size,dummy_idx,subset_size,dummy_idx,work,INSERT_VALUES);CHKERRQ(ierr);
+        cum += subset_size;
+      }
+      ierr = MatDenseRestoreArrayRead(S_Ej_expl,&rS_data);CHKERRQ(ierr);
+      ierr = MatDestroy(&S_Ej_expl);CHKERRQ(ierr);
+    }
+    ierr = VecDestroy(&Dall);CHKERRQ(ierr);
     ierr = PetscFree2(dummy_idx,work);CHKERRQ(ierr);
     /* free */
     ierr = ISDestroy(&is_I);CHKERRQ(ierr);
@@ -881,7 +1071,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
     size_active_schur = local_size;
 
     /* import scaling vector (wrong formulation if we have 3D edges) */
-    if (scaling && compute_Stilda) {
+    if (scaling && compute_sums) {
       const PetscScalar *array;
       PetscScalar       *array2;
       const PetscInt    *idxs;
@@ -1359,7 +1549,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
     cum = cum2 = 0;
     ierr = MatDenseGetArrayRead(S_all,&rS_data);CHKERRQ(ierr);
     ierr = MatSeqAIJGetArray(sub_schurs->S_Ej_all,&SEj_arr);CHKERRQ(ierr);
-    if (compute_Stilda) {
+    if (compute_sums) {
       ierr = MatSeqAIJGetArray(sub_schurs->sum_S_Ej_inv_all,&SEjinv_arr);CHKERRQ(ierr);
     }
     for (i=0;i<sub_schurs->n_subs;i++) {
@@ -1407,7 +1597,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
       if (deluxe) {
         ierr = PetscArraycpy(SEj_arr,work,subset_size*subset_size);CHKERRQ(ierr);
         /* if adaptivity is requested, invert S_E blocks */
-        if (compute_Stilda) {
+        if (compute_sums) {
           Mat               M;
           const PetscScalar *vals;
           PetscBool         isdense,isdensecuda;
@@ -1437,7 +1627,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
           ierr = MatDenseRestoreArrayRead(M,&vals);CHKERRQ(ierr);
           ierr = MatDestroy(&M);CHKERRQ(ierr);
         }
-      } else if (compute_Stilda) { /* not using deluxe */
+      } else if (compute_sums) { /* not using deluxe */
         Mat         SEj;
         Vec         D;
         PetscScalar *array;
@@ -1459,7 +1649,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
     }
     ierr = MatDenseRestoreArrayRead(S_all,&rS_data);CHKERRQ(ierr);
     ierr = MatSeqAIJRestoreArray(sub_schurs->S_Ej_all,&SEj_arr);CHKERRQ(ierr);
-    if (compute_Stilda) {
+    if (compute_sums) {
       ierr = MatSeqAIJRestoreArray(sub_schurs->sum_S_Ej_inv_all,&SEjinv_arr);CHKERRQ(ierr);
     }
     if (solver_S) {
@@ -1482,7 +1672,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
 #endif
 
     schur_factor = NULL;
-    if (compute_Stilda && size_active_schur) {
+    if (compute_sums && size_active_schur) {
 
       ierr = MatSeqAIJGetArray(sub_schurs->sum_S_Ej_tilda_all,&SEjinv_arr);CHKERRQ(ierr);
       if (sub_schurs->n_subs == 1 && size_schur == size_active_schur && deluxe) { /* we already computed the inverse */
@@ -1742,7 +1932,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
   ierr = MatSetVariableBlockSizes(sub_schurs->S_Ej_all,sub_schurs->n_subs,nnz);CHKERRQ(ierr);
   ierr = MatAssemblyBegin(sub_schurs->S_Ej_all,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(sub_schurs->S_Ej_all,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
-  if (compute_Stilda) {
+  if (compute_sums) {
     ierr = MatSetVariableBlockSizes(sub_schurs->sum_S_Ej_tilda_all,sub_schurs->n_subs,nnz);CHKERRQ(ierr);
     ierr = MatAssemblyBegin(sub_schurs->sum_S_Ej_tilda_all,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
     ierr = MatAssemblyEnd(sub_schurs->sum_S_Ej_tilda_all,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
@@ -1773,7 +1963,7 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
   ierr = VecResetArray(lstash);CHKERRQ(ierr);
 
   /* Get local part of (\sum_j S^-1_Ej) (\sum_j St^-1_Ej) */
-  if (compute_Stilda) {
+  if (compute_sums) {
     ierr = VecSet(gstash,0.0);CHKERRQ(ierr);
     ierr = MatSeqAIJGetArray(sub_schurs->sum_S_Ej_tilda_all,&stasharray);CHKERRQ(ierr);
     ierr = VecPlaceArray(lstash,stasharray);CHKERRQ(ierr);
@@ -1795,34 +1985,9 @@ PetscErrorCode PCBDDCSubSchursSetUp(PCBDDCSubSchurs sub_schurs, Mat Ain, Mat Sin
       ierr = VecResetArray(lstash);CHKERRQ(ierr);
     } else {
       PetscScalar *array;
-      PetscInt    cum;
 
       ierr = MatSeqAIJGetArray(sub_schurs->sum_S_Ej_tilda_all,&array);CHKERRQ(ierr);
-      cum = 0;
-      for (i=0;i<sub_schurs->n_subs;i++) {
-        ierr = ISGetLocalSize(sub_schurs->is_subs[i],&subset_size);CHKERRQ(ierr);
-        ierr = PetscBLASIntCast(subset_size,&B_N);CHKERRQ(ierr);
-        ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
-        if (use_potr) {
-          PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("L",&B_N,array+cum,&B_N,&B_ierr));
-          if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in POTRF Lapack routine %d",(int)B_ierr);
-          PetscStackCallBLAS("LAPACKpotri",LAPACKpotri_("L",&B_N,array+cum,&B_N,&B_ierr));
-          if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in POTRI Lapack routine %d",(int)B_ierr);
-        } else if (use_sytr) {
-          PetscStackCallBLAS("LAPACKsytrf",LAPACKsytrf_("L",&B_N,array+cum,&B_N,pivots,Bwork,&B_lwork,&B_ierr));
-          if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYTRF Lapack routine %d",(int)B_ierr);
-          PetscStackCallBLAS("LAPACKsytri",LAPACKsytri_("L",&B_N,array+cum,&B_N,pivots,Bwork,&B_ierr));
-          if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in SYTRI Lapack routine %d",(int)B_ierr);
-        } else {
-          PetscStackCallBLAS("LAPACKgetrf",LAPACKgetrf_(&B_N,&B_N,array+cum,&B_N,pivots,&B_ierr));
-          if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in GETRF Lapack routine %d",(int)B_ierr);
-          PetscStackCallBLAS("LAPACKgetri",LAPACKgetri_(&B_N,array+cum,&B_N,pivots,Bwork,&B_lwork,&B_ierr));
-          if (B_ierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in GETRI Lapack routine %d",(int)B_ierr);
-        }
-        ierr = PetscLogFlops(1.0*subset_size*subset_size*subset_size);CHKERRQ(ierr);
-        ierr = PetscFPTrapPop();CHKERRQ(ierr);
-        cum += subset_size*subset_size;
-      }
+      ierr = PCBDDCSubSchursInvertBlocks_Private(sub_schurs,array,use_potr,use_sytr,B_lwork);CHKERRQ(ierr);
       ierr = MatSeqAIJRestoreArray(sub_schurs->sum_S_Ej_tilda_all,&array);CHKERRQ(ierr);
       ierr = PetscObjectReference((PetscObject)sub_schurs->sum_S_Ej_all);CHKERRQ(ierr);
       ierr = MatDestroy(&sub_schurs->sum_S_Ej_inv_all);CHKERRQ(ierr);
@@ -1979,6 +2144,7 @@ PetscErrorCode PCBDDCSubSchursCreate(PCBDDCSubSchurs *sub_schurs)
   PetscFunctionBegin;
   ierr = PetscNew(&schurs_ctx);CHKERRQ(ierr);
   schurs_ctx->n_subs = 0;
+  schurs_ctx->nthreads = 1;
   *sub_schurs = schurs_ctx;
   PetscFunctionReturn(0);
 }
@@ -139,6 +139,10 @@ struct _PCBDDCSubSchurs {
   char      *prefix;
   /* */
   PetscBool restrict_comm;
+  /* threads working on different subsets concurrently */
+  PetscInt  nthreads;
+  /* the adaptive constraints are reused: the matrices of the eigenproblems are not computed */
+  PetscBool skip_adaptive;
   /* debug */
   PetscBool debug;
 };
@@ -159,6 +159,8 @@ static PetscErrorCode PCSetFromOptions_BJacobi(PetscOptionItems *PetscOptionsObj
   if (flg) {ierr = PCBJacobiSetTotalBlocks(pc,blocks,NULL);CHKERRQ(ierr);}
   ierr = PetscOptionsInt("-pc_bjacobi_local_blocks","Local number of blocks","PCBJacobiSetLocalBlocks",jac->n_local,&blocks,&flg);CHKERRQ(ierr);
   if (flg) {ierr = PCBJacobiSetLocalBlocks(pc,blocks,NULL);CHKERRQ(ierr);}
+  ierr = PetscOptionsInt("-pc_bjacobi_threads","Number of threads solving the local blocks concurrently","PCBJacobiSetThreads",jac->nthreads,&blocks,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = PCBJacobiSetThreads(pc,blocks);CHKERRQ(ierr);}
   if (jac->ksp) {
     /* The sub-KSP has already been set up (e.g., PCSetUp_BJacobi_Singleblock), but KSPSetFromOptions was not called
      * unless we had already been called. */
@@ -192,6 +194,7 @@ static PetscErrorCode PCView_BJacobi(PC pc,PetscViewer viewer)
       ierr = PetscViewerASCIIPrintf(viewer,"  using Amat local matrix, number of blocks = %D\n",jac->n);CHKERRQ(ierr);
     }
     ierr = PetscViewerASCIIPrintf(viewer,"  number of blocks = %D\n",jac->n);CHKERRQ(ierr);
+    if (jac->nthreads > 1) {ierr = PetscViewerASCIIPrintf(viewer,"  local blocks are solved concurrently by up to %D threads\n",jac->nthreads);CHKERRQ(ierr);}
     ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)pc),&rank);CHKERRMPI(ierr);
     ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
     if (format != PETSC_VIEWER_ASCII_INFO_DETAIL) {
@@ -269,6 +272,23 @@ static PetscErrorCode PCView_BJacobi(PC pc,PetscViewer viewer)
 
 /* -------------------------------------------------------------------------------------*/
 
+static PetscErrorCode PCBJacobiSetThreads_BJacobi(PC pc,PetscInt nthreads)
+{
+  PC_BJacobi *jac = (PC_BJacobi*)pc->data;
+
+  PetscFunctionBegin;
+  if (nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",nthreads);
+#if !(defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY))
+  if (nthreads > 1) {
+    PetscErrorCode ierr;
+
+    ierr = PetscInfo1(pc,"Solving the blocks one after another, %D threads require PETSc configured with OpenMP and --with-threadsafety\n",nthreads);CHKERRQ(ierr);
+  }
+#endif
+  jac->nthreads = nthreads;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode  PCBJacobiGetSubKSP_BJacobi(PC pc,PetscInt *n_local,PetscInt *first_local,KSP **ksp)
 {
   PC_BJacobi *jac = (PC_BJacobi*)pc->data;
@@ -501,6 +521,43 @@ PetscErrorCode  PCBJacobiGetLocalBlocks(PC pc, PetscInt *blocks, const PetscInt
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCBJacobiSetThreads - Sets the number of threads that set up and solve the local blocks of the
+   block Jacobi preconditioner concurrently.
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  nthreads - the number of threads, 1 (the default) solves the local blocks one after another
+
+   Options Database Key:
+.  -pc_bjacobi_threads <nthreads> - sets the number of threads
+
+   Notes:
+   Only has an effect when a process owns several blocks, see PCBJacobiSetLocalBlocks(). Each thread factors
+   and solves whole blocks with their own KSP and PC objects, so the sub-solvers need no synchronization
+   between themselves.
+
+   This requires PETSc to be configured with OpenMP and --with-threadsafety, otherwise the blocks are solved
+   one after another. Sub-solvers that perform reductions, for example Krylov methods other than KSPPREONLY,
+   additionally need an MPI implementation providing MPI_THREAD_MULTIPLE.
+
+   Level: intermediate
+
+.seealso: PCBJacobiSetLocalBlocks(), PCASMSetThreads()
+@*/
+PetscErrorCode PCBJacobiSetThreads(PC pc,PetscInt nthreads)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveInt(pc,nthreads,2);
+  ierr = PetscTryMethod(pc,"PCBJacobiSetThreads_C",(PC,PetscInt),(pc,nthreads));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* -----------------------------------------------------------------------------------*/
 
 /*MC
@@ -509,7 +566,8 @@ PetscErrorCode  PCBJacobiGetLocalBlocks(PC pc, PetscInt *blocks, const PetscInt
 
    Options Database Keys:
 +  -pc_use_amat - use Amat to apply block of operator in inner Krylov method
--  -pc_bjacobi_blocks <n> - use n total blocks
+.  -pc_bjacobi_blocks <n> - use n total blocks
+-  -pc_bjacobi_threads <n> - solve the blocks of each process with up to n threads concurrently
 
    Notes:
     Each processor can have one or more blocks, or a single block can be shared by several processes. Defaults to one block per processor.
@@ -533,7 +591,7 @@ PetscErrorCode  PCBJacobiGetLocalBlocks(PC pc, PetscInt *blocks, const PetscInt
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC,
            PCASM, PCSetUseAmat(), PCGetUseAmat(), PCBJacobiGetSubKSP(), PCBJacobiSetTotalBlocks(),
-           PCBJacobiSetLocalBlocks(), PCSetModifySubMatrices()
+           PCBJacobiSetLocalBlocks(), PCSetModifySubMatrices(), PCBJacobiSetThreads()
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_BJacobi(PC pc)
@@ -563,12 +621,14 @@ PETSC_EXTERN PetscErrorCode PCCreate_BJacobi(PC pc)
   jac->g_lens            = NULL;
   jac->l_lens            = NULL;
   jac->psubcomm          = NULL;
+  jac->nthreads          = 1;
 
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCBJacobiGetSubKSP_C",PCBJacobiGetSubKSP_BJacobi);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCBJacobiSetTotalBlocks_C",PCBJacobiSetTotalBlocks_BJacobi);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCBJacobiGetTotalBlocks_C",PCBJacobiGetTotalBlocks_BJacobi);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCBJacobiSetLocalBlocks_C",PCBJacobiSetLocalBlocks_BJacobi);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCBJacobiGetLocalBlocks_C",PCBJacobiGetLocalBlocks_BJacobi);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCBJacobiSetThreads_C",PCBJacobiSetThreads_BJacobi);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -882,26 +942,18 @@ static PetscErrorCode PCDestroy_BJacobi_Multiblock(PC pc)
 
 static PetscErrorCode PCSetUpOnBlocks_BJacobi_Multiblock(PC pc)
 {
-  PC_BJacobi         *jac = (PC_BJacobi*)pc->data;
-  PetscErrorCode     ierr;
-  PetscInt           i,n_local = jac->n_local;
-  KSPConvergedReason reason;
+  PC_BJacobi     *jac = (PC_BJacobi*)pc->data;
+  PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  for (i=0; i<n_local; i++) {
-    ierr = KSPSetUp(jac->ksp[i]);CHKERRQ(ierr);
-    ierr = KSPGetConvergedReason(jac->ksp[i],&reason);CHKERRQ(ierr);
-    if (reason == KSP_DIVERGED_PC_FAILED) {
-      pc->failedreason = PC_SUBPC_ERROR;
-    }
-  }
+  ierr = PCSetUpBlocks_Private(pc,jac->nthreads,jac->n_local,jac->ksp);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
 /*
       Preconditioner for block Jacobi
 */
-static PetscErrorCode PCApply_BJacobi_Multiblock(PC pc,Vec x,Vec y)
+static PetscErrorCode PCApplyOrTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y,PetscBool transpose)
 {
   PC_BJacobi            *jac = (PC_BJacobi*)pc->data;
   PetscErrorCode        ierr;
@@ -921,12 +973,9 @@ static PetscErrorCode PCApply_BJacobi_Multiblock(PC pc,Vec x,Vec y)
     */
     ierr = VecPlaceArray(bjac->x[i],xin+bjac->starts[i]);CHKERRQ(ierr);
     ierr = VecPlaceArray(bjac->y[i],yin+bjac->starts[i]);CHKERRQ(ierr);
-
-    ierr = PetscLogEventBegin(PC_ApplyOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
-    ierr = KSPSolve(jac->ksp[i],bjac->x[i],bjac->y[i]);CHKERRQ(ierr);
-    ierr = KSPCheckSolve(jac->ksp[i],pc,bjac->y[i]);CHKERRQ(ierr);
-    ierr = PetscLogEventEnd(PC_ApplyOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
-
+  }
+  ierr = PCSolveBlocks_Private(pc,jac->nthreads,n_local,jac->ksp,bjac->x,bjac->y,transpose);CHKERRQ(ierr);
+  for (i=0; i<n_local; i++) {
     ierr = VecResetArray(bjac->x[i]);CHKERRQ(ierr);
     ierr = VecResetArray(bjac->y[i]);CHKERRQ(ierr);
   }
@@ -935,40 +984,21 @@ static PetscErrorCode PCApply_BJacobi_Multiblock(PC pc,Vec x,Vec y)
   PetscFunctionReturn(0);
 }
 
-/*
-      Preconditioner for block Jacobi
-*/
-static PetscErrorCode PCApplyTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y)
+static PetscErrorCode PCApply_BJacobi_Multiblock(PC pc,Vec x,Vec y)
 {
-  PC_BJacobi            *jac = (PC_BJacobi*)pc->data;
-  PetscErrorCode        ierr;
-  PetscInt              i,n_local = jac->n_local;
-  PC_BJacobi_Multiblock *bjac = (PC_BJacobi_Multiblock*)jac->data;
-  PetscScalar           *yin;
-  const PetscScalar     *xin;
+  PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = VecGetArrayRead(x,&xin);CHKERRQ(ierr);
-  ierr = VecGetArray(y,&yin);CHKERRQ(ierr);
-  for (i=0; i<n_local; i++) {
-    /*
-       To avoid copying the subvector from x into a workspace we instead
-       make the workspace vector array point to the subpart of the array of
-       the global vector.
-    */
-    ierr = VecPlaceArray(bjac->x[i],xin+bjac->starts[i]);CHKERRQ(ierr);
-    ierr = VecPlaceArray(bjac->y[i],yin+bjac->starts[i]);CHKERRQ(ierr);
+  ierr = PCApplyOrTranspose_BJacobi_Multiblock(pc,x,y,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
-    ierr = PetscLogEventBegin(PC_ApplyTransposeOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
-    ierr = KSPSolveTranspose(jac->ksp[i],bjac->x[i],bjac->y[i]);CHKERRQ(ierr);
-    ierr = KSPCheckSolve(jac->ksp[i],pc,bjac->y[i]);CHKERRQ(ierr);
-    ierr = PetscLogEventEnd(PC_ApplyTransposeOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
+static PetscErrorCode PCApplyTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
 
-    ierr = VecResetArray(bjac->x[i]);CHKERRQ(ierr);
-    ierr = VecResetArray(bjac->y[i]);CHKERRQ(ierr);
-  }
-  ierr = VecRestoreArrayRead(x,&xin);CHKERRQ(ierr);
-  ierr = VecRestoreArray(y,&yin);CHKERRQ(ierr);
+  PetscFunctionBegin;
+  ierr = PCApplyOrTranspose_BJacobi_Multiblock(pc,x,y,PETSC_TRUE);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
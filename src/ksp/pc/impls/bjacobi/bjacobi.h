@@ -18,6 +18,7 @@ typedef struct {
   PetscInt     *l_lens;           /* lens of each block */
   PetscInt     *g_lens;
   PetscSubcomm psubcomm;          /* for multiple processors per block */
+  PetscInt     nthreads;          /* number of threads solving the local blocks concurrently */
 } PC_BJacobi;
 
 /*
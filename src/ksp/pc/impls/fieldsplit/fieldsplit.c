@@ -35,6 +35,7 @@ typedef struct {
   /* Only used when Schur complement preconditioning is used */
   Mat                       B;                     /* The (0,1) block */
   Mat                       C;                     /* The (1,0) block */
+  IS                        Bcols,Ccols;           /* The columns of B and C, kept with them to extract them again */
   Mat                       schur;                 /* The Schur complement S = A11 - A10 A00^{-1} A01, the KSP here, kspinner, is H_1 in [El08] */
   Mat                       schurp;                /* Assembled approximation to S built by MatSchurComplement to be used as a preconditioning matrix when solving with S */
   Mat                       schur_user;            /* User-provided preconditioning matrix for the Schur complement */
@@ -813,7 +814,6 @@ static PetscErrorCode PCSetUp_FieldSplit(PC pc)
   }
 
   if (jac->type == PC_COMPOSITE_SCHUR) {
-    IS          ccis;
     PetscBool   isspd;
     PetscInt    rstart,rend;
     char        lscname[256];
@@ -838,29 +838,35 @@ static PetscErrorCode PCSetUp_FieldSplit(PC pc)
         scall = MAT_INITIAL_MATRIX;
         ierr  = MatDestroy(&jac->B);CHKERRQ(ierr);
         ierr  = MatDestroy(&jac->C);CHKERRQ(ierr);
+        ierr  = ISDestroy(&jac->Bcols);CHKERRQ(ierr);
+        ierr  = ISDestroy(&jac->Ccols);CHKERRQ(ierr);
       } else scall = MAT_REUSE_MATRIX;
 
       ierr  = MatSchurComplementGetKSP(jac->schur, &kspInner);CHKERRQ(ierr);
+      /* the index sets are kept so that the submatrix extraction can reuse its data, see MatCreateSubMatrix() */
       ilink = jac->head;
-      ierr  = ISComplement(ilink->is_col,rstart,rend,&ccis);CHKERRQ(ierr);
+      if (!jac->Bcols) {ierr = ISComplement(ilink->is_col,rstart,rend,&jac->Bcols);CHKERRQ(ierr);}
       if (jac->offdiag_use_amat) {
-        ierr = MatCreateSubMatrix(pc->mat,ilink->is,ccis,scall,&jac->B);CHKERRQ(ierr);
+        ierr = MatCreateSubMatrix(pc->mat,ilink->is,jac->Bcols,scall,&jac->B);CHKERRQ(ierr);
       } else {
-        ierr = MatCreateSubMatrix(pc->pmat,ilink->is,ccis,scall,&jac->B);CHKERRQ(ierr);
+        ierr = MatCreateSubMatrix(pc->pmat,ilink->is,jac->Bcols,scall,&jac->B);CHKERRQ(ierr);
       }
-      ierr  = ISDestroy(&ccis);CHKERRQ(ierr);
       ilink = ilink->next;
-      ierr  = ISComplement(ilink->is_col,rstart,rend,&ccis);CHKERRQ(ierr);
+      if (!jac->Ccols) {ierr = ISComplement(ilink->is_col,rstart,rend,&jac->Ccols);CHKERRQ(ierr);}
       if (jac->offdiag_use_amat) {
-        ierr = MatCreateSubMatrix(pc->mat,ilink->is,ccis,scall,&jac->C);CHKERRQ(ierr);
+        ierr = MatCreateSubMatrix(pc->mat,ilink->is,jac->Ccols,scall,&jac->C);CHKERRQ(ierr);
       } else {
-        ierr = MatCreateSubMatrix(pc->pmat,ilink->is,ccis,scall,&jac->C);CHKERRQ(ierr);
+        ierr = MatCreateSubMatrix(pc->pmat,ilink->is,jac->Ccols,scall,&jac->C);CHKERRQ(ierr);
       }
-      ierr  = ISDestroy(&ccis);CHKERRQ(ierr);
       ierr  = MatSchurComplementUpdateSubMatrices(jac->schur,jac->mat[0],jac->pmat[0],jac->B,jac->C,jac->mat[1]);CHKERRQ(ierr);
       if (jac->schurpre == PC_FIELDSPLIT_SCHUR_PRE_SELFP) {
-        ierr = MatDestroy(&jac->schurp);CHKERRQ(ierr);
-        ierr = MatSchurComplementGetPmat(jac->schur,MAT_INITIAL_MATRIX,&jac->schurp);CHKERRQ(ierr);
+        /* numerical recomputation with the symbolic products of the first setup, see MatCreateSchurComplementPmat() */
+        if (jac->schurp && pc->flag != DIFFERENT_NONZERO_PATTERN) {
+          ierr = MatSchurComplementGetPmat(jac->schur,MAT_REUSE_MATRIX,&jac->schurp);CHKERRQ(ierr);
+        } else {
+          ierr = MatDestroy(&jac->schurp);CHKERRQ(ierr);
+          ierr = MatSchurComplementGetPmat(jac->schur,MAT_INITIAL_MATRIX,&jac->schurp);CHKERRQ(ierr);
+        }
       }
       if (kspA != kspInner) {
         ierr = KSPSetOperators(kspA,jac->mat[0],jac->pmat[0]);CHKERRQ(ierr);
@@ -879,21 +885,21 @@ static PetscErrorCode PCSetUp_FieldSplit(PC pc)
 
       /* extract the A01 and A10 matrices */
       ilink = jac->head;
-      ierr  = ISComplement(ilink->is_col,rstart,rend,&ccis);CHKERRQ(ierr);
+      ierr  = ISDestroy(&jac->Bcols);CHKERRQ(ierr);
+      ierr  = ISComplement(ilink->is_col,rstart,rend,&jac->Bcols);CHKERRQ(ierr);
       if (jac->offdiag_use_amat) {
-        ierr = MatCreateSubMatrix(pc->mat,ilink->is,ccis,MAT_INITIAL_MATRIX,&jac->B);CHKERRQ(ierr);
+        ierr = MatCreateSubMatrix(pc->mat,ilink->is,jac->Bcols,MAT_INITIAL_MATRIX,&jac->B);CHKERRQ(ierr);
       } else {
-        ierr = MatCreateSubMatrix(pc->pmat,ilink->is,ccis,MAT_INITIAL_MATRIX,&jac->B);CHKERRQ(ierr);
+        ierr = MatCreateSubMatrix(pc->pmat,ilink->is,jac->Bcols,MAT_INITIAL_MATRIX,&jac->B);CHKERRQ(ierr);
       }
-      ierr  = ISDestroy(&ccis);CHKERRQ(ierr);
       ilink = ilink->next;
-      ierr  = ISComplement(ilink->is_col,rstart,rend,&ccis);CHKERRQ(ierr);
+      ierr  = ISDestroy(&jac->Ccols);CHKERRQ(ierr);
+      ierr  = ISComplement(ilink->is_col,rstart,rend,&jac->Ccols);CHKERRQ(ierr);
       if (jac->offdiag_use_amat) {
-        ierr = MatCreateSubMatrix(pc->mat,ilink->is,ccis,MAT_INITIAL_MATRIX,&jac->C);CHKERRQ(ierr);
+        ierr = MatCreateSubMatrix(pc->mat,ilink->is,jac->Ccols,MAT_INITIAL_MATRIX,&jac->C);CHKERRQ(ierr);
       } else {
-        ierr = MatCreateSubMatrix(pc->pmat,ilink->is,ccis,MAT_INITIAL_MATRIX,&jac->C);CHKERRQ(ierr);
+        ierr = MatCreateSubMatrix(pc->pmat,ilink->is,jac->Ccols,MAT_INITIAL_MATRIX,&jac->C);CHKERRQ(ierr);
       }
-      ierr = ISDestroy(&ccis);CHKERRQ(ierr);
 
       /* Use mat[0] (diagonal block of Amat) preconditioned by pmat[0] to define Schur complement */
       ierr = MatCreate(((PetscObject)jac->mat[0])->comm,&jac->schur);CHKERRQ(ierr);
@@ -1569,6 +1575,8 @@ static PetscErrorCode PCReset_FieldSplit(PC pc)
   ierr = KSPDestroy(&jac->kspupper);CHKERRQ(ierr);
   ierr = MatDestroy(&jac->B);CHKERRQ(ierr);
   ierr = MatDestroy(&jac->C);CHKERRQ(ierr);
+  ierr = ISDestroy(&jac->Bcols);CHKERRQ(ierr);
+  ierr = ISDestroy(&jac->Ccols);CHKERRQ(ierr);
   ierr = MatDestroy(&jac->H);CHKERRQ(ierr);
   ierr = VecDestroy(&jac->u);CHKERRQ(ierr);
   ierr = VecDestroy(&jac->v);CHKERRQ(ierr);
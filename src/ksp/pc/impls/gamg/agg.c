@@ -102,6 +102,8 @@ static PetscErrorCode PCGAMGSetSymGraph_AGG(PC pc, PetscBool n)
    Notes:
    Squaring the graph increases the rate of coarsening (aggressive coarsening) and thereby reduces the complexity of the coarse grids, and generally results in slower solver converge rates. Reducing coarse grid complexity reduced the complexity of Galerkin coarse grid construction considerably.
 
+   The graph is not squared with -mat_coarsen_type mis2, which aggregates with a distance-2 maximal independent set of the graph itself and gives similar aggregates at a fraction of the memory.
+
    Level: intermediate
 
 .seealso: PCGAMGSetSymGraph(), PCGAMGSetThreshold()
@@ -850,6 +852,7 @@ static PetscErrorCode PCGAMGCoarsen_AGG(PC a_pc,Mat *a_Gmat1,PetscCoarsenData **
   PetscBool      *bIndexSet;
   MatCoarsen     crs;
   MPI_Comm       comm;
+  PetscBool      ismis2;
   PetscReal      hashfact;
   PetscInt       iSwapIndex;
   PetscRandom    random;
@@ -862,7 +865,11 @@ static PetscErrorCode PCGAMGCoarsen_AGG(PC a_pc,Mat *a_Gmat1,PetscCoarsenData **
   if (bs != 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"bs %D must be 1",bs);
   nloc = n/bs;
 
-  if (pc_gamg->current_level < pc_gamg_agg->square_graph) {
+  ierr = MatCoarsenCreate(comm, &crs);CHKERRQ(ierr);
+  ierr = MatCoarsenSetFromOptions(crs);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)crs,MATCOARSENMIS2,&ismis2);CHKERRQ(ierr);
+  /* the distance-2 MIS provides the aggregates of the squared graph */
+  if (pc_gamg->current_level < pc_gamg_agg->square_graph && !ismis2) {
     ierr = PCGAMGSquareGraph_GAMG(a_pc,Gmat1,&Gmat2);CHKERRQ(ierr);
   } else Gmat2 = Gmat1;
 
@@ -886,8 +893,6 @@ static PetscErrorCode PCGAMGCoarsen_AGG(PC a_pc,Mat *a_Gmat1,PetscCoarsenData **
   ierr = PetscRandomDestroy(&random);CHKERRQ(ierr);
   ierr = ISCreateGeneral(PETSC_COMM_SELF, nloc, permute, PETSC_USE_POINTER, &perm);CHKERRQ(ierr);
   ierr = PetscLogEventBegin(petsc_gamg_setup_events[SET4],0,0,0,0);CHKERRQ(ierr);
-  ierr = MatCoarsenCreate(comm, &crs);CHKERRQ(ierr);
-  ierr = MatCoarsenSetFromOptions(crs);CHKERRQ(ierr);
   ierr = MatCoarsenSetGreedyOrdering(crs, perm);CHKERRQ(ierr);
   ierr = MatCoarsenSetAdjacency(crs, Gmat2);CHKERRQ(ierr);
   ierr = MatCoarsenSetStrictAggs(crs, PETSC_TRUE);CHKERRQ(ierr);
@@ -1057,6 +1062,86 @@ static PetscErrorCode PCGAMGProlongator_AGG(PC pc,Mat Amat,Mat Gmat,PetscCoarsen
 }
 
 /* -------------------------------------------------------------------------- */
+/* one step of the power iteration for D^{-1} A: v := D^{-1} A v/|D^{-1} A v|, lambda = |D^{-1} A v| for the normalized v */
+static PetscErrorCode PCGAMGPowerStep_AGG(Mat Amat,Vec dinv,Vec v,PetscReal *lambda)
+{
+  PetscErrorCode ierr;
+  Vec            w;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(v,&w);CHKERRQ(ierr);
+  ierr = MatMult(Amat,v,w);CHKERRQ(ierr);
+  ierr = VecPointwiseMult(v,w,dinv);CHKERRQ(ierr);
+  ierr = VecNormalize(v,lambda);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCGAMGRefreshProlongator_AGG - recomputes the values of the smoothed prolongator of a level, with the tentative prolongator, sparsity and
+   symbolic product A Ptent of the first setup, if the diagonal of its operator changed by more than the refresh tolerance
+
+  Input Parameter:
+   . pc - this
+   . level - the level
+   . Amat - the new operator on this fine level
+  Output Parameter:
+   . refreshed - the prolongator was refreshed
+*/
+static PetscErrorCode PCGAMGRefreshProlongator_AGG(PC pc,PetscInt level,Mat Amat,PetscBool *refreshed)
+{
+  PetscErrorCode ierr;
+  PC_MG          *mg      = (PC_MG*)pc->data;
+  PC_GAMG        *pc_gamg = (PC_GAMG*)mg->innerctx;
+  PCGAMGRefresh  *rf      = &pc_gamg->refresh[level];
+  Vec            diag,w;
+  PetscReal      drift,lambda;
+
+  PetscFunctionBegin;
+  *refreshed = PETSC_FALSE;
+  if (!rf->P) PetscFunctionReturn(0);
+  ierr = VecDuplicate(rf->diag,&diag);CHKERRQ(ierr);
+  ierr = VecDuplicate(rf->diag,&w);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(Amat,diag);CHKERRQ(ierr);
+  ierr = VecPointwiseDivide(w,diag,rf->diag);CHKERRQ(ierr);
+  ierr = VecShift(w,-1.0);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_INFINITY,&drift);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  if (drift <= pc_gamg->refresh_tol) {
+    ierr = PetscInfo3(pc,"Keep the prolongator of level %D, the diagonal changed by %g <= %g\n",level,(double)drift,(double)pc_gamg->refresh_tol);CHKERRQ(ierr);
+    ierr = VecDestroy(&diag);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscLogEventBegin(PC_GAMGOptProlongator_AGG,0,0,0,0);CHKERRQ(ierr);
+  ierr = VecCopy(diag,rf->diag);CHKERRQ(ierr);
+  ierr = VecReciprocal(diag);CHKERRQ(ierr);
+
+  /* scale the eigenvalue estimates as the warm started power iteration, unless they were given */
+  ierr = PCGAMGPowerStep_AGG(Amat,diag,rf->vpow,&lambda);CHKERRQ(ierr);
+  if (pc_gamg->emax <= 0.0 && lambda > 0.0 && rf->lambdapow > 0.0) {
+    rf->emin *= lambda/rf->lambdapow;
+    rf->emax *= lambda/rf->lambdapow;
+  }
+  rf->lambdapow = lambda;
+  if (pc_gamg->use_sa_esteig) {
+    mg->min_eigen_DinvA[level] = rf->emin;
+    mg->max_eigen_DinvA[level] = rf->emax;
+  }
+  ierr = PetscInfo4(pc,"Refresh the prolongator of level %D, the diagonal changed by %g, max eigen=%e min=%e\n",level,(double)drift,(double)rf->emax,(double)rf->emin);CHKERRQ(ierr);
+
+  /* P := (I - omega/lam D^{-1}A) Ptent in the sparsity of the first setup */
+  ierr = PetscLogEventBegin(petsc_gamg_setup_matmat_events[level][2],0,0,0,0);CHKERRQ(ierr);
+  ierr = MatMatMult(Amat,rf->Ptent,MAT_REUSE_MATRIX,PETSC_DEFAULT,&rf->AP);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(petsc_gamg_setup_matmat_events[level][2],0,0,0,0);CHKERRQ(ierr);
+  ierr = MatCopy(rf->AP,rf->P,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatDiagonalScale(rf->P,diag,NULL);CHKERRQ(ierr);
+  ierr = MatAYPX(rf->P,-1.4/rf->emax,rf->Ptent,SUBSET_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = VecDestroy(&diag);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PC_GAMGOptProlongator_AGG,0,0,0,0);CHKERRQ(ierr);
+  *refreshed = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
 /*
    PCGAMGOptProlongator_AGG
 
@@ -1073,12 +1158,14 @@ static PetscErrorCode PCGAMGOptProlongator_AGG(PC pc,Mat Amat,Mat *a_P)
   PC_GAMG        *pc_gamg     = (PC_GAMG*)mg->innerctx;
   PC_GAMG_AGG    *pc_gamg_agg = (PC_GAMG_AGG*)pc_gamg->subctx;
   PetscInt       jj;
+  PCGAMGRefresh  *rf          = &pc_gamg->refresh[pc_gamg->current_level];
   Mat            Prol  = *a_P;
   MPI_Comm       comm;
   KSP            eksp;
   Vec            bb, xx;
   PC             epc;
   PetscReal      alpha, emax, emin;
+  PetscBool      refresh;
 
   PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)Amat,&comm);CHKERRQ(ierr);
@@ -1148,6 +1235,9 @@ static PetscErrorCode PCGAMGOptProlongator_AGG(PC pc,Mat Amat,Mat *a_P)
     mg->max_eigen_DinvA[pc_gamg->current_level] = 0;
   }
 
+  /* keep what is needed to refresh the smoothed prolongator, see PCGAMGRefreshProlongator_AGG() */
+  refresh = (PetscBool)(pc_gamg->reuse_prol && pc_gamg->refresh_tol >= 0.0 && pc_gamg_agg->nsmooths == 1);
+
   /* smooth P0 */
   for (jj = 0; jj < pc_gamg_agg->nsmooths; jj++) {
     Mat tMat;
@@ -1159,12 +1249,22 @@ static PetscErrorCode PCGAMGOptProlongator_AGG(PC pc,Mat Amat,Mat *a_P)
     ierr = PetscLogEventBegin(petsc_gamg_setup_matmat_events[pc_gamg->current_level][2],0,0,0,0);CHKERRQ(ierr);
     ierr = MatMatMult(Amat, Prol, MAT_INITIAL_MATRIX, PETSC_DEFAULT, &tMat);CHKERRQ(ierr);
     ierr = PetscLogEventEnd(petsc_gamg_setup_matmat_events[pc_gamg->current_level][2],0,0,0,0);CHKERRQ(ierr);
-    ierr = MatProductClear(tMat);CHKERRQ(ierr);
+    if (refresh) {
+      rf->AP = tMat;
+      ierr   = PetscObjectReference((PetscObject)Prol);CHKERRQ(ierr);
+      rf->Ptent = Prol;
+      ierr   = MatDuplicate(rf->AP, MAT_COPY_VALUES, &tMat);CHKERRQ(ierr);
+    } else {
+      ierr = MatProductClear(tMat);CHKERRQ(ierr);
+    }
     ierr = MatCreateVecs(Amat, &diag, NULL);CHKERRQ(ierr);
     ierr = MatGetDiagonal(Amat, diag);CHKERRQ(ierr); /* effectively PCJACOBI */
+    if (refresh) {
+      ierr = VecDuplicate(diag, &rf->diag);CHKERRQ(ierr);
+      ierr = VecCopy(diag, rf->diag);CHKERRQ(ierr);
+    }
     ierr = VecReciprocal(diag);CHKERRQ(ierr);
     ierr = MatDiagonalScale(tMat, diag, NULL);CHKERRQ(ierr);
-    ierr = VecDestroy(&diag);CHKERRQ(ierr);
 
     /* TODO: Set a PCFailedReason and exit the building of the AMG preconditioner */
     if (emax == 0.0) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_PLIB,"Computed maximum singular value as zero");
@@ -1174,6 +1274,21 @@ static PetscErrorCode PCGAMGOptProlongator_AGG(PC pc,Mat Amat,Mat *a_P)
     ierr = MatAYPX(tMat, alpha, Prol, SUBSET_NONZERO_PATTERN);CHKERRQ(ierr);
     ierr = MatDestroy(&Prol);CHKERRQ(ierr);
     Prol = tMat;
+
+    /* start the power iteration that updates the eigenvalue estimates of the refreshes */
+    if (refresh) {
+      PetscInt its;
+
+      rf->emin = emin;
+      rf->emax = emax;
+      ierr     = PetscObjectReference((PetscObject)Prol);CHKERRQ(ierr);
+      rf->P    = Prol;
+      ierr     = VecDuplicate(diag, &rf->vpow);CHKERRQ(ierr);
+      ierr     = VecSetRandom(rf->vpow, NULL);CHKERRQ(ierr);
+      ierr     = VecNormalize(rf->vpow, NULL);CHKERRQ(ierr);
+      for (its=0; its<3; its++) {ierr = PCGAMGPowerStep_AGG(Amat, diag, rf->vpow, &rf->lambdapow);CHKERRQ(ierr);}
+    }
+    ierr = VecDestroy(&diag);CHKERRQ(ierr);
     ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET9],0,0,0,0);CHKERRQ(ierr);
   }
   ierr = PetscLogEventEnd(PC_GAMGOptProlongator_AGG,0,0,0,0);CHKERRQ(ierr);
@@ -1205,12 +1320,13 @@ PetscErrorCode  PCCreateGAMG_AGG(PC pc)
   /* reset does not do anything; setup not virtual */
 
   /* set internal function pointers */
-  pc_gamg->ops->graph             = PCGAMGGraph_AGG;
-  pc_gamg->ops->coarsen           = PCGAMGCoarsen_AGG;
-  pc_gamg->ops->prolongator       = PCGAMGProlongator_AGG;
-  pc_gamg->ops->optprolongator    = PCGAMGOptProlongator_AGG;
-  pc_gamg->ops->createdefaultdata = PCSetData_AGG;
-  pc_gamg->ops->view              = PCView_GAMG_AGG;
+  pc_gamg->ops->graph              = PCGAMGGraph_AGG;
+  pc_gamg->ops->coarsen            = PCGAMGCoarsen_AGG;
+  pc_gamg->ops->prolongator        = PCGAMGProlongator_AGG;
+  pc_gamg->ops->optprolongator     = PCGAMGOptProlongator_AGG;
+  pc_gamg->ops->refreshprolongator = PCGAMGRefreshProlongator_AGG;
+  pc_gamg->ops->createdefaultdata  = PCSetData_AGG;
+  pc_gamg->ops->view               = PCView_GAMG_AGG;
 
   pc_gamg_agg->square_graph = 1;
   pc_gamg_agg->sym_graph    = PETSC_FALSE;
@@ -32,6 +32,29 @@ static PetscFunctionList GAMGList = NULL;
 static PetscBool PCGAMGPackageInitialized;
 
 /* ----------------------------------------------------------------------------- */
+static PetscErrorCode PCGAMGRefreshReset_Private(PC_GAMG *pc_gamg)
+{
+  PetscErrorCode ierr;
+  PetscInt       level;
+
+  PetscFunctionBegin;
+  for (level = 0; level < PETSC_MG_MAXLEVELS; level++) {
+    PCGAMGRefresh *rf = &pc_gamg->refresh[level];
+
+    ierr = MatDestroy(&rf->Ptent);CHKERRQ(ierr);
+    ierr = MatDestroy(&rf->AP);CHKERRQ(ierr);
+    ierr = MatDestroy(&rf->P);CHKERRQ(ierr);
+    ierr = ISDestroy(&rf->perm);CHKERRQ(ierr);
+    ierr = VecDestroy(&rf->diag);CHKERRQ(ierr);
+    ierr = VecDestroy(&rf->vpow);CHKERRQ(ierr);
+    rf->chebysa  = PETSC_FALSE;
+    rf->nrefresh = 0;
+    ierr = MatDestroy(&pc_gamg->aijcopy[level]);CHKERRQ(ierr);
+    ierr = MatDestroy(&pc_gamg->aijptap[level]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode PCReset_GAMG(PC pc)
 {
   PetscErrorCode ierr, level;
@@ -48,6 +71,182 @@ PetscErrorCode PCReset_GAMG(PC pc)
   }
   pc_gamg->emin = 0;
   pc_gamg->emax = 0;
+  ierr = PCGAMGRefreshReset_Private(pc_gamg);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCGAMGRefreshLevel_Private - refreshes the interpolation of a level from its new fine operator, and the Chebyshev bounds that were
+   derived from the eigenvalue estimates of the smoothed aggregation
+
+   Input Parameter:
+   . pc - the preconditioner context
+   . level - the level of GAMG, 0 is the finest
+   . mglevel - the corresponding coarse level of PCMG
+   . A - the new operator of the level
+*/
+static PetscErrorCode PCGAMGRefreshLevel_Private(PC pc,PetscInt level,PetscInt mglevel,Mat A)
+{
+  PetscErrorCode ierr;
+  PC_MG          *mg      = (PC_MG*)pc->data;
+  PC_GAMG        *pc_gamg = (PC_GAMG*)mg->innerctx;
+  PCGAMGRefresh  *rf      = &pc_gamg->refresh[level];
+  PetscBool      refreshed;
+
+  PetscFunctionBegin;
+  ierr = (*pc_gamg->ops->refreshprolongator)(pc,level,A,&refreshed);CHKERRQ(ierr);
+  if (!refreshed) PetscFunctionReturn(0);
+  rf->nrefresh++;
+  /* the interpolation is the smoothed prolongator itself, or its columns moved by a process reduction */
+  if (rf->perm) {
+    IS       findices;
+    PetscInt Istart,Iend,bs;
+
+    ierr = MatGetBlockSize(A,&bs);CHKERRQ(ierr);
+    ierr = MatGetOwnershipRange(rf->P,&Istart,&Iend);CHKERRQ(ierr);
+    ierr = ISCreateStride(PetscObjectComm((PetscObject)pc),Iend-Istart,Istart,1,&findices);CHKERRQ(ierr);
+    ierr = ISSetBlockSize(findices,bs);CHKERRQ(ierr);
+    ierr = MatCreateSubMatrix(rf->P,findices,rf->perm,MAT_REUSE_MATRIX,&mg->levels[mglevel+1]->interpolate);CHKERRQ(ierr);
+    ierr = ISDestroy(&findices);CHKERRQ(ierr);
+  }
+  if (rf->chebysa) {
+    KSP           smoother = mg->levels[mglevel+1]->smoothd;
+    KSP_Chebyshev *cheb    = (KSP_Chebyshev*)smoother->data;
+
+    ierr = PetscInfo3(pc,"PCSetUp_GAMG: call KSPChebyshevSetEigenvalues on level %D with emax = %g emin = %g\n",level,(double)rf->emax,(double)rf->emin);CHKERRQ(ierr);
+    cheb->emin_computed = rf->emin;
+    cheb->emax_computed = rf->emax;
+    ierr = KSPChebyshevSetEigenvalues(smoother, cheb->tform[2]*rf->emin + cheb->tform[3]*rf->emax, cheb->tform[0]*rf->emin + cheb->tform[1]*rf->emax);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCGAMGGetAIJ_Private - the operator of a level in AIJ format, for the sparse products that build the next level. Levels stored
+   in BAIJ format are copied, there are no products of BAIJ matrices with the rectangular blocks of the prolongators. With reused
+   interpolations and PCGAMGSetKeepAIJProducts() the copy is kept, and only its values are updated while the nonzero state of the
+   level does not change.
+
+   Input Parameter:
+   . pc - the preconditioner context
+   . level - the level of GAMG, 0 is the finest
+   . A - the operator of the level
+   Output Parameter:
+   . Aaij - A itself, with a new reference, or its AIJ copy
+   . isbaij - whether A is stored in BAIJ format
+*/
+static PetscErrorCode PCGAMGGetAIJ_Private(PC pc,PetscInt level,Mat A,Mat *Aaij,PetscBool *isbaij)
+{
+  PetscErrorCode ierr;
+  PC_MG          *mg      = (PC_MG*)pc->data;
+  PC_GAMG        *pc_gamg = (PC_GAMG*)mg->innerctx;
+  PetscBool      cache    = (PetscBool)(pc_gamg->reuse_prol && pc_gamg->keep_aij);
+
+  PetscFunctionBegin;
+  ierr = PetscObjectBaseTypeCompareAny((PetscObject)A,isbaij,MATSEQBAIJ,MATMPIBAIJ,"");CHKERRQ(ierr);
+  if (*isbaij) {
+    if (cache && pc_gamg->aijcopy[level] && pc_gamg->aijstate[level] == A->nonzerostate) {
+      ierr = MatConvert(A,MATAIJ,MAT_REUSE_MATRIX,&pc_gamg->aijcopy[level]);CHKERRQ(ierr);
+      ierr = PetscObjectReference((PetscObject)pc_gamg->aijcopy[level]);CHKERRQ(ierr);
+      *Aaij = pc_gamg->aijcopy[level];
+      PetscFunctionReturn(0);
+    }
+    ierr = MatConvert(A,MATAIJ,MAT_INITIAL_MATRIX,Aaij);CHKERRQ(ierr);
+    ierr = MatPropagateSymmetryOptions(A,*Aaij);CHKERRQ(ierr);
+    if (cache) {
+      ierr = MatDestroy(&pc_gamg->aijcopy[level]);CHKERRQ(ierr);
+      ierr = MatDestroy(&pc_gamg->aijptap[level]);CHKERRQ(ierr);
+      ierr = PetscObjectReference((PetscObject)*Aaij);CHKERRQ(ierr);
+      pc_gamg->aijcopy[level]  = *Aaij;
+      pc_gamg->aijstate[level] = A->nonzerostate;
+    }
+  } else {
+    ierr  = PetscObjectReference((PetscObject)A);CHKERRQ(ierr);
+    *Aaij = A;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCGAMGSetUpCoarseSubcomm_Private - solves the coarse grid, whose equations were moved to some of the processes, with PCTELESCOPE on the
+   subcommunicator of these processes, so that the other processes do not take part in the reductions of the coarse grid solver. The
+   coarse grid solver is set up by PCMG, after its options are processed, see PCGAMGSetCoarseSubcommSolver_Private().
+
+   Input Parameter:
+   . pc - the preconditioner context
+   . coarse - the coarse grid solver
+   . A - the coarse grid operator
+*/
+static PetscErrorCode PCGAMGSetUpCoarseSubcomm_Private(PC pc,KSP coarse,Mat A)
+{
+  PetscErrorCode   ierr;
+  MPI_Comm         comm;
+  PetscMPIInt      rank,size,active,nactive,redfactor,lmatch[2],match[2];
+  PetscInt         n;
+  PC               tpc;
+  PetscSubcommType type;
+
+  PetscFunctionBegin;
+  ierr   = PetscObjectGetComm((PetscObject)A,&comm);CHKERRQ(ierr);
+  ierr   = MPI_Comm_rank(comm,&rank);CHKERRMPI(ierr);
+  ierr   = MPI_Comm_size(comm,&size);CHKERRMPI(ierr);
+  ierr   = MatGetLocalSize(A,&n,NULL);CHKERRQ(ierr);
+  active = n ? 1 : 0;
+  ierr   = MPIU_Allreduce(&active,&nactive,1,MPI_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  if (nactive == size || size%nactive) {
+    ierr = PetscInfo2(pc,"Coarse grid on %d of %d processes, not using a subcommunicator\n",nactive,size);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  /* the active processes must form the first subcommunicator of PCTELESCOPE: the multiples of the reduction factor (spread
+     layout of the coarse grids) or the first processes (compact layout) */
+  redfactor = size/nactive;
+  lmatch[0] = (PetscMPIInt)((n > 0) == !(rank%redfactor));
+  lmatch[1] = (PetscMPIInt)((n > 0) == (rank < nactive));
+  ierr      = MPIU_Allreduce(lmatch,match,2,MPI_INT,MPI_MIN,comm);CHKERRQ(ierr);
+  if (!match[0] && !match[1]) {
+    ierr = PetscInfo2(pc,"The %d processes of the coarse grid are not a subcommunicator with reduction factor %d, not using it\n",nactive,redfactor);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  type = match[0] ? PETSC_SUBCOMM_INTERLACED : PETSC_SUBCOMM_CONTIGUOUS;
+  ierr = PetscInfo3(pc,"Coarse grid solver on the %s subcommunicator of %d of %d processes\n",match[0] ? "interlaced" : "contiguous",nactive,size);CHKERRQ(ierr);
+
+  ierr = KSPSetType(coarse,KSPPREONLY);CHKERRQ(ierr);
+  ierr = KSPGetPC(coarse,&tpc);CHKERRQ(ierr);
+  ierr = PCSetType(tpc,PCTELESCOPE);CHKERRQ(ierr);
+  ierr = PCTelescopeSetReductionFactor(tpc,redfactor);CHKERRQ(ierr);
+  ierr = PCTelescopeSetSubcommType(tpc,type);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCGAMGSetCoarseSubcommSolver_Private - once PCMG has set up the coarse grid solver, makes the solver of the subcommunicator the default
+   parallel coarse grid solver of PCMG, KSPPREONLY with PCREDUNDANT (PCLU on one process), unless -mg_coarse_telescope_pc_type is given
+   or the coarse grid solver is not PCTELESCOPE
+
+   Input Parameter:
+   . pc - the preconditioner context
+*/
+static PetscErrorCode PCGAMGSetCoarseSubcommSolver_Private(PC pc)
+{
+  PetscErrorCode ierr;
+  KSP            coarse,inner;
+  PC             tpc,ipc;
+  PetscMPIInt    nactive;
+  PetscBool      istelescope,flg;
+
+  PetscFunctionBegin;
+  ierr = PCMGGetCoarseSolve(pc,&coarse);CHKERRQ(ierr);
+  ierr = KSPGetPC(coarse,&tpc);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)tpc,PCTELESCOPE,&istelescope);CHKERRQ(ierr);
+  if (!istelescope) PetscFunctionReturn(0);
+  ierr = PCTelescopeGetKSP(tpc,&inner);CHKERRQ(ierr);
+  if (!inner) PetscFunctionReturn(0);
+  ierr = PetscOptionsHasName(((PetscObject)inner)->options,((PetscObject)inner)->prefix,"-pc_type",&flg);CHKERRQ(ierr);
+  if (flg) PetscFunctionReturn(0);
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)inner),&nactive);CHKERRMPI(ierr);
+  ierr = KSPGetPC(inner,&ipc);CHKERRQ(ierr);
+  ierr = PCSetType(ipc,nactive > 1 ? PCREDUNDANT : PCLU);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(inner);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -503,11 +702,11 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
   PetscInt       fine_level,level,level1,bs,M,N,qq,lidx,nASMBlocksArr[PETSC_MG_MAXLEVELS];
   MPI_Comm       comm;
   PetscMPIInt    rank,size,nactivepe;
-  Mat            Aarr[PETSC_MG_MAXLEVELS],Parr[PETSC_MG_MAXLEVELS];
+  Mat            Aarr[PETSC_MG_MAXLEVELS],Parr[PETSC_MG_MAXLEVELS],Aaij;
   IS             *ASMLocalIDsArr[PETSC_MG_MAXLEVELS];
   PetscLogDouble nnz0=0.,nnztot=0.;
   MatInfo        info;
-  PetscBool      is_last = PETSC_FALSE;
+  PetscBool      is_last = PETSC_FALSE,isbaij;
 
   PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)pc,&comm);CHKERRQ(ierr);
@@ -518,11 +717,13 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
     if (!pc_gamg->reuse_prol || pc->flag == DIFFERENT_NONZERO_PATTERN) {
       /* reset everything */
       ierr = PCReset_MG(pc);CHKERRQ(ierr);
+      ierr = PCGAMGRefreshReset_Private(pc_gamg);CHKERRQ(ierr);
       pc->setupcalled = 0;
     } else {
       PC_MG_Levels **mglevels = mg->levels;
       /* just do Galerkin grids */
-      Mat          B,dA,dB;
+      Mat          B,dA,dB,dBaij;
+      PetscBool    isbaij;
 
       if (pc_gamg->Nlevels > 1) {
         PetscInt gl;
@@ -534,23 +735,43 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
         for (level=pc_gamg->Nlevels-2,gl=0; level>=0; level--,gl++) {
           MatReuse reuse = MAT_INITIAL_MATRIX ;
 
+          /* BAIJ levels compute their products in AIJ format and store the new coarse operator in BAIJ format */
+          ierr = PCGAMGGetAIJ_Private(pc,gl,dB,&dBaij,&isbaij);CHKERRQ(ierr);
+          /* numerical refresh of the prolongator from the new fine operator */
+          if (pc_gamg->refresh_tol >= 0.0 && pc_gamg->ops->refreshprolongator) {
+            ierr = PCGAMGRefreshLevel_Private(pc,gl,level,dBaij);CHKERRQ(ierr);
+          }
           /* matrix structure can change from repartitioning or process reduction but don't know if we have process reduction here. Should fix */
           ierr = KSPGetOperators(mglevels[level]->smoothd,NULL,&B);CHKERRQ(ierr);
-          if (B->product) {
+          if (isbaij) {
+            /* the product of the AIJ copy, kept with PCGAMGSetKeepAIJProducts(), has its values copied into the BAIJ coarse operator of the first setup */
+            Mat C = pc_gamg->aijptap[gl];
+
+            if (C && C->product && C->product->A == dBaij && C->product->B == mglevels[level+1]->interpolate) reuse = MAT_REUSE_MATRIX;
+            else {ierr = MatDestroy(&pc_gamg->aijptap[gl]);CHKERRQ(ierr);}
+          } else if (B->product) {
             if (B->product->A == dB && B->product->B == mglevels[level+1]->interpolate) {
               reuse = MAT_REUSE_MATRIX;
             }
           }
-          if (reuse == MAT_INITIAL_MATRIX) { ierr = MatDestroy(&mglevels[level]->A);CHKERRQ(ierr); }
+          if (reuse == MAT_INITIAL_MATRIX && !isbaij) { ierr = MatDestroy(&mglevels[level]->A);CHKERRQ(ierr); }
           if (reuse == MAT_REUSE_MATRIX) {
             ierr = PetscInfo1(pc,"RAP after first solve, reuse matrix level %D\n",level);CHKERRQ(ierr);
           } else {
             ierr = PetscInfo1(pc,"RAP after first solve, new matrix level %D\n",level);CHKERRQ(ierr);
           }
           ierr = PetscLogEventBegin(petsc_gamg_setup_matmat_events[gl][1],0,0,0,0);CHKERRQ(ierr);
-          ierr = MatPtAP(dB,mglevels[level+1]->interpolate,reuse,PETSC_DEFAULT,&B);CHKERRQ(ierr);
+          if (isbaij) {
+            ierr = MatPtAP(dBaij,mglevels[level+1]->interpolate,reuse,PETSC_DEFAULT,&pc_gamg->aijptap[gl]);CHKERRQ(ierr);
+          } else {
+            ierr = MatPtAP(dBaij,mglevels[level+1]->interpolate,reuse,PETSC_DEFAULT,&B);CHKERRQ(ierr);
+          }
           ierr = PetscLogEventEnd(petsc_gamg_setup_matmat_events[gl][1],0,0,0,0);CHKERRQ(ierr);
-          if (reuse == MAT_INITIAL_MATRIX) mglevels[level]->A = B;
+          ierr = MatDestroy(&dBaij);CHKERRQ(ierr);
+          if (isbaij) {
+            ierr = MatConvert(pc_gamg->aijptap[gl],MATBAIJ,MAT_REUSE_MATRIX,&B);CHKERRQ(ierr);
+            if (!pc_gamg->keep_aij) {ierr = MatDestroy(&pc_gamg->aijptap[gl]);CHKERRQ(ierr);}
+          } else if (reuse == MAT_INITIAL_MATRIX) mglevels[level]->A = B;
           ierr = KSPSetOperators(mglevels[level]->smoothd,B,B);CHKERRQ(ierr);
           dB   = B;
         }
@@ -611,7 +832,9 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
 
       ierr = pc_gamg->ops->graph(pc,Aarr[level], &Gmat);CHKERRQ(ierr);
       ierr = pc_gamg->ops->coarsen(pc, &Gmat, &agg_lists);CHKERRQ(ierr);
-      ierr = pc_gamg->ops->prolongator(pc,Aarr[level],Gmat,agg_lists,&Prol11);CHKERRQ(ierr);
+      /* the graph is read from BAIJ levels directly, the prolongator and the Galerkin product use their AIJ copy */
+      ierr = PCGAMGGetAIJ_Private(pc,level,Aarr[level],&Aaij,&isbaij);CHKERRQ(ierr);
+      ierr = pc_gamg->ops->prolongator(pc,Aaij,Gmat,agg_lists,&Prol11);CHKERRQ(ierr);
 
       /* could have failed to create new level */
       if (Prol11) {
@@ -623,7 +846,7 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
 
         if (pc_gamg->ops->optprolongator) {
           /* smooth */
-          ierr = pc_gamg->ops->optprolongator(pc, Aarr[level], &Prol11);CHKERRQ(ierr);
+          ierr = pc_gamg->ops->optprolongator(pc, Aaij, &Prol11);CHKERRQ(ierr);
         }
 
         if (pc_gamg->use_aggs_in_asm) {
@@ -649,6 +872,7 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
     ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET1],0,0,0,0);CHKERRQ(ierr);
     if (!level) Aarr[0] = Pmat; /* use Pmat for finest level setup */
     if (!Parr[level1]) { /* failed to coarsen */
+      ierr = MatDestroy(&Aaij);CHKERRQ(ierr);
       ierr = PetscInfo1(pc,"Stop gridding, level %D\n",level);CHKERRQ(ierr);
 #if defined(GAMG_STAGES)
       ierr = PetscLogStagePop();CHKERRQ(ierr);
@@ -660,7 +884,10 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
     if (is_last) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Is last ?");
     if (N <= pc_gamg->coarse_eq_limit) is_last = PETSC_TRUE;
     if (level1 == pc_gamg->Nlevels-1) is_last = PETSC_TRUE;
-    ierr = pc_gamg->ops->createlevel(pc, Aarr[level], bs, &Parr[level1], &Aarr[level1], &nactivepe, NULL, is_last);CHKERRQ(ierr);
+    ierr = pc_gamg->ops->createlevel(pc, Aaij, bs, &Parr[level1], &Aarr[level1], &nactivepe, pc_gamg->refresh[level].P ? &pc_gamg->refresh[level].perm : NULL, is_last);CHKERRQ(ierr);
+    ierr = MatDestroy(&Aaij);CHKERRQ(ierr);
+    /* the coarse operators of a BAIJ matrix are BAIJ with the block size of the near null space */
+    if (isbaij) {ierr = MatConvert(Aarr[level1],MATBAIJ,MAT_INPLACE_MATRIX,&Aarr[level1]);CHKERRQ(ierr);}
 
     ierr = PetscLogEventEnd(petsc_gamg_setup_events[SET2],0,0,0,0);CHKERRQ(ierr);
     ierr = MatGetSize(Aarr[level1], &M, &N);CHKERRQ(ierr); /* M is loop test variables */
@@ -752,6 +979,8 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
         ierr = PCFactorSetShiftType(pc2,MAT_SHIFT_INBLOCKS);CHKERRQ(ierr);
         ierr = KSPSetTolerances(k2[0],PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT,1);CHKERRQ(ierr);
         ierr = KSPSetType(k2[0], KSPPREONLY);CHKERRQ(ierr);
+      } else if (pc_gamg->coarse_subcomm) {
+        ierr = PCGAMGSetUpCoarseSubcomm_Private(pc, smoother, Lmat);CHKERRQ(ierr);
       }
     }
 
@@ -788,6 +1017,7 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
               cheb->emin_computed = emin;
               cheb->emax_computed = emax;
               ierr = KSPChebyshevSetEigenvalues(smoother, cheb->tform[2]*emin + cheb->tform[3]*emax, cheb->tform[0]*emin + cheb->tform[1]*emax);CHKERRQ(ierr);
+              pc_gamg->refresh[level].chebysa = PETSC_TRUE;
 
               /* We have set the eigenvalues and consumed the transformation values
                  prevent from flagging the recomputation of the eigenvalues again in PCSetUp_MG
@@ -800,7 +1030,24 @@ PetscErrorCode PCSetUp_GAMG(PC pc)
       }
     }
 
+    /* Chebyshev smoothers that estimate their eigenvalues keep them while refreshes change the operators little */
+    if (pc_gamg->reuse_prol && pc_gamg->refresh_tol > 0.0) {
+      for (lidx = 1; lidx < pc_gamg->Nlevels; lidx++) {
+        KSP       smoother;
+        PetscBool ischeb;
+
+        ierr = PCMGGetSmoother(pc, lidx, &smoother);CHKERRQ(ierr);
+        ierr = PetscObjectTypeCompare((PetscObject)smoother,KSPCHEBYSHEV,&ischeb);CHKERRQ(ierr);
+        if (ischeb && ((KSP_Chebyshev*)smoother->data)->reusetol == 0.0) {
+          ierr = KSPChebyshevEstEigSetReuseTolerance(smoother, pc_gamg->refresh_tol);CHKERRQ(ierr);
+        }
+      }
+    }
+
     ierr = PCSetUp_MG(pc);CHKERRQ(ierr);
+    if (pc_gamg->use_parallel_coarse_grid_solver && pc_gamg->coarse_subcomm) {
+      ierr = PCGAMGSetCoarseSubcommSolver_Private(pc);CHKERRQ(ierr);
+    }
 
     /* restore Chebyshev smoother for next calls */
     if (pc_gamg->use_sa_esteig==1) {
@@ -1149,8 +1396,9 @@ static PetscErrorCode PCGAMGSetEigenvalues_GAMG(PC pc,PetscReal emax,PetscReal e
    Notes:
     this may negatively affect the convergence rate of the method on new matrices if the matrix entries change a great deal, but allows
           rebuilding the preconditioner quicker.
+          With MATBAIJ operators the Galerkin products are computed with MATAIJ copies of the levels, see PCGAMGSetKeepAIJProducts().
 
-.seealso: ()
+.seealso: PCGAMGSetKeepAIJProducts(), PCGAMGSetRefreshTolerance()
 @*/
 PetscErrorCode PCGAMGSetReuseInterpolation(PC pc, PetscBool n)
 {
@@ -1172,6 +1420,98 @@ static PetscErrorCode PCGAMGSetReuseInterpolation_GAMG(PC pc, PetscBool n)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCGAMGSetKeepAIJProducts - Keep the MATAIJ copies of MATBAIJ levels and their Galerkin products between setups with reused interpolations
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  flg - PETSC_TRUE to keep them
+
+   Options Database Key:
+.  -pc_gamg_keep_aij_products <true,false>
+
+   Level: advanced
+
+   Notes:
+   There are no sparse products of MATBAIJ matrices with the rectangular blocks of the prolongators, so the Galerkin product of a
+   MATBAIJ level is computed with a temporary MATAIJ copy of the level and the result is converted back to MATBAIJ. By default the
+   copy and the product are freed as soon as the coarse operator is built.
+
+   With PCGAMGSetReuseInterpolation() and this option, the copies and the products are kept with their symbolic data, so that
+   later setups only update their values. This stores each level operator about 2.5 times: the MATBAIJ operator, its MATAIJ copy
+   (which needs 12 instead of about 8 bytes per nonzero) and the MATAIJ product that is the next coarse operator again.
+
+.seealso: PCGAMGSetReuseInterpolation()
+@*/
+PetscErrorCode PCGAMGSetKeepAIJProducts(PC pc, PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveBool(pc,flg,2);
+  ierr = PetscTryMethod(pc,"PCGAMGSetKeepAIJProducts_C",(PC,PetscBool),(pc,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PCGAMGSetKeepAIJProducts_GAMG(PC pc, PetscBool flg)
+{
+  PC_MG   *mg      = (PC_MG*)pc->data;
+  PC_GAMG *pc_gamg = (PC_GAMG*)mg->innerctx;
+
+  PetscFunctionBegin;
+  pc_gamg->keep_aij = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PCGAMGSetRefreshTolerance - Refresh the values of the reused prolongators when the operator changed enough
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  tol - largest relative change of the diagonal of the operator of a level for which its smoothed prolongator is kept, negative (the default) to always keep it
+
+   Options Database Key:
+.  -pc_gamg_refresh_tol <tol>
+
+   Level: intermediate
+
+   Notes:
+   This is used with PCGAMGSetReuseInterpolation() and smoothed aggregation with one smoothing step, and must be set before the first setup.
+   The graph, aggregates, tentative prolongators and the sparsity of the smoothed prolongators and of the Galerkin products are then kept.
+   When the preconditioner is rebuilt with the same nonzero pattern, each level, from the finest one, measures the largest relative change of the
+   diagonal of its operator since its smoothed prolongator was last computed. Beyond tol, the values of the prolongator are recomputed with the
+   symbolic product of the first setup, and its eigenvalue estimates are scaled by one step of a power iteration continued from the previous setups.
+   The Galerkin products always reuse their symbolic data. The Chebyshev smoothers that estimate their eigenvalues are also given this tolerance
+   with KSPChebyshevEstEigSetReuseTolerance(), unless a tolerance is already set on them. PCView() shows the number of refreshed prolongators.
+
+.seealso: PCGAMGSetReuseInterpolation(), KSPChebyshevEstEigSetReuseTolerance(), PCGAMGSetNSmooths()
+@*/
+PetscErrorCode PCGAMGSetRefreshTolerance(PC pc, PetscReal tol)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveReal(pc,tol,2);
+  ierr = PetscTryMethod(pc,"PCGAMGSetRefreshTolerance_C",(PC,PetscReal),(pc,tol));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PCGAMGSetRefreshTolerance_GAMG(PC pc, PetscReal tol)
+{
+  PC_MG   *mg      = (PC_MG*)pc->data;
+  PC_GAMG *pc_gamg = (PC_GAMG*)mg->innerctx;
+
+  PetscFunctionBegin;
+  pc_gamg->refresh_tol = tol;
+  PetscFunctionReturn(0);
+}
+
 /*@
    PCGAMGASMSetUseAggs - Have the PCGAMG smoother on each level use the aggregates defined by the coarsening process as the subdomains for the additive Schwarz preconditioner.
 
@@ -1222,7 +1562,7 @@ static PetscErrorCode PCGAMGASMSetUseAggs_GAMG(PC pc, PetscBool flg)
 
    Level: intermediate
 
-.seealso: PCGAMGSetCoarseGridLayoutType(), PCGAMGSetCpuPinCoarseGrids()
+.seealso: PCGAMGSetCoarseGridLayoutType(), PCGAMGSetCpuPinCoarseGrids(), PCGAMGSetCoarseSubcomm()
 @*/
 PetscErrorCode PCGAMGSetUseParallelCoarseGridSolve(PC pc, PetscBool flg)
 {
@@ -1244,6 +1584,50 @@ static PetscErrorCode PCGAMGSetUseParallelCoarseGridSolve_GAMG(PC pc, PetscBool
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCGAMGSetCoarseSubcomm - solve the coarse grid on the subcommunicator of the processes that hold its equations
+
+   Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  flg - PETSC_TRUE to use the subcommunicator
+
+   Options Database Key:
+.  -pc_gamg_coarse_subcomm
+
+   Notes:
+    With a parallel coarse grid solver, see PCGAMGSetUseParallelCoarseGridSolve(), the coarsest grid is usually held by a few processes only,
+    see PCGAMGSetProcEqLim(), but all the processes take part in the reductions of its solver. With this option the coarse grid is solved by PCTELESCOPE
+    on the subcommunicator of these processes, with the reduction factor and the subcommunicator type (interlaced for the spread layout, contiguous
+    for the compact layout, see PCGAMGSetCoarseGridLayoutType()) that keep every coarse grid equation on its process. The solver on the
+    subcommunicator, by default KSPPREONLY with PCREDUNDANT (PCLU on one process), is set with the -mg_coarse_telescope_ prefix. Nothing is
+    changed when the coarse grid is held by all the processes, or by processes that do not form such a subcommunicator.
+
+   Level: intermediate
+
+.seealso: PCGAMGSetUseParallelCoarseGridSolve(), PCGAMGSetProcEqLim(), PCGAMGSetCoarseGridLayoutType(), PCTELESCOPE
+@*/
+PetscErrorCode PCGAMGSetCoarseSubcomm(PC pc, PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  ierr = PetscTryMethod(pc,"PCGAMGSetCoarseSubcomm_C",(PC,PetscBool),(pc,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PCGAMGSetCoarseSubcomm_GAMG(PC pc, PetscBool flg)
+{
+  PC_MG   *mg      = (PC_MG*)pc->data;
+  PC_GAMG *pc_gamg = (PC_GAMG*)mg->innerctx;
+
+  PetscFunctionBegin;
+  pc_gamg->coarse_subcomm = flg;
+  PetscFunctionReturn(0);
+}
+
 /*@
    PCGAMGSetCpuPinCoarseGrids - pin reduced grids to CPU
 
@@ -1624,6 +2008,15 @@ static PetscErrorCode PCView_GAMG(PC pc,PetscViewer viewer)
   }
   if (pc_gamg->use_parallel_coarse_grid_solver) {
     ierr = PetscViewerASCIIPrintf(viewer,"      Using parallel coarse grid solver (all coarse grid equations not put on one process)\n");CHKERRQ(ierr);
+    if (pc_gamg->coarse_subcomm) {
+      ierr = PetscViewerASCIIPrintf(viewer,"      Solving the coarse grid on the subcommunicator of its processes\n");CHKERRQ(ierr);
+    }
+  }
+  if (pc_gamg->reuse_prol && pc_gamg->refresh_tol >= 0.0) {
+    PetscInt level,nrefresh = 0;
+
+    for (level=0; level<PETSC_MG_MAXLEVELS; level++) nrefresh += pc_gamg->refresh[level].nrefresh;
+    ierr = PetscViewerASCIIPrintf(viewer,"      Refreshing the reused prolongators when the diagonal of the operator changes more than %g, %D refreshes so far\n",(double)pc_gamg->refresh_tol,nrefresh);CHKERRQ(ierr);
   }
 #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
   if (pc_gamg->cpu_pin_coarse_grids) {
@@ -1670,8 +2063,11 @@ PetscErrorCode PCSetFromOptions_GAMG(PetscOptionItems *PetscOptionsObject,PC pc)
   ierr = PetscOptionsBool("-pc_gamg_use_sa_esteig","Use eigen estimate from Smoothed aggregation for smoother","PCGAMGSetUseSAEstEig",f2,&f2,&flag);CHKERRQ(ierr);
   if (flag) pc_gamg->use_sa_esteig = f2 ? 1 : 0;
   ierr = PetscOptionsBool("-pc_gamg_reuse_interpolation","Reuse prolongation operator","PCGAMGReuseInterpolation",pc_gamg->reuse_prol,&pc_gamg->reuse_prol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-pc_gamg_keep_aij_products","Keep the AIJ copies of BAIJ levels and their Galerkin products with reused interpolations","PCGAMGSetKeepAIJProducts",pc_gamg->keep_aij,&pc_gamg->keep_aij,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-pc_gamg_refresh_tol","Refresh the reused smoothed prolongators when the diagonal of the operator changes more than this","PCGAMGSetRefreshTolerance",pc_gamg->refresh_tol,&pc_gamg->refresh_tol,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-pc_gamg_asm_use_agg","Use aggregation aggregates for ASM smoother","PCGAMGASMSetUseAggs",pc_gamg->use_aggs_in_asm,&pc_gamg->use_aggs_in_asm,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-pc_gamg_use_parallel_coarse_grid_solver","Use parallel coarse grid solver (otherwise put last grid on one process)","PCGAMGSetUseParallelCoarseGridSolve",pc_gamg->use_parallel_coarse_grid_solver,&pc_gamg->use_parallel_coarse_grid_solver,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-pc_gamg_coarse_subcomm","Solve the coarse grid on the subcommunicator of its processes","PCGAMGSetCoarseSubcomm",pc_gamg->coarse_subcomm,&pc_gamg->coarse_subcomm,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-pc_gamg_cpu_pin_coarse_grids","Pin coarse grids to the CPU","PCGAMGSetCpuPinCoarseGrids",pc_gamg->cpu_pin_coarse_grids,&pc_gamg->cpu_pin_coarse_grids,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnum("-pc_gamg_coarse_grid_layout_type","compact: place reduced grids on processes in natural order; spread: distribute to whole machine for more memory bandwidth","PCGAMGSetCoarseGridLayoutType",LayoutTypes,(PetscEnum)pc_gamg->layout_type,(PetscEnum*)&pc_gamg->layout_type,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_gamg_process_eq_limit","Limit (goal) on number of equations per process on coarse grids","PCGAMGSetProcEqLim",pc_gamg->min_eq_proc,&pc_gamg->min_eq_proc,NULL);CHKERRQ(ierr);
@@ -1717,10 +2113,13 @@ PetscErrorCode PCSetFromOptions_GAMG(PetscOptionItems *PetscOptionsObject,PC pc)
 +   -pc_gamg_type <type> - one of agg, geo, or classical
 .   -pc_gamg_repartition  <true,default=false> - repartition the degrees of freedom accross the coarse grids as they are determined
 .   -pc_gamg_reuse_interpolation <true,default=false> - when rebuilding the algebraic multigrid preconditioner reuse the previously computed interpolations
+.   -pc_gamg_refresh_tol <tol,default=-1> - with reused interpolations, recompute the values of the smoothed prolongators of the levels whose diagonal changed more than tol (PCGAMGSetRefreshTolerance())
+.   -pc_gamg_keep_aij_products <true,default=false> - with reused interpolations and MATBAIJ operators, keep the MATAIJ copies of the levels and their Galerkin products (PCGAMGSetKeepAIJProducts())
 .   -pc_gamg_asm_use_agg <true,default=false> - use the aggregates from the coasening process to defined the subdomains on each level for the PCASM smoother
 .   -pc_gamg_process_eq_limit <limit, default=50> - GAMG will reduce the number of MPI processes used directly on the coarse grids so that there are around <limit>
                                         equations on each process that has degrees of freedom
 .   -pc_gamg_coarse_eq_limit <limit, default=50> - Set maximum number of equations on coarsest grid to aim for.
+.   -pc_gamg_coarse_subcomm <true,default=false> - with a parallel coarse grid solver, solve the coarse grid with PCTELESCOPE on the subcommunicator of the processes that hold it (PCGAMGSetCoarseSubcomm())
 .   -pc_gamg_threshold[] <thresh,default=0> - Before aggregating the graph GAMG will remove small values from the graph on each level
 -   -pc_gamg_threshold_scale <scale,default=1> - Scaling of threshold on each coarser grid if not specified
 
@@ -1741,10 +2140,13 @@ PetscErrorCode PCSetFromOptions_GAMG(PetscOptionItems *PetscOptionsObject,PC pc)
        Call MatSetNearNullSpace() (or PCSetCoordinates() if solving the equations of elasticity) to indicate the near null space of the operator
        See the Users Manual Chapter 4 for more details
 
+    With a MATBAIJ or MATMPIBAIJ operator the graph is read from the blocks directly and the coarse operators are stored in BAIJ format,
+    with the block size of the near null space, so that the smoothers of every level use the block kernels; the prolongators are AIJ.
+
   Level: intermediate
 
 .seealso:  PCCreate(), PCSetType(), MatSetBlockSize(), PCMGType, PCSetCoordinates(), MatSetNearNullSpace(), PCGAMGSetType(), PCGAMGAGG, PCGAMGGEO, PCGAMGCLASSICAL, PCGAMGSetProcEqLim(),
-           PCGAMGSetCoarseEqLim(), PCGAMGSetRepartition(), PCGAMGRegister(), PCGAMGSetReuseInterpolation(), PCGAMGASMSetUseAggs(), PCGAMGSetUseParallelCoarseGridSolve(), PCGAMGSetNlevels(), PCGAMGSetThreshold(), PCGAMGGetType(), PCGAMGSetReuseInterpolation(), PCGAMGSetUseSAEstEig(), PCGAMGSetEstEigKSPMaxIt(), PCGAMGSetEstEigKSPType()
+           PCGAMGSetCoarseEqLim(), PCGAMGSetRepartition(), PCGAMGRegister(), PCGAMGSetReuseInterpolation(), PCGAMGASMSetUseAggs(), PCGAMGSetUseParallelCoarseGridSolve(), PCGAMGSetCoarseSubcomm(), PCGAMGSetNlevels(), PCGAMGSetThreshold(), PCGAMGGetType(), PCGAMGSetReuseInterpolation(), PCGAMGSetUseSAEstEig(), PCGAMGSetEstEigKSPMaxIt(), PCGAMGSetEstEigKSPType()
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
@@ -1790,8 +2192,10 @@ PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetEigenvalues_C",PCGAMGSetEigenvalues_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetUseSAEstEig_C",PCGAMGSetUseSAEstEig_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetReuseInterpolation_C",PCGAMGSetReuseInterpolation_GAMG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetKeepAIJProducts_C",PCGAMGSetKeepAIJProducts_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGASMSetUseAggs_C",PCGAMGASMSetUseAggs_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetUseParallelCoarseGridSolve_C",PCGAMGSetUseParallelCoarseGridSolve_GAMG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetCoarseSubcomm_C",PCGAMGSetCoarseSubcomm_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetCpuPinCoarseGrids_C",PCGAMGSetCpuPinCoarseGrids_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetCoarseGridLayoutType_C",PCGAMGSetCoarseGridLayoutType_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetThreshold_C",PCGAMGSetThreshold_GAMG);CHKERRQ(ierr);
@@ -1800,10 +2204,13 @@ PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetType_C",PCGAMGSetType_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGGetType_C",PCGAMGGetType_GAMG);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetNlevels_C",PCGAMGSetNlevels_GAMG);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCGAMGSetRefreshTolerance_C",PCGAMGSetRefreshTolerance_GAMG);CHKERRQ(ierr);
   pc_gamg->repart           = PETSC_FALSE;
   pc_gamg->reuse_prol       = PETSC_FALSE;
+  pc_gamg->keep_aij         = PETSC_FALSE;
   pc_gamg->use_aggs_in_asm  = PETSC_FALSE;
   pc_gamg->use_parallel_coarse_grid_solver = PETSC_FALSE;
+  pc_gamg->coarse_subcomm   = PETSC_FALSE;
   pc_gamg->cpu_pin_coarse_grids = PETSC_FALSE;
   pc_gamg->layout_type      = PCGAMG_LAYOUT_SPREAD;
   pc_gamg->min_eq_proc      = 50;
@@ -1817,6 +2224,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_GAMG(PC pc)
   pc_gamg->use_sa_esteig    = -1;
   pc_gamg->emin             = 0;
   pc_gamg->emax             = 0;
+  pc_gamg->refresh_tol      = -1.0;
 
   pc_gamg->ops->createlevel = PCGAMGCreateLevel_GAMG;
 
@@ -3,6 +3,7 @@
  */
 #include <petsc/private/matimpl.h>
 #include <../src/ksp/pc/impls/gamg/gamg.h>           /*I "petscpc.h" I*/
+#include <../src/mat/impls/baij/mpi/mpibaij.h>
 
 /*
    Produces a set of block column indices of the matrix row, one for each block represented in the original row
@@ -53,6 +54,81 @@ PETSC_STATIC_INLINE PetscErrorCode MatCollapseRows(Mat Amat,PetscInt start,Petsc
   PetscFunctionReturn(0);
 }
 
+/*
+   PCGAMGCreateGraph_BAIJ - the scalar graph of a (MPI)BAIJ matrix, read block by block from its storage: one vertex per block row
+   and one edge per stored block, weighted with the sum of the absolute values of the block (the value itself with block size one)
+*/
+static PetscErrorCode PCGAMGCreateGraph_BAIJ(Mat Amat,Mat *a_Gmat)
+{
+  PetscErrorCode ierr;
+  Mat            Gmat,Ad = Amat,Ao = NULL;
+  Mat_SeqBAIJ    *ad,*ao = NULL;
+  const PetscInt *garray = NULL;
+  PetscInt       bs,bs2,nloc,rstart,cstart,Ii,kk,ll,n,maxnz = 0,*d_nnz,*o_nnz,*cols;
+  PetscScalar    *vals;
+  PetscBool      ismpibaij;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectBaseTypeCompare((PetscObject)Amat,MATMPIBAIJ,&ismpibaij);CHKERRQ(ierr);
+  if (ismpibaij) {
+    Mat_MPIBAIJ *baij = (Mat_MPIBAIJ*)Amat->data;
+
+    Ad     = baij->A;
+    Ao     = baij->B;
+    garray = baij->garray;
+    ao     = (Mat_SeqBAIJ*)Ao->data;
+  }
+  ad     = (Mat_SeqBAIJ*)Ad->data;
+  ierr   = MatGetBlockSize(Amat,&bs);CHKERRQ(ierr);
+  bs2    = bs*bs;
+  nloc   = Amat->rmap->n/bs;
+  rstart = Amat->rmap->rstart/bs;
+  cstart = Amat->cmap->rstart/bs;
+
+  /* exact preallocation, the block structure is the graph */
+  ierr = PetscMalloc2(nloc,&d_nnz,nloc,&o_nnz);CHKERRQ(ierr);
+  for (Ii=0; Ii<nloc; Ii++) {
+    d_nnz[Ii] = ad->i[Ii+1] - ad->i[Ii];
+    o_nnz[Ii] = ao ? ao->i[Ii+1] - ao->i[Ii] : 0;
+    maxnz     = PetscMax(maxnz,d_nnz[Ii]+o_nnz[Ii]);
+  }
+  ierr = MatCreate(PetscObjectComm((PetscObject)Amat),&Gmat);CHKERRQ(ierr);
+  ierr = MatSetSizes(Gmat,nloc,nloc,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
+  ierr = MatSetBlockSizes(Gmat,1,1);CHKERRQ(ierr);
+  ierr = MatSetType(Gmat,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(Gmat,0,d_nnz);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(Gmat,0,d_nnz,0,o_nnz);CHKERRQ(ierr);
+  ierr = PetscFree2(d_nnz,o_nnz);CHKERRQ(ierr);
+
+  ierr = PetscMalloc2(maxnz,&cols,maxnz,&vals);CHKERRQ(ierr);
+  for (Ii=0; Ii<nloc; Ii++) {
+    PetscInt row = rstart + Ii;
+
+    for (n=0,kk=ad->i[Ii]; kk<ad->i[Ii+1]; kk++,n++) {
+      const MatScalar *blk = ad->a + kk*bs2;
+
+      cols[n] = cstart + ad->j[kk];
+      if (bs == 1) vals[n] = blk[0];
+      else for (ll=0,vals[n]=0.0; ll<bs2; ll++) vals[n] += PetscAbs(PetscRealPart(blk[ll]));
+    }
+    if (ao) {
+      for (kk=ao->i[Ii]; kk<ao->i[Ii+1]; kk++,n++) {
+        const MatScalar *blk = ao->a + kk*bs2;
+
+        cols[n] = garray[ao->j[kk]];
+        if (bs == 1) vals[n] = blk[0];
+        else for (ll=0,vals[n]=0.0; ll<bs2; ll++) vals[n] += PetscAbs(PetscRealPart(blk[ll]));
+      }
+    }
+    ierr = MatSetValues(Gmat,1,&row,n,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(cols,vals);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(Gmat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(Gmat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  *a_Gmat = Gmat;
+  PetscFunctionReturn(0);
+}
+
 /* -------------------------------------------------------------------------- */
 /*
    PCGAMGCreateGraph - create simple scaled scalar graph from matrix
@@ -68,6 +144,7 @@ PetscErrorCode PCGAMGCreateGraph(Mat Amat, Mat *a_Gmat)
   PetscInt       Istart,Iend,Ii,jj,kk,ncols,nloc,NN,MM,bs;
   MPI_Comm       comm;
   Mat            Gmat;
+  PetscBool      isbaij;
 
   PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)Amat,&comm);CHKERRQ(ierr);
@@ -81,7 +158,10 @@ PetscErrorCode PCGAMGCreateGraph(Mat Amat, Mat *a_Gmat)
   /* TODO GPU: these calls are potentially expensive if matrices are large and we want to use the GPU */
   /* A solution consists in providing a new API, MatAIJGetCollapsedAIJ, and each class can provide a fast
      implementation */
-  if (bs > 1) {
+  ierr = PetscObjectBaseTypeCompareAny((PetscObject)Amat,&isbaij,MATSEQBAIJ,MATMPIBAIJ,"");CHKERRQ(ierr);
+  if (isbaij) {
+    ierr = PCGAMGCreateGraph_BAIJ(Amat,&Gmat);CHKERRQ(ierr);
+  } else if (bs > 1) {
     const PetscScalar *vals;
     const PetscInt    *idx;
     PetscInt          *d_nnz, *o_nnz,*w0,*w1,*w2;
@@ -140,7 +220,7 @@ PetscErrorCode PCGAMGCreateGraph(Mat Amat, Mat *a_Gmat)
         if (o_nnz[jj] > (NN/bs-nloc)) o_nnz[jj] = NN/bs-nloc;
       }
 
-    } else SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_USER,"Require AIJ matrix type");
+    } else SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_USER,"Require AIJ or BAIJ matrix type");
 
     /* get scalar copy (norms) of matrix */
     ierr = MatCreate(comm, &Gmat);CHKERRQ(ierr);
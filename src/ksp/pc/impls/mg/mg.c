@@ -241,6 +241,7 @@ PetscErrorCode PCReset_MG(PC pc)
       if (mglevels[i]->cr) {ierr = KSPReset(mglevels[i]->cr);CHKERRQ(ierr);}
     }
     mg->Nc = 0;
+    ierr = PCMGACycleResetConcurrent_Private(pc);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
@@ -725,6 +726,9 @@ PetscErrorCode PCSetFromOptions_MG(PetscOptionItems *PetscOptionsObject,PC pc)
       ierr = PCMGMultiplicativeSetCycles(pc,cycles);CHKERRQ(ierr);
     }
   }
+  if (mg->am == PC_MG_ADDITIVE) {
+    ierr = PetscOptionsBool("-pc_mg_additive_concurrent","Smooth the levels concurrently on disjoint groups of processes","PCMGAdditiveSetConcurrent",mg->additiveconcurrent,&mg->additiveconcurrent,NULL);CHKERRQ(ierr);
+  }
   flg  = PETSC_FALSE;
   ierr = PetscOptionsBool("-pc_mg_log","Log times for each multigrid level","None",flg,&flg,NULL);CHKERRQ(ierr);
   if (flg) {
@@ -796,6 +800,17 @@ PetscErrorCode PCView_MG(PC pc,PetscViewer viewer)
     if (mg->am == PC_MG_MULTIPLICATIVE) {
       ierr = PetscViewerASCIIPrintf(viewer,"    Cycles per PCApply=%d\n",mg->cyclesperpcapply);CHKERRQ(ierr);
     }
+    if (mg->am == PC_MG_ADDITIVE && mg->additiveconcurrent) {
+      if (mglevels[0]->cscatter) {
+        ierr = PetscViewerASCIIPrintf(viewer,"    Levels smoothed concurrently, processes smoothing each level (coarsest first):");CHKERRQ(ierr);
+        ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
+        for (i=0; i<levels; i++) {ierr = PetscViewerASCIIPrintf(viewer," %d",(int)mglevels[i]->cgroupsize);CHKERRQ(ierr);}
+        ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
+        ierr = PetscViewerASCIIUseTabs(viewer,PETSC_TRUE);CHKERRQ(ierr);
+      } else {
+        ierr = PetscViewerASCIIPrintf(viewer,"    Levels smoothed in sequence, the concurrent cycle is not available\n");CHKERRQ(ierr);
+      }
+    }
     if (mg->galerkin == PC_MG_GALERKIN_BOTH) {
       ierr = PetscViewerASCIIPrintf(viewer,"    Using Galerkin computed coarse grid matrices\n");CHKERRQ(ierr);
     } else if (mg->galerkin == PC_MG_GALERKIN_PMAT) {
@@ -881,7 +896,7 @@ PetscErrorCode PCSetUp_MG(PC pc)
   PetscErrorCode ierr;
   PetscInt       i,n;
   PC             cpc;
-  PetscBool      dump = PETSC_FALSE,opsset,use_amat,missinginterpolate = PETSC_FALSE;
+  PetscBool      dump = PETSC_FALSE,opsset,use_amat,missinginterpolate = PETSC_FALSE,concurrent;
   Mat            dA,dB;
   Vec            tvec;
   DM             *dms;
@@ -1190,18 +1205,28 @@ PetscErrorCode PCSetUp_MG(PC pc)
     }
   }
 
+  /* the concurrent additive cycle smooths with copies of the levels, the smoothers of the levels are then set up only if used */
+  if (mg->am == PC_MG_ADDITIVE && mg->additiveconcurrent) {
+    ierr = PCMGACycleSetUpConcurrent_Private(pc);CHKERRQ(ierr);
+  } else {
+    ierr = PCMGACycleResetConcurrent_Private(pc);CHKERRQ(ierr);
+  }
+  concurrent = mglevels[0]->cscatter ? PETSC_TRUE : PETSC_FALSE;
+
   for (i=1; i<n; i++) {
     if (mglevels[i]->smoothu == mglevels[i]->smoothd || mg->am == PC_MG_FULL || mg->am == PC_MG_KASKADE || mg->cyclesperpcapply > 1) {
       /* if doing only down then initial guess is zero */
       ierr = KSPSetInitialGuessNonzero(mglevels[i]->smoothd,PETSC_TRUE);CHKERRQ(ierr);
     }
     if (mglevels[i]->cr) {ierr = KSPSetInitialGuessNonzero(mglevels[i]->cr,PETSC_TRUE);CHKERRQ(ierr);}
-    if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
-    ierr = KSPSetUp(mglevels[i]->smoothd);CHKERRQ(ierr);
-    if (mglevels[i]->smoothd->reason == KSP_DIVERGED_PC_FAILED) {
-      pc->failedreason = PC_SUBPC_ERROR;
+    if (!concurrent) {
+      if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
+      ierr = KSPSetUp(mglevels[i]->smoothd);CHKERRQ(ierr);
+      if (mglevels[i]->smoothd->reason == KSP_DIVERGED_PC_FAILED) {
+        pc->failedreason = PC_SUBPC_ERROR;
+      }
+      if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventEnd(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
     }
-    if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventEnd(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
     if (!mglevels[i]->residual) {
       Mat mat;
       ierr = KSPGetOperators(mglevels[i]->smoothd,&mat,NULL);CHKERRQ(ierr);
@@ -1225,12 +1250,14 @@ PetscErrorCode PCSetUp_MG(PC pc)
       }
 
       ierr = KSPSetInitialGuessNonzero(mglevels[i]->smoothu,PETSC_TRUE);CHKERRQ(ierr);
-      if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
-      ierr = KSPSetUp(mglevels[i]->smoothu);CHKERRQ(ierr);
-      if (mglevels[i]->smoothu->reason == KSP_DIVERGED_PC_FAILED) {
-        pc->failedreason = PC_SUBPC_ERROR;
+      if (!concurrent) {
+        if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
+        ierr = KSPSetUp(mglevels[i]->smoothu);CHKERRQ(ierr);
+        if (mglevels[i]->smoothu->reason == KSP_DIVERGED_PC_FAILED) {
+          pc->failedreason = PC_SUBPC_ERROR;
+        }
+        if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventEnd(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
       }
-      if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventEnd(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
     }
     if (mglevels[i]->cr) {
       Mat downmat,downpmat;
@@ -1252,12 +1279,14 @@ PetscErrorCode PCSetUp_MG(PC pc)
     }
   }
 
-  if (mglevels[0]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[0]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
-  ierr = KSPSetUp(mglevels[0]->smoothd);CHKERRQ(ierr);
-  if (mglevels[0]->smoothd->reason == KSP_DIVERGED_PC_FAILED) {
-    pc->failedreason = PC_SUBPC_ERROR;
+  if (!concurrent) {
+    if (mglevels[0]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[0]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
+    ierr = KSPSetUp(mglevels[0]->smoothd);CHKERRQ(ierr);
+    if (mglevels[0]->smoothd->reason == KSP_DIVERGED_PC_FAILED) {
+      pc->failedreason = PC_SUBPC_ERROR;
+    }
+    if (mglevels[0]->eventsmoothsetup) {ierr = PetscLogEventEnd(mglevels[0]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
   }
-  if (mglevels[0]->eventsmoothsetup) {ierr = PetscLogEventEnd(mglevels[0]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
 
   /*
      Dump the interpolation/restriction matrices plus the
@@ -1445,6 +1474,75 @@ PetscErrorCode  PCMGMultiplicativeSetCycles(PC pc,PetscInt n)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCMGAdditiveSetConcurrent - Smooths the levels of the additive multigrid cycle concurrently,
+   each level, or group of coarsest levels, on its own disjoint group of processes
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the multigrid context
+-  flg - PETSC_TRUE to smooth the levels concurrently (default is PETSC_FALSE)
+
+   Options Database Key:
+.  -pc_mg_additive_concurrent <bool>
+
+   Level: advanced
+
+   Notes:
+    This is used with the PCMGType of PC_MG_ADDITIVE. The residual is restricted to all the levels, then the right hand
+    side of each level is moved to its group of processes, all the groups smooth their levels at the same time with a copy
+    of the level operator and smoother, and the corrections are moved back and interpolated. The latency of the coarse levels
+    is thus hidden behind the work on the finer levels, at the cost of moving the vectors of each level to fewer processes.
+
+    The processes are divided among the levels in proportion to the number of nonzeros of their operators. When there are
+    fewer processes than levels the coarsest levels share the last group. The smoother of each level is a copy, with the same
+    options prefix, of the KSP type, PC type, tolerances, KSPCHEBYSHEV eigenvalues and PCJACOBI or PCSOR parameters of
+    PCMGGetSmoother(); other settings made in code are not copied. The coarsest level is solved with PCREDUNDANT, or PCLU on
+    one process, unless set with the -mg_coarse_ options. The smoothers of PCMGGetSmoother() are then not set up. Processor
+    local smoothers such as PCSOR differ from those of the sequential cycle since the groups have fewer processes.
+
+    The cycle runs in sequence on one process, with PCMatApply(), or when the level operators cannot give their submatrices.
+
+.seealso: PCMGSetType(), PCMGAdditiveGetConcurrent(), PCTELESCOPE
+@*/
+PetscErrorCode PCMGAdditiveSetConcurrent(PC pc,PetscBool flg)
+{
+  PC_MG *mg = (PC_MG*)pc->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveBool(pc,flg,2);
+  mg->additiveconcurrent = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PCMGAdditiveGetConcurrent - Returns whether the levels of the additive multigrid cycle are smoothed concurrently
+
+   Not Collective
+
+   Input Parameter:
+.  pc - the multigrid context
+
+   Output Parameter:
+.  flg - PETSC_TRUE if the levels are smoothed concurrently
+
+   Level: advanced
+
+.seealso: PCMGAdditiveSetConcurrent()
+@*/
+PetscErrorCode PCMGAdditiveGetConcurrent(PC pc,PetscBool *flg)
+{
+  PC_MG *mg = (PC_MG*)pc->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidBoolPointer(flg,2);
+  *flg = mg->additiveconcurrent;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode PCMGSetGalerkin_MG(PC pc,PCMGGalerkinType use)
 {
   PC_MG *mg = (PC_MG*)pc->data;
@@ -1872,6 +1970,7 @@ PetscErrorCode PCMGGetCoarseSpaceConstructor(const char name[], PetscErrorCode (
 .  -pc_mg_distinct_smoothup - configure up (after interpolation) and down (before restriction) smoothers separately (with different options prefixes)
 .  -pc_mg_galerkin <both,pmat,mat,none> - use Galerkin process to compute coarser operators, i.e. Acoarse = R A R'
 .  -pc_mg_multiplicative_cycles - number of cycles to use as the preconditioner (defaults to 1)
+.  -pc_mg_additive_concurrent - smooth the levels of the additive cycle concurrently on disjoint groups of processes, see PCMGAdditiveSetConcurrent()
 .  -pc_mg_dump_matlab - dumps the matrices for each level and the restriction/interpolation matrices
                         to the Socket viewer for reading from MATLAB.
 -  -pc_mg_dump_binary - dumps the matrices for each level and the restriction/interpolation matrices
@@ -1887,13 +1986,17 @@ PetscErrorCode PCMGGetCoarseSpaceConstructor(const char name[], PetscErrorCode (
        (because the residual has just been computed for the multigrid algorithm and is hence available for free) while with monitoring the
        residual is computed at the end of each cycle.
 
+       The default coarse grid solver is a direct LU factorization, redundant on each process for a parallel coarse grid. When the
+       coarse operator is nearly dense, -mg_coarse_pc_factor_mat_solver_type blr (-mg_coarse_redundant_pc_factor_mat_solver_type blr in
+       parallel) uses the block low-rank factorization MATSOLVERBLR, whose accuracy and memory are controlled with -mat_blr_tol
+
    Level: intermediate
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC, PCMGType, PCEXOTIC, PCGAMG, PCML, PCHYPRE
            PCMGSetLevels(), PCMGGetLevels(), PCMGSetType(), PCMGSetCycleType(),
            PCMGSetDistinctSmoothUp(), PCMGGetCoarseSolve(), PCMGSetResidual(), PCMGSetInterpolation(),
            PCMGSetRestriction(), PCMGGetSmoother(), PCMGGetSmootherUp(), PCMGGetSmootherDown(),
-           PCMGSetCycleTypeOnLevel(), PCMGSetRhs(), PCMGSetX(), PCMGSetR()
+           PCMGSetCycleTypeOnLevel(), PCMGSetRhs(), PCMGSetX(), PCMGSetR(), PCMGAdditiveSetConcurrent()
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_MG(PC pc)
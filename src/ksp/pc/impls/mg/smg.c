@@ -1,8 +1,336 @@
 
 /*
-     Additive Multigrid V Cycle routine
+     Additive Multigrid V Cycle routine, with the levels smoothed in sequence or concurrently
 */
 #include <petsc/private/pcmgimpl.h>
+#include <petsc/private/kspimpl.h>
+
+/*
+   Divides the processes among the groups in proportion to the work of each group, with at least one process per group
+*/
+static PetscErrorCode PCMGACycleGroupSizes_Private(PetscMPIInt size,PetscInt ngroups,const PetscReal work[],PetscMPIInt nranks[])
+{
+  PetscInt    g,gmax;
+  PetscMPIInt nsum = 0;
+  PetscReal   wtotal = 0.0;
+
+  PetscFunctionBegin;
+  for (g=0; g<ngroups; g++) wtotal += work[g];
+  for (g=0; g<ngroups; g++) {
+    nranks[g] = PetscMax(1,(PetscMPIInt)PetscFloorReal(size*work[g]/wtotal));
+    nsum     += nranks[g];
+  }
+  while (nsum > size) {
+    for (gmax=0,g=1; g<ngroups; g++) if (nranks[g] > nranks[gmax]) gmax = g;
+    nranks[gmax]--;
+    nsum--;
+  }
+  while (nsum < size) {
+    for (gmax=0,g=1; g<ngroups; g++) if (work[g]*nranks[gmax] > work[gmax]*nranks[g]) gmax = g;
+    nranks[gmax]++;
+    nsum++;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Gives the smoother of a group the state of the smoother of the level that may have been set in code rather than with options:
+   the KSP and PC types, the tolerances and norm type, and the parameters of PCJACOBI and PCSOR. The Chebyshev eigenvalues, which
+   PCGAMG sets at every setup, are copied by PCMGACycleSetUpConcurrent_Private().
+*/
+static PetscErrorCode PCMGACycleCopySmoother_Private(KSP ksp,KSP csmooth)
+{
+  KSPType        ktype;
+  PCType         ptype;
+  KSPNormType    normtype;
+  PC             ipc,cpc;
+  PetscReal      rtol,abstol,dtol,omega;
+  PetscInt       maxits,its,lits;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPGetType(ksp,&ktype);CHKERRQ(ierr);
+  ierr = KSPSetType(csmooth,ktype);CHKERRQ(ierr);
+  ierr = KSPGetTolerances(ksp,&rtol,&abstol,&dtol,&maxits);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(csmooth,rtol,abstol,dtol,maxits);CHKERRQ(ierr);
+  ierr = KSPGetNormType(ksp,&normtype);CHKERRQ(ierr);
+  ierr = KSPSetNormType(csmooth,normtype);CHKERRQ(ierr);
+  if (normtype == KSP_NORM_NONE) {ierr = KSPSetConvergenceTest(csmooth,KSPConvergedSkip,NULL,NULL);CHKERRQ(ierr);}
+
+  ierr = KSPGetPC(ksp,&ipc);CHKERRQ(ierr);
+  ierr = KSPGetPC(csmooth,&cpc);CHKERRQ(ierr);
+  ierr = PCGetType(ipc,&ptype);CHKERRQ(ierr);
+  ierr = PCSetType(cpc,ptype);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ipc,PCJACOBI,&flg);CHKERRQ(ierr);
+  if (flg) {
+    PCJacobiType jtype;
+
+    ierr = PCJacobiGetType(ipc,&jtype);CHKERRQ(ierr);
+    ierr = PCJacobiSetType(cpc,jtype);CHKERRQ(ierr);
+    ierr = PCJacobiGetUseAbs(ipc,&flg);CHKERRQ(ierr);
+    ierr = PCJacobiSetUseAbs(cpc,flg);CHKERRQ(ierr);
+    ierr = PCJacobiGetFixDiagonal(ipc,&flg);CHKERRQ(ierr);
+    ierr = PCJacobiSetFixDiagonal(cpc,flg);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)ipc,PCSOR,&flg);CHKERRQ(ierr);
+  if (flg) {
+    MatSORType stype;
+
+    ierr = PCSORGetSymmetric(ipc,&stype);CHKERRQ(ierr);
+    ierr = PCSORSetSymmetric(cpc,stype);CHKERRQ(ierr);
+    ierr = PCSORGetOmega(ipc,&omega);CHKERRQ(ierr);
+    ierr = PCSORSetOmega(cpc,omega);CHKERRQ(ierr);
+    ierr = PCSORGetIterations(ipc,&its,&lits);CHKERRQ(ierr);
+    ierr = PCSORSetIterations(cpc,its,lits);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Sets up the copies of the levels on the groups of processes of the concurrent additive cycle. Level i is smoothed by
+   group levels-1-i, so the finest level gets the first processes, and the coarsest levels share the last group when there
+   are fewer processes than levels. Without a second group, or when a level cannot be moved, the cycle runs in sequence.
+   Otherwise PCSetUp_MG() does not set up the smoothers of the levels themselves, they are only used by PCMatApply().
+*/
+PetscErrorCode PCMGACycleSetUpConcurrent_Private(PC pc)
+{
+  PC_MG          *mg = (PC_MG*)pc->data;
+  PC_MG_Levels   **mglevels = mg->levels;
+  PetscInt       i,l = mglevels[0]->levels,ngroups,M,N,Mc,bs,st,ed;
+  PetscMPIInt    size,rank,first,color,*nranks,result;
+  PetscReal      *work;
+  MPI_Comm       comm,subcomm;
+  MatReuse       reuse;
+  PetscBool      valid = PETSC_TRUE,has;
+  MatInfo        info;
+  Mat            A,Blocal,*_Blocal;
+  IS             iscol;
+  Vec            x;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)pc,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRMPI(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRMPI(ierr);
+  ngroups = PetscMin(l,size);
+
+  /* keep the groups and the copies of the level operators when only their values changed */
+  reuse = MAT_REUSE_MATRIX;
+  if (!mglevels[0]->cscatter || pc->flag == DIFFERENT_NONZERO_PATTERN) reuse = MAT_INITIAL_MATRIX;
+  for (i=0; i<l && reuse == MAT_REUSE_MATRIX; i++) {
+    ierr = KSPGetOperators(mglevels[i]->smoothd,NULL,&A);CHKERRQ(ierr);
+    ierr = MatGetSize(A,&M,NULL);CHKERRQ(ierr);
+    ierr = VecGetSize(mglevels[i]->ctmp,&Mc);CHKERRQ(ierr);
+    if (M != Mc) reuse = MAT_INITIAL_MATRIX;
+  }
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = PCMGACycleResetConcurrent_Private(pc);CHKERRQ(ierr);
+    if (ngroups < 2) {
+      ierr = PetscInfo(pc,"Concurrent additive cycle needs at least two processes and two levels, smoothing in sequence\n");CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    for (i=0; i<l; i++) {
+      if (!mglevels[i]->smoothd) {valid = PETSC_FALSE; break;}
+      ierr = MPI_Comm_compare(comm,PetscObjectComm((PetscObject)mglevels[i]->smoothd),&result);CHKERRMPI(ierr);
+      if (result != MPI_IDENT && result != MPI_CONGRUENT) {valid = PETSC_FALSE; break;}
+      ierr = KSPGetOperators(mglevels[i]->smoothd,NULL,&A);CHKERRQ(ierr);
+      ierr = MatHasOperation(A,MATOP_CREATE_SUBMATRICES,&has);CHKERRQ(ierr);
+      if (!has) {valid = PETSC_FALSE; break;}
+    }
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&valid,1,MPIU_BOOL,MPI_LAND,comm);CHKERRMPI(ierr);
+    if (!valid) {
+      ierr = PetscInfo(pc,"Concurrent additive cycle needs all the level operators on the communicator of the PC with MatCreateSubMatrices(), smoothing in sequence\n");CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+
+    ierr = PetscCalloc2(ngroups,&work,ngroups,&nranks);CHKERRQ(ierr);
+    for (i=0; i<l; i++) {
+      ierr = KSPGetOperators(mglevels[i]->smoothd,NULL,&A);CHKERRQ(ierr);
+      ierr = MatGetSize(A,&M,NULL);CHKERRQ(ierr);
+      ierr = MatGetInfo(A,MAT_GLOBAL_SUM,&info);CHKERRQ(ierr);
+      work[PetscMin(l-1-i,ngroups-1)] += PetscMax((PetscReal)info.nz_used,(PetscReal)M);
+    }
+    ierr = PCMGACycleGroupSizes_Private(size,ngroups,work,nranks);CHKERRQ(ierr);
+    for (color=0,first=0; rank >= first+nranks[color]; color++) first += nranks[color];
+    ierr = PetscSubcommCreate(comm,&mg->cpsubcomm);CHKERRQ(ierr);
+    ierr = PetscSubcommSetNumber(mg->cpsubcomm,ngroups);CHKERRQ(ierr);
+    ierr = PetscSubcommSetTypeGeneral(mg->cpsubcomm,color,rank-first);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)pc,sizeof(PetscSubcomm));CHKERRQ(ierr);
+    for (i=0; i<l; i++) mglevels[i]->cgroupsize = nranks[PetscMin(l-1-i,ngroups-1)];
+    ierr = PetscInfo3(pc,"Concurrent additive cycle on %D groups of processes, the finest level on %d and the coarsest on %d processes\n",ngroups,(int)nranks[0],(int)nranks[ngroups-1]);CHKERRQ(ierr);
+    ierr = PetscFree2(work,nranks);CHKERRQ(ierr);
+  }
+  subcomm = PetscSubcommChild(mg->cpsubcomm);
+  color   = mg->cpsubcomm->color;
+
+  for (i=0; i<l; i++) {
+    PetscBool member = (PetscBool)(color == PetscMin(l-1-i,ngroups-1));
+
+    ierr = KSPGetOperators(mglevels[i]->smoothd,NULL,&A);CHKERRQ(ierr);
+    ierr = MatGetSize(A,&M,&N);CHKERRQ(ierr);
+    ierr = MatGetBlockSize(A,&bs);CHKERRQ(ierr);
+    if (reuse == MAT_INITIAL_MATRIX) {
+      PetscInt m = 0;
+
+      /* the level vectors on the group, and the same arrays seen from the communicator of the PC */
+      if (member) {
+        ierr = VecCreate(subcomm,&mglevels[i]->cxred);CHKERRQ(ierr);
+        ierr = VecSetSizes(mglevels[i]->cxred,PETSC_DECIDE,M);CHKERRQ(ierr);
+        ierr = VecSetBlockSize(mglevels[i]->cxred,bs);CHKERRQ(ierr);
+        ierr = VecSetType(mglevels[i]->cxred,VECSTANDARD);CHKERRQ(ierr);
+        ierr = VecDuplicate(mglevels[i]->cxred,&mglevels[i]->cyred);CHKERRQ(ierr);
+        ierr = VecGetLocalSize(mglevels[i]->cxred,&m);CHKERRQ(ierr);
+        ierr = VecGetOwnershipRange(mglevels[i]->cxred,&st,&ed);CHKERRQ(ierr);
+        ierr = ISCreateStride(comm,ed-st,st,1,&mglevels[i]->cis);CHKERRQ(ierr);
+      } else {
+        ierr = ISCreateStride(comm,0,0,1,&mglevels[i]->cis);CHKERRQ(ierr);
+      }
+      ierr = ISSetBlockSize(mglevels[i]->cis,bs);CHKERRQ(ierr);
+      ierr = VecCreateMPIWithArray(comm,bs,m,M,NULL,&mglevels[i]->ctmp);CHKERRQ(ierr);
+      ierr = MatCreateVecs(A,&x,NULL);CHKERRQ(ierr);
+      ierr = VecScatterCreate(x,mglevels[i]->cis,mglevels[i]->ctmp,NULL,&mglevels[i]->cscatter);CHKERRQ(ierr);
+      ierr = VecDestroy(&x);CHKERRQ(ierr);
+    }
+
+    /* the rows of the level owned by each process of the group */
+    ierr = ISCreateStride(PETSC_COMM_SELF,N,0,1,&iscol);CHKERRQ(ierr);
+    ierr = ISSetIdentity(iscol);CHKERRQ(ierr);
+    ierr = ISSetBlockSize(iscol,bs);CHKERRQ(ierr);
+    ierr = MatSetOption(A,MAT_SUBMAT_SINGLEIS,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = MatCreateSubMatrices(A,1,&mglevels[i]->cis,&iscol,MAT_INITIAL_MATRIX,&_Blocal);CHKERRQ(ierr);
+    Blocal = *_Blocal;
+    ierr = PetscFree(_Blocal);CHKERRQ(ierr);
+    ierr = ISDestroy(&iscol);CHKERRQ(ierr);
+    if (member) {
+      PetscInt m;
+
+      ierr = VecGetLocalSize(mglevels[i]->cxred,&m);CHKERRQ(ierr);
+      ierr = MatCreateMPIMatConcatenateSeqMat(subcomm,Blocal,m,reuse,&mglevels[i]->cA);CHKERRQ(ierr);
+      ierr = MatPropagateSymmetryOptions(A,mglevels[i]->cA);CHKERRQ(ierr);
+    }
+    ierr = MatDestroy(&Blocal);CHKERRQ(ierr);
+    if (!member) continue;
+
+    if (!mglevels[i]->csmooth) {
+      const char *prefix;
+      KSP        ksp = mglevels[i]->smoothd;
+      PC         cpc;
+
+      ierr = KSPCreate(subcomm,&mglevels[i]->csmooth);CHKERRQ(ierr);
+      ierr = KSPSetErrorIfNotConverged(mglevels[i]->csmooth,pc->erroriffailure);CHKERRQ(ierr);
+      ierr = PetscObjectIncrementTabLevel((PetscObject)mglevels[i]->csmooth,(PetscObject)pc,l-i);CHKERRQ(ierr);
+      ierr = KSPGetOptionsPrefix(ksp,&prefix);CHKERRQ(ierr);
+      ierr = KSPSetOptionsPrefix(mglevels[i]->csmooth,prefix);CHKERRQ(ierr);
+      ierr = KSPGetPC(mglevels[i]->csmooth,&cpc);CHKERRQ(ierr);
+      if (i) {
+        ierr = PCMGACycleCopySmoother_Private(ksp,mglevels[i]->csmooth);CHKERRQ(ierr);
+      } else {
+        ierr = KSPSetType(mglevels[i]->csmooth,KSPPREONLY);CHKERRQ(ierr);
+        ierr = PCSetType(cpc,mglevels[i]->cgroupsize > 1 ? PCREDUNDANT : PCLU);CHKERRQ(ierr);
+        ierr = PCFactorSetShiftType(cpc,MAT_SHIFT_INBLOCKS);CHKERRQ(ierr);
+      }
+      ierr = KSPSetFromOptions(mglevels[i]->csmooth);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)pc,(PetscObject)mglevels[i]->csmooth);CHKERRQ(ierr);
+    }
+    if (i) {
+      PetscReal emax,emin;
+
+      /* eigenvalues given to the smoother of the level, e.g., by PCGAMG from its smoothed aggregation estimates */
+      ierr = KSPChebyshevGetEigenvalues(mglevels[i]->smoothd,&emax,&emin);CHKERRQ(ierr);
+      if (emax != 0.0 && emin != 0.0) {ierr = KSPChebyshevSetEigenvalues(mglevels[i]->csmooth,emax,emin);CHKERRQ(ierr);}
+    }
+    ierr = KSPSetOperators(mglevels[i]->csmooth,mglevels[i]->cA,mglevels[i]->cA);CHKERRQ(ierr);
+    ierr = KSPSetUp(mglevels[i]->csmooth);CHKERRQ(ierr);
+    if (mglevels[i]->csmooth->reason == KSP_DIVERGED_PC_FAILED) pc->failedreason = PC_SUBPC_ERROR;
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PCMGACycleResetConcurrent_Private(PC pc)
+{
+  PC_MG          *mg = (PC_MG*)pc->data;
+  PC_MG_Levels   **mglevels = mg->levels;
+  PetscInt       i,l;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!mglevels) PetscFunctionReturn(0);
+  l = mglevels[0]->levels;
+  for (i=0; i<l; i++) {
+    ierr = ISDestroy(&mglevels[i]->cis);CHKERRQ(ierr);
+    ierr = VecScatterDestroy(&mglevels[i]->cscatter);CHKERRQ(ierr);
+    ierr = VecDestroy(&mglevels[i]->ctmp);CHKERRQ(ierr);
+    ierr = VecDestroy(&mglevels[i]->cxred);CHKERRQ(ierr);
+    ierr = VecDestroy(&mglevels[i]->cyred);CHKERRQ(ierr);
+    ierr = MatDestroy(&mglevels[i]->cA);CHKERRQ(ierr);
+    ierr = KSPDestroy(&mglevels[i]->csmooth);CHKERRQ(ierr);
+    mglevels[i]->cgroupsize = 0;
+  }
+  ierr = PetscSubcommDestroy(&mg->cpsubcomm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Moves the right hand sides of all the levels to their groups of processes at once, smooths the levels of the group
+   of this process, and moves the corrections back. All the groups smooth at the same time.
+*/
+static PetscErrorCode PCMGACycleConcurrentSolve_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transpose)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,l = mglevels[0]->levels;
+  PetscScalar    *array;
+
+  PetscFunctionBegin;
+  for (i=0; i<l; i++) {
+    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    if (mglevels[i]->cxred) {
+      ierr = VecGetArray(mglevels[i]->cxred,&array);CHKERRQ(ierr);
+      ierr = VecPlaceArray(mglevels[i]->ctmp,array);CHKERRQ(ierr);
+    }
+    ierr = VecScatterBegin(mglevels[i]->cscatter,mglevels[i]->b,mglevels[i]->ctmp,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+  }
+  for (i=0; i<l; i++) {
+    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    ierr = VecScatterEnd(mglevels[i]->cscatter,mglevels[i]->b,mglevels[i]->ctmp,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    if (mglevels[i]->cxred) {
+      ierr = VecResetArray(mglevels[i]->ctmp);CHKERRQ(ierr);
+      ierr = VecRestoreArray(mglevels[i]->cxred,NULL);CHKERRQ(ierr);
+    }
+    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+  }
+  for (i=0; i<l; i++) {
+    if (!mglevels[i]->csmooth) continue;
+    if (mglevels[i]->eventsmoothsolve) {ierr = PetscLogEventBegin(mglevels[i]->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+    if (!transpose) {
+      ierr = KSPSolve(mglevels[i]->csmooth,mglevels[i]->cxred,mglevels[i]->cyred);CHKERRQ(ierr);
+    } else {
+      ierr = KSPSolveTranspose(mglevels[i]->csmooth,mglevels[i]->cxred,mglevels[i]->cyred);CHKERRQ(ierr);
+    }
+    ierr = KSPCheckSolve(mglevels[i]->csmooth,pc,mglevels[i]->cyred);CHKERRQ(ierr);
+    if (mglevels[i]->eventsmoothsolve) {ierr = PetscLogEventEnd(mglevels[i]->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+  }
+  for (i=0; i<l; i++) {
+    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    if (mglevels[i]->cyred) {
+      ierr = VecGetArray(mglevels[i]->cyred,&array);CHKERRQ(ierr);
+      ierr = VecPlaceArray(mglevels[i]->ctmp,array);CHKERRQ(ierr);
+    }
+    ierr = VecScatterBegin(mglevels[i]->cscatter,mglevels[i]->ctmp,mglevels[i]->x,INSERT_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+  }
+  for (i=0; i<l; i++) {
+    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    ierr = VecScatterEnd(mglevels[i]->cscatter,mglevels[i]->ctmp,mglevels[i]->x,INSERT_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+    if (mglevels[i]->cyred) {
+      ierr = VecResetArray(mglevels[i]->ctmp);CHKERRQ(ierr);
+      ierr = VecRestoreArray(mglevels[i]->cyred,NULL);CHKERRQ(ierr);
+    }
+    if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
 
 PetscErrorCode PCMGACycle_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transpose,PetscBool matapp)
 {
@@ -23,7 +351,9 @@ PetscErrorCode PCMGACycle_Private(PC pc,PC_MG_Levels **mglevels,PetscBool transp
     if (mglevels[i]->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels[i]->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
   }
   /* solve separately on each level */
-  for (i=0; i<l; i++) {
+  if (!matapp && mglevels[0]->cscatter) {
+    ierr = PCMGACycleConcurrentSolve_Private(pc,mglevels,transpose);CHKERRQ(ierr);
+  } else for (i=0; i<l; i++) {
     if (matapp) {
       if (!mglevels[i]->X) {
         ierr = MatDuplicate(mglevels[i]->B,MAT_DO_NOT_COPY_VALUES,&mglevels[i]->X);CHKERRQ(ierr);
@@ -2,24 +2,321 @@
    Defines a  (S)SOR  preconditioner for any Mat implementation
 */
 #include <petsc/private/pcimpl.h>               /*I "petscpc.h" I*/
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+/* the MatSORType that are not sweeps are left to MatSOR() */
+#define PCSORMulticolorSupported(flag) (!((flag) & (SOR_EISENSTAT | SOR_APPLY_UPPER | SOR_APPLY_LOWER)))
+
+/*
+   Multicolor (S)SOR for AIJ matrices. The local rows are numbered color by color and copied, without their diagonal, into
+   a CSR whose columns are the new numbers of the local rows followed by the ghost values, so the rows of one color, which
+   are not coupled to each other, are stored contiguously and relaxed concurrently
+*/
+typedef struct {
+  PetscObjectId    id;
+  PetscObjectState nonzerostate;
+  PetscInt         n,nghost,ncolors;  /* local rows, ghost values and number of colors over all the processes */
+  PetscInt         *cptr;             /* the rows of color c are cptr[c] <= k < cptr[c+1] */
+  PetscInt         *perm,*iperm;      /* local row of the k-th row, and its inverse */
+  PetscInt         *ai,*aj;
+  MatScalar        *aa,*diag;
+  PetscScalar      *x,*b;             /* iterate followed by the ghost values, and right hand side, in the new numbering */
+} PC_SOR_Multicolor;
 
 typedef struct {
-  PetscInt   its;         /* inner iterations, number of sweeps */
-  PetscInt   lits;        /* local inner iterations, number of sweeps applied by the local matrix mat->A */
-  MatSORType sym;         /* forward, reverse, symmetric etc. */
-  PetscReal  omega;
-  PetscReal  fshift;
+  PetscInt          its;         /* inner iterations, number of sweeps */
+  PetscInt          lits;        /* local inner iterations, number of sweeps applied by the local matrix mat->A */
+  MatSORType        sym;         /* forward, reverse, symmetric etc. */
+  PetscReal         omega;
+  PetscReal         fshift;
+  PetscBool         multicolor;  /* use multicolor Gauss-Seidel for AIJ matrices */
+  PetscBool         usemc;       /* the multicolor data is set up for pc->pmat */
+  PC_SOR_Multicolor *mc;
 } PC_SOR;
 
+static PetscErrorCode PCSORMulticolorReset_Private(PC_SOR_Multicolor *mc)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(mc->cptr);CHKERRQ(ierr);
+  ierr = PetscFree2(mc->perm,mc->iperm);CHKERRQ(ierr);
+  ierr = PetscFree4(mc->ai,mc->aj,mc->aa,mc->diag);CHKERRQ(ierr);
+  ierr = PetscFree2(mc->x,mc->b);CHKERRQ(ierr);
+  mc->id           = 0;
+  mc->nonzerostate = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PCReset_SOR(PC pc)
+{
+  PC_SOR         *jac = (PC_SOR*)pc->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (jac->mc) {ierr = PCSORMulticolorReset_Private(jac->mc);CHKERRQ(ierr);}
+  ierr = PetscFree(jac->mc);CHKERRQ(ierr);
+  jac->usemc = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PCDestroy_SOR(PC pc)
 {
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = PCReset_SOR(pc);CHKERRQ(ierr);
   ierr = PetscFree(pc->data);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+/*
+   Colors the graph of the matrix, symmetrized if the matrix is not known to be (structurally) symmetric, with a distance one
+   MatColoring and numbers the local rows by color, keeping their order within a color
+*/
+static PetscErrorCode PCSORMulticolorColor_Private(PC pc,Mat A,PC_SOR_Multicolor *mc)
+{
+  PetscErrorCode        ierr;
+  Mat                   G;
+  MatColoring           coloring;
+  ISColoring            iscoloring;
+  const ISColoringValue *colors;
+  PetscBool             set,sym;
+  PetscInt              i,c,n,ncolors;
+
+  PetscFunctionBegin;
+  ierr = MatIsSymmetricKnown(A,&set,&sym);CHKERRQ(ierr);
+  if ((set && sym) || (A->structurally_symmetric_set && A->structurally_symmetric)) {
+    ierr = PetscObjectReference((PetscObject)A);CHKERRQ(ierr);
+    G    = A;
+  } else {
+    ierr = MatTranspose(A,MAT_INITIAL_MATRIX,&G);CHKERRQ(ierr);
+    ierr = MatAXPY(G,1.0,A,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  }
+  ierr = MatColoringCreate(G,&coloring);CHKERRQ(ierr);
+  ierr = MatColoringSetDistance(coloring,1);CHKERRQ(ierr);
+  ierr = MatColoringSetType(coloring,MATCOLORINGJP);CHKERRQ(ierr);
+  ierr = PetscObjectSetOptionsPrefix((PetscObject)coloring,((PetscObject)pc)->prefix);CHKERRQ(ierr);
+  ierr = PetscObjectAppendOptionsPrefix((PetscObject)coloring,"pc_sor_");CHKERRQ(ierr);
+  ierr = MatColoringSetFromOptions(coloring);CHKERRQ(ierr);
+  ierr = MatColoringApply(coloring,&iscoloring);CHKERRQ(ierr);
+  ierr = MatColoringDestroy(&coloring);CHKERRQ(ierr);
+  ierr = MatDestroy(&G);CHKERRQ(ierr);
+
+  ierr = ISColoringGetColors(iscoloring,&n,&ncolors,&colors);CHKERRQ(ierr);
+  mc->ncolors = ncolors;
+  ierr = PetscCalloc1(ncolors+1,&mc->cptr);CHKERRQ(ierr);
+  ierr = PetscMalloc2(n,&mc->perm,n,&mc->iperm);CHKERRQ(ierr);
+  for (i=0; i<n; i++) mc->cptr[colors[i]+1]++;
+  for (c=0; c<ncolors; c++) mc->cptr[c+1] += mc->cptr[c];
+  for (i=0; i<n; i++) {
+    mc->iperm[i]            = mc->cptr[colors[i]]++;
+    mc->perm[mc->iperm[i]] = i;
+  }
+  for (c=ncolors; c>0; c--) mc->cptr[c] = mc->cptr[c-1];
+  mc->cptr[0] = 0;
+  ierr = ISColoringDestroy(&iscoloring);CHKERRQ(ierr);
+  ierr = PetscInfo2(pc,"Multicolor SOR with %D colors for %D local rows\n",ncolors,n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Sets up the multicolor data for MATSEQAIJ and MATMPIAIJ matrices, the coloring is kept while the nonzero pattern does
+   not change, the values are copied at every setup
+*/
+static PetscErrorCode PCSORMulticolorSetUp_Private(PC pc)
+{
+  PC_SOR            *jac = (PC_SOR*)pc->data;
+  PC_SOR_Multicolor *mc;
+  PetscErrorCode    ierr;
+  Mat               A = pc->pmat,Ad,Ao = NULL;
+  Mat_SeqAIJ        *ad,*ao = NULL;
+  const MatScalar   *aa,*aoa = NULL;
+  PetscBool         isaij,isaijo = PETSC_TRUE;
+  PetscObjectId     id;
+  PetscObjectState  nonzerostate;
+  PetscInt          k,r,j,nz;
+
+  PetscFunctionBegin;
+  jac->usemc = PETSC_FALSE;
+  if (!jac->multicolor) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATMPIAIJ,&isaij);CHKERRQ(ierr);
+  if (isaij) {
+    Mat_MPIAIJ *aij = (Mat_MPIAIJ*)A->data;
+
+    Ad   = aij->A;
+    Ao   = aij->B;
+    ierr = PetscObjectTypeCompare((PetscObject)Ad,MATSEQAIJ,&isaij);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)Ao,MATSEQAIJ,&isaijo);CHKERRQ(ierr);
+  } else {
+    Ad   = A;
+    ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&isaij);CHKERRQ(ierr);
+  }
+  if (!isaij || !isaijo) {
+    ierr = PetscInfo1(pc,"Multicolor SOR is only implemented for MATSEQAIJ and MATMPIAIJ, using MatSOR() for %s\n",((PetscObject)A)->type_name);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!jac->mc) {ierr = PetscNewLog(pc,&jac->mc);CHKERRQ(ierr);}
+  mc   = jac->mc;
+  ierr = PetscObjectGetId((PetscObject)A,&id);CHKERRQ(ierr);
+  ierr = MatGetNonzeroState(A,&nonzerostate);CHKERRQ(ierr);
+  ad   = (Mat_SeqAIJ*)Ad->data;
+  if (Ao) ao = (Mat_SeqAIJ*)Ao->data;
+  if (id != mc->id || nonzerostate != mc->nonzerostate) {
+    ierr = PCSORMulticolorReset_Private(mc);CHKERRQ(ierr);
+    ierr = PCSORMulticolorColor_Private(pc,A,mc);CHKERRQ(ierr);
+    mc->n      = Ad->rmap->n;
+    mc->nghost = Ao ? Ao->cmap->n : 0;
+    nz         = ad->nz + (ao ? ao->nz : 0);
+    ierr = PetscMalloc4(mc->n+1,&mc->ai,nz,&mc->aj,nz,&mc->aa,mc->n,&mc->diag);CHKERRQ(ierr);
+    ierr = PetscMalloc2(mc->n+mc->nghost,&mc->x,mc->n,&mc->b);CHKERRQ(ierr);
+    mc->id           = id;
+    mc->nonzerostate = nonzerostate;
+  }
+  ierr = MatSeqAIJGetArrayRead(Ad,&aa);CHKERRQ(ierr);
+  if (Ao) {ierr = MatSeqAIJGetArrayRead(Ao,&aoa);CHKERRQ(ierr);}
+  mc->ai[0] = nz = 0;
+  for (k=0; k<mc->n; k++) {
+    r           = mc->perm[k];
+    mc->diag[k] = 0.0;
+    for (j=ad->i[r]; j<ad->i[r+1]; j++) {
+      if (ad->j[j] == r) mc->diag[k] += aa[j];
+      else {
+        mc->aj[nz]   = mc->iperm[ad->j[j]];
+        mc->aa[nz++] = aa[j];
+      }
+    }
+    if (ao) {
+      for (j=ao->i[r]; j<ao->i[r+1]; j++) {
+        mc->aj[nz]   = mc->n + ao->j[j];
+        mc->aa[nz++] = aoa[j];
+      }
+    }
+    mc->ai[k+1] = nz;
+  }
+  if (Ao) {ierr = MatSeqAIJRestoreArrayRead(Ao,&aoa);CHKERRQ(ierr);}
+  ierr = MatSeqAIJRestoreArrayRead(Ad,&aa);CHKERRQ(ierr);
+  jac->usemc = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PCSetUp_SOR(PC pc)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PCSORMulticolorSetUp_Private(pc);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* relaxes the rows of one color, which do not depend on each other */
+static PetscErrorCode PCSORMulticolorRelax_Private(PC_SOR_Multicolor *mc,PetscInt c,PetscReal omega,PetscReal fshift)
+{
+  const PetscInt    *ai = mc->ai,*aj = mc->aj;
+  const MatScalar   *aa = mc->aa,*diag = mc->diag;
+  const PetscScalar *b = mc->b;
+  PetscScalar       *x = mc->x;
+  PetscInt          k;
+
+  PetscFunctionBegin;
+  PetscPragmaOMPParallelFor
+  for (k=mc->cptr[c]; k<mc->cptr[c+1]; k++) {
+    const PetscInt  *idx = aj + ai[k];
+    const MatScalar *v   = aa + ai[k];
+    PetscInt        nz   = ai[k+1] - ai[k];
+    PetscScalar     sum  = b[k];
+
+    PetscSparseDenseMinusDot(sum,x,v,idx,nz);
+    x[k] = (1.0 - omega)*x[k] + omega*sum/(diag[k] + fshift);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Updates the ghost values of the iterate after the rows cptr[cs] <= k < cptr[ce] have changed; they are first copied
+   back to y, whose other entries are current, since the scatter of the matrix sends all the ghost values
+*/
+static PetscErrorCode PCSORMulticolorUpdateGhosts_Private(Mat A,PC_SOR_Multicolor *mc,Vec y,PetscInt cs,PetscInt ce)
+{
+  Mat_MPIAIJ        *aij = (Mat_MPIAIJ*)A->data;
+  PetscErrorCode    ierr;
+  PetscScalar       *yy;
+  const PetscScalar *lx;
+  PetscInt          k;
+
+  PetscFunctionBegin;
+  ierr = VecGetArray(y,&yy);CHKERRQ(ierr);
+  for (k=mc->cptr[cs]; k<mc->cptr[ce]; k++) yy[mc->perm[k]] = mc->x[k];
+  ierr = VecRestoreArray(y,&yy);CHKERRQ(ierr);
+  ierr = VecScatterBegin(aij->Mvctx,y,aij->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecScatterEnd(aij->Mvctx,y,aij->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(aij->lvec,&lx);CHKERRQ(ierr);
+  ierr = PetscArraycpy(mc->x+mc->n,lx,mc->nghost);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(aij->lvec,&lx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Multicolor version of MatSOR(). The local sweeps update the ghost values once per outer iteration, as MatSOR_MPIAIJ(),
+   while the global sweeps update them after each color so they are a Gauss-Seidel iteration over all the processes
+*/
+static PetscErrorCode PCSORMulticolorApply_Private(PC pc,Vec b,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec y)
+{
+  PC_SOR            *jac = (PC_SOR*)pc->data;
+  PC_SOR_Multicolor *mc = jac->mc;
+  Mat               A = pc->pmat;
+  PetscErrorCode    ierr;
+  PetscBool         ismpi,global = (flag & SOR_SYMMETRIC_SWEEP) ? PETSC_TRUE : PETSC_FALSE;
+  PetscBool         forward,backward;
+  const PetscScalar *bb;
+  PetscScalar       *yy;
+  PetscInt          it,l,c,k,nc = mc->ncolors;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATMPIAIJ,&ismpi);CHKERRQ(ierr);
+  if (global) {
+    forward  = (flag & SOR_FORWARD_SWEEP) ? PETSC_TRUE : PETSC_FALSE;
+    backward = (flag & SOR_BACKWARD_SWEEP) ? PETSC_TRUE : PETSC_FALSE;
+  } else {
+    forward  = (flag & SOR_LOCAL_FORWARD_SWEEP) ? PETSC_TRUE : PETSC_FALSE;
+    backward = (flag & SOR_LOCAL_BACKWARD_SWEEP) ? PETSC_TRUE : PETSC_FALSE;
+  }
+  ierr = VecGetArrayRead(b,&bb);CHKERRQ(ierr);
+  for (k=0; k<mc->n; k++) mc->b[k] = bb[mc->perm[k]];
+  ierr = VecRestoreArrayRead(b,&bb);CHKERRQ(ierr);
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    ierr = PetscArrayzero(mc->x,mc->n+mc->nghost);CHKERRQ(ierr);
+    if (ismpi) {ierr = VecSet(y,0.0);CHKERRQ(ierr);}
+  } else {
+    ierr = VecGetArray(y,&yy);CHKERRQ(ierr);
+    for (k=0; k<mc->n; k++) mc->x[k] = yy[mc->perm[k]];
+    ierr = VecRestoreArray(y,&yy);CHKERRQ(ierr);
+    if (ismpi) {ierr = PCSORMulticolorUpdateGhosts_Private(A,mc,y,0,0);CHKERRQ(ierr);}
+  }
+  for (it=0; it<its; it++) {
+    if (!global && ismpi && it) {ierr = PCSORMulticolorUpdateGhosts_Private(A,mc,y,0,nc);CHKERRQ(ierr);}
+    for (l=0; l<lits; l++) {
+      if (forward) {
+        for (c=0; c<nc; c++) {
+          ierr = PCSORMulticolorRelax_Private(mc,c,omega,fshift);CHKERRQ(ierr);
+          if (global && ismpi) {ierr = PCSORMulticolorUpdateGhosts_Private(A,mc,y,c,c+1);CHKERRQ(ierr);}
+        }
+      }
+      if (backward) {
+        for (c=nc-1; c>=0; c--) {
+          ierr = PCSORMulticolorRelax_Private(mc,c,omega,fshift);CHKERRQ(ierr);
+          if (global && ismpi) {ierr = PCSORMulticolorUpdateGhosts_Private(A,mc,y,c,c+1);CHKERRQ(ierr);}
+        }
+      }
+    }
+  }
+  ierr = VecGetArray(y,&yy);CHKERRQ(ierr);
+  for (k=0; k<mc->n; k++) yy[mc->perm[k]] = mc->x[k];
+  ierr = VecRestoreArray(y,&yy);CHKERRQ(ierr);
+  ierr = PetscLogFlops((forward && backward ? 2.0 : 1.0)*its*lits*(2.0*mc->ai[mc->n] + 5.0*mc->n));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PCApply_SOR(PC pc,Vec x,Vec y)
 {
   PC_SOR         *jac = (PC_SOR*)pc->data;
@@ -27,6 +324,10 @@ static PetscErrorCode PCApply_SOR(PC pc,Vec x,Vec y)
   PetscInt       flag = jac->sym | SOR_ZERO_INITIAL_GUESS;
 
   PetscFunctionBegin;
+  if (jac->usemc && PCSORMulticolorSupported(jac->sym)) {
+    ierr = PCSORMulticolorApply_Private(pc,x,jac->omega,(MatSORType)flag,jac->fshift,jac->its,jac->lits,y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = MatSOR(pc->pmat,x,jac->omega,(MatSORType)flag,jac->fshift,jac->its,jac->lits,y);CHKERRQ(ierr);
   ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -42,6 +343,10 @@ static PetscErrorCode PCApplyTranspose_SOR(PC pc,Vec x,Vec y)
   PetscFunctionBegin;
   ierr = MatIsSymmetricKnown(pc->pmat,&set,&sym);CHKERRQ(ierr);
   if (!set || !sym || (jac->sym != SOR_SYMMETRIC_SWEEP && jac->sym != SOR_LOCAL_SYMMETRIC_SWEEP)) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Can only apply transpose of SOR if matrix is symmetric and sweep is symmetric");
+  if (jac->usemc && PCSORMulticolorSupported(jac->sym)) {
+    ierr = PCSORMulticolorApply_Private(pc,x,jac->omega,(MatSORType)flag,jac->fshift,jac->its,jac->lits,y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = MatSOR(pc->pmat,x,jac->omega,(MatSORType)flag,jac->fshift,jac->its,jac->lits,y);CHKERRQ(ierr);
   ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -56,8 +361,12 @@ static PetscErrorCode PCApplyRichardson_SOR(PC pc,Vec b,Vec y,Vec w,PetscReal rt
   PetscFunctionBegin;
   ierr = PetscInfo1(pc,"Warning, convergence critera ignored, using %D iterations\n",its);CHKERRQ(ierr);
   if (guesszero) stype = (MatSORType) (stype | SOR_ZERO_INITIAL_GUESS);
-  ierr = MatSOR(pc->pmat,b,jac->omega,stype,jac->fshift,its*jac->its,jac->lits,y);CHKERRQ(ierr);
-  ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr);
+  if (jac->usemc && PCSORMulticolorSupported(stype)) {
+    ierr = PCSORMulticolorApply_Private(pc,b,jac->omega,stype,jac->fshift,its*jac->its,jac->lits,y);CHKERRQ(ierr);
+  } else {
+    ierr = MatSOR(pc->pmat,b,jac->omega,stype,jac->fshift,its*jac->its,jac->lits,y);CHKERRQ(ierr);
+    ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr);
+  }
   *outits = its;
   *reason = PCRICHARDSON_CONVERGED_ITS;
   PetscFunctionReturn(0);
@@ -75,6 +384,7 @@ PetscErrorCode PCSetFromOptions_SOR(PetscOptionItems *PetscOptionsObject,PC pc)
   ierr = PetscOptionsReal("-pc_sor_diagonal_shift","Add to the diagonal entries","",jac->fshift,&jac->fshift,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_sor_its","number of inner SOR iterations","PCSORSetIterations",jac->its,&jac->its,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsInt("-pc_sor_lits","number of local inner SOR iterations","PCSORSetIterations",jac->lits,&jac->lits,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-pc_sor_multicolor","use multicolor Gauss-Seidel for AIJ matrices","PCSORSetMulticolor",jac->multicolor,&jac->multicolor,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsBoolGroupBegin("-pc_sor_symmetric","SSOR, not SOR","PCSORSetSymmetric",&flg);CHKERRQ(ierr);
   if (flg) {ierr = PCSORSetSymmetric(pc,SOR_SYMMETRIC_SWEEP);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroup("-pc_sor_backward","use backward sweep instead of forward","PCSORSetSymmetric",&flg);CHKERRQ(ierr);
@@ -114,6 +424,7 @@ PetscErrorCode PCView_SOR(PC pc,PetscViewer viewer)
     else if (sym & SOR_LOCAL_BACKWARD_SWEEP)                                 sortype = "local_backward";
     else                                                                     sortype = "unknown";
     ierr = PetscViewerASCIIPrintf(viewer,"  type = %s, iterations = %D, local iterations = %D, omega = %g\n",sortype,jac->its,jac->lits,(double)jac->omega);CHKERRQ(ierr);
+    if (jac->usemc) {ierr = PetscViewerASCIIPrintf(viewer,"  multicolor with %D colors\n",jac->mc->ncolors);CHKERRQ(ierr);}
   }
   PetscFunctionReturn(0);
 }
@@ -148,6 +459,25 @@ static PetscErrorCode  PCSORSetIterations_SOR(PC pc,PetscInt its,PetscInt lits)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode  PCSORSetMulticolor_SOR(PC pc,PetscBool flg)
+{
+  PC_SOR *jac = (PC_SOR*)pc->data;
+
+  PetscFunctionBegin;
+  if (flg != jac->multicolor) pc->setupcalled = 0;
+  jac->multicolor = flg;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode  PCSORGetMulticolor_SOR(PC pc,PetscBool *flg)
+{
+  PC_SOR *jac = (PC_SOR*)pc->data;
+
+  PetscFunctionBegin;
+  *flg = jac->multicolor;
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode  PCSORGetSymmetric_SOR(PC pc,MatSORType *flag)
 {
   PC_SOR *jac = (PC_SOR*)pc->data;
@@ -396,6 +726,73 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCSORSetMulticolor - Sets the SOR preconditioner to relax the unknowns color by color, with a coloring of the graph of
+   the matrix in which unknowns of the same color are not coupled, for MATSEQAIJ and MATMPIAIJ matrices
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  flg - PETSC_TRUE to use multicolor Gauss-Seidel
+
+   Options Database Keys:
++  -pc_sor_multicolor <true,false> - Activates multicolor Gauss-Seidel
+-  -pc_sor_mat_coloring_type <jp,greedy,...> - The MatColoring used, JP by default
+
+   Notes:
+   The rows of one color are relaxed concurrently with OpenMP threads when PETSc is configured --with-openmp, and are
+   stored contiguously for locality. With the global sweeps, SOR_FORWARD_SWEEP, SOR_BACKWARD_SWEEP and SOR_SYMMETRIC_SWEEP,
+   the ghost values are updated after each color so that in parallel this is a true Gauss-Seidel iteration, which does
+   not depend on the number of processes for a given coloring; the local sweeps, the default, update them once per outer
+   iteration, as the block Jacobi of MatSOR(). The result differs from the lexicographic SOR since the unknowns are
+   relaxed in a different order.
+
+   The coloring is computed on the graph of the matrix, symmetrized unless MatIsSymmetricKnown() or the option
+   MAT_STRUCTURALLY_SYMMETRIC tell it is symmetric, and is recomputed only when the nonzero pattern changes.
+   Other matrix types, and SOR_EISENSTAT, use MatSOR().
+
+   Level: intermediate
+
+.seealso: PCSORGetMulticolor(), PCSORSetSymmetric(), PCSORSetIterations(), MatColoringCreate(), MatSOR()
+@*/
+PetscErrorCode  PCSORSetMulticolor(PC pc,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveBool(pc,flg,2);
+  ierr = PetscTryMethod(pc,"PCSORSetMulticolor_C",(PC,PetscBool),(pc,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PCSORGetMulticolor - Gets if the SOR preconditioner relaxes the unknowns color by color
+
+   Not Collective
+
+   Input Parameter:
+.  pc - the preconditioner context
+
+   Output Parameter:
+.  flg - PETSC_TRUE if multicolor Gauss-Seidel is used
+
+   Level: intermediate
+
+.seealso: PCSORSetMulticolor()
+@*/
+PetscErrorCode  PCSORGetMulticolor(PC pc,PetscBool *flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidBoolPointer(flg,2);
+  ierr = PetscUseMethod(pc,"PCSORGetMulticolor_C",(PC,PetscBool*),(pc,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*MC
      PCSOR - (S)SOR (successive over relaxation, Gauss-Seidel) preconditioning
 
@@ -409,14 +806,15 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
 .  -pc_sor_omega <omega> - Sets omega
 .  -pc_sor_diagonal_shift <shift> - shift the diagonal entries; useful if the matrix has zeros on the diagonal
 .  -pc_sor_its <its> - Sets number of iterations   (default 1)
--  -pc_sor_lits <lits> - Sets number of local iterations  (default 1)
+.  -pc_sor_lits <lits> - Sets number of local iterations  (default 1)
+-  -pc_sor_multicolor - Activates multicolor Gauss-Seidel for AIJ matrices, see PCSORSetMulticolor()
 
    Level: beginner
 
    Notes:
     Only implemented for the AIJ  and SeqBAIJ matrix formats.
           Not a true parallel SOR, in parallel this implementation corresponds to block
-          Jacobi with SOR on each block.
+          Jacobi with SOR on each block, unless PCSORSetMulticolor() is used with a global sweep.
 
           For AIJ matrix if a diagonal entry is zero (and the diagonal shift is zero) then by default the inverse of that
           zero will be used and hence the KSPSolve() will terminate with KSP_DIVERGED_NANORIF. If the option
@@ -434,7 +832,7 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
           If omega != 1, you will need to set the MAT_USE_INODES option to PETSC_FALSE on the matrix.
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC,
-           PCSORSetIterations(), PCSORSetSymmetric(), PCSORSetOmega(), PCEISENSTAT, MatSetOption()
+           PCSORSetIterations(), PCSORSetSymmetric(), PCSORSetOmega(), PCSORSetMulticolor(), PCEISENSTAT, MatSetOption()
 M*/
 
 PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
@@ -449,7 +847,8 @@ PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
   pc->ops->applytranspose  = PCApplyTranspose_SOR;
   pc->ops->applyrichardson = PCApplyRichardson_SOR;
   pc->ops->setfromoptions  = PCSetFromOptions_SOR;
-  pc->ops->setup           = NULL;
+  pc->ops->setup           = PCSetUp_SOR;
+  pc->ops->reset           = PCReset_SOR;
   pc->ops->view            = PCView_SOR;
   pc->ops->destroy         = PCDestroy_SOR;
   pc->data                 = (void*)jac;
@@ -465,5 +864,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_SOR(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetSymmetric_C",PCSORGetSymmetric_SOR);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetOmega_C",PCSORGetOmega_SOR);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetIterations_C",PCSORGetIterations_SOR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORSetMulticolor_C",PCSORSetMulticolor_SOR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCSORGetMulticolor_C",PCSORGetMulticolor_SOR);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
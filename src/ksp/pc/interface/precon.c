@@ -1049,6 +1049,86 @@ PetscErrorCode  PCSetUpOnBlocks(PC pc)
   PetscFunctionReturn(0);
 }
 
+/*
+   PCSetUpBlocks_Private - Calls KSPSetUp() on n independent sequential block solvers, with up to nthreads
+   OpenMP threads factoring blocks concurrently.
+
+   The blocks must not share any objects; each thread works with its own KSP, PC and matrices. Threads are only
+   used when PETSc is configured with OpenMP and --with-threadsafety, otherwise the blocks are set up in order.
+*/
+PetscErrorCode PCSetUpBlocks_Private(PC pc,PetscInt nthreads,PetscInt n,KSP ksp[])
+{
+  PetscErrorCode     ierr = 0;
+  PetscInt           i;
+  KSPConvergedReason reason;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  if (nthreads > 1 && n > 1) {
+    PetscErrorCode ierrt = 0;
+
+    #pragma omp parallel for num_threads((int)PetscMin(nthreads,n)) schedule(dynamic,1) private(ierr)
+    for (i=0; i<n; i++) {
+      ierr = KSPSetUp(ksp[i]);
+      if (ierr) {
+        #pragma omp critical
+        ierrt = ierr;
+      }
+    }
+    CHKERRQ(ierrt);
+  } else
+#endif
+  {
+    for (i=0; i<n; i++) {ierr = KSPSetUp(ksp[i]);CHKERRQ(ierr);}
+  }
+  for (i=0; i<n; i++) {
+    ierr = KSPGetConvergedReason(ksp[i],&reason);CHKERRQ(ierr);
+    if (reason == KSP_DIVERGED_PC_FAILED) pc->failedreason = PC_SUBPC_ERROR;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCSolveBlocks_Private - Solves n independent sequential block systems ksp[i] y[i] = x[i], or their transposes,
+   with up to nthreads OpenMP threads working on different blocks concurrently.
+
+   Failed block solves are reported to the outer PC with KSPCheckSolve() after all the blocks are done. Logging
+   is per block in the sequential case only, since PETSc logging is not available in thread safe builds.
+*/
+PetscErrorCode PCSolveBlocks_Private(PC pc,PetscInt nthreads,PetscInt n,KSP ksp[],Vec x[],Vec y[],PetscBool transpose)
+{
+  PetscErrorCode ierr = 0;
+  PetscInt       i;
+  PetscLogEvent  event = transpose ? PC_ApplyTransposeOnBlocks : PC_ApplyOnBlocks;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+  if (nthreads > 1 && n > 1) {
+    PetscErrorCode ierrt = 0;
+
+    #pragma omp parallel for num_threads((int)PetscMin(nthreads,n)) schedule(dynamic,1) private(ierr)
+    for (i=0; i<n; i++) {
+      ierr = transpose ? KSPSolveTranspose(ksp[i],x[i],y[i]) : KSPSolve(ksp[i],x[i],y[i]);
+      if (ierr) {
+        #pragma omp critical
+        ierrt = ierr;
+      }
+    }
+    CHKERRQ(ierrt);
+  } else
+#endif
+  {
+    for (i=0; i<n; i++) {
+      ierr = PetscLogEventBegin(event,ksp[i],x[i],y[i],0);CHKERRQ(ierr);
+      if (transpose) {ierr = KSPSolveTranspose(ksp[i],x[i],y[i]);CHKERRQ(ierr);}
+      else {ierr = KSPSolve(ksp[i],x[i],y[i]);CHKERRQ(ierr);}
+      ierr = PetscLogEventEnd(event,ksp[i],x[i],y[i],0);CHKERRQ(ierr);
+    }
+  }
+  for (i=0; i<n; i++) {ierr = KSPCheckSolve(ksp[i],pc,y[i]);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PCSetModifySubMatrices - Sets a user-defined routine for modifying the
    submatrices that arise within certain subdomain-based preconditioners.
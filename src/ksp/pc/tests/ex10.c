@@ -0,0 +1,148 @@
+
+static char help[] = "Tests multicolor Gauss-Seidel with PCSOR, comparing it with MatSOR() for the natural coloring, and solves a Laplacian with it.\n\
+  -m <m>       : the grid is m x m\n\n";
+
+#include <petscksp.h>
+
+/* five point Laplacian with homogeneous Dirichlet boundary conditions and a convection term, so the matrix is not symmetric */
+static PetscErrorCode FormOperator(Mat A,PetscInt m,PetscReal beta)
+{
+  PetscInt       n,Istart,Iend;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (n=Istart; n<Iend; n++) {
+    PetscInt i = n%m,j = n/m;
+
+    if (i > 0)   {ierr = MatSetValue(A,n,n-1,-1.0-beta,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i < m-1) {ierr = MatSetValue(A,n,n+1,-1.0+beta,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j > 0)   {ierr = MatSetValue(A,n,n-m,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j < m-1) {ierr = MatSetValue(A,n,n+m,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,n,n,4.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* with the natural coloring each row is a color, so multicolor SOR relaxes the rows in the order of MatSOR() */
+static PetscErrorCode CheckNatural(Mat A,Vec b,MatSORType sym,PetscInt its,PetscInt lits,PetscReal omega)
+{
+  PC             pc;
+  Vec            x,y;
+  PetscReal      err,nrm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecDuplicate(b,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&y);CHKERRQ(ierr);
+  ierr = PCCreate(PETSC_COMM_WORLD,&pc);CHKERRQ(ierr);
+  ierr = PCSetOptionsPrefix(pc,"check_");CHKERRQ(ierr);
+  ierr = PCSetOperators(pc,A,A);CHKERRQ(ierr);
+  ierr = PCSetType(pc,PCSOR);CHKERRQ(ierr);
+  ierr = PCSORSetSymmetric(pc,sym);CHKERRQ(ierr);
+  ierr = PCSORSetIterations(pc,its,lits);CHKERRQ(ierr);
+  ierr = PCSORSetOmega(pc,omega);CHKERRQ(ierr);
+  ierr = PCSetUp(pc);CHKERRQ(ierr);
+  ierr = PCApply(pc,b,x);CHKERRQ(ierr);
+  ierr = PCSORSetMulticolor(pc,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = PCSetUp(pc);CHKERRQ(ierr);
+  ierr = PCApply(pc,b,y);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_2,&err);CHKERRQ(ierr);
+  if (err > 100*PETSC_MACHINE_EPSILON*nrm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Multicolor SOR differs from MatSOR() for MatSORType %d: %g\n",(int)sym,(double)(err/nrm));CHKERRQ(ierr);}
+  ierr = PCDestroy(&pc);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat                A;
+  KSP                ksp;
+  Vec                b,x,r;
+  PetscReal          rnorm,bnorm,beta = 0.0;
+  PetscInt           m = 32,its;
+  PetscMPIInt        size;
+  PetscBool          check = PETSC_FALSE,view = PETSC_FALSE;
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRMPI(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-beta",&beta,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-check",&check,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view_iterations",&view,NULL);CHKERRQ(ierr);
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_USE_INODES,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = FormOperator(A,m,beta);CHKERRQ(ierr);
+  if (beta == 0.0) {ierr = MatSetOption(A,MAT_SYMMETRIC,PETSC_TRUE);CHKERRQ(ierr);}
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+  ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+
+  if (check) {
+    ierr = CheckNatural(A,b,SOR_LOCAL_FORWARD_SWEEP,2,2,1.0);CHKERRQ(ierr);
+    ierr = CheckNatural(A,b,SOR_LOCAL_BACKWARD_SWEEP,1,1,1.3);CHKERRQ(ierr);
+    ierr = CheckNatural(A,b,SOR_LOCAL_SYMMETRIC_SWEEP,3,1,0.8);CHKERRQ(ierr);
+    if (size == 1) {
+      ierr = CheckNatural(A,b,SOR_FORWARD_SWEEP,2,1,1.0);CHKERRQ(ierr);
+      ierr = CheckNatural(A,b,SOR_SYMMETRIC_SWEEP,2,1,1.2);CHKERRQ(ierr);
+    }
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Checked multicolor SOR with the natural coloring\n");CHKERRQ(ierr);
+  }
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,1000);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  if (reason < 0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Linear solve did not converge: %s\n",KSPConvergedReasons[reason]);CHKERRQ(ierr);}
+  ierr = MatMult(A,x,r);CHKERRQ(ierr);
+  ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+  ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+  if (rnorm > 1.e-6*bnorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Relative residual %g too large\n",(double)(rnorm/bnorm));CHKERRQ(ierr);}
+  else {ierr = PetscPrintf(PETSC_COMM_WORLD,"Linear solve converged\n");CHKERRQ(ierr);}
+  ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+  if (view) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Iterations %D\n",its);CHKERRQ(ierr);}
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      nsize: {{1 3}}
+      args: -check -check_pc_sor_mat_coloring_type natural -beta {{0 0.3}}
+      output_file: output/ex10_check.out
+      test:
+         suffix: check
+         args: -ksp_type gmres -pc_type sor -pc_sor_multicolor -pc_sor_forward
+      test:
+         suffix: check_greedy
+         args: -ksp_type gmres -pc_type sor -pc_sor_multicolor -pc_sor_symmetric -pc_sor_mat_coloring_type greedy
+
+   testset:
+      nsize: {{1 2}}
+      output_file: output/ex10_1.out
+      test:
+         suffix: cg
+         args: -ksp_type cg -pc_type sor -pc_sor_multicolor -pc_sor_symmetric -pc_sor_its {{1 2}}
+      test:
+         suffix: gamg
+         args: -ksp_type cg -pc_type gamg -mg_levels_ksp_type richardson -mg_levels_pc_type sor -mg_levels_pc_sor_multicolor -mg_levels_pc_sor_symmetric
+
+TEST*/
@@ -0,0 +1,357 @@
+#include <petsc/private/matimpl.h>    /*I "petscmat.h" I*/
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+#include <petscsf.h>
+
+/*
+   The status of a vertex in the distance-2 MIS is a single 64 bit integer so that the rounds only need minimums: vertices
+   in the MIS are MIS2_IN, vertices that can not be in it are MIS2_OUT and undecided vertices carry their priority, a
+   bijective hash of their global index into [0,2^62) that lies between the two. Priorities are unique and do not depend
+   on the ordering of the vertices, the number of processes or the number of threads.
+*/
+#define MIS2_IN  ((PetscInt64)-1)
+#define MIS2_OUT ((PetscInt64)1 << 62)
+
+PETSC_STATIC_INLINE PetscInt64 MIS2Priority(PetscInt gid)
+{
+  const uint64_t mask = ((uint64_t)1 << 62) - 1;
+  uint64_t       x    = (uint64_t)gid & mask;
+
+  /* xorshift and odd multipliers are invertible modulo 2^62 */
+  x ^= x >> 31; x = (x*0x7fb5d329728ea185ULL) & mask;
+  x ^= x >> 27; x = (x*0x81dadef4bc2dd44dULL) & mask;
+  x ^= x >> 33;
+  return (PetscInt64)x;
+}
+
+/*
+   misTwoAgg - distance-2 maximal independent set aggregation that does not form the square of the graph. MatAIJ specific!!!
+
+   Each round computes, for every vertex, the minimum status over its closed neighborhood and then the minimum of these
+   over the closed neighborhood again, which is the minimum status within distance 2. An undecided vertex joins the MIS if
+   this is its own priority and leaves it if a vertex of the MIS is within distance 2. The rounds only read the status of
+   the previous round so that vertices are processed by OpenMP threads in any order.
+
+   The vertices of the MIS are the roots of the aggregates; their neighbors join them and the remaining vertices join the
+   aggregate of the neighbor with the strongest connection, ties go to the smallest root. Vertices without neighbors are
+   not aggregated. In parallel, a matrix whose off-process columns are the members of the aggregates owned by other
+   processes is provided with the aggregates, to communicate the data of the members as the square of the graph would.
+
+   Input Parameter:
+   . Gmat - global matrix of graph, its values are the strength of the connections
+
+   Output Parameter:
+   . a_locals_llist - array of list of global indices of the nodes rooted at selected nodes
+*/
+static PetscErrorCode misTwoAgg(Mat Gmat,PetscCoarsenData **a_locals_llist)
+{
+  PetscErrorCode    ierr;
+  Mat_SeqAIJ        *matA,*matB = NULL;
+  Mat_MPIAIJ        *mpimat = NULL;
+  MPI_Comm          comm;
+  PetscBool         isMPI,isAIJ;
+  const PetscInt    nloc = Gmat->rmap->n;
+  PetscInt          my0,Iend,nghost = 0,lid,nundecided,nselected = 0,nremoved = 0,nrounds = 0,nleaves,*ilocal,*iremote,*members;
+  PetscInt          *lid_agg,*ghost_agg = NULL,*lid_gid,nmembers,nleft;
+  const PetscInt    *degree;
+  PetscInt64        *lid_status,*lid_colmin,*ghost_status = NULL,*ghost_colmin = NULL;
+  PetscCoarsenData  *agg_lists;
+  PetscLayout       layout;
+  PetscSF           sf = NULL,aggsf;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)Gmat,&comm);CHKERRQ(ierr);
+  ierr = PetscObjectBaseTypeCompare((PetscObject)Gmat,MATMPIAIJ,&isMPI);CHKERRQ(ierr);
+  if (isMPI) {
+    mpimat = (Mat_MPIAIJ*)Gmat->data;
+    matA   = (Mat_SeqAIJ*)mpimat->A->data;
+    matB   = (Mat_SeqAIJ*)mpimat->B->data;
+  } else {
+    ierr = PetscObjectBaseTypeCompare((PetscObject)Gmat,MATSEQAIJ,&isAIJ);CHKERRQ(ierr);
+    if (!isAIJ) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_USER,"Require AIJ matrix.");
+    matA = (Mat_SeqAIJ*)Gmat->data;
+  }
+  ierr = MatGetOwnershipRange(Gmat,&my0,&Iend);CHKERRQ(ierr);
+  ierr = MatGetLayouts(Gmat,&layout,NULL);CHKERRQ(ierr);
+  ierr = PetscMalloc4(nloc,&lid_status,nloc,&lid_colmin,nloc,&lid_agg,nloc,&lid_gid);CHKERRQ(ierr);
+  if (mpimat) {
+    ierr = VecGetLocalSize(mpimat->lvec,&nghost);CHKERRQ(ierr);
+    ierr = PetscMalloc3(nghost,&ghost_status,nghost,&ghost_colmin,nghost,&ghost_agg);CHKERRQ(ierr);
+    ierr = PetscSFCreate(comm,&sf);CHKERRQ(ierr);
+    ierr = PetscSFSetGraphLayout(sf,layout,nghost,NULL,PETSC_COPY_VALUES,mpimat->garray);CHKERRQ(ierr);
+  }
+
+  /* vertices without neighbors are removed, the others start undecided */
+  PetscPragmaOMPParallelFor
+  for (lid=0; lid<nloc; lid++) {
+    PetscInt k,nadj = (matB ? matB->i[lid+1] - matB->i[lid] : 0);
+
+    for (k=matA->i[lid]; k<matA->i[lid+1]; k++) if (matA->j[k] != lid) nadj++;
+    lid_gid[lid]    = my0 + lid;
+    lid_status[lid] = nadj ? MIS2Priority(my0+lid) : MIS2_OUT;
+    lid_agg[lid]    = nadj ? -1 : -2;
+  }
+  for (lid=0; lid<nloc; lid++) if (lid_agg[lid] == -2) nremoved++;
+  nundecided = nloc - nremoved;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nundecided,1,MPIU_INT,MPI_SUM,comm);CHKERRMPI(ierr);
+
+  while (nundecided) {
+    nrounds++;
+    /* minimum status in the closed neighborhood */
+    if (sf) {
+      ierr = PetscSFBcastBegin(sf,MPIU_INT64,lid_status,ghost_status,MPI_REPLACE);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf,MPIU_INT64,lid_status,ghost_status,MPI_REPLACE);CHKERRQ(ierr);
+    }
+    PetscPragmaOMPParallelFor
+    for (lid=0; lid<nloc; lid++) {
+      PetscInt   k;
+      PetscInt64 s = lid_status[lid];
+
+      for (k=matA->i[lid]; k<matA->i[lid+1]; k++) s = PetscMin(s,lid_status[matA->j[k]]);
+      if (matB) for (k=matB->i[lid]; k<matB->i[lid+1]; k++) s = PetscMin(s,ghost_status[matB->j[k]]);
+      lid_colmin[lid] = s;
+    }
+    /* minimum status within distance 2 decides the undecided vertices */
+    if (sf) {
+      ierr = PetscSFBcastBegin(sf,MPIU_INT64,lid_colmin,ghost_colmin,MPI_REPLACE);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf,MPIU_INT64,lid_colmin,ghost_colmin,MPI_REPLACE);CHKERRQ(ierr);
+    }
+    PetscPragmaOMPParallelFor
+    for (lid=0; lid<nloc; lid++) {
+      PetscInt   k;
+      PetscInt64 s = lid_colmin[lid];
+
+      if (lid_status[lid] == MIS2_IN || lid_status[lid] == MIS2_OUT) continue;
+      for (k=matA->i[lid]; k<matA->i[lid+1]; k++) s = PetscMin(s,lid_colmin[matA->j[k]]);
+      if (matB) for (k=matB->i[lid]; k<matB->i[lid+1]; k++) s = PetscMin(s,ghost_colmin[matB->j[k]]);
+      if (s == MIS2_IN) lid_status[lid] = MIS2_OUT;
+      else if (s == lid_status[lid]) lid_status[lid] = MIS2_IN;
+    }
+    for (lid=0,nundecided=0; lid<nloc; lid++) if (lid_status[lid] != MIS2_IN && lid_status[lid] != MIS2_OUT) nundecided++;
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&nundecided,1,MPIU_INT,MPI_SUM,comm);CHKERRMPI(ierr);
+  }
+
+  /* the neighbors of the roots join them */
+  if (sf) {
+    ierr = PetscSFBcastBegin(sf,MPIU_INT64,lid_status,ghost_status,MPI_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,MPIU_INT64,lid_status,ghost_status,MPI_REPLACE);CHKERRQ(ierr);
+  }
+  PetscPragmaOMPParallelFor
+  for (lid=0; lid<nloc; lid++) {
+    PetscInt  k,root = lid_agg[lid];
+    PetscReal w,wmax = -1.0;
+
+    if (lid_status[lid] == MIS2_IN) root = my0 + lid;
+    else if (root == -1) {
+      for (k=matA->i[lid]; k<matA->i[lid+1]; k++) {
+        if (lid_status[matA->j[k]] != MIS2_IN) continue;
+        w = PetscAbsScalar(matA->a[k]);
+        if (w > wmax || (w == wmax && my0 + matA->j[k] < root)) {wmax = w; root = my0 + matA->j[k];}
+      }
+      if (matB) for (k=matB->i[lid]; k<matB->i[lid+1]; k++) {
+        if (ghost_status[matB->j[k]] != MIS2_IN) continue;
+        w = PetscAbsScalar(matB->a[k]);
+        if (w > wmax || (w == wmax && mpimat->garray[matB->j[k]] < root)) {wmax = w; root = mpimat->garray[matB->j[k]];}
+      }
+    }
+    lid_colmin[lid] = root;
+  }
+  for (lid=0; lid<nloc; lid++) lid_agg[lid] = (PetscInt)lid_colmin[lid];
+
+  /* the other vertices are at distance 2 of a root and join the aggregate of their strongest aggregated neighbor */
+  if (sf) {
+    ierr = PetscSFBcastBegin(sf,MPIU_INT,lid_agg,ghost_agg,MPI_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,MPIU_INT,lid_agg,ghost_agg,MPI_REPLACE);CHKERRQ(ierr);
+  }
+  PetscPragmaOMPParallelFor
+  for (lid=0; lid<nloc; lid++) {
+    PetscInt  k,root = -1,r;
+    PetscReal w,wmax = -1.0;
+
+    lid_colmin[lid] = lid_agg[lid];
+    if (lid_agg[lid] != -1) continue;
+    for (k=matA->i[lid]; k<matA->i[lid+1]; k++) {
+      if ((r = lid_agg[matA->j[k]]) < 0) continue;
+      w = PetscAbsScalar(matA->a[k]);
+      if (w > wmax || (w == wmax && r < root)) {wmax = w; root = r;}
+    }
+    if (matB) for (k=matB->i[lid]; k<matB->i[lid+1]; k++) {
+      if ((r = ghost_agg[matB->j[k]]) < 0) continue;
+      w = PetscAbsScalar(matB->a[k]);
+      if (w > wmax || (w == wmax && r < root)) {wmax = w; root = r;}
+    }
+    lid_colmin[lid] = root;
+  }
+  for (lid=0,nleft=0; lid<nloc; lid++) if ((lid_agg[lid] = (PetscInt)lid_colmin[lid]) == -1) nleft++;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nleft,1,MPIU_INT,MPI_SUM,comm);CHKERRMPI(ierr);
+
+  /* with a nonsymmetric graph some vertices may be left over, they are aggregated around new roots at distance 1 */
+  while (nleft) {
+    nrounds++;
+    PetscPragmaOMPParallelFor
+    for (lid=0; lid<nloc; lid++) lid_status[lid] = lid_agg[lid] == -1 ? MIS2Priority(my0+lid) : MIS2_OUT;
+    if (sf) {
+      ierr = PetscSFBcastBegin(sf,MPIU_INT64,lid_status,ghost_status,MPI_REPLACE);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf,MPIU_INT64,lid_status,ghost_status,MPI_REPLACE);CHKERRQ(ierr);
+    }
+    PetscPragmaOMPParallelFor
+    for (lid=0; lid<nloc; lid++) {
+      PetscInt   k;
+      PetscInt64 s = MIS2_OUT;
+
+      lid_colmin[lid] = lid_agg[lid];
+      if (lid_agg[lid] != -1) continue;
+      for (k=matA->i[lid]; k<matA->i[lid+1]; k++) if (matA->j[k] != lid) s = PetscMin(s,lid_status[matA->j[k]]);
+      if (matB) for (k=matB->i[lid]; k<matB->i[lid+1]; k++) s = PetscMin(s,ghost_status[matB->j[k]]);
+      if (lid_status[lid] < s) lid_colmin[lid] = my0 + lid;
+    }
+    for (lid=0; lid<nloc; lid++) lid_agg[lid] = (PetscInt)lid_colmin[lid];
+    if (sf) {
+      ierr = PetscSFBcastBegin(sf,MPIU_INT,lid_agg,ghost_agg,MPI_REPLACE);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf,MPIU_INT,lid_agg,ghost_agg,MPI_REPLACE);CHKERRQ(ierr);
+    }
+    PetscPragmaOMPParallelFor
+    for (lid=0; lid<nloc; lid++) {
+      PetscInt  k,root = -1;
+      PetscReal w,wmax = -1.0;
+
+      lid_colmin[lid] = lid_agg[lid];
+      if (lid_agg[lid] != -1) continue;
+      for (k=matA->i[lid]; k<matA->i[lid+1]; k++) {
+        if (lid_agg[matA->j[k]] != my0 + matA->j[k] || lid_status[matA->j[k]] == MIS2_OUT) continue;
+        w = PetscAbsScalar(matA->a[k]);
+        if (w > wmax || (w == wmax && my0 + matA->j[k] < root)) {wmax = w; root = my0 + matA->j[k];}
+      }
+      if (matB) for (k=matB->i[lid]; k<matB->i[lid+1]; k++) {
+        if (ghost_agg[matB->j[k]] != mpimat->garray[matB->j[k]] || ghost_status[matB->j[k]] == MIS2_OUT) continue;
+        w = PetscAbsScalar(matB->a[k]);
+        if (w > wmax || (w == wmax && mpimat->garray[matB->j[k]] < root)) {wmax = w; root = mpimat->garray[matB->j[k]];}
+      }
+      lid_colmin[lid] = root;
+    }
+    for (lid=0,nleft=0; lid<nloc; lid++) if ((lid_agg[lid] = (PetscInt)lid_colmin[lid]) == -1) nleft++;
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&nleft,1,MPIU_INT,MPI_SUM,comm);CHKERRMPI(ierr);
+  }
+
+  /* gather the members of the aggregates at their roots */
+  for (lid=0,nleaves=0; lid<nloc; lid++) if (lid_agg[lid] >= 0) nleaves++;
+  ierr = PetscMalloc1(nleaves,&ilocal);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nleaves,&iremote);CHKERRQ(ierr);
+  for (lid=0,nleaves=0; lid<nloc; lid++) {
+    if (lid_agg[lid] < 0) continue;
+    ilocal[nleaves]    = lid;
+    iremote[nleaves++] = lid_agg[lid];
+  }
+  ierr = PetscSFCreate(comm,&aggsf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraphLayout(aggsf,layout,nleaves,ilocal,PETSC_OWN_POINTER,iremote);CHKERRQ(ierr);
+  ierr = PetscFree(iremote);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeBegin(aggsf,&degree);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeEnd(aggsf,&degree);CHKERRQ(ierr);
+  for (lid=0,nmembers=0; lid<nloc; lid++) nmembers += degree[lid];
+  ierr = PetscMalloc1(nmembers,&members);CHKERRQ(ierr);
+  ierr = PetscSFGatherBegin(aggsf,MPIU_INT,lid_gid,members);CHKERRQ(ierr);
+  ierr = PetscSFGatherEnd(aggsf,MPIU_INT,lid_gid,members);CHKERRQ(ierr);
+
+  /* the root heads its list, the other members are sorted to be independent of the order of the messages */
+  ierr = PetscCDCreate(nloc,&agg_lists);CHKERRQ(ierr);
+  for (lid=0,nmembers=0; lid<nloc; nmembers+=degree[lid++]) {
+    PetscInt k;
+
+    if (!degree[lid]) continue;
+    nselected++;
+    ierr = PetscSortInt(degree[lid],members+nmembers);CHKERRQ(ierr);
+    ierr = PetscCDAppendID(agg_lists,lid,my0+lid);CHKERRQ(ierr);
+    for (k=nmembers; k<nmembers+degree[lid]; k++) {
+      if (members[k] != my0+lid) {ierr = PetscCDAppendID(agg_lists,lid,members[k]);CHKERRQ(ierr);}
+    }
+  }
+  /* the ghost data of the graph must include the members of the aggregates that are owned by other processes */
+  if (sf) {
+    Mat         mat;
+    PetscInt    *onnz,k;
+    PetscScalar one = 1.0;
+
+    ierr = PetscCalloc1(nloc,&onnz);CHKERRQ(ierr);
+    for (lid=0,nmembers=0; lid<nloc; nmembers+=degree[lid++]) {
+      for (k=nmembers; k<nmembers+degree[lid]; k++) if (members[k] < my0 || members[k] >= Iend) onnz[lid]++;
+    }
+    ierr = MatCreateAIJ(comm,nloc,nloc,PETSC_DETERMINE,PETSC_DETERMINE,0,NULL,0,onnz,&mat);CHKERRQ(ierr);
+    for (lid=0,nmembers=0; lid<nloc; nmembers+=degree[lid++]) {
+      PetscInt gid = my0 + lid;
+
+      for (k=nmembers; k<nmembers+degree[lid]; k++) {
+        if (members[k] < my0 || members[k] >= Iend) {ierr = MatSetValues(mat,1,&gid,1,&members[k],&one,INSERT_VALUES);CHKERRQ(ierr);}
+      }
+    }
+    ierr = MatAssemblyBegin(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = PetscCDSetMat(agg_lists,mat);CHKERRQ(ierr);
+    ierr = PetscFree(onnz);CHKERRQ(ierr);
+  }
+  *a_locals_llist = agg_lists;
+  ierr = PetscInfo4(Gmat,"\t removed %D of %D vertices.  %D selected in %D rounds.\n",nremoved,nloc,nselected,nrounds);CHKERRQ(ierr);
+
+  ierr = PetscFree(members);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&aggsf);CHKERRQ(ierr);
+  if (sf) {
+    ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+    ierr = PetscFree3(ghost_status,ghost_colmin,ghost_agg);CHKERRQ(ierr);
+  }
+  ierr = PetscFree4(lid_status,lid_colmin,lid_agg,lid_gid);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCoarsenApply_MIS2(MatCoarsen coarse)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!coarse->strict_aggs) SETERRQ(PetscObjectComm((PetscObject)coarse),PETSC_ERR_SUP,"Only strict (non overlapping) aggregates are supported");
+  ierr = misTwoAgg(coarse->graph,&coarse->agg_lists);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCoarsenView_MIS2(MatCoarsen coarse,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)coarse),&rank);CHKERRMPI(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"  [%d] distance-2 MIS aggregator\n",rank);CHKERRQ(ierr);
+    ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATCOARSENMIS2 - A coarsener that aggregates around a distance-2 maximal independent set of the graph without forming
+   the square of the graph
+
+   Notes:
+   The independent set is computed in rounds where every vertex of the graph is processed independently, with OpenMP
+   threads when PETSc is configured with OpenMP. Ties are broken with a hash of the global indices, hence the aggregates
+   do not depend on the number of threads or on the greedy ordering set with MatCoarsenSetGreedyOrdering(), which is
+   ignored.
+
+   The aggregates are similar to those of MATCOARSENMIS on the squared graph, PCGAMG does not square the graph when
+   this coarsener is used, see PCGAMGSetSquareGraph(). Only strict aggregates are supported.
+
+   Level: beginner
+
+.seealso: MatCoarsenSetType(), MatCoarsenType, MatCoarsenCreate(), MATCOARSENMIS
+
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCoarsenCreate_MIS2(MatCoarsen coarse)
+{
+  PetscFunctionBegin;
+  coarse->ops->apply = MatCoarsenApply_MIS2;
+  coarse->ops->view  = MatCoarsenView_MIS2;
+  PetscFunctionReturn(0);
+}
@@ -69,7 +69,8 @@
       PetscEnum, parameter :: MAT_STRUCTURE_ONLY = 22
       PetscEnum, parameter :: MAT_SORTED_FULL = 23
       PetscEnum, parameter :: MAT_FORM_EXPLICIT_TRANSPOSE = 24
-      PetscEnum, parameter :: MAT_OPTION_MAX = 25
+      PetscEnum, parameter :: MAT_SUBMATRIX_PLAN = 25
+      PetscEnum, parameter :: MAT_OPTION_MAX = 26
 !
 !  MatFactorShiftType
 !
@@ -5,6 +5,7 @@
 #include <../src/mat/impls/aij/mpi/mpiaij.h>
 #include <petsc/private/vecimpl.h>
 #include <petsc/private/isimpl.h>    /* needed because accesses data structure of ISLocalToGlobalMapping directly */
+#include <petscsf.h>
 
 PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat mat)
 {
@@ -15,6 +16,8 @@ PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat mat)
   PetscInt       ec = 0; /* Number of nonzero external columns */
   IS             from,to;
   Vec            gvec;
+  PetscSFCompression compression;
+  PetscBool      flg;
 #if defined(PETSC_USE_CTABLE)
   PetscTable         gid1_lid1;
   PetscTablePosition tpos;
@@ -119,6 +122,8 @@ PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat mat)
   /* generate the scatter context */
   ierr = VecScatterDestroy(&aij->Mvctx);CHKERRQ(ierr);
   ierr = VecScatterCreate(gvec,from,aij->lvec,to,&aij->Mvctx);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(((PetscObject)mat)->options,((PetscObject)mat)->prefix,"-matmult_vecscatter_compression",PetscSFCompressions,(PetscEnum*)&compression,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = PetscSFSetCompression(aij->Mvctx,compression);CHKERRQ(ierr);}
   ierr = VecScatterViewFromOptions(aij->Mvctx,(PetscObject)mat,"-matmult_vecscatter_view");CHKERRQ(ierr);
   ierr = PetscLogObjectParent((PetscObject)mat,(PetscObject)aij->Mvctx);CHKERRQ(ierr);
   ierr = PetscLogObjectParent((PetscObject)mat,(PetscObject)aij->lvec);CHKERRQ(ierr);
@@ -3244,6 +3244,8 @@ PetscErrorCode MatCreateSubMatrix_MPIAIJ_SameRowColDist(Mat mat,IS isrow,IS isco
 
     /* Update diagonal and off-diagonal portions of submat */
     asub = (Mat_MPIAIJ*)(*submat)->data;
+    a->A->submatrix_plan = mat->submatrix_plan;
+    a->B->submatrix_plan = mat->submatrix_plan;
     ierr = MatCreateSubMatrix_SeqAIJ(a->A,isrow_d,iscol_d,PETSC_DECIDE,MAT_REUSE_MATRIX,&asub->A);CHKERRQ(ierr);
     ierr = ISGetLocalSize(iscol_o,&n);CHKERRQ(ierr);
     if (n) {
@@ -4349,9 +4351,10 @@ $     MatMPIAIJSetPreallocation(A,...);
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
 .  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
--  -matmult_vecscatter_view <viewer> - View the vecscatter (i.e., communication pattern) used in MatMult() of sparse parallel matrices.
+.  -matmult_vecscatter_view <viewer> - View the vecscatter (i.e., communication pattern) used in MatMult() of sparse parallel matrices.
         See viewer types in manual of MatView(). Of them, ascii_matlab, draw or binary cause the vecscatter be viewed as a matrix.
         Entry (i,j) is the size of message (in bytes) rank i sends to rank j in one MatMult() call.
+-  -matmult_vecscatter_compression <none,single,bfloat16> - Send the off-process vector entries needed by MatMult() in reduced precision, see PetscSFSetCompression()
 
    Example usage:
 
@@ -2612,6 +2612,120 @@ PetscErrorCode MatDiagonalScale_SeqAIJ(Mat A,Vec ll,Vec rr)
   PetscFunctionReturn(0);
 }
 
+/*
+   The plan of MatCreateSubMatrix_SeqAIJ() with MAT_REUSE_MATRIX: the location in A of each nonzero of the submatrix, valid
+   while A has the same nonzero pattern and the same index sets are used. It costs one PetscInt per nonzero of the submatrix
+   and is not made if the option MAT_SUBMATRIX_PLAN of A is off
+*/
+typedef struct {
+  PetscObjectId    id,rowid,colid;
+  PetscObjectState nonzerostate,rowstate,colstate;
+  PetscInt         nz;
+  PetscInt         *idx;
+} Mat_SubMatrixPlan_SeqAIJ;
+
+static PetscErrorCode MatSubMatrixPlanDestroy_SeqAIJ(void *ptr)
+{
+  Mat_SubMatrixPlan_SeqAIJ *plan = (Mat_SubMatrixPlan_SeqAIJ*)ptr;
+  PetscErrorCode           ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(plan->idx);CHKERRQ(ierr);
+  ierr = PetscFree(plan);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* records where the nonzeros of the submatrix C are in A, this is done at the first reuse of C */
+static PetscErrorCode MatCreateSubMatrixSetPlan_SeqAIJ(Mat A,IS isrow,IS iscol,Mat C)
+{
+  Mat_SeqAIJ               *a = (Mat_SeqAIJ*)A->data,*c = (Mat_SeqAIJ*)C->data;
+  Mat_SubMatrixPlan_SeqAIJ *plan;
+  PetscContainer           container;
+  const PetscInt           *irow,*icol = NULL;
+  PetscInt                 i,k,r,col,loc,first = 0,step = 1,m = C->rmap->n;
+  PetscBool                stride;
+  PetscErrorCode           ierr;
+
+  PetscFunctionBegin;
+  if (!A->submatrix_plan) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)iscol,ISSTRIDE,&stride);CHKERRQ(ierr);
+  if (stride) {ierr = ISStrideGetInfo(iscol,&first,&step);CHKERRQ(ierr);}
+  else {ierr = ISGetIndices(iscol,&icol);CHKERRQ(ierr);}
+  ierr = ISGetIndices(isrow,&irow);CHKERRQ(ierr);
+  ierr = PetscNew(&plan);CHKERRQ(ierr);
+  plan->nz = c->i[m];
+  ierr = PetscMalloc1(plan->nz,&plan->idx);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    r = irow[i];
+    for (k=c->i[i]; k<c->i[i+1]; k++) {
+      col  = stride ? first + step*c->j[k] : icol[c->j[k]];
+      ierr = PetscFindInt(col,a->ilen[r],a->j+a->i[r],&loc);CHKERRQ(ierr);
+      if (loc < 0) break;
+      plan->idx[k] = a->i[r] + loc;
+    }
+    if (k < c->i[i+1]) break;
+  }
+  ierr = ISRestoreIndices(isrow,&irow);CHKERRQ(ierr);
+  if (!stride) {ierr = ISRestoreIndices(iscol,&icol);CHKERRQ(ierr);}
+  if (i < m) { /* the rows of A are not sorted */
+    ierr = MatSubMatrixPlanDestroy_SeqAIJ(plan);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscObjectGetId((PetscObject)A,&plan->id);CHKERRQ(ierr);
+  ierr = MatGetNonzeroState(A,&plan->nonzerostate);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)isrow,&plan->rowid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)isrow,&plan->rowstate);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)iscol,&plan->colid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)iscol,&plan->colstate);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,plan);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,MatSubMatrixPlanDestroy_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)C,"MatCreateSubMatrix_SeqAIJ_Plan",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* copies the values of the submatrix C from A with its plan, if it has one that is still valid */
+static PetscErrorCode MatCreateSubMatrixApplyPlan_SeqAIJ(Mat A,IS isrow,IS iscol,Mat C,PetscBool *applied)
+{
+  Mat_SubMatrixPlan_SeqAIJ *plan;
+  PetscContainer           container;
+  PetscObjectId            id,rowid,colid;
+  PetscObjectState         nonzerostate,rowstate,colstate;
+  const PetscScalar        *aa;
+  const PetscInt           *idx;
+  PetscScalar              *ca;
+  PetscInt                 k;
+  PetscErrorCode           ierr;
+
+  PetscFunctionBegin;
+  *applied = PETSC_FALSE;
+  ierr = PetscObjectQuery((PetscObject)C,"MatCreateSubMatrix_SeqAIJ_Plan",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) PetscFunctionReturn(0);
+  ierr = PetscContainerGetPointer(container,(void**)&plan);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)A,&id);CHKERRQ(ierr);
+  ierr = MatGetNonzeroState(A,&nonzerostate);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)isrow,&rowid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)isrow,&rowstate);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)iscol,&colid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)iscol,&colstate);CHKERRQ(ierr);
+  if (id != plan->id || nonzerostate != plan->nonzerostate || rowid != plan->rowid || rowstate != plan->rowstate || colid != plan->colid || colstate != plan->colstate || ((Mat_SeqAIJ*)C->data)->nz != plan->nz) {
+    ierr = PetscObjectCompose((PetscObject)C,"MatCreateSubMatrix_SeqAIJ_Plan",NULL);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  idx  = plan->idx;
+  ierr = MatSeqAIJGetArrayRead(A,&aa);CHKERRQ(ierr);
+  ierr = MatSeqAIJGetArray(C,&ca);CHKERRQ(ierr);
+  PetscPragmaOMPParallelFor
+  for (k=0; k<plan->nz; k++) ca[k] = aa[idx[k]];
+  ierr = MatSeqAIJRestoreArray(C,&ca);CHKERRQ(ierr);
+  ierr = MatSeqAIJRestoreArrayRead(A,&aa);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  *applied = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatCreateSubMatrix_SeqAIJ(Mat A,IS isrow,IS iscol,PetscInt csize,MatReuse scall,Mat *B)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data,*c;
@@ -2627,6 +2741,12 @@ PetscErrorCode MatCreateSubMatrix_SeqAIJ(Mat A,IS isrow,IS iscol,PetscInt csize,
   PetscBool         stride;
 
   PetscFunctionBegin;
+  if (scall == MAT_REUSE_MATRIX) {
+    PetscBool applied;
+
+    ierr = MatCreateSubMatrixApplyPlan_SeqAIJ(A,isrow,iscol,*B,&applied);CHKERRQ(ierr);
+    if (applied) PetscFunctionReturn(0);
+  }
   ierr = ISGetIndices(isrow,&irow);CHKERRQ(ierr);
   ierr = ISGetLocalSize(isrow,&nrows);CHKERRQ(ierr);
   ierr = ISGetLocalSize(iscol,&ncols);CHKERRQ(ierr);
@@ -2778,6 +2898,8 @@ PetscErrorCode MatCreateSubMatrix_SeqAIJ(Mat A,IS isrow,IS iscol,PetscInt csize,
   ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
 
   ierr = ISRestoreIndices(isrow,&irow);CHKERRQ(ierr);
+  /* a submatrix that is extracted again is likely to be extracted many times */
+  if (scall == MAT_REUSE_MATRIX) {ierr = MatCreateSubMatrixSetPlan_SeqAIJ(A,isrow,iscol,C);CHKERRQ(ierr);}
   *B   = C;
   PetscFunctionReturn(0);
 }
@@ -3097,6 +3219,7 @@ PetscErrorCode MatCopy_SeqAIJ(Mat A,Mat B,MatStructure str)
     ierr = MatSeqAIJGetArrayRead(A,&aa);CHKERRQ(ierr);
     if (a->i[A->rmap->n] != b->i[B->rmap->n]) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Number of nonzeros in two matrices are different %D != %D",a->i[A->rmap->n],b->i[B->rmap->n]);
     ierr = PetscArraycpy(b->a,aa,a->i[A->rmap->n]);CHKERRQ(ierr);
+    ierr = MatSeqAIJInvalidateDiagonal(B);CHKERRQ(ierr);
     ierr = PetscObjectStateIncrease((PetscObject)B);CHKERRQ(ierr);
     ierr = MatSeqAIJRestoreArrayRead(A,&aa);CHKERRQ(ierr);
   } else {
@@ -0,0 +1,529 @@
+
+/*
+   Block low-rank (BLR) LU factorization of sequential matrices.
+
+   The permuted matrix is cut into nb x nb blocks and factored one block column at a time (left-looking):
+   block row and block column k are gathered from the matrix and updated with the factors already
+   computed, the diagonal block is factored with partial pivoting restricted to the block, and the
+   off-diagonal blocks of L and U are compressed with a truncated SVD. Only the compressed factors,
+   one block row and one block column are ever held, never the dense matrix.
+*/
+#include <petsc/private/matimpl.h>
+#include <petscblaslapack.h>
+
+typedef struct {
+  PetscBLASInt m,n,r;             /* r < 0 for a dense block */
+  PetscScalar  *X,*W;             /* dense: X is m x n; low rank: X is m x r and W is r x n */
+} MatBLRBlock;
+
+typedef struct {
+  PetscInt       bs;              /* requested block size */
+  PetscReal      tol;             /* truncation of the singular values, relative to the norm of the matrix */
+  PetscInt       nb,*start;       /* number of blocks and their first row in the permuted numbering */
+  MatBLRBlock    *blocks;         /* row major, L_ik below and U_kj above the dense LU factors of the diagonal blocks */
+  PetscBLASInt   *pivots;         /* pivots of the diagonal blocks, local to each block */
+  IS             row,col;
+  PetscScalar    *S,*T;           /* products of low-rank blocks */
+  PetscScalar    *a,*u,*vt,*work; /* truncated SVD */
+  PetscReal      *s,*rwork;
+  PetscBLASInt   lwork;
+  PetscScalar    *y;              /* solves */
+  PetscInt       nlr,maxrank;     /* statistics of the last factorization */
+  PetscLogDouble nstored,nnz;
+} Mat_BLR;
+
+static PetscErrorCode MatBLRReset_Private(Mat_BLR *blr)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<blr->nb*blr->nb; i++) {
+    ierr = PetscFree(blr->blocks[i].X);CHKERRQ(ierr);
+    ierr = PetscFree(blr->blocks[i].W);CHKERRQ(ierr);
+    blr->blocks[i].r = 0;
+  }
+  blr->nlr     = 0;
+  blr->maxrank = 0;
+  blr->nstored = 0;
+  PetscFunctionReturn(0);
+}
+
+/* stores the m x n block A of leading dimension lda in b, as a product X W when this takes less memory */
+static PetscErrorCode MatBLRCompress_Private(Mat_BLR *blr,PetscBLASInt m,PetscBLASInt n,const PetscScalar *A,PetscBLASInt lda,PetscReal thresh,MatBLRBlock *b)
+{
+  PetscBLASInt   k = PetscMin(m,n),r,i,j,info;
+  PetscBool      zero = PETSC_TRUE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  b->m = m;
+  b->n = n;
+  b->r = 0;
+  for (j=0; j<n && zero; j++) {
+    for (i=0; i<m; i++) if (PetscAbsScalar(A[i+j*lda]) != 0.0) {zero = PETSC_FALSE; break;}
+  }
+  if (zero) PetscFunctionReturn(0);
+  for (j=0; j<n; j++) {ierr = PetscArraycpy(blr->a+j*m,A+j*lda,m);CHKERRQ(ierr);}
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+  PetscStackCallBLAS("LAPACKgesvd",LAPACKgesvd_("S","S",&m,&n,blr->a,&m,blr->s,blr->u,&m,blr->vt,&k,blr->work,&blr->lwork,blr->rwork,&info));
+#else
+  PetscStackCallBLAS("LAPACKgesvd",LAPACKgesvd_("S","S",&m,&n,blr->a,&m,blr->s,blr->u,&m,blr->vt,&k,blr->work,&blr->lwork,&info));
+#endif
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine gesvd %d",(int)info);
+  ierr = PetscLogFlops(4.0*m*n*k);CHKERRQ(ierr);
+  for (r=0; r<k && blr->s[r] > thresh; r++);
+  if (r*(m+n) < m*n) {
+    b->r = r;
+    ierr = PetscMalloc1(m*r,&b->X);CHKERRQ(ierr);
+    ierr = PetscMalloc1(r*n,&b->W);CHKERRQ(ierr);
+    ierr = PetscArraycpy(b->X,blr->u,m*r);CHKERRQ(ierr);
+    for (j=0; j<n; j++) {
+      for (i=0; i<r; i++) b->W[i+j*r] = blr->s[i]*blr->vt[i+j*k];
+    }
+  } else {
+    b->r = -1;
+    ierr = PetscMalloc1(m*n,&b->X);CHKERRQ(ierr);
+    for (j=0; j<n; j++) {ierr = PetscArraycpy(b->X+j*m,A+j*lda,m);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/* C = C - A B with C of leading dimension ldc; low-rank operands are multiplied through their small inner factors */
+static PetscErrorCode MatBLRMultSub_Private(Mat_BLR *blr,const MatBLRBlock *A,const MatBLRBlock *B,PetscScalar *C,PetscBLASInt ldc)
+{
+  PetscScalar    one = 1.0,mone = -1.0,zero = 0.0;
+  PetscBLASInt   m = A->m,p = A->n,n = B->n,r1 = A->r,r2 = B->r;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!r1 || !r2 || !m || !n || !p) PetscFunctionReturn(0);
+  if (r1 < 0 && r2 < 0) {
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&m,&n,&p,&mone,A->X,&m,B->X,&p,&one,C,&ldc));
+    ierr = PetscLogFlops(2.0*m*n*p);CHKERRQ(ierr);
+  } else if (r1 < 0) {
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&m,&r2,&p,&one,A->X,&m,B->X,&p,&zero,blr->T,&m));
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&m,&n,&r2,&mone,blr->T,&m,B->W,&r2,&one,C,&ldc));
+    ierr = PetscLogFlops(2.0*m*r2*(p+n));CHKERRQ(ierr);
+  } else if (r2 < 0) {
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&r1,&n,&p,&one,A->W,&r1,B->X,&p,&zero,blr->T,&r1));
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&m,&n,&r1,&mone,A->X,&m,blr->T,&r1,&one,C,&ldc));
+    ierr = PetscLogFlops(2.0*r1*n*(p+m));CHKERRQ(ierr);
+  } else {
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&r1,&r2,&p,&one,A->W,&r1,B->X,&p,&zero,blr->S,&r1));
+    if (r1 <= r2) {
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&r1,&n,&r2,&one,blr->S,&r1,B->W,&r2,&zero,blr->T,&r1));
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&m,&n,&r1,&mone,A->X,&m,blr->T,&r1,&one,C,&ldc));
+      ierr = PetscLogFlops(2.0*r1*(r2*p+n*r2+m*n));CHKERRQ(ierr);
+    } else {
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&m,&r2,&r1,&one,A->X,&m,blr->S,&r1,&zero,blr->T,&m));
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&m,&n,&r2,&mone,blr->T,&m,B->W,&r2,&one,C,&ldc));
+      ierr = PetscLogFlops(2.0*r2*(r1*p+m*r1+m*n));CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* y = y - A x */
+static PetscErrorCode MatBLRMultVecSub_Private(Mat_BLR *blr,const MatBLRBlock *A,const PetscScalar *x,PetscScalar *y)
+{
+  PetscScalar  one = 1.0,mone = -1.0,zero = 0.0;
+  PetscBLASInt ione = 1;
+
+  PetscFunctionBegin;
+  if (!A->r || !A->m || !A->n) PetscFunctionReturn(0);
+  if (A->r < 0) {
+    PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&A->m,&A->n,&mone,A->X,&A->m,x,&ione,&one,y,&ione));
+  } else {
+    PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&A->r,&A->n,&one,A->W,&A->r,x,&ione,&zero,blr->T,&ione));
+    PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&A->m,&A->r,&mone,A->X,&A->m,blr->T,&ione,&one,y,&ione));
+  }
+  PetscFunctionReturn(0);
+}
+
+/* applies the row interchanges of a diagonal block to the rows of a block of the same block row */
+static void MatBLRSwapRows_Private(const PetscBLASInt *pivots,MatBLRBlock *A)
+{
+  PetscBLASInt i,j,p,nc = A->r < 0 ? A->n : A->r;
+  PetscScalar  t;
+
+  for (i=0; i<A->m; i++) {
+    p = pivots[i]-1;
+    if (p == i) continue;
+    for (j=0; j<nc; j++) {
+      t              = A->X[i+j*A->m];
+      A->X[i+j*A->m] = A->X[p+j*A->m];
+      A->X[p+j*A->m] = t;
+    }
+  }
+}
+
+static PetscErrorCode MatSolve_BLR(Mat F,Vec b,Vec x)
+{
+  Mat_BLR           *blr = (Mat_BLR*)F->data;
+  PetscInt          i,j,k,l,n = F->rmap->n,nb = blr->nb,*start = blr->start;
+  const PetscInt    *r,*c;
+  const PetscScalar *ba;
+  PetscScalar       *xa,*y = blr->y,one = 1.0,t;
+  PetscBLASInt      bk,ione = 1,p;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = ISGetIndices(blr->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(blr->col,&c);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(b,&ba);CHKERRQ(ierr);
+  for (i=0; i<n; i++) y[i] = ba[r[i]];
+  ierr = VecRestoreArrayRead(b,&ba);CHKERRQ(ierr);
+  for (k=0; k<nb; k++) {
+    PetscScalar *yk = y+start[k];
+
+    ierr = PetscBLASIntCast(start[k+1]-start[k],&bk);CHKERRQ(ierr);
+    for (i=0; i<bk; i++) {
+      p = blr->pivots[start[k]+i]-1;
+      if (p != i) {t = yk[i]; yk[i] = yk[p]; yk[p] = t;}
+    }
+    for (l=0; l<k; l++) {ierr = MatBLRMultVecSub_Private(blr,&blr->blocks[k*nb+l],y+start[l],yk);CHKERRQ(ierr);}
+    PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","L","N","U",&bk,&ione,&one,blr->blocks[k*nb+k].X,&bk,yk,&bk));
+  }
+  for (k=nb-1; k>=0; k--) {
+    PetscScalar *yk = y+start[k];
+
+    ierr = PetscBLASIntCast(start[k+1]-start[k],&bk);CHKERRQ(ierr);
+    for (j=k+1; j<nb; j++) {ierr = MatBLRMultVecSub_Private(blr,&blr->blocks[k*nb+j],y+start[j],yk);CHKERRQ(ierr);}
+    PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","U","N","N",&bk,&ione,&one,blr->blocks[k*nb+k].X,&bk,yk,&bk));
+  }
+  ierr = VecGetArrayWrite(x,&xa);CHKERRQ(ierr);
+  for (i=0; i<n; i++) xa[c[i]] = y[i];
+  ierr = VecRestoreArrayWrite(x,&xa);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(blr->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(blr->col,&c);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*blr->nstored-n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatLUFactorNumeric_BLR(Mat F,Mat A,const MatFactorInfo *info)
+{
+  Mat_BLR           *blr = (Mat_BLR*)F->data;
+  PetscInt          i,j,k,l,ii,jj,nc,n = A->rmap->n,nb = blr->nb,*start = blr->start,bmax = 0;
+  const PetscInt    *r,*ic,*cols;
+  const PetscScalar *vals;
+  PetscScalar       *C,*R,one = 1.0;
+  PetscReal         anorm,unorm;
+  PetscBLASInt      bk,ldc,mc,nr,bi,lierr;
+  IS                icol;
+  MatInfo           ainfo;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatBLRReset_Private(blr);CHKERRQ(ierr);
+  /* a zero pivot of a previous factorization must not be reported again */
+  F->factorerrortype = MAT_FACTOR_NOERROR;
+  ierr = MatNorm(A,NORM_FROBENIUS,&anorm);CHKERRQ(ierr);
+  ierr = MatGetInfo(A,MAT_LOCAL,&ainfo);CHKERRQ(ierr);
+  blr->nnz = ainfo.nz_used;
+  for (k=0; k<nb; k++) bmax = PetscMax(bmax,start[k+1]-start[k]);
+  ierr = PetscMalloc2(n*bmax,&C,n*bmax,&R);CHKERRQ(ierr);
+  ierr = ISGetIndices(blr->row,&r);CHKERRQ(ierr);
+  ierr = ISInvertPermutation(blr->col,PETSC_DECIDE,&icol);CHKERRQ(ierr);
+  ierr = ISGetIndices(icol,&ic);CHKERRQ(ierr);
+  for (k=0; k<nb; k++) {
+    MatBLRBlock *D = &blr->blocks[k*nb+k];
+
+    /* C holds block column k from the diagonal down, R block row k right of the diagonal */
+    ierr = PetscBLASIntCast(start[k+1]-start[k],&bk);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(n-start[k],&ldc);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(n-start[k+1],&nr);CHKERRQ(ierr);
+    mc   = ldc-bk;
+    ierr = PetscArrayzero(C,ldc*bk);CHKERRQ(ierr);
+    ierr = PetscArrayzero(R,bk*nr);CHKERRQ(ierr);
+    for (ii=start[k]; ii<n; ii++) {
+      ierr = MatGetRow(A,r[ii],&nc,&cols,&vals);CHKERRQ(ierr);
+      for (i=0; i<nc; i++) {
+        jj = ic[cols[i]];
+        if (jj >= start[k] && jj < start[k+1]) C[ii-start[k]+(jj-start[k])*ldc] = vals[i];
+        else if (ii < start[k+1] && jj >= start[k+1]) R[ii-start[k]+(jj-start[k+1])*bk] = vals[i];
+      }
+      ierr = MatRestoreRow(A,r[ii],&nc,&cols,&vals);CHKERRQ(ierr);
+    }
+    for (l=0; l<k; l++) {
+      for (i=k; i<nb; i++) {ierr = MatBLRMultSub_Private(blr,&blr->blocks[i*nb+l],&blr->blocks[l*nb+k],C+start[i]-start[k],ldc);CHKERRQ(ierr);}
+      for (j=k+1; j<nb; j++) {ierr = MatBLRMultSub_Private(blr,&blr->blocks[k*nb+l],&blr->blocks[l*nb+j],R+(start[j]-start[k+1])*bk,bk);CHKERRQ(ierr);}
+    }
+
+    ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+    PetscStackCallBLAS("LAPACKgetrf",LAPACKgetrf_(&bk,&bk,C,&ldc,blr->pivots+start[k],&lierr));
+    ierr = PetscFPTrapPop();CHKERRQ(ierr);
+    if (lierr < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine getrf %d",(int)lierr);
+    if (lierr > 0) {
+      ierr = PetscInfo1(F,"Zero pivot in row %D\n",start[k]+lierr-1);CHKERRQ(ierr);
+      F->factorerrortype             = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+      F->factorerror_zeropivot_value = 0.0;
+      F->factorerror_zeropivot_row   = start[k]+lierr-1;
+      break;
+    }
+    ierr = PetscLogFlops((2.0*bk*bk*bk)/3.0);CHKERRQ(ierr);
+    D->m = D->n = bk;
+    D->r = -1;
+    ierr = PetscMalloc1(bk*bk,&D->X);CHKERRQ(ierr);
+    for (j=0; j<bk; j++) {ierr = PetscArraycpy(D->X+j*bk,C+j*ldc,bk);CHKERRQ(ierr);}
+    unorm = 0.0;
+    for (j=0; j<bk; j++) {
+      for (i=0; i<=j; i++) unorm += PetscRealPart(D->X[i+j*bk]*PetscConj(D->X[i+j*bk]));
+    }
+    unorm = PetscSqrtReal(unorm);
+
+    /* the interchanges also act on the part of L left of the diagonal block */
+    for (l=0; l<k; l++) MatBLRSwapRows_Private(blr->pivots+start[k],&blr->blocks[k*nb+l]);
+    if (nr) {
+      MatBLRBlock Rk;
+
+      Rk.m = bk;
+      Rk.n = nr;
+      Rk.r = -1;
+      Rk.X = R;
+      MatBLRSwapRows_Private(blr->pivots+start[k],&Rk);
+      PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","L","N","U",&bk,&nr,&one,D->X,&bk,R,&bk));
+      PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","U","N","N",&mc,&bk,&one,D->X,&bk,C+bk,&ldc));
+      ierr = PetscLogFlops(1.0*bk*bk*(nr+mc));CHKERRQ(ierr);
+    }
+
+    /* errors in L_ik are amplified by U_kk in the product L U */
+    for (j=k+1; j<nb; j++) {
+      ierr = PetscBLASIntCast(start[j+1]-start[j],&bi);CHKERRQ(ierr);
+      ierr = MatBLRCompress_Private(blr,bk,bi,R+(start[j]-start[k+1])*bk,bk,blr->tol*anorm,&blr->blocks[k*nb+j]);CHKERRQ(ierr);
+    }
+    for (i=k+1; i<nb; i++) {
+      ierr = PetscBLASIntCast(start[i+1]-start[i],&bi);CHKERRQ(ierr);
+      ierr = MatBLRCompress_Private(blr,bi,bk,C+start[i]-start[k],ldc,unorm > 0.0 ? blr->tol*anorm/unorm : 0.0,&blr->blocks[i*nb+k]);CHKERRQ(ierr);
+    }
+  }
+  ierr = ISRestoreIndices(icol,&ic);CHKERRQ(ierr);
+  ierr = ISDestroy(&icol);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(blr->row,&r);CHKERRQ(ierr);
+  ierr = PetscFree2(C,R);CHKERRQ(ierr);
+  if (F->factorerrortype) PetscFunctionReturn(0);
+
+  for (k=0; k<nb*nb; k++) {
+    MatBLRBlock *B = &blr->blocks[k];
+
+    if (B->r < 0) blr->nstored += (PetscLogDouble)B->m*B->n;
+    else {
+      blr->nstored += (PetscLogDouble)B->r*(B->m+B->n);
+      if (k/nb != k%nb) {
+        blr->nlr++;
+        blr->maxrank = PetscMax(blr->maxrank,B->r);
+      }
+    }
+  }
+  ierr = PetscInfo4(F,"%D of %D off-diagonal blocks are low rank, the factors store %g entries, %g of a dense LU\n",blr->nlr,nb*(nb-1),blr->nstored,n ? blr->nstored/((PetscLogDouble)n*n) : 0.0);CHKERRQ(ierr);
+  F->ops->solve   = MatSolve_BLR;
+  F->assembled    = PETSC_TRUE;
+  F->preallocated = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatLUFactorSymbolic_BLR(Mat F,Mat A,IS r,IS c,const MatFactorInfo *info)
+{
+  Mat_BLR        *blr = (Mat_BLR*)F->data;
+  PetscInt       k,n = A->rmap->n,nb,bmax = 0;
+  PetscBLASInt   m,lwork = -1,lierr;
+  PetscScalar    qwork;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (A->rmap->n != A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Must be square matrix, rows %D columns %D",A->rmap->n,A->cmap->n);
+  ierr = MatBLRReset_Private(blr);CHKERRQ(ierr);
+  ierr = ISDestroy(&blr->row);CHKERRQ(ierr);
+  ierr = ISDestroy(&blr->col);CHKERRQ(ierr);
+  if (r) {
+    ierr = PetscObjectReference((PetscObject)r);CHKERRQ(ierr);
+    ierr = PetscObjectReference((PetscObject)c);CHKERRQ(ierr);
+    blr->row = r;
+    blr->col = c;
+  } else {
+    ierr = ISCreateStride(PETSC_COMM_SELF,n,0,1,&blr->row);CHKERRQ(ierr);
+    ierr = ISSetPermutation(blr->row);CHKERRQ(ierr);
+    ierr = PetscObjectReference((PetscObject)blr->row);CHKERRQ(ierr);
+    blr->col = blr->row;
+  }
+
+  /* blocks of nearly equal sizes, none larger than bs */
+  nb   = (n + blr->bs - 1)/blr->bs;
+  ierr = PetscFree(blr->start);CHKERRQ(ierr);
+  ierr = PetscFree(blr->blocks);CHKERRQ(ierr);
+  ierr = PetscFree(blr->pivots);CHKERRQ(ierr);
+  ierr = PetscFree(blr->y);CHKERRQ(ierr);
+  ierr = PetscFree4(blr->S,blr->T,blr->a,blr->u);CHKERRQ(ierr);
+  ierr = PetscFree3(blr->vt,blr->s,blr->rwork);CHKERRQ(ierr);
+  ierr = PetscFree(blr->work);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nb+1,&blr->start);CHKERRQ(ierr);
+  for (k=0; k<=nb; k++) blr->start[k] = (k*n)/nb;
+  for (k=0; k<nb; k++) bmax = PetscMax(bmax,blr->start[k+1]-blr->start[k]);
+  ierr = PetscCalloc1(nb*nb,&blr->blocks);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&blr->pivots);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&blr->y);CHKERRQ(ierr);
+  blr->nb = nb;
+
+  ierr = PetscBLASIntCast(bmax,&m);CHKERRQ(ierr);
+  ierr = PetscMalloc4(bmax*bmax,&blr->S,bmax*bmax,&blr->T,bmax*bmax,&blr->a,bmax*bmax,&blr->u);CHKERRQ(ierr);
+  ierr = PetscMalloc3(bmax*bmax,&blr->vt,bmax,&blr->s,5*bmax,&blr->rwork);CHKERRQ(ierr);
+  if (m) {
+#if defined(PETSC_USE_COMPLEX)
+    PetscStackCallBLAS("LAPACKgesvd",LAPACKgesvd_("S","S",&m,&m,blr->a,&m,blr->s,blr->u,&m,blr->vt,&m,&qwork,&lwork,blr->rwork,&lierr));
+#else
+    PetscStackCallBLAS("LAPACKgesvd",LAPACKgesvd_("S","S",&m,&m,blr->a,&m,blr->s,blr->u,&m,blr->vt,&m,&qwork,&lwork,&lierr));
+#endif
+    if (lierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine gesvd %d",(int)lierr);
+    ierr = PetscBLASIntCast((PetscInt)PetscRealPart(qwork),&lwork);CHKERRQ(ierr);
+  }
+  blr->lwork = PetscMax(lwork,5*m+1);
+  ierr = PetscMalloc1(blr->lwork,&blr->work);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)F,(nb*nb)*sizeof(MatBLRBlock)+5*bmax*bmax*sizeof(PetscScalar)+n*(sizeof(PetscScalar)+sizeof(PetscBLASInt)));CHKERRQ(ierr);
+
+  F->ops->lufactornumeric = MatLUFactorNumeric_BLR;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetInfo_BLR(Mat F,MatInfoType flag,MatInfo *info)
+{
+  Mat_BLR        *blr = (Mat_BLR*)F->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(info,sizeof(MatInfo));CHKERRQ(ierr);
+  info->block_size        = 1.0;
+  info->nz_allocated      = blr->nstored;
+  info->nz_used           = blr->nstored;
+  info->memory            = ((PetscObject)F)->mem;
+  info->fill_ratio_needed = blr->nnz > 0.0 ? blr->nstored/blr->nnz : 0.0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatView_BLR(Mat F,PetscViewer viewer)
+{
+  Mat_BLR           *blr = (Mat_BLR*)F->data;
+  PetscInt          n = F->rmap->n;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO) {
+      ierr = PetscViewerASCIIPrintf(viewer,"BLR run parameters:\n");CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPrintf(viewer,"  block size %D, %D blocks, tolerance %g\n",blr->bs,blr->nb,(double)blr->tol);CHKERRQ(ierr);
+      if (blr->nstored > 0.0) {
+        ierr = PetscViewerASCIIPrintf(viewer,"  low-rank off-diagonal blocks %D of %D, maximum rank %D\n",blr->nlr,blr->nb*(blr->nb-1),blr->maxrank);CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"  entries in the factors %g, %g of a dense LU\n",blr->nstored,blr->nstored/((PetscLogDouble)n*n));CHKERRQ(ierr);
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_BLR(Mat F)
+{
+  Mat_BLR        *blr = (Mat_BLR*)F->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatBLRReset_Private(blr);CHKERRQ(ierr);
+  ierr = ISDestroy(&blr->row);CHKERRQ(ierr);
+  ierr = ISDestroy(&blr->col);CHKERRQ(ierr);
+  ierr = PetscFree(blr->start);CHKERRQ(ierr);
+  ierr = PetscFree(blr->blocks);CHKERRQ(ierr);
+  ierr = PetscFree(blr->pivots);CHKERRQ(ierr);
+  ierr = PetscFree(blr->y);CHKERRQ(ierr);
+  ierr = PetscFree4(blr->S,blr->T,blr->a,blr->u);CHKERRQ(ierr);
+  ierr = PetscFree3(blr->vt,blr->s,blr->rwork);CHKERRQ(ierr);
+  ierr = PetscFree(blr->work);CHKERRQ(ierr);
+  ierr = PetscFree(F->data);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)F,"MatFactorGetSolverType_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatFactorGetSolverType_seq_blr(Mat A,MatSolverType *type)
+{
+  PetscFunctionBegin;
+  *type = MATSOLVERBLR;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  MATSOLVERBLR = "blr" - A block low-rank (BLR) LU factorization for sequential matrices
+
+  The matrix, permuted with the ordering of the factorization, is cut into blocks. The off-diagonal blocks of the
+  factors are compressed to low rank with a truncated SVD, dropping the singular values below the tolerance times
+  the Frobenius norm of the matrix, and are kept dense when this does not save memory. Pivoting is restricted to the
+  diagonal blocks. The dense matrix is never formed, so the memory is that of the compressed factors.
+
+  This suits the small but nearly dense coarse operators of aggressively coarsened multigrid hierarchies, for example
+  -mg_coarse_pc_factor_mat_solver_type blr, or -mg_coarse_redundant_pc_factor_mat_solver_type blr when the coarse
+  operator is parallel, and -mg_coarse_sub_pc_factor_mat_solver_type blr with PCGAMG. With a positive tolerance the
+  factorization is approximate, and the coarse solve becomes a preconditioner whose accuracy is controlled by the tolerance.
+
+  Use -pc_type lu -pc_factor_mat_solver_type blr to use this solver
+
+  Options Database Keys:
++ -mat_blr_block_size <128> - the largest size of the blocks
+- -mat_blr_tol <1.e-8> - the truncation tolerance of the low-rank blocks, relative to the norm of the matrix, 0 for an exact LU
+
+  Notes:
+    The default ordering is nested dissection for sparse matrices, which clusters connected unknowns into the same blocks.
+
+    BLR only pays off for dense or nearly dense operators, such as the Galerkin coarse operators of PCGAMG with
+    -pc_gamg_square_graph, where it stores fewer entries than a sparse LU with nested dissection ordering. For a sparse
+    operator, such as a rediscretized coarse operator of geometric multigrid, the sparse LU of MATSOLVERPETSC has less fill
+    than the compressed dense blocks. Compare the nonzeros reported by -mat_factor_view ::ascii_info for both solvers.
+
+  Level: intermediate
+
+.seealso: PCLU, PCFactorSetMatSolverType(), MatSolverType, MATSOLVERPETSC, PCMG, PCGAMG
+M*/
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seq_blr(Mat A,MatFactorType ftype,Mat *F)
+{
+  Mat            B;
+  Mat_BLR        *blr;
+  PetscBool      isdense;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(PetscObjectComm((PetscObject)A),&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,A->rmap->n,A->cmap->n);CHKERRQ(ierr);
+  ierr = PetscStrallocpy("blr",&((PetscObject)B)->type_name);CHKERRQ(ierr);
+  ierr = MatSetUp(B);CHKERRQ(ierr);
+
+  ierr = PetscNewLog(B,&blr);CHKERRQ(ierr);
+  blr->bs  = 128;
+  blr->tol = 1.e-8;
+
+  B->data                  = blr;
+  B->ops->getinfo          = MatGetInfo_BLR;
+  B->ops->lufactorsymbolic = MatLUFactorSymbolic_BLR;
+  B->ops->destroy          = MatDestroy_BLR;
+  B->ops->view             = MatView_BLR;
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatFactorGetSolverType_C",MatFactorGetSolverType_seq_blr);CHKERRQ(ierr);
+
+  B->factortype   = MAT_FACTOR_LU;
+  B->assembled    = PETSC_TRUE;
+  B->preallocated = PETSC_TRUE;
+  ierr = PetscFree(B->solvertype);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(MATSOLVERBLR,&B->solvertype);CHKERRQ(ierr);
+  B->canuseordering = PETSC_TRUE;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQDENSE,&isdense);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(isdense ? MATORDERINGNATURAL : MATORDERINGND,(char**)&B->preferredordering[MAT_FACTOR_LU]);CHKERRQ(ierr);
+
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"BLR Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_blr_block_size","The largest size of the blocks","None",blr->bs,&blr->bs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-mat_blr_tol","Truncation tolerance of the low-rank blocks, relative to the norm of the matrix","None",blr->tol,&blr->tol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (blr->bs < 1) SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_OUTOFRANGE,"Block size %D must be positive",blr->bs);
+  if (blr->tol < 0.0) SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_OUTOFRANGE,"Tolerance %g must be nonnegative",(double)blr->tol);
+  *F = B;
+  PetscFunctionReturn(0);
+}
@@ -28,6 +28,7 @@ const char       *MatOptions_Shifted[] = {"UNUSED_NONZERO_LOCATION_ERR",
                                   "STRUCTURE_ONLY",
                                   "SORTED_FULL",
                                   "FORM_EXPLICIT_TRANSPOSE",
+                                  "SUBMATRIX_PLAN",
                                   "MatOption","MAT_",NULL};
 const char *const* MatOptions = MatOptions_Shifted+2;
 const char *const MatFactorShiftTypes[] = {"NONE","NONZERO","POSITIVE_DEFINITE","INBLOCKS","MatFactorShiftType","PC_FACTOR_",NULL};
@@ -143,6 +144,7 @@ PETSC_INTERN PetscErrorCode MatGetFactor_seqdense_cuda(Mat,MatFactorType,Mat*);
 #endif
 PETSC_INTERN PetscErrorCode MatGetFactor_constantdiagonal_petsc(Mat,MatFactorType,Mat*);
 PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_bas(Mat,MatFactorType,Mat*);
+PETSC_INTERN PetscErrorCode MatGetFactor_seq_blr(Mat,MatFactorType,Mat*);
 
 /*@C
   MatInitializePackage - This function initializes everything in the Mat package. It is called
@@ -388,6 +390,10 @@ PetscErrorCode  MatInitializePackage(void)
 
   ierr = MatSolverTypeRegister(MATSOLVERBAS,   MATSEQAIJ,        MAT_FACTOR_ICC,MatGetFactor_seqaij_bas);CHKERRQ(ierr);
 
+  ierr = MatSolverTypeRegister(MATSOLVERBLR,   MATSEQAIJ,        MAT_FACTOR_LU,MatGetFactor_seq_blr);CHKERRQ(ierr);
+  ierr = MatSolverTypeRegister(MATSOLVERBLR,   MATSEQBAIJ,       MAT_FACTOR_LU,MatGetFactor_seq_blr);CHKERRQ(ierr);
+  ierr = MatSolverTypeRegister(MATSOLVERBLR,   MATSEQDENSE,      MAT_FACTOR_LU,MatGetFactor_seq_blr);CHKERRQ(ierr);
+
   /*
      Register the external package factorization based solvers
         Eventually we don't want to have these hardwired here at compile time of PETSc
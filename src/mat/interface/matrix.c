@@ -5818,6 +5818,9 @@ PetscErrorCode MatAssemblyEnd(Mat mat,MatAssemblyType type)
                      single call to MatSetValues(), preallocation is perfect, row oriented, INSERT_VALUES is used. Common
                      with finite difference schemes with non-periodic boundary conditions.
 
+   MAT_SUBMATRIX_PLAN - on by default, records at the first reuse of a submatrix of a SeqAIJ or MPIAIJ matrix where its
+                     nonzeros are in the matrix, see MatCreateSubMatrix()
+
    Level: intermediate
 
 .seealso:  MatOption, Mat
@@ -5840,6 +5843,9 @@ PetscErrorCode MatSetOption(Mat mat,MatOption op,PetscBool flg)
   case MAT_FORCE_DIAGONAL_ENTRIES:
     mat->force_diagonals = flg;
     PetscFunctionReturn(0);
+  case MAT_SUBMATRIX_PLAN:
+    mat->submatrix_plan = flg;
+    PetscFunctionReturn(0);
   case MAT_NO_OFF_PROC_ENTRIES:
     mat->nooffprocentries = flg;
     PetscFunctionReturn(0);
@@ -5958,6 +5964,9 @@ PetscErrorCode MatGetOption(Mat mat,MatOption op,PetscBool *flg)
   case MAT_SPD:
     *flg = mat->spd;
     break;
+  case MAT_SUBMATRIX_PLAN:
+    *flg = mat->submatrix_plan;
+    break;
   default:
     break;
   }
@@ -8097,6 +8106,9 @@ M*/
     Output Parameter:
 .   newmat - the new submatrix, of the same type as the old
 
+    Options Database Keys:
+.   -mat_submatrix_plan <true,false> - read by MatSetFromOptions(), record the position in mat of the nonzeros of newmat at the first reuse, see the notes below
+
     Level: advanced
 
     Notes:
@@ -8113,6 +8125,10 @@ M*/
    will reuse the matrix generated the first time.  You should call MatDestroy() on newmat when
    you are finished using it.
 
+    For MATSEQAIJ and the diagonal and off-diagonal parts of MATMPIAIJ, the first call with MAT_REUSE_MATRIX records the position in mat
+   of each nonzero of newmat, so that the next calls with the same index sets only copy the values. This plan is kept with newmat and
+   costs one PetscInt per nonzero of newmat, use MatSetOption(mat,MAT_SUBMATRIX_PLAN,PETSC_FALSE) to not make it.
+
     The communicator of the newly obtained matrix is ALWAYS the same as the communicator of
     the input matrix.
 
@@ -0,0 +1,112 @@
+
+static char help[] = "Checks the aggregates of MATCOARSENMIS2 on the graph of a 2D or 3D Laplacian.\n\
+  -m <m>   : the grid is m x m (x m)\n\
+  -dim <d> : dimension of the grid, 2 or 3\n\n";
+
+#include <petscmatcoarsen.h>
+
+int main(int argc,char **args)
+{
+  Mat              A,G;
+  MatCoarsen       crs;
+  PetscCoarsenData *agg_lists;
+  PetscCDIntNd     *pos;
+  Vec              roots,closed,count;
+  PetscInt         m = 20,dim = 2,N,Istart,Iend,row,lid,gid,d,nroots = 0;
+  PetscReal        cmin,cmax,rmax;
+  PetscScalar      one = 1.0;
+  PetscErrorCode   ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  N    = dim == 3 ? m*m*m : m*m;
+
+  /* graph of the Laplacian, with a few vertices without neighbors at the end of the grid */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,N+3,N+3,7,NULL,6,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (row=Istart; row<Iend; row++) {
+    PetscInt c[3] = {row%m,(row/m)%m,row/(m*m)},stride = 1;
+
+    ierr = MatSetValue(A,row,row,1.0,INSERT_VALUES);CHKERRQ(ierr);
+    if (row >= N) continue;
+    for (d=0; d<dim; d++,stride*=m) {
+      if (c[d] > 0) {ierr = MatSetValue(A,row,row-stride,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      if (c[d] < m-1) {ierr = MatSetValue(A,row,row+stride,1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCoarsenCreate(PETSC_COMM_WORLD,&crs);CHKERRQ(ierr);
+  ierr = MatCoarsenSetType(crs,MATCOARSENMIS2);CHKERRQ(ierr);
+  ierr = MatCoarsenSetAdjacency(crs,A);CHKERRQ(ierr);
+  ierr = MatCoarsenSetStrictAggs(crs,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatCoarsenSetFromOptions(crs);CHKERRQ(ierr);
+  ierr = MatCoarsenApply(crs);CHKERRQ(ierr);
+  ierr = MatCoarsenGetData(crs,&agg_lists);CHKERRQ(ierr);
+  ierr = MatCoarsenDestroy(&crs);CHKERRQ(ierr);
+  ierr = PetscCDGetMat(agg_lists,&G);CHKERRQ(ierr);
+  ierr = MatDestroy(&G);CHKERRQ(ierr);
+
+  /* count the aggregates of every vertex and mark the roots */
+  ierr = MatCreateVecs(A,&roots,&closed);CHKERRQ(ierr);
+  ierr = VecDuplicate(roots,&count);CHKERRQ(ierr);
+  for (lid=0; lid<Iend-Istart; lid++) {
+    ierr = PetscCDGetHeadPos(agg_lists,lid,&pos);CHKERRQ(ierr);
+    if (!pos) continue;
+    ierr = PetscCDIntNdGetID(pos,&gid);CHKERRQ(ierr);
+    if (gid != Istart+lid) {ierr = PetscPrintf(PETSC_COMM_SELF,"Aggregate %D is not headed by its root\n",Istart+lid);CHKERRQ(ierr);}
+    ierr = VecSetValue(roots,Istart+lid,one,INSERT_VALUES);CHKERRQ(ierr);
+    nroots++;
+    while (pos) {
+      ierr = PetscCDIntNdGetID(pos,&gid);CHKERRQ(ierr);
+      ierr = VecSetValue(count,gid,one,ADD_VALUES);CHKERRQ(ierr);
+      ierr = PetscCDGetNextPos(agg_lists,lid,&pos);CHKERRQ(ierr);
+    }
+  }
+  ierr = PetscCDDestroy(agg_lists);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(roots);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(roots);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(count);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(count);CHKERRQ(ierr);
+
+  /* the vertices with neighbors are in exactly one aggregate, the others in none */
+  ierr = VecMax(count,NULL,&cmax);CHKERRQ(ierr);
+  if (Iend > N) {
+    PetscScalar *c;
+
+    ierr = VecGetArray(count,&c);CHKERRQ(ierr);
+    for (row=PetscMax(N,Istart); row<Iend; row++) {
+      if (c[row-Istart] != 0.0) {ierr = PetscPrintf(PETSC_COMM_SELF,"Vertex %D without neighbors is aggregated\n",row);CHKERRQ(ierr);}
+      c[row-Istart] = 1.0;
+    }
+    ierr = VecRestoreArray(count,&c);CHKERRQ(ierr);
+  }
+  ierr = VecMin(count,NULL,&cmin);CHKERRQ(ierr);
+  if (cmin != 1.0 || cmax != 1.0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Vertices are in %g to %g aggregates\n",(double)cmin,(double)cmax);CHKERRQ(ierr);}
+
+  /* no two roots are within distance 2: every closed neighborhood holds at most one root */
+  ierr = MatMult(A,roots,closed);CHKERRQ(ierr);
+  ierr = VecMax(closed,NULL,&rmax);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&nroots,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRMPI(ierr);
+  if (rmax > 1.0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Roots are within distance 2 of each other\n");CHKERRQ(ierr);}
+  if (nroots > N/3) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Too many aggregates %D for %D vertices\n",nroots,N);CHKERRQ(ierr);}
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Aggregates checked\n");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&count);CHKERRQ(ierr);
+  ierr = VecDestroy(&closed);CHKERRQ(ierr);
+  ierr = VecDestroy(&roots);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: {{1 2 3}}
+      args: -dim {{2 3}}
+      output_file: output/ex302_1.out
+
+TEST*/
@@ -87,6 +87,7 @@ PetscErrorCode  MatCreate(MPI_Comm comm,Mat *A)
 
   B->congruentlayouts = PETSC_DECIDE;
   B->preallocated     = PETSC_FALSE;
+  B->submatrix_plan   = PETSC_TRUE;
 #if defined(PETSC_HAVE_DEVICE)
   B->boundtocpu       = PETSC_TRUE;
 #endif
@@ -248,6 +249,9 @@ PetscErrorCode  MatSetFromOptions(Mat B)
   ierr = PetscOptionsBool("-mat_form_explicit_transpose","Hint to form an explicit transpose for operations like MatMultTranspose","MatSetOption",flg,&flg,&set);CHKERRQ(ierr);
   if (set) {ierr = MatSetOption(B,MAT_FORM_EXPLICIT_TRANSPOSE,flg);CHKERRQ(ierr);}
 
+  ierr = PetscOptionsBool("-mat_submatrix_plan","Record where the nonzeros of a reused submatrix are in the matrix","MatSetOption",B->submatrix_plan,&flg,&set);CHKERRQ(ierr);
+  if (set) {ierr = MatSetOption(B,MAT_SUBMATRIX_PLAN,flg);CHKERRQ(ierr);}
+
   /* process any options handlers added with PetscObjectAddOptionsHandler() */
   ierr = PetscObjectProcessOptionsHandlers(PetscOptionsObject,(PetscObject)B);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
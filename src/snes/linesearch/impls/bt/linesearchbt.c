@@ -51,7 +51,7 @@ PetscErrorCode SNESLineSearchBTGetAlpha(SNESLineSearch linesearch, PetscReal *al
 
 static PetscErrorCode  SNESLineSearchApply_BT(SNESLineSearch linesearch)
 {
-  PetscBool         changed_y,changed_w;
+  PetscBool         changed_y,changed_w,xnormknown = PETSC_FALSE;
   PetscErrorCode    ierr;
   Vec               X,F,Y,W,G;
   SNES              snes;
@@ -367,10 +367,17 @@ static PetscErrorCode  SNESLineSearchApply_BT(SNESLineSearch linesearch)
     if (linesearch->ops->vinorm) {
       gnorm = fnorm;
       ierr  = (*linesearch->ops->vinorm)(snes, G, W, &gnorm);CHKERRQ(ierr);
+      ierr  = VecNorm(Y,NORM_2,&ynorm);CHKERRQ(ierr);
     } else {
-      ierr = VecNorm(G,NORM_2,&gnorm);CHKERRQ(ierr);
+      /* W becomes the new solution so its norm is computed in the same reduction */
+      ierr  = VecNormBegin(G,NORM_2,&gnorm);CHKERRQ(ierr);
+      ierr  = VecNormBegin(Y,NORM_2,&ynorm);CHKERRQ(ierr);
+      ierr  = VecNormBegin(W,NORM_2,&xnorm);CHKERRQ(ierr);
+      ierr  = VecNormEnd(G,NORM_2,&gnorm);CHKERRQ(ierr);
+      ierr  = VecNormEnd(Y,NORM_2,&ynorm);CHKERRQ(ierr);
+      ierr  = VecNormEnd(W,NORM_2,&xnorm);CHKERRQ(ierr);
+      xnormknown = PETSC_TRUE;
     }
-    ierr = VecNorm(Y,NORM_2,&ynorm);CHKERRQ(ierr);
     if (PetscIsInfOrNanReal(gnorm)) {
       ierr = SNESLineSearchSetReason(linesearch,SNES_LINESEARCH_FAILED_NANORINF);CHKERRQ(ierr);
       ierr = PetscInfo(snes,"Aborted due to Nan or Inf in function evaluation\n");CHKERRQ(ierr);
@@ -381,7 +388,7 @@ static PetscErrorCode  SNESLineSearchApply_BT(SNESLineSearch linesearch)
   /* copy the solution over */
   ierr = VecCopy(W, X);CHKERRQ(ierr);
   ierr = VecCopy(G, F);CHKERRQ(ierr);
-  ierr = VecNorm(X, NORM_2, &xnorm);CHKERRQ(ierr);
+  if (!xnormknown) {ierr = VecNorm(X, NORM_2, &xnorm);CHKERRQ(ierr);}
   ierr = SNESLineSearchSetLambda(linesearch, lambda);CHKERRQ(ierr);
   ierr = SNESLineSearchSetNorms(linesearch, xnorm, gnorm, ynorm);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -530,9 +530,12 @@ PetscErrorCode SNESLineSearchPreCheckPicard(SNESLineSearch linesearch,Vec X,Vec
     PetscFunctionReturn(0);
   }
 
-  ierr = VecDot(Y,Ylast,&dot);CHKERRQ(ierr);
-  ierr = VecNorm(Y,NORM_2,&ynorm);CHKERRQ(ierr);
-  ierr = VecNorm(Ylast,NORM_2,&ylastnorm);CHKERRQ(ierr);
+  ierr = VecDotBegin(Y,Ylast,&dot);CHKERRQ(ierr);
+  ierr = VecNormBegin(Y,NORM_2,&ynorm);CHKERRQ(ierr);
+  ierr = VecNormBegin(Ylast,NORM_2,&ylastnorm);CHKERRQ(ierr);
+  ierr = VecDotEnd(Y,Ylast,&dot);CHKERRQ(ierr);
+  ierr = VecNormEnd(Y,NORM_2,&ynorm);CHKERRQ(ierr);
+  ierr = VecNormEnd(Ylast,NORM_2,&ylastnorm);CHKERRQ(ierr);
   /* Compute the angle between the vectors Y and Ylast, clip to keep inside the domain of acos() */
   theta         = PetscAcosReal((PetscReal)PetscClipInterval(PetscAbsScalar(dot) / (ynorm * ylastnorm),-1.0,1.0));
   angle_radians = angle * PETSC_PI / 180.;
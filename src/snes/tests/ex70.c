@@ -0,0 +1,268 @@
+static char help[] = "Tests the matrix-free Jacobian of DMPLEX, -dm_mat_type shell, against the assembled one, and solves\n\
+a nonlinear diffusion problem with matrix-free p-multigrid built with DMPlexCoarsenDegree().\n\n\n";
+
+#include <petscdmplex.h>
+#include <petscsnes.h>
+#include <petscds.h>
+
+typedef struct {
+  PetscBool check; /* Compare the matrix-free Jacobian with the assembled one */
+  PetscBool pmg;   /* Build the p-multigrid hierarchy */
+} AppCtx;
+
+static PetscErrorCode quadratic_u(PetscInt dim, PetscReal time, const PetscReal x[], PetscInt Nc, PetscScalar *u, void *ctx)
+{
+  PetscInt d;
+  *u = 0.0;
+  for (d = 0; d < dim; ++d) *u += x[d]*x[d];
+  return 0;
+}
+
+static PetscErrorCode trig_u(PetscInt dim, PetscReal time, const PetscReal x[], PetscInt Nc, PetscScalar *u, void *ctx)
+{
+  PetscInt d;
+  *u = 1.0;
+  for (d = 0; d < dim; ++d) *u += PetscSinReal(2.0*PETSC_PI*x[d] + 0.3*d);
+  return 0;
+}
+
+/* u - div((1 + u^2) grad u) = f, with f such that the solution is u = |x|^2 */
+static void f0_u(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                 const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                 const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                 PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f0[])
+{
+  PetscScalar ue = 0.0;
+  PetscInt    d;
+
+  for (d = 0; d < dim; ++d) ue += x[d]*x[d];
+  f0[0] = u[0] - ue + 2.0*dim*(1.0 + ue*ue) + 8.0*ue*ue;
+}
+
+static void f1_u(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                 const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                 const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                 PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f1[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) f1[d] = (1.0 + u[0]*u[0])*u_x[d];
+}
+
+static void g0_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g0[])
+{
+  g0[0] = 1.0;
+}
+
+static void g2_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g2[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) g2[d] = 2.0*u[0]*u_x[d];
+}
+
+static void g3_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g3[])
+{
+  PetscInt d;
+  for (d = 0; d < dim; ++d) g3[d*dim+d] = 1.0 + u[0]*u[0];
+}
+
+static PetscErrorCode ProcessOptions(MPI_Comm comm, AppCtx *options)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  options->check = PETSC_TRUE;
+  options->pmg   = PETSC_FALSE;
+
+  ierr = PetscOptionsBegin(comm, "", "Matrix-free Jacobian Options", "DMPLEX");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-check", "Compare the matrix-free Jacobian with the assembled one", "ex70.c", options->check, &options->check, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-pmg", "Build the p-multigrid hierarchy with DMPlexCoarsenDegree()", "ex70.c", options->pmg, &options->pmg, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode SetupDiscretization(DM dm, AppCtx *user)
+{
+  PetscFE        fe;
+  PetscDS        ds;
+  DMLabel        label;
+  PetscBool      simplex;
+  PetscInt       dim;
+  const PetscInt id = 1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = DMGetDimension(dm, &dim);CHKERRQ(ierr);
+  ierr = DMPlexIsSimplex(dm, &simplex);CHKERRQ(ierr);
+  ierr = PetscFECreateDefault(PETSC_COMM_SELF, dim, 1, simplex, NULL, -1, &fe);CHKERRQ(ierr);
+  ierr = PetscObjectSetName((PetscObject) fe, "u");CHKERRQ(ierr);
+  ierr = DMSetField(dm, 0, NULL, (PetscObject) fe);CHKERRQ(ierr);
+  ierr = DMCreateDS(dm);CHKERRQ(ierr);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = PetscDSSetResidual(ds, 0, f0_u, f1_u);CHKERRQ(ierr);
+  ierr = PetscDSSetJacobian(ds, 0, 0, g0_uu, NULL, g2_uu, g3_uu);CHKERRQ(ierr);
+  ierr = PetscDSSetExactSolution(ds, 0, quadratic_u, user);CHKERRQ(ierr);
+  ierr = DMGetLabel(dm, "marker", &label);CHKERRQ(ierr);
+  ierr = DMAddBoundary(dm, DM_BC_ESSENTIAL, "wall", label, 1, &id, 0, 0, NULL, (void (*)(void)) quadratic_u, NULL, user, NULL);CHKERRQ(ierr);
+  ierr = PetscFEDestroy(&fe);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Coarsen the degree by half down to linear elements, the levels are picked up by PCMG through DMCoarsen() */
+static PetscErrorCode CreateDegreeHierarchy(DM dm, PetscInt *nlevels)
+{
+  DM             cdm = dm, dmc;
+  PetscFE        fe;
+  PetscSpace     sp;
+  PetscInt       k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = DMGetField(dm, 0, NULL, (PetscObject *) &fe);CHKERRQ(ierr);
+  ierr = PetscFEGetBasisSpace(fe, &sp);CHKERRQ(ierr);
+  ierr = PetscSpaceGetDegree(sp, &k, NULL);CHKERRQ(ierr);
+  for (*nlevels = 1; k > 1; ++(*nlevels)) {
+    k    = k/2;
+    ierr = DMPlexCoarsenDegree(cdm, k, &dmc);CHKERRQ(ierr);
+    ierr = DMDestroy(&dmc);CHKERRQ(ierr);
+    ierr = DMGetCoarseDM(cdm, &cdm);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckJacobian(SNES snes, DM dm, Vec u)
+{
+  Mat            J, A;
+  Vec            x, y, z;
+  MatType        mtype;
+  PetscRandom    rand;
+  PetscReal      nrm, err, derr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = DMCreateMatrix(dm, &J);CHKERRQ(ierr);
+  ierr = DMGetMatType(dm, &mtype);CHKERRQ(ierr);
+  ierr = DMSetMatType(dm, MATAIJ);CHKERRQ(ierr);
+  ierr = DMCreateMatrix(dm, &A);CHKERRQ(ierr);
+  ierr = DMSetMatType(dm, mtype);CHKERRQ(ierr);
+  ierr = SNESComputeJacobian(snes, u, J, J);CHKERRQ(ierr);
+  ierr = SNESComputeJacobian(snes, u, A, A);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A, &x, &y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y, &z);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD, &rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetInterval(rand, -1.0, 1.0);CHKERRQ(ierr);
+  ierr = VecSetRandom(x, rand);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = MatMult(A, x, y);CHKERRQ(ierr);
+  ierr = MatMult(J, x, z);CHKERRQ(ierr);
+  ierr = VecNorm(y, NORM_2, &nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(z, -1.0, y);CHKERRQ(ierr);
+  ierr = VecNorm(z, NORM_2, &err);CHKERRQ(ierr);
+  err /= nrm;
+  ierr = MatGetDiagonal(A, y);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(J, z);CHKERRQ(ierr);
+  ierr = VecNorm(y, NORM_2, &nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(z, -1.0, y);CHKERRQ(ierr);
+  ierr = VecNorm(z, NORM_2, &derr);CHKERRQ(ierr);
+  derr /= nrm;
+  if (err > 1.e-10 || derr > 1.e-10) {ierr = PetscPrintf(PETSC_COMM_WORLD, "Matrix-free Jacobian differs from the assembled one: action %g diagonal %g\n", (double) err, (double) derr);CHKERRQ(ierr);}
+  else {ierr = PetscPrintf(PETSC_COMM_WORLD, "Matrix-free and assembled Jacobians agree\n");CHKERRQ(ierr);}
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&J);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc, char **argv)
+{
+  DM                  dm;
+  SNES                snes;
+  Vec                 u;
+  PetscReal           error;
+  PetscInt            nlevels = 1;
+  SNESConvergedReason reason;
+  PetscErrorCode      (*exact[1])(PetscInt, PetscReal, const PetscReal [], PetscInt, PetscScalar *, void *) = {quadratic_u};
+  PetscErrorCode      (*guess[1])(PetscInt, PetscReal, const PetscReal [], PetscInt, PetscScalar *, void *) = {trig_u};
+  AppCtx              user;
+  PetscErrorCode      ierr;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, help);if (ierr) return ierr;
+  ierr = ProcessOptions(PETSC_COMM_WORLD, &user);CHKERRQ(ierr);
+  ierr = DMCreate(PETSC_COMM_WORLD, &dm);CHKERRQ(ierr);
+  ierr = DMSetType(dm, DMPLEX);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(dm);CHKERRQ(ierr);
+  ierr = DMViewFromOptions(dm, NULL, "-dm_view");CHKERRQ(ierr);
+  ierr = SetupDiscretization(dm, &user);CHKERRQ(ierr);
+  if (user.pmg) {
+    ierr = CreateDegreeHierarchy(dm, &nlevels);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD, "Degree hierarchy with %D levels\n", nlevels);CHKERRQ(ierr);
+  }
+
+  ierr = SNESCreate(PETSC_COMM_WORLD, &snes);CHKERRQ(ierr);
+  ierr = SNESSetDM(snes, dm);CHKERRQ(ierr);
+  ierr = DMPlexSetSNESLocalFEM(dm, &user, &user, &user);CHKERRQ(ierr);
+  if (user.pmg) {
+    KSP ksp;
+    PC  pc;
+
+    ierr = SNESGetKSP(snes, &ksp);CHKERRQ(ierr);
+    ierr = KSPGetPC(ksp, &pc);CHKERRQ(ierr);
+    ierr = PCSetType(pc, PCMG);CHKERRQ(ierr);
+    ierr = PCMGSetLevels(pc, nlevels, NULL);CHKERRQ(ierr);
+  }
+  ierr = SNESSetFromOptions(snes);CHKERRQ(ierr);
+  ierr = DMCreateGlobalVector(dm, &u);CHKERRQ(ierr);
+  ierr = PetscObjectSetName((PetscObject) u, "u");CHKERRQ(ierr);
+  ierr = DMProjectFunction(dm, 0.0, guess, NULL, INSERT_ALL_VALUES, u);CHKERRQ(ierr);
+  if (user.check) {ierr = CheckJacobian(snes, dm, u);CHKERRQ(ierr);}
+  ierr = SNESSolve(snes, NULL, u);CHKERRQ(ierr);
+  ierr = SNESGetConvergedReason(snes, &reason);CHKERRQ(ierr);
+  if (reason < 0) {ierr = PetscPrintf(PETSC_COMM_WORLD, "Nonlinear solve failed: %s\n", SNESConvergedReasons[reason]);CHKERRQ(ierr);}
+  /* the solution is quadratic, the error only comes from the quadrature of the nonlinear terms */
+  ierr = DMComputeL2Diff(dm, 0.0, exact, NULL, u, &error);CHKERRQ(ierr);
+  if (error < 1.e-4) {ierr = PetscPrintf(PETSC_COMM_WORLD, "L_2 Error: < 1.0e-4\n");CHKERRQ(ierr);}
+  else {ierr = PetscPrintf(PETSC_COMM_WORLD, "L_2 Error: %g\n", (double) error);CHKERRQ(ierr);}
+  ierr = VecDestroy(&u);CHKERRQ(ierr);
+  ierr = SNESDestroy(&snes);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+  testset:
+    args: -dm_plex_simplex 0 -dm_plex_box_faces 3,3 -dm_mat_type shell -snes_rtol 1.e-10 -ksp_rtol 1.e-10 -pc_type jacobi
+    output_file: output/ex70_1.out
+    test:
+      suffix: 2d
+      nsize: {{1 2}}
+      args: -petscspace_degree {{2 3}} -dm_plex_matfree_sumfact {{0 1}}
+    test:
+      suffix: 3d
+      args: -dm_plex_dim 3 -dm_plex_box_faces 2,2,2 -petscspace_degree 2 -dm_plex_matfree_sumfact {{0 1}}
+    test:
+      suffix: simplex
+      requires: triangle
+      args: -dm_plex_simplex 1 -petscspace_degree 2
+
+  testset:
+    args: -dm_plex_simplex 0 -dm_plex_box_faces 4,4 -dm_mat_type shell -petscspace_degree 4 -pmg -check 0 -snes_rtol 1.e-10 -snes_converged_reason
+    args: -ksp_rtol 1.e-10 -ksp_converged_reason -mg_levels_ksp_type chebyshev -mg_levels_pc_type jacobi
+    args: -mg_coarse_ksp_type gmres -mg_coarse_pc_type jacobi -mg_coarse_ksp_rtol 1.e-3 -mg_coarse_ksp_max_it 100
+    test:
+      suffix: pmg
+      nsize: {{1 2}}
+      output_file: output/ex70_pmg.out
+
+TEST*/
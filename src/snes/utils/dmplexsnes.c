@@ -1441,19 +1441,29 @@ PetscErrorCode DMSNESComputeJacobianAction(DM dm, Vec X, Vec Y, Vec F, void *use
   We form the residual one batch of elements at a time. This allows us to offload work onto an accelerator,
   like a GPU, or vectorize on a multicore machine.
 
+  A matrix created by DMCreateMatrix() with -dm_mat_type shell is not assembled: it applies the Jacobian at X
+  matrix-free, with sum factorization for a Lagrange field on quadrilaterals or hexahedra, and provides MatGetDiagonal()
+  so that it can be smoothed with Chebyshev and Jacobi.
+
   Level: developer
 
-.seealso: FormFunctionLocal()
+.seealso: FormFunctionLocal(), DMPlexCoarsenDegree()
 @*/
 PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void *user)
 {
   DM             plex;
   IS             allcellIS;
-  PetscBool      hasJac, hasPrec;
+  PetscBool      hasJac, hasPrec, isMF, isMFP;
   PetscInt       Nds, s;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  /* Matrix-free operators from DMCreateMatrix() only record the linearization point */
+  ierr = DMPlexMatrixFreeSetState_Internal(Jac, X, user, &isMF);CHKERRQ(ierr);
+  ierr = DMPlexMatrixFreeSetState_Internal(JacP, X, user, &isMFP);CHKERRQ(ierr);
+  if (isMF && (isMFP || Jac == JacP)) PetscFunctionReturn(0);
+  if (isMF)  Jac  = JacP;
+  if (isMFP) JacP = Jac;
   ierr = DMSNESConvertPlex(dm, &plex, PETSC_TRUE);CHKERRQ(ierr);
   ierr = DMPlexGetAllCells_Internal(plex, &allcellIS);CHKERRQ(ierr);
   ierr = DMGetNumDS(dm, &Nds);CHKERRQ(ierr);
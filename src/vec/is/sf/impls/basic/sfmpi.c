@@ -23,7 +23,7 @@ static PetscErrorCode PetscSFLinkStartRequests_MPI(PetscSF sf,PetscSFLink link,P
       nreqs = bas->nrootreqs;
       ierr = PetscSFLinkGetMPIBuffersAndRequests(sf,link,direction,NULL,NULL,&reqs,NULL);CHKERRQ(ierr);
     }
-    ierr = MPI_Startall_irecv(buflen,link->unit,nreqs,reqs);CHKERRMPI(ierr);
+    ierr = MPI_Startall_irecv(buflen,link->wireunit,nreqs,reqs);CHKERRMPI(ierr);
   }
 
   buflen = (direction == PETSCSF_ROOT2LEAF) ? bas->rootbuflen[PETSCSF_REMOTE] : sf->leafbuflen[PETSCSF_REMOTE];
@@ -38,7 +38,7 @@ static PetscErrorCode PetscSFLinkStartRequests_MPI(PetscSF sf,PetscSFLink link,P
       ierr   = PetscSFLinkGetMPIBuffersAndRequests(sf,link,direction,NULL,NULL,NULL,&reqs);CHKERRQ(ierr);
     }
     ierr = PetscSFLinkSyncStreamBeforeCallMPI(sf,link,direction);CHKERRQ(ierr);
-    ierr = MPI_Startall_isend(buflen,link->unit,nreqs,reqs);CHKERRMPI(ierr);
+    ierr = MPI_Startall_isend(buflen,link->wireunit,nreqs,reqs);CHKERRMPI(ierr);
   }
   PetscFunctionReturn(0);
 }
@@ -90,8 +90,10 @@ PetscErrorCode PetscSFLinkCreate_MPI(PetscSF sf,MPI_Datatype unit,PetscMemType x
   PetscMemType      leafmtype = PetscMemTypeHost(xleafmtype) ? PETSC_MEMTYPE_HOST : PETSC_MEMTYPE_DEVICE;
   PetscMemType      rootmtype_mpi,leafmtype_mpi;   /* mtypes seen by MPI */
   PetscInt          rootdirect_mpi,leafdirect_mpi; /* root/leafdirect seen by MPI*/
+  PetscSFCompression compression;
 
   PetscFunctionBegin;
+  ierr = PetscSFLinkGetCompression(sf,unit,rootmtype,leafmtype,sfop,&compression);CHKERRQ(ierr);
 
   /* Can we directly use root/leafdirect with the given sf, sfop and op? */
   for (i=PETSCSF_LOCAL; i<=PETSCSF_REMOTE; i++) {
@@ -106,6 +108,10 @@ PetscErrorCode PetscSFLinkCreate_MPI(PetscSF sf,MPI_Datatype unit,PetscMemType x
       leafdirect[i] = PETSC_FALSE; /* We also force allocating a separate leafbuf so that leafdata and leafupdate can share mpi requests */
     }
   }
+  if (compression) { /* Remote data is compressed in place in send buffers and expanded in receive buffers, so they can not be user data */
+    rootdirect[PETSCSF_REMOTE] = PETSC_FALSE;
+    leafdirect[PETSCSF_REMOTE] = PETSC_FALSE;
+  }
 
   if (sf->use_gpu_aware_mpi) {
     rootmtype_mpi = rootmtype;
@@ -125,7 +131,7 @@ PetscErrorCode PetscSFLinkCreate_MPI(PetscSF sf,MPI_Datatype unit,PetscMemType x
   for (p=&bas->avail; (link=*p); p=&link->next) {
     if (!link->use_nvshmem) { /* Only check with MPI links */
       ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
-      if (match) {
+      if (match && link->compression == compression) {
         /* If root/leafdata will be directly passed to MPI, test if the data used to initialized the MPI requests matches with the current.
            If not, free old requests. New requests will be lazily init'ed until one calls PetscSFLinkGetMPIBuffersAndRequests().
         */
@@ -147,6 +153,7 @@ PetscErrorCode PetscSFLinkCreate_MPI(PetscSF sf,MPI_Datatype unit,PetscMemType x
 
   ierr = PetscNew(&link);CHKERRQ(ierr);
   ierr = PetscSFLinkSetUp_Host(sf,link,unit);CHKERRQ(ierr);
+  ierr = PetscSFLinkSetUpCompression(sf,link,compression);CHKERRQ(ierr);
   ierr = PetscCommGetNewTag(PetscObjectComm((PetscObject)sf),&link->tag);CHKERRQ(ierr); /* One tag per link */
 
   nreqs = (nrootreqs+nleafreqs)*8;
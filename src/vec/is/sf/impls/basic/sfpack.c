@@ -23,6 +23,10 @@
     else if (!((s).u op (t).u)) s = t;           \
   } while (0)
 
+/* Packing a large number of scattered entries is bandwidth bound on a single core; with OpenMP, split the index loop
+   of Pack routines among threads when there are at least 32768 basic types to move. Pack only reads from the
+   unpacked data, so there are no data races. */
+
 /* DEF_PackFunc - macro defining a Pack routine
 
    Arguments of the macro:
@@ -56,13 +60,20 @@
         u2 = u + opt->start[r]*MBS;                                                                          \
         X  = opt->X[r];                                                                                      \
         Y  = opt->Y[r];                                                                                      \
-        for (k=0; k<opt->dz[r]; k++)                                                                         \
-          for (j=0; j<opt->dy[r]; j++) {                                                                     \
-            ierr = PetscArraycpy(p2,u2+(X*Y*k+X*j)*MBS,opt->dx[r]*MBS);CHKERRQ(ierr);                        \
-            p2  += opt->dx[r]*MBS;                                                                           \
-          }                                                                                                  \
+        if (opt->dx[r] == 1 && opt->dz[r] == 1) { /* Strided, so no memcpy */                                \
+          for (i=0; i<opt->dy[r]; i++,p2+=MBS)                                                               \
+            for (j=0; j<M; j++)                                                                              \
+              for (k=0; k<BS; k++) p2[j*BS+k] = u2[X*i*MBS+j*BS+k];                                          \
+        } else {                                                                                             \
+          for (k=0; k<opt->dz[r]; k++)                                                                       \
+            for (j=0; j<opt->dy[r]; j++) {                                                                   \
+              ierr = PetscArraycpy(p2,u2+(X*Y*k+X*j)*MBS,opt->dx[r]*MBS);CHKERRQ(ierr);                      \
+              p2  += opt->dx[r]*MBS;                                                                         \
+            }                                                                                                \
+        }                                                                                                    \
       }                                                                                                      \
     } else {                                                                                                 \
+      PetscPragmaOMPParallelForClauses(private(j,k) if(count*MBS >= 32768))                                  \
       for (i=0; i<count; i++)                                                                                \
         for (j=0; j<M; j++)     /* Decent compilers should eliminate this loop when M = const 1 */           \
           for (k=0; k<BS; k++)  /* Compiler either unrolls (BS=1) or vectorizes (BS=2,4,8,etc) this loop */  \
@@ -100,11 +111,17 @@
         u2 = u + opt->start[r]*MBS;                                                                          \
         X  = opt->X[r];                                                                                      \
         Y  = opt->Y[r];                                                                                      \
-        for (k=0; k<opt->dz[r]; k++)                                                                         \
-          for (j=0; j<opt->dy[r]; j++) {                                                                     \
-            ierr = PetscArraycpy(u2+(X*Y*k+X*j)*MBS,p,opt->dx[r]*MBS);CHKERRQ(ierr);                         \
-            p   += opt->dx[r]*MBS;                                                                           \
-          }                                                                                                  \
+        if (opt->dx[r] == 1 && opt->dz[r] == 1) { /* Strided, so no memcpy */                                \
+          for (i=0; i<opt->dy[r]; i++,p+=MBS)                                                                \
+            for (j=0; j<M; j++)                                                                              \
+              for (k=0; k<BS; k++) u2[X*i*MBS+j*BS+k] = p[j*BS+k];                                           \
+        } else {                                                                                             \
+          for (k=0; k<opt->dz[r]; k++)                                                                       \
+            for (j=0; j<opt->dy[r]; j++) {                                                                   \
+              ierr = PetscArraycpy(u2+(X*Y*k+X*j)*MBS,p,opt->dx[r]*MBS);CHKERRQ(ierr);                       \
+              p   += opt->dx[r]*MBS;                                                                         \
+            }                                                                                                \
+        }                                                                                                    \
       }                                                                                                      \
     } else {                                                                                                 \
       for (i=0; i<count; i++)                                                                                \
@@ -481,6 +498,7 @@ PetscErrorCode PetscSFLinkDestroy(PetscSF sf,PetscSFLink link)
 
   /* Destroy host related fields */
   if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRMPI(ierr);}
+  if (link->compression) {ierr = MPI_Type_free(&link->wireunit);CHKERRMPI(ierr);}
   if (!link->use_nvshmem) {
     for (i=0; i<nreqs; i++) { /* Persistent reqs must be freed. */
       if (link->reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->reqs[i]);CHKERRMPI(ierr);}
@@ -495,6 +513,112 @@ PetscErrorCode PetscSFLinkDestroy(PetscSF sf,PetscSFLink link)
   PetscFunctionReturn(0);
 }
 
+/* Decide which compression a link created for the given operation should use. Compression is only supported with
+   persistent requests (so that the wire datatype can be fixed when the requests are initialized), for host data, and
+   for Bcast/Reduce on double precision PetscReal/PetscComplex units. FetchAndOp needs exact values of the fetched roots.
+ */
+PetscErrorCode PetscSFLinkGetCompression(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,PetscMemType leafmtype,PetscSFOperation sfop,PetscSFCompression *compression)
+{
+#if defined(PETSC_USE_REAL_DOUBLE)
+  PetscErrorCode    ierr;
+  PetscInt          nPetscReal = 0,nPetscComplex = 0;
+#endif
+
+  PetscFunctionBegin;
+  *compression = PETSCSF_COMPRESSION_NONE;
+#if defined(PETSC_USE_REAL_DOUBLE)
+  if (!sf->compression || !sf->persistent || sfop == PETSCSF_FETCH || !PetscMemTypeHost(rootmtype) || !PetscMemTypeHost(leafmtype)) PetscFunctionReturn(0);
+  ierr = MPIPetsc_Type_compare_contig(unit,MPIU_REAL,&nPetscReal);CHKERRQ(ierr);
+ #if defined(PETSC_HAVE_COMPLEX)
+  if (!nPetscReal) {ierr = MPIPetsc_Type_compare_contig(unit,MPIU_COMPLEX,&nPetscComplex);CHKERRQ(ierr);}
+ #endif
+  if (nPetscReal || nPetscComplex) *compression = sf->compression;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/* Build the wire datatype of a link that sends its remote buffers compressed */
+PetscErrorCode PetscSFLinkSetUpCompression(PetscSF sf,PetscSFLink link,PetscSFCompression compression)
+{
+  PetscErrorCode    ierr;
+  PetscMPIInt       n;
+
+  PetscFunctionBegin;
+  link->compression = compression;
+  if (!compression) PetscFunctionReturn(0);
+  ierr = PetscMPIIntCast(link->unitbytes/sizeof(PetscReal),&n);CHKERRQ(ierr); /* Number of reals in a unit */
+  if (compression == PETSCSF_COMPRESSION_SINGLE) {
+    ierr = MPI_Type_contiguous(n,MPI_FLOAT,&link->wireunit);CHKERRMPI(ierr);
+    link->wirebytes = n*sizeof(float);
+  } else {
+    ierr = MPI_Type_contiguous(n,MPI_UNSIGNED_SHORT,&link->wireunit);CHKERRMPI(ierr);
+    link->wirebytes = n*sizeof(unsigned short);
+  }
+  ierr = MPI_Type_commit(&link->wireunit);CHKERRMPI(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Round count units of packed PetscReals in buf in place to the wire precision of the link. The compressed values
+   are stored contiguously from the beginning of buf. Since the wire representation is narrower, going forward never
+   overwrites a value not yet read. memcpy() is used to avoid aliasing problems with the in-place type punning.
+ */
+static PetscErrorCode PetscSFLinkCompressBuffer(PetscSFLink link,PetscInt count,char *buf)
+{
+  PetscInt          i,n = count*(PetscInt)(link->unitbytes/sizeof(PetscReal));
+  PetscReal         r;
+  float             f;
+  uint32_t          u;
+  unsigned short    h;
+
+  PetscFunctionBegin;
+  if (link->compression == PETSCSF_COMPRESSION_SINGLE) {
+    for (i=0; i<n; i++) {
+      memcpy(&r,buf+i*sizeof(PetscReal),sizeof(PetscReal));
+      f    = (float)r;
+      memcpy(buf+i*sizeof(float),&f,sizeof(float));
+    }
+  } else { /* bfloat16 is the upper half of a float. Round to nearest even and keep NaNs quiet */
+    for (i=0; i<n; i++) {
+      memcpy(&r,buf+i*sizeof(PetscReal),sizeof(PetscReal));
+      f    = (float)r;
+      memcpy(&u,&f,sizeof(float));
+      if ((u & 0x7fffffffU) > 0x7f800000U) u |= 0x00400000U;
+      else u += 0x7fffU + ((u >> 16) & 1U);
+      h    = (unsigned short)(u >> 16);
+      memcpy(buf+i*sizeof(unsigned short),&h,sizeof(unsigned short));
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Expand count units of compressed data in buf in place back to PetscReals. Going backward never overwrites a value not yet read */
+static PetscErrorCode PetscSFLinkDecompressBuffer(PetscSFLink link,PetscInt count,char *buf)
+{
+  PetscInt          i,n = count*(PetscInt)(link->unitbytes/sizeof(PetscReal));
+  PetscReal         r;
+  float             f;
+  uint32_t          u;
+  unsigned short    h;
+
+  PetscFunctionBegin;
+  if (link->compression == PETSCSF_COMPRESSION_SINGLE) {
+    for (i=n-1; i>=0; i--) {
+      memcpy(&f,buf+i*sizeof(float),sizeof(float));
+      r    = (PetscReal)f;
+      memcpy(buf+i*sizeof(PetscReal),&r,sizeof(PetscReal));
+    }
+  } else {
+    for (i=n-1; i>=0; i--) {
+      memcpy(&h,buf+i*sizeof(unsigned short),sizeof(unsigned short));
+      u    = ((uint32_t)h) << 16;
+      memcpy(&f,&u,sizeof(float));
+      r    = (PetscReal)f;
+      memcpy(buf+i*sizeof(PetscReal),&r,sizeof(PetscReal));
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode PetscSFLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,const void *leafdata,MPI_Op op,PetscSFOperation sfop,PetscSFLink *mylink)
 {
   PetscErrorCode    ierr;
@@ -527,7 +651,7 @@ PetscErrorCode PetscSFLinkGetMPIBuffersAndRequests(PetscSF sf,PetscSFLink link,P
   PetscMPIInt          n;
   MPI_Aint             disp;
   MPI_Comm             comm = PetscObjectComm((PetscObject)sf);
-  MPI_Datatype         unit = link->unit;
+  MPI_Datatype         unit = link->wireunit;
   const PetscMemType   rootmtype_mpi = link->rootmtype_mpi,leafmtype_mpi = link->leafmtype_mpi; /* Used to select buffers passed to MPI */
   const PetscInt       rootdirect_mpi = link->rootdirect_mpi,leafdirect_mpi = link->leafdirect_mpi;
 
@@ -538,13 +662,13 @@ PetscErrorCode PetscSFLinkGetMPIBuffersAndRequests(PetscSF sf,PetscSFLink link,P
       ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
       if (direction == PETSCSF_LEAF2ROOT) {
         for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
-          disp = (rootoffset[i] - rootoffset[ndrootranks])*link->unitbytes;
+          disp = (rootoffset[i] - rootoffset[ndrootranks])*link->wirebytes;
           ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
           ierr = MPI_Recv_init(link->rootbuf[PETSCSF_REMOTE][rootmtype_mpi]+disp,n,unit,bas->iranks[i],link->tag,comm,link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi]+j);CHKERRMPI(ierr);
         }
       } else { /* PETSCSF_ROOT2LEAF */
         for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
-          disp = (rootoffset[i] - rootoffset[ndrootranks])*link->unitbytes;
+          disp = (rootoffset[i] - rootoffset[ndrootranks])*link->wirebytes;
           ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
           ierr = MPI_Send_init(link->rootbuf[PETSCSF_REMOTE][rootmtype_mpi]+disp,n,unit,bas->iranks[i],link->tag,comm,link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi]+j);CHKERRMPI(ierr);
         }
@@ -556,13 +680,13 @@ PetscErrorCode PetscSFLinkGetMPIBuffersAndRequests(PetscSF sf,PetscSFLink link,P
       ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL,NULL);CHKERRQ(ierr);
       if (direction == PETSCSF_LEAF2ROOT) {
         for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
-          disp = (leafoffset[i] - leafoffset[ndleafranks])*link->unitbytes;
+          disp = (leafoffset[i] - leafoffset[ndleafranks])*link->wirebytes;
           ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
           ierr = MPI_Send_init(link->leafbuf[PETSCSF_REMOTE][leafmtype_mpi]+disp,n,unit,sf->ranks[i],link->tag,comm,link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi]+j);CHKERRMPI(ierr);
         }
       } else { /* PETSCSF_ROOT2LEAF */
         for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
-          disp = (leafoffset[i] - leafoffset[ndleafranks])*link->unitbytes;
+          disp = (leafoffset[i] - leafoffset[ndleafranks])*link->wirebytes;
           ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
           ierr = MPI_Recv_init(link->leafbuf[PETSCSF_REMOTE][leafmtype_mpi]+disp,n,unit,sf->ranks[i],link->tag,comm,link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi]+j);CHKERRMPI(ierr);
         }
@@ -769,6 +893,8 @@ PetscErrorCode PetscSFLinkSetUp_Host(PetscSF sf,PetscSFLink link,MPI_Datatype un
   }
 
   if (!link->isbuiltin) {ierr = MPI_Type_dup(unit,&link->unit);CHKERRMPI(ierr);}
+  link->wireunit  = link->unit;
+  link->wirebytes = link->unitbytes;
 
   link->Memcpy = PetscSFLinkMemcpy_Host;
   PetscFunctionReturn(0);
@@ -1067,6 +1193,7 @@ PetscErrorCode PetscSFLinkPackRootData(PetscSF sf,PetscSFLink link,PetscSFScope
   }
   ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
   if (bas->rootbuflen[scope]) {ierr = PetscSFLinkPackRootData_Private(sf,link,scope,rootdata);CHKERRQ(ierr);}
+  if (scope == PETSCSF_REMOTE && link->compression && bas->rootbuflen[scope]) {ierr = PetscSFLinkCompressBuffer(link,bas->rootbuflen[scope],link->rootbuf[scope][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1082,6 +1209,7 @@ PetscErrorCode PetscSFLinkPackLeafData(PetscSF sf,PetscSFLink link,PetscSFScope
   }
   ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
   if (sf->leafbuflen[scope]) {ierr = PetscSFLinkPackLeafData_Private(sf,link,scope,leafdata);CHKERRQ(ierr);}
+  if (scope == PETSCSF_REMOTE && link->compression && sf->leafbuflen[scope]) {ierr = PetscSFLinkCompressBuffer(link,sf->leafbuflen[scope],link->leafbuf[scope][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1142,6 +1270,7 @@ PetscErrorCode PetscSFLinkUnpackRootData(PetscSF sf,PetscSFLink link,PetscSFScop
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  if (scope == PETSCSF_REMOTE && link->compression && bas->rootbuflen[scope]) {ierr = PetscSFLinkDecompressBuffer(link,bas->rootbuflen[scope],link->rootbuf[scope][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);}
   if (bas->rootbuflen[scope]) {ierr = PetscSFLinkUnpackRootData_Private(sf,link,scope,rootdata,op);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   if (scope == PETSCSF_REMOTE) {
@@ -1158,6 +1287,7 @@ PetscErrorCode PetscSFLinkUnpackLeafData(PetscSF sf,PetscSFLink link,PetscSFScop
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  if (scope == PETSCSF_REMOTE && link->compression && sf->leafbuflen[scope]) {ierr = PetscSFLinkDecompressBuffer(link,sf->leafbuflen[scope],link->leafbuf[scope][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);}
   if (sf->leafbuflen[scope]) {ierr = PetscSFLinkUnpackLeafData_Private(sf,link,scope,leafdata,op);CHKERRQ(ierr);}
   ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   if (scope == PETSCSF_REMOTE) {
@@ -1278,91 +1408,115 @@ PetscErrorCode PetscSFLinkFetchAndOpLocal(PetscSF sf,PetscSFLink link,void *root
   PetscFunctionReturn(0);
 }
 
+/* Find the largest 3D subdomain (in the sense of PetscSFPackOpt) that idx[0,m) starts with, i.e., idx[] begins with
+   start + X*Y*k + X*j + i for k in [0,dz), j in [0,dy), i in [0,dx). Return in *len the number of indices it covers.
+   A strided pattern is a subdomain with dx = 1 and X the stride.
+*/
+static PetscErrorCode PetscSFFindPackBox(PetscInt m,const PetscInt *idx,PetscInt *start_,PetscInt *dx_,PetscInt *dy_,PetscInt *dz_,PetscInt *X_,PetscInt *Y_,PetscInt *len)
+{
+  PetscInt i,j,dx,dy,dz,X,Y,d,q,start = idx[0];
+
+  PetscFunctionBegin;
+  /* Search in X dimension */
+  for (dx=1; dx<m; dx++) {
+    if (idx[dx] != start+dx) break;
+  }
+
+  /* Search in Y dimension, with the stride given by the first index after the x-walk */
+  dy = 1;
+  X  = (dx < m) ? idx[dx]-start : dx;
+  if (X > 0) {
+    for (; (dy+1)*dx <= m; dy++) {
+      for (i=0; i<dx; i++) {if (idx[dy*dx+i] != start+X*dy+i) break;}
+      if (i < dx) break;
+    }
+  }
+  if (dy == 1) X = dx;
+
+  /* Search in Z dimension */
+  dz = 1;
+  Y  = dy;
+  q  = dx*dy;
+  if (dy > 1 && q < m) {
+    d = idx[q]-start;
+    if (d > 0 && d%X == 0) {
+      Y = d/X;
+      for (; (dz+1)*q <= m; dz++) {
+        for (j=0; j<dy; j++) {
+          for (i=0; i<dx; i++) {if (idx[dz*q+j*dx+i] != start+X*Y*dz+X*j+i) break;}
+          if (i < dx) break;
+        }
+        if (j < dy) break;
+      }
+    }
+    if (dz == 1) Y = dy;
+  }
+
+  *start_ = start;
+  *dx_    = dx;
+  *dy_    = dy;
+  *dz_    = dz;
+  *X_     = X;
+  *Y_     = Y;
+  *len    = dx*dy*dz;
+  PetscFunctionReturn(0);
+}
+
 /*
   Create per-rank pack/unpack optimizations based on indice patterns
 
    Input Parameters:
   +  n       - Number of destination ranks
   .  offset  - [n+1] For the i-th rank, its associated indices are idx[offset[i], offset[i+1]). offset[0] needs not to be 0.
-  -  idx     - [*]   Array storing indices
+  .  idx     - [*]   Array storing indices
+  -  split   - Whether indices of a rank can be described by a sequence of 3D subdomains instead of a single one
 
    Output Parameters:
   +  opt     - Pack optimizations. NULL if no optimizations.
+
+   Notes:
+   With split, e.g., the ghost points a DMDA with periodic boundaries receives from a neighbor, which lie on both sides
+   of the local domain, are still packed with memory copies. Kernels only walk through the subdomains in order, so they
+   do not care which rank a subdomain belongs to. We give up if the subdomains are too small on average to beat the
+   plain index loops. The ScatterAndOp kernels assume a single subdomain, so do not split for PETSCSF_LOCAL.
 */
-PetscErrorCode PetscSFCreatePackOpt(PetscInt n,const PetscInt *offset,const PetscInt *idx,PetscSFPackOpt *out)
+PetscErrorCode PetscSFCreatePackOpt(PetscInt n,const PetscInt *offset,const PetscInt *idx,PetscBool split,PetscSFPackOpt *out)
 {
   PetscErrorCode ierr;
-  PetscInt       r,p,start,i,j,k,dx,dy,dz,dydz,m,X,Y;
-  PetscBool      optimizable = PETSC_TRUE;
+  PetscInt       r,p,b,nb = 0,len,start,dx,dy,dz,X,Y;
   PetscSFPackOpt opt;
 
   PetscFunctionBegin;
-  ierr   = PetscMalloc1(1,&opt);CHKERRQ(ierr);
-  ierr   = PetscMalloc1(7*n+2,&opt->array);CHKERRQ(ierr);
-  opt->n      = opt->array[0] = n;
-  opt->offset = opt->array + 1;
-  opt->start  = opt->array + n   + 2;
-  opt->dx     = opt->array + 2*n + 2;
-  opt->dy     = opt->array + 3*n + 2;
-  opt->dz     = opt->array + 4*n + 2;
-  opt->X      = opt->array + 5*n + 2;
-  opt->Y      = opt->array + 6*n + 2;
-
-  for (r=0; r<n; r++) { /* For each destination rank */
-    m     = offset[r+1] - offset[r]; /* Total number of indices for this rank. We want to see if m can be factored into dx*dy*dz */
-    p     = offset[r];
-    start = idx[p]; /* First index for this rank */
-    p++;
-
-    /* Search in X dimension */
-    for (dx=1; dx<m; dx++,p++) {
-      if (start+dx != idx[p]) break;
-    }
-
-    dydz = m/dx;
-    X    = dydz > 1 ? (idx[p]-start) : dx;
-    /* Not optimizable if m is not a multiple of dx, or some unrecognized pattern is found */
-    if (m%dx || X <= 0) {optimizable = PETSC_FALSE; goto finish;}
-    for (dy=1; dy<dydz; dy++) { /* Search in Y dimension */
-      for (i=0; i<dx; i++,p++) {
-        if (start+X*dy+i != idx[p]) {
-          if (i) {optimizable = PETSC_FALSE; goto finish;} /* The pattern is violated in the middle of an x-walk */
-          else goto Z_dimension;
-        }
-      }
+  *out = NULL;
+  if (!n) PetscFunctionReturn(0);
+  /* Count the subdomains */
+  for (r=0; r<n; r++) {
+    for (p=offset[r]; p<offset[r+1]; p+=len,nb++) {
+      ierr = PetscSFFindPackBox(offset[r+1]-p,idx+p,&start,&dx,&dy,&dz,&X,&Y,&len);CHKERRQ(ierr);
+      if (!split && len != offset[r+1]-p) PetscFunctionReturn(0); /* Not optimizable since some unrecognized pattern is found */
     }
-
-Z_dimension:
-    dz = m/(dx*dy);
-    Y  = dz > 1 ? (idx[p]-start)/X : dy;
-    /* Not optimizable if m is not a multiple of dx*dy, or some unrecognized pattern is found */
-    if (m%(dx*dy) || Y <= 0) {optimizable = PETSC_FALSE; goto finish;}
-    for (k=1; k<dz; k++) { /* Go through Z dimension to see if remaining indices follow the pattern */
-      for (j=0; j<dy; j++) {
-        for (i=0; i<dx; i++,p++) {
-          if (start+X*Y*k+X*j+i != idx[p]) {optimizable = PETSC_FALSE; goto finish;}
-        }
-      }
-    }
-    opt->start[r] = start;
-    opt->dx[r]    = dx;
-    opt->dy[r]    = dy;
-    opt->dz[r]    = dz;
-    opt->X[r]     = X;
-    opt->Y[r]     = Y;
   }
+  if (split && nb > n && 4*nb > offset[n]-offset[0]) PetscFunctionReturn(0); /* Subdomains are too small; index loops are faster */
 
-finish:
-  /* If not optimizable, free arrays to save memory */
-  if (!n || !optimizable) {
-    ierr = PetscFree(opt->array);CHKERRQ(ierr);
-    ierr = PetscFree(opt);CHKERRQ(ierr);
-    *out = NULL;
-  } else {
-    opt->offset[0] = 0;
-    for (r=0; r<n; r++) opt->offset[r+1] = opt->offset[r] + opt->dx[r]*opt->dy[r]*opt->dz[r];
-    *out = opt;
+  ierr   = PetscMalloc1(1,&opt);CHKERRQ(ierr);
+  ierr   = PetscMalloc1(7*nb+2,&opt->array);CHKERRQ(ierr);
+  opt->n      = opt->array[0] = nb;
+  opt->offset = opt->array + 1;
+  opt->start  = opt->array + nb   + 2;
+  opt->dx     = opt->array + 2*nb + 2;
+  opt->dy     = opt->array + 3*nb + 2;
+  opt->dz     = opt->array + 4*nb + 2;
+  opt->X      = opt->array + 5*nb + 2;
+  opt->Y      = opt->array + 6*nb + 2;
+
+  opt->offset[0] = 0;
+  for (r=0,b=0; r<n; r++) { /* For each destination rank */
+    for (p=offset[r]; p<offset[r+1]; p+=len,b++) {
+      ierr = PetscSFFindPackBox(offset[r+1]-p,idx+p,&opt->start[b],&opt->dx[b],&opt->dy[b],&opt->dz[b],&opt->X[b],&opt->Y[b],&len);CHKERRQ(ierr);
+      opt->offset[b+1] = opt->offset[b] + len;
+    }
   }
+  *out = opt;
   PetscFunctionReturn(0);
 }
 
@@ -1412,8 +1566,8 @@ PetscErrorCode PetscSFSetUpPackFields(PetscSF sf)
   }
 
   /* If not, see if we can have per-rank optimizations by doing index analysis */
-  if (!sf->leafcontig[0]) {ierr = PetscSFCreatePackOpt(sf->ndranks,            sf->roffset,             sf->rmine, &sf->leafpackopt[0]);CHKERRQ(ierr);}
-  if (!sf->leafcontig[1]) {ierr = PetscSFCreatePackOpt(sf->nranks-sf->ndranks, sf->roffset+sf->ndranks, sf->rmine, &sf->leafpackopt[1]);CHKERRQ(ierr);}
+  if (!sf->leafcontig[0]) {ierr = PetscSFCreatePackOpt(sf->ndranks,            sf->roffset,             sf->rmine, PETSC_FALSE, &sf->leafpackopt[0]);CHKERRQ(ierr);}
+  if (!sf->leafcontig[1]) {ierr = PetscSFCreatePackOpt(sf->nranks-sf->ndranks, sf->roffset+sf->ndranks, sf->rmine, PETSC_TRUE,  &sf->leafpackopt[1]);CHKERRQ(ierr);}
 
   /* Are root indices for self and remote contiguous? */
   bas->rootbuflen[0] = bas->ioffset[bas->ndiranks];
@@ -1429,8 +1583,8 @@ PetscErrorCode PetscSFSetUpPackFields(PetscSF sf)
     if (bas->irootloc[i] != bas->rootstart[1]+j) {bas->rootcontig[1] = PETSC_FALSE; break;}
   }
 
-  if (!bas->rootcontig[0]) {ierr = PetscSFCreatePackOpt(bas->ndiranks,              bas->ioffset,               bas->irootloc, &bas->rootpackopt[0]);CHKERRQ(ierr);}
-  if (!bas->rootcontig[1]) {ierr = PetscSFCreatePackOpt(bas->niranks-bas->ndiranks, bas->ioffset+bas->ndiranks, bas->irootloc, &bas->rootpackopt[1]);CHKERRQ(ierr);}
+  if (!bas->rootcontig[0]) {ierr = PetscSFCreatePackOpt(bas->ndiranks,              bas->ioffset,               bas->irootloc, PETSC_FALSE, &bas->rootpackopt[0]);CHKERRQ(ierr);}
+  if (!bas->rootcontig[1]) {ierr = PetscSFCreatePackOpt(bas->niranks-bas->ndiranks, bas->ioffset+bas->ndiranks, bas->irootloc, PETSC_TRUE,  &bas->rootpackopt[1]);CHKERRQ(ierr);}
 
  #if defined(PETSC_HAVE_DEVICE)
     /* Check dups in indices so that CUDA unpacking kernels can use cheaper regular instructions instead of atomics when they know there are no data race chances */
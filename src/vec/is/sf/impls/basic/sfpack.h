@@ -171,6 +171,9 @@ struct _n_PetscSFLink {
   PetscBool    isbuiltin;                    /* Is unit an MPI/PETSc builtin datatype? If it is true, then bs=1 and basicunit is equivalent to unit */
   size_t       unitbytes;                    /* Number of bytes in a unit */
   PetscInt     bs;                           /* Number of basic units in a unit */
+  PetscSFCompression compression;           /* Reduced precision of remote data on the wire. Fixed at link creation, since it determines the MPI requests */
+  MPI_Datatype wireunit;                     /* The MPI datatype of a unit on the wire. Same as unit unless compression is on */
+  size_t       wirebytes;                    /* Number of bytes in a wireunit */
   const void   *rootdata,*leafdata;          /* rootdata and leafdata the link is working on. They are used as keys for pending links. */
   PetscMemType rootmtype,leafmtype;          /* root/leafdata's memory type */
 
@@ -212,6 +215,8 @@ PETSC_INTERN PetscErrorCode PetscSFLinkSetUp_Host(PetscSF,PetscSFLink,MPI_Dataty
 PETSC_INTERN PetscErrorCode PetscSFLinkGetInUse(PetscSF,MPI_Datatype,const void*,const void*,PetscCopyMode,PetscSFLink*);
 PETSC_INTERN PetscErrorCode PetscSFLinkReclaim(PetscSF,PetscSFLink*);
 PETSC_INTERN PetscErrorCode PetscSFLinkDestroy(PetscSF,PetscSFLink);
+PETSC_INTERN PetscErrorCode PetscSFLinkGetCompression(PetscSF,MPI_Datatype,PetscMemType,PetscMemType,PetscSFOperation,PetscSFCompression*);
+PETSC_INTERN PetscErrorCode PetscSFLinkSetUpCompression(PetscSF,PetscSFLink,PetscSFCompression);
 
 /* Get pack/unpack function pointers from a link */
 PETSC_STATIC_INLINE PetscErrorCode PetscSFLinkGetPack(PetscSFLink link,PetscMemType mtype,PetscErrorCode (**Pack)(PetscSFLink,PetscInt,PetscInt,PetscSFPackOpt,const PetscInt*,const void*,void*))
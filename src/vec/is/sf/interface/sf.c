@@ -21,6 +21,7 @@
 #endif
 
 const char *const PetscSFDuplicateOptions[] = {"CONFONLY","RANKS","GRAPH","PetscSFDuplicateOption","PETSCSF_DUPLICATE_",NULL};
+const char *const PetscSFCompressions[]     = {"NONE","SINGLE","BFLOAT16","PetscSFCompression","PETSCSF_COMPRESSION_",NULL};
 
 PETSC_STATIC_INLINE PetscErrorCode PetscGetMemType(const void *data,PetscMemType *type)
 {
@@ -165,6 +166,10 @@ PetscErrorCode PetscSFReset(PetscSF sf)
   if (sf->multi) sf->multi->multi = NULL;
   ierr = PetscSFDestroy(&sf->multi);CHKERRQ(ierr);
   ierr = PetscLayoutDestroy(&sf->map);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf->vscat.msf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->vscat.mroots);CHKERRQ(ierr);
+  ierr = PetscFree2(sf->vscat.mrootbuf,sf->vscat.mleafbuf);CHKERRQ(ierr);
+  sf->vscat.mbufn = 0;
 
  #if defined(PETSC_HAVE_DEVICE)
   for (PetscInt i=0; i<2; i++) {ierr = PetscSFFree(sf,PETSC_MEMTYPE_DEVICE,sf->rmine_d[i]);CHKERRQ(ierr);}
@@ -353,6 +358,7 @@ PetscErrorCode PetscSFSetUp(PetscSF sf)
    Options Database Keys:
 +  -sf_type               - implementation type, see PetscSFSetType()
 .  -sf_rank_order         - sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise
+.  -sf_compression <none,single,bfloat16> - round floating point data sent to other processes to lower precision, see PetscSFSetCompression()
 .  -sf_use_default_stream - Assume callers of SF computed the input root/leafdata with the default cuda stream. SF will also
                             use the default stream to process data. Therefore, no stream synchronization is needed between SF and its caller (default: true).
                             If true, this option only works with -use_gpu_aware_mpi 1.
@@ -379,6 +385,7 @@ PetscErrorCode PetscSFSetFromOptions(PetscSF sf)
   ierr = PetscOptionsFList("-sf_type","PetscSF implementation type","PetscSFSetType",PetscSFList,deft,type,sizeof(type),&flg);CHKERRQ(ierr);
   ierr = PetscSFSetType(sf,flg ? type : deft);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-sf_rank_order","sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise","PetscSFSetRankOrder",sf->rankorder,&sf->rankorder,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnum("-sf_compression","Reduced precision used for floating point data sent to other processes","PetscSFSetCompression",PetscSFCompressions,(PetscEnum)sf->compression,(PetscEnum*)&sf->compression,NULL);CHKERRQ(ierr);
  #if defined(PETSC_HAVE_DEVICE)
   {
     char        backendstr[32] = {0};
@@ -428,6 +435,69 @@ PetscErrorCode PetscSFSetRankOrder(PetscSF sf,PetscBool flg)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PetscSFSetCompression - round floating point data sent between processes to a lower precision
+
+   Logically Collective
+
+   Input Parameters:
++  sf - star forest
+-  compression - PETSCSF_COMPRESSION_NONE (default), PETSCSF_COMPRESSION_SINGLE or PETSCSF_COMPRESSION_BFLOAT16
+
+   Options Database Key:
+.  -sf_compression <none,single,bfloat16> - set the compression
+
+   Notes:
+   Halo exchanges in iterative solvers are often bandwidth bound, while the data exchanged (e.g., the ghost values of the
+   vector in a matrix-vector product inside a preconditioner) does not always need full precision. With compression the
+   packed send buffers are rounded in place (with round-to-nearest-even) to the requested precision, halving or quartering
+   the number of bytes sent, and expanded back to full precision on the receiver before unpacking. Data exchanged within
+   a process is not affected.
+
+   Compression is only applied to PetscSFBcast and PetscSFReduce operations on PetscReal or PetscScalar data (or
+   contiguous blocks of them) in host memory for PETSCSFBASIC and when PETSc is configured with double precision.
+   Other communication is done in full precision.
+
+   The matrix-vector product scatter of MATMPIAIJ matrices can be compressed separately with the option
+   -matmult_vecscatter_compression.
+
+   Level: advanced
+
+.seealso: PetscSFGetCompression(), PetscSFCompression, PetscSFSetFromOptions()
+@*/
+PetscErrorCode PetscSFSetCompression(PetscSF sf,PetscSFCompression compression)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(sf,compression,2);
+  sf->compression = compression;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscSFGetCompression - get the reduced precision used for floating point data sent between processes
+
+   Not Collective
+
+   Input Parameter:
+.  sf - star forest
+
+   Output Parameter:
+.  compression - the compression, see PetscSFSetCompression()
+
+   Level: advanced
+
+.seealso: PetscSFSetCompression(), PetscSFCompression
+@*/
+PetscErrorCode PetscSFGetCompression(PetscSF sf,PetscSFCompression *compression)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  PetscValidPointer(compression,2);
+  *compression = sf->compression;
+  PetscFunctionReturn(0);
+}
+
 /*@
    PetscSFSetGraph - Set a parallel star forest
 
@@ -757,6 +827,7 @@ PetscErrorCode PetscSFDuplicate(PetscSF sf,PetscSFDuplicateOption opt,PetscSF *n
   (*newsf)->vscat.unit   = dtype;
   (*newsf)->vscat.to_n   = sf->vscat.to_n;
   (*newsf)->vscat.from_n = sf->vscat.from_n;
+  (*newsf)->compression  = sf->compression;
   /* Do not copy lsf. Build it on demand since it is rarely used */
 
 #if defined(PETSC_HAVE_DEVICE)
@@ -19,6 +19,7 @@ int main(int argc, char **argv)
   PetscInt    i;
   PetscInt    *ilocal;
   PetscSFNode *iremote;
+  PetscSFCompression compression;
 
   ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
   ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRMPI(ierr);
@@ -84,6 +85,22 @@ int main(int argc, char **argv)
 
   ierr = VecView(Aout,PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
   ierr = VecView(Bout,PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
+
+  /* the values above are exact in any precision; broadcast values that are not, and check that only the remote leaf is rounded */
+  ierr = PetscSFGetCompression(sf,&compression);CHKERRQ(ierr);
+  if (compression) {
+    PetscReal rootval = (rank+1)/3.0,exact[2],diff,bound = compression == PETSCSF_COMPRESSION_SINGLE ? PetscPowReal(2.0,-24) : PetscPowReal(2.0,-8);
+    PetscReal leafval[2];
+
+    exact[0] = rootval;
+    exact[1] = (2-rank)/3.0;
+    ierr = PetscSFBcastBegin(sf,MPIU_REAL,&rootval,leafval,MPI_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,MPIU_REAL,&rootval,leafval,MPI_REPLACE);CHKERRQ(ierr);
+    diff = PetscAbsReal(leafval[1]-exact[1])/exact[1];
+    ierr = PetscSynchronizedPrintf(PETSC_COMM_WORLD,"[%d] compression %s: local leaf %s, remote leaf %s\n",rank,PetscSFCompressions[compression],
+                                   leafval[0] == exact[0] ? "exact" : "rounded",diff > 0.0 && diff <= bound ? "rounded within the precision" : "not rounded as expected");CHKERRQ(ierr);
+    ierr = PetscSynchronizedFlush(PETSC_COMM_WORLD,PETSC_STDOUT);CHKERRQ(ierr);
+  }
   ierr = VecDestroy(&A);CHKERRQ(ierr);
   ierr = VecDestroy(&B);CHKERRQ(ierr);
   ierr = VecDestroy(&Aout);CHKERRQ(ierr);
@@ -102,6 +119,13 @@ int main(int argc, char **argv)
       filter: grep -v "type" | grep -v "sort"
       args: -sf_type basic
 
+   test:
+      suffix: basic_compression
+      nsize: 2
+      filter: grep -v "type" | grep -v "sort"
+      args: -sf_type basic -sf_compression {{single bfloat16}separate output}
+      requires: double
+
    test:
       suffix: window
       nsize: 2
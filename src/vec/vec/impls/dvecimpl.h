@@ -34,6 +34,8 @@ PETSC_INTERN PetscErrorCode VecAXPY_Seq(Vec,PetscScalar,Vec);
 PETSC_INTERN PetscErrorCode VecAXPBY_Seq(Vec,PetscScalar,PetscScalar,Vec);
 PETSC_INTERN PetscErrorCode VecMax_Seq(Vec,PetscInt*,PetscReal*);
 PETSC_INTERN PetscErrorCode VecNorm_Seq(Vec,NormType,PetscReal*);
+PETSC_INTERN PetscErrorCode VecMDot_Repro(Vec,PetscInt,const Vec[],PetscBool,PetscBool,PetscScalar*);
+PETSC_INTERN PetscErrorCode VecNorm_Repro(Vec,NormType,PetscBool,PetscReal*);
 PETSC_INTERN PetscErrorCode VecDestroy_Seq(Vec);
 PETSC_INTERN PetscErrorCode VecDuplicate_Seq(Vec,Vec*);
 PETSC_INTERN PetscErrorCode VecSetOption_Seq(Vec,VecOption,PetscBool);
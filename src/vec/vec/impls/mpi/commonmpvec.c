@@ -286,3 +286,110 @@ PetscErrorCode  VecGhostUpdateEnd(Vec g,InsertMode insertmode,ScatterMode scatte
   }
   PetscFunctionReturn(0);
 }
+
+/* Gather the local forms of n ghosted vectors that share one ghost scatter. Returns NULL scatter if there is nothing to communicate */
+static PetscErrorCode VecGhostGetMultiple_Private(PetscInt n,const Vec g[],VecScatter *scatter,Vec **l)
+{
+  Vec_MPI        *v;
+  PetscErrorCode ierr;
+  PetscInt       i;
+  PetscBool      ismpi,isseq;
+
+  PetscFunctionBegin;
+  *scatter = NULL;
+  *l       = NULL;
+  for (i=0; i<n; i++) {
+    PetscValidHeaderSpecific(g[i],VEC_CLASSID,2);
+    ierr = PetscObjectTypeCompare((PetscObject)g[i],VECMPI,&ismpi);CHKERRQ(ierr);
+    ierr = PetscObjectTypeCompare((PetscObject)g[i],VECSEQ,&isseq);CHKERRQ(ierr);
+    if (isseq) { /* Do nothing */
+      if (*scatter) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Cannot mix sequential and parallel ghosted vectors");
+      continue;
+    }
+    if (!ismpi) SETERRQ(PetscObjectComm((PetscObject)g[i]),PETSC_ERR_ARG_WRONG,"Vector is not ghosted");
+    v = (Vec_MPI*)g[i]->data;
+    if (!v->localrep) SETERRQ(PetscObjectComm((PetscObject)g[i]),PETSC_ERR_ARG_WRONG,"Vector is not ghosted");
+    if (i && !*scatter) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Cannot mix sequential and parallel ghosted vectors");
+    if (!i) *scatter = v->localupdate;
+    else if (v->localupdate != *scatter) SETERRQ(PetscObjectComm((PetscObject)g[i]),PETSC_ERR_ARG_INCOMP,"Vectors must share the ghost scatter, e.g., be obtained with VecDuplicate() from the same ghosted vector");
+  }
+  if (!*scatter) PetscFunctionReturn(0);
+  ierr = PetscMalloc1(n,l);CHKERRQ(ierr);
+  for (i=0; i<n; i++) (*l)[i] = ((Vec_MPI*)g[i]->data)->localrep;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecGhostUpdateMultipleBegin - Begins the ghost update of several ghosted vectors with one exchange of messages
+
+   Neighbor-wise Collective on Vec
+
+   Input Parameters:
++  n - number of vectors
+.  g - the vectors (obtained with VecCreateGhost() and VecDuplicate() from the same vector, so that they share the ghost scatter)
+.  insertmode - one of ADD_VALUES, MAX_VALUES, MIN_VALUES or INSERT_VALUES
+-  scattermode - one of SCATTER_FORWARD or SCATTER_REVERSE
+
+   Notes:
+   This has the same effect as calling VecGhostUpdateBegin() on each vector, but the entries of all the vectors
+   are interleaved and sent with one message per neighbor process, see VecScatterBeginMultiple(). Use it when many
+   fields with the same ghosting are updated together and the update is latency bound.
+
+   Level: advanced
+
+.seealso: VecGhostUpdateMultipleEnd(), VecGhostUpdateBegin(), VecScatterBeginMultiple(), VecCreateGhost()
+@*/
+PetscErrorCode VecGhostUpdateMultipleBegin(PetscInt n,const Vec g[],InsertMode insertmode,ScatterMode scattermode)
+{
+  PetscErrorCode ierr;
+  VecScatter     scatter;
+  Vec            *l;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  PetscValidPointer(g,2);
+  ierr = VecGhostGetMultiple_Private(n,g,&scatter,&l);CHKERRQ(ierr);
+  if (!scatter) PetscFunctionReturn(0);
+  if (scattermode == SCATTER_REVERSE) {
+    ierr = VecScatterBeginMultiple(scatter,n,l,g,insertmode,scattermode);CHKERRQ(ierr);
+  } else {
+    ierr = VecScatterBeginMultiple(scatter,n,g,l,insertmode,scattermode);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(l);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecGhostUpdateMultipleEnd - Ends the ghost update of several ghosted vectors started with VecGhostUpdateMultipleBegin()
+
+   Neighbor-wise Collective on Vec
+
+   Input Parameters:
++  n - number of vectors
+.  g - the vectors
+.  insertmode - one of ADD_VALUES, MAX_VALUES, MIN_VALUES or INSERT_VALUES
+-  scattermode - one of SCATTER_FORWARD or SCATTER_REVERSE
+
+   Level: advanced
+
+.seealso: VecGhostUpdateMultipleBegin(), VecGhostUpdateEnd()
+@*/
+PetscErrorCode VecGhostUpdateMultipleEnd(PetscInt n,const Vec g[],InsertMode insertmode,ScatterMode scattermode)
+{
+  PetscErrorCode ierr;
+  VecScatter     scatter;
+  Vec            *l;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  PetscValidPointer(g,2);
+  ierr = VecGhostGetMultiple_Private(n,g,&scatter,&l);CHKERRQ(ierr);
+  if (!scatter) PetscFunctionReturn(0);
+  if (scattermode == SCATTER_REVERSE) {
+    ierr = VecScatterEndMultiple(scatter,n,l,g,insertmode,scattermode);CHKERRQ(ierr);
+  } else {
+    ierr = VecScatterEndMultiple(scatter,n,g,l,insertmode,scattermode);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(l);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -11,6 +11,10 @@ PetscErrorCode VecDot_MPI(Vec xin,Vec yin,PetscScalar *z)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,1,&yin,PETSC_TRUE,PETSC_TRUE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = VecDot_Seq(xin,yin,&work);CHKERRQ(ierr);
   ierr = MPIU_Allreduce(&work,&sum,1,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)xin));CHKERRMPI(ierr);
   *z   = sum;
@@ -23,6 +27,10 @@ PetscErrorCode VecTDot_MPI(Vec xin,Vec yin,PetscScalar *z)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,1,&yin,PETSC_FALSE,PETSC_TRUE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = VecTDot_Seq(xin,yin,&work);CHKERRQ(ierr);
   ierr = MPIU_Allreduce(&work,&sum,1,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)xin));CHKERRMPI(ierr);
   *z   = sum;
@@ -11,6 +11,10 @@ PetscErrorCode VecMDot_MPI(Vec xin,PetscInt nv,const Vec y[],PetscScalar *z)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,nv,y,PETSC_TRUE,PETSC_TRUE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   if (nv > 128) {
     ierr = PetscMalloc1(nv,&work);CHKERRQ(ierr);
   }
@@ -28,6 +32,10 @@ PetscErrorCode VecMTDot_MPI(Vec xin,PetscInt nv,const Vec y[],PetscScalar *z)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,nv,y,PETSC_FALSE,PETSC_TRUE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   if (nv > 128) {
     ierr = PetscMalloc1(nv,&work);CHKERRQ(ierr);
   }
@@ -49,6 +57,10 @@ PetscErrorCode VecNorm_MPI(Vec xin,NormType type,PetscReal *z)
   PetscBLASInt      one = 1,bn = 0;
 
   PetscFunctionBegin;
+  if (VecReproducible && type != NORM_INFINITY) {
+    ierr = VecNorm_Repro(xin,type,PETSC_TRUE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
   if (type == NORM_2 || type == NORM_FROBENIUS) {
     ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
@@ -14,6 +14,10 @@ PetscErrorCode VecDot_Seq(Vec xin,Vec yin,PetscScalar *z)
   PetscErrorCode    ierr;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,1,&yin,PETSC_TRUE,PETSC_FALSE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscBLASIntCast(xin->map->n,&bn);CHKERRQ(ierr);
   ierr = VecGetArrayRead(xin,&xa);CHKERRQ(ierr);
   ierr = VecGetArrayRead(yin,&ya);CHKERRQ(ierr);
@@ -34,6 +38,10 @@ PetscErrorCode VecTDot_Seq(Vec xin,Vec yin,PetscScalar *z)
   PetscErrorCode    ierr;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,1,&yin,PETSC_FALSE,PETSC_FALSE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscBLASIntCast(xin->map->n,&bn);CHKERRQ(ierr);
   ierr = VecGetArrayRead(xin,&xa);CHKERRQ(ierr);
   ierr = VecGetArrayRead(yin,&ya);CHKERRQ(ierr);
@@ -217,6 +217,10 @@ PetscErrorCode VecNorm_Seq(Vec xin,NormType type,PetscReal *z)
   PetscBLASInt      one = 1, bn = 0;
 
   PetscFunctionBegin;
+  if (VecReproducible && type != NORM_INFINITY) {
+    ierr = VecNorm_Repro(xin,type,PETSC_FALSE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
   if (type == NORM_2 || type == NORM_FROBENIUS) {
     ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
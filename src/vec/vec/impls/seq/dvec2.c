@@ -17,6 +17,10 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
   Vec               *yy;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,nv,yin,PETSC_TRUE,PETSC_FALSE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   sum0 = 0.0;
   sum1 = 0.0;
   sum2 = 0.0;
@@ -98,6 +102,10 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
   Vec               *yy;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,nv,yin,PETSC_TRUE,PETSC_FALSE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   sum0 = 0.;
   sum1 = 0.;
   sum2 = 0.;
@@ -298,6 +306,10 @@ PetscErrorCode VecMTDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
   Vec               *yy;
 
   PetscFunctionBegin;
+  if (VecReproducible) {
+    ierr = VecMDot_Repro(xin,nv,yin,PETSC_FALSE,PETSC_FALSE,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   sum0 = 0.;
   sum1 = 0.;
   sum2 = 0.;
@@ -144,6 +144,7 @@ static void MPIAPI MPIU_MinIndex_Local(void *in,void *out,PetscMPIInt *cnt,MPI_D
 }
 
 PETSC_EXTERN void MPIAPI PetscSplitReduction_Local(void*,void*,PetscMPIInt*,MPI_Datatype*);
+PETSC_EXTERN void MPIAPI VecRepro_Local(void*,void*,PetscMPIInt*,MPI_Datatype*);
 
 const char *const NormTypes[] = {"1","2","FROBENIUS","INFINITY","1_AND_2","NormType","NORM_",NULL};
 PetscInt          NormIds[7];  /* map from NormType to IDs used to cache Normvalues */
@@ -257,6 +258,11 @@ PetscErrorCode  VecInitializePackage(void)
     if (pkg) {ierr = PetscLogEventExcludeClass(VEC_CLASSID);CHKERRQ(ierr);}
     if (pkg) {ierr = PetscLogEventExcludeClass(PETSCSF_CLASSID);CHKERRQ(ierr);}
   }
+  /* Reproducible reductions, see src/vec/vec/impls/seq/vrepro.c */
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_reproducible",&VecReproducible,NULL);CHKERRQ(ierr);
+#if !defined(PETSC_USE_REAL_DOUBLE)
+  if (VecReproducible) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"-vec_reproducible is only supported for double precision");
+#endif
 
   /*
     Create the special MPI reduction operation that may be used by VecNorm/DotBegin()
@@ -264,6 +270,9 @@ PetscErrorCode  VecInitializePackage(void)
   ierr = MPI_Op_create(PetscSplitReduction_Local,1,&PetscSplitReduction_Op);CHKERRMPI(ierr);
   ierr = MPI_Op_create(MPIU_MaxIndex_Local,1,&MPIU_MAXLOC);CHKERRMPI(ierr);
   ierr = MPI_Op_create(MPIU_MinIndex_Local,1,&MPIU_MINLOC);CHKERRMPI(ierr);
+  ierr = MPI_Op_create(VecRepro_Local,1,&VecRepro_Op);CHKERRMPI(ierr);
+  ierr = MPI_Type_contiguous(VEC_REPRO_NACC,MPIU_REAL,&VecRepro_Type);CHKERRMPI(ierr);
+  ierr = MPI_Type_commit(&VecRepro_Type);CHKERRMPI(ierr);
 
   /* Register the different norm types for cached norms */
   for (i=0; i<4; i++) {
@@ -292,6 +301,8 @@ PetscErrorCode  VecFinalizePackage(void)
   ierr = MPI_Op_free(&PetscSplitReduction_Op);CHKERRMPI(ierr);
   ierr = MPI_Op_free(&MPIU_MAXLOC);CHKERRMPI(ierr);
   ierr = MPI_Op_free(&MPIU_MINLOC);CHKERRMPI(ierr);
+  ierr = MPI_Op_free(&VecRepro_Op);CHKERRMPI(ierr);
+  ierr = MPI_Type_free(&VecRepro_Type);CHKERRMPI(ierr);
   if (Petsc_Reduction_keyval != MPI_KEYVAL_INVALID) {
     ierr = MPI_Comm_free_keyval(&Petsc_Reduction_keyval);CHKERRMPI(ierr);
   }
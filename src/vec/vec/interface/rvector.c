@@ -107,6 +107,14 @@ $     val = (x,y) = y^H x,
 $     val = (x,y) = y^T x,
    where y^T denotes the transpose of y.
 
+   Options Database Key:
+.  -vec_reproducible - use a binned summation whose result does not depend on the number of processes, for VECSEQ and VECMPI in double precision
+
+   Notes:
+   The reproducible summation is also used by VecTDot(), VecMDot(), VecMTDot(), VecNorm() and the split phase
+   VecDotBegin()/VecDotEnd(), VecNormBegin()/VecNormEnd() etc. For large vectors it takes up to about twice the time of
+   the usual one, for small vectors in cache several times, see src/vec/vec/impls/seq/vrepro.c
+
    Level: intermediate
 
 .seealso: VecMDot(), VecTDot(), VecNorm(), VecDotBegin(), VecDotEnd(), VecDotRealPart()
@@ -195,6 +203,8 @@ $     NORM_INFINITY denotes max_i |x_i|
       the 1 norm of the complex entries (what is returned by the BLAS routine asum()). Both are valid norms but most
       people expect the former.
 
+      With -vec_reproducible, NORM_1 and NORM_2 do not depend on the number of processes, see VecDot().
+
    Level: intermediate
 
    Performance Issues:
@@ -410,6 +420,9 @@ $     val = (x,y) = y^T x,
 $     val = (x,y) = y^H x,
    where y^H denotes the conjugate transpose of y.
 
+   Options Database Key:
+.  -vec_reproducible - use a binned summation whose result does not depend on the number of processes, see VecDot()
+
    Level: intermediate
 
 .seealso: VecDot(), VecMTDot()
@@ -1077,6 +1090,9 @@ $      val = (x,y) = y^T x,
 $      val = (x,y) = y^H x,
    where y^H denotes the conjugate transpose of y.
 
+   Options Database Key:
+.  -vec_reproducible - use a binned summation whose results do not depend on the number of processes, see VecDot()
+
    Level: intermediate
 
 .seealso: VecMDot(), VecTDot()
@@ -1125,6 +1141,9 @@ $     val = (x,y) = y^H x,
 $     val = (x,y) = y^T x,
    where y^T denotes the transpose of y.
 
+   Options Database Key:
+.  -vec_reproducible - use a binned summation whose results do not depend on the number of processes, see VecDot()
+
    Level: intermediate
 
 .seealso: VecMTDot(), VecDot()
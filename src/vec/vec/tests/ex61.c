@@ -0,0 +1,144 @@
+
+static char help[] = "Tests that VecDot(), VecTDot(), VecMDot(), VecMTDot(), VecNorm() and their split phase forms with -vec_reproducible do not depend on the number of processes.\n\n";
+
+#include <petscvec.h>
+
+#define NRES 15
+
+/* The reductions tested, with the split phase forms last */
+static PetscErrorCode Reductions(Vec x,Vec y[],PetscScalar r[],PetscReal nrm[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDot(x,y[0],&r[0]);CHKERRQ(ierr);
+  ierr = VecTDot(x,y[1],&r[1]);CHKERRQ(ierr);
+  ierr = VecMDot(x,3,y,r+2);CHKERRQ(ierr);
+  ierr = VecMTDot(x,3,y,r+5);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_1_AND_2,nrm);CHKERRQ(ierr);
+  ierr = VecNorm(y[1],NORM_2,&nrm[2]);CHKERRQ(ierr);
+
+  ierr = VecDotBegin(x,y[0],&r[8]);CHKERRQ(ierr);
+  ierr = VecTDotBegin(x,y[1],&r[9]);CHKERRQ(ierr);
+  ierr = VecNormBegin(y[2],NORM_2,&nrm[3]);CHKERRQ(ierr);
+  ierr = VecMTDotBegin(y[2],2,y,r+10);CHKERRQ(ierr);
+  ierr = VecNormBegin(x,NORM_1,&nrm[4]);CHKERRQ(ierr);
+  ierr = VecMDotBegin(y[2],3,y,r+12);CHKERRQ(ierr);
+  ierr = VecNormBegin(x,NORM_INFINITY,&nrm[5]);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
+  ierr = VecDotEnd(x,y[0],&r[8]);CHKERRQ(ierr);
+  ierr = VecTDotEnd(x,y[1],&r[9]);CHKERRQ(ierr);
+  ierr = VecNormEnd(y[2],NORM_2,&nrm[3]);CHKERRQ(ierr);
+  ierr = VecMTDotEnd(y[2],2,y,r+10);CHKERRQ(ierr);
+  ierr = VecNormEnd(x,NORM_1,&nrm[4]);CHKERRQ(ierr);
+  ierr = VecMDotEnd(y[2],3,y,r+12);CHKERRQ(ierr);
+  ierr = VecNormEnd(x,NORM_INFINITY,&nrm[5]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = 1000,i,j,rstart,rend;
+  PetscMPIInt    rank;
+  PetscScalar    v,r[NRES],sr[NRES];
+  PetscReal      nrm[6],snrm[6],scale = 1.0;
+  PetscBool      same;
+  Vec            x,*y,sx,sy[3];
+  VecScatter     scat;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRMPI(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-scale",&scale,NULL);CHKERRQ(ierr);
+
+  /* Entries of very different magnitudes and signs so that the usual summation depends on the order */
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,PETSC_DECIDE,n,&x);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,3,&y);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(x,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    v    = scale*PetscSinReal((PetscReal)i)*PetscPowReal(10.0,(PetscReal)(i%31-15));
+    ierr = VecSetValue(x,i,v,INSERT_VALUES);CHKERRQ(ierr);
+    for (j=0; j<3; j++) {
+      v    = PetscCosReal((PetscReal)(i*(j+1)))*PetscPowReal(2.0,(PetscReal)((7*i+j)%61-30));
+      ierr = VecSetValue(y[j],i,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  for (j=0; j<3; j++) {
+    ierr = VecAssemblyBegin(y[j]);CHKERRQ(ierr);
+    ierr = VecAssemblyEnd(y[j]);CHKERRQ(ierr);
+  }
+
+  ierr = Reductions(x,y,r,nrm);CHKERRQ(ierr);
+
+  /* Compute the same on a single process from a sequential copy and compare bit for bit */
+  ierr = VecScatterCreateToZero(x,&scat,&sx);CHKERRQ(ierr);
+  ierr = VecScatterBegin(scat,x,sx,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = VecScatterEnd(scat,x,sx,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  for (j=0; j<3; j++) {
+    ierr = VecDuplicate(sx,&sy[j]);CHKERRQ(ierr);
+    ierr = VecScatterBegin(scat,y[j],sy[j],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd(scat,y[j],sy[j],INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  }
+  if (!rank) {
+    ierr = Reductions(sx,sy,sr,snrm);CHKERRQ(ierr);
+    for (same=PETSC_TRUE,j=0; j<NRES; j++) if (r[j] != sr[j]) {
+      same = PETSC_FALSE;
+      ierr = PetscPrintf(PETSC_COMM_SELF,"Reduction %D differs\n",j);CHKERRQ(ierr);
+    }
+    for (j=0; j<6; j++) if (nrm[j] != snrm[j]) {
+      same = PETSC_FALSE;
+      ierr = PetscPrintf(PETSC_COMM_SELF,"Norm %D differs\n",j);CHKERRQ(ierr);
+    }
+    /* The split phase forms compute the same sums */
+    if (r[8] != r[0] || r[9] != r[1] || nrm[4] != nrm[0]) {ierr = PetscPrintf(PETSC_COMM_SELF,"Split phase results differ\n");CHKERRQ(ierr);}
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Dot %g tdot %g norms %g %g %g\n",(double)PetscRealPart(r[0]),(double)PetscRealPart(r[1]),(double)nrm[0],(double)nrm[1],(double)nrm[2]);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Parallel and sequential results %s\n",same ? "are identical" : "differ");CHKERRQ(ierr);
+  }
+
+  ierr = VecScatterDestroy(&scat);CHKERRQ(ierr);
+  ierr = VecDestroy(&sx);CHKERRQ(ierr);
+  for (j=0; j<3; j++) {ierr = VecDestroy(&sy[j]);CHKERRQ(ierr);}
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(3,&y);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      requires: double
+      args: -vec_reproducible
+      output_file: output/ex61_1.out
+      test:
+        suffix: 1
+      test:
+        suffix: 2
+        nsize: 2
+      test:
+        suffix: 3
+        nsize: 3
+
+   test:
+      suffix: sync
+      requires: double
+      nsize: 3
+      args: -vec_reproducible -splitreduction_async 0
+      output_file: output/ex61_1.out
+
+   test:
+      suffix: large
+      requires: double
+      nsize: 3
+      args: -vec_reproducible -scale 1e200
+
+   test:
+      suffix: small
+      requires: double
+      nsize: 3
+      args: -vec_reproducible -scale 1e-200
+
+TEST*/
@@ -21,14 +21,36 @@ T*/
 */
 #include <petscvec.h>
 
+/* Check that the local form of gy, including the ghost padding, is twice that of gx */
+static PetscErrorCode CheckTwice(Vec gx,Vec gy)
+{
+  Vec               lx,ly;
+  const PetscScalar *x,*y;
+  PetscInt          i,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBeginUser;
+  ierr = VecGhostGetLocalForm(gx,&lx);CHKERRQ(ierr);
+  ierr = VecGhostGetLocalForm(gy,&ly);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(lx,&n);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(lx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(ly,&y);CHKERRQ(ierr);
+  for (i=0; i<n; i++) if (y[i] != 2.0*x[i]) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Entry %D of the second vector is %g, expected %g",i,(double)PetscRealPart(y[i]),(double)PetscRealPart(2.0*x[i]));
+  ierr = VecRestoreArrayRead(lx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(ly,&y);CHKERRQ(ierr);
+  ierr = VecGhostRestoreLocalForm(gx,&lx);CHKERRQ(ierr);
+  ierr = VecGhostRestoreLocalForm(gy,&ly);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 int main(int argc,char **argv)
 {
   PetscMPIInt    rank,size;
   PetscInt       nlocal = 6,nghost = 2,ifrom[2],i,rstart,rend;
   PetscErrorCode ierr;
-  PetscBool      flg,flg2,flg3;
+  PetscBool      flg,flg2,flg3,flg4;
   PetscScalar    value,*array,*tarray=0;
-  Vec            lx,gx,gxs;
+  Vec            lx,gx,gxs,gy = NULL,vecs[2];
 
   ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
   ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRMPI(ierr);
@@ -70,6 +92,7 @@ int main(int argc,char **argv)
   ierr = PetscOptionsHasName(NULL,NULL,"-allocate",&flg);CHKERRQ(ierr);
   ierr = PetscOptionsHasName(NULL,NULL,"-vecmpisetghost",&flg2);CHKERRQ(ierr);
   ierr = PetscOptionsHasName(NULL,NULL,"-minvalues",&flg3);CHKERRQ(ierr);
+  ierr = PetscOptionsHasName(NULL,NULL,"-multiple",&flg4);CHKERRQ(ierr);
   if (flg) {
     ierr = PetscMalloc1(nlocal+nghost,&tarray);CHKERRQ(ierr);
     ierr = VecCreateGhostWithArray(PETSC_COMM_WORLD,nlocal,PETSC_DECIDE,nghost,ifrom,tarray,&gxs);CHKERRQ(ierr);
@@ -104,8 +127,18 @@ int main(int argc,char **argv)
   ierr = VecAssemblyBegin(gx);CHKERRQ(ierr);
   ierr = VecAssemblyEnd(gx);CHKERRQ(ierr);
 
-  ierr = VecGhostUpdateBegin(gx,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
-  ierr = VecGhostUpdateEnd(gx,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  if (flg4) { /* Update gx together with a second vector gy = 2*gx with one exchange of messages */
+    ierr = VecDuplicate(gx,&gy);CHKERRQ(ierr);
+    ierr = VecCopy(gx,gy);CHKERRQ(ierr);
+    ierr = VecScale(gy,2.0);CHKERRQ(ierr);
+    vecs[0] = gx; vecs[1] = gy;
+    ierr = VecGhostUpdateMultipleBegin(2,vecs,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecGhostUpdateMultipleEnd(2,vecs,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = CheckTwice(gx,gy);CHKERRQ(ierr);
+  } else {
+    ierr = VecGhostUpdateBegin(gx,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecGhostUpdateEnd(gx,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  }
 
   /*
      Print out each vector, including the ghost padding region.
@@ -127,8 +160,19 @@ int main(int argc,char **argv)
     ierr = VecRestoreArray(lx,&array);CHKERRQ(ierr);
     ierr = VecGhostRestoreLocalForm(gx,&lx);CHKERRQ(ierr);
 
-    ierr = VecGhostUpdateBegin(gx,MIN_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
-    ierr = VecGhostUpdateEnd(gx,MIN_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+    if (flg4) {
+      ierr = VecGhostGetLocalForm(gy,&lx);CHKERRQ(ierr);
+      ierr = VecGetArray(lx,&array);CHKERRQ(ierr);
+      for (i=0; i<nghost; i++) array[nlocal+i] = rank ? (PetscScalar)8 : (PetscScalar)16;
+      ierr = VecRestoreArray(lx,&array);CHKERRQ(ierr);
+      ierr = VecGhostRestoreLocalForm(gy,&lx);CHKERRQ(ierr);
+      ierr = VecGhostUpdateMultipleBegin(2,vecs,MIN_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      ierr = VecGhostUpdateMultipleEnd(2,vecs,MIN_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      ierr = CheckTwice(gx,gy);CHKERRQ(ierr);
+    } else {
+      ierr = VecGhostUpdateBegin(gx,MIN_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+      ierr = VecGhostUpdateEnd(gx,MIN_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+    }
 
     ierr = VecGhostGetLocalForm(gx,&lx);CHKERRQ(ierr);
     ierr = VecGetArray(lx,&array);CHKERRQ(ierr);
@@ -142,6 +186,7 @@ int main(int argc,char **argv)
   }
 
   ierr = VecDestroy(&gx);CHKERRQ(ierr);
+  ierr = VecDestroy(&gy);CHKERRQ(ierr);
 
   if (flg) {ierr = PetscFree(tarray);CHKERRQ(ierr);}
   ierr = PetscFinalize();
@@ -172,5 +217,18 @@ int main(int argc,char **argv)
        output_file: output/ex9_2.out
        requires: !complex
 
+     test:
+       suffix: multiple
+       nsize: 2
+       args: -multiple
+       output_file: output/ex9_1.out
+
+     test:
+       suffix: multiple_minvalues
+       nsize: 2
+       args: -multiple -minvalues
+       output_file: output/ex9_2.out
+       requires: !complex
+
 TEST*/
 
@@ -53,8 +53,12 @@ static PetscErrorCode  PetscSplitReductionCreate(MPI_Comm comm,PetscSplitReducti
   (*sr)->maxops      = MAXOPS;
   ierr               = PetscMalloc6(MAXOPS,&(*sr)->lvalues,MAXOPS,&(*sr)->gvalues,MAXOPS,&(*sr)->invecs,MAXOPS,&(*sr)->reducetype,MAXOPS,&(*sr)->lvalues_mix,MAXOPS,&(*sr)->gvalues_mix);CHKERRQ(ierr);
 #undef MAXOPS
+  if (VecReproducible) {
+    ierr = PetscMalloc2((*sr)->maxops*VEC_REPRO_NSCALAR,&(*sr)->lrepro,(*sr)->maxops*VEC_REPRO_NSCALAR,&(*sr)->grepro);CHKERRQ(ierr);
+  }
   (*sr)->comm        = comm;
   (*sr)->request     = MPI_REQUEST_NULL;
+  (*sr)->rrequest    = MPI_REQUEST_NULL;
   (*sr)->mix         = PETSC_FALSE;
   (*sr)->async       = PETSC_FALSE;
 #if defined(PETSC_HAVE_MPI_IALLREDUCE)
@@ -126,12 +130,13 @@ PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm comm)
     PetscScalar *lvalues = sr->lvalues,*gvalues = sr->gvalues;
     PetscInt    sum_flg = 0,max_flg = 0, min_flg = 0;
     MPI_Comm    comm = sr->comm;
-    PetscMPIInt size,cmul = sizeof(PetscScalar)/sizeof(PetscReal);
+    PetscMPIInt size,cnt,cmul = sizeof(PetscScalar)/sizeof(PetscReal);
 
     ierr = PetscLogEventBegin(VEC_ReduceBegin,0,0,0,0);CHKERRQ(ierr);
     ierr = MPI_Comm_size(sr->comm,&size);CHKERRMPI(ierr);
     if (size == 1) {
       ierr = PetscArraycpy(gvalues,lvalues,numops);CHKERRQ(ierr);
+      if (VecReproducible) {ierr = PetscArraycpy(sr->grepro,sr->lrepro,numops*VEC_REPRO_NSCALAR);CHKERRQ(ierr);}
     } else {
       /* determine if all reductions are sum, max, or min */
       for (i=0; i<numops; i++) {
@@ -140,6 +145,11 @@ PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm comm)
         else if (reducetype[i] == PETSC_SR_REDUCE_MIN) min_flg = 1;
         else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Error in PetscSplitReduction() data structure, probably memory corruption");
       }
+      if (VecReproducible) { /* the sums are in the accumulators, lvalues only needs reducing for max and min */
+        ierr = PetscMPIIntCast(numops*VEC_REPRO_NSCALAR/VEC_REPRO_NACC,&cnt);CHKERRQ(ierr);
+        ierr = MPIPetsc_Iallreduce(sr->lrepro,sr->grepro,cnt,VecRepro_Type,VecRepro_Op,comm,&sr->rrequest);CHKERRQ(ierr);
+        if (!max_flg && !min_flg) sum_flg = 0;
+      }
       if (sum_flg + max_flg + min_flg > 1 && sr->mix) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Error in PetscSplitReduction() data structure, probably memory corruption");
       if (sum_flg + max_flg + min_flg > 1) {
         sr->mix = PETSC_TRUE;
@@ -149,7 +159,7 @@ PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm comm)
         ierr = MPIPetsc_Iallreduce((PetscReal*)lvalues,(PetscReal*)gvalues,cmul*numops,MPIU_REAL,MPIU_MAX,comm,&sr->request);CHKERRQ(ierr);
       } else if (min_flg) {
         ierr = MPIPetsc_Iallreduce((PetscReal*)lvalues,(PetscReal*)gvalues,cmul*numops,MPIU_REAL,MPIU_MIN,comm,&sr->request);CHKERRQ(ierr);
-      } else {
+      } else if (sum_flg) {
         ierr = MPIPetsc_Iallreduce(lvalues,gvalues,numops,MPIU_SCALAR,MPIU_SUM,comm,&sr->request);CHKERRQ(ierr);
       }
     }
@@ -177,6 +187,9 @@ PetscErrorCode PetscSplitReductionEnd(PetscSplitReduction *sr)
     if (sr->request != MPI_REQUEST_NULL) {
       ierr = MPI_Wait(&sr->request,MPI_STATUS_IGNORE);CHKERRMPI(ierr);
     }
+    if (sr->rrequest != MPI_REQUEST_NULL) {
+      ierr = MPI_Wait(&sr->rrequest,MPI_STATUS_IGNORE);CHKERRMPI(ierr);
+    }
     sr->state = STATE_END;
     if (sr->mix) {
       PetscInt i;
@@ -200,7 +213,7 @@ static PetscErrorCode PetscSplitReductionApply(PetscSplitReduction *sr)
   PetscScalar    *lvalues = sr->lvalues,*gvalues = sr->gvalues;
   PetscInt       sum_flg  = 0,max_flg = 0, min_flg = 0;
   MPI_Comm       comm     = sr->comm;
-  PetscMPIInt    size,cmul = sizeof(PetscScalar)/sizeof(PetscReal);
+  PetscMPIInt    size,cnt,cmul = sizeof(PetscScalar)/sizeof(PetscReal);
 
   PetscFunctionBegin;
   if (sr->numopsend > 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Cannot call this after VecxxxEnd() has been called");
@@ -208,6 +221,7 @@ static PetscErrorCode PetscSplitReductionApply(PetscSplitReduction *sr)
   ierr = MPI_Comm_size(sr->comm,&size);CHKERRMPI(ierr);
   if (size == 1) {
     ierr = PetscArraycpy(gvalues,lvalues,numops);CHKERRQ(ierr);
+    if (VecReproducible) {ierr = PetscArraycpy(sr->grepro,sr->lrepro,numops*VEC_REPRO_NSCALAR);CHKERRQ(ierr);}
   } else {
     /* determine if all reductions are sum, max, or min */
     for (i=0; i<numops; i++) {
@@ -216,6 +230,11 @@ static PetscErrorCode PetscSplitReductionApply(PetscSplitReduction *sr)
       else if (reducetype[i] == PETSC_SR_REDUCE_MIN) min_flg = 1;
       else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Error in PetscSplitReduction() data structure, probably memory corruption");
     }
+    if (VecReproducible) { /* the sums are in the accumulators, lvalues only needs reducing for max and min */
+      ierr = PetscMPIIntCast(numops*VEC_REPRO_NSCALAR/VEC_REPRO_NACC,&cnt);CHKERRQ(ierr);
+      ierr = MPIU_Allreduce(sr->lrepro,sr->grepro,cnt,VecRepro_Type,VecRepro_Op,comm);CHKERRMPI(ierr);
+      if (!max_flg && !min_flg) sum_flg = 0;
+    }
     if (sum_flg + max_flg + min_flg > 1) {
       if (sr->mix) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Error in PetscSplitReduction() data structure, probably memory corruption");
       for (i=0; i<numops; i++) { sr->lvalues_mix[i].v = lvalues[i]; sr->lvalues_mix[i].i = reducetype[i]; }
@@ -225,7 +244,7 @@ static PetscErrorCode PetscSplitReductionApply(PetscSplitReduction *sr)
       ierr = MPIU_Allreduce((PetscReal*)lvalues,(PetscReal*)gvalues,cmul*numops,MPIU_REAL,MPIU_MAX,comm);CHKERRMPI(ierr);
     } else if (min_flg) {
       ierr = MPIU_Allreduce((PetscReal*)lvalues,(PetscReal*)gvalues,cmul*numops,MPIU_REAL,MPIU_MIN,comm);CHKERRMPI(ierr);
-    } else {
+    } else if (sum_flg) {
       ierr = MPIU_Allreduce(lvalues,gvalues,numops,MPIU_SCALAR,MPIU_SUM,comm);CHKERRMPI(ierr);
     }
   }
@@ -247,6 +266,7 @@ PetscErrorCode  PetscSplitReductionExtend(PetscSplitReduction *sr)
   struct PetscScalarInt *lvalues_mix = (struct PetscScalarInt*)sr->lvalues_mix;
   struct PetscScalarInt *gvalues_mix = (struct PetscScalarInt*)sr->gvalues_mix;
   void                  **invecs = sr->invecs;
+  PetscReal             *lrepro = sr->lrepro,*grepro = sr->grepro;
 
   PetscFunctionBegin;
   sr->maxops = 2*maxops;
@@ -258,6 +278,11 @@ PetscErrorCode  PetscSplitReductionExtend(PetscSplitReduction *sr)
   ierr = PetscArraycpy(sr->lvalues_mix,lvalues_mix,maxops);CHKERRQ(ierr);
   ierr = PetscArraycpy(sr->gvalues_mix,gvalues_mix,maxops);CHKERRQ(ierr);
   ierr = PetscFree6(lvalues,gvalues,reducetype,invecs,lvalues_mix,gvalues_mix);CHKERRQ(ierr);
+  if (lrepro) {
+    ierr = PetscMalloc2(2*maxops*VEC_REPRO_NSCALAR,&sr->lrepro,2*maxops*VEC_REPRO_NSCALAR,&sr->grepro);CHKERRQ(ierr);
+    ierr = PetscArraycpy(sr->lrepro,lrepro,maxops*VEC_REPRO_NSCALAR);CHKERRQ(ierr);
+    ierr = PetscFree2(lrepro,grepro);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
@@ -267,6 +292,7 @@ PetscErrorCode  PetscSplitReductionDestroy(PetscSplitReduction *sr)
 
   PetscFunctionBegin;
   ierr = PetscFree6(sr->lvalues,sr->gvalues,sr->reducetype,sr->invecs,sr->lvalues_mix,sr->gvalues_mix);CHKERRQ(ierr);
+  ierr = PetscFree2(sr->lrepro,sr->grepro);CHKERRQ(ierr);
   ierr = PetscFree(sr);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -320,6 +346,22 @@ PetscErrorCode PetscSplitReductionGet(MPI_Comm comm,PetscSplitReduction **sr)
   PetscFunctionReturn(0);
 }
 
+/*
+   PetscSplitReductionReproGet - With -vec_reproducible the local parts of the next n sums go into these (zeroed)
+   accumulators instead of lvalues
+*/
+static PetscErrorCode PetscSplitReductionReproGet(PetscSplitReduction *sr,PetscInt n,PetscReal **acc)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  *acc = sr->lrepro + sr->numopsbegin*VEC_REPRO_NSCALAR;
+  ierr = PetscArrayzero(*acc,n*VEC_REPRO_NSCALAR);CHKERRQ(ierr);
+  for (i=0; i<n; i++) sr->lvalues[sr->numopsbegin+i] = 0.0;
+  PetscFunctionReturn(0);
+}
+
 /* ----------------------------------------------------------------------------------------------------*/
 
 /*@
@@ -335,6 +377,8 @@ PetscErrorCode PetscSplitReductionGet(MPI_Comm comm,PetscSplitReduction **sr)
    Notes:
    Each call to VecDotBegin() should be paired with a call to VecDotEnd().
 
+   With -vec_reproducible the result does not depend on the number of processes, see VecDot().
+
 seealso: VecDotEnd(), VecNormBegin(), VecNormEnd(), VecNorm(), VecDot(), VecMDot(),
          VecTDotBegin(), VecTDotEnd(), PetscCommSplitReductionBegin()
 @*/
@@ -343,6 +387,7 @@ PetscErrorCode  VecDotBegin(Vec x,Vec y,PetscScalar *result)
   PetscErrorCode      ierr;
   PetscSplitReduction *sr;
   MPI_Comm            comm;
+  PetscReal           *acc;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(x,VEC_CLASSID,1);
@@ -357,7 +402,13 @@ PetscErrorCode  VecDotBegin(Vec x,Vec y,PetscScalar *result)
   sr->invecs[sr->numopsbegin]     = (void*)x;
   if (!x->ops->dot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local dots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->dot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  if (VecReproducible) {
+    ierr = PetscSplitReductionReproGet(sr,1,&acc);CHKERRQ(ierr);
+    ierr = VecReproMDotLocal(x,1,&y,PETSC_TRUE,acc);CHKERRQ(ierr);
+    sr->numopsbegin++;
+  } else {
+    ierr = (*x->ops->dot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -375,6 +426,8 @@ PetscErrorCode  VecDotBegin(Vec x,Vec y,PetscScalar *result)
    Notes:
    Each call to VecDotBegin() should be paired with a call to VecDotEnd().
 
+   With -vec_reproducible the result does not depend on the number of processes, see VecDot().
+
 .seealso: VecDotBegin(), VecNormBegin(), VecNormEnd(), VecNorm(), VecDot(), VecMDot(),
          VecTDotBegin(),VecTDotEnd(), PetscCommSplitReductionBegin()
 
@@ -393,7 +446,8 @@ PetscErrorCode  VecDotEnd(Vec x,Vec y,PetscScalar *result)
   if (sr->numopsend >= sr->numopsbegin) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() more times then VecxxxBegin()");
   if (x && (void*)x != sr->invecs[sr->numopsend]) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() in a different order or with a different vector than VecxxxBegin()");
   if (sr->reducetype[sr->numopsend] != PETSC_SR_REDUCE_SUM) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecDotEnd() on a reduction started with VecNormBegin()");
-  *result = sr->gvalues[sr->numopsend++];
+  if (VecReproducible) *result = VecReproScalar(sr->grepro+VEC_REPRO_NSCALAR*sr->numopsend++);
+  else *result = sr->gvalues[sr->numopsend++];
 
   /*
      We are finished getting all the results so reset to no outstanding requests
@@ -429,6 +483,7 @@ PetscErrorCode  VecTDotBegin(Vec x,Vec y,PetscScalar *result)
   PetscErrorCode      ierr;
   PetscSplitReduction *sr;
   MPI_Comm            comm;
+  PetscReal           *acc;
 
   PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)x,&comm);CHKERRQ(ierr);
@@ -441,7 +496,13 @@ PetscErrorCode  VecTDotBegin(Vec x,Vec y,PetscScalar *result)
   sr->invecs[sr->numopsbegin]     = (void*)x;
   if (!x->ops->tdot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local dots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->tdot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  if (VecReproducible) {
+    ierr = PetscSplitReductionReproGet(sr,1,&acc);CHKERRQ(ierr);
+    ierr = VecReproMDotLocal(x,1,&y,PETSC_FALSE,acc);CHKERRQ(ierr);
+    sr->numopsbegin++;
+  } else {
+    ierr = (*x->ops->tdot_local)(x,y,sr->lvalues+sr->numopsbegin++);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -489,6 +550,8 @@ PetscErrorCode  VecTDotEnd(Vec x,Vec y,PetscScalar *result)
    Notes:
    Each call to VecNormBegin() should be paired with a call to VecNormEnd().
 
+   With -vec_reproducible NORM_1, NORM_2 and NORM_1_AND_2 do not depend on the number of processes, see VecDot().
+
 .seealso: VecNormEnd(), VecNorm(), VecDot(), VecMDot(), VecDotBegin(), VecDotEnd(), PetscCommSplitReductionBegin()
 
 @*/
@@ -496,7 +559,7 @@ PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
 {
   PetscErrorCode      ierr;
   PetscSplitReduction *sr;
-  PetscReal           lresult[2];
+  PetscReal           lresult[2],*acc;
   MPI_Comm            comm;
 
   PetscFunctionBegin;
@@ -510,6 +573,16 @@ PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
 
   sr->invecs[sr->numopsbegin] = (void*)x;
   if (!x->ops->norm_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local norms");
+  if (VecReproducible && ntype != NORM_MAX) {
+    PetscInt nsum = ntype == NORM_1_AND_2 ? 2 : 1;
+
+    ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
+    ierr = PetscSplitReductionReproGet(sr,nsum,&acc);CHKERRQ(ierr);
+    ierr = VecReproNormLocal(x,ntype,acc,ntype == NORM_1_AND_2 ? acc+VEC_REPRO_NSCALAR : acc);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
+    for (; nsum; nsum--) sr->reducetype[sr->numopsbegin++] = PETSC_SR_REDUCE_SUM;
+    PetscFunctionReturn(0);
+  }
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   ierr = (*x->ops->norm_local)(x,ntype,lresult);CHKERRQ(ierr);
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
@@ -538,6 +611,8 @@ PetscErrorCode  VecNormBegin(Vec x,NormType ntype,PetscReal *result)
    Notes:
    Each call to VecNormBegin() should be paired with a call to VecNormEnd().
 
+   With -vec_reproducible NORM_1, NORM_2 and NORM_1_AND_2 do not depend on the number of processes, see VecDot().
+
    The x vector is not allowed to be NULL, otherwise the vector would not have its correctly cached norm value
 
 .seealso: VecNormBegin(), VecNorm(), VecDot(), VecMDot(), VecDotBegin(), VecDotEnd(), PetscCommSplitReductionBegin()
@@ -558,12 +633,17 @@ PetscErrorCode  VecNormEnd(Vec x,NormType ntype,PetscReal *result)
   if (sr->numopsend >= sr->numopsbegin) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() more times then VecxxxBegin()");
   if ((void*)x != sr->invecs[sr->numopsend]) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() in a different order or with a different vector than VecxxxBegin()");
   if (sr->reducetype[sr->numopsend] != PETSC_SR_REDUCE_MAX && ntype == NORM_MAX) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecNormEnd(,NORM_MAX,) on a reduction started with VecDotBegin() or NORM_1 or NORM_2");
-  result[0] = PetscRealPart(sr->gvalues[sr->numopsend++]);
+  if (VecReproducible && ntype != NORM_MAX) {
+    result[0] = VecReproReal(sr->grepro+VEC_REPRO_NSCALAR*sr->numopsend++,(PetscBool)(ntype != NORM_1 && ntype != NORM_1_AND_2));
+    if (ntype == NORM_1_AND_2) result[1] = VecReproReal(sr->grepro+VEC_REPRO_NSCALAR*sr->numopsend++,PETSC_TRUE);
+  } else {
+    result[0] = PetscRealPart(sr->gvalues[sr->numopsend++]);
 
-  if (ntype == NORM_2) result[0] = PetscSqrtReal(result[0]);
-  else if (ntype == NORM_1_AND_2) {
-    result[1] = PetscRealPart(sr->gvalues[sr->numopsend++]);
-    result[1] = PetscSqrtReal(result[1]);
+    if (ntype == NORM_2) result[0] = PetscSqrtReal(result[0]);
+    else if (ntype == NORM_1_AND_2) {
+      result[1] = PetscRealPart(sr->gvalues[sr->numopsend++]);
+      result[1] = PetscSqrtReal(result[1]);
+    }
   }
   if (ntype!=NORM_1_AND_2) {
     ierr = PetscObjectComposedDataSetReal((PetscObject)x,NormIds[ntype],result[0]);CHKERRQ(ierr);
@@ -608,6 +688,7 @@ PetscErrorCode  VecMDotBegin(Vec x,PetscInt nv,const Vec y[],PetscScalar result[
   PetscErrorCode      ierr;
   PetscSplitReduction *sr;
   MPI_Comm            comm;
+  PetscReal           *acc;
   int                 i;
 
   PetscFunctionBegin;
@@ -623,7 +704,12 @@ PetscErrorCode  VecMDotBegin(Vec x,PetscInt nv,const Vec y[],PetscScalar result[
   }
   if (!x->ops->mdot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local mdots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->mdot_local)(x,nv,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);
+  if (VecReproducible) {
+    ierr = PetscSplitReductionReproGet(sr,nv,&acc);CHKERRQ(ierr);
+    ierr = VecReproMDotLocal(x,nv,y,PETSC_TRUE,acc);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->mdot_local)(x,nv,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   sr->numopsbegin += nv;
   PetscFunctionReturn(0);
@@ -664,7 +750,11 @@ PetscErrorCode  VecMDotEnd(Vec x,PetscInt nv,const Vec y[],PetscScalar result[])
   if (sr->numopsend >= sr->numopsbegin) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() more times then VecxxxBegin()");
   if (x && (void*)x != sr->invecs[sr->numopsend]) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() in a different order or with a different vector than VecxxxBegin()");
   if (sr->reducetype[sr->numopsend] != PETSC_SR_REDUCE_SUM) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecDotEnd() on a reduction started with VecNormBegin()");
-  for (i=0;i<nv;i++) result[i] = sr->gvalues[sr->numopsend++];
+  if (VecReproducible) {
+    for (i=0;i<nv;i++) result[i] = VecReproScalar(sr->grepro+VEC_REPRO_NSCALAR*sr->numopsend++);
+  } else {
+    for (i=0;i<nv;i++) result[i] = sr->gvalues[sr->numopsend++];
+  }
 
   /*
      We are finished getting all the results so reset to no outstanding requests
@@ -700,6 +790,7 @@ PetscErrorCode  VecMTDotBegin(Vec x,PetscInt nv,const Vec y[],PetscScalar result
   PetscErrorCode      ierr;
   PetscSplitReduction *sr;
   MPI_Comm            comm;
+  PetscReal           *acc;
   int                 i;
 
   PetscFunctionBegin;
@@ -715,7 +806,12 @@ PetscErrorCode  VecMTDotBegin(Vec x,PetscInt nv,const Vec y[],PetscScalar result
   }
   if (!x->ops->mtdot_local) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Vector does not support local mdots");
   ierr = PetscLogEventBegin(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
-  ierr = (*x->ops->mdot_local)(x,nv,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);
+  if (VecReproducible) {
+    ierr = PetscSplitReductionReproGet(sr,nv,&acc);CHKERRQ(ierr);
+    ierr = VecReproMDotLocal(x,nv,y,PETSC_FALSE,acc);CHKERRQ(ierr);
+  } else {
+    ierr = (*x->ops->mtdot_local)(x,nv,y,sr->lvalues+sr->numopsbegin);CHKERRQ(ierr);
+  }
   ierr = PetscLogEventEnd(VEC_ReduceArithmetic,0,0,0,0);CHKERRQ(ierr);
   sr->numopsbegin += nv;
   PetscFunctionReturn(0);